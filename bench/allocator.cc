@@ -0,0 +1,231 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Benchmarks for node allocation.
+ *
+ *  Churn in node-based containers, which allocate and free one node
+ *  per insertion and erasure: a `list` with 4096 nodes, which erases
+ *  and re-inserts nodes at both ends, and a `map` with 4096 keys, which
+ *  erases and re-inserts keys in a pseudo-random order. Each container
+ *  is benchmarked with `std::allocator`, `pool_allocator`, and
+ *  `polymorphic_allocator` with either `new_delete_resource()` or
+ *  a `pool_resource`.
+ *
+ *  Multi-threaded throughput is measured by allocating and freeing
+ *  blocks of 16 to 256 bytes from 1 to 8 threads sharing a single
+ *  resource: `new_delete_resource()`, a `pool_locked_resource`, which
+ *  serializes all threads on one mutex, and a `thread_cache_resource`.
+ */
+
+#include <pycpp/allocator/pool.h>
+#include <pycpp/allocator/thread_cache.h>
+#include <pycpp/stl/list.h>
+#include <pycpp/stl/map.h>
+#include <pycpp/stl/memory.h>
+#include <pycpp/stl/vector.h>
+#include <benchmark/benchmark.h>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+static constexpr size_t NODE_COUNT = 4096;
+
+template <typename T>
+using pool_list = std::list<T, pool_allocator<T>>;
+
+template <typename Key, typename T>
+using pool_map = std::map<Key, T, std::less<Key>, pool_allocator<std::pair<const Key, T>>>;
+
+template <typename T>
+using polymorphic_list = std::list<T, polymorphic_allocator<T>>;
+
+template <typename Key, typename T>
+using polymorphic_map = std::map<Key, T, std::less<Key>, polymorphic_allocator<std::pair<const Key, T>>>;
+
+
+static uint64_t next_random(uint64_t& state)
+{
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state ^ (state >> 29);
+}
+
+
+static vector<uint64_t> make_keys()
+{
+    vector<uint64_t> keys;
+    uint64_t state = 3;
+    for (size_t i = 0; i < NODE_COUNT; ++i) {
+        keys.emplace_back(next_random(state));
+    }
+    return keys;
+}
+
+
+static const vector<uint64_t> KEYS = make_keys();
+static constexpr size_t BLOCK_COUNT = 256;
+static pool_locked_resource<>::allocator_type::arena_type POOL_ARENA;
+static pool_locked_resource<> POOL_RESOURCE(POOL_ARENA);
+static thread_cache_resource THREAD_CACHE_RESOURCE;
+
+
+template <typename List>
+static void list_churn(benchmark::State& state, List& list)
+{
+    for (size_t i = 0; i < NODE_COUNT; ++i) {
+        list.push_back(i);
+    }
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < NODE_COUNT; ++i) {
+            list.pop_front();
+            list.push_back(i);
+            list.pop_back();
+            list.push_front(i);
+        }
+        benchmark::DoNotOptimize(list.front());
+    }
+    state.SetItemsProcessed(state.iterations() * NODE_COUNT * 2);
+}
+
+
+template <typename Map>
+static void map_churn(benchmark::State& state, Map& map)
+{
+    for (uint64_t key: KEYS) {
+        map.emplace(key, key);
+    }
+
+    for (auto _ : state) {
+        for (uint64_t key: KEYS) {
+            map.erase(key);
+            map.emplace(key ^ 1, key);
+        }
+        for (uint64_t key: KEYS) {
+            map.erase(key ^ 1);
+            map.emplace(key, key);
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * NODE_COUNT * 2);
+}
+
+
+static void threaded_churn(benchmark::State& state, memory_resource* resource)
+{
+    void* blocks[BLOCK_COUNT];
+    for (auto _ : state) {
+        for (size_t i = 0; i < BLOCK_COUNT; ++i) {
+            blocks[i] = resource->allocate(16 + (i % 16) * 16);
+        }
+        for (size_t i = 0; i < BLOCK_COUNT; ++i) {
+            resource->deallocate(blocks[i], 16 + (i % 16) * 16);
+        }
+        benchmark::DoNotOptimize(blocks[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * BLOCK_COUNT);
+}
+
+// BENCHMARKS
+// ----------
+
+
+static void list_std_allocator(benchmark::State& state)
+{
+    std::list<uint64_t> list;
+    list_churn(state, list);
+}
+
+
+static void list_pool_allocator(benchmark::State& state)
+{
+    typename pool_list<uint64_t>::allocator_type::arena_type arena;
+    pool_list<uint64_t> list(arena);
+    list_churn(state, list);
+}
+
+
+static void list_new_delete_resource(benchmark::State& state)
+{
+    polymorphic_list<uint64_t> list(new_delete_resource());
+    list_churn(state, list);
+}
+
+
+static void list_pool_resource(benchmark::State& state)
+{
+    pool_resource<>::allocator_type::arena_type arena;
+    pool_resource<> resource(arena);
+    polymorphic_list<uint64_t> list(&resource);
+    list_churn(state, list);
+}
+
+
+static void map_std_allocator(benchmark::State& state)
+{
+    std::map<uint64_t, uint64_t> map;
+    map_churn(state, map);
+}
+
+
+static void map_pool_allocator(benchmark::State& state)
+{
+    using map_type = pool_map<uint64_t, uint64_t>;
+    typename map_type::allocator_type::arena_type arena;
+    map_type map((std::less<uint64_t>()), arena);
+    map_churn(state, map);
+}
+
+
+static void map_new_delete_resource(benchmark::State& state)
+{
+    using map_type = polymorphic_map<uint64_t, uint64_t>;
+    map_type map((std::less<uint64_t>()), new_delete_resource());
+    map_churn(state, map);
+}
+
+
+static void map_pool_resource(benchmark::State& state)
+{
+    using map_type = polymorphic_map<uint64_t, uint64_t>;
+    pool_resource<>::allocator_type::arena_type arena;
+    pool_resource<> resource(arena);
+    map_type map((std::less<uint64_t>()), &resource);
+    map_churn(state, map);
+}
+
+
+static void threaded_new_delete_resource(benchmark::State& state)
+{
+    threaded_churn(state, new_delete_resource());
+}
+
+
+static void threaded_pool_resource(benchmark::State& state)
+{
+    threaded_churn(state, &POOL_RESOURCE);
+}
+
+
+static void threaded_thread_cache_resource(benchmark::State& state)
+{
+    threaded_churn(state, &THREAD_CACHE_RESOURCE);
+}
+
+// REGISTER
+// --------
+
+BENCHMARK(list_std_allocator);
+BENCHMARK(list_pool_allocator);
+BENCHMARK(list_new_delete_resource);
+BENCHMARK(list_pool_resource);
+BENCHMARK(map_std_allocator);
+BENCHMARK(map_pool_allocator);
+BENCHMARK(map_new_delete_resource);
+BENCHMARK(map_pool_resource);
+BENCHMARK(threaded_new_delete_resource)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(threaded_pool_resource)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(threaded_thread_cache_resource)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_MAIN();
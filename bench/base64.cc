@@ -0,0 +1,110 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Benchmarks for base16 and base64 encoding and decoding.
+ */
+
+#include <pycpp/stl/sstream.h>
+#include <pycpp/stream/encoding.h>
+#include <pycpp/string/base16.h>
+#include <pycpp/string/base64.h>
+#include <benchmark/benchmark.h>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+/**
+ *  \brief Binary data, similar to a compressed attachment.
+ */
+static string make_binary()
+{
+    string str;
+    uint32_t state = 1;
+    while (str.size() < 1 << 20) {
+        state = state * 1103515245 + 12345;
+        str.push_back(static_cast<char>(state >> 16));
+    }
+    return str;
+}
+
+static const string BINARY = make_binary();
+static const string BASE16 = base16_encode(BINARY);
+static const string BASE64 = base64_encode(BINARY);
+static const string DIGEST = BINARY.substr(0, 32);
+
+// BENCHMARKS
+// ----------
+
+
+static void base64_encode_blob(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(base64_encode(BINARY));
+    }
+    state.SetBytesProcessed(state.iterations() * BINARY.size());
+}
+
+
+static void base64_decode_blob(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(base64_decode(BASE64));
+    }
+    state.SetBytesProcessed(state.iterations() * BASE64.size());
+}
+
+
+static void base64_ostream_blob(benchmark::State& state)
+{
+    for (auto _ : state) {
+        ostringstream sstream;
+        {
+            base64_ostream stream(sstream);
+            stream.write(BINARY.data(), BINARY.size());
+        }
+        benchmark::DoNotOptimize(sstream.str());
+    }
+    state.SetBytesProcessed(state.iterations() * BINARY.size());
+}
+
+
+static void base16_encode_blob(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(base16_encode(BINARY));
+    }
+    state.SetBytesProcessed(state.iterations() * BINARY.size());
+}
+
+
+static void base16_decode_blob(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(base16_decode(BASE16));
+    }
+    state.SetBytesProcessed(state.iterations() * BASE16.size());
+}
+
+
+static void base16_encode_digest(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(base16_encode(DIGEST));
+    }
+    state.SetBytesProcessed(state.iterations() * DIGEST.size());
+}
+
+// REGISTER
+// --------
+
+BENCHMARK(base64_encode_blob);
+BENCHMARK(base64_decode_blob);
+BENCHMARK(base64_ostream_blob);
+BENCHMARK(base16_encode_blob);
+BENCHMARK(base16_decode_blob);
+BENCHMARK(base16_encode_digest);
+
+BENCHMARK_MAIN();
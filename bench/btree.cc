@@ -0,0 +1,147 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Benchmarks for B-tree lookups.
+ *
+ *  Lookups of every key, in a random order, in sets with 4096 and
+ *  1048576 keys: `btree_set` with `less<>`, which searches nodes with
+ *  SIMD compares, `btree_set` with an equivalent comparator, which
+ *  searches nodes one key at a time, and `std::set`.
+ */
+
+#include <pycpp/collections/btree_set.h>
+#include <pycpp/stl/algorithm.h>
+#include <pycpp/stl/functional.h>
+#include <pycpp/stl/vector.h>
+#include <benchmark/benchmark.h>
+#include <set>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+/**
+ *  \brief Comparator equivalent to `less<>`, searched one key at a time.
+ */
+template <typename T>
+struct scalar_less
+{
+    bool operator()(const T& x, const T& y) const noexcept
+    {
+        return x < y;
+    }
+};
+
+
+static uint64_t next_random(uint64_t& state)
+{
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state ^ (state >> 29);
+}
+
+
+template <typename Key>
+static vector<Key> make_keys(size_t count)
+{
+    vector<Key> keys;
+    uint64_t state = 1;
+    for (size_t i = 0; i < count; ++i) {
+        keys.emplace_back(static_cast<Key>(next_random(state) >> 16));
+    }
+    return keys;
+}
+
+
+template <typename Set>
+static void lookup(benchmark::State& state)
+{
+    using key_type = typename Set::key_type;
+    vector<key_type> keys = make_keys<key_type>(static_cast<size_t>(state.range(0)));
+    Set set;
+    for (const key_type& key: keys) {
+        set.insert(key);
+    }
+
+    for (auto _ : state) {
+        size_t count = 0;
+        for (const key_type& key: keys) {
+            count += set.find(key) != set.end();
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+// BENCHMARKS
+// ----------
+
+
+static void btree_int32(benchmark::State& state)
+{
+    lookup<btree_set<int32_t>>(state);
+}
+
+
+static void btree_int32_scalar(benchmark::State& state)
+{
+    lookup<btree_set<int32_t, scalar_less<int32_t>>>(state);
+}
+
+
+static void std_set_int32(benchmark::State& state)
+{
+    lookup<std::set<int32_t>>(state);
+}
+
+
+static void btree_int64(benchmark::State& state)
+{
+    lookup<btree_set<int64_t>>(state);
+}
+
+
+static void btree_int64_scalar(benchmark::State& state)
+{
+    lookup<btree_set<int64_t, scalar_less<int64_t>>>(state);
+}
+
+
+static void std_set_int64(benchmark::State& state)
+{
+    lookup<std::set<int64_t>>(state);
+}
+
+
+static void btree_double(benchmark::State& state)
+{
+    lookup<btree_set<double>>(state);
+}
+
+
+static void btree_double_scalar(benchmark::State& state)
+{
+    lookup<btree_set<double, scalar_less<double>>>(state);
+}
+
+
+static void std_set_double(benchmark::State& state)
+{
+    lookup<std::set<double>>(state);
+}
+
+// REGISTER
+// --------
+
+BENCHMARK(btree_int32)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(btree_int32_scalar)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(std_set_int32)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(btree_int64)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(btree_int64_scalar)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(std_set_int64)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(btree_double)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(btree_double_scalar)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(std_set_double)->Arg(1 << 12)->Arg(1 << 20);
+
+BENCHMARK_MAIN();
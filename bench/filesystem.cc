@@ -0,0 +1,265 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Benchmarks for recursive directory traversal.
+ *
+ *  Walks a generated tree of 4096 directories (16x16x16) with 256
+ *  empty files each, ~1M files in total, with the single-threaded
+ *  `recursive_directory_iterator` and with the parallel `walk`.
+ *  The tree is created under the temporary directory on the first
+ *  run and reused afterwards: remove `pycpp_walk_bench` to
+ *  regenerate it. Set `PYCPP_WALK_ROOT` to walk another tree.
+ *
+ *  Copies a 256 MB file with `copy_file` and with an 8 KB
+ *  `read`/`write` loop (the previous implementation), and a tree
+ *  of 4096 64 KB files with `copy_dir` and `copy_dir_parallel`.
+ */
+
+#include <pycpp/filesystem.h>
+#include <pycpp/stl/atomic.h>
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+static constexpr size_t FANOUT = 16;
+static constexpr size_t LEVELS = 3;
+static constexpr size_t FILES = 256;
+static constexpr size_t BLOB_SIZE = 256 << 20;
+static constexpr size_t COPY_DIRS = 16;
+static constexpr size_t COPY_FILE_SIZE = 64 << 10;
+
+
+static path_t child(const path_t& dir, char prefix, size_t index)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%c%zu", prefix, index);
+    return join_path({dir, name});
+}
+
+
+static void make_level(const path_t& dir, size_t level)
+{
+    mkdir(dir);
+    if (level == LEVELS) {
+        for (size_t i = 0; i < FILES; ++i) {
+            fd_close(fd_open(child(dir, 'f', i), ios_base::out));
+        }
+        return;
+    }
+    for (size_t i = 0; i < FANOUT; ++i) {
+        make_level(child(dir, 'd', i), level + 1);
+    }
+}
+
+
+static path_t make_tree()
+{
+    const char* root = getenv("PYCPP_WALK_ROOT");
+    if (root) {
+        return path_t(root);
+    }
+
+    path_t path = join_path({gettempdir(), "pycpp_walk_bench"});
+    path_t done = join_path({path, "complete"});
+    if (!exists(done)) {
+        if (exists(path)) {
+            remove_path(path);
+        }
+        make_level(path, 0);
+        fd_close(fd_open(done, ios_base::out));
+    }
+    return path;
+}
+
+
+static const path_t& tree()
+{
+    static const path_t path = make_tree();
+    return path;
+}
+
+
+static void write_file(const path_t& path, size_t size)
+{
+    string data(size, 'x');
+    fd_t fd = fd_open(path, ios_base::out);
+    fd_write(fd, data.data(), data.size());
+    fd_close(fd);
+}
+
+
+/**
+ *  \brief Temporary files for the copy benchmarks, removed on exit.
+ */
+struct copy_data
+{
+    path_t root;
+    path_t blob;
+    path_t tree;
+    path_t dst;
+
+    copy_data():
+        root(temporary_directory())
+    {
+        blob = join_path({root, "blob"});
+        tree = join_path({root, "tree"});
+        dst = join_path({root, "dst"});
+        write_file(blob, BLOB_SIZE);
+        mkdir(tree);
+        for (size_t i = 0; i < COPY_DIRS; ++i) {
+            path_t dir = child(tree, 'd', i);
+            mkdir(dir);
+            for (size_t j = 0; j < FILES; ++j) {
+                write_file(child(dir, 'f', j), COPY_FILE_SIZE);
+            }
+        }
+    }
+
+    ~copy_data()
+    {
+        remove_path(root);
+    }
+};
+
+
+static const copy_data& copies()
+{
+    static const copy_data data;
+    return data;
+}
+
+
+/**
+ *  \brief Previous `copy_file` implementation.
+ */
+static void copy_read_write(const path_t& src, const path_t& dst)
+{
+    char buf[8192];
+    int in = ::open(src.data(), O_RDONLY);
+    int out = ::open(dst.data(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ssize_t bytes;
+    while ((bytes = ::read(in, buf, sizeof(buf))) > 0) {
+        ::write(out, buf, bytes);
+    }
+    ::close(out);
+    ::close(in);
+}
+
+// BENCHMARKS
+// ----------
+
+
+static void recursive_iterator(benchmark::State& state)
+{
+    const path_t& root = tree();
+    for (auto _ : state) {
+        size_t count = 0;
+        size_t bytes = 0;
+        recursive_directory_iterator first(root), last;
+        for (; first != last; ++first) {
+            bytes += first->basename().size();
+            ++count;
+        }
+        benchmark::DoNotOptimize(bytes);
+        state.counters["entries"] = count;
+    }
+}
+
+
+static void parallel_walk(benchmark::State& state)
+{
+    const path_t& root = tree();
+    walk_options options;
+    options.threads = static_cast<size_t>(state.range(0));
+    options.stat = state.range(1) != 0;
+
+    for (auto _ : state) {
+        atomic<size_t> count(0);
+        atomic<size_t> bytes(0);
+        walk(root, [&count, &bytes](walk_batch& batch) {
+            size_t length = 0;
+            for (const walk_entry& entry: batch.entries) {
+                length += entry.basename.size();
+            }
+            count += batch.entries.size();
+            bytes += length;
+        }, nullptr, options);
+        benchmark::DoNotOptimize(bytes.load());
+        state.counters["entries"] = count.load();
+    }
+}
+
+
+
+static void copy_file_kernel(benchmark::State& state)
+{
+    const copy_data& data = copies();
+    for (auto _ : state) {
+        copy_file(data.blob, data.dst, true);
+    }
+    remove_file(data.dst);
+    state.SetBytesProcessed(state.iterations() * BLOB_SIZE);
+}
+
+
+static void copy_file_read_write(benchmark::State& state)
+{
+    const copy_data& data = copies();
+    for (auto _ : state) {
+        copy_read_write(data.blob, data.dst);
+    }
+    remove_file(data.dst);
+    state.SetBytesProcessed(state.iterations() * BLOB_SIZE);
+}
+
+
+static void copy_dir_serial(benchmark::State& state)
+{
+    const copy_data& data = copies();
+    for (auto _ : state) {
+        copy_dir(data.tree, data.dst, true, true);
+    }
+    remove_path(data.dst);
+    state.SetBytesProcessed(state.iterations() * COPY_DIRS * FILES * COPY_FILE_SIZE);
+}
+
+
+static void copy_dir_threads(benchmark::State& state)
+{
+    const copy_data& data = copies();
+    size_t threads = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        copy_dir_parallel(data.tree, data.dst, true, threads);
+    }
+    remove_path(data.dst);
+    state.SetBytesProcessed(state.iterations() * COPY_DIRS * FILES * COPY_FILE_SIZE);
+}
+
+// REGISTER
+// --------
+
+BENCHMARK(recursive_iterator)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(parallel_walk)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->ArgNames({"threads", "stat"})
+    ->Args({1, 0})
+    ->Args({2, 0})
+    ->Args({4, 0})
+    ->Args({8, 0})
+    ->Args({1, 1})
+    ->Args({8, 1});
+BENCHMARK(copy_file_kernel)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(copy_file_read_write)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(copy_dir_serial)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(copy_dir_threads)->Unit(benchmark::kMillisecond)->UseRealTime()->Arg(1)->Arg(4)->Arg(8);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,219 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Benchmarks for cryptographic hash throughput.
+ *
+ *  Each hash is benchmarked from 64 bytes to 1 MB. The fastest
+ *  implementation the processor supports is used: to benchmark the
+ *  fallbacks, mask instruction sets with `PYCPP_CPU_DISABLE`, for
+ *  example `PYCPP_CPU_DISABLE=sha` (AVX2) or `PYCPP_CPU_DISABLE=sha,avx2`
+ *  (portable).
+ *
+ *  Batches of 4096 200-byte records are hashed one at a time with a
+ *  hash object, returning a `secure_string` or writing the digest in
+ *  place, and with the multi-buffer batch API.
+ */
+
+#include <pycpp/hashlib.h>
+#include <pycpp/stl/string.h>
+#include <benchmark/benchmark.h>
+#include <stdlib.h>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+/**
+ *  \brief Binary data, similar to a compressed blob.
+ */
+static string make_binary()
+{
+    string str;
+    uint32_t state = 1;
+    while (str.size() < 1 << 20) {
+        state = state * 1103515245 + 12345;
+        str.push_back(static_cast<char>(state >> 16));
+    }
+    return str;
+}
+
+static const string BINARY = make_binary();
+static constexpr size_t RECORD_COUNT = 4096;
+static constexpr size_t RECORD_SIZE = 200;
+
+
+static void set_label(benchmark::State& state)
+{
+    const char* disabled = getenv("PYCPP_CPU_DISABLE");
+    state.SetLabel(disabled ? disabled : "native");
+}
+
+
+template <typename Hash>
+static void hash_blob(benchmark::State& state)
+{
+    set_label(state);
+
+    size_t length = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        Hash hash(BINARY.data(), length);
+        benchmark::DoNotOptimize(hash.digest());
+    }
+    state.SetBytesProcessed(state.iterations() * length);
+}
+
+
+
+template <typename Hash>
+static void hash_records(benchmark::State& state)
+{
+    set_label(state);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < RECORD_COUNT; ++i) {
+            Hash hash(BINARY.data() + i * RECORD_SIZE, RECORD_SIZE);
+            benchmark::DoNotOptimize(hash.digest());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * RECORD_COUNT);
+    state.SetBytesProcessed(state.iterations() * RECORD_COUNT * RECORD_SIZE);
+}
+
+
+template <typename Hash>
+static void hash_records_into(benchmark::State& state)
+{
+    set_label(state);
+
+    typename Hash::digest_type digest;
+    for (auto _ : state) {
+        for (size_t i = 0; i < RECORD_COUNT; ++i) {
+            Hash hash(BINARY.data() + i * RECORD_SIZE, RECORD_SIZE);
+            hash.digest_into(digest);
+            benchmark::DoNotOptimize(digest.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * RECORD_COUNT);
+    state.SetBytesProcessed(state.iterations() * RECORD_COUNT * RECORD_SIZE);
+}
+
+
+template <size_t DigestSize, typename Batch>
+static void hash_batch(benchmark::State& state, Batch batch)
+{
+    set_label(state);
+
+    const void* src[RECORD_COUNT];
+    size_t srclen[RECORD_COUNT];
+    for (size_t i = 0; i < RECORD_COUNT; ++i) {
+        src[i] = BINARY.data() + i * RECORD_SIZE;
+        srclen[i] = RECORD_SIZE;
+    }
+
+    string dst(RECORD_COUNT * DigestSize, '\0');
+    for (auto _ : state) {
+        batch(src, srclen, RECORD_COUNT, &dst[0]);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * RECORD_COUNT);
+    state.SetBytesProcessed(state.iterations() * RECORD_COUNT * RECORD_SIZE);
+}
+
+// BENCHMARKS
+// ----------
+
+
+static void sha1(benchmark::State& state)
+{
+    hash_blob<sha1_hash>(state);
+}
+
+
+static void sha2_256(benchmark::State& state)
+{
+    hash_blob<sha2_256_hash>(state);
+}
+
+
+static void sha2_512(benchmark::State& state)
+{
+    hash_blob<sha2_512_hash>(state);
+}
+
+
+
+static void md5_records(benchmark::State& state)
+{
+    hash_records<md5_hash>(state);
+}
+
+
+static void md5_records_into(benchmark::State& state)
+{
+    hash_records_into<md5_hash>(state);
+}
+
+
+static void md5_batch(benchmark::State& state)
+{
+    using batch_t = void (*)(const void* const*, const size_t*, size_t, void*);
+    hash_batch<16>(state, static_cast<batch_t>(md5_digest_batch));
+}
+
+
+static void sha1_records(benchmark::State& state)
+{
+    hash_records<sha1_hash>(state);
+}
+
+
+static void sha1_records_into(benchmark::State& state)
+{
+    hash_records_into<sha1_hash>(state);
+}
+
+
+static void sha1_batch(benchmark::State& state)
+{
+    using batch_t = void (*)(const void* const*, const size_t*, size_t, void*);
+    hash_batch<20>(state, static_cast<batch_t>(sha1_digest_batch));
+}
+
+
+static void sha2_256_records(benchmark::State& state)
+{
+    hash_records<sha2_256_hash>(state);
+}
+
+
+static void sha2_256_records_into(benchmark::State& state)
+{
+    hash_records_into<sha2_256_hash>(state);
+}
+
+
+static void sha2_256_batch(benchmark::State& state)
+{
+    using batch_t = void (*)(const void* const*, const size_t*, size_t, void*);
+    hash_batch<32>(state, static_cast<batch_t>(sha2_256_digest_batch));
+}
+
+// REGISTER
+// --------
+
+BENCHMARK(sha1)->RangeMultiplier(16)->Range(64, 1 << 20);
+BENCHMARK(sha2_256)->RangeMultiplier(16)->Range(64, 1 << 20);
+BENCHMARK(sha2_512)->RangeMultiplier(16)->Range(64, 1 << 20);
+BENCHMARK(md5_records);
+BENCHMARK(md5_records_into);
+BENCHMARK(md5_batch);
+BENCHMARK(sha1_records);
+BENCHMARK(sha1_records_into);
+BENCHMARK(sha1_batch);
+BENCHMARK(sha2_256_records);
+BENCHMARK(sha2_256_records_into);
+BENCHMARK(sha2_256_batch);
+
+BENCHMARK_MAIN();
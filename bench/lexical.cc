@@ -6,8 +6,12 @@
 #include <pycpp/lexical/atoi.h>
 #include <pycpp/lexical/ftoa.h>
 #include <pycpp/lexical/itoa.h>
+#include <pycpp/stl/random.h>
 #include <pycpp/stl/string.h>
 #include <pycpp/stl/vector.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
 
 PYCPP_USING_NAMESPACE
 
@@ -111,6 +115,115 @@ vector<double> FLOATS = {
 };
 
 
+vector<std::string> LONG_FLOAT_STRINGS = {
+    "1.00000000000000011102230246251565404236316680908203125",
+    "2.4703282292062327208828439643411068618252990130716238221279284125033775364510e-324",
+    "179769313486231580793728971405301e+276",
+    "0.000000000000000000000000000000000000000000012345678901234567890123",
+    "3.14159265358979323846264338327950288419716939937510582097494459",
+};
+
+
+static vector<std::string> random_float_strings()
+{
+    // round-trip (17-digit) representations of random doubles
+    vector<std::string> strings;
+    mt19937_64 gen(0);
+    uniform_real_distribution<double> mantissa(1., 10.);
+    uniform_int_distribution<int> exponent(-300, 300);
+    char buffer[32];
+    for (size_t i = 0; i < 1000; ++i) {
+        double value = mantissa(gen) * pow(10., exponent(gen));
+        snprintf(buffer, sizeof(buffer), "%.17g", value);
+        strings.emplace_back(buffer);
+    }
+    return strings;
+}
+
+vector<std::string> RANDOM_FLOAT_STRINGS = random_float_strings();
+
+
+static vector<double> random_doubles()
+{
+    // random bit patterns, excluding NaN and Inf
+    vector<double> doubles;
+    mt19937_64 gen(0);
+    while (doubles.size() < 1000) {
+        uint64_t bits = gen();
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (isfinite(value)) {
+            doubles.push_back(value);
+        }
+    }
+    return doubles;
+}
+
+vector<double> RANDOM_DOUBLES = random_doubles();
+
+
+static vector<float> random_floats()
+{
+    vector<float> floats;
+    mt19937 gen(0);
+    while (floats.size() < 1000) {
+        uint32_t bits = gen();
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        if (isfinite(value)) {
+            floats.push_back(value);
+        }
+    }
+    return floats;
+}
+
+vector<float> RANDOM_FLOATS = random_floats();
+
+
+static vector<uint64_t> random_integers()
+{
+    // uniform bit lengths, so every digit count is represented
+    vector<uint64_t> integers;
+    mt19937_64 gen(0);
+    for (size_t i = 0; i < 1000; ++i) {
+        integers.push_back(gen() >> (gen() % 64));
+    }
+    return integers;
+}
+
+vector<uint64_t> RANDOM_INTEGERS = random_integers();
+
+
+static vector<std::string> random_integer_strings(int base)
+{
+    vector<std::string> strings;
+    const char* format = base == 16 ? "%llx" : "%llu";
+    char buffer[32];
+    for (auto n: RANDOM_INTEGERS) {
+        snprintf(buffer, sizeof(buffer), format, (unsigned long long) n);
+        strings.emplace_back(buffer);
+    }
+    return strings;
+}
+
+vector<std::string> RANDOM_INTEGER_STRINGS = random_integer_strings(10);
+vector<std::string> RANDOM_HEX_STRINGS = random_integer_strings(16);
+
+
+static std::string join_integer_strings()
+{
+    std::string joined;
+    for (const auto& s: RANDOM_INTEGER_STRINGS) {
+        joined += s;
+        joined += ',';
+    }
+    joined.pop_back();
+    return joined;
+}
+
+std::string JOINED_INTEGER_STRINGS = join_integer_strings();
+
+
 static void std_strtoll(benchmark::State& state)
 {
     for (auto _ : state) {
@@ -131,6 +244,55 @@ static void atoi64(benchmark::State& state)
 }
 
 
+static void std_strtoull_random(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (const auto& s: RANDOM_INTEGER_STRINGS) {
+            benchmark::DoNotOptimize(std::strtoull(s.data(), nullptr, 10));
+        }
+    }
+}
+
+
+static void atou64_random(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (const auto& s: RANDOM_INTEGER_STRINGS) {
+            benchmark::DoNotOptimize(atou64(s, 10));
+        }
+    }
+}
+
+
+static void std_strtoull_random_base16(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (const auto& s: RANDOM_HEX_STRINGS) {
+            benchmark::DoNotOptimize(std::strtoull(s.data(), nullptr, 16));
+        }
+    }
+}
+
+
+static void atou64_random_base16(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (const auto& s: RANDOM_HEX_STRINGS) {
+            benchmark::DoNotOptimize(atou64(s, 16));
+        }
+    }
+}
+
+
+static void atou64_batch(benchmark::State& state)
+{
+    vector<uint64_t> values(RANDOM_INTEGERS.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(atou64_batch(JOINED_INTEGER_STRINGS, values.data(), values.size()));
+    }
+}
+
+
 static void std_to_string(benchmark::State& state)
 {
     for (auto _ : state) {
@@ -171,6 +333,53 @@ static void i64toa_base16(benchmark::State& state)
 }
 
 
+static void std_snprintf_integer_random(benchmark::State& state)
+{
+    char buffer[32];
+    for (auto _ : state) {
+        for (auto n: RANDOM_INTEGERS) {
+            benchmark::DoNotOptimize(snprintf(buffer, sizeof(buffer), "%llu", (unsigned long long) n));
+        }
+    }
+}
+
+
+static void u64toa_random(benchmark::State& state)
+{
+    char buffer[32];
+    for (auto _ : state) {
+        for (auto n: RANDOM_INTEGERS) {
+            char* last = buffer + sizeof(buffer);
+            u64toa(n, buffer, last, 10);
+            benchmark::DoNotOptimize(last);
+        }
+    }
+}
+
+
+static void u64toa_random_base16(benchmark::State& state)
+{
+    char buffer[32];
+    for (auto _ : state) {
+        for (auto n: RANDOM_INTEGERS) {
+            char* last = buffer + sizeof(buffer);
+            u64toa(n, buffer, last, 16);
+            benchmark::DoNotOptimize(last);
+        }
+    }
+}
+
+
+static void u64toa_batch(benchmark::State& state)
+{
+    vector<char> buffer(RANDOM_INTEGERS.size() * 21 + 1);
+    for (auto _ : state) {
+        char* last = buffer.data() + buffer.size();
+        benchmark::DoNotOptimize(u64toa_batch(RANDOM_INTEGERS.data(), RANDOM_INTEGERS.size(), buffer.data(), last));
+    }
+}
+
+
 static void std_strtod(benchmark::State& state)
 {
     for (auto _ : state) {
@@ -190,17 +399,163 @@ static void atof64(benchmark::State& state)
     }
 }
 
+
+
+static void std_strtof(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (const auto& s: FLOAT_STRINGS) {
+            benchmark::DoNotOptimize(std::strtof(s.data(), nullptr));
+        }
+    }
+}
+
+
+static void atof32(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (const auto& s: FLOAT_STRINGS) {
+            benchmark::DoNotOptimize(atof32(s, 10));
+        }
+    }
+}
+
+
+static void std_strtod_random(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (const auto& s: RANDOM_FLOAT_STRINGS) {
+            benchmark::DoNotOptimize(std::strtod(s.data(), nullptr));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * RANDOM_FLOAT_STRINGS.size());
+}
+
+
+static void atof64_random(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (const auto& s: RANDOM_FLOAT_STRINGS) {
+            benchmark::DoNotOptimize(atof64(s, 10));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * RANDOM_FLOAT_STRINGS.size());
+}
+
+
+static void std_strtod_long(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (const auto& s: LONG_FLOAT_STRINGS) {
+            benchmark::DoNotOptimize(std::strtod(s.data(), nullptr));
+        }
+    }
+}
+
+
+static void atof64_long(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (const auto& s: LONG_FLOAT_STRINGS) {
+            benchmark::DoNotOptimize(atof64(s, 10));
+        }
+    }
+}
+
+
+
+static void std_snprintf_double(benchmark::State& state)
+{
+    char buffer[32];
+    for (auto _ : state) {
+        for (double d: FLOATS) {
+            benchmark::DoNotOptimize(snprintf(buffer, sizeof(buffer), "%.17g", d));
+        }
+    }
+}
+
+
+static void f64toa(benchmark::State& state)
+{
+    char buffer[32];
+    for (auto _ : state) {
+        for (double d: FLOATS) {
+            char* last = buffer + sizeof(buffer);
+            f64toa(d, buffer, last, 10);
+            benchmark::DoNotOptimize(last);
+        }
+    }
+}
+
+
+static void std_snprintf_double_random(benchmark::State& state)
+{
+    char buffer[32];
+    for (auto _ : state) {
+        for (double d: RANDOM_DOUBLES) {
+            benchmark::DoNotOptimize(snprintf(buffer, sizeof(buffer), "%.17g", d));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * RANDOM_DOUBLES.size());
+}
+
+
+static void f64toa_random(benchmark::State& state)
+{
+    char buffer[32];
+    for (auto _ : state) {
+        for (double d: RANDOM_DOUBLES) {
+            char* last = buffer + sizeof(buffer);
+            f64toa(d, buffer, last, 10);
+            benchmark::DoNotOptimize(last);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * RANDOM_DOUBLES.size());
+}
+
+
+static void f32toa_random(benchmark::State& state)
+{
+    char buffer[32];
+    for (auto _ : state) {
+        for (float f: RANDOM_FLOATS) {
+            char* last = buffer + sizeof(buffer);
+            f32toa(f, buffer, last, 10);
+            benchmark::DoNotOptimize(last);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * RANDOM_FLOATS.size());
+}
+
 // REGISTER
 // --------
 
 BENCHMARK(std_strtoll);
 BENCHMARK(atoi64);
+BENCHMARK(std_strtoull_random);
+BENCHMARK(atou64_random);
+BENCHMARK(std_strtoull_random_base16);
+BENCHMARK(atou64_random_base16);
+BENCHMARK(atou64_batch);
 BENCHMARK(std_to_string);
 BENCHMARK(i64toa);
 BENCHMARK(i64toa_base2);
 BENCHMARK(i64toa_base16);
+BENCHMARK(std_snprintf_integer_random);
+BENCHMARK(u64toa_random);
+BENCHMARK(u64toa_random_base16);
+BENCHMARK(u64toa_batch);
 BENCHMARK(std_strtod);
 BENCHMARK(atof64);
-// TODO: std_to_string_double
-// TODO: ftoa
+BENCHMARK(std_strtof);
+BENCHMARK(atof32);
+BENCHMARK(std_strtod_random);
+BENCHMARK(atof64_random);
+BENCHMARK(std_strtod_long);
+BENCHMARK(atof64_long);
+BENCHMARK(std_snprintf_double);
+BENCHMARK(f64toa);
+BENCHMARK(std_snprintf_double_random);
+BENCHMARK(f64toa_random);
+BENCHMARK(f32toa_random);
 BENCHMARK_MAIN();
\ No newline at end of file
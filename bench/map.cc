@@ -0,0 +1,214 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Benchmarks for hash map lookups.
+ *
+ *  Lookups of every key, in a shuffled order, in `robin_map` and
+ *  `ordered_map` with 16384 keys. Each map is benchmarked with the
+ *  default hash (XXH3 for strings, a multiply-fold mixer for
+ *  integers) and with the previous defaults (XXH64 for strings,
+ *  the identity `std::hash` for integers).
+ *
+ *  Strided integer keys, such as aligned addresses or IDs with
+ *  tag bits in the low bits, share their low bits: with the
+ *  identity hash, they collide in power-of-two tables.
+ */
+
+#include <pycpp/collections/ordered_map.h>
+#include <pycpp/collections/robin_map.h>
+#include <pycpp/stl/algorithm.h>
+#include <pycpp/stl/functional.h>
+#include <pycpp/stl/string.h>
+#include <pycpp/stl/vector.h>
+#include <benchmark/benchmark.h>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+static constexpr size_t KEY_COUNT = 16384;
+
+/**
+ *  \brief Previous default string hash.
+ */
+struct xxh64_hash
+{
+    size_t operator()(const string& x) const noexcept
+    {
+        return XXH64(x.data(), x.size(), HASH_SEED);
+    }
+};
+
+
+static uint64_t next_random(uint64_t& state)
+{
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state ^ (state >> 29);
+}
+
+
+template <typename Key>
+static void shuffle_keys(vector<Key>& keys)
+{
+    uint64_t state = 2;
+    for (size_t i = keys.size(); i > 1; --i) {
+        swap(keys[i - 1], keys[next_random(state) % i]);
+    }
+}
+
+
+static vector<string> make_strings()
+{
+    vector<string> keys;
+    for (size_t i = 0; i < KEY_COUNT; ++i) {
+        // "user:" followed by a number, digits in reverse order
+        string key = "user:";
+        for (size_t value = i * 7919 + 1; value; value /= 10) {
+            key.push_back(static_cast<char>('0' + value % 10));
+        }
+        keys.emplace_back(move(key));
+    }
+    return keys;
+}
+
+
+static vector<uint64_t> make_random()
+{
+    vector<uint64_t> keys;
+    uint64_t state = 1;
+    for (size_t i = 0; i < KEY_COUNT; ++i) {
+        keys.emplace_back(next_random(state));
+    }
+    return keys;
+}
+
+
+static vector<uint64_t> make_strided()
+{
+    vector<uint64_t> keys;
+    for (size_t i = 0; i < KEY_COUNT; ++i) {
+        keys.emplace_back(i << 8);
+    }
+    return keys;
+}
+
+
+static const vector<string> STRINGS = make_strings();
+static const vector<uint64_t> RANDOM = make_random();
+static const vector<uint64_t> STRIDED = make_strided();
+
+
+template <typename Map, typename Key>
+static void lookup(benchmark::State& state, const vector<Key>& keys)
+{
+    Map map;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        map.emplace(keys[i], i);
+    }
+    vector<Key> order(keys);
+    shuffle_keys(order);
+
+    for (auto _ : state) {
+        size_t sum = 0;
+        for (const Key& key: order) {
+            sum += map.find(key)->second;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+// BENCHMARKS
+// ----------
+
+
+static void robin_string(benchmark::State& state)
+{
+    lookup<robin_map<string, size_t>>(state, STRINGS);
+}
+
+
+static void robin_string_xxh64(benchmark::State& state)
+{
+    lookup<robin_map<string, size_t, xxh64_hash>>(state, STRINGS);
+}
+
+
+static void robin_random(benchmark::State& state)
+{
+    lookup<robin_map<uint64_t, size_t>>(state, RANDOM);
+}
+
+
+static void robin_random_identity(benchmark::State& state)
+{
+    lookup<robin_map<uint64_t, size_t, std::hash<uint64_t>>>(state, RANDOM);
+}
+
+
+static void robin_strided(benchmark::State& state)
+{
+    lookup<robin_map<uint64_t, size_t>>(state, STRIDED);
+}
+
+
+static void robin_strided_identity(benchmark::State& state)
+{
+    lookup<robin_map<uint64_t, size_t, std::hash<uint64_t>>>(state, STRIDED);
+}
+
+
+static void ordered_string(benchmark::State& state)
+{
+    lookup<ordered_map<string, size_t>>(state, STRINGS);
+}
+
+
+static void ordered_string_xxh64(benchmark::State& state)
+{
+    lookup<ordered_map<string, size_t, xxh64_hash>>(state, STRINGS);
+}
+
+
+static void ordered_random(benchmark::State& state)
+{
+    lookup<ordered_map<uint64_t, size_t>>(state, RANDOM);
+}
+
+
+static void ordered_random_identity(benchmark::State& state)
+{
+    lookup<ordered_map<uint64_t, size_t, std::hash<uint64_t>>>(state, RANDOM);
+}
+
+
+static void ordered_strided(benchmark::State& state)
+{
+    lookup<ordered_map<uint64_t, size_t>>(state, STRIDED);
+}
+
+
+static void ordered_strided_identity(benchmark::State& state)
+{
+    lookup<ordered_map<uint64_t, size_t, std::hash<uint64_t>>>(state, STRIDED);
+}
+
+// REGISTER
+// --------
+
+BENCHMARK(robin_string);
+BENCHMARK(robin_string_xxh64);
+BENCHMARK(robin_random);
+BENCHMARK(robin_random_identity);
+BENCHMARK(robin_strided);
+BENCHMARK(robin_strided_identity);
+BENCHMARK(ordered_string);
+BENCHMARK(ordered_string_xxh64);
+BENCHMARK(ordered_random);
+BENCHMARK(ordered_random_identity);
+BENCHMARK(ordered_strided);
+BENCHMARK(ordered_strided_identity);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,106 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Benchmarks for numerical reductions.
+ */
+
+#include <pycpp/math/average.h>
+#include <pycpp/math/dot.h>
+#include <pycpp/math/std.h>
+#include <pycpp/stl/deque.h>
+#include <pycpp/stl/vector.h>
+#include <benchmark/benchmark.h>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+static vector<double> make_values(size_t n)
+{
+    vector<double> values(n);
+    for (size_t i = 0; i < n; ++i) {
+        values[i] = static_cast<double>(i % 1000) * 0.001;
+    }
+    return values;
+}
+
+static const vector<double> VALUES = make_values(1 << 20);
+static const deque<double> DEQUE(VALUES.begin(), VALUES.end());
+
+// BENCHMARKS
+// ----------
+
+
+static void average_deque(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(average(DEQUE.begin(), DEQUE.end()));
+    }
+    state.SetBytesProcessed(state.iterations() * VALUES.size() * sizeof(double));
+}
+
+
+static void average_vector(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(average(VALUES.begin(), VALUES.end()));
+    }
+    state.SetBytesProcessed(state.iterations() * VALUES.size() * sizeof(double));
+}
+
+
+static void sum_kahan(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(reduce_sum(VALUES.data(), VALUES.size(), summation_kahan));
+    }
+    state.SetBytesProcessed(state.iterations() * VALUES.size() * sizeof(double));
+}
+
+
+static void sum_pairwise(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(reduce_sum(VALUES.data(), VALUES.size(), summation_pairwise));
+    }
+    state.SetBytesProcessed(state.iterations() * VALUES.size() * sizeof(double));
+}
+
+
+static void dot_vector(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dot(VALUES.begin(), VALUES.end(), VALUES.begin(), VALUES.end()));
+    }
+    state.SetBytesProcessed(state.iterations() * VALUES.size() * sizeof(double));
+}
+
+
+static void variance_deque(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(variance(DEQUE.begin(), DEQUE.end()));
+    }
+    state.SetBytesProcessed(state.iterations() * VALUES.size() * sizeof(double));
+}
+
+
+static void variance_vector(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(variance(VALUES.begin(), VALUES.end()));
+    }
+    state.SetBytesProcessed(state.iterations() * VALUES.size() * sizeof(double));
+}
+
+
+BENCHMARK(average_deque);
+BENCHMARK(average_vector);
+BENCHMARK(sum_kahan);
+BENCHMARK(sum_pairwise);
+BENCHMARK(dot_vector);
+BENCHMARK(variance_deque);
+BENCHMARK(variance_vector);
+BENCHMARK_MAIN();
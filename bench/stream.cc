@@ -0,0 +1,219 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Benchmarks for sequential file streams.
+ *
+ *  Scans a 256 MB file of text lines with `fd_istream`, which issues
+ *  one blocking read per 4 KB buffer, and with `aio_istream`, which
+ *  keeps several reads in flight while the lines are parsed. Each
+ *  scan sums the integer at the start of each line.
+ *
+ *  The "cold" variants evict the file from the page cache before
+ *  each scan (`posix_fadvise(POSIX_FADV_DONTNEED)`), to approximate
+ *  a file on cold storage.
+ *
+ *  The same file is mapped whole and scanned with each `mmap_options`
+ *  setting, reporting the page faults per scan, and read line by
+ *  line through the sliding `mmap_window_ifstream`.
+ */
+
+#include <pycpp/filesystem.h>
+#include <pycpp/stream/aio.h>
+#include <pycpp/stream/fd.h>
+#include <pycpp/stream/mmap.h>
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/resource.h>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+static constexpr size_t FILE_SIZE = 256 << 20;
+
+
+/**
+ *  \brief Temporary file of short numbered lines, removed on exit.
+ */
+struct stream_data
+{
+    path_t root;
+    path_t path;
+
+    stream_data():
+        root(temporary_directory())
+    {
+        path = join_path({root, "lines"});
+        fd_t fd = fd_open(path, ios_base::out);
+        fd_ostream stream(fd, true);
+        char line[64];
+        for (size_t size = 0, i = 0; size < FILE_SIZE; ++i) {
+            int length = snprintf(line, sizeof(line), "%zu,field,another field,%zu\n", i % 1000, i);
+            stream.write(line, length);
+            size += length;
+        }
+    }
+
+    ~stream_data()
+    {
+        remove_path(root);
+    }
+};
+
+
+static const path_t& data()
+{
+    static const stream_data data;
+    return data.path;
+}
+
+
+static void evict(fd_t fd)
+{
+#if defined(HAVE_POSIX_FADVISE)
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#else
+    (void) fd;
+#endif
+}
+
+
+template <typename IStream>
+static void open(IStream& stream, const path_t& path, bool cold)
+{
+    fd_t fd = fd_open(path, ios_base::in);
+    if (cold) {
+        evict(fd);
+    }
+    stream.open(fd, true);
+}
+
+
+static void open(mmap_window_ifstream& stream, const path_t& path, bool)
+{
+    stream.open(path);
+}
+
+
+template <typename IStream>
+static void scan(benchmark::State& state, bool cold)
+{
+    const path_t& path = data();
+    for (auto _ : state) {
+        IStream stream;
+        open(stream, path, cold);
+        string line;
+        size_t sum = 0;
+        while (getline(stream, line)) {
+            sum += strtoul(line.data(), nullptr, 10);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * FILE_SIZE);
+}
+
+
+static size_t page_faults()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt + usage.ru_majflt;
+}
+
+// BENCHMARKS
+// ----------
+
+
+static void fd_stream_warm(benchmark::State& state)
+{
+    scan<fd_istream>(state, false);
+}
+
+
+static void aio_stream_warm(benchmark::State& state)
+{
+    scan<aio_istream>(state, false);
+}
+
+
+static void fd_stream_cold(benchmark::State& state)
+{
+    scan<fd_istream>(state, true);
+}
+
+
+static void aio_stream_cold(benchmark::State& state)
+{
+    scan<aio_istream>(state, true);
+}
+
+
+/**
+ *  \brief Scan a whole-file mapping, reading a byte per cache line.
+ *
+ *  Arguments are the advice, prefaulting, huge pages, and whether
+ *  to evict the file from the page cache first.
+ */
+static void mmap_scan(benchmark::State& state)
+{
+    const path_t& path = data();
+    mmap_options options(static_cast<mmap_advice>(state.range(0)), state.range(1) != 0, state.range(2) != 0);
+    size_t faults = 0;
+    for (auto _ : state) {
+        if (state.range(3)) {
+            state.PauseTiming();
+            fd_t fd = fd_open(path, ios_base::in);
+            evict(fd);
+            fd_close(fd);
+            state.ResumeTiming();
+        }
+        size_t before = page_faults();
+        mmap_ifstream stream(path);
+        stream.map(0, getsize(path), options);
+        const char* first = stream.data();
+        size_t size = stream.size();
+        size_t sum = 0;
+        for (size_t i = 0; i < size; i += 64) {
+            sum += first[i];
+        }
+        benchmark::DoNotOptimize(sum);
+        stream.close();
+        faults += page_faults() - before;
+    }
+    state.counters["faults"] = static_cast<double>(faults) / state.iterations();
+    state.SetBytesProcessed(state.iterations() * FILE_SIZE);
+}
+
+
+static void mmap_window_stream(benchmark::State& state)
+{
+    scan<mmap_window_ifstream>(state, false);
+}
+
+// REGISTER
+// --------
+
+BENCHMARK(fd_stream_warm)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(aio_stream_warm)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(fd_stream_cold)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(aio_stream_cold)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(mmap_window_stream)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(mmap_scan)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->ArgNames({"advice", "populate", "huge", "cold"})
+    ->Args({mmap_normal, 0, 0, 0})
+    ->Args({mmap_sequential, 0, 0, 0})
+    ->Args({mmap_random, 0, 0, 0})
+    ->Args({mmap_normal, 1, 0, 0})
+    ->Args({mmap_sequential, 0, 1, 0})
+    ->Args({mmap_normal, 0, 0, 1})
+    ->Args({mmap_sequential, 0, 0, 1})
+    ->Args({mmap_random, 0, 0, 1})
+    ->Args({mmap_willneed, 0, 0, 1})
+    ->Args({mmap_normal, 1, 0, 1});
+
+BENCHMARK_MAIN();
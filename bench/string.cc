@@ -0,0 +1,105 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Benchmarks for string splitting.
+ */
+
+#include <pycpp/string/split.h>
+#include <pycpp/string/string.h>
+#include <benchmark/benchmark.h>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+static string make_csv()
+{
+    string str;
+    for (size_t i = 0; i < 4096; ++i) {
+        str += "field";
+        str += static_cast<char>('0' + (i % 10));
+        str += (i % 16 == 15) ? '\n' : ',';
+    }
+    return str;
+}
+
+static const string CSV = make_csv();
+
+// BENCHMARKS
+// ----------
+
+
+static void split_char(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(split(CSV, ","));
+    }
+}
+
+
+static void splititer_char(benchmark::State& state)
+{
+    for (auto _ : state) {
+        size_t bytes = 0;
+        for (string_view token: splititer(CSV, ',')) {
+            bytes += token.size();
+        }
+        benchmark::DoNotOptimize(bytes);
+    }
+}
+
+
+static void split_charset(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(split(CSV, ",\n"));
+    }
+}
+
+
+static void split_lambda(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(split(CSV, [](char c) {
+            return c == ',' || c == '\n';
+        }));
+    }
+}
+
+
+static void splititer_charset(benchmark::State& state)
+{
+    for (auto _ : state) {
+        size_t bytes = 0;
+        for (string_view token: splititer(CSV, ",\n")) {
+            bytes += token.size();
+        }
+        benchmark::DoNotOptimize(bytes);
+    }
+}
+
+
+static void splititer_predicate(benchmark::State& state)
+{
+    for (auto _ : state) {
+        size_t bytes = 0;
+        for (string_view token: splititer(CSV, [](char c) { return c == ',' || c == '\n'; })) {
+            bytes += token.size();
+        }
+        benchmark::DoNotOptimize(bytes);
+    }
+}
+
+// REGISTER
+// --------
+
+BENCHMARK(split_char);
+BENCHMARK(splititer_char);
+BENCHMARK(split_charset);
+BENCHMARK(split_lambda);
+BENCHMARK(splititer_charset);
+BENCHMARK(splititer_predicate);
+
+BENCHMARK_MAIN();
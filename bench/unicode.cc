@@ -0,0 +1,167 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Benchmarks for Unicode validation and conversions.
+ */
+
+#include <pycpp/string/unicode.h>
+#include <benchmark/benchmark.h>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+/**
+ *  \brief Mostly ASCII text, with occasional accented characters.
+ */
+static string make_ascii()
+{
+    string str;
+    while (str.size() < 65536) {
+        str += "The quick brown fox jumps over the lazy dog, r\xc3\xa4ksm\xc3\xb6rg\xc3\xa5s. ";
+    }
+    return str;
+}
+
+
+/**
+ *  \brief Mostly CJK text (3-byte UTF-8), with ASCII punctuation.
+ */
+static string make_cjk()
+{
+    string str;
+    while (str.size() < 65536) {
+        str += "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe6\x96\x87\xe7\xab\xa0, ";
+        str += "\xed\x95\x9c\xea\xb5\xad\xec\x96\xb4 \xe4\xb8\xad\xe6\x96\x87. ";
+    }
+    return str;
+}
+
+static const string ASCII = make_ascii();
+static const string CJK = make_cjk();
+static const string ASCII_UTF16 = utf8_to_utf16(ASCII);
+static const string CJK_UTF16 = utf8_to_utf16(CJK);
+static const string ASCII_UTF32 = utf8_to_utf32(ASCII);
+static const string CJK_UTF32 = utf8_to_utf32(CJK);
+
+// BENCHMARKS
+// ----------
+
+
+static void is_valid_utf8_ascii(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(is_valid_utf8(ASCII));
+    }
+    state.SetBytesProcessed(state.iterations() * ASCII.size());
+}
+
+
+static void is_valid_utf8_cjk(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(is_valid_utf8(CJK));
+    }
+    state.SetBytesProcessed(state.iterations() * CJK.size());
+}
+
+
+static void is_unicode_ascii(benchmark::State& state)
+{
+    string str(65536, 'a');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(is_unicode(str));
+    }
+    state.SetBytesProcessed(state.iterations() * str.size());
+}
+
+
+static void utf8_to_utf16_ascii(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utf8_to_utf16(ASCII));
+    }
+    state.SetBytesProcessed(state.iterations() * ASCII.size());
+}
+
+
+static void utf8_to_utf16_cjk(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utf8_to_utf16(CJK));
+    }
+    state.SetBytesProcessed(state.iterations() * CJK.size());
+}
+
+
+static void utf8_to_utf32_ascii(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utf8_to_utf32(ASCII));
+    }
+    state.SetBytesProcessed(state.iterations() * ASCII.size());
+}
+
+
+static void utf8_to_utf32_cjk(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utf8_to_utf32(CJK));
+    }
+    state.SetBytesProcessed(state.iterations() * CJK.size());
+}
+
+
+static void utf16_to_utf8_ascii(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utf16_to_utf8(ASCII_UTF16));
+    }
+    state.SetBytesProcessed(state.iterations() * ASCII_UTF16.size());
+}
+
+
+static void utf16_to_utf8_cjk(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utf16_to_utf8(CJK_UTF16));
+    }
+    state.SetBytesProcessed(state.iterations() * CJK_UTF16.size());
+}
+
+
+static void utf32_to_utf8_ascii(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utf32_to_utf8(ASCII_UTF32));
+    }
+    state.SetBytesProcessed(state.iterations() * ASCII_UTF32.size());
+}
+
+
+static void utf32_to_utf8_cjk(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utf32_to_utf8(CJK_UTF32));
+    }
+    state.SetBytesProcessed(state.iterations() * CJK_UTF32.size());
+}
+
+// REGISTER
+// --------
+
+BENCHMARK(is_valid_utf8_ascii);
+BENCHMARK(is_valid_utf8_cjk);
+BENCHMARK(is_unicode_ascii);
+BENCHMARK(utf8_to_utf16_ascii);
+BENCHMARK(utf8_to_utf16_cjk);
+BENCHMARK(utf8_to_utf32_ascii);
+BENCHMARK(utf8_to_utf32_cjk);
+BENCHMARK(utf16_to_utf8_ascii);
+BENCHMARK(utf16_to_utf8_cjk);
+BENCHMARK(utf32_to_utf8_ascii);
+BENCHMARK(utf32_to_utf8_cjk);
+
+BENCHMARK_MAIN();
@@ -9,6 +9,10 @@
 
 // TODO: add custom allocators
 #include <pycpp/allocator/crt.h>
+#include <pycpp/allocator/fixed_pool.h>
+#include <pycpp/allocator/page.h>
+#include <pycpp/allocator/pool.h>
 #include <pycpp/allocator/secure.h>
 #include <pycpp/allocator/stack.h>
 #include <pycpp/allocator/standard.h>
+#include <pycpp/allocator/thread_cache.h>
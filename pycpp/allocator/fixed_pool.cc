@@ -0,0 +1,181 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/allocator/fixed_pool.h>
+#include <pycpp/stl/algorithm.h>
+#include <pycpp/stl/new.h>
+#include <pycpp/stl/utility.h>
+#include <assert.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// CONSTANTS
+// ---------
+
+static constexpr size_t DEFAULT_CHUNK_SIZE = 16384;
+static constexpr size_t MIN_BLOCKS_PER_CHUNK = 8;
+
+// HELPERS
+// -------
+
+
+static size_t align_up(size_t n, size_t alignment) noexcept
+{
+    return (n + (alignment-1)) & ~(alignment-1);
+}
+
+// OBJECTS
+// -------
+
+
+fixed_pool::fixed_pool(size_t block_size, size_t blocks_per_chunk, size_t alignment, size_t max_blocks, memory_resource* upstream):
+    block_size_(align_up(max(block_size, sizeof(node)), max(alignment, alignof(node)))),
+    blocks_per_chunk_(blocks_per_chunk),
+    alignment_(max(alignment, alignof(node))),
+    max_blocks_(max_blocks),
+    upstream_(upstream ? upstream : new_delete_resource())
+{
+    assert((alignment_ & (alignment_-1)) == 0 && "Alignment must be a power of 2.");
+    if (blocks_per_chunk_ == 0) {
+        blocks_per_chunk_ = max(DEFAULT_CHUNK_SIZE / block_size_, MIN_BLOCKS_PER_CHUNK);
+    }
+}
+
+
+fixed_pool::fixed_pool(fixed_pool&& rhs) noexcept:
+    block_size_(rhs.block_size_),
+    blocks_per_chunk_(rhs.blocks_per_chunk_),
+    alignment_(rhs.alignment_),
+    max_blocks_(rhs.max_blocks_),
+    upstream_(rhs.upstream_)
+{
+    swap(rhs);
+}
+
+
+fixed_pool& fixed_pool::operator=(fixed_pool&& rhs) noexcept
+{
+    swap(rhs);
+    return *this;
+}
+
+
+fixed_pool::~fixed_pool() noexcept
+{
+    release();
+}
+
+
+/**
+ *  \brief Request a chunk from upstream and return its first block.
+ */
+void* fixed_pool::allocate_chunk()
+{
+    size_t count = blocks_per_chunk_;
+    if (max_blocks_) {
+        if (capacity_ >= max_blocks_) {
+            throw bad_alloc();
+        }
+        count = min(count, max_blocks_ - capacity_);
+    }
+
+    size_t header = header_size();
+    byte* chunk = static_cast<byte*>(upstream_->allocate(header + count * block_size_, alignment_));
+    node* n = reinterpret_cast<node*>(chunk);
+    n->next = chunks_;
+    chunks_ = n;
+    capacity_ += count;
+
+    byte* first = chunk + header;
+    cursor_ = first + block_size_;
+    end_ = first + count * block_size_;
+    return first;
+}
+
+
+/**
+ *  \brief Return every chunk upstream, invalidating all blocks.
+ */
+void fixed_pool::release() noexcept
+{
+    // only the newest chunk, first in the list, may be shorter,
+    // when `max_blocks` truncates it
+    size_t header = header_size();
+    size_t remaining = capacity_;
+    while (chunks_) {
+        node* next = chunks_->next;
+        size_t count = remaining % blocks_per_chunk_;
+        count = count ? count : blocks_per_chunk_;
+        upstream_->deallocate(chunks_, header + count * block_size_, alignment_);
+        remaining -= count;
+        chunks_ = next;
+    }
+
+    free_ = nullptr;
+    cursor_ = nullptr;
+    end_ = nullptr;
+    capacity_ = 0;
+}
+
+
+void fixed_pool::swap(fixed_pool& rhs) noexcept
+{
+    using PYCPP_NAMESPACE::swap;
+    swap(free_, rhs.free_);
+    swap(cursor_, rhs.cursor_);
+    swap(end_, rhs.end_);
+    swap(chunks_, rhs.chunks_);
+    swap(block_size_, rhs.block_size_);
+    swap(blocks_per_chunk_, rhs.blocks_per_chunk_);
+    swap(alignment_, rhs.alignment_);
+    swap(max_blocks_, rhs.max_blocks_);
+    swap(capacity_, rhs.capacity_);
+    swap(upstream_, rhs.upstream_);
+}
+
+
+size_t fixed_pool::block_size() const noexcept
+{
+    return block_size_;
+}
+
+
+size_t fixed_pool::blocks_per_chunk() const noexcept
+{
+    return blocks_per_chunk_;
+}
+
+
+size_t fixed_pool::alignment() const noexcept
+{
+    return alignment_;
+}
+
+
+size_t fixed_pool::max_blocks() const noexcept
+{
+    return max_blocks_;
+}
+
+
+/**
+ *  \brief Number of blocks carved from all chunks.
+ */
+size_t fixed_pool::capacity() const noexcept
+{
+    return capacity_;
+}
+
+
+memory_resource* fixed_pool::upstream() const noexcept
+{
+    return upstream_;
+}
+
+
+size_t fixed_pool::header_size() const noexcept
+{
+    return align_up(sizeof(node), alignment_);
+}
+
+PYCPP_END_NAMESPACE
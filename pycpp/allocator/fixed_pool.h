@@ -1,6 +1,158 @@
-// Like a pool but fixed pool size.
-// Throws bad_alloc if the pool is exceeded.
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Pool of fixed-size memory blocks.
+ *
+ *  A pool that hands out blocks of a single size, in constant time,
+ *  from chunks requested from an upstream resource. Freed blocks are
+ *  threaded onto an intrusive free list, which stores the link in
+ *  the block itself, and are reused before any new block is carved
+ *  from the current chunk. Chunks are only returned to the upstream
+ *  resource by `release()` or the destructor.
+ *
+ *  A non-zero `max_blocks` bounds the size of the pool: once
+ *  `max_blocks` blocks are in use, `allocate` throws `bad_alloc`.
+ *
+ *  `fixed_pool` is not thread-safe.
+ *
+ *  \synopsis
+ *      class fixed_pool
+ *      {
+ *      public:
+ *          fixed_pool(size_t block_size, size_t blocks_per_chunk = 0, size_t alignment = alignof(max_align_t), size_t max_blocks = 0, memory_resource* upstream = nullptr);
+ *          fixed_pool(const fixed_pool&) = delete;
+ *          fixed_pool& operator=(const fixed_pool&) = delete;
+ *          fixed_pool(fixed_pool&&) noexcept;
+ *          fixed_pool& operator=(fixed_pool&&) noexcept;
+ *          ~fixed_pool() noexcept;
+ *
+ *          void* allocate();
+ *          void deallocate(void* p) noexcept;
+ *          void release() noexcept;
+ *          void swap(fixed_pool& rhs) noexcept;
+ *
+ *          size_t block_size() const noexcept;
+ *          size_t blocks_per_chunk() const noexcept;
+ *          size_t alignment() const noexcept;
+ *          size_t max_blocks() const noexcept;
+ *          size_t capacity() const noexcept;
+ *          memory_resource* upstream() const noexcept;
+ *      };
+ */
 
 #pragma once
 
-#include <pycpp/config.h>
+#include <pycpp/stl/memory.h>
+#include <stddef.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// DECLARATIONS
+// ------------
+
+/**
+ *  \brief Pool of fixed-size blocks with an intrusive free list.
+ *
+ *  `block_size` is rounded up to a multiple of `alignment`, and to at
+ *  least the size of a pointer. A zero `blocks_per_chunk` picks enough
+ *  blocks to fill roughly 16 KB, and a null `upstream` uses
+ *  `new_delete_resource()`.
+ */
+class fixed_pool
+{
+public:
+    // MEMBER FUNCTIONS
+    // ----------------
+
+    // CONSTRUCTORS
+    fixed_pool(size_t block_size, size_t blocks_per_chunk = 0, size_t alignment = alignof(max_align_t), size_t max_blocks = 0, memory_resource* upstream = nullptr);
+    fixed_pool(const fixed_pool&) = delete;
+    fixed_pool& operator=(const fixed_pool&) = delete;
+    fixed_pool(fixed_pool&&) noexcept;
+    fixed_pool& operator=(fixed_pool&&) noexcept;
+    ~fixed_pool() noexcept;
+
+    // ALLOCATION
+    void* allocate();
+    void deallocate(void* p) noexcept;
+    void release() noexcept;
+
+    // MODIFIERS
+    void swap(fixed_pool& rhs) noexcept;
+
+    // PROPERTIES
+    size_t block_size() const noexcept;
+    size_t blocks_per_chunk() const noexcept;
+    size_t alignment() const noexcept;
+    size_t max_blocks() const noexcept;
+    size_t capacity() const noexcept;
+    memory_resource* upstream() const noexcept;
+
+private:
+    struct node
+    {
+        node* next;
+    };
+
+    node* free_ = nullptr;
+    byte* cursor_ = nullptr;
+    byte* end_ = nullptr;
+    node* chunks_ = nullptr;
+    size_t block_size_;
+    size_t blocks_per_chunk_;
+    size_t alignment_;
+    size_t max_blocks_;
+    size_t capacity_ = 0;
+    memory_resource* upstream_;
+
+    void* allocate_chunk();
+    size_t header_size() const noexcept;
+};
+
+// SPECIALIZATION
+// --------------
+
+template <>
+struct is_relocatable<fixed_pool>: true_type
+{};
+
+// IMPLEMENTATION
+// --------------
+
+
+/**
+ *  \brief Pop a block from the free list, or carve one from the current chunk.
+ */
+inline void* fixed_pool::allocate()
+{
+    if (free_) {
+        node* n = free_;
+        free_ = n->next;
+        return n;
+    } else if (cursor_ != end_) {
+        byte* p = cursor_;
+        cursor_ += block_size_;
+        return p;
+    }
+    return allocate_chunk();
+}
+
+
+/**
+ *  \brief Push a block back onto the free list.
+ */
+inline void fixed_pool::deallocate(void* p) noexcept
+{
+    node* n = static_cast<node*>(p);
+    n->next = free_;
+    free_ = n;
+}
+
+
+inline void swap(fixed_pool& lhs, fixed_pool& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,333 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/allocator/page.h>
+#include <pycpp/preprocessor/os.h>
+#include <pycpp/stl/algorithm.h>
+#include <pycpp/stl/new.h>
+#include <pycpp/stl/utility.h>
+#include <stdint.h>
+
+#if defined(OS_WINDOWS)
+#   include <windows.h>
+#else
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
+PYCPP_BEGIN_NAMESPACE
+
+// CONSTANTS
+// ---------
+
+static constexpr size_t HUGE_PAGE_SIZE = 2 << 20;
+static constexpr size_t COMMIT_SIZE = 64 << 10;
+
+// HELPERS
+// -------
+
+
+static size_t align_up(size_t n, size_t alignment) noexcept
+{
+    return (n + (alignment-1)) & ~(alignment-1);
+}
+
+
+#if defined(OS_WINDOWS)                 // WINDOWS
+
+static size_t get_page_size() noexcept
+{
+    SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    return info.dwPageSize;
+}
+
+
+static byte* map_pages(size_t n)
+{
+    void* p = ::VirtualAlloc(nullptr, n, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (p == nullptr) {
+        throw bad_alloc();
+    }
+    return static_cast<byte*>(p);
+}
+
+
+static void unmap_pages(void* p, size_t) noexcept
+{
+    ::VirtualFree(p, 0, MEM_RELEASE);
+}
+
+
+static byte* reserve_pages(size_t n, size_t)
+{
+    void* p = ::VirtualAlloc(nullptr, n, MEM_RESERVE, PAGE_NOACCESS);
+    if (p == nullptr) {
+        throw bad_alloc();
+    }
+    return static_cast<byte*>(p);
+}
+
+
+static void release_pages(byte* p, size_t) noexcept
+{
+    ::VirtualFree(p, 0, MEM_RELEASE);
+}
+
+
+static bool commit_pages(byte* p, size_t n) noexcept
+{
+    return ::VirtualAlloc(p, n, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+
+/**
+ *  \brief Decommit pages, returning the number of bytes still committed.
+ */
+static size_t decommit_pages(byte* p, size_t n) noexcept
+{
+    ::VirtualFree(p, n, MEM_DECOMMIT);
+    return 0;
+}
+
+#else                                   // POSIX
+
+static size_t get_page_size() noexcept
+{
+    long page_size = ::sysconf(_SC_PAGESIZE);
+    return page_size > 0 ? static_cast<size_t>(page_size) : 4096;
+}
+
+
+static byte* map_pages(size_t n)
+{
+    void* p = ::mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        throw bad_alloc();
+    }
+    return static_cast<byte*>(p);
+}
+
+
+static void unmap_pages(void* p, size_t n) noexcept
+{
+    ::munmap(p, n);
+}
+
+
+/**
+ *  \brief Reserve inaccessible addresses, aligned to `alignment`.
+ */
+static byte* reserve_pages(size_t n, size_t alignment)
+{
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_NORESERVE)
+    flags |= MAP_NORESERVE;
+#endif
+
+    // over-reserve, then trim the unaligned ends
+    size_t page = get_page_size();
+    size_t extra = alignment > page ? alignment : 0;
+    void* ptr = ::mmap(nullptr, n + extra, PROT_NONE, flags, -1, 0);
+    if (ptr == MAP_FAILED) {
+        throw bad_alloc();
+    }
+
+    byte* first = static_cast<byte*>(ptr);
+    if (extra) {
+        uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+        size_t shift = align_up(address, alignment) - address;
+        if (shift) {
+            ::munmap(first, shift);
+        }
+        if (extra - shift) {
+            ::munmap(first + shift + n, extra - shift);
+        }
+        first += shift;
+    }
+    return first;
+}
+
+
+static void release_pages(byte* p, size_t n) noexcept
+{
+    ::munmap(p, n);
+}
+
+
+static bool commit_pages(byte* p, size_t n) noexcept
+{
+    return ::mprotect(p, n, PROT_READ | PROT_WRITE) == 0;
+}
+
+
+/**
+ *  \brief Drop the physical memory of pages, keeping them committed.
+ *
+ *  The pages stay readable and writable, and are zero-filled
+ *  on the next access.
+ */
+static size_t decommit_pages(byte* p, size_t n) noexcept
+{
+#if defined(HAVE_MADVISE) && defined(MADV_DONTNEED)
+    ::madvise(p, n, MADV_DONTNEED);
+    return n;
+#else
+    ::mprotect(p, n, PROT_NONE);
+    return 0;
+#endif
+}
+
+#endif                                  // WINDOWS
+
+// OBJECTS
+// -------
+
+// PAGE ALLOCATOR
+
+
+void* page_allocator_base::allocate(size_t n, size_t size, const void*)
+{
+    if (size && n > numeric_limits<size_t>::max() / size) {
+        throw bad_alloc();
+    }
+    size_t bytes = align_up(max<size_t>(n * size, 1), page_region::page_size());
+    return map_pages(bytes);
+}
+
+
+void page_allocator_base::deallocate(void* p, size_t n)
+{
+    if (p) {
+        unmap_pages(p, align_up(max<size_t>(n, 1), page_region::page_size()));
+    }
+}
+
+// REGION
+
+
+page_region::page_region(size_t reserve, bool huge_pages):
+    huge_pages_(huge_pages)
+{
+#if !(defined(HAVE_MADVISE) && defined(MADV_HUGEPAGE))
+    huge_pages_ = false;
+#endif
+
+    size_t granularity = huge_pages_ ? HUGE_PAGE_SIZE : page_size();
+    reserved_ = align_up(max<size_t>(reserve, 1), granularity);
+    if (reserved_ < reserve) {
+        throw bad_alloc();
+    }
+    data_ = reserve_pages(reserved_, granularity);
+
+#if defined(HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+    if (huge_pages_) {
+        ::madvise(data_, reserved_, MADV_HUGEPAGE);
+    }
+#endif
+}
+
+
+page_region::page_region(page_region&& rhs) noexcept
+{
+    swap(rhs);
+}
+
+
+page_region& page_region::operator=(page_region&& rhs) noexcept
+{
+    swap(rhs);
+    return *this;
+}
+
+
+page_region::~page_region() noexcept
+{
+    if (data_) {
+        release_pages(data_, reserved_);
+    }
+}
+
+
+/**
+ *  \brief Commit pages until at least `n` bytes are committed.
+ *
+ *  Memory is committed in steps of at least 64 KB, or of 2 MB with
+ *  huge pages, and at least doubles the committed size, to limit
+ *  the number of system calls as the region grows.
+ */
+void page_region::commit(size_t n)
+{
+    if (n <= committed_) {
+        return;
+    } else if (n > reserved_) {
+        throw bad_alloc();
+    }
+
+    size_t step = huge_pages_ ? HUGE_PAGE_SIZE : max(COMMIT_SIZE, page_size());
+    size_t target = align_up(max(n, 2 * committed_), step);
+    target = min(target, reserved_);
+    if (!commit_pages(data_ + committed_, target - committed_)) {
+        throw bad_alloc();
+    }
+    committed_ = target;
+}
+
+
+/**
+ *  \brief Return the physical memory of committed pages to the system.
+ *
+ *  The contents of the region are lost.
+ */
+void page_region::decommit() noexcept
+{
+    if (committed_) {
+        committed_ = decommit_pages(data_, committed_);
+    }
+}
+
+
+void page_region::swap(page_region& rhs) noexcept
+{
+    using PYCPP_NAMESPACE::swap;
+    swap(data_, rhs.data_);
+    swap(reserved_, rhs.reserved_);
+    swap(committed_, rhs.committed_);
+    swap(huge_pages_, rhs.huge_pages_);
+}
+
+
+size_t page_region::page_size() noexcept
+{
+    static size_t size = get_page_size();
+    return size;
+}
+
+
+byte* page_region::data() const noexcept
+{
+    return data_;
+}
+
+
+size_t page_region::reserved() const noexcept
+{
+    return reserved_;
+}
+
+
+/**
+ *  \brief Number of bytes from the start of the region that may be accessed.
+ */
+size_t page_region::committed() const noexcept
+{
+    return committed_;
+}
+
+
+bool page_region::huge_pages() const noexcept
+{
+    return huge_pages_;
+}
+
+PYCPP_END_NAMESPACE
@@ -1,2 +1,683 @@
-// Virtual page allocator....
-// TODO: here...
\ No newline at end of file
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Virtual memory page allocators.
+ *
+ *  `page_allocator` maps whole pages directly from the operating
+ *  system for each allocation, which suits large, long-lived buffers,
+ *  and returns them to the system on deallocation.
+ *
+ *  `page_arena` is a growable linear arena. It reserves a large
+ *  range of virtual addresses up front (4 GB on 64-bit systems by
+ *  default), without using any memory, and commits pages lazily as
+ *  the arena grows. Unlike `linear_allocator` or `stack_allocator`,
+ *  the arena has no fixed size chosen at compile time, and since the
+ *  addresses are reserved, it grows in place without copying. As
+ *  with `linear_allocator`, deallocation is a no-op: `reset()` frees
+ *  every allocation at once, and returns the physical memory to the
+ *  system (with `MADV_DONTNEED` on POSIX systems), while keeping the
+ *  address range for reuse.
+ *
+ *  On Linux, the arena may be backed by transparent huge pages,
+ *  which reduces TLB misses for large arenas, at the cost of
+ *  committing memory in 2 MB steps.
+ *
+ *  By default, `page_arena_allocator` and `page_arena` are not
+ *  thread-safe, for performance. Using the locked variant, by
+ *  setting `UseLocks`, ensures thread safety through a shared mutex.
+ *
+ *  \synopsis
+ *      template <typename T>
+ *      struct page_allocator
+ *      {
+ *          using value_type = T;
+ *
+ *          page_allocator() noexcept;
+ *          page_allocator(const self_t&) noexcept;
+ *          template <typename U> page_allocator(const page_allocator<U>&) noexcept;
+ *          self_t& operator=(const self_t&) noexcept;
+ *          template <typename U> self_t& operator=(const page_allocator<U>&) noexcept;
+ *          ~page_allocator() = default;
+ *
+ *          value_type* allocate(size_t n, const void* hint = nullptr);
+ *          void deallocate(value_type* p, size_t n);
+ *      };
+ *
+ *      class page_region
+ *      {
+ *      public:
+ *          page_region(size_t reserve, bool huge_pages = false);
+ *          page_region(const page_region&) = delete;
+ *          page_region& operator=(const page_region&) = delete;
+ *          page_region(page_region&&) noexcept;
+ *          page_region& operator=(page_region&&) noexcept;
+ *          ~page_region() noexcept;
+ *
+ *          void commit(size_t n);
+ *          void decommit() noexcept;
+ *          void swap(page_region& rhs) noexcept;
+ *
+ *          static size_t page_size() noexcept;
+ *          byte* data() const noexcept;
+ *          size_t reserved() const noexcept;
+ *          size_t committed() const noexcept;
+ *          bool huge_pages() const noexcept;
+ *      };
+ *
+ *      template <
+ *          size_t Alignment = implementation-defined,
+ *          bool UseLocks = false
+ *      >
+ *      class page_arena
+ *      {
+ *      public:
+ *          static constexpr size_t alignment = Alignment;
+ *          static constexpr bool use_locks = UseLocks;
+ *          using mutex_type = conditional_t<UseLocks, mutex, dummy_mutex>;
+ *
+ *          page_arena(size_t reserve = PAGE_ARENA_RESERVE, bool huge_pages = false);
+ *          page_arena(const page_arena&) = delete;
+ *          page_arena& operator=(const page_arena&) = delete;
+ *          page_arena(page_arena&&) = delete;
+ *          page_arena& operator=(page_arena&&) = delete;
+ *
+ *          template <size_t RequiredAlignment> byte* allocate(size_t n);
+ *          void deallocate(byte* p, size_t n) noexcept;
+ *
+ *          size_t used() const noexcept;
+ *          size_t committed() const noexcept;
+ *          size_t reserved() const noexcept;
+ *          void reset() noexcept;
+ *      };
+ *
+ *      template <
+ *          typename T,
+ *          size_t Alignment = implementation-defined,
+ *          bool UseLocks = false
+ *      >
+ *      class page_arena_allocator
+ *      {
+ *      public:
+ *          using value_type = T;
+ *          using arena_type = page_arena<Alignment, UseLocks>;
+ *
+ *          page_arena_allocator() noexcept;
+ *          page_arena_allocator(arena_type& arena) noexcept;
+ *          ...
+ *
+ *          value_type* allocate(size_t n, const void* hint = nullptr);
+ *          void deallocate(value_type* p, size_t n);
+ *      };
+ *
+ *      using page_resource = resource_adaptor<page_allocator<byte>>;
+ *
+ *      template <size_t Alignment = implementation-defined, bool UseLocks = false>
+ *      using page_arena_resource = resource_adaptor<page_arena_allocator<byte, Alignment, UseLocks>>;
+ *
+ *      template <size_t Alignment = implementation-defined>
+ *      using page_arena_unlocked_resource = page_arena_resource<Alignment, false>;
+ *
+ *      template <size_t Alignment = implementation-defined>
+ *      using page_arena_locked_resource = page_arena_resource<Alignment, true>;
+ *
+ *      template <typename T, size_t Alignment = implementation-defined>
+ *      using page_arena_locked_allocator = page_arena_allocator<T, Alignment, true>;
+ *
+ *      template <typename T, size_t Alignment = implementation-defined>
+ *      using page_arena_unlocked_allocator = page_arena_allocator<T, Alignment, false>;
+ */
+
+#pragma once
+
+#include <pycpp/misc/compressed_pair.h>
+#include <pycpp/stl/limits.h>
+#include <pycpp/stl/memory.h>
+#include <pycpp/stl/mutex.h>
+#include <pycpp/stl/type_traits.h>
+#include <assert.h>
+#include <stddef.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// CONSTANTS
+// ---------
+
+/**
+ *  \brief Default size of the address range reserved by `page_arena`.
+ */
+static constexpr size_t PAGE_ARENA_RESERVE = sizeof(void*) >= 8 ? (size_t(1) << 32) : (size_t(1) << 28);
+
+// FORWARD
+// -------
+
+template <typename T>
+struct page_allocator;
+
+template <
+    size_t Alignment = alignof(max_align_t),
+    bool UseLocks = false
+>
+class page_arena;
+
+template <
+    typename T,
+    size_t Alignment = alignof(max_align_t),
+    bool UseLocks = false
+>
+class page_arena_allocator;
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Base for the virtual memory page allocator.
+ */
+struct page_allocator_base
+{
+    static void* allocate(size_t n, size_t size, const void* hint = nullptr);
+    static void deallocate(void* p, size_t n);
+};
+
+
+/**
+ *  \brief Allocator mapping whole pages for each allocation.
+ */
+template <typename T>
+struct page_allocator: private page_allocator_base
+{
+    // MEMBER TYPES
+    // ------------
+    using self_t = page_allocator<T>;
+    using value_type = T;
+#if defined(CPP11_PARTIAL_ALLOCATOR_TRAITS)
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    template <typename U> struct rebind { using other = page_allocator<U>; };
+#endif      // CPP11_PARTIAL_ALLOCATOR_TRAITS
+
+    // MEMBER FUNCTIONS
+    // ----------------
+    page_allocator() noexcept = default;
+    page_allocator(const self_t&) noexcept = default;
+    self_t& operator=(const self_t&) noexcept = default;
+    ~page_allocator() noexcept = default;
+
+    template <typename U>
+    page_allocator(const page_allocator<U>&) noexcept
+    {}
+
+    template <typename U>
+    self_t& operator=(const page_allocator<U>&) noexcept
+    {
+        return *this;
+    }
+
+    // ALLOCATOR TRAITS
+
+    value_type* allocate(size_t n, const void* hint = nullptr)
+    {
+        return reinterpret_cast<value_type*>(page_allocator_base::allocate(n, sizeof(value_type), hint));
+    }
+
+    void deallocate(value_type* p, size_t n)
+    {
+        page_allocator_base::deallocate(p, sizeof(value_type) * n);
+    }
+
+#if defined(CPP11_PARTIAL_ALLOCATOR_TRAITS)
+
+    template <typename ... Ts>
+    void construct(T* p, Ts&&... ts)
+    {
+        ::new (static_cast<void*>(p)) T(std::forward<Ts>(ts)...);
+    }
+
+    void destroy(T* p)
+    {
+        p->~T();
+    }
+
+    size_type max_size()
+    {
+        return std::numeric_limits<size_type>::max();
+    }
+
+#endif      // CPP11_PARTIAL_ALLOCATOR_TRAITS
+};
+
+// REGION
+
+/**
+ *  \brief Reserved range of virtual addresses, committed lazily.
+ *
+ *  `reserve` is rounded up to a multiple of the page size, or of
+ *  2 MB with huge pages. Committed pages are readable and writable,
+ *  and are zero-filled when first touched.
+ */
+class page_region
+{
+public:
+    // MEMBER FUNCTIONS
+    // ----------------
+
+    // CONSTRUCTORS
+    page_region(size_t reserve, bool huge_pages = false);
+    page_region(const page_region&) = delete;
+    page_region& operator=(const page_region&) = delete;
+    page_region(page_region&&) noexcept;
+    page_region& operator=(page_region&&) noexcept;
+    ~page_region() noexcept;
+
+    // MODIFIERS
+    void commit(size_t n);
+    void decommit() noexcept;
+    void swap(page_region& rhs) noexcept;
+
+    // PROPERTIES
+    static size_t page_size() noexcept;
+    byte* data() const noexcept;
+    size_t reserved() const noexcept;
+    size_t committed() const noexcept;
+    bool huge_pages() const noexcept;
+
+private:
+    byte* data_ = nullptr;
+    size_t reserved_ = 0;
+    size_t committed_ = 0;
+    bool huge_pages_ = false;
+};
+
+// ARENA
+
+/**
+ *  \brief Growable arena committing pages from a reserved range.
+ *
+ *  Move and copy constructors are disabled, since allocators hold
+ *  a pointer to the arena.
+ */
+template <
+    size_t Alignment,
+    bool UseLocks
+>
+class page_arena
+{
+public:
+    // MEMBER TEMPLATES
+    // ----------------
+    template <size_t A1 = Alignment, bool UL1 = UseLocks>
+    struct rebind { using other = page_arena<A1, UL1>; };
+
+    // STATIC VARIABLES
+    // ----------------
+    static constexpr size_t alignment = Alignment;
+    static constexpr bool use_locks = UseLocks;
+
+    // MEMBER TYPES
+    // ------------
+    using mutex_type = conditional_t<UseLocks, mutex, dummy_mutex>;
+
+    // MEMBER FUNCTIONS
+    // ----------------
+
+    // CONSTRUCTORS
+
+    page_arena(const page_arena&) = delete;
+    page_arena& operator=(const page_arena&) = delete;
+    page_arena(page_arena&&) = delete;
+    page_arena& operator=(page_arena&&) = delete;
+
+    page_arena(size_t reserve = PAGE_ARENA_RESERVE, bool huge_pages = false):
+        region_(reserve, huge_pages),
+        data_(0)
+    {}
+
+    // ALLOCATION
+
+    template <size_t RequiredAlignment> byte* allocate(size_t n);
+    void deallocate(byte* p, size_t n) noexcept;
+
+    // PROPERTIES
+
+    size_t used() const noexcept
+    {
+        return offset_();
+    }
+
+    size_t committed() const noexcept
+    {
+        return region_.committed();
+    }
+
+    size_t reserved() const noexcept
+    {
+        return region_.reserved();
+    }
+
+    void reset() noexcept
+    {
+        lock_guard<mutex_type> lock(mutex_());
+        offset_() = 0;
+        region_.decommit();
+    }
+
+private:
+    page_region region_;
+    compressed_pair<size_t, mutex_type> data_;
+
+    size_t& offset_() noexcept
+    {
+        return get<0>(data_);
+    }
+
+    const size_t& offset_() const noexcept
+    {
+        return get<0>(data_);
+    }
+
+    mutex_type& mutex_() noexcept
+    {
+        return get<1>(data_);
+    }
+
+    const mutex_type& mutex_() const noexcept
+    {
+        return get<1>(data_);
+    }
+
+    static size_t align_up(size_t n) noexcept
+    {
+        return (n + (alignment-1)) & ~(alignment-1);
+    }
+};
+
+// ALLOCATOR
+
+/**
+ *  \brief Allocator drawing from a growable page arena.
+ */
+template <
+    typename T,
+    size_t Alignment,
+    bool UseLocks
+>
+class page_arena_allocator
+{
+public:
+    // MEMBER TEMPLATES
+    // ----------------
+    template <typename T1, size_t A1 = Alignment, bool UL1 = UseLocks>
+    struct rebind { using other = page_arena_allocator<T1, A1, UL1>; };
+
+    // STATIC VARIABLES
+    // ----------------
+    static constexpr size_t alignment = Alignment;
+    static constexpr bool use_locks = UseLocks;
+
+    // MEMBER TYPES
+    // ------------
+    using self_t = page_arena_allocator<T, Alignment, UseLocks>;
+    using value_type = T;
+    using arena_type = page_arena<alignment, use_locks>;
+    using mutex_type = typename arena_type::mutex_type;
+    using propagate_on_container_move_assignment = true_type;
+#if defined(CPP11_PARTIAL_ALLOCATOR_TRAITS)
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+#endif      // CPP11_PARTIAL_ALLOCATOR_TRAITS
+
+    // MEMBER FUNCTIONS
+    // ----------------
+
+    // CONSTRUCTORS
+
+    page_arena_allocator() noexcept:
+        arena_(nullptr)
+    {}
+
+    page_arena_allocator(arena_type& arena) noexcept:
+        arena_(&arena)
+    {}
+
+    page_arena_allocator(const self_t& rhs) noexcept:
+        arena_(rhs.arena_)
+    {}
+
+    template <typename T1>
+    page_arena_allocator(const page_arena_allocator<T1, Alignment, UseLocks>& rhs) noexcept:
+        arena_(rhs.arena_)
+    {}
+
+    self_t& operator=(const self_t& rhs) noexcept
+    {
+        arena_ = rhs.arena_;
+        return *this;
+    }
+
+    template <typename T1>
+    self_t& operator=(const page_arena_allocator<T1, Alignment, UseLocks>& rhs) noexcept
+    {
+        arena_ = rhs.arena_;
+        return *this;
+    }
+
+    page_arena_allocator(self_t&& rhs) noexcept
+    {
+        swap(arena_, rhs.arena_);
+    }
+
+    template <typename T1>
+    page_arena_allocator(page_arena_allocator<T1, Alignment, UseLocks>&& rhs) noexcept
+    {
+        swap(arena_, rhs.arena_);
+    }
+
+    self_t& operator=(self_t&& rhs) noexcept
+    {
+        swap(arena_, rhs.arena_);
+        return *this;
+    }
+
+    template <typename T1>
+    self_t& operator=(page_arena_allocator<T1, Alignment, UseLocks>&& rhs) noexcept
+    {
+        swap(arena_, rhs.arena_);
+        return *this;
+    }
+
+    ~page_arena_allocator() noexcept
+    {
+        arena_ = nullptr;
+    }
+
+    // ALLOCATOR TRAITS
+
+    value_type* allocate(size_t n, const void* hint = nullptr)
+    {
+        assert(arena_ && "Arena cannot be null.");
+        return reinterpret_cast<T*>(arena_->template allocate<alignof(T)>(sizeof(T) * n));
+    }
+
+    void deallocate(value_type* p, size_t n)
+    {
+        assert(arena_ && "Arena cannot be null.");
+        arena_->deallocate(reinterpret_cast<byte*>(p), sizeof(T) * n);
+    }
+
+#if defined(CPP11_PARTIAL_ALLOCATOR_TRAITS)
+
+    template <typename ... Ts>
+    void construct(T* p, Ts&&... ts)
+    {
+        ::new (static_cast<void*>(p)) T(std::forward<Ts>(ts)...);
+    }
+
+    void destroy(T* p)
+    {
+        p->~T();
+    }
+
+    size_type max_size()
+    {
+        return std::numeric_limits<size_type>::max();
+    }
+
+#endif      // CPP11_PARTIAL_ALLOCATOR_TRAITS
+
+private:
+    template <typename T1, size_t A, bool UL>
+    friend class page_arena_allocator;
+
+    template <typename T1, size_t A1, bool UL1, typename T2, size_t A2, bool UL2>
+    friend bool operator==(const page_arena_allocator<T1, A1, UL1>& lhs, const page_arena_allocator<T2, A2, UL2>& rhs) noexcept;
+
+    arena_type* arena_ = nullptr;
+};
+
+// ALIAS
+// -----
+
+using page_resource = resource_adaptor<page_allocator<byte>>;
+
+template <
+    size_t Alignment = alignof(max_align_t),
+    bool UseLocks = false
+>
+using page_arena_resource = resource_adaptor<
+    page_arena_allocator<byte, Alignment, UseLocks>
+>;
+
+template <size_t Alignment = alignof(max_align_t)>
+using page_arena_unlocked_resource = resource_adaptor<
+    page_arena_allocator<byte, Alignment, false>
+>;
+
+template <size_t Alignment = alignof(max_align_t)>
+using page_arena_locked_resource = resource_adaptor<
+    page_arena_allocator<byte, Alignment, true>
+>;
+
+template <
+    typename T,
+    size_t Alignment = alignof(max_align_t)
+>
+using page_arena_locked_allocator = page_arena_allocator<T, Alignment, true>;
+
+template <
+    typename T,
+    size_t Alignment = alignof(max_align_t)
+>
+using page_arena_unlocked_allocator = page_arena_allocator<T, Alignment, false>;
+
+// SPECIALIZATION
+// --------------
+
+template <typename T>
+struct is_relocatable<page_allocator<T>>: true_type
+{};
+
+template <>
+struct is_relocatable<page_region>: true_type
+{};
+
+template <size_t A, bool UL>
+struct is_relocatable<page_arena<A, UL>>: false_type
+{};
+
+template <typename T, size_t A, bool UL>
+struct is_relocatable<page_arena_allocator<T, A, UL>>: true_type
+{};
+
+// IMPLEMENTATION
+// --------------
+
+// PAGE ALLOCATOR
+
+template <typename T, typename U>
+inline bool operator==(const page_allocator<T>&, const page_allocator<U>&) noexcept
+{
+    return true;
+}
+
+
+template <typename T, typename U>
+inline bool operator!=(const page_allocator<T>& lhs, const page_allocator<U>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+// REGION
+
+inline void swap(page_region& lhs, page_region& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+// ARENA
+
+template <size_t A, bool UL>
+const size_t page_arena<A, UL>::alignment;
+
+template <size_t A, bool UL>
+const bool page_arena<A, UL>::use_locks;
+
+template <size_t A, bool UL>
+template <size_t RequiredAlignment>
+byte* page_arena<A, UL>::allocate(size_t n)
+{
+    static_assert(RequiredAlignment <= alignment, "Alignment is too small for this arena");
+    static_assert(alignment <= 4096, "Alignment is larger than a page.");
+
+    lock_guard<mutex_type> lock(mutex_());
+    size_t aligned_n = align_up(n);
+    if (aligned_n < n || aligned_n > region_.reserved() - offset_()) {
+        throw bad_alloc();
+    }
+
+    size_t end = offset_() + aligned_n;
+    if (end > region_.committed()) {
+        region_.commit(end);
+    }
+    byte* r = region_.data() + offset_();
+    offset_() = end;
+    return r;
+}
+
+
+template <size_t A, bool UL>
+inline void page_arena<A, UL>::deallocate(byte* p, size_t n) noexcept
+{
+    assert(region_.data() <= p && p <= region_.data() + offset_() && "Pointer not allocated from arena.");
+}
+
+// ALLOCATOR
+
+template <typename T, size_t A, bool UL>
+const size_t page_arena_allocator<T, A, UL>::alignment;
+
+template <typename T, size_t A, bool UL>
+const bool page_arena_allocator<T, A, UL>::use_locks;
+
+template <typename T1, size_t A1, bool UL1, typename T2, size_t A2, bool UL2>
+inline bool operator==(const page_arena_allocator<T1, A1, UL1>& lhs,
+    const page_arena_allocator<T2, A2, UL2>& rhs) noexcept
+{
+    return lhs.arena_ == rhs.arena_;
+}
+
+template <typename T1, size_t A1, bool UL1, typename T2, size_t A2, bool UL2>
+inline bool operator!=(const page_arena_allocator<T1, A1, UL1>& lhs,
+    const page_arena_allocator<T2, A2, UL2>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+PYCPP_END_NAMESPACE
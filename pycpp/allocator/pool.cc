@@ -1 +1,118 @@
-// TODO: implement
+//  :copyright: (c) 2013 Cosku Acay, http://www.coskuacay.com.
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/allocator/pool.h>
+#include <pycpp/stl/algorithm.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// CONSTANTS
+// ---------
+
+static constexpr size_t DEFAULT_MAX_BLOCK_SIZE = 4096;
+
+// HELPERS
+// -------
+
+
+static size_t log2_ceil(size_t n) noexcept
+{
+    size_t shift = 0;
+    while ((static_cast<size_t>(1) << shift) < n) {
+        ++shift;
+    }
+    return shift;
+}
+
+
+/**
+ *  \brief Size of the blocks in the pool at `index`.
+ */
+static size_t index_block_size(size_t index, size_t shift) noexcept
+{
+    if (index < 16) {
+        return (index + 1) << shift;
+    }
+    return static_cast<size_t>(16) << (shift + index - 15);
+}
+
+// OBJECTS
+// -------
+
+
+size_class_pool::size_class_pool(size_t blocks_per_chunk, size_t max_block_size, size_t alignment, memory_resource* upstream):
+    pools_(polymorphic_allocator<fixed_pool>(upstream ? upstream : new_delete_resource())),
+    alignment_(max(alignment, alignof(void*))),
+    shift_(log2_ceil(alignment_)),
+    upstream_(upstream ? upstream : new_delete_resource())
+{
+    // round the largest block up to the size of its class
+    max_block_size = max_block_size ? max_block_size : DEFAULT_MAX_BLOCK_SIZE;
+    size_t count = size_class(max_block_size) + 1;
+    max_block_size_ = index_block_size(count - 1, shift_);
+
+    pools_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        pools_.emplace_back(index_block_size(i, shift_), blocks_per_chunk, alignment_, 0, upstream_);
+    }
+}
+
+
+/**
+ *  \brief Return every chunk of every pool upstream.
+ */
+void size_class_pool::release() noexcept
+{
+    for (fixed_pool& pool: pools_) {
+        pool.release();
+    }
+}
+
+
+size_t size_class_pool::size_classes() const noexcept
+{
+    return pools_.size();
+}
+
+
+/**
+ *  \brief Size of the blocks served by the pool at `index`.
+ */
+size_t size_class_pool::class_block_size(size_t index) const noexcept
+{
+    return pools_[index].block_size();
+}
+
+
+/**
+ *  \brief Number of bytes reserved to serve a request of `n` bytes.
+ */
+size_t size_class_pool::block_size(size_t n) const noexcept
+{
+    n = n ? n : 1;
+    if (n > max_block_size_) {
+        return n;
+    }
+    return pools_[size_class(n)].block_size();
+}
+
+
+size_t size_class_pool::max_block_size() const noexcept
+{
+    return max_block_size_;
+}
+
+
+size_t size_class_pool::alignment() const noexcept
+{
+    return alignment_;
+}
+
+
+memory_resource* size_class_pool::upstream() const noexcept
+{
+    return upstream_;
+}
+
+PYCPP_END_NAMESPACE
@@ -5,58 +5,334 @@
  *  \addtogroup PyCPP
  *  \brief Memory pool allocator.
  *
- *  An allocator that optimizes for types of known size by using
- *  a memory pool to allocate each block.
+ *  An allocator that optimizes for small allocations of known size,
+ *  such as the nodes of `list`, `map` or `set`, by serving them from
+ *  pools of fixed-size blocks rather than calling `malloc` for each
+ *  node. Requests are segregated into size classes: multiples of the
+ *  alignment up to 16 times the alignment, then powers of two up to
+ *  `max_block_size` (4096 bytes by default). Each size class has its
+ *  own `fixed_pool`, which allocates and frees blocks in constant time
+ *  and grows by chunks of `BlocksPerChunk` blocks (0 for roughly 16 KB
+ *  chunks). Larger requests go directly to the upstream resource.
+ *
+ *  Like `linear_allocator`, `pool_allocator` holds a pointer to a
+ *  `pool_allocator_arena`, which owns the pools, so an allocator
+ *  rebound to a container's node type shares the pools of the
+ *  original. Memory returned to the pools is only released upstream
+ *  when the arena is reset or destroyed, so the arena must outlive
+ *  every container using it.
+ *
+ *  By default, `pool_allocator` and `pool_allocator_arena` are not
+ *  thread-safe, for performance. Using the locked variant, by setting
+ *  `UseLocks`, ensures thread safety through a shared mutex.
+ *
+ *  \synopsis
+ *      class size_class_pool
+ *      {
+ *      public:
+ *          size_class_pool(size_t blocks_per_chunk = 0, size_t max_block_size = 0, size_t alignment = alignof(max_align_t), memory_resource* upstream = nullptr);
+ *          size_class_pool(const size_class_pool&) = delete;
+ *          size_class_pool& operator=(const size_class_pool&) = delete;
+ *          size_class_pool(size_class_pool&&) = default;
+ *          size_class_pool& operator=(size_class_pool&&) = default;
+ *
+ *          void* allocate(size_t n, size_t alignment = alignof(max_align_t));
+ *          void deallocate(void* p, size_t n, size_t alignment = alignof(max_align_t)) noexcept;
+ *          void release() noexcept;
+ *
+ *          size_t size_class(size_t n) const noexcept;
+ *          size_t size_classes() const noexcept;
+ *          size_t class_block_size(size_t index) const noexcept;
+ *          size_t block_size(size_t n) const noexcept;
+ *          size_t max_block_size() const noexcept;
+ *          size_t alignment() const noexcept;
+ *          memory_resource* upstream() const noexcept;
+ *      };
+ *
+ *      template <
+ *          size_t BlocksPerChunk = 0,
+ *          size_t Alignment = implementation-defined,
+ *          bool UseLocks = false
+ *      >
+ *      class pool_allocator_arena
+ *      {
+ *      public:
+ *          static constexpr size_t alignment = Alignment;
+ *          static constexpr size_t blocks_per_chunk = BlocksPerChunk;
+ *          static constexpr bool use_locks = UseLocks;
+ *          using mutex_type = conditional_t<UseLocks, mutex, dummy_mutex>;
+ *
+ *          pool_allocator_arena(size_t max_block_size = 0, memory_resource* upstream = nullptr);
+ *          pool_allocator_arena(const pool_allocator_arena&) = delete;
+ *          pool_allocator_arena& operator=(const pool_allocator_arena&) = delete;
+ *          pool_allocator_arena(pool_allocator_arena&&) = delete;
+ *          pool_allocator_arena& operator=(pool_allocator_arena&&) = delete;
+ *
+ *          template <size_t RequiredAlignment> byte* allocate(size_t n);
+ *          void deallocate(byte* p, size_t n) noexcept;
+ *          void reset() noexcept;
+ *          size_t max_block_size() const noexcept;
+ *      };
+ *
+ *      template <
+ *          typename T,
+ *          size_t BlocksPerChunk = 0,
+ *          size_t Alignment = implementation-defined,
+ *          bool UseLocks = false
+ *      >
+ *      class pool_allocator
+ *      {
+ *      public:
+ *          static constexpr size_t alignment = Alignment;
+ *          static constexpr size_t blocks_per_chunk = BlocksPerChunk;
+ *          static constexpr bool use_locks = UseLocks;
+ *
+ *          using value_type = T;
+ *          using arena_type = pool_allocator_arena<BlocksPerChunk, Alignment, UseLocks>;
+ *          using mutex_type = typename arena_type::mutex_type;
+ *          using propagate_on_container_move_assignment = true_type;
+ *
+ *          pool_allocator() noexcept;
+ *          pool_allocator(arena_type& arena) noexcept;
+ *          pool_allocator(const pool_allocator&) noexcept;
+ *          pool_allocator& operator=(const pool_allocator&) noexcept;
+ *          pool_allocator(pool_allocator&&) noexcept;
+ *          pool_allocator& operator=(pool_allocator&&) noexcept;
+ *          ~pool_allocator() noexcept;
+ *
+ *          value_type* allocate(size_t n, const void* hint = nullptr);
+ *          void deallocate(value_type* p, size_t n);
+ *      };
+ *
+ *      template <
+ *          size_t BlocksPerChunk = 0,
+ *          size_t Alignment = implementation-defined,
+ *          bool UseLocks = false
+ *      >
+ *      using pool_resource = resource_adaptor<
+ *          pool_allocator<byte, BlocksPerChunk, Alignment, UseLocks>
+ *      >;
+ *
+ *      template <size_t BlocksPerChunk = 0, size_t Alignment = implementation-defined>
+ *      using pool_unlocked_resource = pool_resource<BlocksPerChunk, Alignment, false>;
+ *
+ *      template <size_t BlocksPerChunk = 0, size_t Alignment = implementation-defined>
+ *      using pool_locked_resource = pool_resource<BlocksPerChunk, Alignment, true>;
+ *
+ *      template <typename T, size_t BlocksPerChunk = 0, size_t Alignment = implementation-defined>
+ *      using pool_locked_allocator = pool_allocator<T, BlocksPerChunk, Alignment, true>;
+ *
+ *      template <typename T, size_t BlocksPerChunk = 0, size_t Alignment = implementation-defined>
+ *      using pool_unlocked_allocator = pool_allocator<T, BlocksPerChunk, Alignment, false>;
+ *
+ *      template <typename T1, size_t N1, size_t A1, bool UL1, typename T2, size_t N2, size_t A2, bool UL2>
+ *      bool operator==(const pool_allocator<T1, N1, A1, UL1>& lhs,
+ *          const pool_allocator<T2, N2, A2, UL2>& rhs) noexcept;
+ *
+ *      template <typename T1, size_t N1, size_t A1, bool UL1, typename T2, size_t N2, size_t A2, bool UL2>
+ *      bool operator!=(const pool_allocator<T1, N1, A1, UL1>& lhs,
+ *          const pool_allocator<T2, N2, A2, UL2>& rhs) noexcept;
  */
 
-//// TODO: implement
-//// Pool allocators take advantage of fixed-size allocations
-//// Array allocations make no sense, since they break this.
-//// It will therefore work with list, and not vector,
-//// since items must be requested 1x1.
-//
-//// Boost has a fast pool allocator, which works like this.
-//// It all has a pool allocator, which can handle custom shapes.
-//
-//// I might need a custom mutex for the implementation...
-//// This allocator is not thread-safe, which...
-
 #pragma once
 
-#include <pycpp/config.h>
-#include <limits.h>
+#include <pycpp/allocator/fixed_pool.h>
+#include <pycpp/misc/compressed_pair.h>
+#include <pycpp/stl/limits.h>
+#include <pycpp/stl/memory.h>
+#include <pycpp/stl/mutex.h>
+#include <pycpp/stl/type_traits.h>
+#include <pycpp/stl/vector.h>
+#include <assert.h>
 #include <stddef.h>
 
 PYCPP_BEGIN_NAMESPACE
 
+// FORWARD
+// -------
+
+template <
+    size_t BlocksPerChunk = 0,
+    size_t Alignment = alignof(max_align_t),
+    bool UseLocks = false
+>
+class pool_allocator_arena;
+
+template <
+    typename T,
+    size_t BlocksPerChunk = 0,
+    size_t Alignment = alignof(max_align_t),
+    bool UseLocks = false
+>
+class pool_allocator;
+
 // DECLARATIONS
 // ------------
 
+/**
+ *  \brief Pools of fixed-size blocks, segregated by size class.
+ *
+ *  A zero `max_block_size` uses 4096 bytes, and a null `upstream`
+ *  uses `new_delete_resource()`. Requests larger than `max_block_size`,
+ *  or aligned more strictly than `alignment`, use `upstream` directly.
+ *  `size_class_pool` is not thread-safe.
+ */
+class size_class_pool
+{
+public:
+    // MEMBER FUNCTIONS
+    // ----------------
+
+    // CONSTRUCTORS
+    size_class_pool(size_t blocks_per_chunk = 0, size_t max_block_size = 0, size_t alignment = alignof(max_align_t), memory_resource* upstream = nullptr);
+    size_class_pool(const size_class_pool&) = delete;
+    size_class_pool& operator=(const size_class_pool&) = delete;
+    size_class_pool(size_class_pool&&) = default;
+    size_class_pool& operator=(size_class_pool&&) = default;
+
+    // ALLOCATION
+    void* allocate(size_t n, size_t alignment = alignof(max_align_t));
+    void deallocate(void* p, size_t n, size_t alignment = alignof(max_align_t)) noexcept;
+    void release() noexcept;
+
+    // PROPERTIES
+    size_t size_class(size_t n) const noexcept;
+    size_t size_classes() const noexcept;
+    size_t class_block_size(size_t index) const noexcept;
+    size_t block_size(size_t n) const noexcept;
+    size_t max_block_size() const noexcept;
+    size_t alignment() const noexcept;
+    memory_resource* upstream() const noexcept;
+
+private:
+    vector<fixed_pool> pools_;
+    size_t max_block_size_;
+    size_t alignment_;
+    size_t shift_;
+    memory_resource* upstream_;
+
+    bool use_pool(size_t n, size_t alignment) const noexcept;
+};
+
+// ARENA
+
+/**
+ *  \brief Arena owning the size-class pools of `pool_allocator`.
+ *
+ *  Move and copy constructors are disabled, since allocators hold
+ *  a pointer to the arena.
+ */
+template <
+    size_t BlocksPerChunk,
+    size_t Alignment,
+    bool UseLocks
+>
+class pool_allocator_arena
+{
+public:
+    // MEMBER TEMPLATES
+    // ----------------
+    template <size_t N1 = BlocksPerChunk, size_t A1 = Alignment, bool UL1 = UseLocks>
+    struct rebind { using other = pool_allocator_arena<N1, A1, UL1>; };
+
+    // STATIC VARIABLES
+    // ----------------
+    static constexpr size_t alignment = Alignment;
+    static constexpr size_t blocks_per_chunk = BlocksPerChunk;
+    static constexpr bool use_locks = UseLocks;
+
+    // MEMBER TYPES
+    // ------------
+    using mutex_type = conditional_t<UseLocks, mutex, dummy_mutex>;
+
+    // MEMBER FUNCTIONS
+    // ----------------
+
+    // CONSTRUCTORS
+
+    pool_allocator_arena(const pool_allocator_arena&) = delete;
+    pool_allocator_arena& operator=(const pool_allocator_arena&) = delete;
+    pool_allocator_arena(pool_allocator_arena&&) = delete;
+    pool_allocator_arena& operator=(pool_allocator_arena&&) = delete;
+
+    pool_allocator_arena(size_t max_block_size = 0, memory_resource* upstream = nullptr):
+        data_(size_class_pool(blocks_per_chunk, max_block_size, alignment, upstream))
+    {}
+
+    // ALLOCATION
+
+    template <size_t RequiredAlignment> byte* allocate(size_t n);
+    void deallocate(byte* p, size_t n) noexcept;
+
+    // PROPERTIES
+
+    size_t max_block_size() const noexcept
+    {
+        return pool_().max_block_size();
+    }
+
+    void reset() noexcept
+    {
+        lock_guard<mutex_type> lock(mutex_());
+        pool_().release();
+    }
+
+private:
+    compressed_pair<size_class_pool, mutex_type> data_;
+
+    size_class_pool& pool_() noexcept
+    {
+        return get<0>(data_);
+    }
+
+    const size_class_pool& pool_() const noexcept
+    {
+        return get<0>(data_);
+    }
+
+    mutex_type& mutex_() noexcept
+    {
+        return get<1>(data_);
+    }
+
+    const mutex_type& mutex_() const noexcept
+    {
+        return get<1>(data_);
+    }
+};
+
+// ALLOCATOR
 
 /**
- *  \brief Allocator optimized for stack-based allocation.
+ *  \brief Allocator optimized for node-based containers.
  */
 template <
     typename T,
-    size_t N,
-    size_t Alignment = alignof(max_align_t)
+    size_t BlocksPerChunk,
+    size_t Alignment,
+    bool UseLocks
 >
 class pool_allocator
 {
 public:
     // MEMBER TEMPLATES
     // ----------------
-    template <typename T1, size_t N1 = N, size_t A1 = Alignment>
-    struct rebind { using other = pool_allocator<T1, N1, A1>; };
+    template <typename T1, size_t N1 = BlocksPerChunk, size_t A1 = Alignment, bool UL1 = UseLocks>
+    struct rebind { using other = pool_allocator<T1, N1, A1, UL1>; };
 
     // STATIC VARIABLES
     // ----------------
     static constexpr size_t alignment = Alignment;
-    static constexpr size_t size = N;
+    static constexpr size_t blocks_per_chunk = BlocksPerChunk;
+    static constexpr bool use_locks = UseLocks;
 
     // MEMBER TYPES
     // ------------
+    using self_t = pool_allocator<T, BlocksPerChunk, Alignment, UseLocks>;
     using value_type = T;
+    using arena_type = pool_allocator_arena<blocks_per_chunk, alignment, use_locks>;
+    using mutex_type = typename arena_type::mutex_type;
+    using propagate_on_container_move_assignment = true_type;
 #if defined(CPP11_PARTIAL_ALLOCATOR_TRAITS)
     using reference = value_type&;
     using const_reference = const value_type&;
@@ -65,34 +341,275 @@ public:
     using size_type = size_t;
     using difference_type = ptrdiff_t;
 #endif      // CPP11_PARTIAL_ALLOCATOR_TRAITS
-// TODO: here
 
     // MEMBER FUNCTIONS
     // ----------------
-//    pool_allocator() noexcept;
-//    pool_allocator(const pool_allocator<T, N, Alignment>&) noexcept;
-//    ~pool_allocator() noexcept;
 
-//    pool_allocator<T, N, Alignment>& operator=(const pool_allocator<T, N, Alignment>&) noexcept;
-//    pool_allocator<T, N, Alignment>& operator=(pool_allocator<T, N, Alignment>&&) noexcept;
+    // CONSTRUCTORS
 
-private:
-    union slot_
+    pool_allocator() noexcept:
+        arena_(nullptr)
+    {}
+
+    pool_allocator(arena_type& arena) noexcept:
+        arena_(&arena)
+    {}
+
+    pool_allocator(const self_t& rhs) noexcept:
+        arena_(rhs.arena_)
+    {}
+
+    template <typename T1>
+    pool_allocator(const pool_allocator<T1, BlocksPerChunk, Alignment, UseLocks>& rhs) noexcept:
+        arena_(rhs.arena_)
+    {}
+
+    self_t& operator=(const self_t& rhs) noexcept
+    {
+        arena_ = rhs.arena_;
+        return *this;
+    }
+
+    template <typename T1>
+    self_t& operator=(const pool_allocator<T1, BlocksPerChunk, Alignment, UseLocks>& rhs) noexcept
+    {
+        arena_ = rhs.arena_;
+        return *this;
+    }
+
+    pool_allocator(self_t&& rhs) noexcept
+    {
+        swap(arena_, rhs.arena_);
+    }
+
+    template <typename T1>
+    pool_allocator(pool_allocator<T1, BlocksPerChunk, Alignment, UseLocks>&& rhs) noexcept
+    {
+        swap(arena_, rhs.arena_);
+    }
+
+    self_t& operator=(self_t&& rhs) noexcept
     {
-        value_type element;
-        slot_* next;
-    };
+        swap(arena_, rhs.arena_);
+        return *this;
+    }
 
-    using data_pointer_ = char*;
-    using slot_type_ = slot_;
-    using slot_pointer_ = slot_*;
+    template <typename T1>
+    self_t& operator=(pool_allocator<T1, BlocksPerChunk, Alignment, UseLocks>&& rhs) noexcept
+    {
+        swap(arena_, rhs.arena_);
+        return *this;
+    }
+
+    ~pool_allocator() noexcept
+    {
+        arena_ = nullptr;
+    }
+
+    // ALLOCATOR TRAITS
+
+    value_type* allocate(size_t n, const void* hint = nullptr)
+    {
+        assert(arena_ && "Arena cannot be null.");
+        return reinterpret_cast<T*>(arena_->template allocate<alignof(T)>(sizeof(T) * n));
+    }
+
+    void deallocate(value_type* p, size_t n)
+    {
+        assert(arena_ && "Arena cannot be null.");
+        arena_->deallocate(reinterpret_cast<byte*>(p), sizeof(T) * n);
+    }
+
+#if defined(CPP11_PARTIAL_ALLOCATOR_TRAITS)
+
+    template <typename ... Ts>
+    void construct(T* p, Ts&&... ts)
+    {
+        ::new (static_cast<void*>(p)) T(std::forward<Ts>(ts)...);
+    }
+
+    void destroy(T* p)
+    {
+        p->~T();
+    }
+
+    size_type max_size()
+    {
+        return std::numeric_limits<size_type>::max();
+    }
+
+#endif      // CPP11_PARTIAL_ALLOCATOR_TRAITS
+
+private:
+    template <typename T1, size_t N, size_t A, bool UL>
+    friend class pool_allocator;
+
+    template <typename T1, size_t N1, size_t A1, bool UL1, typename T2, size_t N2, size_t A2, bool UL2>
+    friend bool operator==(const pool_allocator<T1, N1, A1, UL1>& lhs, const pool_allocator<T2, N2, A2, UL2>& rhs) noexcept;
+
+    arena_type* arena_ = nullptr;
 };
 
-// TODO: specialize is_relocatable
-// TODO: add locked and unlocked variants
+// ALIAS
+// -----
+
+template <
+    size_t BlocksPerChunk = 0,
+    size_t Alignment = alignof(max_align_t),
+    bool UseLocks = false
+>
+using pool_resource = resource_adaptor<
+    pool_allocator<byte, BlocksPerChunk, Alignment, UseLocks>
+>;
+
+template <
+    size_t BlocksPerChunk = 0,
+    size_t Alignment = alignof(max_align_t)
+>
+using pool_unlocked_resource = resource_adaptor<
+    pool_allocator<byte, BlocksPerChunk, Alignment, false>
+>;
+
+template <
+    size_t BlocksPerChunk = 0,
+    size_t Alignment = alignof(max_align_t)
+>
+using pool_locked_resource = resource_adaptor<
+    pool_allocator<byte, BlocksPerChunk, Alignment, true>
+>;
+
+template <
+    typename T,
+    size_t BlocksPerChunk = 0,
+    size_t Alignment = alignof(max_align_t)
+>
+using pool_locked_allocator = pool_allocator<T, BlocksPerChunk, Alignment, true>;
+
+template <
+    typename T,
+    size_t BlocksPerChunk = 0,
+    size_t Alignment = alignof(max_align_t)
+>
+using pool_unlocked_allocator = pool_allocator<T, BlocksPerChunk, Alignment, false>;
+
+// SPECIALIZATION
+// --------------
+
+template <>
+struct is_relocatable<size_class_pool>: true_type
+{};
+
+template <size_t N, size_t A, bool UL>
+struct is_relocatable<pool_allocator_arena<N, A, UL>>: false_type
+{};
+
+template <typename T, size_t N, size_t A, bool UL>
+struct is_relocatable<pool_allocator<T, N, A, UL>>: true_type
+{};
 
 // IMPLEMENTATION
 // --------------
 
+// POOL
+
+
+inline bool size_class_pool::use_pool(size_t n, size_t alignment) const noexcept
+{
+    return n <= max_block_size_ && alignment <= alignment_;
+}
+
+
+/**
+ *  \brief Index of the pool serving `n` bytes, for `0 < n <= max_block_size()`.
+ */
+inline size_t size_class_pool::size_class(size_t n) const noexcept
+{
+    // 16 classes spaced by the alignment, then powers of two
+    size_t index = (n - 1) >> shift_;
+    if (index < 16) {
+        return index;
+    }
+
+    size_t cls = 15;
+    for (index >>= 4; index; index >>= 1) {
+        ++cls;
+    }
+    return cls;
+}
+
+
+inline void* size_class_pool::allocate(size_t n, size_t alignment)
+{
+    n = n ? n : 1;
+    if (use_pool(n, alignment)) {
+        return pools_[size_class(n)].allocate();
+    }
+    return upstream_->allocate(n, alignment);
+}
+
+
+inline void size_class_pool::deallocate(void* p, size_t n, size_t alignment) noexcept
+{
+    n = n ? n : 1;
+    if (use_pool(n, alignment)) {
+        pools_[size_class(n)].deallocate(p);
+    } else {
+        upstream_->deallocate(p, n, alignment);
+    }
+}
+
+// ARENA
+
+template <size_t N, size_t A, bool UL>
+const size_t pool_allocator_arena<N, A, UL>::alignment;
+
+template <size_t N, size_t A, bool UL>
+const size_t pool_allocator_arena<N, A, UL>::blocks_per_chunk;
+
+template <size_t N, size_t A, bool UL>
+const bool pool_allocator_arena<N, A, UL>::use_locks;
+
+template <size_t N, size_t A, bool UL>
+template <size_t RequiredAlignment>
+inline byte* pool_allocator_arena<N, A, UL>::allocate(size_t n)
+{
+    static_assert(RequiredAlignment <= alignment, "Alignment is too small for this arena");
+
+    lock_guard<mutex_type> lock(mutex_());
+    return static_cast<byte*>(pool_().allocate(n, alignment));
+}
+
+
+template <size_t N, size_t A, bool UL>
+inline void pool_allocator_arena<N, A, UL>::deallocate(byte* p, size_t n) noexcept
+{
+    lock_guard<mutex_type> lock(mutex_());
+    pool_().deallocate(p, n, alignment);
+}
+
+// ALLOCATOR
+
+template <typename T, size_t N, size_t A, bool UL>
+const size_t pool_allocator<T, N, A, UL>::alignment;
+
+template <typename T, size_t N, size_t A, bool UL>
+const size_t pool_allocator<T, N, A, UL>::blocks_per_chunk;
+
+template <typename T, size_t N, size_t A, bool UL>
+const bool pool_allocator<T, N, A, UL>::use_locks;
+
+template <typename T1, size_t N1, size_t A1, bool UL1, typename T2, size_t N2, size_t A2, bool UL2>
+inline bool operator==(const pool_allocator<T1, N1, A1, UL1>& lhs,
+    const pool_allocator<T2, N2, A2, UL2>& rhs) noexcept
+{
+    return lhs.arena_ == rhs.arena_;
+}
+
+template <typename T1, size_t N1, size_t A1, bool UL1, typename T2, size_t N2, size_t A2, bool UL2>
+inline bool operator!=(const pool_allocator<T1, N1, A1, UL1>& lhs,
+    const pool_allocator<T2, N2, A2, UL2>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
 
 PYCPP_END_NAMESPACE
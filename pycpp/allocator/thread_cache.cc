@@ -0,0 +1,459 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/allocator/pool.h>
+#include <pycpp/allocator/thread_cache.h>
+#include <pycpp/preprocessor/tls.h>
+#include <pycpp/stl/algorithm.h>
+#include <pycpp/stl/atomic.h>
+#include <pycpp/stl/mutex.h>
+#include <vector>
+#include <stdint.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// CONSTANTS
+// ---------
+
+static constexpr size_t BATCH_BYTES = 8192;
+static constexpr size_t MIN_BATCH_SIZE = 4;
+static constexpr size_t MAX_BATCH_SIZE = 64;
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Free block, linked to the next block and, at the head
+ *  of a batch in the central pool, to the next batch.
+ */
+struct thread_cache_node
+{
+    thread_cache_node* next;
+    thread_cache_node* batch;
+};
+
+
+/**
+ *  \brief Free blocks of one size class, cached by a thread.
+ */
+struct thread_cache_bin
+{
+    thread_cache_node* head = nullptr;
+    size_t count = 0;
+};
+
+
+/**
+ *  \brief Free blocks of one size class, shared by all threads.
+ */
+struct central_bin
+{
+    mutex lock;
+    thread_cache_node* batches = nullptr;
+    size_t batch_size = 0;
+    size_t block_size = 0;
+};
+
+
+/**
+ *  \brief Cache of a single thread for a single resource.
+ *
+ *  Caches are owned by the thread, and linked into the list of
+ *  their resource, so the resource can detach them when destroyed.
+ *  `owner`, `prev` and `next` are guarded by the registry mutex.
+ */
+struct thread_cache
+{
+    uint64_t id;
+    thread_cache_resource_impl* owner;
+    thread_cache* prev = nullptr;
+    thread_cache* next = nullptr;
+    unique_ptr<thread_cache_bin[]> bins;
+
+    thread_cache(uint64_t id, thread_cache_resource_impl* owner, size_t classes);
+};
+
+
+/**
+ *  \brief Caches of the current thread, flushed when the thread exits.
+ */
+struct thread_cache_list
+{
+    // use the global allocator, since the resource
+    // may be installed as the default resource
+    std::vector<thread_cache*> caches;
+
+    ~thread_cache_list();
+};
+
+
+struct thread_cache_resource_impl
+{
+    uint64_t id;
+    size_class_pool pool;
+    unique_ptr<central_bin[]> central;
+    thread_cache* caches = nullptr;
+
+    thread_cache_resource_impl(size_t max_block_size, memory_resource* upstream);
+    ~thread_cache_resource_impl();
+
+    bool use_cache(size_t n, size_t alignment) const noexcept;
+    thread_cache* cache();
+
+    void* allocate(size_t n, size_t alignment);
+    void deallocate(void* p, size_t n, size_t alignment) noexcept;
+
+    void fetch(thread_cache_bin& bin, size_t cls);
+    void release(thread_cache_bin& bin, size_t cls) noexcept;
+    void flush(thread_cache& cache) noexcept;
+};
+
+// GLOBALS
+// -------
+
+// Resources are identified by a unique ID, rather than their
+// address, since a new resource may reuse the address of a
+// destroyed one while threads still hold stale caches for it.
+static atomic<uint64_t> RESOURCE_ID = ATOMIC_VAR_INIT(1);
+static thread_local_storage uint64_t LAST_ID = 0;
+static thread_local_storage thread_cache* LAST_CACHE = nullptr;
+static thread_local_storage bool THREAD_EXITED = false;
+static thread_local thread_cache_list THREAD_CACHES;
+
+// HELPERS
+// -------
+
+
+/**
+ *  \brief Mutex guarding the links between caches and resources.
+ *
+ *  Never destroyed, since threads may exit after static destructors.
+ */
+static mutex& registry_mutex()
+{
+    static mutex* m = new mutex;
+    return *m;
+}
+
+
+/**
+ *  \brief Unlink a cache from its resource, with the registry locked.
+ */
+static void detach(thread_cache* cache) noexcept
+{
+    thread_cache_resource_impl* owner = cache->owner;
+    if (cache->prev) {
+        cache->prev->next = cache->next;
+    } else {
+        owner->caches = cache->next;
+    }
+    if (cache->next) {
+        cache->next->prev = cache->prev;
+    }
+    cache->owner = nullptr;
+    cache->prev = nullptr;
+    cache->next = nullptr;
+}
+
+// IMPLEMENTATION
+// --------------
+
+
+thread_cache::thread_cache(uint64_t id, thread_cache_resource_impl* owner, size_t classes):
+    id(id),
+    owner(owner),
+    bins(new thread_cache_bin[classes])
+{}
+
+
+thread_cache_list::~thread_cache_list()
+{
+    {
+        lock_guard<mutex> lock(registry_mutex());
+        for (thread_cache* cache: caches) {
+            if (cache->owner) {
+                cache->owner->flush(*cache);
+                detach(cache);
+            }
+        }
+    }
+    for (thread_cache* cache: caches) {
+        delete cache;
+    }
+    caches.clear();
+
+    // later allocations from this thread bypass the caches
+    LAST_ID = 0;
+    LAST_CACHE = nullptr;
+    THREAD_EXITED = true;
+}
+
+
+thread_cache_resource_impl::thread_cache_resource_impl(size_t max_block_size, memory_resource* upstream):
+    id(RESOURCE_ID.fetch_add(1)),
+    pool(0, max_block_size, max(alignof(max_align_t), sizeof(thread_cache_node)), upstream)
+{
+    size_t classes = pool.size_classes();
+    central.reset(new central_bin[classes]);
+    for (size_t i = 0; i < classes; ++i) {
+        central_bin& bin = central[i];
+        bin.block_size = pool.class_block_size(i);
+        bin.batch_size = min(max(BATCH_BYTES / bin.block_size, MIN_BATCH_SIZE), MAX_BATCH_SIZE);
+    }
+}
+
+
+thread_cache_resource_impl::~thread_cache_resource_impl()
+{
+    // threads delete their caches on exit
+    lock_guard<mutex> lock(registry_mutex());
+    while (caches) {
+        detach(caches);
+    }
+    if (LAST_ID == id) {
+        LAST_ID = 0;
+        LAST_CACHE = nullptr;
+    }
+}
+
+
+inline bool thread_cache_resource_impl::use_cache(size_t n, size_t alignment) const noexcept
+{
+    return n <= pool.max_block_size() && alignment <= pool.alignment();
+}
+
+
+/**
+ *  \brief Get the cache of the current thread, or null after the thread exits.
+ */
+thread_cache* thread_cache_resource_impl::cache()
+{
+    if (LAST_ID == id) {
+        return LAST_CACHE;
+    } else if (THREAD_EXITED) {
+        return nullptr;
+    }
+
+    thread_cache_list& list = THREAD_CACHES;
+    thread_cache* result = nullptr;
+    for (thread_cache* cache: list.caches) {
+        if (cache->id == id) {
+            result = cache;
+            break;
+        }
+    }
+
+    if (!result) {
+        unique_ptr<thread_cache> cache(new thread_cache(id, this, pool.size_classes()));
+        lock_guard<mutex> lock(registry_mutex());
+
+        // drop caches of destroyed resources
+        auto stale = [](thread_cache* c) -> bool {
+            if (c->owner == nullptr) {
+                delete c;
+                return true;
+            }
+            return false;
+        };
+        list.caches.erase(remove_if(list.caches.begin(), list.caches.end(), stale), list.caches.end());
+        list.caches.push_back(cache.get());
+
+        result = cache.release();
+        result->next = caches;
+        if (caches) {
+            caches->prev = result;
+        }
+        caches = result;
+    }
+
+    LAST_ID = id;
+    LAST_CACHE = result;
+    return result;
+}
+
+
+void* thread_cache_resource_impl::allocate(size_t n, size_t alignment)
+{
+    n = n ? n : 1;
+    if (!use_cache(n, alignment)) {
+        return pool.upstream()->allocate(n, alignment);
+    }
+
+    size_t cls = pool.size_class(n);
+    thread_cache* c = cache();
+    if (!c) {
+        central_bin& central_bin = central[cls];
+        lock_guard<mutex> lock(central_bin.lock);
+        return pool.allocate(central_bin.block_size, alignment);
+    }
+
+    thread_cache_bin& bin = c->bins[cls];
+    if (!bin.head) {
+        fetch(bin, cls);
+    }
+    thread_cache_node* node = bin.head;
+    bin.head = node->next;
+    --bin.count;
+    return node;
+}
+
+
+void thread_cache_resource_impl::deallocate(void* p, size_t n, size_t alignment) noexcept
+{
+    n = n ? n : 1;
+    if (!use_cache(n, alignment)) {
+        pool.upstream()->deallocate(p, n, alignment);
+        return;
+    }
+
+    size_t cls = pool.size_class(n);
+    thread_cache* c = cache();
+    if (!c) {
+        central_bin& central_bin = central[cls];
+        lock_guard<mutex> lock(central_bin.lock);
+        pool.deallocate(p, central_bin.block_size, alignment);
+        return;
+    }
+
+    thread_cache_bin& bin = c->bins[cls];
+    thread_cache_node* node = static_cast<thread_cache_node*>(p);
+    node->next = bin.head;
+    bin.head = node;
+    if (++bin.count > 2 * central[cls].batch_size) {
+        release(bin, cls);
+    }
+}
+
+
+/**
+ *  \brief Move a batch of blocks from the central pool to an empty bin.
+ */
+void thread_cache_resource_impl::fetch(thread_cache_bin& bin, size_t cls)
+{
+    central_bin& central_bin = central[cls];
+    lock_guard<mutex> lock(central_bin.lock);
+    if (central_bin.batches) {
+        thread_cache_node* batch = central_bin.batches;
+        central_bin.batches = batch->batch;
+        bin.head = batch;
+        bin.count = central_bin.batch_size;
+        return;
+    }
+
+    // carve a new batch, which reuses blocks flushed individually first
+    // a partial batch is kept if upstream runs out of memory
+    thread_cache_node* head = nullptr;
+    size_t count = 0;
+    for (; count < central_bin.batch_size; ++count) {
+        thread_cache_node* node;
+        try {
+            node = static_cast<thread_cache_node*>(pool.allocate(central_bin.block_size));
+        } catch (...) {
+            if (count == 0) {
+                throw;
+            }
+            break;
+        }
+        node->next = head;
+        head = node;
+    }
+    bin.head = head;
+    bin.count = count;
+}
+
+
+/**
+ *  \brief Move a batch of blocks from a full bin to the central pool.
+ */
+void thread_cache_resource_impl::release(thread_cache_bin& bin, size_t cls) noexcept
+{
+    central_bin& central_bin = central[cls];
+    thread_cache_node* batch = bin.head;
+    thread_cache_node* last = batch;
+    for (size_t i = 1; i < central_bin.batch_size; ++i) {
+        last = last->next;
+    }
+    bin.head = last->next;
+    bin.count -= central_bin.batch_size;
+    last->next = nullptr;
+
+    lock_guard<mutex> lock(central_bin.lock);
+    batch->batch = central_bin.batches;
+    central_bin.batches = batch;
+}
+
+
+/**
+ *  \brief Return every block cached by a thread to the central pool.
+ */
+void thread_cache_resource_impl::flush(thread_cache& cache) noexcept
+{
+    for (size_t cls = 0; cls < pool.size_classes(); ++cls) {
+        thread_cache_bin& bin = cache.bins[cls];
+        while (bin.count >= central[cls].batch_size) {
+            release(bin, cls);
+        }
+
+        central_bin& central_bin = central[cls];
+        lock_guard<mutex> lock(central_bin.lock);
+        while (bin.head) {
+            thread_cache_node* node = bin.head;
+            bin.head = node->next;
+            pool.deallocate(node, central_bin.block_size);
+        }
+        bin.count = 0;
+    }
+}
+
+
+thread_cache_resource::thread_cache_resource(size_t max_block_size, memory_resource* upstream):
+    ptr_(new thread_cache_resource_impl(max_block_size, upstream))
+{}
+
+
+thread_cache_resource::~thread_cache_resource()
+{}
+
+
+/**
+ *  \brief Return the blocks cached by the current thread to the central pool.
+ */
+void thread_cache_resource::flush() noexcept
+{
+    thread_cache* cache = ptr_->cache();
+    if (cache) {
+        ptr_->flush(*cache);
+    }
+}
+
+
+size_t thread_cache_resource::max_block_size() const noexcept
+{
+    return ptr_->pool.max_block_size();
+}
+
+
+memory_resource* thread_cache_resource::upstream() const noexcept
+{
+    return ptr_->pool.upstream();
+}
+
+
+void* thread_cache_resource::do_allocate(size_t n, size_t alignment)
+{
+    return ptr_->allocate(n, alignment);
+}
+
+
+void thread_cache_resource::do_deallocate(void* p, size_t n, size_t alignment)
+{
+    ptr_->deallocate(p, n, alignment);
+}
+
+
+bool thread_cache_resource::do_is_equal(const memory_resource& rhs) const noexcept
+{
+    return this == &rhs;
+}
+
+PYCPP_END_NAMESPACE
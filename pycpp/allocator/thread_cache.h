@@ -0,0 +1,94 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Thread-caching memory resource.
+ *
+ *  A polymorphic resource for allocation-heavy, multi-threaded code.
+ *  Each thread keeps a cache of free blocks for each size class, so
+ *  most allocations and deallocations take no lock. A cache that runs
+ *  out of blocks fetches a whole batch from a central pool, and a
+ *  cache that holds too many returns a batch, so each lock on the
+ *  central pool is amortized over many blocks. Size classes match
+ *  `size_class_pool`: multiples of the alignment up to 16 times the
+ *  alignment, then powers of two up to `max_block_size` (4096 bytes by
+ *  default). Larger requests go directly to the upstream resource.
+ *
+ *  Blocks of a size class are interchangeable, so a block freed by a
+ *  thread other than the one which allocated it simply goes into the
+ *  freeing thread's cache, and returns to the central pool with the
+ *  next batch. A thread's cache is returned to the central pool when
+ *  the thread exits, or by `flush()`. Memory is only returned upstream
+ *  when the resource is destroyed.
+ *
+ *  The resource may be installed with `set_default_resource()`, for
+ *  all containers using the default `polymorphic_allocator`. It must
+ *  then outlive every container allocating through it, and the
+ *  previous default resource should be restored before it is destroyed.
+ *
+ *  \synopsis
+ *      class thread_cache_resource: public memory_resource
+ *      {
+ *      public:
+ *          thread_cache_resource(size_t max_block_size = 0, memory_resource* upstream = nullptr);
+ *          thread_cache_resource(const thread_cache_resource&) = delete;
+ *          thread_cache_resource& operator=(const thread_cache_resource&) = delete;
+ *          ~thread_cache_resource();
+ *
+ *          void flush() noexcept;
+ *          size_t max_block_size() const noexcept;
+ *          memory_resource* upstream() const noexcept;
+ *
+ *      protected:
+ *          virtual void* do_allocate(size_t n, size_t alignment) override;
+ *          virtual void do_deallocate(void* p, size_t n, size_t alignment) override;
+ *          virtual bool do_is_equal(const memory_resource& rhs) const noexcept override;
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory.h>
+#include <stddef.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// FORWARD
+// -------
+
+struct thread_cache_resource_impl;
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Memory resource with per-thread caches of free blocks.
+ *
+ *  A zero `max_block_size` uses 4096 bytes, and a null `upstream`
+ *  uses `new_delete_resource()`.
+ */
+class thread_cache_resource: public memory_resource
+{
+public:
+    thread_cache_resource(size_t max_block_size = 0, memory_resource* upstream = nullptr);
+    thread_cache_resource(const thread_cache_resource&) = delete;
+    thread_cache_resource& operator=(const thread_cache_resource&) = delete;
+    ~thread_cache_resource();
+
+    // MODIFIERS
+    void flush() noexcept;
+
+    // PROPERTIES
+    size_t max_block_size() const noexcept;
+    memory_resource* upstream() const noexcept;
+
+protected:
+    virtual void* do_allocate(size_t n, size_t alignment) override;
+    virtual void do_deallocate(void* p, size_t n, size_t alignment) override;
+    virtual bool do_is_equal(const memory_resource& rhs) const noexcept override;
+
+private:
+    unique_ptr<thread_cache_resource_impl> ptr_;
+};
+
+PYCPP_END_NAMESPACE
@@ -96,6 +96,7 @@
 #pragma once
 
 #include <pycpp/preprocessor/architecture.h>
+#include <pycpp/preprocessor/compiler.h>
 #include <pycpp/stl/algorithm.h>
 #include <pycpp/stl/functional.h>
 #include <pycpp/stl/initializer_list.h>
@@ -113,6 +114,14 @@
 #include <stdint.h>
 #include <string.h>
 #include <sys/types.h>
+#if (defined(HAVE_GCC) || defined(HAVE_CLANG)) && defined(__SSE2__)
+#   include <emmintrin.h>
+#   define PYCPP_BTREE_SSE2
+#   if defined(__SSE4_2__)
+#       include <nmmintrin.h>
+#       define PYCPP_BTREE_SSE42
+#   endif
+#endif
 
 PYCPP_BEGIN_NAMESPACE
 
@@ -513,6 +522,269 @@ struct btree_binary_search_compare_to
     }
 };
 
+// Returns the position of the first of n sorted keys which is not
+// less than k, or greater than k if Upper. The keys are counted
+// without branches, which compilers may vectorize.
+template <bool Upper, typename T>
+inline int btree_scalar_search(const T* keys, int n, T k) noexcept
+{
+    int count = 0;
+    for (int i = 0; i < n; ++i) {
+        count += Upper ? !(k < keys[i]) : keys[i] < k;
+    }
+    return count;
+}
+
+
+template <bool Upper, typename T>
+inline int btree_arithmetic_search(const T* keys, int n, T k) noexcept
+{
+    return btree_scalar_search<Upper>(keys, n, k);
+}
+
+#if defined(PYCPP_BTREE_SSE2)
+
+// SSE2 compares for each key type. less() and greater() return
+// one bit for each key in the vector less than, or greater than,
+// the search key. Unsigned integers are compared as signed
+// integers by flipping their sign bit.
+struct btree_sse2_int32
+{
+    using key_type = int32_t;
+    using vector_type = __m128i;
+    enum { lanes = 4, mask = 0xF };
+
+    static vector_type set1(key_type k) noexcept
+    {
+        return _mm_set1_epi32(k);
+    }
+
+    static vector_type load(const key_type* p) noexcept
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    static int less(vector_type v, vector_type k) noexcept
+    {
+        return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, k)));
+    }
+
+    static int greater(vector_type v, vector_type k) noexcept
+    {
+        return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(v, k)));
+    }
+};
+
+struct btree_sse2_uint32: btree_sse2_int32
+{
+    using key_type = uint32_t;
+
+    static vector_type set1(key_type k) noexcept
+    {
+        return _mm_set1_epi32(static_cast<int32_t>(k ^ 0x80000000U));
+    }
+
+    static vector_type load(const key_type* p) noexcept
+    {
+        vector_type v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        return _mm_xor_si128(v, _mm_set1_epi32(INT32_MIN));
+    }
+};
+
+struct btree_sse2_float
+{
+    using key_type = float;
+    using vector_type = __m128;
+    enum { lanes = 4, mask = 0xF };
+
+    static vector_type set1(key_type k) noexcept
+    {
+        return _mm_set1_ps(k);
+    }
+
+    static vector_type load(const key_type* p) noexcept
+    {
+        return _mm_loadu_ps(p);
+    }
+
+    static int less(vector_type v, vector_type k) noexcept
+    {
+        return _mm_movemask_ps(_mm_cmplt_ps(v, k));
+    }
+
+    static int greater(vector_type v, vector_type k) noexcept
+    {
+        return _mm_movemask_ps(_mm_cmpgt_ps(v, k));
+    }
+};
+
+struct btree_sse2_double
+{
+    using key_type = double;
+    using vector_type = __m128d;
+    enum { lanes = 2, mask = 0x3 };
+
+    static vector_type set1(key_type k) noexcept
+    {
+        return _mm_set1_pd(k);
+    }
+
+    static vector_type load(const key_type* p) noexcept
+    {
+        return _mm_loadu_pd(p);
+    }
+
+    static int less(vector_type v, vector_type k) noexcept
+    {
+        return _mm_movemask_pd(_mm_cmplt_pd(v, k));
+    }
+
+    static int greater(vector_type v, vector_type k) noexcept
+    {
+        return _mm_movemask_pd(_mm_cmpgt_pd(v, k));
+    }
+};
+
+#if defined(PYCPP_BTREE_SSE42)
+
+struct btree_sse42_int64
+{
+    using key_type = int64_t;
+    using vector_type = __m128i;
+    enum { lanes = 2, mask = 0x3 };
+
+    static vector_type set1(key_type k) noexcept
+    {
+        return _mm_set1_epi64x(k);
+    }
+
+    static vector_type load(const key_type* p) noexcept
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    static int less(vector_type v, vector_type k) noexcept
+    {
+        return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(k, v)));
+    }
+
+    static int greater(vector_type v, vector_type k) noexcept
+    {
+        return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(v, k)));
+    }
+};
+
+struct btree_sse42_uint64: btree_sse42_int64
+{
+    using key_type = uint64_t;
+
+    static vector_type set1(key_type k) noexcept
+    {
+        return _mm_set1_epi64x(static_cast<int64_t>(k ^ 0x8000000000000000ULL));
+    }
+
+    static vector_type load(const key_type* p) noexcept
+    {
+        vector_type v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        return _mm_xor_si128(v, _mm_set1_epi64x(INT64_MIN));
+    }
+};
+
+#endif
+
+// Compares the keys a vector at a time, stopping at the first vector
+// with a key not less than k, or greater than k if Upper, whose
+// position is found with a bit scan.
+template <bool Upper, typename Traits>
+inline int btree_simd_search(const typename Traits::key_type* keys, int n, typename Traits::key_type k) noexcept
+{
+    using vector_type = typename Traits::vector_type;
+
+    vector_type key = Traits::set1(k);
+    int i = 0;
+    for (; i + Traits::lanes <= n; i += Traits::lanes) {
+        vector_type v = Traits::load(keys + i);
+        int bits = Upper ? Traits::greater(v, key) : Traits::less(v, key) ^ Traits::mask;
+        if (bits) {
+            return i + __builtin_ctz(static_cast<unsigned>(bits));
+        }
+    }
+    return i + btree_scalar_search<Upper>(keys + i, n - i, k);
+}
+
+
+template <bool Upper>
+inline int btree_arithmetic_search(const int32_t* keys, int n, int32_t k) noexcept
+{
+    return btree_simd_search<Upper, btree_sse2_int32>(keys, n, k);
+}
+
+
+template <bool Upper>
+inline int btree_arithmetic_search(const uint32_t* keys, int n, uint32_t k) noexcept
+{
+    return btree_simd_search<Upper, btree_sse2_uint32>(keys, n, k);
+}
+
+
+template <bool Upper>
+inline int btree_arithmetic_search(const float* keys, int n, float k) noexcept
+{
+    return btree_simd_search<Upper, btree_sse2_float>(keys, n, k);
+}
+
+
+template <bool Upper>
+inline int btree_arithmetic_search(const double* keys, int n, double k) noexcept
+{
+    return btree_simd_search<Upper, btree_sse2_double>(keys, n, k);
+}
+
+#if defined(PYCPP_BTREE_SSE42)
+
+template <bool Upper>
+inline int btree_arithmetic_search(const int64_t* keys, int n, int64_t k) noexcept
+{
+    return btree_simd_search<Upper, btree_sse42_int64>(keys, n, k);
+}
+
+
+template <bool Upper>
+inline int btree_arithmetic_search(const uint64_t* keys, int n, uint64_t k) noexcept
+{
+    return btree_simd_search<Upper, btree_sse42_uint64>(keys, n, k);
+}
+
+#endif
+#endif
+
+// Dispatch helper class for searching sets of arithmetic keys
+// compared with less<>, which are stored contiguously.
+template <typename K, typename N, typename Compare>
+struct btree_arithmetic_search_plain_compare
+{
+    static int lower_bound(const K& k, const N& n, Compare)
+    {
+        return n.template arithmetic_search<false>(k);
+    }
+
+    static int upper_bound(const K& k, const N& n, Compare)
+    {
+        return n.template arithmetic_search<true>(k);
+    }
+};
+
+// Whether the values of a node are arithmetic keys compared with
+// less<>, as in sets, which can be searched as an array.
+template <typename Params>
+struct btree_is_arithmetic_search: integral_constant<bool,
+        (is_integral<typename Params::key_type>::value ||
+         is_floating_point<typename Params::key_type>::value) &&
+        is_same<typename Params::key_type, typename Params::mutable_value_type>::value &&
+        is_same<typename Params::key_compare, btree_key_compare_to_adapter<less<typename Params::key_type>>>::value
+    >
+{};
+
 // BTREE
 
 // A node in the btree holding. The same node type is used for both internal
@@ -556,14 +828,20 @@ public:
         binary_search_compare_to_type,
         binary_search_plain_compare_type
     >;
+    using arithmetic_search_type = btree_arithmetic_search_plain_compare<key_type, self_type, key_compare>;
     // If the key is an integral or floating point type, use linear
     // search which is faster than binary search for such types.
     // Might be wise to also configure linear search based on
-    // node-size.
+    // node-size. Sets of such keys compared with less<> compare
+    // the keys as an array instead.
     using search_type = conditional_t<
-        is_integral<key_type>::value || is_floating_point<key_type>::value,
-        linear_search_type,
-        binary_search_type
+        btree_is_arithmetic_search<Params>::value,
+        arithmetic_search_type,
+        conditional_t<
+            is_integral<key_type>::value || is_floating_point<key_type>::value,
+            linear_search_type,
+            binary_search_type
+        >
     >;
 
     struct base_fields {
@@ -786,6 +1064,15 @@ public:
         return s;
     }
 
+    // Returns the position of the first value whose key is not less
+    // than k, or greater than k if Upper, for sets of arithmetic keys
+    // compared with less<>.
+    template <bool Upper>
+    int arithmetic_search(const key_type& k) const noexcept
+    {
+        return btree_arithmetic_search<Upper>(&fields_.values[0], count(), k);
+    }
+
     // Returns the position of the first value whose key is not less
     // than k using binary search performed using plain compare.
     template <typename Compare>
@@ -1318,6 +1605,33 @@ public:
     template <typename InputIterator>
     void insert_multi_range(InputIterator b, InputIterator e);
 
+    // Replaces the contents of the btree with the values in [b, e),
+    // which must be sorted. The btree is built bottom-up in linear
+    // time, filling each node to fill times its capacity, but at
+    // least half full. Later values with a key equal to the
+    // previous value are skipped by bulk_load_unique().
+    template <typename InputIterator>
+    void bulk_load_unique(InputIterator b, InputIterator e, double fill = 1.0);
+
+    template <typename InputIterator>
+    void bulk_load_multi(InputIterator b, InputIterator e, double fill = 1.0);
+
+    // Inserts the values in [b, e), which must be sorted, by merging
+    // them with the values in the btree and rebuilding it in linear
+    // time.
+    template <typename InputIterator>
+    void merge_unique(InputIterator b, InputIterator e);
+
+    template <typename InputIterator>
+    void merge_multi(InputIterator b, InputIterator e);
+
+    // Moves the values in x into the btree, rebuilding it in linear
+    // time unless x is small enough to insert one value at a time.
+    // Values whose key already exists in the btree are left in x
+    // by merge_unique().
+    void merge_unique(self_type& x);
+    void merge_multi(self_type& x);
+
     void assign(const self_type& x);
 
     // Erase the specified iterator from the btree. The iterator must
@@ -1326,7 +1640,9 @@ public:
     // exists).
     iterator erase(iterator iter);
 
-    // Erases range. Returns the number of keys erased.
+    // Erases range. Returns the number of keys erased. Large ranges
+    // are erased by rebuilding the btree from the remaining values,
+    // which frees the erased nodes without rebalancing.
     int erase(iterator begin, iterator end);
 
     // Erases the specified key from the btree. Returns 1 if an element
@@ -1644,6 +1960,36 @@ private:
     // Tries to shrink the height of the tree by 1.
     void try_shrink();
 
+    // Builds a btree bottom-up from values appended in sorted order.
+    class bulk_loader;
+
+    // Functors returning the value to append when rebuilding a btree,
+    // either a copy of an input value or a value moved out of a
+    // btree that is about to be discarded.
+    struct copy_value
+    {
+        template <typename InputIterator>
+        auto operator()(const InputIterator& iter) const -> decltype(*iter)
+        {
+            return *iter;
+        }
+    };
+
+    struct move_value
+    {
+        mutable_value_type&& operator()(const iterator& iter) const noexcept
+        {
+            return move(*iter.node->mutable_value(iter.position));
+        }
+    };
+
+    // Rebuilds the btree from its values merged with the values in
+    // [b, e), which must be sorted. Values in the btree precede equal
+    // values in [b, e). If unique, values whose key equals the
+    // previous key are appended to rejected, if not null, instead.
+    template <typename InputIterator, typename Value>
+    void internal_merge(InputIterator b, InputIterator e, Value value, bool unique, bulk_loader* rejected);
+
     iterator internal_end(iterator iter) noexcept
     {
         return iter.node ? iter : end();
@@ -2116,6 +2462,33 @@ public:
         this->tree_.insert_unique_range(b, e);
     }
 
+    // Bulk loading routines. Replaces the contents with the sorted
+    // values in [b, e), filling each node to fill times its capacity.
+    template <typename InputIterator>
+    void bulk_load(InputIterator b, InputIterator e, double fill = 1.0)
+    {
+        this->tree_.bulk_load_unique(b, e, fill);
+    }
+
+    // Merge routines. Merges the sorted values in [b, e), or moves
+    // the values of x whose key is not in the container, in linear
+    // time.
+    template <typename InputIterator>
+    void merge(InputIterator b, InputIterator e)
+    {
+        this->tree_.merge_unique(b, e);
+    }
+
+    void merge(self_type& x)
+    {
+        this->tree_.merge_unique(x.tree_);
+    }
+
+    void merge(self_type&& x)
+    {
+        this->tree_.merge_unique(x.tree_);
+    }
+
     // Deletion routines.
     int erase(const key_type& key)
     {
@@ -2358,6 +2731,32 @@ public:
         this->tree_.insert_multi_range(b, e);
     }
 
+    // Bulk loading routines. Replaces the contents with the sorted
+    // values in [b, e), filling each node to fill times its capacity.
+    template <typename InputIterator>
+    void bulk_load(InputIterator b, InputIterator e, double fill = 1.0)
+    {
+        this->tree_.bulk_load_multi(b, e, fill);
+    }
+
+    // Merge routines. Merges the sorted values in [b, e), or moves
+    // the values of x, in linear time.
+    template <typename InputIterator>
+    void merge(InputIterator b, InputIterator e)
+    {
+        this->tree_.merge_multi(b, e);
+    }
+
+    void merge(self_type& x)
+    {
+        this->tree_.merge_multi(x.tree_);
+    }
+
+    void merge(self_type&& x)
+    {
+        this->tree_.merge_multi(x.tree_);
+    }
+
     // Deletion routines.
     int erase(const key_type& key)
     {
@@ -2713,6 +3112,192 @@ void btree_iterator<N, R, P>::decrement_slow()
 }
 
 
+// btree bulk loader
+
+// The rightmost node on each level of the btree is kept on a spine.
+// A value is appended to the rightmost leaf or, once the leaf is
+// full, becomes the delimiting key on the lowest level with room,
+// under which an empty subtree is started for the values that
+// follow. The rightmost nodes are filled once all values have been
+// appended.
+template <typename P>
+class btree<P>::bulk_loader
+{
+public:
+    // Loads values into tree, which must be empty until finish().
+    bulk_loader(btree& tree, double fill);
+    ~bulk_loader();
+
+    // Returns the key of the last value appended, or null.
+    const key_type* last() const noexcept
+    {
+        return last_;
+    }
+
+    // Appends a value, whose key must not be less than last().
+    template <typename ... Ts>
+    void append(Ts&&... ts);
+
+    // Completes the btree and stores it in the tree.
+    void finish();
+
+private:
+    enum {
+        // Every node holds at least 2 values, so each level holds
+        // at least 3 times as many values as the level above.
+        max_height = 8 * sizeof(size_type),
+    };
+
+    btree& tree_;
+    int target_;
+    int height_ = 0;
+    size_type size_ = 0;
+    const key_type* last_ = nullptr;
+    node_type* leftmost_ = nullptr;
+    node_type* spine_[max_height];
+};
+
+
+template <typename P>
+btree<P>::bulk_loader::bulk_loader(btree& tree, double fill):
+    tree_(tree)
+{
+    assert(tree_.empty());
+    int target = static_cast<int>(fill * node_values);
+    target_ = min<int>(max<int>(target, max<int>(min_node_values, 2)), node_values);
+}
+
+
+template <typename P>
+btree<P>::bulk_loader::~bulk_loader()
+{
+    // Free the partially built btree if an exception was thrown.
+    if (height_) {
+        tree_.internal_clear(spine_[height_ - 1]);
+    }
+}
+
+
+template <typename P>
+template <typename ... Ts>
+void btree<P>::bulk_loader::append(Ts&&... ts)
+{
+    if (height_ == 0) {
+        leftmost_ = tree_.new_leaf_root_node(node_values);
+        spine_[0] = leftmost_;
+        height_ = 1;
+    }
+
+    node_type* node = spine_[0];
+    if (node->count() < target_) {
+        node->insert_value(node->count(), forward<Ts>(ts)...);
+    } else {
+        int level = 1;
+        while (level < height_ && spine_[level]->count() == target_) {
+            ++level;
+        }
+        if (level == height_) {
+            // Grow the btree by a level. New internal nodes take the
+            // leftmost leaf as their parent, like the root node.
+            assert(height_ < max_height);
+            node_type* top = tree_.new_internal_node(leftmost_);
+            top->set_child(0, spine_[height_ - 1]);
+            spine_[height_++] = top;
+        }
+
+        node = spine_[level];
+        node_type* subtree = tree_.new_leaf_node(leftmost_);
+        try {
+            for (int i = 1; i < level; ++i) {
+                node_type* parent = tree_.new_internal_node(leftmost_);
+                parent->set_child(0, subtree);
+                subtree = parent;
+            }
+            node->insert_value(node->count(), forward<Ts>(ts)...);
+        } catch (...) {
+            tree_.internal_clear(subtree);
+            throw;
+        }
+
+        node->set_child(node->count(), subtree);
+        for (int i = level - 1; i > 0; --i) {
+            spine_[i] = subtree;
+            subtree = subtree->child(0);
+        }
+        spine_[0] = subtree;
+    }
+
+    assert(!last_ || !tree_.compare_keys(node->key(node->count() - 1), *last_));
+    last_ = &node->key(node->count() - 1);
+    ++size_;
+}
+
+
+template <typename P>
+void btree<P>::bulk_loader::finish()
+{
+    if (height_ == 0) {
+        return;
+    }
+
+    // Fill the rightmost nodes from the top down, by merging each
+    // with its left sibling, or moving values from its left sibling.
+    // Only the top node may be emptied by a merge.
+    for (int level = height_ - 1; level > 0; --level) {
+        node_type* parent = spine_[level];
+        node_type* node = spine_[level - 1];
+        assert(parent->count() > 0);
+        if (node->count() >= min_node_values) {
+            continue;
+        }
+
+        node_type* left = parent->child(node->position() - 1);
+        bool can_empty = level == height_ - 1;
+        if ((1 + left->count() + node->count()) <= node_values && (parent->count() > 1 || can_empty)) {
+            left->merge(node);
+            if (node->leaf()) {
+                tree_.delete_leaf_node(node);
+            } else {
+                tree_.delete_internal_node(node);
+            }
+            spine_[level - 1] = left;
+        } else {
+            int to_move = (left->count() - node->count()) / 2;
+            if (to_move > 0) {
+                left->rebalance_left_to_right(node, to_move);
+            }
+        }
+    }
+    if (height_ > 1 && spine_[height_ - 1]->count() == 0) {
+        spine_[height_ - 2]->make_root();
+        tree_.delete_internal_node(spine_[height_ - 1]);
+        --height_;
+    }
+
+    node_type* top = spine_[height_ - 1];
+    *tree_.mutable_root() = top;
+    if (height_ > 1) {
+        // The root node holds the size of the btree and its rightmost
+        // leaf, so the values and children of the top node are moved
+        // into a new root node.
+        node_type* root;
+        try {
+            root = tree_.new_internal_root_node();
+        } catch (...) {
+            *tree_.mutable_root() = nullptr;
+            throw;
+        }
+        *root->mutable_child(0) = top;
+        root->swap(top);
+        *tree_.mutable_root() = root;
+        tree_.delete_internal_node(top);
+        *tree_.mutable_rightmost() = spine_[0];
+        *tree_.mutable_size() = size_;
+    }
+    height_ = 0;
+}
+
+
 // btree methods
 template <typename P>
 inline btree<P>::btree(const allocator_type& alloc):
@@ -2837,6 +3422,7 @@ btree<P>::find_insert_unique_hint(iterator position, const key_type& key)
         // position.key() == key
         return make_pair(position, false);
     }
+    return find_insert_unique(key);
 }
 
 
@@ -2876,7 +3462,7 @@ template <typename P> template <typename InputIterator>
 void btree<P>::insert_unique_range(InputIterator b, InputIterator e)
 {
     for (; b != e; ++b) {
-        insert_unique(end(), *b);
+        insert_unique_hint(end(), *b);
     }
 }
 
@@ -2934,6 +3520,7 @@ btree<P>::find_insert_multi_hint(iterator position, const key_type& key)
             return next;
         }
     }
+    return find_insert_multi(key);
 }
 
 
@@ -2959,7 +3546,7 @@ btree<P>::emplace_multi_hint(iterator position, Ts&&... ts)
         position = find_insert_multi_hint(position, params_type::key(v));
         return internal_insert(position, move(v));
     }
-    return insert_multi(forward<Ts>(ts)...);
+    return emplace_multi(forward<Ts>(ts)...);
 }
 
 
@@ -2967,11 +3554,138 @@ template <typename P> template <typename InputIterator>
 void btree<P>::insert_multi_range(InputIterator b, InputIterator e)
 {
     for (; b != e; ++b) {
-        insert_multi(end(), *b);
+        insert_multi_hint(end(), *b);
     }
 }
 
 
+template <typename P> template <typename InputIterator>
+void btree<P>::bulk_load_unique(InputIterator b, InputIterator e, double fill)
+{
+    clear();
+    bulk_loader loader(*this, fill);
+    for (; b != e; ++b) {
+        auto&& v = *b;
+        const key_type* last = loader.last();
+        if (last && !compare_keys(*last, params_type::key(v))) {
+            // The previous key is equal to this key.
+            assert(!compare_keys(params_type::key(v), *last));
+            continue;
+        }
+        loader.append(forward<decltype(v)>(v));
+    }
+    loader.finish();
+}
+
+
+template <typename P> template <typename InputIterator>
+void btree<P>::bulk_load_multi(InputIterator b, InputIterator e, double fill)
+{
+    clear();
+    bulk_loader loader(*this, fill);
+    for (; b != e; ++b) {
+        loader.append(*b);
+    }
+    loader.finish();
+}
+
+
+template <typename P> template <typename InputIterator>
+void btree<P>::merge_unique(InputIterator b, InputIterator e)
+{
+    internal_merge(b, e, copy_value(), true, nullptr);
+}
+
+
+template <typename P> template <typename InputIterator>
+void btree<P>::merge_multi(InputIterator b, InputIterator e)
+{
+    internal_merge(b, e, copy_value(), false, nullptr);
+}
+
+
+template <typename P>
+void btree<P>::merge_unique(self_type& x)
+{
+    if (this == &x || x.empty()) {
+        return;
+    }
+
+    // Rebuilding moves every value in both btrees, while inserting
+    // a value visits a node on every level of the btree.
+    if (x.size() * height() < size()) {
+        for (iterator iter = x.begin(); iter != x.end();) {
+            pair<iterator, bool> p = find_insert_unique(iter.key());
+            if (p.second) {
+                internal_insert(p.first, move_value()(iter));
+                iter = x.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+        return;
+    }
+
+    self_type rest(x.key_comp(), x.internal_allocator());
+    bulk_loader rejected(rest, 1.0);
+    internal_merge(x.begin(), x.end(), move_value(), true, &rejected);
+    rejected.finish();
+    x.swap(rest);
+}
+
+
+template <typename P>
+void btree<P>::merge_multi(self_type& x)
+{
+    if (this == &x || x.empty()) {
+        return;
+    }
+
+    if (x.size() * height() < size()) {
+        for (iterator iter = x.begin(); iter != x.end(); ++iter) {
+            internal_insert(find_insert_multi(iter.key()), move_value()(iter));
+        }
+    } else {
+        internal_merge(x.begin(), x.end(), move_value(), false, nullptr);
+    }
+    x.clear();
+}
+
+
+template <typename P>
+template <typename InputIterator, typename Value>
+void btree<P>::internal_merge(InputIterator b, InputIterator e, Value value, bool unique, bulk_loader* rejected)
+{
+    // Values are moved out of the btree, so the merged values are
+    // loaded into a new btree, which replaces it once complete.
+    self_type tmp(key_comp(), internal_allocator());
+    bulk_loader loader(tmp, 1.0);
+    iterator iter = begin();
+    iterator last = end();
+    for (; b != e; ++b) {
+        auto&& v = value(b);
+        const key_type& key = params_type::key(v);
+        for (; iter != last && !compare_keys(key, iter.key()); ++iter) {
+            loader.append(move_value()(iter));
+        }
+
+        const key_type* previous = loader.last();
+        if (unique && previous && !compare_keys(*previous, key)) {
+            if (rejected) {
+                rejected->append(forward<decltype(v)>(v));
+            }
+        } else {
+            loader.append(forward<decltype(v)>(v));
+        }
+    }
+    for (; iter != last; ++iter) {
+        loader.append(move_value()(iter));
+    }
+    loader.finish();
+    swap(tmp);
+}
+
+
 template <typename P>
 void btree<P>::assign(const self_type& x)
 {
@@ -3064,6 +3778,28 @@ template <typename P>
 int btree<P>::erase(iterator begin, iterator end)
 {
     int count = distance(begin, end);
+    if (count == size()) {
+        clear();
+        return count;
+    }
+
+    // Erasing a value shifts the values after it in its node, so
+    // large ranges are erased by moving the remaining values into
+    // a new btree and freeing the old nodes whole.
+    if (count >= node_values && (size() - count) < count * min_node_values) {
+        self_type tmp(key_comp(), internal_allocator());
+        bulk_loader loader(tmp, 1.0);
+        for (iterator iter = this->begin(); iter != begin; ++iter) {
+            loader.append(move_value()(iter));
+        }
+        for (iterator iter = end; iter != this->end(); ++iter) {
+            loader.append(move_value()(iter));
+        }
+        loader.finish();
+        swap(tmp);
+        return count;
+    }
+
     for (int i = 0; i < count; i++) {
         begin = erase(begin);
     }
@@ -21,13 +21,13 @@ static csv_indexes parse_header(const csv_row& header)
 // -------
 
 
-csv_dict_stream_reader::csv_dict_stream_reader(csvpunct_impl* punct):
-    reader_(punct)
+csv_dict_stream_reader::csv_dict_stream_reader(csvpunct_impl* punct, const allocator_type& allocator):
+    reader_(punct, allocator)
 {}
 
 
 csv_dict_stream_reader::csv_dict_stream_reader(csv_dict_stream_reader&& rhs):
-    csv_dict_stream_reader()
+    csv_dict_stream_reader(nullptr, rhs.get_allocator())
 {
     swap(rhs);
 }
@@ -40,7 +40,8 @@ csv_dict_stream_reader& csv_dict_stream_reader::operator=(csv_dict_stream_reader
 }
 
 
-csv_dict_stream_reader::csv_dict_stream_reader(istream& stream, size_t skip, csvpunct_impl* punct)
+csv_dict_stream_reader::csv_dict_stream_reader(istream& stream, size_t skip, csvpunct_impl* punct, const allocator_type& allocator):
+    reader_(nullptr, allocator)
 {
     open(stream, skip, punct);
 }
@@ -65,6 +66,12 @@ const csvpunct_impl* csv_dict_stream_reader::punctuation() const
 }
 
 
+auto csv_dict_stream_reader::get_allocator() const -> allocator_type
+{
+    return reader_.get_allocator();
+}
+
+
 void csv_dict_stream_reader::swap(csv_dict_stream_reader& rhs)
 {
     using PYCPP_NAMESPACE::swap;
@@ -75,10 +82,12 @@ void csv_dict_stream_reader::swap(csv_dict_stream_reader& rhs)
 
 auto csv_dict_stream_reader::operator()() -> value_type
 {
-    value_type map;
+    value_type map(reader_.get_allocator());
     csv_row row = reader_();
+    map.reserve(header_.size());
     for (const auto& pair: header_) {
-        map[pair.first] = move(row.at(pair.second));
+        string key(pair.first, map.get_allocator());
+        map.emplace(move(key), move(row.at(pair.second)));
     }
 
     return map;
@@ -109,13 +118,13 @@ auto csv_dict_stream_reader::end() -> iterator
 }
 
 
-csv_dict_file_reader::csv_dict_file_reader(csvpunct_impl* punct):
-    csv_dict_stream_reader(punct)
+csv_dict_file_reader::csv_dict_file_reader(csvpunct_impl* punct, const allocator_type& allocator):
+    csv_dict_stream_reader(punct, allocator)
 {}
 
 
 csv_dict_file_reader::csv_dict_file_reader(csv_dict_file_reader&& rhs):
-    csv_dict_file_reader()
+    csv_dict_file_reader(nullptr, rhs.get_allocator())
 {
     swap(rhs);
 }
@@ -128,7 +137,8 @@ csv_dict_file_reader& csv_dict_file_reader::operator=(csv_dict_file_reader&& rhs
 }
 
 
-csv_dict_file_reader::csv_dict_file_reader(const string_view& name, size_t skip, csvpunct_impl* punct)
+csv_dict_file_reader::csv_dict_file_reader(const string_view& name, size_t skip, csvpunct_impl* punct, const allocator_type& allocator):
+    csv_dict_stream_reader(nullptr, allocator)
 {
     open(name, skip, punct);
 }
@@ -144,7 +154,8 @@ void csv_dict_file_reader::open(const string_view& name, size_t skip, csvpunct_i
 #if defined(HAVE_WFOPEN)                        // WINDOWS
 
 
-csv_dict_file_reader::csv_dict_file_reader(const wstring_view& name, size_t skip, csvpunct_impl* punct)
+csv_dict_file_reader::csv_dict_file_reader(const wstring_view& name, size_t skip, csvpunct_impl* punct, const allocator_type& allocator):
+    csv_dict_stream_reader(nullptr, allocator)
 {
     open(name, skip, punct);
 }
@@ -158,7 +169,8 @@ void csv_dict_file_reader::open(const wstring_view& name, size_t skip, csvpunct_
 
 
 
-csv_dict_file_reader::csv_dict_file_reader(const u16string_view& name, size_t skip, csvpunct_impl* punct)
+csv_dict_file_reader::csv_dict_file_reader(const u16string_view& name, size_t skip, csvpunct_impl* punct, const allocator_type& allocator):
+    csv_dict_stream_reader(nullptr, allocator)
 {
     open(name, skip, punct);
 }
@@ -197,13 +209,13 @@ void csv_dict_file_reader::swap(csv_dict_file_reader& rhs)
 }
 
 
-csv_dict_string_reader::csv_dict_string_reader(csvpunct_impl* punct):
-    csv_dict_stream_reader(punct)
+csv_dict_string_reader::csv_dict_string_reader(csvpunct_impl* punct, const allocator_type& allocator):
+    csv_dict_stream_reader(punct, allocator)
 {}
 
 
 csv_dict_string_reader::csv_dict_string_reader(csv_dict_string_reader&& rhs):
-    csv_dict_string_reader()
+    csv_dict_string_reader(nullptr, rhs.get_allocator())
 {
     swap(rhs);
 }
@@ -216,7 +228,8 @@ csv_dict_string_reader& csv_dict_string_reader::operator=(csv_dict_string_reader
 }
 
 
-csv_dict_string_reader::csv_dict_string_reader(const string_wrapper& str, size_t skip, csvpunct_impl* punct)
+csv_dict_string_reader::csv_dict_string_reader(const string_wrapper& str, size_t skip, csvpunct_impl* punct, const allocator_type& allocator):
+    csv_dict_stream_reader(nullptr, allocator)
 {
     open(str, skip, punct);
 }
@@ -35,6 +35,7 @@ struct csv_dict_stream_reader
 public:
     // MEMBER TYPES
     // ------------
+    using allocator_type = csv_stream_reader::allocator_type;
     using value_type = csv_map;
     using pointer = value_type*;
     using const_pointer = const value_type*;
@@ -44,19 +45,20 @@ public:
 
     // MEMBER FUNCTIONS
     // ----------------
-    csv_dict_stream_reader(csvpunct_impl* = nullptr);
+    csv_dict_stream_reader(csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     csv_dict_stream_reader(const csv_dict_stream_reader&) = delete;
     csv_dict_stream_reader& operator=(const csv_dict_stream_reader&) = delete;
     csv_dict_stream_reader(csv_dict_stream_reader&&);
     csv_dict_stream_reader& operator=(csv_dict_stream_reader&&);
 
     // STREAM
-    csv_dict_stream_reader(istream&, size_t skip = 0, csvpunct_impl* = nullptr);
+    csv_dict_stream_reader(istream&, size_t skip = 0, csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     void open(istream&, size_t skip = 0, csvpunct_impl* = nullptr);
 
     // PROPERTIES/MODIFIERS
     void punctuation(csvpunct_impl*);
     const csvpunct_impl* punctuation() const;
+    allocator_type get_allocator() const;
     void swap(csv_dict_stream_reader&);
 
     // DATA
@@ -80,19 +82,19 @@ protected:
 struct csv_dict_file_reader: csv_dict_stream_reader
 {
 public:
-    csv_dict_file_reader(csvpunct_impl* = nullptr);
+    csv_dict_file_reader(csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     csv_dict_file_reader(const csv_dict_file_reader&) = delete;
     csv_dict_file_reader& operator=(const csv_dict_file_reader&) = delete;
     csv_dict_file_reader(csv_dict_file_reader&&);
     csv_dict_file_reader& operator=(csv_dict_file_reader&&);
 
     // STREAM
-    csv_dict_file_reader(const string_view& name, size_t skip = 0, csvpunct_impl* = nullptr);
+    csv_dict_file_reader(const string_view& name, size_t skip = 0, csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     void open(const string_view& name, size_t skip = 0, csvpunct_impl* = nullptr);
 #if defined(HAVE_WFOPEN)                        // WINDOWS
-    csv_dict_file_reader(const wstring_view& name, size_t skip = 0, csvpunct_impl* = nullptr);
+    csv_dict_file_reader(const wstring_view& name, size_t skip = 0, csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     void open(const wstring_view& name, size_t skip = 0, csvpunct_impl* = nullptr);
-    csv_dict_file_reader(const u16string_view& name, size_t skip = 0, csvpunct_impl* = nullptr);
+    csv_dict_file_reader(const u16string_view& name, size_t skip = 0, csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     void open(const u16string_view& name, size_t skip = 0, csvpunct_impl* = nullptr);
 #endif                                          // WINDOWS
 
@@ -110,14 +112,14 @@ private:
 struct csv_dict_string_reader: csv_dict_stream_reader
 {
 public:
-    csv_dict_string_reader(csvpunct_impl* = nullptr);
+    csv_dict_string_reader(csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     csv_dict_string_reader(const csv_dict_string_reader&) = delete;
     csv_dict_string_reader& operator=(const csv_dict_string_reader&) = delete;
     csv_dict_string_reader(csv_dict_string_reader&&);
     csv_dict_string_reader& operator=(csv_dict_string_reader&&);
 
     // STREAM
-    csv_dict_string_reader(const string_wrapper& str, size_t skip = 0, csvpunct_impl* = nullptr);
+    csv_dict_string_reader(const string_wrapper& str, size_t skip = 0, csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     void open(const string_wrapper& str, size_t skip = 0, csvpunct_impl* = nullptr);
 
     // MODIFIERS
@@ -18,9 +18,9 @@ static string readline(istream& stream)
 }
 
 
-static csv_row parse_csv_row(istream& stream, csvpunct_impl& punct, size_t size)
+static csv_row parse_csv_row(istream& stream, csvpunct_impl& punct, size_t size, const byte_allocator& allocator)
 {
-    csv_row row;
+    csv_row row(allocator);
     string line = readline(stream);
     row.reserve(size);
 
@@ -43,7 +43,7 @@ static csv_row parse_csv_row(istream& stream, csvpunct_impl& punct, size_t size)
             word[j] = c;            // append quoted character to word
             j++;
         } else if (c == punct.delimiter()) {
-            row.emplace_back(string(word.data(), j));
+            row.emplace_back(word.data(), j, allocator);
             j = 0;
             k++;
         } else {
@@ -52,7 +52,7 @@ static csv_row parse_csv_row(istream& stream, csvpunct_impl& punct, size_t size)
         }
     }
 
-    row.emplace_back(string(word.data(), j));
+    row.emplace_back(word.data(), j, allocator);
 
     return row;
 }
@@ -60,12 +60,14 @@ static csv_row parse_csv_row(istream& stream, csvpunct_impl& punct, size_t size)
 // OBJECTS
 // -------
 
-csv_stream_reader::csv_stream_reader(csvpunct_impl* punct):
-    punct_(punct ? punct : new csvpunct)
+csv_stream_reader::csv_stream_reader(csvpunct_impl* punct, const allocator_type& allocator):
+    punct_(punct ? punct : new csvpunct),
+    allocator_(allocator)
 {}
 
 
-csv_stream_reader::csv_stream_reader(csv_stream_reader&& rhs)
+csv_stream_reader::csv_stream_reader(csv_stream_reader&& rhs):
+    allocator_(rhs.allocator_)
 {
     swap(rhs);
 }
@@ -78,8 +80,9 @@ csv_stream_reader& csv_stream_reader::operator=(csv_stream_reader&& rhs)
 }
 
 
-csv_stream_reader::csv_stream_reader(istream& stream, size_t skip, csvpunct_impl* punct):
-    punct_(punct ? punct : new csvpunct)
+csv_stream_reader::csv_stream_reader(istream& stream, size_t skip, csvpunct_impl* punct, const allocator_type& allocator):
+    punct_(punct ? punct : new csvpunct),
+    allocator_(allocator)
 {
     open(stream, skip, nullptr);
 }
@@ -111,8 +114,15 @@ const csvpunct_impl* csv_stream_reader::punctuation() const
 }
 
 
+auto csv_stream_reader::get_allocator() const -> allocator_type
+{
+    return allocator_;
+}
+
+
 void csv_stream_reader::swap(csv_stream_reader& rhs)
 {
+    // allocators are not propagated
     using PYCPP_NAMESPACE::swap;
     swap(stream_, rhs.stream_);
     swap(row_length_, rhs.row_length_);
@@ -124,8 +134,7 @@ auto csv_stream_reader::operator()() -> value_type
 {
     assert(stream_ && "Stream cannot be null.");
 
-    value_type row;
-    row = parse_csv_row(*stream_, *punct_, row_length_);
+    value_type row = parse_csv_row(*stream_, *punct_, row_length_, allocator_);
     row_length_ = row.size();
     return row;
 }
@@ -156,13 +165,13 @@ auto csv_stream_reader::end() -> iterator
 }
 
 
-csv_file_reader::csv_file_reader(csvpunct_impl* punct):
-    csv_stream_reader(punct)
+csv_file_reader::csv_file_reader(csvpunct_impl* punct, const allocator_type& allocator):
+    csv_stream_reader(punct, allocator)
 {}
 
 
 csv_file_reader::csv_file_reader(csv_file_reader&& rhs):
-    csv_file_reader()
+    csv_file_reader(nullptr, rhs.get_allocator())
 {
     swap(rhs);
 }
@@ -175,7 +184,8 @@ csv_file_reader& csv_file_reader::operator=(csv_file_reader&& rhs)
 }
 
 
-csv_file_reader::csv_file_reader(const string_view& name, size_t skip, csvpunct_impl* punct)
+csv_file_reader::csv_file_reader(const string_view& name, size_t skip, csvpunct_impl* punct, const allocator_type& allocator):
+    csv_stream_reader(nullptr, allocator)
 {
     open(name, skip, punct);
 }
@@ -191,7 +201,8 @@ void csv_file_reader::open(const string_view& name, size_t skip, csvpunct_impl*
 #if defined(HAVE_WFOPEN)                        // WINDOWS
 
 
-csv_file_reader::csv_file_reader(const wstring_view& name, size_t skip, csvpunct_impl* punct)
+csv_file_reader::csv_file_reader(const wstring_view& name, size_t skip, csvpunct_impl* punct, const allocator_type& allocator):
+    csv_stream_reader(nullptr, allocator)
 {
     open(name, skip, punct);
 }
@@ -204,7 +215,8 @@ void csv_file_reader::open(const wstring_view& name, size_t skip, csvpunct_impl*
 }
 
 
-csv_file_reader::csv_file_reader(const u16string_view& name, size_t skip, csvpunct_impl* punct)
+csv_file_reader::csv_file_reader(const u16string_view& name, size_t skip, csvpunct_impl* punct, const allocator_type& allocator):
+    csv_stream_reader(nullptr, allocator)
 {
     open(name, skip, punct);
 }
@@ -239,13 +251,13 @@ void csv_file_reader::swap(csv_file_reader& rhs)
 }
 
 
-csv_string_reader::csv_string_reader(csvpunct_impl* punct):
-    csv_stream_reader(punct)
+csv_string_reader::csv_string_reader(csvpunct_impl* punct, const allocator_type& allocator):
+    csv_stream_reader(punct, allocator)
 {}
 
 
 csv_string_reader::csv_string_reader(csv_string_reader&& rhs):
-    csv_string_reader()
+    csv_string_reader(nullptr, rhs.get_allocator())
 {
     swap(rhs);
 }
@@ -258,7 +270,8 @@ csv_string_reader& csv_string_reader::operator=(csv_string_reader&& rhs)
 }
 
 
-csv_string_reader::csv_string_reader(const string_wrapper& str, size_t skip, csvpunct_impl* punct)
+csv_string_reader::csv_string_reader(const string_wrapper& str, size_t skip, csvpunct_impl* punct, const allocator_type& allocator):
+    csv_stream_reader(nullptr, allocator)
 {
     open(str, skip, punct);
 }
@@ -26,12 +26,16 @@ PYCPP_BEGIN_NAMESPACE
  *
  *  The punctation can be altered similar to an STL locale using `punctuation()`,
  *  the CSV reader takes ownership of the punct object.
+ *
+ *  Rows are allocated from the reader's allocator, so every row in
+ *  a document may be read into an arena and released at once.
  */
 struct csv_stream_reader
 {
 public:
     // MEMBER TYPES
     // ------------
+    using allocator_type = byte_allocator;
     using value_type = csv_row;
     using pointer = value_type*;
     using const_pointer = const value_type*;
@@ -41,19 +45,20 @@ public:
 
     // MEMBER FUNCTIONS
     // ----------------
-    csv_stream_reader(csvpunct_impl* = nullptr);
+    csv_stream_reader(csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     csv_stream_reader(const csv_stream_reader&) = delete;
     csv_stream_reader& operator=(const csv_stream_reader&) = delete;
     csv_stream_reader(csv_stream_reader&&);
     csv_stream_reader& operator=(csv_stream_reader&&);
 
     // STREAM
-    csv_stream_reader(istream&, size_t skip = 0, csvpunct_impl* = nullptr);
+    csv_stream_reader(istream&, size_t skip = 0, csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     void open(istream&, size_t skip = 0, csvpunct_impl* = nullptr);
 
     // PROPERTIES/MODIFIERS
     void punctuation(csvpunct_impl*);
     const csvpunct_impl* punctuation() const;
+    allocator_type get_allocator() const;
     void swap(csv_stream_reader&);
 
     // DATA
@@ -71,6 +76,7 @@ protected:
     istream* stream_ = nullptr;
     size_t row_length_ = 0;
     unique_ptr<csvpunct_impl> punct_;
+    allocator_type allocator_;
 };
 
 
@@ -80,19 +86,19 @@ protected:
 struct csv_file_reader: csv_stream_reader
 {
 public:
-    csv_file_reader(csvpunct_impl* = nullptr);
+    csv_file_reader(csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     csv_file_reader(const csv_file_reader&) = delete;
     csv_file_reader& operator=(const csv_file_reader&) = delete;
     csv_file_reader(csv_file_reader&&);
     csv_file_reader& operator=(csv_file_reader&&);
 
     // STREAM
-    csv_file_reader(const string_view& name, size_t skip = 0, csvpunct_impl* = nullptr);
+    csv_file_reader(const string_view& name, size_t skip = 0, csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     void open(const string_view& name, size_t skip = 0, csvpunct_impl* = nullptr);
 #if defined(HAVE_WFOPEN)                        // WINDOWS
-    csv_file_reader(const wstring_view& name, size_t skip = 0, csvpunct_impl* = nullptr);
+    csv_file_reader(const wstring_view& name, size_t skip = 0, csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     void open(const wstring_view& name, size_t skip = 0, csvpunct_impl* = nullptr);
-    csv_file_reader(const u16string_view& name, size_t skip = 0, csvpunct_impl* = nullptr);
+    csv_file_reader(const u16string_view& name, size_t skip = 0, csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     void open(const u16string_view& name, size_t skip = 0, csvpunct_impl* = nullptr);
 #endif                                          // WINDOWS
 
@@ -110,14 +116,14 @@ private:
 struct csv_string_reader: csv_stream_reader
 {
 public:
-    csv_string_reader(csvpunct_impl* = nullptr);
+    csv_string_reader(csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     csv_string_reader(const csv_string_reader&) = delete;
     csv_string_reader& operator=(const csv_string_reader&) = delete;
     csv_string_reader(csv_string_reader&&);
     csv_string_reader& operator=(csv_string_reader&&);
 
     // STREAM
-    csv_string_reader(const string_wrapper& str, size_t skip = 0, csvpunct_impl* = nullptr);
+    csv_string_reader(const string_wrapper& str, size_t skip = 0, csvpunct_impl* = nullptr, const allocator_type& = allocator_type());
     void open(const string_wrapper& str, size_t skip = 0, csvpunct_impl* = nullptr);
 
     // MODIFIERS
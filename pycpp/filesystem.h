@@ -28,6 +28,7 @@
 #include <pycpp/filesystem/path.h>
 #include <pycpp/filesystem/stat.h>
 #include <pycpp/filesystem/tmp.h>
+#include <pycpp/filesystem/walk.h>
 #include <pycpp/iterator/range.h>
 #include <pycpp/stl/initializer_list.h>
 #include <pycpp/stl/ios.h>
@@ -356,6 +357,14 @@ bool copy_file(const path_view_t& src, const path_view_t& dst, bool replace = fa
  */
 bool copy_dir(const path_view_t& src, const path_view_t& dst, bool recursive = true, bool replace = false);
 
+/**
+ *  \brief Copy directory recursively, copying many files concurrently.
+ *
+ *  \param replace          Replace dst if it exists.
+ *  \param threads          Worker threads, 0 for the hardware concurrency.
+ */
+bool copy_dir_parallel(const path_view_t& src, const path_view_t& dst, bool replace = false, size_t threads = 0);
+
 /**
  *  \brief Copy generic path, and return if copy was successful.
  */
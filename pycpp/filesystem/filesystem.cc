@@ -2,10 +2,19 @@
 //  :license: MIT, see licenses/mit.md for more details.
 
 #include <pycpp/filesystem.h>
+#include <pycpp/filesystem/exception.h>
+#include <pycpp/stl/atomic.h>
 #include <pycpp/stl/utility.h>
 
 PYCPP_BEGIN_NAMESPACE
 
+// DECLARATIONS
+// ------------
+
+#if !defined(OS_WINDOWS)
+bool copy_file_contents(const path_view_t& src, const path_view_t& dst);
+#endif
+
 // HELPERS
 // -------
 
@@ -48,6 +57,32 @@ static bool copy_path_impl(const Path& src, const Path& dst, bool recursive, boo
 }
 
 
+/**
+ *  \brief Map a path below `src` to the same path below `dst`.
+ */
+static path_t rebase_path(const path_t& path, const path_t& src, const path_t& dst)
+{
+    size_t start = path.find_first_not_of(path_separators, src.size());
+    if (start == path_t::npos) {
+        return dst;
+    }
+    return join_path({dst, path_view_t(path).substr(start)});
+}
+
+
+/**
+ *  \brief Copy a new file, skipping the checks in `copy_file`.
+ */
+static bool copy_new_file(const path_t& src, const path_t& dst)
+{
+#if defined(OS_WINDOWS)
+    return copy_file(src, dst);
+#else
+    return copy_file_contents(src, dst);
+#endif
+}
+
+
 template <typename Path>
 static bool remove_path_impl(const Path& path, bool recursive)
 {
@@ -116,6 +151,55 @@ bool copy_path(const path_view_t& src, const path_view_t& dst, bool recursive, b
 }
 
 
+bool copy_dir_parallel(const path_view_t& src, const path_view_t& dst, bool replace, size_t threads)
+{
+    if (replace && exists(dst)) {
+        if (!remove_path(dst)) {
+            throw filesystem_error(filesystem_destination_exists);
+        }
+    }
+    if (!copy_dir(src, dst, false)) {
+        return false;
+    }
+
+    path_t root(src);
+    path_t target(dst);
+    atomic<bool> success(true);
+
+    // create each subdirectory before it is queued, so it exists
+    // before any worker copies into it
+    auto mkdirs = [&](const walk_batch& batch, const walk_entry& entry) {
+        path_t path = batch.path(entry);
+        if (!copy_dir(path, rebase_path(path, root, target), false)) {
+            success = false;
+            return true;
+        }
+        return false;
+    };
+
+    auto copy = [&](walk_batch& batch) {
+        path_t dirname = rebase_path(batch.dirname, root, target);
+        for (const walk_entry& entry: batch.entries) {
+            bool copied = true;
+            if (entry.type == walk_file) {
+                copied = copy_new_file(batch.path(entry), join_path({dirname, entry.basename}));
+            } else if (entry.type == walk_symlink) {
+                copied = copy_link(batch.path(entry), join_path({dirname, entry.basename}));
+            }
+            if (!copied) {
+                success = false;
+            }
+        }
+    };
+
+    walk_options options;
+    options.threads = threads;
+    walk(root, copy, mkdirs, options);
+
+    return success;
+}
+
+
 bool remove_path(const path_view_t& path, bool recursive)
 {
     return remove_path_impl(path, recursive);
@@ -12,6 +12,8 @@
 #   include <pycpp/windows/winapi.h>
 #else
 #   include <dirent.h>
+#   include <fcntl.h>
+#   include <unistd.h>
 #endif
 
 PYCPP_BEGIN_NAMESPACE
@@ -431,7 +433,9 @@ struct directory_data_impl
     path_t basename() const;
     virtual const path_t& dirname() const = 0;
     const stat_t& stat();
+    bool is_directory();
     void open(DIR*& dir, const path_view_t& path);
+    void open_child(DIR* parent, DIR*& dir);
 
     void increment(DIR*& dir);
     bool operator==(const directory_data_impl&) const;
@@ -462,6 +466,45 @@ void directory_data_impl::open(DIR*& dir, const path_view_t& path)
 }
 
 
+/**
+ *  \brief Open the current entry relative to its parent directory.
+ */
+void directory_data_impl::open_child(DIR* parent, DIR*& dir)
+{
+    int flags = O_RDONLY | O_DIRECTORY;
+#if defined(O_CLOEXEC)
+    flags |= O_CLOEXEC;
+#endif
+
+    int fd = openat(dirfd(parent), entry->d_name, flags);
+    if (fd == -1) {
+        handle_error(errno);
+    }
+    dir = fdopendir(fd);
+    if (dir == nullptr) {
+        int code = errno;
+        close(fd);
+        handle_error(code);
+    }
+}
+
+
+/**
+ *  \brief Check if the entry is a directory, without following symlinks.
+ *
+ *  Uses `d_type` when the filesystem provides it, avoiding an `lstat`.
+ */
+bool directory_data_impl::is_directory()
+{
+#if defined(_DIRENT_HAVE_D_TYPE) || defined(DT_UNKNOWN)
+    if (entry->d_type != DT_UNKNOWN) {
+        return entry->d_type == DT_DIR;
+    }
+#endif
+    return isdir(stat());
+}
+
+
 void directory_data_impl::increment(DIR*& dir)
 {
     errno = 0;
@@ -580,10 +623,11 @@ void recursive_directory_data::open(const path_view_t& p)
 recursive_directory_data& recursive_directory_data::operator++()
 {
     // directory start, add  a level
-    if (entry && isdir(stat())) {
+    if (entry && is_directory()) {
+        DIR* parent = dir_list.back();
         path_list.emplace_back(fullpath());
         dir_list.emplace_back(nullptr);
-        directory_data_impl::open(dir_list.back(), path_list.back());
+        open_child(parent, dir_list.back());
     }
 
     // increment until we don't lose a parent directory
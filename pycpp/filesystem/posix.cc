@@ -20,6 +20,14 @@
 #   include <wordexp.h>
 #   include <assert.h>
 #   include <stdlib.h>
+#   include <sys/stat.h>
+#   if defined(OS_LINUX)
+#       include <linux/fs.h>
+#       include <sys/ioctl.h>
+#       include <sys/sendfile.h>
+#   elif defined(OS_MACOS)
+#       include <copyfile.h>
+#   endif
 #endif
 
 PYCPP_BEGIN_NAMESPACE
@@ -199,50 +207,248 @@ bool isabs_impl(const Path& path)
 
 
 /**
- *  \brief Use C FILE descriptors for high performance file copying.
+ *  \brief Result of a copy strategy.
+ *
+ *  Strategies use and advance the file offsets, so when a strategy
+ *  is unsupported, the next one resumes where it stopped.
  */
-static bool copy_file_buffer(const path_view_t& src, const path_view_t& dst)
+enum copy_status
+{
+    copy_complete,
+    copy_unsupported,
+    copy_failed,
+};
+
+
+/**
+ *  \brief Write the entire buffer, retrying short writes.
+ */
+static bool write_all(int fd, const char* buf, size_t length)
+{
+    while (length) {
+        ssize_t bytes = ::write(fd, buf, length);
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        buf += bytes;
+        length -= static_cast<size_t>(bytes);
+    }
+    return true;
+}
+
+
+/**
+ *  \brief Copy through a large, page-aligned user-space buffer.
+ */
+static copy_status copy_fd_buffer(int in, int out)
+{
+    static constexpr size_t alignment = 4096;
+    static constexpr size_t length = 1 << 20;
+
+    void* buf;
+    if (posix_memalign(&buf, alignment, length) != 0) {
+        return copy_failed;
+    }
+
+    copy_status status = copy_complete;
+    while (true) {
+        ssize_t bytes = ::read(in, buf, length);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        } else if (bytes < 0) {
+            status = copy_failed;
+            break;
+        } else if (bytes == 0) {
+            break;
+        } else if (!write_all(out, reinterpret_cast<char*>(buf), static_cast<size_t>(bytes))) {
+            status = copy_failed;
+            break;
+        }
+    }
+
+    free(buf);
+    return status;
+}
+
+
+#if defined(OS_LINUX) && defined(FICLONE)
+
+/**
+ *  \brief Share the extents of `in` with `out` (btrfs, XFS).
+ */
+static copy_status copy_fd_clone(int in, int out)
+{
+    if (ioctl(out, FICLONE, in) == 0) {
+        return copy_complete;
+    }
+    return copy_unsupported;
+}
+
+#else
+
+static copy_status copy_fd_clone(int, int)
+{
+    return copy_unsupported;
+}
+
+#endif
+
+
+#if defined(HAVE_COPY_FILE_RANGE)
+
+/**
+ *  \brief Copy within the kernel, using server-side copies or reflinks where available.
+ */
+static copy_status copy_fd_range(int in, int out, off_t size)
+{
+    off_t copied = 0;
+    while (true) {
+        ssize_t bytes = copy_file_range(in, nullptr, out, nullptr, 1 << 30, 0);
+        if (bytes > 0) {
+            copied += bytes;
+            continue;
+        } else if (bytes == 0) {
+            // files in procfs and sysfs report a size of 0, but
+            // copy_file_range reads nothing from them
+            return copied || !size ? copy_complete : copy_unsupported;
+        } else if (errno == EINTR) {
+            continue;
+        }
+
+        switch (errno) {
+            case EXDEV:
+            case EINVAL:
+            case ENOSYS:
+            case EOPNOTSUPP:
+            case EBADF:
+                return copy_unsupported;
+            default:
+                return copy_failed;
+        }
+    }
+}
+
+#else
+
+static copy_status copy_fd_range(int, int, off_t)
+{
+    return copy_unsupported;
+}
+
+#endif
+
+
+#if defined(OS_LINUX)
+
+/**
+ *  \brief Copy within the kernel through the page cache.
+ */
+static copy_status copy_fd_sendfile(int in, int out)
+{
+    while (true) {
+        ssize_t bytes = sendfile(out, in, nullptr, 1 << 30);
+        if (bytes > 0) {
+            continue;
+        } else if (bytes == 0) {
+            return copy_complete;
+        } else if (errno == EINTR) {
+            continue;
+        }
+
+        switch (errno) {
+            case EINVAL:
+            case ENOSYS:
+                return copy_unsupported;
+            default:
+                return copy_failed;
+        }
+    }
+}
+
+#else
+
+static copy_status copy_fd_sendfile(int, int)
+{
+    return copy_unsupported;
+}
+
+#endif
+
+
+/**
+ *  \brief Copy the contents of a file to a new file, and return if copy was successful.
+ *
+ *  Tries, in order, a reflink, `copy_file_range`, `sendfile`, and
+ *  finally a user-space copy, so the data is only copied through
+ *  user-space when the kernel cannot copy it. The destination is
+ *  created with the permissions of the source, and removed on
+ *  failure.
+ */
+bool copy_file_contents(const path_view_t& src, const path_view_t& dst)
 {
     assert(is_null_terminated(src));
     assert(is_null_terminated(dst));
 
-    // choose a value between 4096 and 8 * 4096 (4-32KB).
-    static constexpr size_t length = 2 * 4096;
-
-    fd_t in = ::open(src.data(), O_RDONLY);
+    int in = ::open(src.data(), O_RDONLY | O_CLOEXEC);
     if (in < 0) {
         return false;
     }
-    fd_t out = ::open(dst.data(), O_WRONLY);
+    struct stat sb;
+    if (fstat(in, &sb) != 0) {
+        ::close(in);
+        return false;
+    }
+    int out = ::open(dst.data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, sb.st_mode & 0777);
     if (out < 0) {
         ::close(in);
         return false;
     }
 
-    char* buf = new char[length];
-    int bytes = 0;
-    while ((bytes = ::read(in, buf, length)) == length) {
-        ::write(out, buf, length);
+#if defined(OS_MACOS)
+    // clones on APFS, otherwise copies within the kernel
+    copy_status status = fcopyfile(in, out, nullptr, COPYFILE_DATA) == 0 ? copy_complete : copy_unsupported;
+#else
+    copy_status status = copy_fd_clone(in, out);
+    if (status == copy_unsupported) {
+        status = copy_fd_range(in, out, sb.st_size);
+    }
+    if (status == copy_unsupported) {
+        status = copy_fd_sendfile(in, out);
+    }
+#endif
+    if (status == copy_unsupported) {
+        status = copy_fd_buffer(in, out);
     }
-    ::write(out, buf, bytes);
 
-    delete[] buf;
-    ::close(out);
+    bool success = status == copy_complete;
+    success &= ::close(out) == 0;
     ::close(in);
+    if (!success) {
+        ::unlink(dst.data());
+    }
 
-    return true;
+    return success;
 }
 
 
 template <typename Path, typename MoveFile>
 static bool move_file_impl(const Path& src, const Path& dst, bool replace, MoveFile move)
 {
-    auto dst_dir = dir_name(dst);
+    // the parent is a view into `dst`, and stat needs a null-terminated path
+    using char_type = typename Path::value_type;
+    using string_type = basic_string<char_type, typename Path::traits_type>;
+    string_type dst_dir(dir_name(dst));
+    if (dst_dir.empty()) {
+        dst_dir = string_type(current_directory);
+    }
 
     // ensure we have a file and a dest directory
     auto src_stat = stat(src);
     auto dst_stat = stat(dst_dir);
-    if (!isfile(src)) {
+    if (!isfile(src_stat)) {
         throw filesystem_error(filesystem_not_a_file);
     } else if (!exists(dst_stat)) {
         throw filesystem_error(filesystem_no_such_directory);
@@ -330,12 +536,18 @@ static bool mklink_impl(const Path& target, const Path& dst, bool replace, Mklin
 template <typename Path, typename CopyFile>
 static bool copy_file_impl(const Path& src, const Path& dst, bool replace, CopyFile copy)
 {
-    auto dst_dir = dir_name(dst);
+    // the parent is a view into `dst`, and stat needs a null-terminated path
+    using char_type = typename Path::value_type;
+    using string_type = basic_string<char_type, typename Path::traits_type>;
+    string_type dst_dir(dir_name(dst));
+    if (dst_dir.empty()) {
+        dst_dir = string_type(current_directory);
+    }
 
     // ensure we have a file and a dest directory
     auto src_stat = stat(src);
     auto dst_stat = stat(dst_dir);
-    if (!isfile(src)) {
+    if (!isfile(src_stat)) {
         throw filesystem_error(filesystem_not_a_file);
     } else if (!exists(dst_stat)) {
         throw filesystem_error(filesystem_no_such_directory);
@@ -759,7 +971,7 @@ bool copy_file(const path_view_t& src, const path_view_t& dst, bool replace)
     assert(is_null_terminated(dst));
 
     return copy_file_impl(src, dst, replace, [](const path_view_t& src, const path_view_t& dst) {
-        return copy_file_buffer(src, dst);
+        return copy_file_contents(src, dst);
     });
 }
 
@@ -463,7 +463,7 @@ static bool set_stat_impl(const Path& src, const Path& dst)
 }
 
 
-static void copy_native(const struct stat& src, stat_t& dst)
+void copy_native(const struct stat& src, stat_t& dst)
 {
     dst.st_dev = src.st_dev;
     dst.st_ino = src.st_ino;
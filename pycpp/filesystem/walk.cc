@@ -0,0 +1,486 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/filesystem.h>
+#include <pycpp/filesystem/exception.h>
+#include <pycpp/filesystem/walk.h>
+#include <pycpp/preprocessor/errno.h>
+#include <pycpp/stl/algorithm.h>
+#include <pycpp/stl/atomic.h>
+#include <pycpp/stl/deque.h>
+#include <pycpp/stl/exception.h>
+#include <pycpp/stl/mutex.h>
+#include <pycpp/stl/thread.h>
+#include <condition_variable>
+#include <string.h>
+#if !defined(OS_WINDOWS)
+#   include <dirent.h>
+#   include <fcntl.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+PYCPP_BEGIN_NAMESPACE
+
+// DECLARATIONS
+// ------------
+
+#if !defined(OS_WINDOWS)
+void copy_native(const struct stat& src, stat_t& dst);
+#endif
+
+// HELPERS
+// -------
+
+
+static void handle_error(int code)
+{
+    switch (code) {
+        case 0:
+            return;
+        case EACCES:
+            throw filesystem_error(filesystem_permissions_error);
+        case EMFILE:
+        case ENFILE:
+            throw filesystem_error(filesystem_too_many_file_descriptors);
+        case ENOENT:
+        case ENOTDIR:
+            throw filesystem_error(filesystem_no_such_directory);
+        case ENOMEM:
+            throw filesystem_error(filesystem_out_of_memory);
+        default:
+            throw filesystem_error(filesystem_unexpected_error);
+    }
+}
+
+
+/**
+ *  \brief Errors skipped with `walk_options::ignore_errors`.
+ *
+ *  Directories may be unreadable, or removed or replaced while
+ *  the walk is in progress.
+ */
+static bool is_ignorable_error(int code)
+{
+    return code == EACCES || code == EPERM || code == ENOENT || code == ENOTDIR || code == ELOOP;
+}
+
+
+#if !defined(OS_WINDOWS)            // POSIX
+
+
+/**
+ *  \brief Throw for an error reading an entry of a directory.
+ *
+ *  Entries other than directories that no longer exist are
+ *  reported as missing files.
+ */
+static void handle_entry_error(int code, walk_type type)
+{
+    if (code == ENOENT && type != walk_directory) {
+        throw filesystem_error(filesystem_file_not_found);
+    }
+    handle_error(code);
+}
+
+
+static bool is_relative_dot(const char* name)
+{
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+
+static walk_type mode_to_type(mode_t mode)
+{
+    if (S_ISREG(mode)) {
+        return walk_file;
+    } else if (S_ISDIR(mode)) {
+        return walk_directory;
+    } else if (S_ISLNK(mode)) {
+        return walk_symlink;
+    }
+    return walk_other;
+}
+
+
+static walk_type dirent_to_type(const dirent* entry)
+{
+#if defined(_DIRENT_HAVE_D_TYPE) || defined(DT_UNKNOWN)
+    switch (entry->d_type) {
+        case DT_UNKNOWN:
+            return walk_unknown;
+        case DT_REG:
+            return walk_file;
+        case DT_DIR:
+            return walk_directory;
+        case DT_LNK:
+            return walk_symlink;
+        default:
+            return walk_other;
+    }
+#else
+    return walk_unknown;
+#endif
+}
+
+
+/**
+ *  \brief Open a directory without following a symlink.
+ *
+ *  Returns nullptr and sets `errno` on failure.
+ */
+static DIR* open_directory(const path_t& path, bool root)
+{
+    int flags = O_RDONLY | O_DIRECTORY;
+#if defined(O_CLOEXEC)
+    flags |= O_CLOEXEC;
+#endif
+#if defined(O_NOFOLLOW)
+    // the entry was a directory when read, do not follow it if it
+    // has since been replaced by a symlink
+    if (!root) {
+        flags |= O_NOFOLLOW;
+    }
+#endif
+
+    int fd = ::open(path.data(), flags);
+    if (fd == -1) {
+        return nullptr;
+    }
+    DIR* dir = fdopendir(fd);
+    if (dir == nullptr) {
+        int code = errno;
+        ::close(fd);
+        errno = code;
+    }
+    return dir;
+}
+
+#endif                              // POSIX
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Directory queued for reading.
+ */
+struct walk_task
+{
+    path_t path;
+    size_t depth;
+};
+
+
+/**
+ *  \brief Tasks owned by a single worker.
+ *
+ *  The owner pushes and pops at the back, so each worker walks its
+ *  subtree depth-first, while thieves take the oldest directories,
+ *  nearest the root, from the front.
+ */
+struct walk_queue
+{
+    mutex lock;
+    deque<walk_task> tasks;
+};
+
+
+/**
+ *  \brief State shared by all workers.
+ */
+struct walk_state
+{
+    walk_callback callback;
+    walk_prune prune;
+    walk_options options;
+    deque<walk_queue> queues;
+
+    // directories queued or being read, the walk is done at 0
+    atomic<size_t> pending;
+    atomic<size_t> queued;
+    atomic<size_t> sleeping;
+    atomic<bool> stop;
+    mutex idle_lock;
+    std::condition_variable idle;
+    mutex error_lock;
+    exception_ptr error;
+
+    walk_state(walk_callback&& callback, walk_prune&& prune, const walk_options& options, size_t threads);
+    void push(size_t worker, walk_task&& task);
+    bool pop(size_t worker, walk_task& task);
+    void done();
+    void fail(exception_ptr ptr);
+    void run(size_t worker);
+    void read(size_t worker, walk_task& task, walk_batch& batch);
+};
+
+
+walk_state::walk_state(walk_callback&& callback, walk_prune&& prune, const walk_options& options, size_t threads):
+    callback(move(callback)),
+    prune(move(prune)),
+    options(options),
+    queues(threads),
+    pending(0),
+    queued(0),
+    sleeping(0),
+    stop(false)
+{}
+
+
+void walk_state::push(size_t worker, walk_task&& task)
+{
+    ++pending;
+    {
+        lock_guard<mutex> lock(queues[worker].lock);
+        queues[worker].tasks.emplace_back(move(task));
+    }
+    ++queued;
+
+    if (sleeping.load()) {
+        lock_guard<mutex> lock(idle_lock);
+        idle.notify_one();
+    }
+}
+
+
+bool walk_state::pop(size_t worker, walk_task& task)
+{
+    // own queue first, newest task
+    {
+        walk_queue& queue = queues[worker];
+        lock_guard<mutex> lock(queue.lock);
+        if (!queue.tasks.empty()) {
+            task = move(queue.tasks.back());
+            queue.tasks.pop_back();
+            --queued;
+            return true;
+        }
+    }
+
+    // steal the oldest task from another worker
+    for (size_t i = 1; i < queues.size(); ++i) {
+        walk_queue& queue = queues[(worker + i) % queues.size()];
+        lock_guard<mutex> lock(queue.lock);
+        if (!queue.tasks.empty()) {
+            task = move(queue.tasks.front());
+            queue.tasks.pop_front();
+            --queued;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void walk_state::done()
+{
+    if (--pending == 0) {
+        lock_guard<mutex> lock(idle_lock);
+        idle.notify_all();
+    }
+}
+
+
+void walk_state::fail(exception_ptr ptr)
+{
+    {
+        lock_guard<mutex> lock(error_lock);
+        if (!error) {
+            error = ptr;
+        }
+    }
+    stop = true;
+    lock_guard<mutex> lock(idle_lock);
+    idle.notify_all();
+}
+
+
+void walk_state::run(size_t worker)
+{
+    // reuse the batch, to keep the capacity of its entries
+    walk_task task;
+    walk_batch batch;
+    while (!stop) {
+        if (pop(worker, task)) {
+            try {
+                read(worker, task, batch);
+            } catch (...) {
+                fail(current_exception());
+            }
+            done();
+            continue;
+        }
+
+        // sleep until work is queued or the walk is done
+        unique_lock<mutex> lock(idle_lock);
+        ++sleeping;
+        idle.wait(lock, [this]() {
+            return stop || queued.load() || !pending.load();
+        });
+        --sleeping;
+        if (!pending.load()) {
+            break;
+        }
+    }
+}
+
+
+#if defined(OS_WINDOWS)             // WINDOWS
+
+
+void walk_state::read(size_t worker, walk_task& task, walk_batch& batch)
+{
+    batch.dirname = move(task.path);
+    batch.depth = task.depth;
+    batch.entries.clear();
+
+    directory_iterator first, last;
+    try {
+        first = directory_iterator(batch.dirname);
+    } catch (filesystem_error&) {
+        if (options.ignore_errors && task.depth) {
+            return;
+        }
+        throw;
+    }
+
+    for (; first != last && !stop; ++first) {
+        walk_entry entry;
+        entry.basename = first->basename();
+        if (first->islink()) {
+            entry.type = walk_symlink;
+        } else if (first->isdir()) {
+            entry.type = walk_directory;
+        } else if (first->isfile()) {
+            entry.type = walk_file;
+        } else {
+            entry.type = walk_other;
+        }
+        if (options.stat) {
+            entry.stat = first->stat();
+        }
+
+        if (entry.type == walk_directory && !(prune && prune(batch, entry))) {
+            push(worker, {batch.path(entry), batch.depth + 1});
+        }
+        batch.entries.emplace_back(move(entry));
+        if (batch.entries.size() >= options.batch_size) {
+            callback(batch);
+            batch.entries.clear();
+        }
+    }
+
+    if (!batch.entries.empty()) {
+        callback(batch);
+    }
+}
+
+
+#else                               // POSIX
+
+
+void walk_state::read(size_t worker, walk_task& task, walk_batch& batch)
+{
+    batch.dirname = move(task.path);
+    batch.depth = task.depth;
+    batch.entries.clear();
+
+    DIR* dir = open_directory(batch.dirname, task.depth == 0);
+    if (dir == nullptr) {
+        if (options.ignore_errors && task.depth && is_ignorable_error(errno)) {
+            return;
+        }
+        handle_error(errno);
+    }
+
+    try {
+        int fd = dirfd(dir);
+        while (!stop) {
+            errno = 0;
+            dirent* native = readdir(dir);
+            if (native == nullptr) {
+                if (errno && !(options.ignore_errors && is_ignorable_error(errno))) {
+                    handle_error(errno);
+                }
+                break;
+            } else if (is_relative_dot(native->d_name)) {
+                continue;
+            }
+
+            walk_entry entry;
+            entry.basename = path_t(native->d_name);
+            entry.type = dirent_to_type(native);
+            if (entry.type == walk_unknown || options.stat) {
+                struct stat sb;
+                if (fstatat(fd, native->d_name, &sb, AT_SYMLINK_NOFOLLOW) == 0) {
+                    entry.type = mode_to_type(sb.st_mode);
+                    copy_native(sb, entry.stat);
+                } else if (!options.ignore_errors || !is_ignorable_error(errno)) {
+                    handle_entry_error(errno, entry.type);
+                }
+            }
+
+            if (entry.type == walk_directory && !(prune && prune(batch, entry))) {
+                push(worker, {batch.path(entry), batch.depth + 1});
+            }
+            batch.entries.emplace_back(move(entry));
+            if (batch.entries.size() >= options.batch_size) {
+                callback(batch);
+                batch.entries.clear();
+            }
+        }
+
+        if (!batch.entries.empty() && !stop) {
+            callback(batch);
+        }
+    } catch (...) {
+        closedir(dir);
+        throw;
+    }
+
+    closedir(dir);
+}
+
+
+#endif                              // WINDOWS
+
+
+path_t walk_batch::path(const walk_entry& entry) const
+{
+    return join_path({dirname, entry.basename});
+}
+
+// FUNCTIONS
+// ---------
+
+
+void walk(const path_view_t& root, walk_callback callback, walk_prune prune, const walk_options& options)
+{
+    size_t threads = options.threads;
+    if (threads == 0) {
+        threads = max<size_t>(thread::hardware_concurrency(), 1);
+    }
+
+    walk_options copy = options;
+    copy.batch_size = max<size_t>(copy.batch_size, 1);
+    walk_state state(move(callback), move(prune), copy, threads);
+    state.push(0, {path_t(root), 0});
+
+    vector<thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back([&state, i]() {
+            state.run(i);
+        });
+    }
+    state.run(0);
+    for (thread& worker: workers) {
+        worker.join();
+    }
+
+    if (state.error) {
+        rethrow_exception(state.error);
+    }
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,157 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Parallel recursive directory walker.
+ *
+ *  Walk a directory tree with a pool of threads, yielding the
+ *  entries of each directory in batches. Unlike
+ *  `recursive_directory_iterator`, which is single-threaded,
+ *  subdirectories are queued as tasks, and idle threads steal
+ *  queued directories from busy threads.
+ *
+ *  The file type comes from `d_type` when the filesystem provides
+ *  it, so most entries need no `stat` call at all. Otherwise, and
+ *  when `walk_options::stat` is set, entries are stat'ed with
+ *  `fstatat` relative to the open directory, and full paths are
+ *  only built once per directory, not per entry.
+ *
+ *  Symbolic links are never followed. Batches are passed to the
+ *  callback concurrently from the worker threads, in no particular
+ *  order, so the callback must be thread-safe.
+ *
+ *  \synopsis
+ *      enum walk_type
+ *      {
+ *          walk_unknown = 0,
+ *          walk_file,
+ *          walk_directory,
+ *          walk_symlink,
+ *          walk_other,
+ *      };
+ *
+ *      struct walk_entry
+ *      {
+ *          path_t basename;
+ *          walk_type type;
+ *          stat_t stat;
+ *      };
+ *
+ *      struct walk_batch
+ *      {
+ *          path_t dirname;
+ *          size_t depth;
+ *          vector<walk_entry> entries;
+ *
+ *          path_t path(const walk_entry& entry) const;
+ *      };
+ *
+ *      struct walk_options
+ *      {
+ *          size_t threads = 0;
+ *          size_t batch_size = 1024;
+ *          bool stat = false;
+ *          bool ignore_errors = false;
+ *      };
+ *
+ *      using walk_callback = function<void(walk_batch&)>;
+ *      using walk_prune = function<bool(const walk_batch&, const walk_entry&)>;
+ *
+ *      void walk(const path_view_t& root, walk_callback callback, walk_prune prune = nullptr, const walk_options& options = walk_options());
+ */
+
+#pragma once
+
+#include <pycpp/filesystem/path.h>
+#include <pycpp/filesystem/stat.h>
+#include <pycpp/stl/functional.h>
+#include <pycpp/stl/vector.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// ENUMS
+// -----
+
+/**
+ *  \brief Type of a directory entry, without following symlinks.
+ */
+enum walk_type
+{
+    walk_unknown = 0,
+    walk_file,
+    walk_directory,
+    walk_symlink,
+    walk_other,
+};
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Entry within a directory.
+ *
+ *  `stat` is only valid if `walk_options::stat` is set.
+ */
+struct walk_entry
+{
+    path_t basename;
+    walk_type type = walk_unknown;
+    stat_t stat = stat_t();
+};
+
+
+/**
+ *  \brief Batch of entries from a single directory.
+ *
+ *  Large directories are split into several batches with the same
+ *  `dirname`. The root has a depth of 0.
+ */
+struct walk_batch
+{
+    path_t dirname;
+    size_t depth = 0;
+    vector<walk_entry> entries;
+
+    path_t path(const walk_entry& entry) const;
+};
+
+
+/**
+ *  \brief Options for a directory walk.
+ *
+ *  \param threads          Worker threads, 0 for the hardware concurrency.
+ *  \param batch_size       Maximum number of entries per batch.
+ *  \param stat             Fill `walk_entry::stat` for every entry.
+ *  \param ignore_errors    Skip subdirectories that cannot be read.
+ */
+struct walk_options
+{
+    size_t threads = 0;
+    size_t batch_size = 1024;
+    bool stat = false;
+    bool ignore_errors = false;
+};
+
+// ALIAS
+// -----
+
+using walk_callback = function<void(walk_batch&)>;
+using walk_prune = function<bool(const walk_batch&, const walk_entry&)>;
+
+// FUNCTIONS
+// ---------
+
+/**
+ *  \brief Walk the directory tree rooted at `root` in parallel.
+ *
+ *  \param root             Directory to walk.
+ *  \param callback         Called with each batch, from any worker.
+ *  \param prune            Return true to skip a subdirectory.
+ *  \param options          Walk options.
+ *
+ *  The first exception thrown by a worker, or by the callback,
+ *  stops the walk and is rethrown once all workers exit.
+ */
+void walk(const path_view_t& root, walk_callback callback, walk_prune prune = nullptr, const walk_options& options = walk_options());
+
+PYCPP_END_NAMESPACE
@@ -3,12 +3,19 @@
 /**
  *  \addtogroup PyCPP
  *  \brief Hash functions.
+ *
+ *  Hash contexts are stored inline in each hash object, so hashing
+ *  does not allocate. `digest()` and `hexdigest()` return the digest
+ *  in a `secure_string`, suitable for key material, while
+ *  `digest_into()` and `hexdigest_into()` write it to a caller-provided
+ *  buffer without allocating.
  */
 
 #pragma once
 
 #include <pycpp/misc/stack_pimpl.h>
 #include <pycpp/secure/string.h>
+#include <pycpp/stl/array.h>
 #include <pycpp/stl/functional.h>
 #include <pycpp/stl/string.h>
 #include <pycpp/stl/utility.h>
@@ -61,16 +68,21 @@ enum hash_algorithm
  *
  *  \param          Name of the hash object.
  *  \cx             Name of the context object.
+ *  \size           Size of the digest, in bytes.
+ *  \cxsize         Size of the context object, stored inline.
  */
-#define SPECIALIZED_HASH(name, cx)                                      \
+#define SPECIALIZED_HASH(name, cx, size, cxsize)                        \
     struct name##_hash                                                  \
     {                                                                   \
     public:                                                             \
+        static constexpr size_t digest_size = size;                     \
+        using digest_type = array<uint8_t, digest_size>;                \
+                                                                        \
         name##_hash();                                                  \
         name##_hash(const name##_hash&) = delete;                       \
         name##_hash& operator=(const name##_hash&) = delete;            \
-        name##_hash(name##_hash&&) noexcept = default;                  \
-        name##_hash& operator=(name##_hash&&) noexcept = default;       \
+        name##_hash(name##_hash&&) noexcept;                            \
+        name##_hash& operator=(name##_hash&&) noexcept;                 \
         name##_hash(const void* src, size_t srclen);                    \
         name##_hash(const string_wrapper& str);                         \
         ~name##_hash() noexcept;                                        \
@@ -81,10 +93,12 @@ enum hash_algorithm
         void hexdigest(void*& dst, size_t dstlen) const;                \
         secure_string digest() const;                                   \
         secure_string hexdigest() const;                                \
+        void digest_into(digest_type& dst) const noexcept;              \
+        void hexdigest_into(char* dst) const noexcept;                  \
         void swap(name##_hash&) noexcept;                               \
                                                                         \
     private:                                                            \
-        unique_ptr<cx##_context> ctx;                                   \
+        stack_pimpl<cx##_context, cxsize> ctx;                          \
     }
 
 // FUNCTIONS
@@ -115,10 +129,57 @@ void hash_hexdigest(void* ctx, void*& dst, size_t dstlen, size_t hashlen, void (
  */
 secure_string hash_hexdigest(void* ctx, size_t hashlen, void (*cb)(void*, void*));
 
+/**
+ *  \brief Write hexdigest from context to `dst`, without allocating.
+ *
+ *  `dst` must hold `2 * hashlen` characters, and is not null-terminated.
+ */
+void hash_hexdigest_into(void* ctx, char* dst, size_t hashlen, void (*cb)(void*, void*)) noexcept;
+
+/**
+ *  \brief Hash independent messages with MD5.
+ *
+ *  Writes the digest of message `i` to `dst + 16 * i`, hashing
+ *  messages in parallel SIMD lanes when supported, without
+ *  allocating memory.
+ */
+void md5_digest_batch(const void* const* src, const size_t* srclen, size_t count, void* dst) noexcept;
+void md5_digest_batch(const string_wrapper* str, size_t count, void* dst) noexcept;
+
+/**
+ *  \brief Hash independent messages with SHA1.
+ *
+ *  Writes the digest of message `i` to `dst + 20 * i`.
+ */
+void sha1_digest_batch(const void* const* src, const size_t* srclen, size_t count, void* dst) noexcept;
+void sha1_digest_batch(const string_wrapper* str, size_t count, void* dst) noexcept;
+
+/**
+ *  \brief Hash independent messages with SHA2-256.
+ *
+ *  Writes the digest of message `i` to `dst + 32 * i`.
+ */
+void sha2_256_digest_batch(const void* const* src, const size_t* srclen, size_t count, void* dst) noexcept;
+void sha2_256_digest_batch(const string_wrapper* str, size_t count, void* dst) noexcept;
+
 
 // OBJECTS
 // -------
 
+SPECIALIZED_HASH(md2, md2, 16, 84);
+SPECIALIZED_HASH(md4, md4, 16, 152);
+SPECIALIZED_HASH(md5, md5, 16, 152);
+SPECIALIZED_HASH(sha1, sha1, 20, 92);
+SPECIALIZED_HASH(sha2_224, sha2_256, 28, 112);
+SPECIALIZED_HASH(sha2_256, sha2_256, 32, 112);
+SPECIALIZED_HASH(sha2_384, sha2_512, 48, 208);
+SPECIALIZED_HASH(sha2_512, sha2_512, 64, 208);
+SPECIALIZED_HASH(sha3_224, sha3, 28, 400);
+SPECIALIZED_HASH(sha3_256, sha3, 32, 400);
+SPECIALIZED_HASH(sha3_384, sha3, 48, 400);
+SPECIALIZED_HASH(sha3_512, sha3, 64, 400);
+SPECIALIZED_HASH(whirlpool, whirlpool, 64, 136);
+
 
 /**
  *  \brief Generic hash context.
@@ -146,26 +207,12 @@ public:
     void swap(cryptographic_hash&) noexcept;
 
 private:
-    using memory_type = aligned_storage_t<sizeof(uintptr_t), alignof(uintptr_t)>;
+    // SHA3 has the largest context
+    using memory_type = aligned_storage_t<sizeof(sha3_512_hash), alignof(sha3_512_hash)>;
     hash_algorithm algorithm;
     memory_type mem;
 };
 
-
-SPECIALIZED_HASH(md2, md2);
-SPECIALIZED_HASH(md4, md4);
-SPECIALIZED_HASH(md5, md5);
-SPECIALIZED_HASH(sha1, sha1);
-SPECIALIZED_HASH(sha2_224, sha2_256);
-SPECIALIZED_HASH(sha2_256, sha2_256);
-SPECIALIZED_HASH(sha2_384, sha2_512);
-SPECIALIZED_HASH(sha2_512, sha2_512);
-SPECIALIZED_HASH(sha3_224, sha3);
-SPECIALIZED_HASH(sha3_256, sha3);
-SPECIALIZED_HASH(sha3_384, sha3);
-SPECIALIZED_HASH(sha3_512, sha3);
-SPECIALIZED_HASH(whirlpool, whirlpool);
-
 // SPECIALIZATION
 // --------------
 
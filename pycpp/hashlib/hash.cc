@@ -8,6 +8,7 @@
 #include <pycpp/hashlib.h>
 #include <pycpp/secure/stdlib.h>
 #include <pycpp/stl/stdexcept.h>
+#include <pycpp/string/base16.h>
 #include <pycpp/string/hex.h>
 #include <assert.h>
 #include <string.h>
@@ -103,6 +104,18 @@ secure_string hash_hexdigest(void* ctx, size_t hashlen, void (*cb)(void*, void*)
 }
 
 
+void hash_hexdigest_into(void* ctx, char* dst, size_t hashlen, void (*cb)(void*, void*)) noexcept
+{
+    uint8_t hash[64];
+    assert(hashlen <= sizeof(hash));
+
+    cb(ctx, hash);
+    const void* src = hash;
+    void* dst_first = dst;
+    base16_encode(src, hashlen, dst_first, 2 * hashlen);
+}
+
+
 /**
  *  \brief Allocate storage for hash.
  */
@@ -218,6 +231,18 @@ template <typename T, typename Memory>
 using hash_type = conditional_const_t<T, is_const<Memory>::value>;
 
 
+/**
+ *  \brief Cast storage to a hash, which must fit inline.
+ */
+template <typename Hash, typename Memory>
+static Hash& hash_cast(Memory& mem) noexcept
+{
+    static_assert(sizeof(Hash) <= sizeof(Memory), "Hash does not fit in storage.");
+    static_assert(alignof(Hash) <= alignof(Memory), "Hash is not aligned in storage.");
+    return reinterpret_cast<Hash&>(mem);
+}
+
+
 /**
  *  \brief Cast storage to the correct type.
  */
@@ -229,55 +254,55 @@ static void get_hash(Memory& mem, hash_algorithm algorithm, Function& function)
             return;
 
         case md2_hash_algorithm:
-            function(reinterpret_cast<hash_type<md2_hash, Memory>&>(mem));
+            function(hash_cast<hash_type<md2_hash, Memory>>(mem));
             break;
 
         case md4_hash_algorithm:
-            function(reinterpret_cast<hash_type<md4_hash, Memory>&>(mem));
+            function(hash_cast<hash_type<md4_hash, Memory>>(mem));
             break;
 
         case md5_hash_algorithm:
-            function(reinterpret_cast<hash_type<md5_hash, Memory>&>(mem));
+            function(hash_cast<hash_type<md5_hash, Memory>>(mem));
             break;
 
         case sha1_hash_algorithm:
-            function(reinterpret_cast<hash_type<sha1_hash, Memory>&>(mem));
+            function(hash_cast<hash_type<sha1_hash, Memory>>(mem));
             break;
 
         case sha2_224_hash_algorithm:
-            function(reinterpret_cast<hash_type<sha2_224_hash, Memory>&>(mem));
+            function(hash_cast<hash_type<sha2_224_hash, Memory>>(mem));
             break;
 
         case sha2_256_hash_algorithm:
-            function(reinterpret_cast<hash_type<sha2_256_hash, Memory>&>(mem));
+            function(hash_cast<hash_type<sha2_256_hash, Memory>>(mem));
             break;
 
         case sha2_384_hash_algorithm:
-            function(reinterpret_cast<hash_type<sha2_384_hash, Memory>&>(mem));
+            function(hash_cast<hash_type<sha2_384_hash, Memory>>(mem));
             break;
 
         case sha2_512_hash_algorithm:
-            function(reinterpret_cast<hash_type<sha2_512_hash, Memory>&>(mem));
+            function(hash_cast<hash_type<sha2_512_hash, Memory>>(mem));
             break;
 
         case sha3_224_hash_algorithm:
-            function(reinterpret_cast<hash_type<sha3_224_hash, Memory>&>(mem));
+            function(hash_cast<hash_type<sha3_224_hash, Memory>>(mem));
             break;
 
         case sha3_256_hash_algorithm:
-            function(reinterpret_cast<hash_type<sha3_256_hash, Memory>&>(mem));
+            function(hash_cast<hash_type<sha3_256_hash, Memory>>(mem));
             break;
 
         case sha3_384_hash_algorithm:
-            function(reinterpret_cast<hash_type<sha3_384_hash, Memory>&>(mem));
+            function(hash_cast<hash_type<sha3_384_hash, Memory>>(mem));
             break;
 
         case sha3_512_hash_algorithm:
-            function(reinterpret_cast<hash_type<sha3_512_hash, Memory>&>(mem));
+            function(hash_cast<hash_type<sha3_512_hash, Memory>>(mem));
             break;
 
         case whirlpool_hash_algorithm:
-            function(reinterpret_cast<hash_type<whirlpool_hash, Memory>&>(mem));
+            function(hash_cast<hash_type<whirlpool_hash, Memory>>(mem));
             break;
 
         default:
@@ -0,0 +1,135 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Tables of the block kernels used by the hashes.
+ *
+ *  SHA-1 and SHA-2 compress blocks, and MD5, SHA-1 and SHA-2-256
+ *  hash batches of messages, with the fastest kernel the processor
+ *  supports. Each table lists every kernel compiled in, fastest
+ *  first, with a check for whether the processor can run it.
+ *
+ *  The kernel used by the hashes may be replaced, so tests and
+ *  benchmarks can run each kernel, including the fallbacks never
+ *  selected on newer hardware, through the public interface. Only
+ *  replace a kernel while no other thread is hashing. A null batch
+ *  kernel hashes each message in turn.
+ */
+
+#pragma once
+
+#include <pycpp/hashlib/multibuffer.h>
+#include <pycpp/stl/iterator.h>
+#include <stddef.h>
+#include <stdint.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// ALIAS
+// -----
+
+using sha1_blocks_t = void (*)(uint32_t* state, const uint8_t* data, size_t blocks);
+using sha256_blocks_t = void (*)(uint32_t* hash, const uint8_t* data, size_t blocks);
+using sha512_blocks_t = void (*)(uint64_t* hash, const uint8_t* data, size_t blocks);
+
+// OBJECTS
+// -------
+
+
+/**
+ *  \brief Named kernel, and whether the processor can run it.
+ */
+template <typename Kernel>
+struct hash_kernel
+{
+    const char* name;
+    Kernel kernel;
+    bool (*supported)();
+};
+
+
+/**
+ *  \brief Range over a table of kernels.
+ */
+template <typename Kernel>
+struct hash_kernel_table
+{
+    const hash_kernel<Kernel>* first;
+    const hash_kernel<Kernel>* last;
+
+    const hash_kernel<Kernel>* begin() const noexcept
+    {
+        return first;
+    }
+
+    const hash_kernel<Kernel>* end() const noexcept
+    {
+        return last;
+    }
+};
+
+// FUNCTIONS
+// ---------
+
+
+/**
+ *  \brief Check for kernels that run on any processor.
+ */
+inline bool hash_kernel_portable()
+{
+    return true;
+}
+
+
+/**
+ *  \brief Get the first kernel in the table the processor supports.
+ */
+template <typename Kernel>
+Kernel hash_kernel_select(const hash_kernel_table<Kernel>& table) noexcept
+{
+    for (const hash_kernel<Kernel>& item: table) {
+        if (item.supported()) {
+            return item.kernel;
+        }
+    }
+    return nullptr;
+}
+
+hash_kernel_table<sha1_blocks_t> sha1_kernels() noexcept;
+hash_kernel_table<sha256_blocks_t> sha256_kernels() noexcept;
+hash_kernel_table<sha512_blocks_t> sha512_kernels() noexcept;
+hash_kernel_table<multibuffer_kernel_t> md5_batch_kernels() noexcept;
+hash_kernel_table<multibuffer_kernel_t> sha1_batch_kernels() noexcept;
+hash_kernel_table<multibuffer_kernel_t> sha256_batch_kernels() noexcept;
+
+/**
+ *  \brief Kernel used by `sha1_hash`.
+ */
+sha1_blocks_t& sha1_kernel() noexcept;
+
+/**
+ *  \brief Kernel used by `sha2_224_hash` and `sha2_256_hash`.
+ */
+sha256_blocks_t& sha256_kernel() noexcept;
+
+/**
+ *  \brief Kernel used by `sha2_384_hash` and `sha2_512_hash`.
+ */
+sha512_blocks_t& sha512_kernel() noexcept;
+
+/**
+ *  \brief Kernel used by `md5_digest_batch`.
+ */
+multibuffer_kernel_t& md5_batch_kernel() noexcept;
+
+/**
+ *  \brief Kernel used by `sha1_digest_batch`.
+ */
+multibuffer_kernel_t& sha1_batch_kernel() noexcept;
+
+/**
+ *  \brief Kernel used by `sha2_256_digest_batch`.
+ */
+multibuffer_kernel_t& sha256_batch_kernel() noexcept;
+
+PYCPP_END_NAMESPACE
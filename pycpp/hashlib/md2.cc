@@ -111,38 +111,44 @@ static void md2_final(void* ptr, void* buf) noexcept
 // -------
 
 
-md2_hash::md2_hash():
-    ctx(make_unique<md2_context>())
+constexpr size_t md2_hash::digest_size;
+
+
+md2_hash::md2_hash()
 {
-    md2_init(ctx.get());
+    md2_init(&ctx.get());
 }
 
 
-md2_hash::md2_hash(const void* src, size_t srclen):
-    ctx(make_unique<md2_context>())
+md2_hash::md2_hash(const void* src, size_t srclen)
 {
-    md2_init(ctx.get());
+    md2_init(&ctx.get());
     update(src, srclen);
 }
 
 
-md2_hash::md2_hash(const string_wrapper& str):
-    ctx(make_unique<md2_context>())
+md2_hash::md2_hash(const string_wrapper& str)
 {
-    md2_init(ctx.get());
+    md2_init(&ctx.get());
     update(str);
 }
 
 
+md2_hash::md2_hash(md2_hash&&) noexcept = default;
+
+
+md2_hash& md2_hash::operator=(md2_hash&&) noexcept = default;
+
+
 md2_hash::~md2_hash() noexcept
 {
-    secure_zero(ctx.get(), sizeof(*ctx));
+    secure_zero(&ctx.get(), sizeof(*ctx));
 }
 
 
 void md2_hash::update(const void* src, size_t srclen) noexcept
 {
-    hash_update(ctx.get(), src, srclen, md2_update);
+    hash_update(&ctx.get(), src, srclen, md2_update);
 }
 
 
@@ -180,6 +186,20 @@ secure_string md2_hash::hexdigest() const
 }
 
 
+void md2_hash::digest_into(digest_type& dst) const noexcept
+{
+    md2_context copy = *ctx;
+    md2_final(&copy, dst.data());
+}
+
+
+void md2_hash::hexdigest_into(char* dst) const noexcept
+{
+    md2_context copy = *ctx;
+    hash_hexdigest_into(&copy, dst, MD2_HASH_SIZE, md2_final);
+}
+
+
 void md2_hash::swap(md2_hash& rhs) noexcept
 {
     using PYCPP_NAMESPACE::swap;
@@ -276,38 +276,44 @@ void md4_final(void *ptr, void* buf) noexcept
 // -------
 
 
-md4_hash::md4_hash():
-    ctx(make_unique<md4_context>())
+constexpr size_t md4_hash::digest_size;
+
+
+md4_hash::md4_hash()
 {
-    md4_init(ctx.get());
+    md4_init(&ctx.get());
 }
 
 
-md4_hash::md4_hash(const void* src, size_t srclen):
-    ctx(make_unique<md4_context>())
+md4_hash::md4_hash(const void* src, size_t srclen)
 {
-    md4_init(ctx.get());
+    md4_init(&ctx.get());
     update(src, srclen);
 }
 
 
-md4_hash::md4_hash(const string_wrapper& str):
-    ctx(make_unique<md4_context>())
+md4_hash::md4_hash(const string_wrapper& str)
 {
-    md4_init(ctx.get());
+    md4_init(&ctx.get());
     update(str);
 }
 
 
+md4_hash::md4_hash(md4_hash&&) noexcept = default;
+
+
+md4_hash& md4_hash::operator=(md4_hash&&) noexcept = default;
+
+
 md4_hash::~md4_hash() noexcept
 {
-    secure_zero(ctx.get(), sizeof(*ctx));
+    secure_zero(&ctx.get(), sizeof(*ctx));
 }
 
 
 void md4_hash::update(const void* src, size_t srclen) noexcept
 {
-    hash_update(ctx.get(), src, srclen, md4_update);
+    hash_update(&ctx.get(), src, srclen, md4_update);
 }
 
 
@@ -345,6 +351,20 @@ secure_string md4_hash::hexdigest() const
 }
 
 
+void md4_hash::digest_into(digest_type& dst) const noexcept
+{
+    md4_context copy = *ctx;
+    md4_final(&copy, dst.data());
+}
+
+
+void md4_hash::hexdigest_into(char* dst) const noexcept
+{
+    md4_context copy = *ctx;
+    hash_hexdigest_into(&copy, dst, MD4_HASH_SIZE, md4_final);
+}
+
+
 void md4_hash::swap(md4_hash& rhs) noexcept
 {
     using PYCPP_NAMESPACE::swap;
@@ -3,10 +3,15 @@
 //  :license: MIT, see licenses/mit.md for more details.
 /*
  *  [reference] http://openwall.info/wiki/people/solar/software/public-domain-source-code/md5
+ *
+ *  Batches of independent messages are hashed 8 at a time, one per
+ *  lane, with an AVX2 multi-buffer kernel.
  */
 
 #include <pycpp/hashlib.h>
+#include <pycpp/hashlib/kernel.h>
 #include <pycpp/preprocessor/processor.h>
+#include <pycpp/runtime/cpu.h>
 #include <pycpp/secure/stdlib.h>
 #include <pycpp/stl/stdexcept.h>
 #include <warnings/push.h>
@@ -19,6 +24,7 @@ PYCPP_BEGIN_NAMESPACE
 // ---------
 
 static constexpr size_t MD5_HASH_SIZE = 16;
+static constexpr uint32_t MD5_IV[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
 
 // OBJECTS
 // -------
@@ -199,15 +205,151 @@ static const void* body(md5_context* ctx, const void* data, uint32_t size) noexc
 }
 
 
+#if defined(HAVE_X86_SIMD)              // HAVE_X86_SIMD
+
+// MULTI-BUFFER
+
+SIMD_TARGET("avx2")
+static inline __m256i md5_f_x8(__m256i x, __m256i y, __m256i z)
+{
+    return _mm256_xor_si256(z, _mm256_and_si256(x, _mm256_xor_si256(y, z)));
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m256i md5_g_x8(__m256i x, __m256i y, __m256i z)
+{
+    return _mm256_xor_si256(y, _mm256_and_si256(z, _mm256_xor_si256(x, y)));
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m256i md5_h_x8(__m256i x, __m256i y, __m256i z)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(x, y), z);
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m256i md5_i_x8(__m256i x, __m256i y, __m256i z)
+{
+    return _mm256_xor_si256(y, _mm256_or_si256(x, _mm256_xor_si256(z, _mm256_set1_epi32(-1))));
+}
+
+
+#define STEP_X8(f, a, b, c, d, i, t, s)                                                         \
+    (a) = _mm256_add_epi32((a), _mm256_add_epi32(f((b), (c), (d)),                              \
+        _mm256_add_epi32(W[i], _mm256_set1_epi32((int) (t)))));                                 \
+    (a) = _mm256_add_epi32(multibuffer_rol_avx2((a), (s)), (b));
+
+
+/**
+ *  \brief Compress one block for each of 8 independent messages.
+ */
+SIMD_TARGET("avx2")
+static void md5_x8_avx2(uint32_t (*state)[MULTIBUFFER_LANES], const uint8_t* const* blocks)
+{
+    __m256i W[16];
+    multibuffer_load_avx2(blocks, W);
+
+    __m256i saved_a = _mm256_loadu_si256((const __m256i*) state[0]);
+    __m256i saved_b = _mm256_loadu_si256((const __m256i*) state[1]);
+    __m256i saved_c = _mm256_loadu_si256((const __m256i*) state[2]);
+    __m256i saved_d = _mm256_loadu_si256((const __m256i*) state[3]);
+    __m256i a = saved_a, b = saved_b, c = saved_c, d = saved_d;
+
+    // ROUND 1
+    STEP_X8(md5_f_x8, a, b, c, d, 0, 0xd76aa478, 7)
+    STEP_X8(md5_f_x8, d, a, b, c, 1, 0xe8c7b756, 12)
+    STEP_X8(md5_f_x8, c, d, a, b, 2, 0x242070db, 17)
+    STEP_X8(md5_f_x8, b, c, d, a, 3, 0xc1bdceee, 22)
+    STEP_X8(md5_f_x8, a, b, c, d, 4, 0xf57c0faf, 7)
+    STEP_X8(md5_f_x8, d, a, b, c, 5, 0x4787c62a, 12)
+    STEP_X8(md5_f_x8, c, d, a, b, 6, 0xa8304613, 17)
+    STEP_X8(md5_f_x8, b, c, d, a, 7, 0xfd469501, 22)
+    STEP_X8(md5_f_x8, a, b, c, d, 8, 0x698098d8, 7)
+    STEP_X8(md5_f_x8, d, a, b, c, 9, 0x8b44f7af, 12)
+    STEP_X8(md5_f_x8, c, d, a, b, 10, 0xffff5bb1, 17)
+    STEP_X8(md5_f_x8, b, c, d, a, 11, 0x895cd7be, 22)
+    STEP_X8(md5_f_x8, a, b, c, d, 12, 0x6b901122, 7)
+    STEP_X8(md5_f_x8, d, a, b, c, 13, 0xfd987193, 12)
+    STEP_X8(md5_f_x8, c, d, a, b, 14, 0xa679438e, 17)
+    STEP_X8(md5_f_x8, b, c, d, a, 15, 0x49b40821, 22)
+
+    // ROUND 2
+    STEP_X8(md5_g_x8, a, b, c, d, 1, 0xf61e2562, 5)
+    STEP_X8(md5_g_x8, d, a, b, c, 6, 0xc040b340, 9)
+    STEP_X8(md5_g_x8, c, d, a, b, 11, 0x265e5a51, 14)
+    STEP_X8(md5_g_x8, b, c, d, a, 0, 0xe9b6c7aa, 20)
+    STEP_X8(md5_g_x8, a, b, c, d, 5, 0xd62f105d, 5)
+    STEP_X8(md5_g_x8, d, a, b, c, 10, 0x02441453, 9)
+    STEP_X8(md5_g_x8, c, d, a, b, 15, 0xd8a1e681, 14)
+    STEP_X8(md5_g_x8, b, c, d, a, 4, 0xe7d3fbc8, 20)
+    STEP_X8(md5_g_x8, a, b, c, d, 9, 0x21e1cde6, 5)
+    STEP_X8(md5_g_x8, d, a, b, c, 14, 0xc33707d6, 9)
+    STEP_X8(md5_g_x8, c, d, a, b, 3, 0xf4d50d87, 14)
+    STEP_X8(md5_g_x8, b, c, d, a, 8, 0x455a14ed, 20)
+    STEP_X8(md5_g_x8, a, b, c, d, 13, 0xa9e3e905, 5)
+    STEP_X8(md5_g_x8, d, a, b, c, 2, 0xfcefa3f8, 9)
+    STEP_X8(md5_g_x8, c, d, a, b, 7, 0x676f02d9, 14)
+    STEP_X8(md5_g_x8, b, c, d, a, 12, 0x8d2a4c8a, 20)
+
+    // ROUND 3
+    STEP_X8(md5_h_x8, a, b, c, d, 5, 0xfffa3942, 4)
+    STEP_X8(md5_h_x8, d, a, b, c, 8, 0x8771f681, 11)
+    STEP_X8(md5_h_x8, c, d, a, b, 11, 0x6d9d6122, 16)
+    STEP_X8(md5_h_x8, b, c, d, a, 14, 0xfde5380c, 23)
+    STEP_X8(md5_h_x8, a, b, c, d, 1, 0xa4beea44, 4)
+    STEP_X8(md5_h_x8, d, a, b, c, 4, 0x4bdecfa9, 11)
+    STEP_X8(md5_h_x8, c, d, a, b, 7, 0xf6bb4b60, 16)
+    STEP_X8(md5_h_x8, b, c, d, a, 10, 0xbebfbc70, 23)
+    STEP_X8(md5_h_x8, a, b, c, d, 13, 0x289b7ec6, 4)
+    STEP_X8(md5_h_x8, d, a, b, c, 0, 0xeaa127fa, 11)
+    STEP_X8(md5_h_x8, c, d, a, b, 3, 0xd4ef3085, 16)
+    STEP_X8(md5_h_x8, b, c, d, a, 6, 0x04881d05, 23)
+    STEP_X8(md5_h_x8, a, b, c, d, 9, 0xd9d4d039, 4)
+    STEP_X8(md5_h_x8, d, a, b, c, 12, 0xe6db99e5, 11)
+    STEP_X8(md5_h_x8, c, d, a, b, 15, 0x1fa27cf8, 16)
+    STEP_X8(md5_h_x8, b, c, d, a, 2, 0xc4ac5665, 23)
+
+    // ROUND 4
+    STEP_X8(md5_i_x8, a, b, c, d, 0, 0xf4292244, 6)
+    STEP_X8(md5_i_x8, d, a, b, c, 7, 0x432aff97, 10)
+    STEP_X8(md5_i_x8, c, d, a, b, 14, 0xab9423a7, 15)
+    STEP_X8(md5_i_x8, b, c, d, a, 5, 0xfc93a039, 21)
+    STEP_X8(md5_i_x8, a, b, c, d, 12, 0x655b59c3, 6)
+    STEP_X8(md5_i_x8, d, a, b, c, 3, 0x8f0ccc92, 10)
+    STEP_X8(md5_i_x8, c, d, a, b, 10, 0xffeff47d, 15)
+    STEP_X8(md5_i_x8, b, c, d, a, 1, 0x85845dd1, 21)
+    STEP_X8(md5_i_x8, a, b, c, d, 8, 0x6fa87e4f, 6)
+    STEP_X8(md5_i_x8, d, a, b, c, 15, 0xfe2ce6e0, 10)
+    STEP_X8(md5_i_x8, c, d, a, b, 6, 0xa3014314, 15)
+    STEP_X8(md5_i_x8, b, c, d, a, 13, 0x4e0811a1, 21)
+    STEP_X8(md5_i_x8, a, b, c, d, 4, 0xf7537e82, 6)
+    STEP_X8(md5_i_x8, d, a, b, c, 11, 0xbd3af235, 10)
+    STEP_X8(md5_i_x8, c, d, a, b, 2, 0x2ad7d2bb, 15)
+    STEP_X8(md5_i_x8, b, c, d, a, 9, 0xeb86d391, 21)
+
+    _mm256_storeu_si256((__m256i*) state[0], _mm256_add_epi32(a, saved_a));
+    _mm256_storeu_si256((__m256i*) state[1], _mm256_add_epi32(b, saved_b));
+    _mm256_storeu_si256((__m256i*) state[2], _mm256_add_epi32(c, saved_c));
+    _mm256_storeu_si256((__m256i*) state[3], _mm256_add_epi32(d, saved_d));
+}
+
+#undef STEP_X8
+
+#endif                                  // HAVE_X86_SIMD
+
+
 /**
  *  \brief Initialize MD5 context.
  */
 void md5_init(md5_context* ctx) noexcept
 {
-    ctx->a = 0x67452301;
-    ctx->b = 0xefcdab89;
-    ctx->c = 0x98badcfe;
-    ctx->d = 0x10325476;
+    ctx->a = MD5_IV[0];
+    ctx->b = MD5_IV[1];
+    ctx->c = MD5_IV[2];
+    ctx->d = MD5_IV[3];
 
     ctx->lo = 0;
     ctx->hi = 0;
@@ -301,42 +443,113 @@ static void md5_final(void* ptr, void* buf) noexcept
 }
 
 
+// BATCH
+// -----
+
+
+#if defined(HAVE_X86_SIMD)              // HAVE_X86_SIMD
+
+static bool md5_x8_supported()
+{
+    return cpu_supports(cpu_avx2);
+}
+
+#endif                                  // HAVE_X86_SIMD
+
+static const hash_kernel<multibuffer_kernel_t> MD5_BATCH_KERNELS[] = {
+#if defined(HAVE_X86_SIMD)
+    {"avx2", md5_x8_avx2, md5_x8_supported},
+#endif
+    {"serial", nullptr, hash_kernel_portable},
+};
+
+
+hash_kernel_table<multibuffer_kernel_t> md5_batch_kernels() noexcept
+{
+    return {begin(MD5_BATCH_KERNELS), end(MD5_BATCH_KERNELS)};
+}
+
+
+multibuffer_kernel_t& md5_batch_kernel() noexcept
+{
+    static multibuffer_kernel_t kernel = hash_kernel_select(md5_batch_kernels());
+    return kernel;
+}
+
+
+template <typename Messages>
+static void md5_batch(const Messages& messages, size_t count, void* dst) noexcept
+{
+    multibuffer_kernel_t kernel = md5_batch_kernel();
+    auto* digest = (uint8_t*) dst;
+
+    if (kernel) {
+        multibuffer_hash hash = {kernel, MD5_IV, 4, MD5_HASH_SIZE, false};
+        multibuffer_digest(hash, messages, count, digest);
+    } else {
+        md5_context ctx;
+        for (size_t i = 0; i < count; ++i) {
+            md5_init(&ctx);
+            hash_update(&ctx, messages.data(i), messages.size(i), md5_update);
+            md5_final(&ctx, digest + i * MD5_HASH_SIZE);
+        }
+    }
+}
+
+
+void md5_digest_batch(const void* const* src, const size_t* srclen, size_t count, void* dst) noexcept
+{
+    md5_batch(multibuffer_arrays {src, srclen}, count, dst);
+}
+
+
+void md5_digest_batch(const string_wrapper* str, size_t count, void* dst) noexcept
+{
+    md5_batch(multibuffer_strings {str}, count, dst);
+}
+
 // OBJECTS
 // -------
 
 
-md5_hash::md5_hash():
-    ctx(make_unique<md5_context>())
+constexpr size_t md5_hash::digest_size;
+
+
+md5_hash::md5_hash()
 {
-    md5_init(ctx.get());
+    md5_init(&ctx.get());
 }
 
 
-md5_hash::md5_hash(const void* src, size_t srclen):
-    ctx(make_unique<md5_context>())
+md5_hash::md5_hash(const void* src, size_t srclen)
 {
-    md5_init(ctx.get());
+    md5_init(&ctx.get());
     update(src, srclen);
 }
 
 
-md5_hash::md5_hash(const string_wrapper& str):
-    ctx(make_unique<md5_context>())
+md5_hash::md5_hash(const string_wrapper& str)
 {
-    md5_init(ctx.get());
+    md5_init(&ctx.get());
     update(str);
 }
 
 
+md5_hash::md5_hash(md5_hash&&) noexcept = default;
+
+
+md5_hash& md5_hash::operator=(md5_hash&&) noexcept = default;
+
+
 md5_hash::~md5_hash() noexcept
 {
-    secure_zero(ctx.get(), sizeof(*ctx));
+    secure_zero(&ctx.get(), sizeof(*ctx));
 }
 
 
 void md5_hash::update(const void* src, size_t srclen) noexcept
 {
-    hash_update(ctx.get(), src, srclen, md5_update);
+    hash_update(&ctx.get(), src, srclen, md5_update);
 }
 
 
@@ -374,6 +587,20 @@ secure_string md5_hash::hexdigest() const
 }
 
 
+void md5_hash::digest_into(digest_type& dst) const noexcept
+{
+    md5_context copy = *ctx;
+    md5_final(&copy, dst.data());
+}
+
+
+void md5_hash::hexdigest_into(char* dst) const noexcept
+{
+    md5_context copy = *ctx;
+    hash_hexdigest_into(&copy, dst, MD5_HASH_SIZE, md5_final);
+}
+
+
 void md5_hash::swap(md5_hash& rhs) noexcept
 {
     using PYCPP_NAMESPACE::swap;
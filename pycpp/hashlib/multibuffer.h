@@ -0,0 +1,291 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Multi-buffer hashing of many independent messages.
+ *
+ *  Merkle-Damgard hashes with 64-byte blocks and 32-bit state words
+ *  (MD5, SHA-1, SHA-2-256) can hash 8 independent messages at once,
+ *  one per 32-bit lane of an AVX2 register. The scheduler assigns a
+ *  message to each lane, feeds every lane its next block (full blocks
+ *  are read in place, the padded tail from a per-lane buffer), and
+ *  refills a lane with the next message as soon as its digest is
+ *  written, so messages of different lengths keep all lanes busy.
+ */
+
+#pragma once
+
+#include <pycpp/runtime/cpu.h>
+#include <pycpp/secure/stdlib.h>
+#include <pycpp/string/string.h>
+#include <stdint.h>
+#include <string.h>
+#if defined(HAVE_X86_SIMD)
+#   include <immintrin.h>
+#endif
+
+PYCPP_BEGIN_NAMESPACE
+
+// CONSTANTS
+// ---------
+
+static constexpr size_t MULTIBUFFER_LANES = 8;
+static constexpr size_t MULTIBUFFER_BLOCK_SIZE = 64;
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Compress one block for each lane.
+ *
+ *  `state[w][l]` is state word `w` of lane `l`.
+ */
+using multibuffer_kernel_t = void (*)(uint32_t (*state)[MULTIBUFFER_LANES], const uint8_t* const* blocks);
+
+
+/**
+ *  \brief Description of a hash for the multi-buffer scheduler.
+ */
+struct multibuffer_hash
+{
+    multibuffer_kernel_t kernel;
+    const uint32_t* iv;
+    size_t words;
+    size_t digest_size;
+    bool big_endian;
+};
+
+
+/**
+ *  \brief Messages from arrays of pointers and lengths.
+ */
+struct multibuffer_arrays
+{
+    const void* const* src;
+    const size_t* srclen;
+
+    const uint8_t* data(size_t i) const noexcept
+    {
+        return reinterpret_cast<const uint8_t*>(src[i]);
+    }
+
+    size_t size(size_t i) const noexcept
+    {
+        return srclen[i];
+    }
+};
+
+
+/**
+ *  \brief Messages from an array of strings.
+ */
+struct multibuffer_strings
+{
+    const string_wrapper* str;
+
+    const uint8_t* data(size_t i) const noexcept
+    {
+        return reinterpret_cast<const uint8_t*>(str[i].data());
+    }
+
+    size_t size(size_t i) const noexcept
+    {
+        return str[i].size();
+    }
+};
+
+
+/**
+ *  \brief Message currently assigned to a lane.
+ */
+struct multibuffer_lane
+{
+    const uint8_t* data;
+    const uint8_t* padding;
+    size_t blocks;
+    size_t tail;
+    size_t index;
+    uint8_t pad[2 * MULTIBUFFER_BLOCK_SIZE];
+};
+
+// FUNCTIONS
+// ---------
+
+
+/**
+ *  \brief Write a 32-bit word in the hash byte order.
+ */
+inline void multibuffer_store(uint8_t* dst, uint32_t value, bool big_endian) noexcept
+{
+    for (int i = 0; i < 4; ++i) {
+        int shift = big_endian ? 24 - 8 * i : 8 * i;
+        dst[i] = static_cast<uint8_t>(value >> shift);
+    }
+}
+
+
+#if defined(HAVE_X86_SIMD)              // HAVE_X86_SIMD
+
+/**
+ *  \brief Load one block for each lane, transposed so `w[i]` holds word `i` of every lane.
+ *
+ *  Words are loaded in memory order, without swapping bytes.
+ */
+SIMD_TARGET("avx2")
+inline void multibuffer_load_avx2(const uint8_t* const* blocks, __m256i* w) noexcept
+{
+    for (size_t half = 0; half < 2; ++half, w += 8) {
+        __m256i r[8];
+        for (size_t l = 0; l < MULTIBUFFER_LANES; ++l) {
+            r[l] = _mm256_loadu_si256((const __m256i*) (blocks[l] + 32 * half));
+        }
+
+        // 8x8 transpose: interleave words, then pairs, then 128-bit halves
+        __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+        __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+        __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+        __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+        __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+        __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+        __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+        __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+        __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+        __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+        __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+        __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+        __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+        __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+        __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+        __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+        w[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+        w[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+        w[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+        w[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+        w[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+        w[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+        w[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+        w[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+    }
+}
+
+
+/**
+ *  \brief Rotate each 32-bit lane left.
+ */
+SIMD_TARGET("avx2")
+inline __m256i multibuffer_rol_avx2(__m256i x, int n) noexcept
+{
+    return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n));
+}
+
+#endif                                  // HAVE_X86_SIMD
+
+
+/**
+ *  \brief Assign a message to a lane and reset its state.
+ */
+template <typename Messages>
+void multibuffer_start(const multibuffer_hash& hash, const Messages& messages, size_t index, multibuffer_lane& lane, uint32_t (*state)[MULTIBUFFER_LANES], size_t l) noexcept
+{
+    const uint8_t* data = messages.data(index);
+    size_t size = messages.size(index);
+    size_t used = size % MULTIBUFFER_BLOCK_SIZE;
+
+    lane.data = data;
+    lane.blocks = size / MULTIBUFFER_BLOCK_SIZE;
+    lane.index = index;
+
+    // pad the tail: 0x80, zeros, and the 64-bit message length in bits
+    lane.tail = used + 9 > MULTIBUFFER_BLOCK_SIZE ? 2 : 1;
+    size_t padded = lane.tail * MULTIBUFFER_BLOCK_SIZE;
+    lane.padding = lane.pad;
+    if (used) {
+        memcpy(lane.pad, data + size - used, used);
+    }
+    lane.pad[used] = 0x80;
+    memset(lane.pad + used + 1, 0, padded - used - 1);
+    uint64_t bits = static_cast<uint64_t>(size) << 3;
+    uint8_t* length = lane.pad + padded - 8;
+    if (hash.big_endian) {
+        multibuffer_store(length, static_cast<uint32_t>(bits >> 32), true);
+        multibuffer_store(length + 4, static_cast<uint32_t>(bits), true);
+    } else {
+        multibuffer_store(length, static_cast<uint32_t>(bits), false);
+        multibuffer_store(length + 4, static_cast<uint32_t>(bits >> 32), false);
+    }
+
+    for (size_t w = 0; w < hash.words; ++w) {
+        state[w][l] = hash.iv[w];
+    }
+}
+
+
+/**
+ *  \brief Hash `count` messages, writing the digests in order to `dst`.
+ */
+template <typename Messages>
+void multibuffer_digest(const multibuffer_hash& hash, const Messages& messages, size_t count, uint8_t* dst) noexcept
+{
+    static const uint8_t idle[MULTIBUFFER_BLOCK_SIZE] = {};
+    multibuffer_lane lanes[MULTIBUFFER_LANES];
+    uint32_t state[8][MULTIBUFFER_LANES];
+    const uint8_t* blocks[MULTIBUFFER_LANES];
+    bool active[MULTIBUFFER_LANES];
+
+    size_t next = 0;
+    size_t remaining = 0;
+    for (size_t l = 0; l < MULTIBUFFER_LANES; ++l) {
+        active[l] = next < count;
+        if (active[l]) {
+            multibuffer_start(hash, messages, next++, lanes[l], state, l);
+            ++remaining;
+        }
+    }
+
+    while (remaining) {
+        // idle lanes compress a dummy block, and their state is ignored
+        for (size_t l = 0; l < MULTIBUFFER_LANES; ++l) {
+            if (!active[l]) {
+                blocks[l] = idle;
+            } else if (lanes[l].blocks) {
+                blocks[l] = lanes[l].data;
+            } else {
+                blocks[l] = lanes[l].padding;
+            }
+        }
+        hash.kernel(state, blocks);
+
+        for (size_t l = 0; l < MULTIBUFFER_LANES; ++l) {
+            multibuffer_lane& lane = lanes[l];
+            if (!active[l]) {
+                continue;
+            } else if (lane.blocks) {
+                lane.data += MULTIBUFFER_BLOCK_SIZE;
+                --lane.blocks;
+                continue;
+            }
+
+            lane.padding += MULTIBUFFER_BLOCK_SIZE;
+            if (--lane.tail) {
+                continue;
+            }
+
+            // message is done: write the digest and refill the lane
+            uint8_t* digest = dst + lane.index * hash.digest_size;
+            for (size_t w = 0; 4 * w < hash.digest_size; ++w) {
+                multibuffer_store(digest + 4 * w, state[w][l], hash.big_endian);
+            }
+            if (next < count) {
+                multibuffer_start(hash, messages, next++, lane, state, l);
+            } else {
+                active[l] = false;
+                --remaining;
+            }
+        }
+    }
+
+    secure_zero(lanes, sizeof(lanes));
+    secure_zero(state, sizeof(state));
+}
+
+PYCPP_END_NAMESPACE
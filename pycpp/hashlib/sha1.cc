@@ -1,15 +1,28 @@
 //  :copyright: (c) Steve Reid <steve@edmweb.com>.
 //  :copyright: (c) 2017 Alex Huszagh.
 //  :license: MIT, see licenses/mit.md for more details.
+/*
+ *  Blocks are compressed with the x86 SHA extensions (SHA-NI) when
+ *  the processor supports them, selected on first use, otherwise with
+ *  the portable implementation.
+ *
+ *  Batches of independent messages are hashed 8 at a time, one per
+ *  lane, with an AVX2 multi-buffer kernel.
+ */
 
 #include <pycpp/hashlib.h>
+#include <pycpp/hashlib/kernel.h>
 #include <pycpp/preprocessor/architecture.h>
+#include <pycpp/runtime/cpu.h>
 #include <pycpp/secure/stdlib.h>
 #include <pycpp/stl/stdexcept.h>
 #include <warnings/push.h>
 #include <warnings/narrowing-conversions.h>
 #include <stdio.h>
 #include <string.h>
+#if defined(HAVE_X86_SIMD)
+#   include <immintrin.h>
+#endif
 
 PYCPP_BEGIN_NAMESPACE
 
@@ -17,6 +30,7 @@ PYCPP_BEGIN_NAMESPACE
 // ---------
 
 constexpr size_t SHA1_HASH_SIZE = 20;
+static constexpr uint32_t SHA1_IV[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
 
 // UNIONS
 // ------
@@ -182,16 +196,254 @@ static void sha1_transform(uint32_t state[5], const uint8_t buffer[64]) noexcept
 }
 
 
+// KERNELS
+// -------
+
+// Each kernel compresses a run of consecutive 64-byte blocks
+// into the hash state.
+
+
+static void sha1_blocks_scalar(uint32_t* state, const uint8_t* data, size_t blocks)
+{
+    for (; blocks; --blocks, data += 64) {
+        sha1_transform(state, data);
+    }
+}
+
+#if defined(HAVE_X86_SIMD)              // HAVE_X86_SIMD
+
+/**
+ *  \brief Compress blocks with the x86 SHA extensions.
+ *
+ *  `sha1rnds4` performs 4 rounds, taking E pre-added to the message
+ *  words (`sha1nexte`). Each group of 4 message words is derived
+ *  from the previous 4 groups with `sha1msg1`, `sha1msg2` and XOR.
+ */
+SIMD_TARGET("sha,sse4.1")
+static void sha1_blocks_shani(uint32_t* state, const uint8_t* data, size_t blocks)
+{
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090A0B0C0D0E0FULL);
+
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) state), 0x1B);
+    __m128i e0 = _mm_set_epi32((int) state[4], 0, 0, 0);
+
+    for (; blocks; --blocks, data += 64) {
+        __m128i abcd_save = abcd;
+        __m128i e_save = e0;
+        __m128i msg[4];
+        __m128i e1 = abcd;
+
+        for (int i = 0; i < 20; ++i) {
+            __m128i& w = msg[i & 3];
+            if (i < 4) {
+                w = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 16 * i)), mask);
+            }
+
+            // E for this group, from A of 4 rounds earlier
+            if (i == 0) {
+                e0 = _mm_add_epi32(e0, w);
+            } else {
+                e0 = _mm_sha1nexte_epu32(e1, w);
+            }
+            e1 = abcd;
+
+            // message words for later groups
+            if (i >= 3) {
+                msg[(i + 1) & 3] = _mm_sha1msg2_epu32(msg[(i + 1) & 3], w);
+            }
+            if (i >= 2) {
+                msg[(i + 2) & 3] = _mm_xor_si128(msg[(i + 2) & 3], w);
+            }
+            if (i >= 1) {
+                msg[(i + 3) & 3] = _mm_sha1msg1_epu32(msg[(i + 3) & 3], w);
+            }
+
+            switch (i / 5) {
+                case 0:     abcd = _mm_sha1rnds4_epu32(abcd, e0, 0); break;
+                case 1:     abcd = _mm_sha1rnds4_epu32(abcd, e0, 1); break;
+                case 2:     abcd = _mm_sha1rnds4_epu32(abcd, e0, 2); break;
+                default:    abcd = _mm_sha1rnds4_epu32(abcd, e0, 3); break;
+            }
+        }
+
+        e0 = _mm_sha1nexte_epu32(e1, e_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+    }
+
+    _mm_storeu_si128((__m128i*) state, _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = (uint32_t) _mm_extract_epi32(e0, 3);
+}
+
+// MULTI-BUFFER
+
+/**
+ *  \brief Get the message word for round `t`.
+ */
+SIMD_TARGET("avx2")
+static inline __m256i sha1_w_x8(__m256i* W, int t)
+{
+    __m256i& w = W[t & 15];
+    if (t >= 16) {
+        __m256i x = _mm256_xor_si256(W[(t - 3) & 15], W[(t - 8) & 15]);
+        x = _mm256_xor_si256(x, _mm256_xor_si256(W[(t - 14) & 15], w));
+        w = multibuffer_rol_avx2(x, 1);
+    }
+    return w;
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m256i sha1_ch_x8(__m256i x, __m256i y, __m256i z)
+{
+    return _mm256_xor_si256(_mm256_and_si256(x, _mm256_xor_si256(y, z)), z);
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m256i sha1_parity_x8(__m256i x, __m256i y, __m256i z)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(x, y), z);
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m256i sha1_maj_x8(__m256i x, __m256i y, __m256i z)
+{
+    return _mm256_or_si256(_mm256_and_si256(_mm256_or_si256(x, y), z), _mm256_and_si256(x, y));
+}
+
+
+#define R_X8(f,k,v,w,x,y,z,t)                                                                   \
+    z = _mm256_add_epi32(z, _mm256_add_epi32(f(w, x, y), _mm256_add_epi32(sha1_w_x8(W, t), k))); \
+    z = _mm256_add_epi32(z, multibuffer_rol_avx2(v, 5));                                        \
+    w = multibuffer_rol_avx2(w, 30);
+
+
+#define R5_X8(f,k,t)                            \
+    R_X8(f, k, a, b, c, d, e, t);               \
+    R_X8(f, k, e, a, b, c, d, t + 1);           \
+    R_X8(f, k, d, e, a, b, c, t + 2);           \
+    R_X8(f, k, c, d, e, a, b, t + 3);           \
+    R_X8(f, k, b, c, d, e, a, t + 4);
+
+
+/**
+ *  \brief Compress one block for each of 8 independent messages.
+ */
+SIMD_TARGET("avx2")
+static void sha1_x8_avx2(uint32_t (*state)[MULTIBUFFER_LANES], const uint8_t* const* blocks)
+{
+    const __m256i mask = _mm256_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL, 0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+    const __m256i k0 = _mm256_set1_epi32(0x5A827999);
+    const __m256i k1 = _mm256_set1_epi32(0x6ED9EBA1);
+    const __m256i k2 = _mm256_set1_epi32((int) 0x8F1BBCDC);
+    const __m256i k3 = _mm256_set1_epi32((int) 0xCA62C1D6);
+
+    __m256i W[16];
+    multibuffer_load_avx2(blocks, W);
+    for (int i = 0; i < 16; ++i) {
+        W[i] = _mm256_shuffle_epi8(W[i], mask);
+    }
+
+    __m256i v[5];
+    for (int i = 0; i < 5; ++i) {
+        v[i] = _mm256_loadu_si256((const __m256i*) state[i]);
+    }
+    __m256i a = v[0], b = v[1], c = v[2], d = v[3], e = v[4];
+
+    for (int t = 0; t < 20; t += 5) {
+        R5_X8(sha1_ch_x8, k0, t);
+    }
+    for (int t = 20; t < 40; t += 5) {
+        R5_X8(sha1_parity_x8, k1, t);
+    }
+    for (int t = 40; t < 60; t += 5) {
+        R5_X8(sha1_maj_x8, k2, t);
+    }
+    for (int t = 60; t < 80; t += 5) {
+        R5_X8(sha1_parity_x8, k3, t);
+    }
+
+    __m256i r[5] = {a, b, c, d, e};
+    for (int i = 0; i < 5; ++i) {
+        _mm256_storeu_si256((__m256i*) state[i], _mm256_add_epi32(v[i], r[i]));
+    }
+}
+
+#undef R_X8
+#undef R5_X8
+
+#endif                                  // HAVE_X86_SIMD
+
+
+#if defined(HAVE_X86_SIMD)              // HAVE_X86_SIMD
+
+static bool sha1_shani_supported()
+{
+    return cpu_supports(cpu_sha) && cpu_supports(cpu_sse41) && cpu_supports(cpu_ssse3);
+}
+
+
+static bool sha1_avx2_supported()
+{
+    return cpu_supports(cpu_avx2);
+}
+
+#endif                                  // HAVE_X86_SIMD
+
+static const hash_kernel<sha1_blocks_t> SHA1_KERNELS[] = {
+#if defined(HAVE_X86_SIMD)
+    {"shani", sha1_blocks_shani, sha1_shani_supported},
+#endif
+    {"scalar", sha1_blocks_scalar, hash_kernel_portable},
+};
+
+// 8 lanes of AVX2 outperform SHA-NI on one message at a time
+static const hash_kernel<multibuffer_kernel_t> SHA1_BATCH_KERNELS[] = {
+#if defined(HAVE_X86_SIMD)
+    {"avx2", sha1_x8_avx2, sha1_avx2_supported},
+#endif
+    {"serial", nullptr, hash_kernel_portable},
+};
+
+
+hash_kernel_table<sha1_blocks_t> sha1_kernels() noexcept
+{
+    return {begin(SHA1_KERNELS), end(SHA1_KERNELS)};
+}
+
+
+hash_kernel_table<multibuffer_kernel_t> sha1_batch_kernels() noexcept
+{
+    return {begin(SHA1_BATCH_KERNELS), end(SHA1_BATCH_KERNELS)};
+}
+
+
+sha1_blocks_t& sha1_kernel() noexcept
+{
+    static sha1_blocks_t kernel = hash_kernel_select(sha1_kernels());
+    return kernel;
+}
+
+
+multibuffer_kernel_t& sha1_batch_kernel() noexcept
+{
+    static multibuffer_kernel_t kernel = hash_kernel_select(sha1_batch_kernels());
+    return kernel;
+}
+
+
+static void sha1_blocks(uint32_t* state, const uint8_t* data, size_t blocks)
+{
+    sha1_kernel()(state, data, blocks);
+}
+
 /**
  *  \brief Initialize SHA1 context.
  */
 static void sha1_init(sha1_context* ctx) noexcept
 {
-    ctx->state[0] = 0x67452301;
-    ctx->state[1] = 0xefcdab89;
-    ctx->state[2] = 0x98badcfe;
-    ctx->state[3] = 0x10325476;
-    ctx->state[4] = 0xc3d2e1f0;
+    memcpy(ctx->state, SHA1_IV, sizeof(ctx->state));
     ctx->count[0] = ctx->count[1] = 0;
 }
 
@@ -213,10 +465,10 @@ static void sha1_update(void* ptr, const void* buf, size_t len) noexcept
     j = (j >> 3) & 63;
     if ((j + len) > 63) {
         memcpy(&ctx->buffer[j], data, (i = 64-j));
-        sha1_transform(ctx->state, ctx->buffer);
-        for ( ; i + 63 < len; i += 64) {
-            sha1_transform(ctx->state, &data[i]);
-        }
+        sha1_blocks(ctx->state, ctx->buffer, 1);
+        size_t blocks = (len - i) / 64;
+        sha1_blocks(ctx->state, &data[i], blocks);
+        i += blocks * 64;
         j = 0;
     }
     else i = 0;
@@ -234,67 +486,104 @@ static void sha1_final(void* ptr, void* buf) noexcept
 
     unsigned i;
     uint8_t finalcount[8];
-    uint8_t c;
 
     for (i = 0; i < 8; i++) {
         finalcount[i] = (uint8_t)((ctx->count[(i >= 4 ? 0 : 1)]
          >> ((3-(i & 3)) * 8) ) & 255);  /* Endian independent */
     }
 
-    c = 0200;
-    sha1_update(ctx, &c, 1);
-    while ((ctx->count[0] & 504) != 448) {
-        c = 0000;
-        sha1_update(ctx, &c, 1);
-    }
+    // pad with 0x80 and zeros up to 56 bytes mod 64
+    static const uint8_t padding[64] = {0x80};
+    size_t used = (ctx->count[0] >> 3) & 63;
+    sha1_update(ctx, padding, ((119 - used) & 63) + 1);
     sha1_update(ctx, finalcount, 8);
     for (i = 0; i < 20; i++) {
         digest[i] = (uint8_t) ((ctx->state[i>>2] >> ((3-(i & 3)) * 8) ) & 255);
     }
 
     secure_zero(&i, sizeof(i));
-    secure_zero(&c, sizeof(c));
     secure_zero(finalcount, sizeof(finalcount));
     secure_zero(ctx, sizeof(*ctx));
 }
 
 
+// BATCH
+// -----
+
+
+template <typename Messages>
+static void sha1_batch(const Messages& messages, size_t count, void* dst) noexcept
+{
+    multibuffer_kernel_t kernel = sha1_batch_kernel();
+    auto* digest = (uint8_t*) dst;
+
+    if (kernel) {
+        multibuffer_hash hash = {kernel, SHA1_IV, 5, SHA1_HASH_SIZE, true};
+        multibuffer_digest(hash, messages, count, digest);
+    } else {
+        sha1_context ctx;
+        for (size_t i = 0; i < count; ++i) {
+            sha1_init(&ctx);
+            hash_update(&ctx, messages.data(i), messages.size(i), sha1_update);
+            sha1_final(&ctx, digest + i * SHA1_HASH_SIZE);
+        }
+    }
+}
+
+
+void sha1_digest_batch(const void* const* src, const size_t* srclen, size_t count, void* dst) noexcept
+{
+    sha1_batch(multibuffer_arrays {src, srclen}, count, dst);
+}
+
+
+void sha1_digest_batch(const string_wrapper* str, size_t count, void* dst) noexcept
+{
+    sha1_batch(multibuffer_strings {str}, count, dst);
+}
+
 // OBJECTS
 // -------
 
 
-sha1_hash::sha1_hash():
-    ctx(make_unique<sha1_context>())
+constexpr size_t sha1_hash::digest_size;
+
+
+sha1_hash::sha1_hash()
 {
-    sha1_init(ctx.get());
+    sha1_init(&ctx.get());
 }
 
 
-sha1_hash::sha1_hash(const void* src, size_t srclen):
-    ctx(make_unique<sha1_context>())
+sha1_hash::sha1_hash(const void* src, size_t srclen)
 {
-    sha1_init(ctx.get());
+    sha1_init(&ctx.get());
     update(src, srclen);
 }
 
 
-sha1_hash::sha1_hash(const string_wrapper& str):
-    ctx(make_unique<sha1_context>())
+sha1_hash::sha1_hash(const string_wrapper& str)
 {
-    sha1_init(ctx.get());
+    sha1_init(&ctx.get());
     update(str);
 }
 
 
+sha1_hash::sha1_hash(sha1_hash&&) noexcept = default;
+
+
+sha1_hash& sha1_hash::operator=(sha1_hash&&) noexcept = default;
+
+
 sha1_hash::~sha1_hash() noexcept
 {
-    secure_zero(ctx.get(), sizeof(*ctx));
+    secure_zero(&ctx.get(), sizeof(*ctx));
 }
 
 
 void sha1_hash::update(const void* src, size_t srclen) noexcept
 {
-    hash_update(ctx.get(), src, srclen, sha1_update);
+    hash_update(&ctx.get(), src, srclen, sha1_update);
 }
 
 
@@ -332,6 +621,20 @@ secure_string sha1_hash::hexdigest() const
 }
 
 
+void sha1_hash::digest_into(digest_type& dst) const noexcept
+{
+    sha1_context copy = *ctx;
+    sha1_final(&copy, dst.data());
+}
+
+
+void sha1_hash::hexdigest_into(char* dst) const noexcept
+{
+    sha1_context copy = *ctx;
+    hash_hexdigest_into(&copy, dst, SHA1_HASH_SIZE, sha1_final);
+}
+
+
 void sha1_hash::swap(sha1_hash& rhs) noexcept
 {
     using PYCPP_NAMESPACE::swap;
@@ -3,15 +3,29 @@
 //  :license: MIT, see licenses/mit.md for more details.
 /*
  *  [reference] https://github.com/rhash/RHash
+ *
+ *  Blocks are compressed by the fastest kernel the processor supports,
+ *  selected on first use: the x86 SHA extensions (SHA-NI), an AVX2
+ *  kernel that computes the message schedule 4 words at a time and
+ *  uses non-destructive BMI2 rotates for the rounds, or the portable
+ *  implementation.
+ *
+ *  Batches of independent messages are hashed 8 at a time, one per
+ *  lane, with an AVX2 multi-buffer kernel.
  */
 
 #include <pycpp/hashlib.h>
+#include <pycpp/hashlib/kernel.h>
 #include <pycpp/preprocessor/architecture.h>
 #include <pycpp/preprocessor/byteorder.h>
 #include <pycpp/preprocessor/processor.h>
+#include <pycpp/runtime/cpu.h>
 #include <pycpp/secure/stdlib.h>
 #include <pycpp/stl/stdexcept.h>
 #include <string.h>
+#if defined(HAVE_X86_SIMD)
+#   include <immintrin.h>
+#endif
 
 PYCPP_BEGIN_NAMESPACE
 
@@ -21,6 +35,13 @@ PYCPP_BEGIN_NAMESPACE
 static constexpr size_t SHA224_HASH_SIZE = 28;
 static constexpr size_t SHA256_HASH_SIZE = 32;
 static constexpr size_t SHA256_BLOCK_SIZE = 64;
+/* Initial values. These words were obtained by taking the first 32
+ * bits of the fractional parts of the square roots of the first
+ * eight prime numbers. */
+static constexpr uint32_t SHA256_H0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
 static constexpr uint32_t ENCODE[] = {0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2};
 
 // OBJECTS
@@ -32,7 +53,7 @@ static constexpr uint32_t ENCODE[] = {0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba
 struct sha2_256_context
 {
     uint64_t length;
-    uint32_t digest_length;
+    uint64_t digest_length;
     uint32_t message[16];
     uint32_t hash[8];
 };
@@ -118,6 +139,342 @@ static void sha256_process_block(uint32_t* hash, uint32_t* block)
 }
 
 
+// KERNELS
+// -------
+
+// Each kernel compresses a run of consecutive 64-byte blocks,
+// which do not need to be aligned, into the hash state.
+
+
+static void sha256_blocks_scalar(uint32_t* hash, const uint8_t* data, size_t blocks)
+{
+    uint32_t block[16];
+    for (; blocks; --blocks, data += SHA256_BLOCK_SIZE) {
+        if (IS_ALIGNED_32(data)) {
+            sha256_process_block(hash, (uint32_t*) data);
+        } else {
+            memcpy(block, data, SHA256_BLOCK_SIZE);
+            sha256_process_block(hash, block);
+        }
+    }
+}
+
+#if defined(HAVE_X86_SIMD)              // HAVE_X86_SIMD
+
+// SHA-NI
+
+/**
+ *  \brief Compress blocks with the x86 SHA extensions.
+ *
+ *  The state is kept as {A, B, E, F} and {C, D, G, H}, the layout
+ *  expected by `sha256rnds2`, which performs 2 rounds. Each group of
+ *  4 message words is derived from the previous 4 groups with
+ *  `sha256msg1` and `sha256msg2`.
+ */
+SIMD_TARGET("sha,sse4.1")
+static void sha256_blocks_shani(uint32_t* hash, const uint8_t* data, size_t blocks)
+{
+    const __m128i mask = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+
+    // DCBA, HGFE -> ABEF, CDGH
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) &hash[0]), 0xB1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) &hash[4]), 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    for (; blocks; --blocks, data += SHA256_BLOCK_SIZE) {
+        __m128i abef = state0;
+        __m128i cdgh = state1;
+        __m128i msg[4];
+
+        for (int i = 0; i < 16; ++i) {
+            __m128i& w = msg[i & 3];
+            if (i < 4) {
+                w = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 16 * i)), mask);
+            } else {
+                __m128i w7 = _mm_alignr_epi8(msg[(i - 1) & 3], msg[(i - 2) & 3], 4);
+                w = _mm_sha256msg1_epu32(w, msg[(i - 3) & 3]);
+                w = _mm_sha256msg2_epu32(_mm_add_epi32(w, w7), msg[(i - 1) & 3]);
+            }
+
+            __m128i wk = _mm_add_epi32(w, _mm_loadu_si128((const __m128i*) &ENCODE[4 * i]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(wk, 0x0E));
+        }
+
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    // ABEF, CDGH -> DCBA, HGFE
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128((__m128i*) &hash[0], state0);
+    _mm_storeu_si128((__m128i*) &hash[4], state1);
+}
+
+// AVX2
+
+SIMD_TARGET("avx2")
+static inline __m128i sha256_ror_avx2(__m128i x, int n)
+{
+    return _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - n));
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m128i sha256_sigma0_avx2(__m128i x)
+{
+    return _mm_xor_si128(_mm_xor_si128(sha256_ror_avx2(x, 7), sha256_ror_avx2(x, 18)), _mm_srli_epi32(x, 3));
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m128i sha256_sigma1_avx2(__m128i x)
+{
+    return _mm_xor_si128(_mm_xor_si128(sha256_ror_avx2(x, 17), sha256_ror_avx2(x, 19)), _mm_srli_epi32(x, 10));
+}
+
+
+/**
+ *  \brief Compress blocks with a vectorized message schedule.
+ *
+ *  The 64 message words, plus round constants, are computed 4 at a
+ *  time before the rounds. Since `W[t+2]` and `W[t+3]` depend on
+ *  `W[t]` and `W[t+1]`, the `sigma1` term is added in two halves.
+ */
+SIMD_TARGET("avx2,bmi2")
+static void sha256_blocks_avx2(uint32_t* hash, const uint8_t* data, size_t blocks)
+{
+    const __m128i mask = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+    uint32_t W[64];
+    uint32_t WK[64];
+
+    for (; blocks; --blocks, data += SHA256_BLOCK_SIZE) {
+        for (int t = 0; t < 16; t += 4) {
+            __m128i w = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 4 * t)), mask);
+            _mm_storeu_si128((__m128i*) &W[t], w);
+            _mm_storeu_si128((__m128i*) &WK[t], _mm_add_epi32(w, _mm_loadu_si128((const __m128i*) &ENCODE[t])));
+        }
+        for (int t = 16; t < 64; t += 4) {
+            __m128i w16 = _mm_loadu_si128((const __m128i*) &W[t - 16]);
+            __m128i w15 = _mm_loadu_si128((const __m128i*) &W[t - 15]);
+            __m128i w7 = _mm_loadu_si128((const __m128i*) &W[t - 7]);
+            __m128i w = _mm_add_epi32(_mm_add_epi32(w16, w7), sha256_sigma0_avx2(w15));
+
+            // W[t], W[t+1] from W[t-2], W[t-1], then W[t+2], W[t+3]
+            __m128i w2 = _mm_loadl_epi64((const __m128i*) &W[t - 2]);
+            w = _mm_add_epi32(w, sha256_sigma1_avx2(w2));
+            w = _mm_add_epi32(w, _mm_slli_si128(sha256_sigma1_avx2(w), 8));
+
+            _mm_storeu_si128((__m128i*) &W[t], w);
+            _mm_storeu_si128((__m128i*) &WK[t], _mm_add_epi32(w, _mm_loadu_si128((const __m128i*) &ENCODE[t])));
+        }
+
+        uint32_t A = hash[0], B = hash[1], C = hash[2], D = hash[3];
+        uint32_t E = hash[4], F = hash[5], G = hash[6], H = hash[7];
+        for (int t = 0; t < 64; t += 8) {
+            ROUND(A, B, C, D, E, F, G, H, 0, WK[t]);
+            ROUND(H, A, B, C, D, E, F, G, 0, WK[t + 1]);
+            ROUND(G, H, A, B, C, D, E, F, 0, WK[t + 2]);
+            ROUND(F, G, H, A, B, C, D, E, 0, WK[t + 3]);
+            ROUND(E, F, G, H, A, B, C, D, 0, WK[t + 4]);
+            ROUND(D, E, F, G, H, A, B, C, 0, WK[t + 5]);
+            ROUND(C, D, E, F, G, H, A, B, 0, WK[t + 6]);
+            ROUND(B, C, D, E, F, G, H, A, 0, WK[t + 7]);
+        }
+        hash[0] += A, hash[1] += B, hash[2] += C, hash[3] += D;
+        hash[4] += E, hash[5] += F, hash[6] += G, hash[7] += H;
+    }
+}
+
+// MULTI-BUFFER
+
+SIMD_TARGET("avx2")
+static inline __m256i sha256_ror_x8(__m256i x, int n)
+{
+    return multibuffer_rol_avx2(x, 32 - n);
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m256i sha256_Sigma0_x8(__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(sha256_ror_x8(x, 2), sha256_ror_x8(x, 13)), sha256_ror_x8(x, 22));
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m256i sha256_Sigma1_x8(__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(sha256_ror_x8(x, 6), sha256_ror_x8(x, 11)), sha256_ror_x8(x, 25));
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m256i sha256_sigma0_x8(__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(sha256_ror_x8(x, 7), sha256_ror_x8(x, 18)), _mm256_srli_epi32(x, 3));
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m256i sha256_sigma1_x8(__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(sha256_ror_x8(x, 17), sha256_ror_x8(x, 19)), _mm256_srli_epi32(x, 10));
+}
+
+
+/**
+ *  \brief Get the message word plus round constant for round `t`.
+ */
+SIMD_TARGET("avx2")
+static inline __m256i sha256_wk_x8(__m256i* W, int t)
+{
+    __m256i& w = W[t & 15];
+    if (t >= 16) {
+        __m256i sum = _mm256_add_epi32(sha256_sigma1_x8(W[(t - 2) & 15]), W[(t - 7) & 15]);
+        w = _mm256_add_epi32(w, _mm256_add_epi32(sum, sha256_sigma0_x8(W[(t - 15) & 15])));
+    }
+    return _mm256_add_epi32(w, _mm256_set1_epi32(ENCODE[t]));
+}
+
+
+#define ROUND_X8(a,b,c,d,e,f,g,h,t) {                                                   \
+    __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));   \
+    __m256i maj = _mm256_xor_si256(_mm256_and_si256(a, b),                              \
+        _mm256_and_si256(c, _mm256_xor_si256(a, b)));                                   \
+    __m256i T1 = _mm256_add_epi32(_mm256_add_epi32(h, sha256_Sigma1_x8(e)),            \
+        _mm256_add_epi32(ch, sha256_wk_x8(W, t)));                                      \
+    d = _mm256_add_epi32(d, T1);                                                        \
+    h = _mm256_add_epi32(T1, _mm256_add_epi32(sha256_Sigma0_x8(a), maj)); }
+
+
+/**
+ *  \brief Compress one block for each of 8 independent messages.
+ */
+SIMD_TARGET("avx2")
+static void sha256_x8_avx2(uint32_t (*state)[MULTIBUFFER_LANES], const uint8_t* const* blocks)
+{
+    const __m256i mask = _mm256_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL, 0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+    __m256i W[16];
+    multibuffer_load_avx2(blocks, W);
+    for (int i = 0; i < 16; ++i) {
+        W[i] = _mm256_shuffle_epi8(W[i], mask);
+    }
+
+    __m256i v[8];
+    for (int i = 0; i < 8; ++i) {
+        v[i] = _mm256_loadu_si256((const __m256i*) state[i]);
+    }
+    __m256i A = v[0], B = v[1], C = v[2], D = v[3];
+    __m256i E = v[4], F = v[5], G = v[6], H = v[7];
+
+    for (int t = 0; t < 64; t += 8) {
+        ROUND_X8(A, B, C, D, E, F, G, H, t);
+        ROUND_X8(H, A, B, C, D, E, F, G, t + 1);
+        ROUND_X8(G, H, A, B, C, D, E, F, t + 2);
+        ROUND_X8(F, G, H, A, B, C, D, E, t + 3);
+        ROUND_X8(E, F, G, H, A, B, C, D, t + 4);
+        ROUND_X8(D, E, F, G, H, A, B, C, t + 5);
+        ROUND_X8(C, D, E, F, G, H, A, B, t + 6);
+        ROUND_X8(B, C, D, E, F, G, H, A, t + 7);
+    }
+
+    __m256i r[8] = {A, B, C, D, E, F, G, H};
+    for (int i = 0; i < 8; ++i) {
+        _mm256_storeu_si256((__m256i*) state[i], _mm256_add_epi32(v[i], r[i]));
+    }
+}
+
+#undef ROUND_X8
+
+#endif                                  // HAVE_X86_SIMD
+
+
+#if defined(HAVE_X86_SIMD)              // HAVE_X86_SIMD
+
+static bool sha256_shani_supported()
+{
+    return cpu_supports(cpu_sha) && cpu_supports(cpu_sse41) && cpu_supports(cpu_ssse3);
+}
+
+
+static bool sha256_avx2_supported()
+{
+    return cpu_supports(cpu_avx2) && cpu_supports(cpu_bmi2);
+}
+
+
+static bool sha256_x8_supported()
+{
+    return cpu_supports(cpu_avx2);
+}
+
+#endif                                  // HAVE_X86_SIMD
+
+static const hash_kernel<sha256_blocks_t> SHA256_KERNELS[] = {
+#if defined(HAVE_X86_SIMD)
+    {"shani", sha256_blocks_shani, sha256_shani_supported},
+    {"avx2", sha256_blocks_avx2, sha256_avx2_supported},
+#endif
+    {"scalar", sha256_blocks_scalar, hash_kernel_portable},
+};
+
+static const hash_kernel<multibuffer_kernel_t> SHA256_BATCH_KERNELS[] = {
+#if defined(HAVE_X86_SIMD)
+    {"avx2", sha256_x8_avx2, sha256_x8_supported},
+#endif
+    {"serial", nullptr, hash_kernel_portable},
+};
+
+
+hash_kernel_table<sha256_blocks_t> sha256_kernels() noexcept
+{
+    return {begin(SHA256_KERNELS), end(SHA256_KERNELS)};
+}
+
+
+hash_kernel_table<multibuffer_kernel_t> sha256_batch_kernels() noexcept
+{
+    return {begin(SHA256_BATCH_KERNELS), end(SHA256_BATCH_KERNELS)};
+}
+
+
+sha256_blocks_t& sha256_kernel() noexcept
+{
+    static sha256_blocks_t kernel = hash_kernel_select(sha256_kernels());
+    return kernel;
+}
+
+
+static multibuffer_kernel_t select_sha256_x8()
+{
+#if defined(HAVE_X86_SIMD)
+    // SHA-NI on one message at a time matches 8 lanes of AVX2
+    if (sha256_shani_supported()) {
+        return nullptr;
+    }
+#endif
+
+    return hash_kernel_select(sha256_batch_kernels());
+}
+
+
+multibuffer_kernel_t& sha256_batch_kernel() noexcept
+{
+    static multibuffer_kernel_t kernel = select_sha256_x8();
+    return kernel;
+}
+
+
+static void sha256_blocks(uint32_t* hash, const uint8_t* data, size_t blocks)
+{
+    sha256_kernel()(hash, data, blocks);
+}
+
 static void sha224_init(sha2_256_context* ctx)
 {
     /* Initial values from FIPS 180-3. These words were obtained by taking
@@ -137,14 +494,6 @@ static void sha224_init(sha2_256_context* ctx)
 
 static void sha256_init(sha2_256_context* ctx)
 {
-    /* Initial values. These words were obtained by taking the first 32
-     * bits of the fractional parts of the square roots of the first
-     * eight prime numbers. */
-    static const uint32_t SHA256_H0[8] = {
-        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
-        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
-    };
-
     ctx->length = 0;
     ctx->digest_length = SHA256_HASH_SIZE;
 
@@ -174,24 +523,15 @@ static void sha256_update(void* ptr, const void* buf, size_t len)
         }
 
         // process partial block
-        sha256_process_block(ctx->hash, (uint32_t*)ctx->message);
+        sha256_blocks(ctx->hash, (const uint8_t*)ctx->message, 1);
         msg  += left;
         len -= left;
     }
-    while (len >= SHA256_BLOCK_SIZE) {
-        uint32_t* aligned_message_block;
-        if (IS_ALIGNED_32(msg)) {
-            /* the most common case is processing of an already aligned message
-            without copying it */
-            aligned_message_block = (uint32_t*)msg;
-        } else {
-            memcpy(ctx->message, msg, SHA256_BLOCK_SIZE);
-            aligned_message_block = (uint32_t*)ctx->message;
-        }
-
-        sha256_process_block(ctx->hash, aligned_message_block);
-        msg  += SHA256_BLOCK_SIZE;
-        len -= SHA256_BLOCK_SIZE;
+    if (len >= SHA256_BLOCK_SIZE) {
+        size_t blocks = len / SHA256_BLOCK_SIZE;
+        sha256_blocks(ctx->hash, msg, blocks);
+        msg += blocks * SHA256_BLOCK_SIZE;
+        len -= blocks * SHA256_BLOCK_SIZE;
     }
     if (len) {
         memcpy(ctx->message, msg, len); /* save leftovers */
@@ -222,7 +562,7 @@ static void sha256_final(void* ptr, void* buf)
         while (index < 16) {
             ctx->message[index++] = 0;
         }
-        sha256_process_block(ctx->hash, ctx->message);
+        sha256_blocks(ctx->hash, (const uint8_t*)ctx->message, 1);
         index = 0;
     }
     while (index < 14) {
@@ -230,7 +570,7 @@ static void sha256_final(void* ptr, void* buf)
     }
     ctx->message[14] = be32toh( (unsigned)(ctx->length >> 29) );
     ctx->message[15] = be32toh( (unsigned)(ctx->length << 3) );
-    sha256_process_block(ctx->hash, ctx->message);
+    sha256_blocks(ctx->hash, (const uint8_t*)ctx->message, 1);
 
     if (result) {
         memcpy_be32toh(result, ctx->hash, ctx->digest_length);
@@ -242,42 +582,83 @@ static void sha256_final(void* ptr, void* buf)
 }
 
 
+// BATCH
+// -----
+
+
+template <typename Messages>
+static void sha256_batch(const Messages& messages, size_t count, void* dst) noexcept
+{
+    multibuffer_kernel_t kernel = sha256_batch_kernel();
+    auto* digest = (uint8_t*) dst;
+
+    if (kernel) {
+        multibuffer_hash hash = {kernel, SHA256_H0, 8, SHA256_HASH_SIZE, true};
+        multibuffer_digest(hash, messages, count, digest);
+    } else {
+        sha2_256_context ctx;
+        for (size_t i = 0; i < count; ++i) {
+            sha256_init(&ctx);
+            hash_update(&ctx, messages.data(i), messages.size(i), sha256_update);
+            sha256_final(&ctx, digest + i * SHA256_HASH_SIZE);
+        }
+    }
+}
+
+
+void sha2_256_digest_batch(const void* const* src, const size_t* srclen, size_t count, void* dst) noexcept
+{
+    sha256_batch(multibuffer_arrays {src, srclen}, count, dst);
+}
+
+
+void sha2_256_digest_batch(const string_wrapper* str, size_t count, void* dst) noexcept
+{
+    sha256_batch(multibuffer_strings {str}, count, dst);
+}
+
 // OBJECTS
 // -------
 
 
-sha2_224_hash::sha2_224_hash():
-    ctx(make_unique<sha2_256_context>())
+constexpr size_t sha2_224_hash::digest_size;
+
+
+sha2_224_hash::sha2_224_hash()
 {
-    sha224_init(ctx.get());
+    sha224_init(&ctx.get());
 }
 
 
-sha2_224_hash::sha2_224_hash(const void* src, size_t srclen):
-    ctx(make_unique<sha2_256_context>())
+sha2_224_hash::sha2_224_hash(const void* src, size_t srclen)
 {
-    sha224_init(ctx.get());
+    sha224_init(&ctx.get());
     update(src, srclen);
 }
 
 
-sha2_224_hash::sha2_224_hash(const string_wrapper& str):
-    ctx(make_unique<sha2_256_context>())
+sha2_224_hash::sha2_224_hash(const string_wrapper& str)
 {
-    sha224_init(ctx.get());
+    sha224_init(&ctx.get());
     update(str);
 }
 
 
+sha2_224_hash::sha2_224_hash(sha2_224_hash&&) noexcept = default;
+
+
+sha2_224_hash& sha2_224_hash::operator=(sha2_224_hash&&) noexcept = default;
+
+
 sha2_224_hash::~sha2_224_hash() noexcept
 {
-    secure_zero(ctx.get(), sizeof(*ctx));
+    secure_zero(&ctx.get(), sizeof(*ctx));
 }
 
 
 void sha2_224_hash::update(const void* src, size_t srclen) noexcept
 {
-    hash_update(ctx.get(), src, srclen, sha256_update);
+    hash_update(&ctx.get(), src, srclen, sha256_update);
 }
 
 
@@ -315,6 +696,20 @@ secure_string sha2_224_hash::hexdigest() const
 }
 
 
+void sha2_224_hash::digest_into(digest_type& dst) const noexcept
+{
+    sha2_256_context copy = *ctx;
+    sha256_final(&copy, dst.data());
+}
+
+
+void sha2_224_hash::hexdigest_into(char* dst) const noexcept
+{
+    sha2_256_context copy = *ctx;
+    hash_hexdigest_into(&copy, dst, SHA224_HASH_SIZE, sha256_final);
+}
+
+
 void sha2_224_hash::swap(sha2_224_hash& rhs) noexcept
 {
     using PYCPP_NAMESPACE::swap;
@@ -322,38 +717,44 @@ void sha2_224_hash::swap(sha2_224_hash& rhs) noexcept
 }
 
 
-sha2_256_hash::sha2_256_hash():
-    ctx(make_unique<sha2_256_context>())
+constexpr size_t sha2_256_hash::digest_size;
+
+
+sha2_256_hash::sha2_256_hash()
 {
-    sha256_init(ctx.get());
+    sha256_init(&ctx.get());
 }
 
 
-sha2_256_hash::sha2_256_hash(const void* src, size_t srclen):
-    ctx(make_unique<sha2_256_context>())
+sha2_256_hash::sha2_256_hash(const void* src, size_t srclen)
 {
-    sha256_init(ctx.get());
+    sha256_init(&ctx.get());
     update(src, srclen);
 }
 
 
-sha2_256_hash::sha2_256_hash(const string_wrapper& str):
-    ctx(make_unique<sha2_256_context>())
+sha2_256_hash::sha2_256_hash(const string_wrapper& str)
 {
-    sha256_init(ctx.get());
+    sha256_init(&ctx.get());
     update(str);
 }
 
 
+sha2_256_hash::sha2_256_hash(sha2_256_hash&&) noexcept = default;
+
+
+sha2_256_hash& sha2_256_hash::operator=(sha2_256_hash&&) noexcept = default;
+
+
 sha2_256_hash::~sha2_256_hash() noexcept
 {
-    secure_zero(ctx.get(), sizeof(*ctx));
+    secure_zero(&ctx.get(), sizeof(*ctx));
 }
 
 
 void sha2_256_hash::update(const void* src, size_t srclen) noexcept
 {
-    hash_update(ctx.get(), src, srclen, sha256_update);
+    hash_update(&ctx.get(), src, srclen, sha256_update);
 }
 
 
@@ -391,6 +792,20 @@ secure_string sha2_256_hash::hexdigest() const
 }
 
 
+void sha2_256_hash::digest_into(digest_type& dst) const noexcept
+{
+    sha2_256_context copy = *ctx;
+    sha256_final(&copy, dst.data());
+}
+
+
+void sha2_256_hash::hexdigest_into(char* dst) const noexcept
+{
+    sha2_256_context copy = *ctx;
+    hash_hexdigest_into(&copy, dst, SHA256_HASH_SIZE, sha256_final);
+}
+
+
 void sha2_256_hash::swap(sha2_256_hash& rhs) noexcept
 {
     using PYCPP_NAMESPACE::swap;
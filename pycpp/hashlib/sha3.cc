@@ -336,38 +336,44 @@ void sha3_final(void* ptr, void* buf) noexcept
 
 
 
-sha3_224_hash::sha3_224_hash():
-    ctx(make_unique<sha3_context>())
+constexpr size_t sha3_224_hash::digest_size;
+
+
+sha3_224_hash::sha3_224_hash()
 {
-    sha3_224_init(ctx.get());
+    sha3_224_init(&ctx.get());
 }
 
 
-sha3_224_hash::sha3_224_hash(const void* src, size_t srclen):
-    ctx(make_unique<sha3_context>())
+sha3_224_hash::sha3_224_hash(const void* src, size_t srclen)
 {
-    sha3_224_init(ctx.get());
+    sha3_224_init(&ctx.get());
     update(src, srclen);
 }
 
 
-sha3_224_hash::sha3_224_hash(const string_wrapper& str):
-    ctx(make_unique<sha3_context>())
+sha3_224_hash::sha3_224_hash(const string_wrapper& str)
 {
-    sha3_224_init(ctx.get());
+    sha3_224_init(&ctx.get());
     update(str);
 }
 
 
+sha3_224_hash::sha3_224_hash(sha3_224_hash&&) noexcept = default;
+
+
+sha3_224_hash& sha3_224_hash::operator=(sha3_224_hash&&) noexcept = default;
+
+
 sha3_224_hash::~sha3_224_hash() noexcept
 {
-    secure_zero(ctx.get(), sizeof(*ctx));
+    secure_zero(&ctx.get(), sizeof(*ctx));
 }
 
 
 void sha3_224_hash::update(const void* src, size_t srclen) noexcept
 {
-    hash_update(ctx.get(), src, srclen, sha3_update);
+    hash_update(&ctx.get(), src, srclen, sha3_update);
 }
 
 
@@ -405,6 +411,20 @@ secure_string sha3_224_hash::hexdigest() const
 }
 
 
+void sha3_224_hash::digest_into(digest_type& dst) const noexcept
+{
+    sha3_context copy = *ctx;
+    sha3_final(&copy, dst.data());
+}
+
+
+void sha3_224_hash::hexdigest_into(char* dst) const noexcept
+{
+    sha3_context copy = *ctx;
+    hash_hexdigest_into(&copy, dst, SHA3_224_HASH_SIZE, sha3_final);
+}
+
+
 void sha3_224_hash::swap(sha3_224_hash& rhs) noexcept
 {
     using PYCPP_NAMESPACE::swap;
@@ -412,38 +432,44 @@ void sha3_224_hash::swap(sha3_224_hash& rhs) noexcept
 }
 
 
-sha3_256_hash::sha3_256_hash():
-    ctx(make_unique<sha3_context>())
+constexpr size_t sha3_256_hash::digest_size;
+
+
+sha3_256_hash::sha3_256_hash()
 {
-    sha3_256_init(ctx.get());
+    sha3_256_init(&ctx.get());
 }
 
 
-sha3_256_hash::sha3_256_hash(const void* src, size_t srclen):
-    ctx(make_unique<sha3_context>())
+sha3_256_hash::sha3_256_hash(const void* src, size_t srclen)
 {
-    sha3_256_init(ctx.get());
+    sha3_256_init(&ctx.get());
     update(src, srclen);
 }
 
 
-sha3_256_hash::sha3_256_hash(const string_wrapper& str):
-    ctx(make_unique<sha3_context>())
+sha3_256_hash::sha3_256_hash(const string_wrapper& str)
 {
-    sha3_256_init(ctx.get());
+    sha3_256_init(&ctx.get());
     update(str);
 }
 
 
+sha3_256_hash::sha3_256_hash(sha3_256_hash&&) noexcept = default;
+
+
+sha3_256_hash& sha3_256_hash::operator=(sha3_256_hash&&) noexcept = default;
+
+
 sha3_256_hash::~sha3_256_hash() noexcept
 {
-    secure_zero(ctx.get(), sizeof(*ctx));
+    secure_zero(&ctx.get(), sizeof(*ctx));
 }
 
 
 void sha3_256_hash::update(const void* src, size_t srclen) noexcept
 {
-    hash_update(ctx.get(), src, srclen, sha3_update);
+    hash_update(&ctx.get(), src, srclen, sha3_update);
 }
 
 
@@ -481,6 +507,20 @@ secure_string sha3_256_hash::hexdigest() const
 }
 
 
+void sha3_256_hash::digest_into(digest_type& dst) const noexcept
+{
+    sha3_context copy = *ctx;
+    sha3_final(&copy, dst.data());
+}
+
+
+void sha3_256_hash::hexdigest_into(char* dst) const noexcept
+{
+    sha3_context copy = *ctx;
+    hash_hexdigest_into(&copy, dst, SHA3_256_HASH_SIZE, sha3_final);
+}
+
+
 void sha3_256_hash::swap(sha3_256_hash& rhs) noexcept
 {
     using PYCPP_NAMESPACE::swap;
@@ -488,38 +528,44 @@ void sha3_256_hash::swap(sha3_256_hash& rhs) noexcept
 }
 
 
-sha3_384_hash::sha3_384_hash():
-    ctx(make_unique<sha3_context>())
+constexpr size_t sha3_384_hash::digest_size;
+
+
+sha3_384_hash::sha3_384_hash()
 {
-    sha3_384_init(ctx.get());
+    sha3_384_init(&ctx.get());
 }
 
 
-sha3_384_hash::sha3_384_hash(const void* src, size_t srclen):
-    ctx(make_unique<sha3_context>())
+sha3_384_hash::sha3_384_hash(const void* src, size_t srclen)
 {
-    sha3_384_init(ctx.get());
+    sha3_384_init(&ctx.get());
     update(src, srclen);
 }
 
 
-sha3_384_hash::sha3_384_hash(const string_wrapper& str):
-    ctx(make_unique<sha3_context>())
+sha3_384_hash::sha3_384_hash(const string_wrapper& str)
 {
-    sha3_384_init(ctx.get());
+    sha3_384_init(&ctx.get());
     update(str);
 }
 
 
+sha3_384_hash::sha3_384_hash(sha3_384_hash&&) noexcept = default;
+
+
+sha3_384_hash& sha3_384_hash::operator=(sha3_384_hash&&) noexcept = default;
+
+
 sha3_384_hash::~sha3_384_hash() noexcept
 {
-    secure_zero(ctx.get(), sizeof(*ctx));
+    secure_zero(&ctx.get(), sizeof(*ctx));
 }
 
 
 void sha3_384_hash::update(const void* src, size_t srclen) noexcept
 {
-    hash_update(ctx.get(), src, srclen, sha3_update);
+    hash_update(&ctx.get(), src, srclen, sha3_update);
 }
 
 
@@ -557,6 +603,20 @@ secure_string sha3_384_hash::hexdigest() const
 }
 
 
+void sha3_384_hash::digest_into(digest_type& dst) const noexcept
+{
+    sha3_context copy = *ctx;
+    sha3_final(&copy, dst.data());
+}
+
+
+void sha3_384_hash::hexdigest_into(char* dst) const noexcept
+{
+    sha3_context copy = *ctx;
+    hash_hexdigest_into(&copy, dst, SHA3_384_HASH_SIZE, sha3_final);
+}
+
+
 void sha3_384_hash::swap(sha3_384_hash& rhs) noexcept
 {
     using PYCPP_NAMESPACE::swap;
@@ -564,38 +624,44 @@ void sha3_384_hash::swap(sha3_384_hash& rhs) noexcept
 }
 
 
-sha3_512_hash::sha3_512_hash():
-    ctx(make_unique<sha3_context>())
+constexpr size_t sha3_512_hash::digest_size;
+
+
+sha3_512_hash::sha3_512_hash()
 {
-    sha3_512_init(ctx.get());
+    sha3_512_init(&ctx.get());
 }
 
 
-sha3_512_hash::sha3_512_hash(const void* src, size_t srclen):
-    ctx(make_unique<sha3_context>())
+sha3_512_hash::sha3_512_hash(const void* src, size_t srclen)
 {
-    sha3_512_init(ctx.get());
+    sha3_512_init(&ctx.get());
     update(src, srclen);
 }
 
 
-sha3_512_hash::sha3_512_hash(const string_wrapper& str):
-    ctx(make_unique<sha3_context>())
+sha3_512_hash::sha3_512_hash(const string_wrapper& str)
 {
-    sha3_512_init(ctx.get());
+    sha3_512_init(&ctx.get());
     update(str);
 }
 
 
+sha3_512_hash::sha3_512_hash(sha3_512_hash&&) noexcept = default;
+
+
+sha3_512_hash& sha3_512_hash::operator=(sha3_512_hash&&) noexcept = default;
+
+
 sha3_512_hash::~sha3_512_hash() noexcept
 {
-    secure_zero(ctx.get(), sizeof(*ctx));
+    secure_zero(&ctx.get(), sizeof(*ctx));
 }
 
 
 void sha3_512_hash::update(const void* src, size_t srclen) noexcept
 {
-    hash_update(ctx.get(), src, srclen, sha3_update);
+    hash_update(&ctx.get(), src, srclen, sha3_update);
 }
 
 
@@ -633,6 +699,20 @@ secure_string sha3_512_hash::hexdigest() const
 }
 
 
+void sha3_512_hash::digest_into(digest_type& dst) const noexcept
+{
+    sha3_context copy = *ctx;
+    sha3_final(&copy, dst.data());
+}
+
+
+void sha3_512_hash::hexdigest_into(char* dst) const noexcept
+{
+    sha3_context copy = *ctx;
+    hash_hexdigest_into(&copy, dst, SHA3_512_HASH_SIZE, sha3_final);
+}
+
+
 void sha3_512_hash::swap(sha3_512_hash& rhs) noexcept
 {
     using PYCPP_NAMESPACE::swap;
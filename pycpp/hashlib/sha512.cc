@@ -3,14 +3,24 @@
 //  :license: MIT, see licenses/mit.md for more details.
 /*
  *  [reference] https://github.com/rhash/RHash
+ *
+ *  Blocks are compressed with an AVX2 kernel when the processor
+ *  supports it, selected on first use, which computes the message
+ *  schedule 4 words at a time and uses non-destructive BMI2 rotates
+ *  for the rounds. Otherwise, the portable implementation is used.
  */
 
 #include <pycpp/hashlib.h>
+#include <pycpp/hashlib/kernel.h>
 #include <pycpp/preprocessor/architecture.h>
 #include <pycpp/preprocessor/byteorder.h>
+#include <pycpp/runtime/cpu.h>
 #include <pycpp/secure/stdlib.h>
 #include <pycpp/stl/stdexcept.h>
 #include <string.h>
+#if defined(HAVE_X86_SIMD)
+#   include <immintrin.h>
+#endif
 
 PYCPP_BEGIN_NAMESPACE
 
@@ -67,7 +77,7 @@ struct sha2_512_context
     uint64_t message[16];
     uint64_t length;
     uint64_t hash[8];
-    unsigned digest_length;
+    uint64_t digest_length;
 };
 
 // FUNCTIONS
@@ -151,6 +161,143 @@ static void sha512_process_block(uint64_t* hash, uint64_t* block) noexcept
 }
 
 
+// KERNELS
+// -------
+
+// Each kernel compresses a run of consecutive 128-byte blocks,
+// which do not need to be aligned, into the hash state.
+
+
+static void sha512_blocks_scalar(uint64_t* hash, const uint8_t* data, size_t blocks)
+{
+    uint64_t block[16];
+    for (; blocks; --blocks, data += SHA512_BLOCK_SIZE) {
+        if (IS_ALIGNED_64(data)) {
+            sha512_process_block(hash, (uint64_t*) data);
+        } else {
+            memcpy(block, data, SHA512_BLOCK_SIZE);
+            sha512_process_block(hash, block);
+        }
+    }
+}
+
+#if defined(HAVE_X86_SIMD)              // HAVE_X86_SIMD
+
+SIMD_TARGET("avx2")
+static inline __m256i sha512_ror_avx2(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - n));
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m256i sha512_sigma0_avx2(__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(sha512_ror_avx2(x, 1), sha512_ror_avx2(x, 8)), _mm256_srli_epi64(x, 7));
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m256i sha512_sigma1_avx2(__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(sha512_ror_avx2(x, 19), sha512_ror_avx2(x, 61)), _mm256_srli_epi64(x, 6));
+}
+
+
+/**
+ *  \brief Compress blocks with a vectorized message schedule.
+ *
+ *  The 80 message words, plus round constants, are computed 4 at a
+ *  time before the rounds. Since `W[t+2]` and `W[t+3]` depend on
+ *  `W[t]` and `W[t+1]`, the `sigma1` term is added in two halves.
+ */
+SIMD_TARGET("avx2,bmi2")
+static void sha512_blocks_avx2(uint64_t* hash, const uint8_t* data, size_t blocks)
+{
+    const __m256i mask = _mm256_set_epi64x(
+        0x08090A0B0C0D0E0FULL, 0x0001020304050607ULL,
+        0x08090A0B0C0D0E0FULL, 0x0001020304050607ULL
+    );
+    uint64_t W[80];
+    uint64_t WK[80];
+
+    for (; blocks; --blocks, data += SHA512_BLOCK_SIZE) {
+        for (int t = 0; t < 16; t += 4) {
+            __m256i w = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*) (data + 8 * t)), mask);
+            _mm256_storeu_si256((__m256i*) &W[t], w);
+            _mm256_storeu_si256((__m256i*) &WK[t], _mm256_add_epi64(w, _mm256_loadu_si256((const __m256i*) &ENCODE[t])));
+        }
+        for (int t = 16; t < 80; t += 4) {
+            __m256i w16 = _mm256_loadu_si256((const __m256i*) &W[t - 16]);
+            __m256i w15 = _mm256_loadu_si256((const __m256i*) &W[t - 15]);
+            __m256i w7 = _mm256_loadu_si256((const __m256i*) &W[t - 7]);
+            __m256i w = _mm256_add_epi64(_mm256_add_epi64(w16, w7), sha512_sigma0_avx2(w15));
+
+            // W[t], W[t+1] from W[t-2], W[t-1], then W[t+2], W[t+3]
+            __m256i w2 = _mm256_inserti128_si256(_mm256_setzero_si256(), _mm_loadu_si128((const __m128i*) &W[t - 2]), 0);
+            w = _mm256_add_epi64(w, sha512_sigma1_avx2(w2));
+            __m256i lo = _mm256_permute2x128_si256(w, w, 0x08);
+            w = _mm256_add_epi64(w, sha512_sigma1_avx2(lo));
+
+            _mm256_storeu_si256((__m256i*) &W[t], w);
+            _mm256_storeu_si256((__m256i*) &WK[t], _mm256_add_epi64(w, _mm256_loadu_si256((const __m256i*) &ENCODE[t])));
+        }
+
+        uint64_t A = hash[0], B = hash[1], C = hash[2], D = hash[3];
+        uint64_t E = hash[4], F = hash[5], G = hash[6], H = hash[7];
+        for (int t = 0; t < 80; t += 8) {
+            ROUND(A, B, C, D, E, F, G, H, 0, WK[t]);
+            ROUND(H, A, B, C, D, E, F, G, 0, WK[t + 1]);
+            ROUND(G, H, A, B, C, D, E, F, 0, WK[t + 2]);
+            ROUND(F, G, H, A, B, C, D, E, 0, WK[t + 3]);
+            ROUND(E, F, G, H, A, B, C, D, 0, WK[t + 4]);
+            ROUND(D, E, F, G, H, A, B, C, 0, WK[t + 5]);
+            ROUND(C, D, E, F, G, H, A, B, 0, WK[t + 6]);
+            ROUND(B, C, D, E, F, G, H, A, 0, WK[t + 7]);
+        }
+        hash[0] += A, hash[1] += B, hash[2] += C, hash[3] += D;
+        hash[4] += E, hash[5] += F, hash[6] += G, hash[7] += H;
+    }
+}
+
+#endif                                  // HAVE_X86_SIMD
+
+
+#if defined(HAVE_X86_SIMD)              // HAVE_X86_SIMD
+
+static bool sha512_avx2_supported()
+{
+    return cpu_supports(cpu_avx2) && cpu_supports(cpu_bmi2);
+}
+
+#endif                                  // HAVE_X86_SIMD
+
+static const hash_kernel<sha512_blocks_t> SHA512_KERNELS[] = {
+#if defined(HAVE_X86_SIMD)
+    {"avx2", sha512_blocks_avx2, sha512_avx2_supported},
+#endif
+    {"scalar", sha512_blocks_scalar, hash_kernel_portable},
+};
+
+
+hash_kernel_table<sha512_blocks_t> sha512_kernels() noexcept
+{
+    return {begin(SHA512_KERNELS), end(SHA512_KERNELS)};
+}
+
+
+sha512_blocks_t& sha512_kernel() noexcept
+{
+    static sha512_blocks_t kernel = hash_kernel_select(sha512_kernels());
+    return kernel;
+}
+
+
+static void sha512_blocks(uint64_t* hash, const uint8_t* data, size_t blocks)
+{
+    sha512_kernel()(hash, data, blocks);
+}
+
 static void sha512_init(sha2_512_context *ctx) noexcept
 {
     /*
@@ -209,24 +356,15 @@ static void sha512_update(void* ptr, const void* buf, size_t len) noexcept
         }
 
         // process partial block
-        sha512_process_block(ctx->hash, ctx->message);
+        sha512_blocks(ctx->hash, (const uint8_t*)ctx->message, 1);
         msg  += left;
         len -= left;
     }
-    while (len >= SHA512_BLOCK_SIZE) {
-        uint64_t* aligned_message_block;
-        if (IS_ALIGNED_64(msg)) {
-            // the most common case is processing of an already
-            // aligned message without copying it
-            aligned_message_block = (uint64_t*)msg;
-        } else {
-            memcpy(ctx->message, msg, SHA512_BLOCK_SIZE);
-            aligned_message_block = ctx->message;
-        }
-
-        sha512_process_block(ctx->hash, aligned_message_block);
-        msg  += SHA512_BLOCK_SIZE;
-        len -= SHA512_BLOCK_SIZE;
+    if (len >= SHA512_BLOCK_SIZE) {
+        size_t blocks = len / SHA512_BLOCK_SIZE;
+        sha512_blocks(ctx->hash, msg, blocks);
+        msg += blocks * SHA512_BLOCK_SIZE;
+        len -= blocks * SHA512_BLOCK_SIZE;
     }
     if (len) {
         // save leftovers
@@ -255,14 +393,14 @@ static void sha512_final(void* ptr, void* buf) noexcept
     /* if no room left in the message to store 128-bit message length */
     if (index >= 15) {
         if (index == 15) ctx->message[index] = 0;
-        sha512_process_block(ctx->hash, ctx->message);
+        sha512_blocks(ctx->hash, (const uint8_t*)ctx->message, 1);
         index = 0;
     }
     while (index < 15) {
         ctx->message[index++] = 0;
     }
     ctx->message[15] = be64toh(ctx->length << 3);
-    sha512_process_block(ctx->hash, ctx->message);
+    sha512_blocks(ctx->hash, (const uint8_t*)ctx->message, 1);
 
     if (result) {
         memcpy_be64toh(result, ctx->hash, ctx->digest_length);
@@ -278,32 +416,38 @@ static void sha512_final(void* ptr, void* buf) noexcept
 // -------
 
 
-sha2_384_hash::sha2_384_hash():
-    ctx(make_unique<sha2_512_context>())
+constexpr size_t sha2_384_hash::digest_size;
+
+
+sha2_384_hash::sha2_384_hash()
 {
-    sha384_init(ctx.get());
+    sha384_init(&ctx.get());
 }
 
 
-sha2_384_hash::sha2_384_hash(const void* src, size_t srclen):
-    ctx(make_unique<sha2_512_context>())
+sha2_384_hash::sha2_384_hash(const void* src, size_t srclen)
 {
-    sha384_init(ctx.get());
+    sha384_init(&ctx.get());
     update(src, srclen);
 }
 
 
-sha2_384_hash::sha2_384_hash(const string_wrapper& str):
-    ctx(make_unique<sha2_512_context>())
+sha2_384_hash::sha2_384_hash(const string_wrapper& str)
 {
-    sha384_init(ctx.get());
+    sha384_init(&ctx.get());
     update(str);
 }
 
 
+sha2_384_hash::sha2_384_hash(sha2_384_hash&&) noexcept = default;
+
+
+sha2_384_hash& sha2_384_hash::operator=(sha2_384_hash&&) noexcept = default;
+
+
 sha2_384_hash::~sha2_384_hash() noexcept
 {
-    secure_zero(ctx.get(), sizeof(*ctx));
+    secure_zero(&ctx.get(), sizeof(*ctx));
 }
 
 
@@ -314,7 +458,7 @@ void sha2_384_hash::update(const void* src, size_t srclen) noexcept
 
     while (length > 0) {
         size_t shift = length > 512 ? 512 : length;
-        sha512_update(ctx.get(), first, shift);
+        sha512_update(&ctx.get(), first, shift);
         length -= shift;
         first += shift;
     }
@@ -355,6 +499,20 @@ secure_string sha2_384_hash::hexdigest() const
 }
 
 
+void sha2_384_hash::digest_into(digest_type& dst) const noexcept
+{
+    sha2_512_context copy = *ctx;
+    sha512_final(&copy, dst.data());
+}
+
+
+void sha2_384_hash::hexdigest_into(char* dst) const noexcept
+{
+    sha2_512_context copy = *ctx;
+    hash_hexdigest_into(&copy, dst, SHA384_HASH_SIZE, sha512_final);
+}
+
+
 void sha2_384_hash::swap(sha2_384_hash& rhs) noexcept
 {
     using PYCPP_NAMESPACE::swap;
@@ -362,38 +520,44 @@ void sha2_384_hash::swap(sha2_384_hash& rhs) noexcept
 }
 
 
-sha2_512_hash::sha2_512_hash():
-    ctx(make_unique<sha2_512_context>())
+constexpr size_t sha2_512_hash::digest_size;
+
+
+sha2_512_hash::sha2_512_hash()
 {
-    sha512_init(ctx.get());
+    sha512_init(&ctx.get());
 }
 
 
-sha2_512_hash::sha2_512_hash(const void* src, size_t srclen):
-    ctx(make_unique<sha2_512_context>())
+sha2_512_hash::sha2_512_hash(const void* src, size_t srclen)
 {
-    sha512_init(ctx.get());
+    sha512_init(&ctx.get());
     update(src, srclen);
 }
 
 
-sha2_512_hash::sha2_512_hash(const string_wrapper& str):
-    ctx(make_unique<sha2_512_context>())
+sha2_512_hash::sha2_512_hash(const string_wrapper& str)
 {
-    sha512_init(ctx.get());
+    sha512_init(&ctx.get());
     update(str);
 }
 
 
+sha2_512_hash::sha2_512_hash(sha2_512_hash&&) noexcept = default;
+
+
+sha2_512_hash& sha2_512_hash::operator=(sha2_512_hash&&) noexcept = default;
+
+
 sha2_512_hash::~sha2_512_hash() noexcept
 {
-    secure_zero(ctx.get(), sizeof(*ctx));
+    secure_zero(&ctx.get(), sizeof(*ctx));
 }
 
 
 void sha2_512_hash::update(const void* src, size_t srclen) noexcept
 {
-    hash_update(ctx.get(), src, srclen, sha512_update);
+    hash_update(&ctx.get(), src, srclen, sha512_update);
 }
 
 
@@ -431,6 +595,20 @@ secure_string sha2_512_hash::hexdigest() const
 }
 
 
+void sha2_512_hash::digest_into(digest_type& dst) const noexcept
+{
+    sha2_512_context copy = *ctx;
+    sha512_final(&copy, dst.data());
+}
+
+
+void sha2_512_hash::hexdigest_into(char* dst) const noexcept
+{
+    sha2_512_context copy = *ctx;
+    hash_hexdigest_into(&copy, dst, SHA512_HASH_SIZE, sha512_final);
+}
+
+
 void sha2_512_hash::swap(sha2_512_hash& rhs) noexcept
 {
     using PYCPP_NAMESPACE::swap;
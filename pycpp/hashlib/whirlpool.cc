@@ -753,38 +753,44 @@ static void whirlpool_final(void* ptr, void* buf) noexcept
 // -------
 
 
-whirlpool_hash::whirlpool_hash():
-    ctx(make_unique<whirlpool_context>())
+constexpr size_t whirlpool_hash::digest_size;
+
+
+whirlpool_hash::whirlpool_hash()
 {
-    whirlpool_init(ctx.get());
+    whirlpool_init(&ctx.get());
 }
 
 
-whirlpool_hash::whirlpool_hash(const void* src, size_t srclen):
-    ctx(make_unique<whirlpool_context>())
+whirlpool_hash::whirlpool_hash(const void* src, size_t srclen)
 {
-    whirlpool_init(ctx.get());
+    whirlpool_init(&ctx.get());
     update(src, srclen);
 }
 
 
-whirlpool_hash::whirlpool_hash(const string_wrapper& str):
-    ctx(make_unique<whirlpool_context>())
+whirlpool_hash::whirlpool_hash(const string_wrapper& str)
 {
-    whirlpool_init(ctx.get());
+    whirlpool_init(&ctx.get());
     update(str);
 }
 
 
+whirlpool_hash::whirlpool_hash(whirlpool_hash&&) noexcept = default;
+
+
+whirlpool_hash& whirlpool_hash::operator=(whirlpool_hash&&) noexcept = default;
+
+
 whirlpool_hash::~whirlpool_hash() noexcept
 {
-    secure_zero(ctx.get(), sizeof(*ctx));
+    secure_zero(&ctx.get(), sizeof(*ctx));
 }
 
 
 void whirlpool_hash::update(const void* src, size_t srclen) noexcept
 {
-    hash_update(ctx.get(), src, srclen, whirlpool_update);
+    hash_update(&ctx.get(), src, srclen, whirlpool_update);
 }
 
 
@@ -822,6 +828,20 @@ secure_string whirlpool_hash::hexdigest() const
 }
 
 
+void whirlpool_hash::digest_into(digest_type& dst) const noexcept
+{
+    whirlpool_context copy = *ctx;
+    whirlpool_final(&copy, dst.data());
+}
+
+
+void whirlpool_hash::hexdigest_into(char* dst) const noexcept
+{
+    whirlpool_context copy = *ctx;
+    hash_hexdigest_into(&copy, dst, WHIRLPOOL_HASH_SIZE, whirlpool_final);
+}
+
+
 void whirlpool_hash::swap(whirlpool_hash& rhs) noexcept
 {
     using PYCPP_NAMESPACE::swap;
@@ -14,13 +14,13 @@ PYCPP_BEGIN_NAMESPACE
 
 json_value_t::json_value_t() noexcept:
     type_(json_null_type),
-    data_((json_pointer_t) nullptr)
+    data_()
 {}
 
 
 json_value_t::json_value_t(json_value_t&& rhs) noexcept:
     type_(json_null_type),
-    data_((json_pointer_t) nullptr)
+    data_()
 {
     swap(rhs);
 }
@@ -35,44 +35,54 @@ json_value_t& json_value_t::operator=(json_value_t&& rhs) noexcept
 
 json_value_t::json_value_t(json_type type) noexcept:
     type_(type),
-    data_((json_pointer_t) nullptr)
+    data_()
 {}
 
 
 json_value_t::json_value_t(json_null_t&&) noexcept:
     type_(json_null_type),
-    data_((json_pointer_t) nullptr)
+    data_()
 {}
 
 
-json_value_t::json_value_t(json_boolean_t&& value):
+json_value_t::json_value_t(json_boolean_t&& value) noexcept:
     type_(json_boolean_type),
-    data_(reinterpret_cast<json_pointer_t>(json_new<json_boolean_t>(move(value))))
-{}
+    data_()
+{
+    data_.boolean = value;
+}
 
 
-json_value_t::json_value_t(json_number_t&& value):
+json_value_t::json_value_t(json_number_t&& value) noexcept:
     type_(json_number_type),
-    data_(reinterpret_cast<json_pointer_t>(json_new<json_number_t>(move(value))))
-{}
+    data_()
+{
+    data_.number = value;
+}
 
 
 json_value_t::json_value_t(json_string_t&& value):
     type_(json_string_type),
-    data_(reinterpret_cast<json_pointer_t>(json_new<json_string_t>(move(value), json_allocator())))
-{}
+    data_()
+{
+    data_.pointer = reinterpret_cast<json_pointer_t>(json_new_container<json_string_t>(move(value)));
+}
 
 
 json_value_t::json_value_t(json_array_t&& value):
     type_(json_array_type),
-    data_(reinterpret_cast<json_pointer_t>(json_new<json_array_t>(move(value), json_allocator())))
-{}
+    data_()
+{
+    data_.pointer = reinterpret_cast<json_pointer_t>(json_new_container<json_array_t>(move(value)));
+}
 
 
 json_value_t::json_value_t(json_object_t&& value):
     type_(json_object_type),
-    data_(reinterpret_cast<json_pointer_t>(json_new<json_object_t>(move(value), json_allocator())))
-{}
+    data_()
+{
+    data_.pointer = reinterpret_cast<json_pointer_t>(json_new_container<json_object_t>(move(value)));
+}
 
 
 json_value_t::~json_value_t()
@@ -128,7 +138,7 @@ json_null_t& json_value_t::get_null()
     if (!has_null()) {
         throw runtime_error("Type is not null.");
     }
-    return *reinterpret_cast<json_null_t*>(&data_);
+    return data_.null;
 }
 
 
@@ -137,7 +147,7 @@ const json_null_t& json_value_t::get_null() const
     if (!has_null()) {
         throw runtime_error("Type is not null.");
     }
-    return *reinterpret_cast<const json_null_t*>(&data_);
+    return data_.null;
 }
 
 
@@ -146,7 +156,7 @@ json_boolean_t& json_value_t::get_boolean()
     if (!has_boolean()) {
         throw runtime_error("Type is not boolean.");
     }
-    return *reinterpret_cast<json_boolean_t*>(data_);
+    return data_.boolean;
 }
 
 
@@ -155,7 +165,7 @@ const json_boolean_t& json_value_t::get_boolean() const
     if (!has_boolean()) {
         throw runtime_error("Type is not boolean.");
     }
-    return *reinterpret_cast<const json_boolean_t*>(data_);
+    return data_.boolean;
 }
 
 
@@ -165,7 +175,7 @@ json_number_t& json_value_t::get_number()
         throw runtime_error("Type is not a number.");
     }
 
-    return *reinterpret_cast<json_number_t*>(data_);
+    return data_.number;
 }
 
 
@@ -175,7 +185,7 @@ const json_number_t& json_value_t::get_number() const
         throw runtime_error("Type is not a number.");
     }
 
-    return *reinterpret_cast<const json_number_t*>(data_);
+    return data_.number;
 }
 
 
@@ -184,10 +194,10 @@ json_string_t& json_value_t::get_string()
     if (!has_string()) {
         throw runtime_error("Type is not a string.");
     }
-    if (!data_) {
+    if (!data_.pointer) {
         throw runtime_error("Value is null.");
     }
-    return *reinterpret_cast<json_string_t*>(data_);
+    return *reinterpret_cast<json_string_t*>(data_.pointer);
 }
 
 
@@ -196,10 +206,10 @@ const json_string_t& json_value_t::get_string() const
     if (!has_string()) {
         throw runtime_error("Type is not a string.");
     }
-    if (!data_) {
+    if (!data_.pointer) {
         throw runtime_error("Value is null.");
     }
-    return *reinterpret_cast<const json_string_t*>(data_);
+    return *reinterpret_cast<const json_string_t*>(data_.pointer);
 }
 
 
@@ -208,10 +218,10 @@ json_array_t& json_value_t::get_array()
     if (!has_array()) {
         throw runtime_error("Type is not an array.");
     }
-    if (!data_) {
+    if (!data_.pointer) {
         throw runtime_error("Value is null.");
     }
-    return *reinterpret_cast<json_array_t*>(data_);
+    return *reinterpret_cast<json_array_t*>(data_.pointer);
 }
 
 
@@ -220,10 +230,10 @@ const json_array_t& json_value_t::get_array() const
     if (!has_array()) {
         throw runtime_error("Type is not an array.");
     }
-    if (!data_) {
+    if (!data_.pointer) {
         throw runtime_error("Value is null.");
     }
-    return *reinterpret_cast<const json_array_t*>(data_);
+    return *reinterpret_cast<const json_array_t*>(data_.pointer);
 }
 
 
@@ -232,10 +242,10 @@ json_object_t& json_value_t::get_object()
     if (!has_object()) {
         throw runtime_error("Type is not an object.");
     }
-    if (!data_) {
+    if (!data_.pointer) {
         throw runtime_error("Value is null.");
     }
-    return *reinterpret_cast<json_object_t*>(data_);
+    return *reinterpret_cast<json_object_t*>(data_.pointer);
 }
 
 
@@ -244,17 +254,17 @@ const json_object_t& json_value_t::get_object() const
     if (!has_object()) {
         throw runtime_error("Type is not an object.");
     }
-    if (!data_) {
+    if (!data_.pointer) {
         throw runtime_error("Value is null.");
     }
-    return *reinterpret_cast<const json_object_t*>(data_);
+    return *reinterpret_cast<const json_object_t*>(data_.pointer);
 }
 
 
 void json_value_t::set_null(json_null_t&& value)
 {
     reset();
-    data_ = (json_pointer_t) nullptr;
+    data_.pointer = 0;
     type_ = json_null_type;
 }
 
@@ -262,7 +272,7 @@ void json_value_t::set_null(json_null_t&& value)
 void json_value_t::set_boolean(json_boolean_t&& value)
 {
     reset();
-    data_ = reinterpret_cast<json_pointer_t>(json_new<json_boolean_t>(move(value)));
+    data_.boolean = value;
     type_ = json_boolean_type;
 }
 
@@ -270,7 +280,7 @@ void json_value_t::set_boolean(json_boolean_t&& value)
 void json_value_t::set_number(json_number_t&& value)
 {
     reset();
-    data_ = reinterpret_cast<json_pointer_t>(json_new<json_number_t>(move(value)));
+    data_.number = value;
     type_ = json_number_type;
 }
 
@@ -278,7 +288,7 @@ void json_value_t::set_number(json_number_t&& value)
 void json_value_t::set_string(json_string_t&& value)
 {
     reset();
-    data_ = reinterpret_cast<json_pointer_t>(json_new<json_string_t>(move(value), json_allocator()));
+    data_.pointer = reinterpret_cast<json_pointer_t>(json_new_container<json_string_t>(move(value)));
     type_ = json_string_type;
 }
 
@@ -286,7 +296,7 @@ void json_value_t::set_string(json_string_t&& value)
 void json_value_t::set_array(json_array_t&& value)
 {
     reset();
-    data_ = reinterpret_cast<json_pointer_t>(json_new<json_array_t>(move(value), json_allocator()));
+    data_.pointer = reinterpret_cast<json_pointer_t>(json_new_container<json_array_t>(move(value)));
     type_ = json_array_type;
 }
 
@@ -294,7 +304,7 @@ void json_value_t::set_array(json_array_t&& value)
 void json_value_t::set_object(json_object_t&& value)
 {
     reset();
-    data_ = reinterpret_cast<json_pointer_t>(json_new<json_object_t>(move(value), json_allocator()));
+    data_.pointer = reinterpret_cast<json_pointer_t>(json_new_container<json_object_t>(move(value)));
     type_ = json_object_type;
 }
 
@@ -347,15 +357,15 @@ bool json_value_t::operator==(const json_value_t& rhs) const noexcept
         case json_null_type:
             return true;
         case json_boolean_type:
-            return *reinterpret_cast<json_boolean_t*>(data_) == *reinterpret_cast<json_boolean_t*>(rhs.data_);
+            return data_.boolean == rhs.data_.boolean;
         case json_number_type:
-            return *reinterpret_cast<json_number_t*>(data_) == *reinterpret_cast<json_number_t*>(rhs.data_);
+            return data_.number == rhs.data_.number;
         case json_string_type:
-            return *reinterpret_cast<json_string_t*>(data_) == *reinterpret_cast<json_string_t*>(rhs.data_);
+            return *reinterpret_cast<json_string_t*>(data_.pointer) == *reinterpret_cast<json_string_t*>(rhs.data_.pointer);
         case json_array_type:
-            return *reinterpret_cast<json_array_t*>(data_) == *reinterpret_cast<json_array_t*>(rhs.data_);
+            return *reinterpret_cast<json_array_t*>(data_.pointer) == *reinterpret_cast<json_array_t*>(rhs.data_.pointer);
         case json_object_type:
-            return *reinterpret_cast<json_object_t*>(data_) == *reinterpret_cast<json_object_t*>(rhs.data_);
+            return *reinterpret_cast<json_object_t*>(data_.pointer) == *reinterpret_cast<json_object_t*>(rhs.data_.pointer);
         default:
             assert(false && "Unexpected JSON value type.");
             return false;
@@ -379,31 +389,26 @@ void json_value_t::swap(json_value_t& rhs) noexcept
 
 void json_value_t::reset()
 {
-    allocator_type allocator;
     switch (type()) {
         case json_null_type:
-            break;
         case json_boolean_type:
-            json_delete(reinterpret_cast<json_boolean_t*>(data_));
-            break;
         case json_number_type:
-            json_delete(reinterpret_cast<json_number_t*>(data_));
             break;
         case json_string_type:
-            json_delete(reinterpret_cast<json_string_t*>(data_));
+            json_delete_container(reinterpret_cast<json_string_t*>(data_.pointer));
             break;
         case json_array_type:
-            json_delete(reinterpret_cast<json_array_t*>(data_));
+            json_delete_container(reinterpret_cast<json_array_t*>(data_.pointer));
             break;
         case json_object_type:
-            json_delete(reinterpret_cast<json_object_t*>(data_));
+            json_delete_container(reinterpret_cast<json_object_t*>(data_.pointer));
             break;
         default:
             assert(false && "Unexpected JSON value type.");
     }
 
     type_ = json_null_type;
-    data_ = (json_pointer_t) nullptr;
+    data_.pointer = 0;
 }
 
 PYCPP_END_NAMESPACE
@@ -58,9 +58,13 @@ using json_ostringstream_t = basic_ostringstream<char, char_traits<char>, alloca
 /**
  *  \brief JSON value type.
  *
- *  Store the data in a 64-bit type, storing the data by value for
+ *  Store the data in a 64-bit union, storing the data by value for
  *  small types (null, bool, numbers) and by pointer for large
  *  values (string, array, object).
+ *
+ *  Large values are allocated with the allocator of the moved
+ *  string, array or object, so values built from containers using
+ *  an arena resource live entirely within the arena.
  */
 struct json_value_t
 {
@@ -79,8 +83,8 @@ public:
 
     json_value_t(json_type type) noexcept;
     json_value_t(json_null_t&&) noexcept;
-    json_value_t(json_boolean_t&&);
-    json_value_t(json_number_t&&);
+    json_value_t(json_boolean_t&&) noexcept;
+    json_value_t(json_number_t&&) noexcept;
     json_value_t(json_string_t&&);
     json_value_t(json_array_t&&);
     json_value_t(json_object_t&&);
@@ -131,8 +135,16 @@ public:
     void swap(json_value_t&) noexcept;
 
 private:
+    union json_data_t
+    {
+        json_pointer_t pointer;
+        json_null_t null;
+        json_boolean_t boolean;
+        json_number_t number;
+    };
+
     json_type type_;
-    json_pointer_t data_;
+    json_data_t data_;
 
     void reset();
 };
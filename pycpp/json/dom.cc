@@ -25,10 +25,11 @@ static void add_value(Levels &levels, bool& has_key, json_string_t& key, Ts... t
         levels.push_back(parent);
         return;
     } else if (has_key) {
-        // adding to object
+        // adding to object, copying the key with its allocator
         json_object_t& object = parent->get_object();
-        object.emplace(key, json_value_t(forward<Ts>(ts)...));
-        value = &object.at(key);
+        json_string_t copy(key, object.get_allocator());
+        auto it = object.emplace(move(copy), json_value_t(forward<Ts>(ts)...)).first;
+        value = &it->second;
         key.clear();
         has_key = false;
     } else {
@@ -125,7 +126,8 @@ static void dump_impl(const json_value_t& value, json_stream_writer& writer)
 
 // HANDLER
 
-json_dom_handler::json_dom_handler(json_dom_handler&& rhs)
+json_dom_handler::json_dom_handler(json_dom_handler&& rhs):
+    allocator_(rhs.allocator_)
 {
     swap(rhs);
 }
@@ -138,7 +140,8 @@ json_dom_handler& json_dom_handler::operator=(json_dom_handler&& rhs)
 }
 
 
-json_dom_handler::json_dom_handler(json_value_t& root) noexcept:
+json_dom_handler::json_dom_handler(json_value_t& root, const allocator_type& allocator):
+    allocator_(allocator),
     root_(&root)
 {}
 
@@ -157,7 +160,7 @@ void json_dom_handler::end_document()
 
 void json_dom_handler::start_object()
 {
-    add_value(levels_, has_key_, key_, json_object_t());
+    add_value(levels_, has_key_, key_, json_object_t(allocator_));
 }
 
 
@@ -169,7 +172,7 @@ void json_dom_handler::end_object(size_t)
 
 void json_dom_handler::start_array()
 {
-    add_value(levels_, has_key_, key_, json_array_t());
+    add_value(levels_, has_key_, key_, json_array_t(allocator_));
 }
 
 
@@ -182,7 +185,7 @@ void json_dom_handler::end_array(size_t)
 void json_dom_handler::key(const string_wrapper& str)
 {
     has_key_ = true;
-    key_ = json_string_t(str);
+    key_.assign(str.data(), str.size());
 }
 
 
@@ -206,12 +209,13 @@ void json_dom_handler::number(double d)
 
 void json_dom_handler::string(const string_wrapper& str)
 {
-    add_value(levels_, has_key_, key_, json_string_t(str));
+    add_value(levels_, has_key_, key_, json_string_t(str.data(), str.size(), allocator_));
 }
 
 
 void json_dom_handler::swap(json_dom_handler& rhs)
 {
+    // allocators are not propagated
     using PYCPP_NAMESPACE::swap;
     swap(root_, rhs.root_);
     swap(has_key_, rhs.has_key_);
@@ -226,13 +230,21 @@ json_document_t::json_document_t() noexcept:
 {}
 
 
+json_document_t::json_document_t(const allocator_type& allocator) noexcept:
+    json_value_t(),
+    allocator_(allocator)
+{}
+
+
 json_document_t::json_document_t(json_document_t&& rhs) noexcept:
-    json_value_t(move(rhs))
+    json_value_t(move(rhs)),
+    allocator_(rhs.allocator_)
 {}
 
 
 json_document_t& json_document_t::operator=(json_document_t&& rhs) noexcept
 {
+    // allocators are not propagated
     json_value_t::operator=(move(rhs));
     return *this;
 }
@@ -248,7 +260,7 @@ void json_document_t::loads(const string_wrapper& data)
 void json_document_t::load(istream& stream)
 {
     json_stream_reader reader;
-    json_dom_handler handler(*this);
+    json_dom_handler handler(*this, allocator_);
     reader.set_handler(handler);
     reader.open(stream);
 }
@@ -318,4 +330,10 @@ void json_document_t::dump(const u16string_view& path, char c, int width)
 
 #endif                                          // WINDOWS
 
+
+auto json_document_t::get_allocator() const noexcept -> allocator_type
+{
+    return allocator_;
+}
+
 PYCPP_END_NAMESPACE
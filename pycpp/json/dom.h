@@ -24,12 +24,18 @@ PYCPP_BEGIN_NAMESPACE
 struct json_dom_handler: json_sax_handler
 {
 public:
+    // MEMBER TYPES
+    // ------------
+    using allocator_type = json_value_t::allocator_type;
+
+    // MEMBER FUNCTIONS
+    // ----------------
     json_dom_handler() = delete;
     json_dom_handler(const json_dom_handler&) = delete;
     json_dom_handler& operator=(const json_dom_handler&) = delete;
     json_dom_handler(json_dom_handler&&);
     json_dom_handler& operator=(json_dom_handler&&);
-    json_dom_handler(json_value_t&) noexcept;
+    json_dom_handler(json_value_t&, const allocator_type& = allocator_type());
 
     // SAX EVENTS
     virtual void start_document() override;
@@ -48,6 +54,7 @@ public:
     void swap(json_dom_handler&);
 
 private:
+    allocator_type allocator_;
     json_value_t* root_ = nullptr;
     bool has_key_ = false;
     json_string_t key_;
@@ -57,10 +64,25 @@ private:
 
 /**
  *  \brief JSON document type.
+ *
+ *  Parsed values are allocated from the document's allocator. To run
+ *  a parse from an arena, construct the document with an arena
+ *  resource, and release the arena once the document is destroyed.
+ *
+ *  \code
+ *      page_arena_resource<>::allocator_type::arena_type arena;
+ *      page_arena_resource<> resource(arena);
+ *      {
+ *          json_document_t document(&resource);
+ *          document.loads(data);
+ *      }
+ *      arena.reset();
+ *  \endcode
  */
 struct json_document_t: json_value_t
 {
     json_document_t() noexcept;
+    explicit json_document_t(const allocator_type&) noexcept;
     json_document_t(const json_document_t&) = delete;
     json_document_t& operator=(const json_document_t&) = delete;
     json_document_t(json_document_t&&) noexcept;
@@ -83,6 +105,12 @@ struct json_document_t: json_value_t
     void dump(const wstring_view&, char = ' ', int = 4);
     void dump(const u16string_view&, char = ' ', int = 4);
 #endif                                          // WINDOWS
+
+    // PROPERTIES
+    allocator_type get_allocator() const noexcept;
+
+private:
+    allocator_type allocator_;
 };
 
 // SPECIALIZATION
@@ -17,11 +17,14 @@ PYCPP_BEGIN_NAMESPACE
 // ---------
 
 /**
- *  \brief Global allocator for JSON data.
+ *  \brief Global allocator for the JSON readers and writers.
  *
- *  To change the allocation behavior of this allocator,
- *  change the underlying `resource` so it is copy
- *  constructed into all JSON data.
+ *  Used for the stream buffers and back-end state of the SAX
+ *  readers and writers. Document data does not use this allocator:
+ *  strings, arrays and objects are allocated with their own
+ *  allocator, and booleans and numbers are stored inline, so
+ *  pass an allocator to `json_document_t` to control where
+ *  a parsed document lives.
  */
 inline byte_allocator& json_allocator() noexcept
 {
@@ -50,80 +53,45 @@ void json_delete(T* t) noexcept
 
     if (t != nullptr) {
         t->~T();
-        traits_type::deallocate(alloc, reinterpret_cast<byte*>(t), 1);
+        traits_type::deallocate(alloc, reinterpret_cast<byte*>(t), sizeof(T));
     }
 }
 
-// OBJECTS
-// -------
-
-// Specific allocator adaptor for the JSON back-end.
-// This allocator stores the size of the array in the head
-// of the allocated array, allowing stack and linear allocators
-// to be effectively used.
-struct json_backend_allocator
-{
-    static constexpr bool kNeedFree = true;
-
-    static void* Malloc(size_t size);
-    static void* Realloc(void* p, size_t old_size, size_t new_size);
-    static void Free(void* p) noexcept;
-};
-
-
-inline void* json_backend_allocator::Malloc(size_t size)
+/**
+ *  \brief Move a JSON container into memory from its own allocator.
+ *
+ *  Strings, arrays and objects carry their allocator, so the container
+ *  and its contents are allocated from the same resource, allowing
+ *  an entire document to be stored in an arena.
+ */
+template <typename T>
+T* json_new_container(T&& value)
 {
-    static byte_allocator& alloc = json_allocator();
-    using traits_type = allocator_traits<byte_allocator>;
+    using allocator_type = typename allocator_traits<byte_allocator>::template rebind_alloc<T>;
+    using traits_type = allocator_traits<allocator_type>;
 
-    // special case for rapidjson compliance
-    if (size == 0) {
-        return nullptr;
-    }
-
-    // allocate and store an extra size_t before the start of the array
+    allocator_type alloc(value.get_allocator());
+    T* t = traits_type::allocate(alloc, 1);
     try {
-        byte* p = traits_type::allocate(alloc, size + sizeof(size_t));
-        size_t* s = reinterpret_cast<size_t*>(p);
-        *s++ = size;
-        return reinterpret_cast<void*>(s);
-    } catch (bad_alloc&) {
-        return nullptr;
+        new(t) T(move(value));
+    } catch (...) {
+        traits_type::deallocate(alloc, t, 1);
+        throw;
     }
+    return t;
 }
 
 
-inline void* json_backend_allocator::Realloc(void* pin, size_t old_size, size_t new_size)
-{
-    // special case for rapidjson compliance
-    if (new_size == 0) {
-        Free(pin);
-        return nullptr;
-    }
-
-    // allocate
-    void* pout = Malloc(new_size);
-    if (pout == nullptr) {
-        return nullptr;
-    }
-
-    // copy over bytes and free
-    memcpy(pout, pin, old_size);
-    Free(pin);
-
-    return pout;
-}
-
-
-inline void json_backend_allocator::Free(void* p) noexcept
+template <typename T>
+void json_delete_container(T* t) noexcept
 {
-    static byte_allocator& alloc = json_allocator();
-    using traits_type = allocator_traits<byte_allocator>;
+    using allocator_type = typename allocator_traits<byte_allocator>::template rebind_alloc<T>;
+    using traits_type = allocator_traits<allocator_type>;
 
-    if (p != nullptr) {
-        size_t* s = reinterpret_cast<size_t*>(p);
-        size_t size = *(--s) + sizeof(size_t);
-        traits_type::deallocate(alloc, reinterpret_cast<byte*>(s), size);
+    if (t != nullptr) {
+        allocator_type alloc(t->get_allocator());
+        t->~T();
+        traits_type::deallocate(alloc, t, 1);
     }
 }
 
@@ -1,38 +1,828 @@
 //  :copyright: (c) 2017 Alex Huszagh.
 //  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  Decimal strings are parsed into a 19-digit mantissa and a decimal
+ *  exponent, and converted using the Eisel-Lemire algorithm, which
+ *  multiplies the normalized mantissa by a truncated, 128-bit
+ *  approximation of the power of five. Exact values which fit in the
+ *  significand are converted using native floating-point arithmetic
+ *  (Clinger's fast path), and inputs with more than 19 significant
+ *  digits whose rounding cannot be determined from the truncated
+ *  mantissa fall back to an arbitrary-precision decimal.
+ *
+ *  Other radixes use the generic, `precise_float_t` algorithm.
+ */
 
 #include <pycpp/lexical/atof.h>
 #include <pycpp/lexical/atoi.h>
 #include <pycpp/lexical/format.h>
 #include <pycpp/lexical/ftoa.h>
 #include <pycpp/lexical/precise_float.h>
+#include <pycpp/lexical/swar.h>
+#include <pycpp/lexical/table.h>
 #include <pycpp/stl/algorithm.h>
-#include <pycpp/stl/functional.h>
 #include <pycpp/stl/iterator.h>
 #include <pycpp/stl/limits.h>
 #include <pycpp/string/casemap.h>
-#include <pycpp/string/string.h>
+#include <float.h>
 #include <math.h>
+#include <string.h>
 
 PYCPP_BEGIN_NAMESPACE
 
-// ALIAS
-// -----
-
-template <typename Int>
-using atoi_function = function<Int(const char*, const char*&, uint8_t)>;
-
 // EXTERN
 // ------
 
 extern precise_float_t atoi_precise_float(const char* first, const char*& last, uint8_t base) noexcept;
 extern bool is_valid_digit(char c, uint8_t base) noexcept;
 
+// CONSTANTS
+// ---------
+
+static const float FLOAT_POWERS[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+static const double DOUBLE_POWERS[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static constexpr uint64_t MIN_19_DIGIT_INTEGER = 1000000000000000000ULL;
+static constexpr uint32_t DECIMAL_MAX_DIGITS = 768;
+static constexpr int32_t DECIMAL_POINT_RANGE = 2047;
+static constexpr uint32_t DECIMAL_MAX_SHIFT = 60;
+static constexpr uint32_t DECIMAL_NUM_POWERS = 19;
+static const uint8_t DECIMAL_POWERS[DECIMAL_NUM_POWERS] = {
+    0, 3, 6, 9, 13, 16, 19, 23, 26, 29, 33, 36, 39, 43, 46, 49, 53, 56, 59
+};
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Binary layout and decimal limits of an IEEE754 type.
+ */
+template <typename Float>
+struct float_traits;
+
+
+template <>
+struct float_traits<float>
+{
+    using uint_type = uint32_t;
+    static constexpr int mantissa_bits = 23;
+    static constexpr int minimum_exponent = -127;
+    static constexpr int infinite_power = 0xFF;
+    static constexpr int sign_index = 31;
+    static constexpr int smallest_power_of_ten = -65;
+    static constexpr int largest_power_of_ten = 38;
+    static constexpr int min_exponent_round_to_even = -17;
+    static constexpr int max_exponent_round_to_even = 10;
+    static constexpr int max_exponent_fast_path = 10;
+    static constexpr uint64_t max_mantissa_fast_path = uint64_t(2) << 23;
+
+    static float power(int exponent) noexcept
+    {
+        return FLOAT_POWERS[exponent];
+    }
+};
+
+
+template <>
+struct float_traits<double>
+{
+    using uint_type = uint64_t;
+    static constexpr int mantissa_bits = 52;
+    static constexpr int minimum_exponent = -1023;
+    static constexpr int infinite_power = 0x7FF;
+    static constexpr int sign_index = 63;
+    static constexpr int smallest_power_of_ten = -342;
+    static constexpr int largest_power_of_ten = 308;
+    static constexpr int min_exponent_round_to_even = -4;
+    static constexpr int max_exponent_round_to_even = 23;
+    static constexpr int max_exponent_fast_path = 22;
+    static constexpr uint64_t max_mantissa_fast_path = uint64_t(2) << 52;
+
+    static double power(int exponent) noexcept
+    {
+        return DOUBLE_POWERS[exponent];
+    }
+};
+
+
+/**
+ *  \brief Decimal number split into its components.
+ *
+ *  The mantissa holds up to the first 19 significant digits, and
+ *  `truncated` is set if any further digits were present.
+ */
+struct decimal_number
+{
+    uint64_t mantissa = 0;
+    int64_t exponent = 0;
+    const char* integer = nullptr;
+    size_t integer_size = 0;
+    const char* fraction = nullptr;
+    size_t fraction_size = 0;
+    int64_t explicit_exponent = 0;
+    bool negative = false;
+    bool truncated = false;
+};
+
+
+/**
+ *  \brief Biased binary exponent and explicit mantissa bits.
+ *
+ *  A negative power indicates the value could not be determined.
+ */
+struct adjusted_mantissa
+{
+    uint64_t mantissa = 0;
+    int32_t power2 = 0;
+
+    bool operator==(const adjusted_mantissa& rhs) const noexcept
+    {
+        return mantissa == rhs.mantissa && power2 == rhs.power2;
+    }
+
+    bool operator!=(const adjusted_mantissa& rhs) const noexcept
+    {
+        return !operator==(rhs);
+    }
+};
+
+
+/**
+ *  \brief Arbitrary-precision decimal, for the slow path.
+ */
+struct big_decimal
+{
+    uint32_t num_digits = 0;
+    int32_t decimal_point = 0;
+    bool truncated = false;
+    uint8_t digits[DECIMAL_MAX_DIGITS];
+};
+
 // HELPERS
 // -------
 
-template <typename Float, typename Int, int Significand>
-Float atof_(const char* first, const char*& last, uint8_t base, atoi_function<Int> function) noexcept
+// SPECIAL
+
+/**
+ *  \brief Check if the range starts with a special string.
+ */
+static bool starts_with(const char* first, const char* last, const string& value) noexcept
+{
+    size_t size = value.size();
+    return static_cast<size_t>(last - first) >= size && memcmp(first, value.data(), size) == 0;
+}
+
+
+/**
+ *  \brief Parse a special IEEE754 value (NaN, Inf), after the sign.
+ */
+template <typename Float>
+static bool parse_special(const char* first, const char*& last, bool negative, Float& value) noexcept
+{
+    if (starts_with(first, last, NAN_STRING)) {
+        last = first + NAN_STRING.size();
+        value = numeric_limits<Float>::quiet_NaN();
+        return true;
+    } else if (starts_with(first, last, INFINITY_STRING)) {
+        last = first + INFINITY_STRING.size();
+        value = numeric_limits<Float>::infinity();
+        value = negative ? -value : value;
+        return true;
+    }
+
+    return false;
+}
+
+// PARSING
+
+static inline bool is_digit(char c) noexcept
+{
+    return static_cast<uint8_t>(c - '0') < 10;
+}
+
+
+/**
+ *  \brief Accumulate a run of digits into the mantissa.
+ *
+ *  Overflow wraps silently: the mantissa is re-parsed if
+ *  more than 19 significant digits are present.
+ */
+static inline const char* parse_digits(const char* first, const char* last, uint64_t& mantissa) noexcept
+{
+    while (last - first >= 8) {
+        uint64_t value = swar_read(first);
+        if (!swar_is_eight_digits(value)) {
+            break;
+        }
+        mantissa = mantissa * 100000000 + swar_parse_eight_digits(value);
+        first += 8;
+    }
+    while (first != last && is_digit(*first)) {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*first - '0');
+        ++first;
+    }
+
+    return first;
+}
+
+
+/**
+ *  \brief Parse a decimal number, and set `last` past the number.
+ *
+ *  Returns false if no digits were found.
+ */
+static bool parse_decimal(const char* first, const char*& last, decimal_number& number) noexcept
+{
+    const char* p = first;
+    uint64_t mantissa = 0;
+
+    // integer
+    number.integer = p;
+    p = parse_digits(p, last, mantissa);
+    number.integer_size = static_cast<size_t>(p - number.integer);
+
+    // fraction
+    number.fraction = p;
+    if (p != last && *p == '.') {
+        ++p;
+        number.fraction = p;
+        p = parse_digits(p, last, mantissa);
+        number.fraction_size = static_cast<size_t>(p - number.fraction);
+    }
+
+    size_t digits = number.integer_size + number.fraction_size;
+    if (digits == 0) {
+        return false;
+    }
+
+    // exponent, only consumed if followed by digits
+    if (p != last && (*p == 'e' || *p == 'E')) {
+        const char* e = p + 1;
+        bool negative = false;
+        if (e != last && (*e == '+' || *e == '-')) {
+            negative = *e == '-';
+            ++e;
+        }
+        if (e != last && is_digit(*e)) {
+            int64_t exponent = 0;
+            for (; e != last && is_digit(*e); ++e) {
+                if (exponent < 0x10000) {
+                    exponent = exponent * 10 + (*e - '0');
+                }
+            }
+            number.explicit_exponent = negative ? -exponent : exponent;
+            p = e;
+        }
+    }
+    last = p;
+
+    number.mantissa = mantissa;
+    number.exponent = number.explicit_exponent - static_cast<int64_t>(number.fraction_size);
+
+    // more than 19 digits, check significant digits
+    if (digits > 19) {
+        const char* integer_last = number.integer + number.integer_size;
+        const char* fraction_last = number.fraction + number.fraction_size;
+        const char* c = number.integer;
+        for (; c != integer_last && *c == '0'; ++c) {
+            --digits;
+        }
+        if (c == integer_last) {
+            for (c = number.fraction; c != fraction_last && *c == '0'; ++c) {
+                --digits;
+            }
+        }
+
+        if (digits > 19) {
+            // keep the first 19 significant digits
+            number.truncated = true;
+            mantissa = 0;
+            c = number.integer;
+            for (; mantissa < MIN_19_DIGIT_INTEGER && c != integer_last; ++c) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*c - '0');
+            }
+            if (mantissa >= MIN_19_DIGIT_INTEGER) {
+                number.exponent = number.explicit_exponent + (integer_last - c);
+            } else {
+                c = number.fraction;
+                for (; mantissa < MIN_19_DIGIT_INTEGER && c != fraction_last; ++c) {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*c - '0');
+                }
+                number.exponent = number.explicit_exponent - (c - number.fraction);
+            }
+            number.mantissa = mantissa;
+        }
+    }
+
+    return true;
+}
+
+// ARITHMETIC
+
+static inline int leading_zeros(uint64_t x) noexcept
+{
+#if defined(HAVE_GCC) || defined(HAVE_CLANG)
+    return __builtin_clzll(x);
+#else
+    int count = 0;
+    while (!(x & 0x8000000000000000ULL)) {
+        x <<= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+
+/**
+ *  \brief Compute the full 128-bit product of two 64-bit integers.
+ */
+static inline void full_multiplication(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    hi = static_cast<uint64_t>(r >> 64);
+    lo = static_cast<uint64_t>(r);
+#else
+    uint64_t a_lo = static_cast<uint32_t>(a);
+    uint64_t a_hi = a >> 32;
+    uint64_t b_lo = static_cast<uint32_t>(b);
+    uint64_t b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + static_cast<uint32_t>(hi_lo) + lo_hi;
+    hi = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    lo = (cross << 32) | static_cast<uint32_t>(lo_lo);
+#endif
+}
+
+
+/**
+ *  \brief Approximate floor(log2(10^q)) + 63.
+ */
+static inline int32_t binary_power(int32_t q) noexcept
+{
+    return (((152170 + 65536) * q) >> 16) + 63;
+}
+
+// EISEL-LEMIRE
+
+/**
+ *  \brief Compute `w * 5^q` with at least `Precision` exact bits.
+ *
+ *  The second, lower word of the power is only used if the
+ *  truncated product could carry into the significant bits.
+ */
+template <int Precision>
+static inline void compute_product(int64_t q, uint64_t w, uint64_t& hi, uint64_t& lo) noexcept
+{
+    const int index = 2 * static_cast<int>(q - POW5_128_MIN_EXPONENT);
+    const uint64_t precision_mask = 0xFFFFFFFFFFFFFFFFULL >> Precision;
+    full_multiplication(w, POW5_128[index], hi, lo);
+    if ((hi & precision_mask) == precision_mask) {
+        uint64_t hi2, lo2;
+        full_multiplication(w, POW5_128[index + 1], hi2, lo2);
+        lo += hi2;
+        if (hi2 > lo) {
+            ++hi;
+        }
+    }
+}
+
+
+/**
+ *  \brief Convert `w * 10^q` to a float using Eisel-Lemire.
+ *
+ *  Always correctly rounded for an exact mantissa.
+ */
+template <typename Float>
+static adjusted_mantissa eisel_lemire(int64_t q, uint64_t w) noexcept
+{
+    using traits = float_traits<Float>;
+
+    adjusted_mantissa am;
+    if (w == 0 || q < traits::smallest_power_of_ten) {
+        return am;
+    } else if (q > traits::largest_power_of_ten) {
+        am.power2 = traits::infinite_power;
+        return am;
+    }
+
+    // normalize and multiply
+    int lz = leading_zeros(w);
+    w <<= lz;
+    uint64_t hi, lo;
+    compute_product<traits::mantissa_bits + 3>(q, w, hi, lo);
+
+    int upperbit = static_cast<int>(hi >> 63);
+    int shift = upperbit + 64 - traits::mantissa_bits - 3;
+    am.mantissa = hi >> shift;
+    am.power2 = binary_power(static_cast<int32_t>(q)) + upperbit - lz - traits::minimum_exponent;
+
+    // subnormal
+    if (am.power2 <= 0) {
+        if (-am.power2 + 1 >= 64) {
+            am.mantissa = 0;
+            am.power2 = 0;
+            return am;
+        }
+        am.mantissa >>= -am.power2 + 1;
+        am.mantissa += (am.mantissa & 1);
+        am.mantissa >>= 1;
+        am.power2 = (am.mantissa < (uint64_t(1) << traits::mantissa_bits)) ? 0 : 1;
+        return am;
+    }
+
+    // exactly halfway between two floats: round-to-even
+    if (lo <= 1 && q >= traits::min_exponent_round_to_even && q <= traits::max_exponent_round_to_even && (am.mantissa & 3) == 1) {
+        if ((am.mantissa << shift) == hi) {
+            am.mantissa &= ~uint64_t(1);
+        }
+    }
+
+    // round-nearest, and check for carry into the exponent
+    am.mantissa += (am.mantissa & 1);
+    am.mantissa >>= 1;
+    if (am.mantissa >= (uint64_t(2) << traits::mantissa_bits)) {
+        am.mantissa = uint64_t(1) << traits::mantissa_bits;
+        ++am.power2;
+    }
+    am.mantissa &= ~(uint64_t(1) << traits::mantissa_bits);
+    if (am.power2 >= traits::infinite_power) {
+        am.power2 = traits::infinite_power;
+        am.mantissa = 0;
+    }
+
+    return am;
+}
+
+// SLOW PATH
+
+static void decimal_trim(big_decimal& d) noexcept
+{
+    while (d.num_digits > 0 && d.digits[d.num_digits - 1] == 0) {
+        --d.num_digits;
+    }
+}
+
+
+static inline void decimal_push(big_decimal& d, char c) noexcept
+{
+    if (d.num_digits < DECIMAL_MAX_DIGITS) {
+        d.digits[d.num_digits++] = static_cast<uint8_t>(c - '0');
+    } else if (c != '0') {
+        d.truncated = true;
+    }
+}
+
+
+/**
+ *  \brief Load the significant digits of a parsed number.
+ */
+static void decimal_load(const decimal_number& number, big_decimal& d) noexcept
+{
+    const char* c = number.integer;
+    const char* integer_last = number.integer + number.integer_size;
+    const char* fraction_last = number.fraction + number.fraction_size;
+
+    for (; c != integer_last && *c == '0'; ++c);
+    d.decimal_point = static_cast<int32_t>(integer_last - c);
+    for (; c != integer_last; ++c) {
+        decimal_push(d, *c);
+    }
+
+    c = number.fraction;
+    if (d.num_digits == 0) {
+        for (; c != fraction_last && *c == '0'; ++c) {
+            --d.decimal_point;
+        }
+    }
+    for (; c != fraction_last; ++c) {
+        decimal_push(d, *c);
+    }
+
+    int64_t point = d.decimal_point + number.explicit_exponent;
+    point = max<int64_t>(min<int64_t>(point, 0x10000), -0x10000);
+    d.decimal_point = static_cast<int32_t>(point);
+    decimal_trim(d);
+}
+
+
+/**
+ *  \brief Number of new digits produced by a left shift.
+ */
+static uint32_t decimal_shift_digits(const big_decimal& d, uint32_t shift) noexcept
+{
+    uint32_t a = DECIMAL_SHIFT_DIGITS[shift];
+    uint32_t b = DECIMAL_SHIFT_DIGITS[shift + 1];
+    uint32_t new_digits = a >> 11;
+    uint32_t pow5_first = a & 0x7FF;
+    uint32_t pow5_last = b & 0x7FF;
+    const uint8_t* pow5 = DECIMAL_SHIFT_POW5 + pow5_first;
+
+    for (uint32_t i = 0; i < pow5_last - pow5_first; ++i) {
+        if (i >= d.num_digits) {
+            return new_digits - 1;
+        } else if (d.digits[i] != pow5[i]) {
+            return d.digits[i] < pow5[i] ? new_digits - 1 : new_digits;
+        }
+    }
+
+    return new_digits;
+}
+
+
+static void decimal_left_shift(big_decimal& d, uint32_t shift) noexcept
+{
+    if (d.num_digits == 0) {
+        return;
+    }
+
+    uint32_t new_digits = decimal_shift_digits(d, shift);
+    int32_t read = static_cast<int32_t>(d.num_digits) - 1;
+    uint32_t write = d.num_digits - 1 + new_digits;
+    uint64_t n = 0;
+
+    for (; read >= 0; --read, --write) {
+        n += static_cast<uint64_t>(d.digits[read]) << shift;
+        uint64_t quotient = n / 10;
+        uint64_t remainder = n - 10 * quotient;
+        if (write < DECIMAL_MAX_DIGITS) {
+            d.digits[write] = static_cast<uint8_t>(remainder);
+        } else if (remainder > 0) {
+            d.truncated = true;
+        }
+        n = quotient;
+    }
+    for (; n > 0; --write) {
+        uint64_t quotient = n / 10;
+        uint64_t remainder = n - 10 * quotient;
+        if (write < DECIMAL_MAX_DIGITS) {
+            d.digits[write] = static_cast<uint8_t>(remainder);
+        } else if (remainder > 0) {
+            d.truncated = true;
+        }
+        n = quotient;
+    }
+
+    d.num_digits = min(d.num_digits + new_digits, DECIMAL_MAX_DIGITS);
+    d.decimal_point += static_cast<int32_t>(new_digits);
+    decimal_trim(d);
+}
+
+
+static void decimal_right_shift(big_decimal& d, uint32_t shift) noexcept
+{
+    uint32_t read = 0;
+    uint32_t write = 0;
+    uint64_t n = 0;
+
+    while ((n >> shift) == 0) {
+        if (read < d.num_digits) {
+            n = 10 * n + d.digits[read++];
+        } else if (n == 0) {
+            return;
+        } else {
+            while ((n >> shift) == 0) {
+                n = 10 * n;
+                ++read;
+            }
+            break;
+        }
+    }
+
+    d.decimal_point -= static_cast<int32_t>(read - 1);
+    if (d.decimal_point < -DECIMAL_POINT_RANGE) {
+        d.num_digits = 0;
+        d.decimal_point = 0;
+        d.truncated = false;
+        return;
+    }
+
+    uint64_t mask = (uint64_t(1) << shift) - 1;
+    while (read < d.num_digits) {
+        uint8_t digit = static_cast<uint8_t>(n >> shift);
+        n = 10 * (n & mask) + d.digits[read++];
+        d.digits[write++] = digit;
+    }
+    while (n > 0) {
+        uint8_t digit = static_cast<uint8_t>(n >> shift);
+        n = 10 * (n & mask);
+        if (write < DECIMAL_MAX_DIGITS) {
+            d.digits[write++] = digit;
+        } else if (digit > 0) {
+            d.truncated = true;
+        }
+    }
+
+    d.num_digits = write;
+    decimal_trim(d);
+}
+
+
+/**
+ *  \brief Round the integral part of the decimal, nearest-even.
+ */
+static uint64_t decimal_round(const big_decimal& d) noexcept
+{
+    if (d.num_digits == 0 || d.decimal_point < 0) {
+        return 0;
+    } else if (d.decimal_point > 18) {
+        return numeric_limits<uint64_t>::max();
+    }
+
+    uint32_t point = static_cast<uint32_t>(d.decimal_point);
+    uint64_t n = 0;
+    for (uint32_t i = 0; i < point; ++i) {
+        n = 10 * n + (i < d.num_digits ? d.digits[i] : 0);
+    }
+
+    bool round_up = false;
+    if (point < d.num_digits) {
+        round_up = d.digits[point] >= 5;
+        if (d.digits[point] == 5 && point + 1 == d.num_digits) {
+            round_up = d.truncated || (point > 0 && (d.digits[point - 1] & 1));
+        }
+    }
+
+    return round_up ? n + 1 : n;
+}
+
+
+/**
+ *  \brief Convert an arbitrary-precision decimal to a float.
+ *
+ *  Scales the decimal by powers of two until it lies in [1/2, 1),
+ *  then extracts the rounded significand.
+ */
+template <typename Float>
+static adjusted_mantissa decimal_to_float(big_decimal& d) noexcept
+{
+    using traits = float_traits<Float>;
+
+    adjusted_mantissa am;
+    if (d.num_digits == 0 || d.decimal_point < -324) {
+        return am;
+    } else if (d.decimal_point >= 310) {
+        am.power2 = traits::infinite_power;
+        return am;
+    }
+
+    int32_t exp2 = 0;
+    while (d.decimal_point > 0) {
+        uint32_t n = static_cast<uint32_t>(d.decimal_point);
+        uint32_t shift = n < DECIMAL_NUM_POWERS ? DECIMAL_POWERS[n] : DECIMAL_MAX_SHIFT;
+        decimal_right_shift(d, shift);
+        if (d.decimal_point < -DECIMAL_POINT_RANGE) {
+            return am;
+        }
+        exp2 += static_cast<int32_t>(shift);
+    }
+    while (d.decimal_point <= 0) {
+        uint32_t shift;
+        if (d.decimal_point == 0) {
+            if (d.digits[0] >= 5) {
+                break;
+            }
+            shift = d.digits[0] < 2 ? 2 : 1;
+        } else {
+            uint32_t n = static_cast<uint32_t>(-d.decimal_point);
+            shift = n < DECIMAL_NUM_POWERS ? DECIMAL_POWERS[n] : DECIMAL_MAX_SHIFT;
+        }
+        decimal_left_shift(d, shift);
+        if (d.decimal_point > DECIMAL_POINT_RANGE) {
+            am.power2 = traits::infinite_power;
+            return am;
+        }
+        exp2 -= static_cast<int32_t>(shift);
+    }
+
+    // value is now in [1/2, 1) * 2^exp2, move it into [1, 2)
+    --exp2;
+    while (traits::minimum_exponent + 1 > exp2) {
+        uint32_t n = static_cast<uint32_t>(traits::minimum_exponent + 1 - exp2);
+        n = min(n, DECIMAL_MAX_SHIFT);
+        decimal_right_shift(d, n);
+        exp2 += static_cast<int32_t>(n);
+    }
+    if (exp2 - traits::minimum_exponent >= traits::infinite_power) {
+        am.power2 = traits::infinite_power;
+        return am;
+    }
+
+    const int bits = traits::mantissa_bits + 1;
+    decimal_left_shift(d, bits);
+    uint64_t mantissa = decimal_round(d);
+    if (mantissa >= (uint64_t(1) << bits)) {
+        decimal_right_shift(d, 1);
+        ++exp2;
+        mantissa = decimal_round(d);
+        if (exp2 - traits::minimum_exponent >= traits::infinite_power) {
+            am.power2 = traits::infinite_power;
+            return am;
+        }
+    }
+
+    am.power2 = exp2 - traits::minimum_exponent;
+    if (mantissa < (uint64_t(1) << traits::mantissa_bits)) {
+        --am.power2;
+    }
+    am.mantissa = mantissa & ((uint64_t(1) << traits::mantissa_bits) - 1);
+
+    return am;
+}
+
+// DECIMAL
+
+template <typename Float>
+static Float to_float(bool negative, const adjusted_mantissa& am) noexcept
+{
+    using traits = float_traits<Float>;
+    using uint_type = typename traits::uint_type;
+
+    uint_type bits = static_cast<uint_type>(am.mantissa);
+    bits |= static_cast<uint_type>(am.power2) << traits::mantissa_bits;
+    bits |= static_cast<uint_type>(negative) << traits::sign_index;
+
+    Float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+
+/**
+ *  \brief Correctly-rounded decimal string to float conversion.
+ */
+template <typename Float>
+static Float atof_decimal(const char* first, const char*& last) noexcept
+{
+    using traits = float_traits<Float>;
+    static_assert(numeric_limits<Float>::is_iec559, "Must support IEC 559/IEEE 754 standard.");
+
+    // sign
+    const char* p = first;
+    bool negative = false;
+    if (p != last && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    // special values, only checked if we have no leading digits
+    Float value;
+    if (p != last && !is_digit(*p) && *p != '.') {
+        if (parse_special(p, last, negative, value)) {
+            return value;
+        }
+        last = first;
+        return 0;
+    }
+
+    decimal_number number;
+    number.negative = negative;
+    if (!parse_decimal(p, last, number)) {
+        last = first;
+        return 0;
+    }
+
+    // Clinger's fast path: the mantissa and power are exact
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD == 0
+    if (!number.truncated && number.mantissa <= traits::max_mantissa_fast_path &&
+        number.exponent >= -traits::max_exponent_fast_path && number.exponent <= traits::max_exponent_fast_path)
+    {
+        value = static_cast<Float>(number.mantissa);
+        if (number.exponent < 0) {
+            value /= traits::power(static_cast<int>(-number.exponent));
+        } else {
+            value *= traits::power(static_cast<int>(number.exponent));
+        }
+        return negative ? -value : value;
+    }
+#endif
+
+    // Eisel-Lemire, with a fallback if the truncated digits
+    // could change the rounded result
+    adjusted_mantissa am = eisel_lemire<Float>(number.exponent, number.mantissa);
+    if (number.truncated && am != eisel_lemire<Float>(number.exponent, number.mantissa + 1)) {
+        big_decimal d;
+        decimal_load(number, d);
+        am = decimal_to_float<Float>(d);
+    }
+
+    return to_float<Float>(negative, am);
+}
+
+// GENERIC
+
+template <typename Float, typename Int, int Significand, Int (*Function)(const char*, const char*&, uint8_t)>
+Float atof_(const char* first, const char*& last, uint8_t base) noexcept
 {
     static_assert(numeric_limits<Float>::is_iec559, "Must support IEC 559/IEEE 754 standard.");
 
@@ -40,19 +830,13 @@ Float atof_(const char* first, const char*& last, uint8_t base, atoi_function<In
     precise_float_t integer, fraction, value;
 
     // check if it is a special IEEE754 number (NaN, INF)
-    string_wrapper view(first, last);
-    if (view.startswith(NAN_STRING)) {
-        last = first + NAN_STRING.size() + 1;
-        return numeric_limits<Float>::quiet_NaN();
-    } else if (view.startswith(INFINITY_STRING)) {
-        last = first + INFINITY_STRING.size() + 1;
-        return numeric_limits<Float>::infinity();
-    } else if (view.size() >= 1 && view[0] == '-') {
-        view = string_wrapper(first+1, last);
-        if (view.startswith(INFINITY_STRING)) {
-            last = first + INFINITY_STRING.size() + 2;
-            return -numeric_limits<Float>::infinity();
+    Float special;
+    if (first != last && *first == '-') {
+        if (parse_special(first+1, last, true, special)) {
+            return special;
         }
+    } else if (parse_special(first, last, false, special)) {
+        return special;
     }
 
     // calculate the integer portion
@@ -69,7 +853,7 @@ Float atof_(const char* first, const char*& last, uint8_t base, atoi_function<In
         do {
             tmp_first = tmp_last;
             tmp_last = min(last, tmp_first + Significand);
-            tmp_frac = function(tmp_first, tmp_last, base);
+            tmp_frac = Function(tmp_first, tmp_last, base);
             digits += distance(tmp_first, tmp_last);
             fraction += (tmp_frac / pow(static_cast<double>(base), static_cast<double>(digits)));
         } while (tmp_last != last && is_valid_digit(*tmp_last, base));
@@ -83,7 +867,7 @@ Float atof_(const char* first, const char*& last, uint8_t base, atoi_function<In
         ++tmp_last;
         tmp_first = tmp_last;
         tmp_last = last;
-        Int exponent = function(tmp_first, tmp_last, base);
+        Int exponent = Function(tmp_first, tmp_last, base);
         value *= pow(base, exponent);
     }
 
@@ -95,10 +879,12 @@ Float atof_(const char* first, const char*& last, uint8_t base, atoi_function<In
 
 float atof32(const char* first, const char*& last, uint8_t base) noexcept
 {
-    int32_t (*f)(const char*, const char*&, uint8_t) = atoi32;
+    if (base == 10) {
+        return atof_decimal<float>(first, last);
+    }
     // a 32-bit, base-36 number can encoded max 7 digits, so
     // use 6 to ensure no possible overflow for any radix.
-    return atof_<float, int32_t, 6>(first, last, base, f);
+    return atof_<float, int32_t, 6, atoi32>(first, last, base);
 }
 
 
@@ -112,10 +898,12 @@ float atof32(const string_view& string, uint8_t base) noexcept
 
 double atof64(const char* first, const char*& last, uint8_t base) noexcept
 {
-    int64_t (*f)(const char*, const char*&, uint8_t) = atoi64;
+    if (base == 10) {
+        return atof_decimal<double>(first, last);
+    }
     // a 64-bit, base-36 number can encoded max 13 digits, so
     // use 12 to ensure no possible overflow for any radix.
-    return atof_<double, int64_t, 12>(first, last, base, f);
+    return atof_<double, int64_t, 12, atoi64>(first, last, base);
 }
 
 
@@ -1,11 +1,27 @@
 //  :copyright: (c) 2017 Alex Huszagh.
 //  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  Decimal and hexadecimal integers are parsed 8 characters at a time
+ *  while at least 8 bytes remain in the buffer: the characters are
+ *  validated and converted with SWAR arithmetic, and the remaining
+ *  digits are parsed one at a time. Values are accumulated modulo
+ *  2^64, so narrower types wrap exactly as if digits were accumulated
+ *  one at a time. The parsers also flag magnitudes that do not fit
+ *  in 64 bits, which the batch routines use to reject values out of
+ *  range for the type.
+ *
+ *  Other radixes, and the `precise_float_t` parser used by `atof.cc`,
+ *  parse a single character at a time.
+ */
 
 #include <pycpp/lexical/atoi.h>
 #include <pycpp/lexical/precise_float.h>
+#include <pycpp/lexical/swar.h>
 #include <pycpp/lexical/table.h>
 #include <pycpp/stl/limits.h>
 #include <pycpp/stl/stdexcept.h>
+#include <pycpp/stl/type_traits.h>
+#include <assert.h>
 #include <ctype.h>
 
 PYCPP_BEGIN_NAMESPACE
@@ -84,37 +100,221 @@ static Int atoi_alnum(const char* first, const char*& last, uint8_t base) noexce
 }
 
 
+// SWAR
+
+/**
+ *  \brief Parse decimal digits, 8 at a time.
+ *
+ *  Sets `overflow` if the value does not fit in 64 bits.
+ */
+static uint64_t atoi_decimal(const char* first, const char*& last, bool& overflow) noexcept
+{
+    // UINT64_MAX is 184467440737|09551615, or 1844674407370955161|5
+    constexpr uint64_t max_chunk_value = 184467440737ULL;
+    constexpr uint64_t max_chunk = 9551615;
+    constexpr uint64_t max_digit_value = 1844674407370955161ULL;
+    constexpr uint64_t max_digit = 5;
+
+    uint64_t value = 0;
+    while (last - first >= 8) {
+        uint64_t chunk = swar_read(first);
+        if (!swar_is_eight_digits(chunk)) {
+            break;
+        }
+        chunk = swar_parse_eight_digits(chunk);
+        overflow |= value > max_chunk_value || (value == max_chunk_value && chunk > max_chunk);
+        value = value * 100000000 + chunk;
+        first += 8;
+    }
+
+    // fewer than 8 digits remain
+    while (first < last && is_valid_num(first[0], '9')) {
+        uint64_t digit = static_cast<uint64_t>(*first++ - '0');
+        overflow |= value > max_digit_value || (value == max_digit_value && digit > max_digit);
+        value = value * 10 + digit;
+    }
+    last = first;
+    return value;
+}
+
+
+/**
+ *  \brief Parse hexadecimal digits, 8 at a time.
+ *
+ *  Sets `overflow` if the value does not fit in 64 bits.
+ */
+static uint64_t atoi_hex(const char* first, const char*& last, bool& overflow) noexcept
+{
+    uint64_t value = 0;
+    while (last - first >= 8) {
+        uint64_t chunk = swar_read(first);
+        if (swar_nonhex(chunk) != 0) {
+            break;
+        }
+        overflow |= (value >> 32) != 0;
+        value = (value << 32) | swar_parse_eight_hex(chunk);
+        first += 8;
+    }
+
+    // fewer than 8 digits remain, avoid the locale-aware `toupper`
+    while (first < last) {
+        uint8_t c = static_cast<uint8_t>(*first);
+        uint8_t digit = static_cast<uint8_t>(c - '0');
+        if (digit >= 10) {
+            digit = static_cast<uint8_t>((c | 0x20) - 'a');
+            if (digit >= 6) {
+                break;
+            }
+            digit += 10;
+        }
+        overflow |= (value >> 60) != 0;
+        value = (value << 4) | digit;
+        ++first;
+    }
+    last = first;
+    return value;
+}
+
+// DISPATCHER
+
 template <typename Int>
 static Int atoi_impl(const char* first, const char*& last, uint8_t base) noexcept
 {
     // logic error, disable in release builds
     assert((base >= 2 && base <= 36) && "Numerical base must be from 2-36");
 
-    if (base <= 10) {
+    // the SWAR parsers wrap on overflow, so only use them for integers
+    bool overflow = false;
+    if (is_integral<Int>::value && base == 10) {
+        return static_cast<Int>(atoi_decimal(first, last, overflow));
+    } else if (is_integral<Int>::value && base == 16) {
+        return static_cast<Int>(atoi_hex(first, last, overflow));
+    } else if (base <= 10) {
         return atoi_num<Int>(first, last, base);
     } else {
         return atoi_alnum<Int>(first, last, base);
     }
 }
 
-#include <warnings/push.h>
-#include <warnings/unary-minus-unsigned.h>
+/**
+ *  \brief Negate an unsigned magnitude, wrapping modulo 2^64.
+ */
+static uint64_t atoi_negate(uint64_t value) noexcept
+{
+    return uint64_t(0) - value;
+}
+
+
+static precise_float_t atoi_negate(precise_float_t value) noexcept
+{
+    return -value;
+}
+
 
 template <typename Int>
 Int atoi_(const char* first, const char*& last, uint8_t base) noexcept
 {
+    // accumulate integers unsigned, so negating the minimum is defined
+    using value_type = conditional_t<is_integral<Int>::value, uint64_t, Int>;
+
     if (first == last) {
         return Int(0);
     } else if (first[0] == '+') {
-        return atoi_impl<Int>(first+1, last, base);
+        return static_cast<Int>(atoi_impl<value_type>(first+1, last, base));
+    } else if (first[0] == '-') {
+        return static_cast<Int>(atoi_negate(atoi_impl<value_type>(first+1, last, base)));
+    } else {
+        return static_cast<Int>(atoi_impl<value_type>(first, last, base));
+    }
+}
+
+
+/**
+ *  \brief Parse the magnitude of a value, failing if it exceeds `max`.
+ */
+static bool atoi_checked_magnitude(const char* first, const char*& last, uint8_t base, uint64_t max, uint64_t& value) noexcept
+{
+    assert((base >= 2 && base <= 36) && "Numerical base must be from 2-36");
+
+    bool overflow = false;
+    if (base == 10) {
+        value = atoi_decimal(first, last, overflow);
+    } else if (base == 16) {
+        value = atoi_hex(first, last, overflow);
+    } else {
+        value = 0;
+        uint64_t limit = numeric_limits<uint64_t>::max() / base;
+        while (first < last && is_valid_digit(first[0], base)) {
+            char c = static_cast<char>(::toupper(*first++));
+            uint64_t digit = static_cast<uint64_t>(c <= '9' ? c - '0' : c - 'A' + 10);
+            overflow |= value > limit || value * base > numeric_limits<uint64_t>::max() - digit;
+            value = value * base + digit;
+        }
+        last = first;
+    }
+
+    return !overflow && value <= max;
+}
+
+
+/**
+ *  \brief Parse a value, failing if it is out of range for the type.
+ */
+template <typename Int>
+static bool atoi_checked_(const char* first, const char*& last, uint8_t base, Int& value) noexcept
+{
+    uint64_t max = static_cast<uint64_t>(numeric_limits<Int>::max());
+    uint64_t magnitude;
+    bool valid;
+
+    if (first == last) {
+        value = Int(0);
+        return true;
+    } else if (first[0] == '+') {
+        valid = atoi_checked_magnitude(first+1, last, base, max, magnitude);
+        value = static_cast<Int>(magnitude);
     } else if (first[0] == '-') {
-        return -atoi_impl<Int>(first+1, last, base);
+        // allow `-0` for unsigned types, and `min()` for signed types
+        uint64_t min = is_signed<Int>::value ? max + 1 : 0;
+        valid = atoi_checked_magnitude(first+1, last, base, min, magnitude);
+        value = static_cast<Int>(uint64_t(0) - magnitude);
     } else {
-        return atoi_impl<Int>(first, last, base);
+        valid = atoi_checked_magnitude(first, last, base, max, magnitude);
+        value = static_cast<Int>(magnitude);
     }
+
+    return valid;
 }
 
-#include <warnings/pop.h>
+
+template <typename Int>
+static size_t atoi_batch_(const char* first, const char*& last, Int* values, size_t count, char delimiter, uint8_t base) noexcept
+{
+    const char* p = first;
+    size_t i = 0;
+    while (i < count) {
+        const char* q = p;
+        if (i != 0) {
+            if (q == last || *q != delimiter) {
+                break;
+            }
+            ++q;
+        }
+
+        // stop before an empty or out-of-range field, leaving
+        // the delimiter unparsed
+        const char* end = last;
+        Int value;
+        if (!atoi_checked_<Int>(q, end, base, value) || end == q) {
+            break;
+        }
+        values[i++] = value;
+        p = end;
+    }
+
+    last = p;
+    return i;
+}
 
 // FUNCTIONS
 // ---------
@@ -231,6 +431,62 @@ int64_t atoi64(const string_view& string, uint8_t base) noexcept
 }
 
 
+size_t atou32_batch(const char* first, const char*& last, uint32_t* values, size_t count, char delimiter, uint8_t base) noexcept
+{
+    return atoi_batch_<uint32_t>(first, last, values, count, delimiter, base);
+}
+
+
+size_t atou32_batch(const string_view& string, uint32_t* values, size_t count, char delimiter, uint8_t base) noexcept
+{
+    const char* first = string.begin();
+    const char* last = string.end();
+    return atou32_batch(first, last, values, count, delimiter, base);
+}
+
+
+size_t atoi32_batch(const char* first, const char*& last, int32_t* values, size_t count, char delimiter, uint8_t base) noexcept
+{
+    return atoi_batch_<int32_t>(first, last, values, count, delimiter, base);
+}
+
+
+size_t atoi32_batch(const string_view& string, int32_t* values, size_t count, char delimiter, uint8_t base) noexcept
+{
+    const char* first = string.begin();
+    const char* last = string.end();
+    return atoi32_batch(first, last, values, count, delimiter, base);
+}
+
+
+size_t atou64_batch(const char* first, const char*& last, uint64_t* values, size_t count, char delimiter, uint8_t base) noexcept
+{
+    return atoi_batch_<uint64_t>(first, last, values, count, delimiter, base);
+}
+
+
+size_t atou64_batch(const string_view& string, uint64_t* values, size_t count, char delimiter, uint8_t base) noexcept
+{
+    const char* first = string.begin();
+    const char* last = string.end();
+    return atou64_batch(first, last, values, count, delimiter, base);
+}
+
+
+size_t atoi64_batch(const char* first, const char*& last, int64_t* values, size_t count, char delimiter, uint8_t base) noexcept
+{
+    return atoi_batch_<int64_t>(first, last, values, count, delimiter, base);
+}
+
+
+size_t atoi64_batch(const string_view& string, int64_t* values, size_t count, char delimiter, uint8_t base) noexcept
+{
+    const char* first = string.begin();
+    const char* last = string.end();
+    return atoi64_batch(first, last, values, count, delimiter, base);
+}
+
+
 // Compatiblility for `ftoa.cc`
 // We can have overflow with any integer type for
 // `float` and `double`, so we need to use `double`
@@ -4,12 +4,39 @@
  *  \addtogroup PyCPP
  *  \brief Fast lexical string-to-integer conversion routines.
  *
- *  These routines are naive, yet 30-50% faster than the STL versions,
- *  thread-safe, and locale-independent, and should be generally
- *  preferred to `std::stol` or `atol`. See out `bench/lexical.cc` for
- *  benchmarks comparing PyCPP to the STL versions.
+ *  These routines are thread-safe and locale-independent, and should be
+ *  generally preferred to `std::stol` or `atol`. Decimal and hex values
+ *  are parsed 8 digits at a time, and are ~2-4x faster than the STL
+ *  versions. See our `bench/lexical.cc` for benchmarks comparing PyCPP
+ *  to the STL versions.
+ *
+ *  Values out of range for the type wrap, and `last` is set to the
+ *  first character that is not part of the number.
+ *
+ *  The batch routines parse up to `count` values separated by
+ *  `delimiter` into `values`, stopping at the first empty field,
+ *  value out of range for the type, or character that is neither
+ *  a digit nor the delimiter. Unlike the scalar routines, they never
+ *  wrap: a field that overflows is rejected, like an empty field.
+ *  They return the number of values parsed, and set `last` past
+ *  the final value.
+ *
+ *  \synopsis
+ *      uint8_t atou8(const char* first, const char*& last, uint8_t base = 10) noexcept;
+ *      uint8_t atou8(const string_view& string, uint8_t base = 10) noexcept;
+ *      ...
+ *      int64_t atoi64(const char* first, const char*& last, uint8_t base = 10) noexcept;
+ *      int64_t atoi64(const string_view& string, uint8_t base = 10) noexcept;
+ *
+ *      size_t atou32_batch(const char* first, const char*& last, uint32_t* values, size_t count, char delimiter = ',', uint8_t base = 10) noexcept;
+ *      size_t atou32_batch(const string_view& string, uint32_t* values, size_t count, char delimiter = ',', uint8_t base = 10) noexcept;
+ *      ...
+ *      size_t atoi64_batch(const char* first, const char*& last, int64_t* values, size_t count, char delimiter = ',', uint8_t base = 10) noexcept;
+ *      size_t atoi64_batch(const string_view& string, int64_t* values, size_t count, char delimiter = ',', uint8_t base = 10) noexcept;
  */
 
+#pragma once
+
 #include <pycpp/stl/string_view.h>
 #include <stdint.h>
 
@@ -66,4 +93,28 @@ uint64_t atou64(const string_view& string, uint8_t base = 10) noexcept;
 int64_t atoi64(const char* first, const char*& last, uint8_t base = 10) noexcept;
 int64_t atoi64(const string_view& string, uint8_t base = 10) noexcept;
 
+/**
+ *  \brief Convert delimited string to array of unsigned 32-bit values.
+ */
+size_t atou32_batch(const char* first, const char*& last, uint32_t* values, size_t count, char delimiter = ',', uint8_t base = 10) noexcept;
+size_t atou32_batch(const string_view& string, uint32_t* values, size_t count, char delimiter = ',', uint8_t base = 10) noexcept;
+
+/**
+ *  \brief Convert delimited string to array of signed 32-bit values.
+ */
+size_t atoi32_batch(const char* first, const char*& last, int32_t* values, size_t count, char delimiter = ',', uint8_t base = 10) noexcept;
+size_t atoi32_batch(const string_view& string, int32_t* values, size_t count, char delimiter = ',', uint8_t base = 10) noexcept;
+
+/**
+ *  \brief Convert delimited string to array of unsigned 64-bit values.
+ */
+size_t atou64_batch(const char* first, const char*& last, uint64_t* values, size_t count, char delimiter = ',', uint8_t base = 10) noexcept;
+size_t atou64_batch(const string_view& string, uint64_t* values, size_t count, char delimiter = ',', uint8_t base = 10) noexcept;
+
+/**
+ *  \brief Convert delimited string to array of signed 64-bit values.
+ */
+size_t atoi64_batch(const char* first, const char*& last, int64_t* values, size_t count, char delimiter = ',', uint8_t base = 10) noexcept;
+size_t atoi64_batch(const string_view& string, int64_t* values, size_t count, char delimiter = ',', uint8_t base = 10) noexcept;
+
 PYCPP_END_NAMESPACE
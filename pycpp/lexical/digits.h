@@ -0,0 +1,26 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Digit writers shared by the integer and float formatters.
+ */
+
+#pragma once
+
+#include <pycpp/config.h>
+#include <stdint.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// FUNCTIONS
+// ---------
+
+/**
+ *  \brief Write the decimal digits of `value` to `first`.
+ *
+ *  Does not write a null terminator, and returns the number of
+ *  digits written.
+ */
+int u64toa_digits(uint64_t value, char* first) noexcept;
+
+PYCPP_END_NAMESPACE
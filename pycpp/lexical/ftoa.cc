@@ -1,18 +1,25 @@
 //  :copyright: (c) 2011 V8 Project Authors
 //  :copyright: (c) 2013 Andreas Samoljuk
+//  :copyright: (c) 2018 Ulf Adams
 //  :copyright: (c) 2017 Alex Huszagh.
 //  :license: MIT, see licenses/mit.md for more details.
 /**
- *  The optimized routines are from Andrea Samoljuk's `fpconv` library,
- *  which is available here:
+ *  Decimal output uses Ulf Adams's Ryu algorithm, which always
+ *  produces the shortest representation that round-trips, and
+ *  is available here:
+ *      `https://github.com/ulfjack/ryu`
+ *
+ *  The digit layout routines are from Andrea Samoljuk's `fpconv`
+ *  library, which is available here:
  *      `https://github.com/night-shift/fpconv`
  */
-
+#include <pycpp/lexical/digits.h>
 #include <pycpp/lexical/itoa.h>
 #include <pycpp/lexical/float.h>
 #include <pycpp/lexical/format.h>
 #include <pycpp/lexical/ftoa.h>
 #include <pycpp/lexical/table.h>
+#include <pycpp/preprocessor/compiler.h>
 #include <pycpp/preprocessor/os.h>
 #include <pycpp/stl/algorithm.h>
 #include <pycpp/stl/string_view.h>
@@ -23,37 +30,30 @@
 
 PYCPP_BEGIN_NAMESPACE
 
-// MACROS
-// ------
-
-#define npowers     87
-#define steppowers  8
-#define firstpower -348 /* 10 ^ -348 */
-#define expmax     -32
-#define expmin     -60
-#define fracmask  0x000FFFFFFFFFFFFFU
-#define expmask   0x7FF0000000000000U
-#define hiddenbit 0x0010000000000000U
-#define signmask  0x8000000000000000U
-#define expbias   (1023 + 52)
-#define absv(n) ((n) < 0 ? -(n) : (n))
-#define minv(a, b) ((a) < (b) ? (a) : (b))
-
 // OBJECTS
 // -------
 
-struct fp_t
-{
-    uint64_t frac;
-    int exp;
-};
-
 union dbits_t
 {
     double d;
     uint64_t i;
 };
 
+union fbits_t
+{
+    float f;
+    uint32_t i;
+};
+
+/**
+ *  \brief Shortest decimal representation, as `mantissa * 10^exponent`.
+ */
+struct decimal_fp
+{
+    uint64_t mantissa;
+    int32_t exponent;
+};
+
 // CONSTANTS
 // ---------
 
@@ -68,66 +68,23 @@ static constexpr int SIGNIFICAND_SIZE = 53;
 static constexpr int EXPONENT_BIAS = 0x3FF + PHYSICAL_SIGNIFICAND_SIZE;
 static constexpr int DENORMAL_EXPONENT = -EXPONENT_BIAS + 1;
 
+// RYU CONSTANTS
+static constexpr int DOUBLE_MANTISSA_BITS = 52;
+static constexpr int DOUBLE_BIAS = 1023;
+static constexpr int FLOAT_MANTISSA_BITS = 23;
+static constexpr int FLOAT_BIAS = 127;
+static constexpr int FLOAT_POW5_INV_BITCOUNT = RYU_POW5_INV_BITCOUNT - 64;
+static constexpr int FLOAT_POW5_BITCOUNT = RYU_POW5_BITCOUNT - 64;
+
 // BUFFER PARAMETERS
 static constexpr size_t BUFFER_SIZE = MAX_FLOAT_SIZE;
 
-// LOOKUPS
-static constexpr uint64_t TENS[] = {
-    10000000000000000000U, 1000000000000000000U, 100000000000000000U,
-    10000000000000000U, 1000000000000000U, 100000000000000U,
-    10000000000000U, 1000000000000U, 100000000000U,
-    10000000000U, 1000000000U, 100000000U,
-    10000000U, 1000000U, 100000U,
-    10000U, 1000U, 100U,
-    10U, 1U
-};
+// General and scientific decimal notation require at most 25 characters.
+static constexpr size_t DECIMAL_BUFFER_SIZE = 32;
 
-static constexpr fp_t POWERS_TEN[] = {
-    { 18054884314459144840U, -1220 }, { 13451937075301367670U, -1193 },
-    { 10022474136428063862U, -1166 }, { 14934650266808366570U, -1140 },
-    { 11127181549972568877U, -1113 }, { 16580792590934885855U, -1087 },
-    { 12353653155963782858U, -1060 }, { 18408377700990114895U, -1034 },
-    { 13715310171984221708U, -1007 }, { 10218702384817765436U, -980 },
-    { 15227053142812498563U, -954 },  { 11345038669416679861U, -927 },
-    { 16905424996341287883U, -901 },  { 12595523146049147757U, -874 },
-    { 9384396036005875287U,  -847 },  { 13983839803942852151U, -821 },
-    { 10418772551374772303U, -794 },  { 15525180923007089351U, -768 },
-    { 11567161174868858868U, -741 },  { 17236413322193710309U, -715 },
-    { 12842128665889583758U, -688 },  { 9568131466127621947U,  -661 },
-    { 14257626930069360058U, -635 },  { 10622759856335341974U, -608 },
-    { 15829145694278690180U, -582 },  { 11793632577567316726U, -555 },
-    { 17573882009934360870U, -529 },  { 13093562431584567480U, -502 },
-    { 9755464219737475723U,  -475 },  { 14536774485912137811U, -449 },
-    { 10830740992659433045U, -422 },  { 16139061738043178685U, -396 },
-    { 12024538023802026127U, -369 },  { 17917957937422433684U, -343 },
-    { 13349918974505688015U, -316 },  { 9946464728195732843U,  -289 },
-    { 14821387422376473014U, -263 },  { 11042794154864902060U, -236 },
-    { 16455045573212060422U, -210 },  { 12259964326927110867U, -183 },
-    { 18268770466636286478U, -157 },  { 13611294676837538539U, -130 },
-    { 10141204801825835212U, -103 },  { 15111572745182864684U, -77 },
-    { 11258999068426240000U, -50 },   { 16777216000000000000U, -24 },
-    { 12500000000000000000U,   3 },   { 9313225746154785156U,   30 },
-    { 13877787807814456755U,  56 },   { 10339757656912845936U,  83 },
-    { 15407439555097886824U, 109 },   { 11479437019748901445U, 136 },
-    { 17105694144590052135U, 162 },   { 12744735289059618216U, 189 },
-    { 9495567745759798747U,  216 },   { 14149498560666738074U, 242 },
-    { 10542197943230523224U, 269 },   { 15709099088952724970U, 295 },
-    { 11704190886730495818U, 322 },   { 17440603504673385349U, 348 },
-    { 12994262207056124023U, 375 },   { 9681479787123295682U,  402 },
-    { 14426529090290212157U, 428 },   { 10748601772107342003U, 455 },
-    { 16016664761464807395U, 481 },   { 11933345169920330789U, 508 },
-    { 17782069995880619868U, 534 },   { 13248674568444952270U, 561 },
-    { 9871031767461413346U,  588 },   { 14708983551653345445U, 614 },
-    { 10959046745042015199U, 641 },   { 16330252207878254650U, 667 },
-    { 12166986024289022870U, 694 },   { 18130221999122236476U, 720 },
-    { 13508068024458167312U, 747 },   { 10064294952495520794U, 774 },
-    { 14996968138956309548U, 800 },   { 11173611982879273257U, 827 },
-    { 16649979327439178909U, 853 },   { 12405201291620119593U, 880 },
-    { 9242595204427927429U,  907 },   { 13772540099066387757U, 933 },
-    { 10261342003245940623U, 960 },   { 15290591125556738113U, 986 },
-    { 11392378155556871081U, 1013 },  { 16975966327722178521U, 1039 },
-    { 12648080533535911531U, 1066 }
-};
+// Fixed notation may write every integral digit of DBL_MAX (309),
+// or the leading zeros of the smallest denormal (326).
+static constexpr size_t FIXED_BUFFER_SIZE = 352;
 
 // HELPERS
 // -------
@@ -143,34 +100,7 @@ char e_notation_char(uint8_t base) noexcept
     return base >= 15 ? '^' : 'e';
 }
 
-// FPCONV GRISU
-
-static fp_t find_cachedpow10(int exp, int* k) noexcept
-{
-    const double one_log_ten = 0.30102999566398114;
-
-    int approx = static_cast<int>(-(exp + npowers) * one_log_ten);
-    int idx = (approx - firstpower) / steppowers;
-
-    while(true) {
-        int current = exp + POWERS_TEN[idx].exp + 64;
-
-        if(current < expmin) {
-            idx++;
-            continue;
-        }
-
-        if(current > expmax) {
-            idx--;
-            continue;
-        }
-
-        *k = (firstpower + idx * steppowers);
-
-        return POWERS_TEN[idx];
-    }
-}
-
+// BITS
 
 static inline uint64_t get_dbits(double d) noexcept
 {
@@ -187,221 +117,434 @@ static inline double get_u64bits(uint64_t u64) noexcept
 }
 
 
-static fp_t build_fp(double d) noexcept
+static inline uint32_t get_fbits(float f) noexcept
 {
-    uint64_t bits = get_dbits(d);
+    fbits_t flt_bits = {f};
+    return flt_bits.i;
+}
 
-    fp_t fp;
-    fp.frac = bits & fracmask;
-    fp.exp = (bits & expmask) >> 52;
+// RYU
 
-    if (fp.exp) {
-        fp.frac += hiddenbit;
-        fp.exp -= expbias;
+/**
+ *  \brief floor(log10(2^e)), for 0 <= e <= 1650.
+ */
+static inline uint32_t log10_pow2(int32_t e) noexcept
+{
+    return (static_cast<uint32_t>(e) * 78913) >> 18;
+}
 
-    } else {
-        fp.exp = -expbias + 1;
-    }
 
-    return fp;
+/**
+ *  \brief floor(log10(5^e)), for 0 <= e <= 2620.
+ */
+static inline uint32_t log10_pow5(int32_t e) noexcept
+{
+    return (static_cast<uint32_t>(e) * 732923) >> 20;
 }
 
-static void normalize(fp_t* fp) noexcept
-{
-    while ((fp->frac & hiddenbit) == 0) {
-        fp->frac <<= 1;
-        fp->exp--;
-    }
 
-    int shift = 64 - 52 - 1;
-    fp->frac <<= shift;
-    fp->exp -= shift;
+/**
+ *  \brief Number of bits in 5^e, for 0 <= e <= 3528.
+ */
+static inline int32_t pow5_bits(int32_t e) noexcept
+{
+    return static_cast<int32_t>(((static_cast<uint32_t>(e) * 1217359) >> 19) + 1);
 }
 
 
-static void get_normalized_boundaries(fp_t* fp, fp_t* lower, fp_t* upper) noexcept
+static inline uint32_t pow5_factor(uint64_t value) noexcept
 {
-    upper->frac = (fp->frac << 1) + 1;
-    upper->exp  = fp->exp - 1;
-
-    while ((upper->frac & (hiddenbit << 1)) == 0) {
-        upper->frac <<= 1;
-        upper->exp--;
+    uint32_t count = 0;
+    while (value % 5 == 0) {
+        value /= 5;
+        ++count;
     }
-
-    int u_shift = 64 - 52 - 2;
-
-    upper->frac <<= u_shift;
-    upper->exp = upper->exp - u_shift;
-
-
-    int l_shift = fp->frac == hiddenbit ? 2 : 1;
-
-    lower->frac = (fp->frac << l_shift) - 1;
-    lower->exp = fp->exp - l_shift;
-
-
-    lower->frac <<= lower->exp - upper->exp;
-    lower->exp = upper->exp;
+    return count;
 }
 
 
-static fp_t multiply(fp_t* a, fp_t* b) noexcept
+static inline bool multiple_of_pow5(uint64_t value, uint32_t p) noexcept
 {
-    const uint64_t lomask = 0x00000000FFFFFFFF;
-
-    uint64_t ah_bl = (a->frac >> 32)    * (b->frac & lomask);
-    uint64_t al_bh = (a->frac & lomask) * (b->frac >> 32);
-    uint64_t al_bl = (a->frac & lomask) * (b->frac & lomask);
-    uint64_t ah_bh = (a->frac >> 32)    * (b->frac >> 32);
-
-    uint64_t tmp = (ah_bl & lomask) + (al_bh & lomask) + (al_bl >> 32);
-    /* round up */
-    tmp += 1U << 31;
+    return pow5_factor(value) >= p;
+}
 
-    fp_t fp = {
-        ah_bh + (ah_bl >> 32) + (al_bh >> 32) + (tmp >> 32),
-        a->exp + b->exp + 64
-    };
 
-    return fp;
+static inline bool multiple_of_pow2(uint64_t value, uint32_t p) noexcept
+{
+    return (value & ((uint64_t(1) << p) - 1)) == 0;
 }
 
 
-static void round_digit(char* digits, int ndigits, uint64_t delta, uint64_t rem, uint64_t kappa, uint64_t frac) noexcept
+/**
+ *  \brief Compute `(m * mul) >> j`, for a 128-bit multiplier and j >= 64.
+ */
+static inline uint64_t mul_shift64(uint64_t m, const uint64_t* mul, int32_t j) noexcept
 {
-    while (rem < frac && delta - rem >= kappa &&
-           (rem + kappa < frac || frac - rem > rem + kappa - frac)) {
-
-        digits[ndigits - 1]--;
-        rem += kappa;
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 b0 = static_cast<unsigned __int128>(m) * mul[0];
+    unsigned __int128 b2 = static_cast<unsigned __int128>(m) * mul[1];
+    return static_cast<uint64_t>(((b0 >> 64) + b2) >> (j - 64));
+#else
+    // split into 32-bit limbs, to avoid a 128-bit type
+    auto multiply = [](uint64_t a, uint64_t b, uint64_t& hi) -> uint64_t {
+        uint64_t a_lo = static_cast<uint32_t>(a);
+        uint64_t a_hi = a >> 32;
+        uint64_t b_lo = static_cast<uint32_t>(b);
+        uint64_t b_hi = b >> 32;
+        uint64_t lo_lo = a_lo * b_lo;
+        uint64_t hi_lo = a_hi * b_lo;
+        uint64_t lo_hi = a_lo * b_hi;
+        uint64_t cross = (lo_lo >> 32) + static_cast<uint32_t>(hi_lo) + lo_hi;
+        hi = (hi_lo >> 32) + (cross >> 32) + a_hi * b_hi;
+        return (cross << 32) | static_cast<uint32_t>(lo_lo);
+    };
+    uint64_t high0, high1;
+    multiply(m, mul[0], high0);
+    uint64_t low1 = multiply(m, mul[1], high1);
+    uint64_t sum = high0 + low1;
+    if (sum < high0) {
+        ++high1;
     }
+    int32_t dist = j - 64;
+    return (high1 << (64 - dist)) | (sum >> dist);
+#endif
 }
 
 
-static int generate_digits(fp_t* fp, fp_t* upper, fp_t* lower, char* digits, int* K) noexcept
+/**
+ *  \brief Compute `(m * factor) >> shift`, for a 64-bit factor and shift > 32.
+ */
+static inline uint32_t mul_shift32(uint32_t m, uint64_t factor, int32_t shift) noexcept
 {
-    uint64_t wfrac = upper->frac - fp->frac;
-    uint64_t delta = upper->frac - lower->frac;
-
-    fp_t one;
-    one.frac = 1ULL << -upper->exp;
-    one.exp  = upper->exp;
-
-    uint64_t part1 = upper->frac >> -one.exp;
-    uint64_t part2 = upper->frac & (one.frac - 1);
-
-    int idx = 0, kappa = 10;
-    const uint64_t* divp;
-    /* 1000000000 */
-    for(divp = TENS + 10; kappa > 0; divp++) {
+    uint64_t bits0 = static_cast<uint64_t>(m) * static_cast<uint32_t>(factor);
+    uint64_t bits1 = static_cast<uint64_t>(m) * (factor >> 32);
+    uint64_t sum = (bits0 >> 32) + bits1;
+    return static_cast<uint32_t>(sum >> (shift - 32));
+}
 
-        uint64_t div = *divp;
-        unsigned digit = static_cast<unsigned>(part1 / div);
 
-        if (digit || idx) {
-            digits[idx++] = digit + '0';
+/**
+ *  \brief Shortest representation of a positive, finite double.
+ *
+ *  Computes the scaled value and its rounding interval in decimal,
+ *  then removes digits while the interval still contains a
+ *  shorter representation.
+ */
+static decimal_fp ryu_d2d(uint64_t ieee_mantissa, uint32_t ieee_exponent) noexcept
+{
+    int32_t e2;
+    uint64_t m2;
+    if (ieee_exponent == 0) {
+        e2 = 1 - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = static_cast<int32_t>(ieee_exponent) - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+        m2 = (uint64_t(1) << DOUBLE_MANTISSA_BITS) | ieee_mantissa;
+    }
+    const bool accept_bounds = (m2 & 1) == 0;
+
+    // step 2: determine the interval of valid decimal representations
+    const uint64_t mv = 4 * m2;
+    const uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    // step 3: convert to a decimal power base, using 128-bit arithmetic
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    bool vm_trailing_zeros = false;
+    bool vr_trailing_zeros = false;
+    if (e2 >= 0) {
+        const uint32_t q = log10_pow2(e2) - (e2 > 3);
+        e10 = static_cast<int32_t>(q);
+        const int32_t k = RYU_POW5_INV_BITCOUNT + pow5_bits(static_cast<int32_t>(q)) - 1;
+        const int32_t i = -e2 + static_cast<int32_t>(q) + k;
+        vr = mul_shift64(4 * m2, RYU_POW5_INV_SPLIT[q], i);
+        vp = mul_shift64(4 * m2 + 2, RYU_POW5_INV_SPLIT[q], i);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, RYU_POW5_INV_SPLIT[q], i);
+        if (q <= 21) {
+            // only one of mp, mv, and mm can be a multiple of 5
+            if (mv % 5 == 0) {
+                vr_trailing_zeros = multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_trailing_zeros = multiple_of_pow5(mv - 1 - mm_shift, q);
+            } else {
+                vp -= multiple_of_pow5(mv + 2, q);
+            }
         }
+    } else {
+        const uint32_t q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = static_cast<int32_t>(q) + e2;
+        const int32_t i = -e2 - static_cast<int32_t>(q);
+        const int32_t k = pow5_bits(i) - RYU_POW5_BITCOUNT;
+        const int32_t j = static_cast<int32_t>(q) - k;
+        vr = mul_shift64(4 * m2, RYU_POW5_SPLIT[i], j);
+        vp = mul_shift64(4 * m2 + 2, RYU_POW5_SPLIT[i], j);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, RYU_POW5_SPLIT[i], j);
+        if (q <= 1) {
+            // mv = 4 * m2 always has at least two trailing zeros
+            vr_trailing_zeros = true;
+            if (accept_bounds) {
+                vm_trailing_zeros = mm_shift == 1;
+            } else {
+                --vp;
+            }
+        } else if (q < 63) {
+            vr_trailing_zeros = multiple_of_pow2(mv, q);
+        }
+    }
 
-        part1 -= digit * div;
-        kappa--;
-
-        uint64_t tmp = (part1 <<-one.exp) + part2;
-        if (tmp <= delta) {
-            *K += kappa;
-            round_digit(digits, idx, delta, tmp, div << -one.exp, wfrac);
-
-            return idx;
+    // step 4: find the shortest representation in the interval
+    int32_t removed = 0;
+    uint8_t last_removed_digit = 0;
+    uint64_t output;
+    if (vm_trailing_zeros || vr_trailing_zeros) {
+        // general case, which happens rarely (~0.7%)
+        while (vp / 10 > vm / 10) {
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = static_cast<uint8_t>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vm_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = static_cast<uint8_t>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        if (vr_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) {
+            // round-to-even if the exact number is .....50..0
+            last_removed_digit = 4;
+        }
+        output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_removed_digit >= 5);
+    } else {
+        // common case, remove two digits at a time when possible
+        bool round_up = false;
+        if (vp / 100 > vm / 100) {
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10) {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
         }
+        output = vr + (vr == vm || round_up);
     }
 
-    /* 10 */
-    const uint64_t* unit = TENS + 18;
+    decimal_fp fp;
+    fp.mantissa = output;
+    fp.exponent = e10 + removed;
+    return fp;
+}
 
-    while(true) {
-        part2 *= 10;
-        delta *= 10;
-        kappa--;
 
-        unsigned digit = static_cast<unsigned>(part2 >> -one.exp);
-        if (digit || idx) {
-            digits[idx++] = digit + '0';
+/**
+ *  \brief Shortest representation of a positive, finite float.
+ *
+ *  Uses 32-bit arithmetic, with the upper words of the double
+ *  multipliers.
+ */
+static decimal_fp ryu_f2d(uint32_t ieee_mantissa, uint32_t ieee_exponent) noexcept
+{
+    int32_t e2;
+    uint32_t m2;
+    if (ieee_exponent == 0) {
+        e2 = 1 - FLOAT_BIAS - FLOAT_MANTISSA_BITS - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = static_cast<int32_t>(ieee_exponent) - FLOAT_BIAS - FLOAT_MANTISSA_BITS - 2;
+        m2 = (uint32_t(1) << FLOAT_MANTISSA_BITS) | ieee_mantissa;
+    }
+    const bool accept_bounds = (m2 & 1) == 0;
+
+    // step 2: determine the interval of valid decimal representations
+    const uint32_t mv = 4 * m2;
+    const uint32_t mp = 4 * m2 + 2;
+    const uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+    const uint32_t mm = 4 * m2 - 1 - mm_shift;
+
+    // step 3: convert to a decimal power base
+    // The inverse multipliers are stored as 2^k / 5^q + 1, so the
+    // upper word needs to be incremented to get the same bound.
+    uint32_t vr, vp, vm;
+    int32_t e10;
+    bool vm_trailing_zeros = false;
+    bool vr_trailing_zeros = false;
+    uint8_t last_removed_digit = 0;
+    if (e2 >= 0) {
+        const uint32_t q = log10_pow2(e2);
+        e10 = static_cast<int32_t>(q);
+        const int32_t k = FLOAT_POW5_INV_BITCOUNT + pow5_bits(static_cast<int32_t>(q)) - 1;
+        const int32_t i = -e2 + static_cast<int32_t>(q) + k;
+        const uint64_t factor = RYU_POW5_INV_SPLIT[q][1] + 1;
+        vr = mul_shift32(mv, factor, i);
+        vp = mul_shift32(mp, factor, i);
+        vm = mul_shift32(mm, factor, i);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            // we need to know one removed digit, even if we will not
+            // remove any digits below
+            const int32_t l = FLOAT_POW5_INV_BITCOUNT + pow5_bits(static_cast<int32_t>(q - 1)) - 1;
+            const uint64_t f = RYU_POW5_INV_SPLIT[q - 1][1] + 1;
+            last_removed_digit = static_cast<uint8_t>(mul_shift32(mv, f, -e2 + static_cast<int32_t>(q) - 1 + l) % 10);
         }
-
-        part2 &= one.frac - 1;
-        if (part2 < delta) {
-            *K += kappa;
-            round_digit(digits, idx, delta, part2, one.frac, wfrac * *unit);
-
-            return idx;
+        if (q <= 9) {
+            // only one of mp, mv, and mm can be a multiple of 5
+            if (mv % 5 == 0) {
+                vr_trailing_zeros = multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_trailing_zeros = multiple_of_pow5(mm, q);
+            } else {
+                vp -= multiple_of_pow5(mp, q);
+            }
+        }
+    } else {
+        const uint32_t q = log10_pow5(-e2);
+        e10 = static_cast<int32_t>(q) + e2;
+        const int32_t i = -e2 - static_cast<int32_t>(q);
+        const int32_t k = pow5_bits(i) - FLOAT_POW5_BITCOUNT;
+        int32_t j = static_cast<int32_t>(q) - k;
+        const uint64_t factor = RYU_POW5_SPLIT[i][1];
+        vr = mul_shift32(mv, factor, j);
+        vp = mul_shift32(mp, factor, j);
+        vm = mul_shift32(mm, factor, j);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            j = static_cast<int32_t>(q) - 1 - (pow5_bits(i + 1) - FLOAT_POW5_BITCOUNT);
+            last_removed_digit = static_cast<uint8_t>(mul_shift32(mv, RYU_POW5_SPLIT[i + 1][1], j) % 10);
+        }
+        if (q <= 1) {
+            // mv = 4 * m2 always has at least two trailing zeros
+            vr_trailing_zeros = true;
+            if (accept_bounds) {
+                vm_trailing_zeros = mm_shift == 1;
+            } else {
+                --vp;
+            }
+        } else if (q < 31) {
+            vr_trailing_zeros = multiple_of_pow2(mv, q - 1);
         }
-
-        unit--;
     }
-}
 
-static int grisu2(double d, char* digits, int* K) noexcept
-{
-    fp_t w = build_fp(d);
+    // step 4: find the shortest representation in the interval
+    int32_t removed = 0;
+    uint32_t output;
+    if (vm_trailing_zeros || vr_trailing_zeros) {
+        while (vp / 10 > vm / 10) {
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = static_cast<uint8_t>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vm_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = static_cast<uint8_t>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        if (vr_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) {
+            // round-to-even if the exact number is .....50..0
+            last_removed_digit = 4;
+        }
+        output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_removed_digit >= 5);
+    } else {
+        while (vp / 10 > vm / 10) {
+            last_removed_digit = static_cast<uint8_t>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        output = vr + (vr == vm || last_removed_digit >= 5);
+    }
 
-    fp_t lower, upper;
-    get_normalized_boundaries(&w, &lower, &upper);
+    decimal_fp fp;
+    fp.mantissa = output;
+    fp.exponent = e10 + removed;
+    return fp;
+}
 
-    normalize(&w);
 
-    int k;
-    fp_t cp = find_cachedpow10(upper.exp, &k);
+static inline decimal_fp shortest_decimal(double d) noexcept
+{
+    uint64_t bits = get_dbits(d);
+    uint64_t mantissa = bits & SIGNIFICAND_MASK;
+    uint32_t exponent = static_cast<uint32_t>((bits & EXPONENT_MASK) >> PHYSICAL_SIGNIFICAND_SIZE);
+    return ryu_d2d(mantissa, exponent);
+}
 
-    w     = multiply(&w,     &cp);
-    upper = multiply(&upper, &cp);
-    lower = multiply(&lower, &cp);
 
-    lower.frac++;
-    upper.frac--;
+static inline decimal_fp shortest_decimal(float f) noexcept
+{
+    uint32_t bits = get_fbits(f);
+    uint32_t mantissa = bits & ((uint32_t(1) << FLOAT_MANTISSA_BITS) - 1);
+    uint32_t exponent = (bits >> FLOAT_MANTISSA_BITS) & 0xFF;
+    return ryu_f2d(mantissa, exponent);
+}
 
-    *K = -k;
+// DIGITS
 
-    return generate_digits(&w, &upper, &lower, digits, K);
+/**
+ *  \brief Write the decimal digits of the mantissa, without null-termination.
+ */
+static inline int write_digits(uint64_t value, char* digits) noexcept
+{
+    return u64toa_digits(value, digits);
 }
 
 
-static int emit_digits(char* digits, int ndigits, char* dest, int K) noexcept
+static int emit_fixed(const char* digits, int ndigits, char* dest, int K) noexcept
 {
-    int exp = absv(K + ndigits - 1);
-
     /* write plain integer */
-    if(K >= 0 && (exp < (ndigits + 7))) {
+    if (K >= 0) {
         memcpy(dest, digits, ndigits);
         memset(dest + ndigits, '0', K);
 
         return ndigits + K;
     }
 
-    /* write decimal w/o scientific notation */
-    if(K < 0 && (K > -7 || exp < 4)) {
-        int offset = ndigits - absv(K);
-        /* fp < 1.0 -> write leading zero */
-        if(offset <= 0) {
-            offset = -offset;
-            dest[0] = '0';
-            dest[1] = '.';
-            memset(dest + 2, '0', offset);
-            memcpy(dest + offset + 2, digits, ndigits);
+    int offset = ndigits + K;
+    /* fp < 1.0 -> write leading zero */
+    if (offset <= 0) {
+        offset = -offset;
+        dest[0] = '0';
+        dest[1] = '.';
+        memset(dest + 2, '0', offset);
+        memcpy(dest + offset + 2, digits, ndigits);
 
-            return ndigits + 2 + offset;
+        return ndigits + 2 + offset;
 
-        /* fp > 1.0 */
-        } else {
-            memcpy(dest, digits, offset);
-            dest[offset] = '.';
-            memcpy(dest + offset + 1, digits + offset, ndigits - offset);
+    /* fp > 1.0 */
+    } else {
+        memcpy(dest, digits, offset);
+        dest[offset] = '.';
+        memcpy(dest + offset + 1, digits + offset, ndigits - offset);
 
-            return ndigits + 1;
-        }
+        return ndigits + 1;
     }
+}
 
-    /* write decimal w/ scientific notation */
-    ndigits = minv(ndigits, 18);
+
+static int emit_scientific(const char* digits, int ndigits, char* dest, int K) noexcept
+{
+    int exp = K + ndigits - 1;
+    exp = exp < 0 ? -exp : exp;
 
     int idx = 0;
     dest[idx++] = digits[0];
@@ -438,6 +581,31 @@ static int emit_digits(char* digits, int ndigits, char* dest, int K) noexcept
     return idx;
 }
 
+
+static int emit_digits(const char* digits, int ndigits, char* dest, int K, float_format format) noexcept
+{
+    switch (format) {
+        case float_fixed:
+            return emit_fixed(digits, ndigits, dest, K);
+        case float_scientific:
+            return emit_scientific(digits, ndigits, dest, K);
+        default:
+            break;
+    }
+
+    // use fixed notation for integers below 10^(ndigits + 7),
+    // and values above 10^-7
+    int exp = K + ndigits - 1;
+    exp = exp < 0 ? -exp : exp;
+    if (K >= 0 && (exp < (ndigits + 7))) {
+        return emit_fixed(digits, ndigits, dest, K);
+    } else if (K < 0 && (K > -7 || exp < 4)) {
+        return emit_fixed(digits, ndigits, dest, K);
+    }
+    return emit_scientific(digits, ndigits, dest, K);
+}
+
+
 static int filter_special(double fp, char* dest) noexcept
 {
     if(fp == 0.0) {
@@ -447,13 +615,13 @@ static int filter_special(double fp, char* dest) noexcept
 
     uint64_t bits = get_dbits(fp);
 
-    bool nan = (bits & expmask) == expmask;
+    bool nan = (bits & EXPONENT_MASK) == EXPONENT_MASK;
 
     if(!nan) {
         return 0;
     }
 
-    if(bits & fracmask) {
+    if(bits & SIGNIFICAND_MASK) {
         memcpy(dest, NAN_STRING.data(), NAN_STRING.size());
         return static_cast<int>(NAN_STRING.size());
 
@@ -464,23 +632,6 @@ static int filter_special(double fp, char* dest) noexcept
 }
 
 
-int fpconv_dtoa(double d, char* dest) noexcept
-{
-    char digits[18];
-    int str_len = 0;
-    int spec = filter_special(d, dest + str_len);
-    if(spec) {
-        return str_len + spec;
-    }
-
-    int K = 0;
-    int ndigits = grisu2(d, digits, &K);
-    str_len += emit_digits(digits, ndigits, dest + str_len, K);
-
-    return str_len;
-}
-
-
 // V8 RADIX
 
 
@@ -770,10 +921,23 @@ static void ftoa_naive(double d, char* first, char*& last, uint8_t base) noexcep
 // BASEN
 
 
-static void ftoa_base10(double value, char* first, char*& last) noexcept
+template <typename Float>
+static void ftoa_base10(Float value, char* first, char*& last, float_format format) noexcept
 {
-    int len = fpconv_dtoa(value, first);
-    last = first + len;
+    int length = 0;
+    if (value == 0) {
+        length = emit_digits("0", 1, first, 0, format);
+    } else {
+        length = filter_special(value, first);
+    }
+
+    if (!length) {
+        char digits[20];
+        decimal_fp fp = shortest_decimal(value);
+        int ndigits = write_digits(fp.mantissa, digits);
+        length = emit_digits(digits, ndigits, first, fp.exponent, format);
+    }
+    last = first + length;
 }
 
 
@@ -783,10 +947,11 @@ static void ftoa_basen(double value, char* first, char*& last, uint8_t base) noe
 }
 
 
-static void ftoa_impl(double value, char* first, char*& last, uint8_t base) noexcept
+template <typename Float>
+static void ftoa_impl(Float value, char* first, char*& last, uint8_t base, float_format format, size_t size) noexcept
 {
     // disable this check in release builds, since it's a logic error
-    assert(last - first >= BUFFER_SIZE && "Need a larger buffer.");
+    assert(static_cast<size_t>(last - first) >= size && "Need a larger buffer.");
 
     // handle negative numbers
     char* tmp = last - 1;
@@ -798,8 +963,8 @@ static void ftoa_impl(double value, char* first, char*& last, uint8_t base) noex
 
     // use optimized functions if possible
     switch (base) {
-        case 10:        ftoa_base10(value, first, tmp);         break;
-        default:        ftoa_basen(value, first, tmp, base);    break;
+        case 10:        ftoa_base10(value, first, tmp, format);     break;
+        default:        ftoa_basen(value, first, tmp, base);        break;
     }
 
     // add a trailing null character
@@ -808,66 +973,101 @@ static void ftoa_impl(double value, char* first, char*& last, uint8_t base) noex
 }
 
 
-void ftoa_(double value, char* first, char*& last, uint8_t base) noexcept
+template <typename Float>
+static void ftoa_(Float value, char* first, char*& last, uint8_t base, float_format format) noexcept
 {
     // sanity checks
     assert(first <= last);
 
+    // fixed notation may need far more digits than the other formats
+    char buffer[FIXED_BUFFER_SIZE];
+    size_t size = BUFFER_SIZE;
+    if (base == 10) {
+        size = format == float_fixed ? FIXED_BUFFER_SIZE : DECIMAL_BUFFER_SIZE;
+    }
+
     // check to use a temporary buffer
     size_t dist = distance(first, last);
     if (dist == 0) {
         // cannot write null terminator
         return;
-    } if (dist < BUFFER_SIZE) {
+    } if (dist < size) {
         // use a temporary buffer and write number to buffer
-        char buffer[BUFFER_SIZE];
         char* first_ = buffer;
-        char* last_ = first_ + BUFFER_SIZE;
-        ftoa_impl(value, first_, last_, base);
+        char* last_ = first_ + size;
+        ftoa_impl(value, first_, last_, base, format, size);
 
         // copy as many bytes as possible except the trailing null byte
         // then, write null-byte so the string is always terminated
-        size_t length = min<size_t>(distance(first_, last_), dist) - 1;
+        size_t length = min<size_t>(distance(first_, last_), dist - 1);
         memcpy(first, first_, length);
         last = first + length;
         *last = '\0';
     } else {
         // current buffer has sufficient capacity, use it
-        ftoa_impl(value, first, last, base);
+        ftoa_impl(value, first, last, base, format, size);
     }
 }
 
+
+template <typename Float>
+static string ftoa_string(Float value, uint8_t base, float_format format)
+{
+    char buffer[FIXED_BUFFER_SIZE];
+    char* last = buffer + FIXED_BUFFER_SIZE;
+    ftoa_(value, buffer, last, base, format);
+    return string(buffer, last);
+}
+
 // FUNCTIONS
 // ---------
 
 
 void f32toa(float value, char* first, char*& last, uint8_t base) noexcept
 {
-    ftoa_(value, first, last, base);
+    ftoa_(value, first, last, base, float_general);
+}
+
+
+void f32toa(float value, char* first, char*& last, float_format format) noexcept
+{
+    ftoa_(value, first, last, 10, format);
 }
 
 
 string f32toa(float value, uint8_t base)
 {
-    char buffer[BUFFER_SIZE];
-    char* last = buffer + BUFFER_SIZE;
-    f32toa(value, buffer, last, base);
-    return string(buffer, last);
+    return ftoa_string(value, base, float_general);
+}
+
+
+string f32toa(float value, float_format format)
+{
+    return ftoa_string(value, 10, format);
 }
 
 
 void f64toa(double value, char* first, char*& last, uint8_t base) noexcept
 {
-    ftoa_(value, first, last, base);
+    ftoa_(value, first, last, base, float_general);
+}
+
+
+void f64toa(double value, char* first, char*& last, float_format format) noexcept
+{
+    ftoa_(value, first, last, 10, format);
 }
 
 
 string f64toa(double value, uint8_t base)
 {
-    char buffer[BUFFER_SIZE];
-    char* last = buffer + BUFFER_SIZE;
-    f64toa(value, buffer, last, base);
-    return string(buffer, last);
+    return ftoa_string(value, base, float_general);
+}
+
+
+string f64toa(double value, float_format format)
+{
+    return ftoa_string(value, 10, format);
 }
 
 
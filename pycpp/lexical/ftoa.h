@@ -7,12 +7,54 @@
  *  This module will set `last` to the be the element past-the-end
  *  of the number (containing a null character), and will always write
  *  a null terminator.
+ *
+ *  Decimal output is the shortest representation that round-trips
+ *  to the same value, using the Ryu algorithm, with a dedicated
+ *  path for 32-bit floats. General notation uses fixed notation for
+ *  values of moderate magnitude, and scientific notation otherwise.
+ *  Fixed notation may require up to 330 characters for extreme
+ *  values, and output is truncated if the buffer is too small.
+ *
+ *  \synopsis
+ *      enum float_format
+ *      {
+ *          float_general = 0,
+ *          float_fixed,
+ *          float_scientific,
+ *      };
+ *
+ *      char e_notation_char(uint8_t base) noexcept;
+ *
+ *      void f32toa(float value, char* first, char*& last, uint8_t base = 10) noexcept;
+ *      void f32toa(float value, char* first, char*& last, float_format format) noexcept;
+ *      string f32toa(float value, uint8_t base = 10);
+ *      string f32toa(float value, float_format format);
+ *
+ *      void f64toa(double value, char* first, char*& last, uint8_t base = 10) noexcept;
+ *      void f64toa(double value, char* first, char*& last, float_format format) noexcept;
+ *      string f64toa(double value, uint8_t base = 10);
+ *      string f64toa(double value, float_format format);
  */
 
+#pragma once
+
 #include <pycpp/stl/string.h>
 
 PYCPP_BEGIN_NAMESPACE
 
+// ENUMS
+// -----
+
+/**
+ *  \brief Notation for decimal float-to-string conversions.
+ */
+enum float_format
+{
+    float_general = 0,
+    float_fixed,
+    float_scientific,
+};
+
 // FUNCTIONS
 // ---------
 
@@ -22,15 +64,27 @@ PYCPP_BEGIN_NAMESPACE
 char e_notation_char(uint8_t base) noexcept;
 
 /**
- *  \brief Convert unsigned 8-bit value to string.
+ *  \brief Convert 32-bit IEEE754 floating point value to string.
  */
 void f32toa(float value, char* first, char*& last, uint8_t base = 10) noexcept;
 string f32toa(float value, uint8_t base = 10);
 
 /**
- *  \brief Convert signed 8-bit value to string.
+ *  \brief Convert 32-bit float to a decimal string with the given notation.
+ */
+void f32toa(float value, char* first, char*& last, float_format format) noexcept;
+string f32toa(float value, float_format format);
+
+/**
+ *  \brief Convert 64-bit IEEE754 floating point value to string.
  */
 void f64toa(double value, char* first, char*& last, uint8_t base = 10) noexcept;
 string f64toa(double value, uint8_t base = 10);
 
+/**
+ *  \brief Convert 64-bit float to a decimal string with the given notation.
+ */
+void f64toa(double value, char* first, char*& last, float_format format) noexcept;
+string f64toa(double value, float_format format);
+
 PYCPP_END_NAMESPACE
@@ -1,13 +1,23 @@
 //  :copyright: (c) 2017 Alex Huszagh.
 //  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  Integer formatters compute the number of digits up-front, from the
+ *  bit length of the value, and then write each digit directly to its
+ *  final position, avoiding a temporary buffer and `reverse`.
+ *
+ *  Decimal values are split into 8-digit blocks using 32-bit arithmetic,
+ *  and each block is written as 4 independent digit pairs from the
+ *  `BASE10` table. Power-of-two bases are extracted with shifts and
+ *  masks, while other bases divide by the square of the base and write
+ *  digit pairs from the corresponding table.
+ */
 
+#include <pycpp/lexical/digits.h>
 #include <pycpp/lexical/itoa.h>
 #include <pycpp/lexical/table.h>
-#include <pycpp/stl/algorithm.h>
-#include <pycpp/stl/stdexcept.h>
+#include <pycpp/preprocessor/compiler.h>
 #include <assert.h>
-#include <math.h>
-#include <string.h>
+#include <limits.h>
 
 PYCPP_BEGIN_NAMESPACE
 
@@ -16,146 +26,331 @@ PYCPP_BEGIN_NAMESPACE
 
 // RANGE
 
-template <typename Int>
-inline uint32_t digits(Int value, uint8_t base) noexcept
+static const uint64_t POWERS_OF_10[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+
+/**
+ *  \brief Number of significant bits in the value, at least 1.
+ */
+static inline uint32_t bit_length(uint64_t value) noexcept
 {
-    if (value == 0) {
-        return 1;
+#if defined(HAVE_GCC) || defined(HAVE_CLANG)
+    return 64 - __builtin_clzll(value | 1);
+#else
+    uint32_t bits = 64;
+    for (uint64_t v = value | 1; !(v & 0x8000000000000000ULL); v <<= 1) {
+        --bits;
     }
-    return static_cast<uint32_t>(floor(log(value) / log(base)) + 1);
+    return bits;
+#endif
 }
 
-// GENERIC
 
 /**
- *  \brief Naive implementation for base-N numbers.
+ *  \brief Number of decimal digits in the value.
  */
-template <typename Int>
-static void itoa_naive(Int value, char* first, char*& last, uint8_t base) noexcept
+static inline uint32_t decimal_length(uint64_t value) noexcept
 {
-    // logic error, disable in release builds
-    assert((base >= 2 && base <= 36) && "Numerical base must be from 2-36");
+    // approximate log10 from log2, then correct with a comparison,
+    // `| 1` gives 0 a single digit without changing any other count
+    uint32_t length = (bit_length(value) * 1233) >> 12;
+    return length + ((value | 1) >= POWERS_OF_10[length]);
+}
 
-    uint32_t rem;
-    char* p = first;
-    while (value >= base) {
-        rem = value % base;
-        value /= base;
-        *p++ = BASEN[rem];
+
+/**
+ *  \brief Number of digits in the value for an arbitrary base.
+ */
+static inline uint32_t digit_count(uint64_t value, uint8_t base) noexcept
+{
+    switch (base) {
+        case 2:     return bit_length(value);
+        case 4:     return (bit_length(value) + 1) / 2;
+        case 8:     return (bit_length(value) + 2) / 3;
+        case 10:    return decimal_length(value);
+        case 16:    return (bit_length(value) + 3) / 4;
+        case 32:    return (bit_length(value) + 4) / 5;
+        default:    break;
     }
 
-    rem = value % base;
-    *p++ = BASEN[rem];
+    // multiply rather than divide, stopping before the power overflows
+    uint32_t count = 1;
+    uint64_t power = base;
+    while (value >= power) {
+        ++count;
+        if (power > ULLONG_MAX / base) {
+            break;
+        }
+        power *= base;
+    }
+    return count;
+}
 
-    reverse(first, p);
-    last = p;
+// DECIMAL
+
+/**
+ *  \brief Write 8 digits, ending at `last`.
+ */
+static inline void write_block8(uint32_t value, char* last) noexcept
+{
+    uint32_t hi = value / 10000;
+    uint32_t lo = value % 10000;
+    uint32_t r0 = 2 * (lo % 100);
+    uint32_t r1 = 2 * (lo / 100);
+    uint32_t r2 = 2 * (hi % 100);
+    uint32_t r3 = 2 * (hi / 100);
+    last[-1] = BASE10[r0 + 1];
+    last[-2] = BASE10[r0];
+    last[-3] = BASE10[r1 + 1];
+    last[-4] = BASE10[r1];
+    last[-5] = BASE10[r2 + 1];
+    last[-6] = BASE10[r2];
+    last[-7] = BASE10[r3 + 1];
+    last[-8] = BASE10[r3];
+}
+
+
+/**
+ *  \brief Write the remaining 1-8 digits, ending at `last`.
+ */
+static inline void write_small(uint32_t value, char* last) noexcept
+{
+    if (value >= 10000) {
+        uint32_t rem = value % 10000;
+        value /= 10000;
+        uint32_t r0 = 2 * (rem % 100);
+        uint32_t r1 = 2 * (rem / 100);
+        last[-1] = BASE10[r0 + 1];
+        last[-2] = BASE10[r0];
+        last[-3] = BASE10[r1 + 1];
+        last[-4] = BASE10[r1];
+        last -= 4;
+    }
+    if (value >= 100) {
+        uint32_t rem = 2 * (value % 100);
+        value /= 100;
+        last[-1] = BASE10[rem + 1];
+        last[-2] = BASE10[rem];
+        last -= 2;
+    }
+    if (value >= 10) {
+        uint32_t rem = 2 * value;
+        last[-1] = BASE10[rem + 1];
+        last[-2] = BASE10[rem];
+    } else {
+        last[-1] = static_cast<char>('0' + value);
+    }
 }
 
-// SPECIFIC
 
 /**
- *  \brief Optimized implementation for base10 numbers.
+ *  \brief Write the decimal digits of the value, ending at `last`.
  */
-template <typename Int, int base>
-static void itoa_optimized(Int value, char* first, char*& last, const char* table) noexcept
+static inline void write_decimal(uint64_t value, char* last) noexcept
+{
+    // write blocks of 8 digits using 32-bit arithmetic
+    while (value >= 100000000) {
+        uint64_t q = value / 100000000;
+        write_block8(static_cast<uint32_t>(value - q * 100000000), last);
+        value = q;
+        last -= 8;
+    }
+    write_small(static_cast<uint32_t>(value), last);
+}
+
+
+int u64toa_digits(uint64_t value, char* first) noexcept
 {
-    static int base2 = base * base;
+    uint32_t length = decimal_length(value);
+    write_decimal(value, first + length);
+    return static_cast<int>(length);
+}
+
+// POWER OF 2
 
-    if (value == 0) {
-        *first = '0';
-        last = first+1;
-        return;
+/**
+ *  \brief Write digits for bases 2, 4, 8, 16 and 32, ending at `last`.
+ */
+template <int shift>
+static inline void write_pow2(uint64_t value, char* last, const char* table) noexcept
+{
+    static constexpr uint64_t mask = (1ULL << shift) - 1;
+    static constexpr uint64_t mask2 = (1ULL << (2 * shift)) - 1;
+
+    while (value > mask2) {
+        uint32_t rem = static_cast<uint32_t>(2 * (value & mask2));
+        value >>= 2 * shift;
+        last[-1] = table[rem + 1];
+        last[-2] = table[rem];
+        last -= 2;
+    }
+    if (value > mask) {
+        uint32_t rem = static_cast<uint32_t>(2 * value);
+        last[-1] = table[rem + 1];
+        last[-2] = table[rem];
+    } else {
+        last[-1] = BASEN[value];
     }
+}
+
+// GENERIC
+
+/**
+ *  \brief Write digits for any other base, ending at `last`.
+ */
+template <typename Uint, int base>
+static inline void write_basen(Uint value, char* last, const char* table) noexcept
+{
+    static constexpr uint32_t base2 = base * base;
 
-    uint32_t rem;
-    char* p = first;
     while (value >= base2) {
-        rem = 2 * (value % base2);
+        uint32_t rem = static_cast<uint32_t>(2 * (value % base2));
         value /= base2;
-        *p++ = table[rem+1];
-        *p++ = table[rem];
+        last[-1] = table[rem + 1];
+        last[-2] = table[rem];
+        last -= 2;
+    }
+    if (value >= base) {
+        uint32_t rem = static_cast<uint32_t>(2 * value);
+        last[-1] = table[rem + 1];
+        last[-2] = table[rem];
+    } else {
+        last[-1] = BASEN[value];
     }
+}
 
-    while (value > 0) {
-        rem = value % base;
-        *p++ = BASEN[rem];
-        value /= base;
+
+/**
+ *  \brief Write the digits of an unsigned value, returning the new end.
+ */
+template <typename Uint>
+static char* write_unsigned(Uint v, char* first, uint8_t base) noexcept
+{
+    // logic error, disable in release builds
+    assert((base >= 2 && base <= 36) && "Numerical base must be from 2-36");
+
+    char* last = first + digit_count(v, base);
+    switch (base) {
+        // Ugly hack to convert runtime value to compile-time optimization
+        case 2:     write_pow2<1>(v, last, BASE2);                  break;
+        case 3:     write_basen<Uint, 3>(v, last, BASE3);           break;
+        case 4:     write_pow2<2>(v, last, BASE4);                  break;
+        case 5:     write_basen<Uint, 5>(v, last, BASE5);           break;
+        case 6:     write_basen<Uint, 6>(v, last, BASE6);           break;
+        case 7:     write_basen<Uint, 7>(v, last, BASE7);           break;
+        case 8:     write_pow2<3>(v, last, BASE8);                  break;
+        case 9:     write_basen<Uint, 9>(v, last, BASE9);           break;
+        case 10:    write_decimal(v, last);                         break;
+        case 11:    write_basen<Uint, 11>(v, last, BASE11);         break;
+        case 12:    write_basen<Uint, 12>(v, last, BASE12);         break;
+        case 13:    write_basen<Uint, 13>(v, last, BASE13);         break;
+        case 14:    write_basen<Uint, 14>(v, last, BASE14);         break;
+        case 15:    write_basen<Uint, 15>(v, last, BASE15);         break;
+        case 16:    write_pow2<4>(v, last, BASE16);                 break;
+        case 17:    write_basen<Uint, 17>(v, last, BASE17);         break;
+        case 18:    write_basen<Uint, 18>(v, last, BASE18);         break;
+        case 19:    write_basen<Uint, 19>(v, last, BASE19);         break;
+        case 20:    write_basen<Uint, 20>(v, last, BASE20);         break;
+        case 21:    write_basen<Uint, 21>(v, last, BASE21);         break;
+        case 22:    write_basen<Uint, 22>(v, last, BASE22);         break;
+        case 23:    write_basen<Uint, 23>(v, last, BASE23);         break;
+        case 24:    write_basen<Uint, 24>(v, last, BASE24);         break;
+        case 25:    write_basen<Uint, 25>(v, last, BASE25);         break;
+        case 26:    write_basen<Uint, 26>(v, last, BASE26);         break;
+        case 27:    write_basen<Uint, 27>(v, last, BASE27);         break;
+        case 28:    write_basen<Uint, 28>(v, last, BASE28);         break;
+        case 29:    write_basen<Uint, 29>(v, last, BASE29);         break;
+        case 30:    write_basen<Uint, 30>(v, last, BASE30);         break;
+        case 31:    write_basen<Uint, 31>(v, last, BASE31);         break;
+        case 32:    write_pow2<5>(v, last, BASE32);                 break;
+        case 33:    write_basen<Uint, 33>(v, last, BASE33);         break;
+        case 34:    write_basen<Uint, 34>(v, last, BASE34);         break;
+        case 35:    write_basen<Uint, 35>(v, last, BASE35);         break;
+        case 36:    write_basen<Uint, 36>(v, last, BASE36);         break;
     }
 
-    reverse(first, p);
-    last = p;
+    return last;
 }
 
 #include <warnings/push.h>
 #include <warnings/unary-minus-unsigned.h>
 
 template <typename Int, typename Uint>
-void itoa_(Int value, char* first, char*& last, uint8_t base) noexcept
+static void itoa_(Int value, char* first, char*& last, uint8_t base) noexcept
 {
+    // handle negative numbers, use an unsigned type to avoid overflow
+    Uint v = value < 0 ? -static_cast<Uint>(value) : static_cast<Uint>(value);
+
     // disable this check in release builds, since it's a logic
     // error and extraordinarily expensive
     assert(first <= last);
-    assert(last - first >= digits(value, base) && "Need a larger buffer.");
+    assert(last - first > (value < 0) + digit_count(v, base) && "Need a larger buffer.");
 
-    // handle negative numbers, use an unsigned type to avoid overflow
-    char* tmp = last - 1;
-    Uint v;
     if (value < 0) {
-        first[0]= '-';
-        v = -value;
-        first++;
-    } else {
-        v = value;
+        *first++ = '-';
     }
+    last = write_unsigned<Uint>(v, first, base);
 
-    // use optimized functions if possible
-    switch (base) {
-        // Ugly hack to convert runtime value to compile-time optimization
-        case 2:     itoa_optimized<Uint, 2>(v, first, tmp, BASE2);   break;
-        case 3:     itoa_optimized<Uint, 3>(v, first, tmp, BASE3);   break;
-        case 4:     itoa_optimized<Uint, 4>(v, first, tmp, BASE4);   break;
-        case 5:     itoa_optimized<Uint, 5>(v, first, tmp, BASE5);   break;
-        case 6:     itoa_optimized<Uint, 6>(v, first, tmp, BASE6);   break;
-        case 7:     itoa_optimized<Uint, 7>(v, first, tmp, BASE7);   break;
-        case 8:     itoa_optimized<Uint, 8>(v, first, tmp, BASE8);   break;
-        case 9:     itoa_optimized<Uint, 9>(v, first, tmp, BASE9);   break;
-        case 10:    itoa_optimized<Uint, 10>(v, first, tmp, BASE10); break;
-        case 11:    itoa_optimized<Uint, 11>(v, first, tmp, BASE11); break;
-        case 12:    itoa_optimized<Uint, 12>(v, first, tmp, BASE12); break;
-        case 13:    itoa_optimized<Uint, 13>(v, first, tmp, BASE13); break;
-        case 14:    itoa_optimized<Uint, 14>(v, first, tmp, BASE14); break;
-        case 15:    itoa_optimized<Uint, 15>(v, first, tmp, BASE15); break;
-        case 16:    itoa_optimized<Uint, 16>(v, first, tmp, BASE16); break;
-        case 17:    itoa_optimized<Uint, 17>(v, first, tmp, BASE17); break;
-        case 18:    itoa_optimized<Uint, 18>(v, first, tmp, BASE18); break;
-        case 19:    itoa_optimized<Uint, 19>(v, first, tmp, BASE19); break;
-        case 20:    itoa_optimized<Uint, 20>(v, first, tmp, BASE20); break;
-        case 21:    itoa_optimized<Uint, 21>(v, first, tmp, BASE21); break;
-        case 22:    itoa_optimized<Uint, 22>(v, first, tmp, BASE22); break;
-        case 23:    itoa_optimized<Uint, 23>(v, first, tmp, BASE23); break;
-        case 24:    itoa_optimized<Uint, 24>(v, first, tmp, BASE24); break;
-        case 25:    itoa_optimized<Uint, 25>(v, first, tmp, BASE25); break;
-        case 26:    itoa_optimized<Uint, 26>(v, first, tmp, BASE26); break;
-        case 27:    itoa_optimized<Uint, 27>(v, first, tmp, BASE27); break;
-        case 28:    itoa_optimized<Uint, 28>(v, first, tmp, BASE28); break;
-        case 29:    itoa_optimized<Uint, 29>(v, first, tmp, BASE29); break;
-        case 30:    itoa_optimized<Uint, 30>(v, first, tmp, BASE30); break;
-        case 31:    itoa_optimized<Uint, 31>(v, first, tmp, BASE31); break;
-        case 32:    itoa_optimized<Uint, 32>(v, first, tmp, BASE32); break;
-        case 33:    itoa_optimized<Uint, 33>(v, first, tmp, BASE33); break;
-        case 34:    itoa_optimized<Uint, 34>(v, first, tmp, BASE34); break;
-        case 35:    itoa_optimized<Uint, 35>(v, first, tmp, BASE35); break;
-        case 36:    itoa_optimized<Uint, 36>(v, first, tmp, BASE36); break;
-        default:    itoa_naive(v, first, tmp, base);                 break;
+    // add a trailing null character
+    *last = '\0';
+}
+
+
+template <typename Int, typename Uint>
+static size_t itoa_batch_(const Int* values, size_t count, char* first, char*& last, char delimiter, uint8_t base) noexcept
+{
+    assert(first < last);
+
+    // reserve space for the null terminator
+    char* p = first;
+    char* end = last - 1;
+    size_t i = 0;
+    for (; i < count; ++i) {
+        Int value = values[i];
+        Uint v = value < 0 ? -static_cast<Uint>(value) : static_cast<Uint>(value);
+        size_t length = (i != 0) + (value < 0) + digit_count(v, base);
+        if (length > static_cast<size_t>(end - p)) {
+            break;
+        }
+
+        if (i != 0) {
+            *p++ = delimiter;
+        }
+        if (value < 0) {
+            *p++ = '-';
+        }
+        p = write_unsigned<Uint>(v, p, base);
     }
 
-    // add a trailing null character
-    *tmp = '\0';
-    last = tmp;
+    *p = '\0';
+    last = p;
+    return i;
 }
 
 #include <warnings/pop.h>
 
+
+template <typename Int, typename Uint>
+static string itoa_batch_(const Int* values, size_t count, char delimiter, uint8_t base)
+{
+    // every value is at most 1 digit per bit, plus the sign and delimiter
+    size_t width = sizeof(Int) * 8 + 2;
+    string result(count * width + 1, '\0');
+    char* first = &result[0];
+    char* last = first + result.size();
+    itoa_batch_<Int, Uint>(values, count, first, last, delimiter, base);
+    result.resize(last - first);
+
+    return result;
+}
+
 // FUNCTIONS
 // ---------
 
@@ -183,8 +378,8 @@ void i8toa(int8_t value, char* first, char*& last, uint8_t base) noexcept
 
 string i8toa(int8_t value, uint8_t base)
 {
-    char buffer[9];
-    char* last = buffer + 9;
+    char buffer[10];
+    char* last = buffer + 10;
     i8toa(value, buffer, last, base);
     return string(buffer, last);
 }
@@ -213,8 +408,8 @@ void i16toa(int16_t value, char* first, char*& last, uint8_t base) noexcept
 
 string i16toa(int16_t value, uint8_t base)
 {
-    char buffer[17];
-    char* last = buffer + 17;
+    char buffer[18];
+    char* last = buffer + 18;
     i16toa(value, buffer, last, base);
     return string(buffer, last);
 }
@@ -243,8 +438,8 @@ void i32toa(int32_t value, char* first, char*& last, uint8_t base) noexcept
 
 string i32toa(int32_t value, uint8_t base)
 {
-    char buffer[33];
-    char* last = buffer + 33;
+    char buffer[34];
+    char* last = buffer + 34;
     i32toa(value, buffer, last, base);
     return string(buffer, last);
 }
@@ -273,10 +468,58 @@ void i64toa(int64_t value, char* first, char*& last, uint8_t base) noexcept
 
 string i64toa(int64_t value, uint8_t base)
 {
-    char buffer[65];
-    char* last = buffer + 65;
+    char buffer[66];
+    char* last = buffer + 66;
     i64toa(value, buffer, last, base);
     return string(buffer, last);
 }
 
+
+size_t u32toa_batch(const uint32_t* values, size_t count, char* first, char*& last, char delimiter, uint8_t base) noexcept
+{
+    return itoa_batch_<uint32_t, uint32_t>(values, count, first, last, delimiter, base);
+}
+
+
+string u32toa_batch(const uint32_t* values, size_t count, char delimiter, uint8_t base)
+{
+    return itoa_batch_<uint32_t, uint32_t>(values, count, delimiter, base);
+}
+
+
+size_t i32toa_batch(const int32_t* values, size_t count, char* first, char*& last, char delimiter, uint8_t base) noexcept
+{
+    return itoa_batch_<int32_t, uint32_t>(values, count, first, last, delimiter, base);
+}
+
+
+string i32toa_batch(const int32_t* values, size_t count, char delimiter, uint8_t base)
+{
+    return itoa_batch_<int32_t, uint32_t>(values, count, delimiter, base);
+}
+
+
+size_t u64toa_batch(const uint64_t* values, size_t count, char* first, char*& last, char delimiter, uint8_t base) noexcept
+{
+    return itoa_batch_<uint64_t, uint64_t>(values, count, first, last, delimiter, base);
+}
+
+
+string u64toa_batch(const uint64_t* values, size_t count, char delimiter, uint8_t base)
+{
+    return itoa_batch_<uint64_t, uint64_t>(values, count, delimiter, base);
+}
+
+
+size_t i64toa_batch(const int64_t* values, size_t count, char* first, char*& last, char delimiter, uint8_t base) noexcept
+{
+    return itoa_batch_<int64_t, uint64_t>(values, count, first, last, delimiter, base);
+}
+
+
+string i64toa_batch(const int64_t* values, size_t count, char delimiter, uint8_t base)
+{
+    return itoa_batch_<int64_t, uint64_t>(values, count, delimiter, base);
+}
+
 PYCPP_END_NAMESPACE
@@ -8,11 +8,32 @@
  *  of the number (containing a null character), and will always write
  *  a null terminator.
  *
- *  Unoptimized verions of each routine are ~25% slower than `std::to_string`,
- *  however, each base has an optimize version that is ~5x faster than
- *  `std::to_string`.
+ *  The number of digits is computed before formatting, so digits are
+ *  written directly to their final position. Decimal values are written
+ *  8 digits at a time, and power-of-two bases (binary, octal, hex) use
+ *  shifts rather than division. Writing to a buffer is ~5x faster than
+ *  `snprintf`.
+ *
+ *  The batch routines format an array of integers into a single buffer,
+ *  separated by `delimiter`. They stop before the first value that does
+ *  not fit, and return the number of values written.
+ *
+ *  \synopsis
+ *      void u8toa(uint8_t value, char* first, char*& last, uint8_t base = 10) noexcept;
+ *      string u8toa(uint8_t value, uint8_t base = 10);
+ *      ...
+ *      void i64toa(int64_t value, char* first, char*& last, uint8_t base = 10) noexcept;
+ *      string i64toa(int64_t value, uint8_t base = 10);
+ *
+ *      size_t u32toa_batch(const uint32_t* values, size_t count, char* first, char*& last, char delimiter = ',', uint8_t base = 10) noexcept;
+ *      string u32toa_batch(const uint32_t* values, size_t count, char delimiter = ',', uint8_t base = 10);
+ *      ...
+ *      size_t i64toa_batch(const int64_t* values, size_t count, char* first, char*& last, char delimiter = ',', uint8_t base = 10) noexcept;
+ *      string i64toa_batch(const int64_t* values, size_t count, char delimiter = ',', uint8_t base = 10);
  */
 
+#pragma once
+
 #include <pycpp/stl/string.h>
 #include <stdint.h>
 
@@ -69,4 +90,28 @@ string u64toa(uint64_t value, uint8_t base = 10);
 void i64toa(int64_t value, char* first, char*& last, uint8_t base = 10) noexcept;
 string i64toa(int64_t value, uint8_t base = 10);
 
+/**
+ *  \brief Convert array of unsigned 32-bit values to a delimited string.
+ */
+size_t u32toa_batch(const uint32_t* values, size_t count, char* first, char*& last, char delimiter = ',', uint8_t base = 10) noexcept;
+string u32toa_batch(const uint32_t* values, size_t count, char delimiter = ',', uint8_t base = 10);
+
+/**
+ *  \brief Convert array of signed 32-bit values to a delimited string.
+ */
+size_t i32toa_batch(const int32_t* values, size_t count, char* first, char*& last, char delimiter = ',', uint8_t base = 10) noexcept;
+string i32toa_batch(const int32_t* values, size_t count, char delimiter = ',', uint8_t base = 10);
+
+/**
+ *  \brief Convert array of unsigned 64-bit values to a delimited string.
+ */
+size_t u64toa_batch(const uint64_t* values, size_t count, char* first, char*& last, char delimiter = ',', uint8_t base = 10) noexcept;
+string u64toa_batch(const uint64_t* values, size_t count, char delimiter = ',', uint8_t base = 10);
+
+/**
+ *  \brief Convert array of signed 64-bit values to a delimited string.
+ */
+size_t i64toa_batch(const int64_t* values, size_t count, char* first, char*& last, char delimiter = ',', uint8_t base = 10) noexcept;
+string i64toa_batch(const int64_t* values, size_t count, char delimiter = ',', uint8_t base = 10);
+
 PYCPP_END_NAMESPACE
@@ -0,0 +1,116 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief SWAR routines to validate and parse 8 digits at once.
+ *
+ *  Each routine treats 8 characters, loaded in memory order into the
+ *  bytes of a 64-bit integer (first character in the low byte), as
+ *  8 lanes. Characters must be 7-bit to avoid carries between lanes,
+ *  so any byte with the high bit set is treated as invalid.
+ */
+
+#pragma once
+
+#include <pycpp/preprocessor/byteorder.h>
+#include <stdint.h>
+#include <string.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// CONSTANTS
+// ---------
+
+static constexpr uint64_t SWAR_ONES = 0x0101010101010101ULL;
+static constexpr uint64_t SWAR_HIGH = 0x8080808080808080ULL;
+static constexpr uint64_t SWAR_ZEROS = 0x3030303030303030ULL;
+
+// FUNCTIONS
+// ---------
+
+/**
+ *  \brief Load 8 characters, with the first character in the low byte.
+ */
+inline uint64_t swar_read(const char* p) noexcept
+{
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+#if BYTE_ORDER == BIG_ENDIAN
+    value = bswap64(value);
+#endif
+    return value;
+}
+
+
+/**
+ *  \brief Set the high bit of each lane within [lo, hi].
+ */
+inline uint64_t swar_in_range(uint64_t value, uint8_t lo, uint8_t hi) noexcept
+{
+    // value must be 7-bit: the high bit of `value + 0x80 - lo` is
+    // set if `value >= lo`, and of `value + 0x7F - hi` if `value > hi`.
+    uint64_t ge = value + SWAR_ONES * (0x80 - lo);
+    uint64_t gt = value + SWAR_ONES * (0x7F - hi);
+    return ge & ~gt & SWAR_HIGH;
+}
+
+
+/**
+ *  \brief Set the high bit of each lane that is not a hex digit.
+ */
+inline uint64_t swar_nonhex(uint64_t value) noexcept
+{
+    // check digits before folding uppercase letters to lowercase,
+    // since the fold also maps control characters onto the digits
+    uint64_t ascii = value & ~SWAR_HIGH;
+    uint64_t lower = ascii | (SWAR_ONES * 0x20);
+    uint64_t digits = swar_in_range(ascii, '0', '9') | swar_in_range(lower, 'a', 'f');
+    return (~digits | value) & SWAR_HIGH;
+}
+
+
+/**
+ *  \brief Check if all 8 lanes are decimal digits.
+ */
+inline bool swar_is_eight_digits(uint64_t value) noexcept
+{
+    return (((value & 0xF0F0F0F0F0F0F0F0ULL) | (((value + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL);
+}
+
+
+/**
+ *  \brief Parse 8 decimal digits at once.
+ *
+ *  Pairs of digits are combined with a multiply and shift,
+ *  then pairs of pairs, and finally the two 4-digit halves.
+ */
+inline uint32_t swar_parse_eight_digits(uint64_t value) noexcept
+{
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 0x000F424000000064ULL;    // 100 + (1000000ULL << 32)
+    const uint64_t mul2 = 0x0000271000000001ULL;    // 1 + (10000ULL << 32)
+    value -= SWAR_ZEROS;
+    value = (value * 10) + (value >> 8);
+    value = (((value & mask) * mul1) + (((value >> 16) & mask) * mul2)) >> 32;
+    return static_cast<uint32_t>(value);
+}
+
+
+/**
+ *  \brief Parse 8 hex digits at once.
+ *
+ *  Each lane is converted to a nibble, and adjacent nibbles, bytes
+ *  and 16-bit words are then merged with shifts and masks.
+ */
+inline uint32_t swar_parse_eight_hex(uint64_t value) noexcept
+{
+    // letters have bit 6 set, and need 9 added to the low nibble
+    uint64_t letters = (value >> 6) & SWAR_ONES;
+    value = (value & (SWAR_ONES * 0x0F)) + letters * 9;
+    value = ((value << 4) | (value >> 8)) & 0x00FF00FF00FF00FFULL;
+    value = ((value << 8) | (value >> 16)) & 0x0000FFFF0000FFFFULL;
+    value = (value << 16) | (value >> 32);
+    return static_cast<uint32_t>(value);
+}
+
+PYCPP_END_NAMESPACE
@@ -1,2 +1,12 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief N-dimensional numeric arrays.
+ *
+ *  Alias for the native `ndarray` module.
+ */
 
-// TODO: export dynd here...
+#pragma once
+
+#include <pycpp/ndarray.h>
@@ -3,10 +3,14 @@
 /**
  *  \addtogroup PyCPP
  *  \brief Numerical averages.
+ *
+ *  Averages of contiguous `float` or `double` ranges use the
+ *  vectorized, parallel reductions from `pycpp/math/reduce.h`.
  */
 
 #pragma once
 
+#include <pycpp/math/reduce.h>
 #include <pycpp/misc/xrange.h>
 #include <pycpp/preprocessor/parallel.h>
 #include <pycpp/stl/algorithm.h>
@@ -14,6 +18,35 @@
 
 PYCPP_BEGIN_NAMESPACE
 
+// DETAIL
+// ------
+
+namespace math_detail
+{
+
+template <typename Iter>
+double average(Iter first, Iter last, true_type)
+{
+    size_t n = distance(first, last);
+    return reduce_sum(reduce_detail::to_pointer(first, n), n) / n;
+}
+
+
+template <typename Iter>
+double average(Iter first, Iter last, false_type)
+{
+    using value_type = typename iterator_traits<Iter>::value_type;
+
+    double sum = 0;
+    for_each(PARALLEL_EXECUTION first, last, [&sum](const value_type& value) {
+        sum += value;
+    });
+
+    return sum / distance(first, last);
+}
+
+}   /* math_detail */
+
 // FUNCTIONS
 // ---------
 
@@ -32,12 +65,7 @@ double average(Iter first, Iter last) noexcept
     using value_type = typename iterator_traits<Iter>::value_type;
     static_assert(is_arithmetic<value_type>::value, "");
 
-    double sum = 0;
-    for_each(PARALLEL_EXECUTION first, last, [&sum](const value_type& value) {
-        sum += value;
-    });
-
-    return sum / distance(first, last);
+    return math_detail::average(first, last, reduce_detail::is_contiguous<Iter>());
 }
 
 
@@ -3,15 +3,62 @@
 /**
  *  \addtogroup PyCPP
  *  \brief Dot product implementation.
+ *
+ *  Dot products of contiguous `float` or `double` ranges of the same
+ *  type use the vectorized, parallel reductions from
+ *  `pycpp/math/reduce.h`.
  */
 
 #pragma once
 
+#include <pycpp/math/reduce.h>
+#include <pycpp/stl/algorithm.h>
 #include <pycpp/stl/iterator.h>
 #include <pycpp/stl/type_traits.h>
 
 PYCPP_BEGIN_NAMESPACE
 
+// DETAIL
+// ------
+
+namespace math_detail
+{
+
+template <
+    typename YIter,
+    typename XIter
+>
+double dot(XIter x_first,
+    XIter x_last,
+    YIter y_first,
+    YIter y_last,
+    true_type)
+{
+    size_t n = min<size_t>(distance(x_first, x_last), distance(y_first, y_last));
+    return reduce_dot(reduce_detail::to_pointer(x_first, n), reduce_detail::to_pointer(y_first, n), n);
+}
+
+
+template <
+    typename YIter,
+    typename XIter
+>
+double dot(XIter x_first,
+    XIter x_last,
+    YIter y_first,
+    YIter y_last,
+    false_type)
+{
+    double sum = 0;
+    while (x_first != x_last && y_first != y_last) {
+        sum += *x_first++ * *y_first++;
+    }
+
+    return sum;
+}
+
+}   /* math_detail */
+
 // FUNCTIONS
 // ---------
 
@@ -35,12 +82,7 @@ double dot(XIter x_first,
     static_assert(is_arithmetic<typename iterator_traits<XIter>::value_type>::value, "");
     static_assert(is_arithmetic<typename iterator_traits<YIter>::value_type>::value, "");
 
-    double sum = 0;
-    while (x_first != x_last && y_first != y_last) {
-        sum += *x_first++ * *y_first++;
-    }
-
-    return sum;
+    return math_detail::dot(x_first, x_last, y_first, y_last, reduce_detail::is_contiguous_pair<XIter, YIter>());
 }
 
 
@@ -0,0 +1,514 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/math/reduce.h>
+#include <pycpp/runtime/cpu.h>
+#include <pycpp/stl/algorithm.h>
+#include <pycpp/stl/system_error.h>
+#include <pycpp/stl/thread.h>
+#if defined(HAVE_X86_SIMD)
+#   include <immintrin.h>
+#endif
+
+PYCPP_BEGIN_NAMESPACE
+
+// CONSTANTS
+// ---------
+
+size_t REDUCE_PARALLEL_THRESHOLD = 1 << 20;
+size_t REDUCE_MAX_THREADS = 0;
+
+/**
+ *  \brief Number of values summed directly at the leaves of a pairwise sum.
+ */
+static constexpr size_t PAIRWISE_BLOCK = 1024;
+
+/**
+ *  \brief Number of values per block when merging moments.
+ */
+static constexpr size_t MOMENTS_BLOCK = 4096;
+
+// OBJECTS
+// -------
+
+template <typename T>
+struct reduce_kernels
+{
+    double (*sum)(const T* x, size_t n);
+    double (*kahan)(const T* x, size_t n);
+    double (*dot)(const T* x, const T* y, size_t n);
+    double (*squared_deviation)(const T* x, size_t n, double mean);
+    double (*trapz)(const T* y, const T* x, size_t n);
+};
+
+// HELPERS
+// -------
+
+// PORTABLE
+
+
+template <typename T>
+static double sum_portable(const T* x, size_t n)
+{
+    // independent accumulators hide the latency of the additions
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += x[i];
+        s1 += x[i + 1];
+        s2 += x[i + 2];
+        s3 += x[i + 3];
+    }
+    for (; i < n; ++i) {
+        s0 += x[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+
+template <typename T>
+static double kahan_portable(const T* x, size_t n)
+{
+    double sum = 0;
+    double c = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double y = x[i] - c;
+        double t = sum + y;
+        c = (t - sum) - y;
+        sum = t;
+    }
+    return sum;
+}
+
+
+template <typename T>
+static double dot_portable(const T* x, const T* y, size_t n)
+{
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += static_cast<double>(x[i]) * y[i];
+        s1 += static_cast<double>(x[i + 1]) * y[i + 1];
+        s2 += static_cast<double>(x[i + 2]) * y[i + 2];
+        s3 += static_cast<double>(x[i + 3]) * y[i + 3];
+    }
+    for (; i < n; ++i) {
+        s0 += static_cast<double>(x[i]) * y[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+
+template <typename T>
+static double squared_deviation_portable(const T* x, size_t n, double mean)
+{
+    double s0 = 0, s1 = 0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        double d0 = x[i] - mean;
+        double d1 = x[i + 1] - mean;
+        s0 += d0 * d0;
+        s1 += d1 * d1;
+    }
+    for (; i < n; ++i) {
+        double d = x[i] - mean;
+        s0 += d * d;
+    }
+    return s0 + s1;
+}
+
+
+/**
+ *  \brief Twice the trapezoidal integral over `n` points.
+ */
+template <typename T>
+static double trapz_portable(const T* y, const T* x, size_t n)
+{
+    double s0 = 0, s1 = 0;
+    size_t i = 0;
+    for (; i + 2 < n; i += 2) {
+        s0 += (static_cast<double>(x[i + 1]) - x[i]) * (static_cast<double>(y[i + 1]) + y[i]);
+        s1 += (static_cast<double>(x[i + 2]) - x[i + 1]) * (static_cast<double>(y[i + 2]) + y[i + 1]);
+    }
+    for (; i + 1 < n; ++i) {
+        s0 += (static_cast<double>(x[i + 1]) - x[i]) * (static_cast<double>(y[i + 1]) + y[i]);
+    }
+    return s0 + s1;
+}
+
+
+#if defined(HAVE_X86_SIMD)              // HAVE_X86_SIMD
+
+// AVX
+
+SIMD_TARGET("avx")
+static __m256d load_avx(const double* p)
+{
+    return _mm256_loadu_pd(p);
+}
+
+
+SIMD_TARGET("avx")
+static __m256d load_avx(const float* p)
+{
+    return _mm256_cvtps_pd(_mm_loadu_ps(p));
+}
+
+
+SIMD_TARGET("avx")
+static double hsum_avx(__m256d v)
+{
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+
+template <typename T>
+SIMD_TARGET("avx")
+static double sum_avx(const T* x, size_t n)
+{
+    __m256d s0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd();
+    __m256d s2 = _mm256_setzero_pd();
+    __m256d s3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        s0 = _mm256_add_pd(s0, load_avx(x + i));
+        s1 = _mm256_add_pd(s1, load_avx(x + i + 4));
+        s2 = _mm256_add_pd(s2, load_avx(x + i + 8));
+        s3 = _mm256_add_pd(s3, load_avx(x + i + 12));
+    }
+    for (; i + 4 <= n; i += 4) {
+        s0 = _mm256_add_pd(s0, load_avx(x + i));
+    }
+    __m256d s = _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3));
+    return hsum_avx(s) + sum_portable(x + i, n - i);
+}
+
+
+template <typename T>
+SIMD_TARGET("avx")
+static double kahan_avx(const T* x, size_t n)
+{
+    // compensated sum per lane, then of the lanes
+    __m256d sum = _mm256_setzero_pd();
+    __m256d c = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d y = _mm256_sub_pd(load_avx(x + i), c);
+        __m256d t = _mm256_add_pd(sum, y);
+        c = _mm256_sub_pd(_mm256_sub_pd(t, sum), y);
+        sum = t;
+    }
+
+    double lanes[8];
+    _mm256_storeu_pd(lanes, sum);
+    _mm256_storeu_pd(lanes + 4, c);
+    double total = 0;
+    double comp = 0;
+    for (size_t j = 0; j < 4; ++j) {
+        double y = lanes[j] - lanes[4 + j] - comp;
+        double t = total + y;
+        comp = (t - total) - y;
+        total = t;
+    }
+    for (; i < n; ++i) {
+        double y = x[i] - comp;
+        double t = total + y;
+        comp = (t - total) - y;
+        total = t;
+    }
+    return total;
+}
+
+
+template <typename T>
+SIMD_TARGET("avx")
+static double dot_avx(const T* x, const T* y, size_t n)
+{
+    __m256d s0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        s0 = _mm256_add_pd(s0, _mm256_mul_pd(load_avx(x + i), load_avx(y + i)));
+        s1 = _mm256_add_pd(s1, _mm256_mul_pd(load_avx(x + i + 4), load_avx(y + i + 4)));
+    }
+    return hsum_avx(_mm256_add_pd(s0, s1)) + dot_portable(x + i, y + i, n - i);
+}
+
+
+template <typename T>
+SIMD_TARGET("avx")
+static double squared_deviation_avx(const T* x, size_t n, double mean)
+{
+    __m256d m = _mm256_set1_pd(mean);
+    __m256d s0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d d0 = _mm256_sub_pd(load_avx(x + i), m);
+        __m256d d1 = _mm256_sub_pd(load_avx(x + i + 4), m);
+        s0 = _mm256_add_pd(s0, _mm256_mul_pd(d0, d0));
+        s1 = _mm256_add_pd(s1, _mm256_mul_pd(d1, d1));
+    }
+    return hsum_avx(_mm256_add_pd(s0, s1)) + squared_deviation_portable(x + i, n - i, mean);
+}
+
+
+template <typename T>
+SIMD_TARGET("avx")
+static double trapz_avx(const T* y, const T* x, size_t n)
+{
+    __m256d s = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 5 <= n; i += 4) {
+        __m256d dx = _mm256_sub_pd(load_avx(x + i + 1), load_avx(x + i));
+        __m256d sy = _mm256_add_pd(load_avx(y + i + 1), load_avx(y + i));
+        s = _mm256_add_pd(s, _mm256_mul_pd(dx, sy));
+    }
+    return hsum_avx(s) + trapz_portable(y + i, x + i, n - i);
+}
+
+#endif                                  // HAVE_X86_SIMD
+
+
+template <typename T>
+static reduce_kernels<T> select_reduce_kernels()
+{
+#if defined(HAVE_X86_SIMD)
+    if (cpu_supports(cpu_avx)) {
+        return {sum_avx<T>, kahan_avx<T>, dot_avx<T>, squared_deviation_avx<T>, trapz_avx<T>};
+    }
+#endif
+    return {sum_portable<T>, kahan_portable<T>, dot_portable<T>, squared_deviation_portable<T>, trapz_portable<T>};
+}
+
+
+template <typename T>
+static const reduce_kernels<T>& get_reduce_kernels()
+{
+    static const reduce_kernels<T> kernels = select_reduce_kernels<T>();
+    return kernels;
+}
+
+// PARALLEL
+
+
+/**
+ *  \brief Number of chunks to split `n` values into.
+ */
+static size_t reduce_threads(size_t n)
+{
+    size_t chunk = max<size_t>(REDUCE_PARALLEL_THRESHOLD, 1);
+    size_t threads = REDUCE_MAX_THREADS;
+    if (threads == 0) {
+        threads = max<size_t>(thread::hardware_concurrency(), 1);
+    }
+    return max<size_t>(min(threads, n / chunk), 1);
+}
+
+
+/**
+ *  \brief Call `f(first, last)` over chunks of `[0, n)`, on separate threads.
+ *
+ *  Returns the result of each chunk, in order. If a thread cannot be
+ *  started, its chunk is reduced on the calling thread.
+ */
+template <typename Result, typename Function>
+static vector<Result> reduce_chunks(size_t n, Function f)
+{
+    size_t count = reduce_threads(n);
+    vector<Result> results(count);
+    if (count == 1) {
+        results[0] = f(0, n);
+        return results;
+    }
+
+    // keep chunk boundaries a multiple of the vector width
+    size_t chunk = (n / count) & ~size_t(15);
+    vector<thread> workers;
+    workers.reserve(count - 1);
+    for (size_t i = 1; i < count; ++i) {
+        size_t first = i * chunk;
+        size_t last = i + 1 == count ? n : first + chunk;
+        try {
+            workers.emplace_back([&results, &f, i, first, last]() {
+                results[i] = f(first, last);
+            });
+        } catch (system_error&) {
+            results[i] = f(first, last);
+        }
+    }
+    results[0] = f(0, chunk);
+    for (thread& worker: workers) {
+        worker.join();
+    }
+
+    return results;
+}
+
+// SUMS
+
+
+template <typename T>
+static double sum_pairwise(const reduce_kernels<T>& kernels, const T* x, size_t n)
+{
+    if (n <= PAIRWISE_BLOCK) {
+        return kernels.sum(x, n);
+    }
+    size_t half = (n / 2) & ~size_t(15);
+    return sum_pairwise(kernels, x, half) + sum_pairwise(kernels, x + half, n - half);
+}
+
+
+template <typename T>
+static double sum_impl(const T* x, size_t n, summation_method method)
+{
+    const reduce_kernels<T>& kernels = get_reduce_kernels<T>();
+    vector<double> sums = reduce_chunks<double>(n, [&](size_t first, size_t last) -> double {
+        switch (method) {
+            case summation_pairwise:
+                return sum_pairwise(kernels, x + first, last - first);
+            case summation_kahan:
+                return kernels.kahan(x + first, last - first);
+            default:
+                return kernels.sum(x + first, last - first);
+        }
+    });
+
+    return method == summation_kahan ? kahan_portable(sums.data(), sums.size()) : sum_portable(sums.data(), sums.size());
+}
+
+
+template <typename T>
+static double dot_impl(const T* x, const T* y, size_t n)
+{
+    const reduce_kernels<T>& kernels = get_reduce_kernels<T>();
+    vector<double> sums = reduce_chunks<double>(n, [&](size_t first, size_t last) -> double {
+        return kernels.dot(x + first, y + first, last - first);
+    });
+
+    return sum_portable(sums.data(), sums.size());
+}
+
+// MOMENTS
+
+
+template <typename T>
+static welford_accumulator moments_impl(const T* x, size_t n)
+{
+    // merge the moments of blocks that fit in the cache, so each
+    // value is read from memory once
+    const reduce_kernels<T>& kernels = get_reduce_kernels<T>();
+    vector<welford_accumulator> chunks = reduce_chunks<welford_accumulator>(n, [&](size_t first, size_t last) -> welford_accumulator {
+        welford_accumulator moments;
+        for (size_t i = first; i < last; i += MOMENTS_BLOCK) {
+            size_t count = min(MOMENTS_BLOCK, last - i);
+            double mean = kernels.sum(x + i, count) / count;
+            double m2 = kernels.squared_deviation(x + i, count, mean);
+            moments.merge(welford_accumulator(count, mean, m2));
+        }
+        return moments;
+    });
+
+    welford_accumulator moments;
+    for (const welford_accumulator& chunk: chunks) {
+        moments.merge(chunk);
+    }
+    return moments;
+}
+
+// TRAPZ
+
+
+template <typename T>
+static double trapz_impl(const T* y, size_t n, double dx)
+{
+    if (n < 2) {
+        return 0;
+    }
+    double sum = sum_impl(y, n, summation_default);
+    return dx * (sum - 0.5 * (static_cast<double>(y[0]) + y[n - 1]));
+}
+
+
+template <typename T>
+static double trapz_impl(const T* y, const T* x, size_t n)
+{
+    if (n < 2) {
+        return 0;
+    }
+
+    // chunks of intervals, each sharing its last point with the next
+    const reduce_kernels<T>& kernels = get_reduce_kernels<T>();
+    vector<double> sums = reduce_chunks<double>(n - 1, [&](size_t first, size_t last) -> double {
+        return kernels.trapz(y + first, x + first, last - first + 1);
+    });
+
+    return 0.5 * sum_portable(sums.data(), sums.size());
+}
+
+// FUNCTIONS
+// ---------
+
+
+double reduce_sum(const float* x, size_t n, summation_method method)
+{
+    return sum_impl(x, n, method);
+}
+
+
+double reduce_sum(const double* x, size_t n, summation_method method)
+{
+    return sum_impl(x, n, method);
+}
+
+
+double reduce_dot(const float* x, const float* y, size_t n)
+{
+    return dot_impl(x, y, n);
+}
+
+
+double reduce_dot(const double* x, const double* y, size_t n)
+{
+    return dot_impl(x, y, n);
+}
+
+
+welford_accumulator reduce_moments(const float* x, size_t n)
+{
+    return moments_impl(x, n);
+}
+
+
+welford_accumulator reduce_moments(const double* x, size_t n)
+{
+    return moments_impl(x, n);
+}
+
+
+double reduce_trapz(const float* y, size_t n, double dx)
+{
+    return trapz_impl(y, n, dx);
+}
+
+
+double reduce_trapz(const double* y, size_t n, double dx)
+{
+    return trapz_impl(y, n, dx);
+}
+
+
+double reduce_trapz(const float* y, const float* x, size_t n)
+{
+    return trapz_impl(y, x, n);
+}
+
+
+double reduce_trapz(const double* y, const double* x, size_t n)
+{
+    return trapz_impl(y, x, n);
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,255 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Vectorized and parallel reductions over contiguous values.
+ *
+ *  Reductions over contiguous `float` and `double` values, which
+ *  `dot`, `average`, `variance` and `trapz` use when given pointers
+ *  or vector iterators. Each thread uses several independent
+ *  accumulators, with AVX if the processor supports it, and ranges
+ *  of at least twice `REDUCE_PARALLEL_THRESHOLD` elements are split
+ *  into chunks of at least that many elements, reduced on up to
+ *  `REDUCE_MAX_THREADS` threads (0 for the hardware concurrency).
+ *  Values are always accumulated as `double`.
+ *
+ *  Partial results are combined in order, so results are repeatable
+ *  for a given number of threads, but may differ in the last bits
+ *  from a sequential loop. `summation_pairwise` and `summation_kahan`
+ *  bound the rounding error for long sums, and moments are computed
+ *  in a single pass by merging the mean and squared deviations of
+ *  cache-sized blocks, as in Welford's algorithm.
+ *
+ *  \synopsis
+ *      extern size_t REDUCE_PARALLEL_THRESHOLD;
+ *      extern size_t REDUCE_MAX_THREADS;
+ *
+ *      enum summation_method
+ *      {
+ *          summation_default = 0,
+ *          summation_pairwise,
+ *          summation_kahan,
+ *      };
+ *
+ *      class welford_accumulator
+ *      {
+ *      public:
+ *          welford_accumulator() noexcept;
+ *          welford_accumulator(size_t count, double mean, double m2) noexcept;
+ *
+ *          void push(double value) noexcept;
+ *          void merge(const welford_accumulator& other) noexcept;
+ *
+ *          size_t count() const noexcept;
+ *          double mean() const noexcept;
+ *          double variance(size_t ddof = 0) const noexcept;
+ *          double stdev(size_t ddof = 0) const noexcept;
+ *      };
+ *
+ *      double reduce_sum(const float* x, size_t n, summation_method method = summation_default);
+ *      double reduce_sum(const double* x, size_t n, summation_method method = summation_default);
+ *      double reduce_dot(const float* x, const float* y, size_t n);
+ *      double reduce_dot(const double* x, const double* y, size_t n);
+ *      welford_accumulator reduce_moments(const float* x, size_t n);
+ *      welford_accumulator reduce_moments(const double* x, size_t n);
+ *      double reduce_trapz(const float* y, size_t n, double dx);
+ *      double reduce_trapz(const double* y, size_t n, double dx);
+ *      double reduce_trapz(const float* y, const float* x, size_t n);
+ *      double reduce_trapz(const double* y, const double* x, size_t n);
+ */
+
+#pragma once
+
+#include <pycpp/stl/iterator.h>
+#include <pycpp/stl/type_traits.h>
+#include <pycpp/stl/vector.h>
+#include <math.h>
+#include <stddef.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// CONSTANTS
+// ---------
+
+extern size_t REDUCE_PARALLEL_THRESHOLD;
+extern size_t REDUCE_MAX_THREADS;
+
+// ENUMS
+// -----
+
+/**
+ *  \brief Algorithm to sum floating-point values.
+ *
+ *  `summation_default` uses independent accumulators, with an error
+ *  that grows linearly with the number of values, `summation_pairwise`
+ *  sums blocks recursively, with an error that grows logarithmically,
+ *  and `summation_kahan` compensates each addition, with an error
+ *  independent of the number of values, at a higher cost.
+ */
+enum summation_method
+{
+    summation_default = 0,
+    summation_pairwise,
+    summation_kahan,
+};
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Running count, mean and sum of squared deviations.
+ *
+ *  Accumulates values in a single, numerically stable pass, and
+ *  merges partial results from separate ranges.
+ */
+class welford_accumulator
+{
+public:
+    welford_accumulator() noexcept = default;
+    welford_accumulator(size_t count, double mean, double m2) noexcept;
+
+    // MODIFIERS
+    void push(double value) noexcept;
+    void merge(const welford_accumulator& other) noexcept;
+
+    // PROPERTIES
+    size_t count() const noexcept;
+    double mean() const noexcept;
+    double variance(size_t ddof = 0) const noexcept;
+    double stdev(size_t ddof = 0) const noexcept;
+
+private:
+    size_t count_ = 0;
+    double mean_ = 0;
+    double m2_ = 0;
+};
+
+// FUNCTIONS
+// ---------
+
+double reduce_sum(const float* x, size_t n, summation_method method = summation_default);
+double reduce_sum(const double* x, size_t n, summation_method method = summation_default);
+double reduce_dot(const float* x, const float* y, size_t n);
+double reduce_dot(const double* x, const double* y, size_t n);
+welford_accumulator reduce_moments(const float* x, size_t n);
+welford_accumulator reduce_moments(const double* x, size_t n);
+double reduce_trapz(const float* y, size_t n, double dx);
+double reduce_trapz(const double* y, size_t n, double dx);
+double reduce_trapz(const float* y, const float* x, size_t n);
+double reduce_trapz(const double* y, const double* x, size_t n);
+
+// DETAIL
+// ------
+
+namespace reduce_detail
+{
+
+/**
+ *  \brief Check if an iterator walks contiguous `float` or `double` values.
+ */
+template <typename Iter, typename T = remove_cv_t<typename iterator_traits<Iter>::value_type>>
+struct is_contiguous: integral_constant<
+        bool,
+        (is_same<T, float>::value || is_same<T, double>::value) && (
+            is_pointer<Iter>::value ||
+            is_same<Iter, typename vector<T>::iterator>::value ||
+            is_same<Iter, typename vector<T>::const_iterator>::value ||
+            is_same<Iter, typename std::vector<T>::iterator>::value ||
+            is_same<Iter, typename std::vector<T>::const_iterator>::value
+        )
+    >
+{};
+
+
+/**
+ *  \brief Check if two iterators walk contiguous values of the same type.
+ */
+template <typename XIter, typename YIter>
+struct is_contiguous_pair: integral_constant<
+        bool,
+        is_contiguous<XIter>::value && is_contiguous<YIter>::value &&
+            is_same<
+                remove_cv_t<typename iterator_traits<XIter>::value_type>,
+                remove_cv_t<typename iterator_traits<YIter>::value_type>
+            >::value
+    >
+{};
+
+
+/**
+ *  \brief Pointer to the values of a contiguous range of `n` elements.
+ */
+template <typename Iter>
+auto to_pointer(Iter first, size_t n) noexcept -> const remove_cv_t<typename iterator_traits<Iter>::value_type>*
+{
+    return n == 0 ? nullptr : &*first;
+}
+
+}   /* reduce_detail */
+
+// IMPLEMENTATION
+// --------------
+
+
+inline welford_accumulator::welford_accumulator(size_t count, double mean, double m2) noexcept:
+    count_(count),
+    mean_(mean),
+    m2_(m2)
+{}
+
+
+inline void welford_accumulator::push(double value) noexcept
+{
+    ++count_;
+    double delta = value - mean_;
+    mean_ += delta / count_;
+    m2_ += delta * (value - mean_);
+}
+
+
+/**
+ *  \brief Combine with the moments of another range (Chan et al.).
+ */
+inline void welford_accumulator::merge(const welford_accumulator& other) noexcept
+{
+    if (other.count_ == 0) {
+        return;
+    } else if (count_ == 0) {
+        *this = other;
+        return;
+    }
+
+    double n1 = static_cast<double>(count_);
+    double n2 = static_cast<double>(other.count_);
+    double n = n1 + n2;
+    double delta = other.mean_ - mean_;
+    mean_ += delta * n2 / n;
+    m2_ += other.m2_ + delta * delta * n1 * n2 / n;
+    count_ += other.count_;
+}
+
+
+inline size_t welford_accumulator::count() const noexcept
+{
+    return count_;
+}
+
+
+inline double welford_accumulator::mean() const noexcept
+{
+    return count_ == 0 ? NAN : mean_;
+}
+
+
+inline double welford_accumulator::variance(size_t ddof) const noexcept
+{
+    return m2_ / (static_cast<double>(count_) - static_cast<double>(ddof));
+}
+
+
+inline double welford_accumulator::stdev(size_t ddof) const noexcept
+{
+    return sqrt(variance(ddof));
+}
+
+PYCPP_END_NAMESPACE
@@ -3,18 +3,68 @@
 /**
  *  \addtogroup PyCPP
  *  \brief Numerical variance and standard deviations.
+ *
+ *  The variance of a contiguous `float` or `double` range, without a
+ *  pre-calculated mean, is calculated in a single, numerically stable
+ *  pass using the vectorized, parallel reductions from
+ *  `pycpp/math/reduce.h`. `moments` calculates the count, mean and
+ *  variance of any range in a single pass.
  */
 
 #pragma once
 
 #include <pycpp/math/average.h>
+#include <pycpp/math/reduce.h>
 #include <math.h>
 
 PYCPP_BEGIN_NAMESPACE
 
+// DETAIL
+// ------
+
+namespace math_detail
+{
+
+template <typename Iter>
+welford_accumulator moments(Iter first, Iter last, true_type)
+{
+    size_t n = distance(first, last);
+    return reduce_moments(reduce_detail::to_pointer(first, n), n);
+}
+
+
+template <typename Iter>
+welford_accumulator moments(Iter first, Iter last, false_type)
+{
+    welford_accumulator accumulator;
+    for (; first != last; ++first) {
+        accumulator.push(*first);
+    }
+    return accumulator;
+}
+
+}   /* math_detail */
+
 // FUNCTIONS
 // ---------
 
+/**
+ *  \brief Calculate count, mean and variance of range in one pass.
+ *
+ *  \param first            Iterator at beginning of range
+ *  \param last             Iterator past end of range
+ */
+template <typename Iter>
+welford_accumulator moments(Iter first,
+    Iter last) noexcept
+{
+    using value_type = typename iterator_traits<Iter>::value_type;
+    static_assert(is_arithmetic<value_type>::value, "");
+
+    return math_detail::moments(first, last, reduce_detail::is_contiguous<Iter>());
+}
+
+
 /**
  *  \brief Calculate variance of range with pre-calculated mean.
  *
@@ -74,6 +124,9 @@ template <typename Iter>
 double variance(Iter first,
     Iter last) noexcept
 {
+    if (reduce_detail::is_contiguous<Iter>::value) {
+        return moments(first, last).variance();
+    }
     return variance(average(first, last), first, last);
 }
 
@@ -91,7 +144,7 @@ template <typename Iter>
 double stdev(Iter first,
     Iter last) noexcept
 {
-    return stdev(average(first, last), first, last);
+    return sqrt(variance(first, last));
 }
 
 
@@ -3,16 +3,91 @@
 /**
  *  \addtogroup PyCPP
  *  \brief Trapezoidal integration implementation.
+ *
+ *  Integrals of contiguous `float` or `double` ranges use the
+ *  vectorized, parallel reductions from `pycpp/math/reduce.h`.
  */
 
 #pragma once
 
+#include <pycpp/math/reduce.h>
 #include <pycpp/misc/xrange.h>
 #include <pycpp/preprocessor/parallel.h>
 #include <pycpp/stl/algorithm.h>
 
 PYCPP_BEGIN_NAMESPACE
 
+// DETAIL
+// ------
+
+namespace math_detail
+{
+
+template <typename Iter>
+double trapz(Iter first, Iter last, double dx, true_type)
+{
+    size_t n = distance(first, last);
+    return reduce_trapz(reduce_detail::to_pointer(first, n), n, dx);
+}
+
+
+template <typename Iter>
+double trapz(Iter first, Iter last, double dx, false_type)
+{
+    double integral = 0;
+    size_t dist = distance(first, last);
+    auto r = xrange<size_t>(0, dist-1, 1);
+    for_each(PARALLEL_EXECUTION r.begin(), r.end(), [&](size_t i) {
+        double yi = first[i];
+        double yj = first[i+1];
+        integral += 0.5 * dx * (yj + yi);
+    });
+
+    return integral;
+}
+
+
+template <
+    typename YIter,
+    typename XIter
+>
+double trapz(YIter y_first,
+    YIter y_last,
+    XIter x_first,
+    XIter x_last,
+    true_type)
+{
+    size_t n = min<size_t>(distance(y_first, y_last), distance(x_first, x_last));
+    return reduce_trapz(reduce_detail::to_pointer(y_first, n), reduce_detail::to_pointer(x_first, n), n);
+}
+
+
+template <
+    typename YIter,
+    typename XIter
+>
+double trapz(YIter y_first,
+    YIter y_last,
+    XIter x_first,
+    XIter x_last,
+    false_type)
+{
+    double integral = 0;
+    size_t dist = min(distance(y_first, y_last), distance(x_first, x_last));
+    auto r = xrange<size_t>(0, dist-1, 1);
+    for_each(PARALLEL_EXECUTION r.begin(), r.end(), [&](size_t i) {
+        double xi = x_first[i];
+        double xj = x_first[i+1];
+        double yi = y_first[i];
+        double yj = y_first[i+1];
+        integral += 0.5 * (xj - xi) * (yj + yi);
+    });
+
+    return integral;
+}
+
+}   /* math_detail */
+
 // FUNCTIONS
 // ---------
 
@@ -29,16 +104,7 @@ double trapz(Iter first, Iter last, double dx = 1) noexcept
     using value_type = typename iterator_traits<Iter>::value_type;
     static_assert(is_arithmetic<value_type>::value, "");
 
-    double integral = 0;
-    size_t dist = distance(first, last);
-    auto r = xrange<size_t>(0, dist-1, 1);
-    for_each(PARALLEL_EXECUTION r.begin(), r.end(), [&](size_t i) {
-        double yi = first[i];
-        double yj = first[i+1];
-        integral += 0.5 * dx * (yj + yi);
-    });
-
-    return integral;
+    return math_detail::trapz(first, last, dx, reduce_detail::is_contiguous<Iter>());
 }
 
 
@@ -62,18 +128,7 @@ double trapz(YIter y_first,
     static_assert(is_arithmetic<typename iterator_traits<XIter>::value_type>::value, "");
     static_assert(is_arithmetic<typename iterator_traits<YIter>::value_type>::value, "");
 
-    double integral = 0;
-    size_t dist = min(distance(y_first, y_last), distance(x_first, x_last));
-    auto r = xrange<size_t>(0, dist-1, 1);
-    for_each(PARALLEL_EXECUTION r.begin(), r.end(), [&](size_t i) {
-        double xi = x_first[i];
-        double xj = x_first[i+1];
-        double yi = y_first[i];
-        double yj = y_first[i+1];
-        integral += 0.5 * (xj - xi) * (yj + yi);
-    });
-
-    return integral;
+    return math_detail::trapz(y_first, y_last, x_first, x_last, reduce_detail::is_contiguous_pair<YIter, XIter>());
 }
 
 
@@ -0,0 +1,11 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Memory-mapped, larger-than-memory containers.
+ */
+
+#pragma once
+
+#include <pycpp/memmap/array.h>
+#include <pycpp/memmap/file.h>
@@ -5,24 +5,808 @@
  *  \brief Memory-mapped file for larger-than-memory arrays.
  *
  *  Internally, the memory-mapped file is implemented like a deque,
- *  with an LRU-cache.
+ *  with an LRU-cache: elements are stored contiguously in the file,
+ *  which is mapped in fixed-size windows (`memmap_file`), and only
+ *  the most recently used windows stay mapped. Every window holds a
+ *  whole number of elements, so no element straddles two windows.
+ *
+ *  References, pointers and the values of `scan` stay valid until
+ *  `cache_size()` other windows have been accessed, so expressions
+ *  using two references at once (like `swap(a[i], a[j])`) are safe.
+ *  Iterators store an index, and are never invalidated by access.
+ *
+ *  `append` and `scan` work a window at a time, and ask the kernel
+ *  to read ahead the next window while the current one is used.
+ *
+ *  \synopsis
+ *      template <typename T>
+ *      class memmap_array
+ *      {
+ *      public:
+ *          using value_type = T;
+ *          using size_type = size_t;
+ *          using difference_type = ptrdiff_t;
+ *          using reference = T&;
+ *          using const_reference = const T&;
+ *          using pointer = T*;
+ *          using const_pointer = const T*;
+ *          using iterator = implementation-defined;
+ *          using const_iterator = implementation-defined;
+ *          using reverse_iterator = pycpp::reverse_iterator<iterator>;
+ *          using const_reverse_iterator = pycpp::reverse_iterator<const_iterator>;
+ *
+ *          memmap_array();
+ *          memmap_array(const path_view_t& path, ios_base::openmode mode = ios_base::in | ios_base::out, size_t window = MEMMAP_WINDOW_SIZE, size_t cache_size = MEMMAP_CACHE_SIZE);
+ *          memmap_array(memmap_array&&);
+ *          memmap_array& operator=(memmap_array&&);
+ *
+ *          void open(const path_view_t& path, ios_base::openmode mode = ios_base::in | ios_base::out, size_t window = MEMMAP_WINDOW_SIZE, size_t cache_size = MEMMAP_CACHE_SIZE);
+ *          void close();
+ *          bool is_open() const;
+ *          void flush(bool async = false);
+ *          void swap(memmap_array&);
+ *
+ *          iterator begin();
+ *          const_iterator begin() const;
+ *          const_iterator cbegin() const;
+ *          iterator end();
+ *          const_iterator end() const;
+ *          const_iterator cend() const;
+ *          reverse_iterator rbegin();
+ *          const_reverse_iterator rbegin() const;
+ *          const_reverse_iterator crbegin() const;
+ *          reverse_iterator rend();
+ *          const_reverse_iterator rend() const;
+ *          const_reverse_iterator crend() const;
+ *
+ *          size_type size() const;
+ *          size_type capacity() const;
+ *          size_type window() const;
+ *          size_type cache_size() const;
+ *          bool empty() const;
+ *          void reserve(size_type n);
+ *          void resize(size_type n);
+ *
+ *          reference operator[](size_type n);
+ *          const_reference operator[](size_type n) const;
+ *          reference at(size_type n);
+ *          const_reference at(size_type n) const;
+ *          reference front();
+ *          const_reference front() const;
+ *          reference back();
+ *          const_reference back() const;
+ *
+ *          void push_back(const value_type& value);
+ *          void pop_back();
+ *          void append(const_pointer first, size_type n);
+ *          template <typename InputIter> void append(InputIter first, InputIter last);
+ *          void clear();
+ *
+ *          template <typename Function> void scan(Function f);
+ *          template <typename Function> void scan(Function f) const;
+ *          template <typename Function> void scan(size_type first, size_type last, Function f);
+ *          template <typename Function> void scan(size_type first, size_type last, Function f) const;
+ *      };
  */
 
 #pragma once
 
-#include <pycpp/config.h>
+#include <pycpp/filesystem/exception.h>
+#include <pycpp/memmap/file.h>
+#include <pycpp/stl/iterator.h>
+#include <pycpp/stl/stdexcept.h>
+#include <pycpp/stl/type_traits.h>
+#include <assert.h>
+#include <string.h>
+
+#if defined(HAVE_MMAP) || defined(OS_WINDOWS)           // MMAP
 
 PYCPP_BEGIN_NAMESPACE
 
 // OBJECTS
 // -------
 
+/**
+ *  \brief Random-access iterator over a memory-mapped array.
+ */
+template <typename Array, typename T>
+struct memmap_array_iterator: iterator<random_access_iterator_tag, T>
+{
+    // MEMBER TYPES
+    // ------------
+    using self_t = memmap_array_iterator<Array, T>;
+    using base_t = iterator<random_access_iterator_tag, T>;
+    using typename base_t::value_type;
+    using typename base_t::difference_type;
+    using reference = T&;
+    using pointer = T*;
+
+    // MEMBER FUNCTIONS
+    // ----------------
+    memmap_array_iterator(Array* array = nullptr, size_t index = 0) noexcept;
+    memmap_array_iterator(const self_t&) noexcept = default;
+    self_t& operator=(const self_t&) noexcept = default;
+    template <typename A, typename U, typename = enable_if_t<is_convertible<U*, T*>::value>>
+    memmap_array_iterator(const memmap_array_iterator<A, U>&) noexcept;
+
+    // RELATIONAL OPERATORS
+    bool operator==(const self_t&) const noexcept;
+    bool operator!=(const self_t&) const noexcept;
+    bool operator<(const self_t&) const noexcept;
+    bool operator<=(const self_t&) const noexcept;
+    bool operator>(const self_t&) const noexcept;
+    bool operator>=(const self_t&) const noexcept;
+
+    // INCREMENTORS
+    self_t& operator++() noexcept;
+    self_t operator++(int) noexcept;
+    self_t& operator--() noexcept;
+    self_t operator--(int) noexcept;
+    self_t& operator+=(difference_type) noexcept;
+    self_t& operator-=(difference_type) noexcept;
+    self_t operator+(difference_type) const noexcept;
+    self_t operator-(difference_type) const noexcept;
+    difference_type operator-(const self_t&) const noexcept;
+    reference operator[](difference_type) const;
+
+    // DEREFERENCE
+    reference operator*() const;
+    pointer operator->() const;
+
+    // OTHER
+    void swap(self_t&) noexcept;
+
+private:
+    template <typename A, typename U>
+    friend struct memmap_array_iterator;
+
+    Array* array_;
+    size_t index_;
+};
+
+
+/**
+ *  \brief Array of trivially-copyable values, stored in a file.
+ */
+template <typename T>
+class memmap_array
+{
+public:
+    static_assert(is_trivially_copyable<T>::value, "memmap_array values must be trivially copyable.");
+
+    // MEMBER TYPES
+    // ------------
+    using self_t = memmap_array<T>;
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using iterator = memmap_array_iterator<self_t, value_type>;
+    using const_iterator = memmap_array_iterator<const self_t, const value_type>;
+    using reverse_iterator = PYCPP_NAMESPACE::reverse_iterator<iterator>;
+    using const_reverse_iterator = PYCPP_NAMESPACE::reverse_iterator<const_iterator>;
+
+    // MEMBER FUNCTIONS
+    // ----------------
+    memmap_array() = default;
+    memmap_array(const path_view_t& path, ios_base::openmode mode = ios_base::in | ios_base::out, size_t window = MEMMAP_WINDOW_SIZE, size_t cache_size = MEMMAP_CACHE_SIZE);
+    memmap_array(const self_t&) = delete;
+    self_t& operator=(const self_t&) = delete;
+    memmap_array(self_t&&) = default;
+    self_t& operator=(self_t&&) = default;
+
+    // MODIFIERS/PROPERTIES
+    void open(const path_view_t& path, ios_base::openmode mode = ios_base::in | ios_base::out, size_t window = MEMMAP_WINDOW_SIZE, size_t cache_size = MEMMAP_CACHE_SIZE);
+    void close();
+    bool is_open() const;
+    void flush(bool async = false);
+    void swap(self_t&);
+
+    // ITERATORS
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const;
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const;
+    reverse_iterator rbegin();
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator crbegin() const;
+    reverse_iterator rend();
+    const_reverse_iterator rend() const;
+    const_reverse_iterator crend() const;
+
+    // CAPACITY
+    size_type size() const;
+    size_type capacity() const;
+    size_type window() const;
+    size_type cache_size() const;
+    bool empty() const;
+    void reserve(size_type n);
+    void resize(size_type n);
+
+    // ELEMENT ACCESS
+    reference operator[](size_type n);
+    const_reference operator[](size_type n) const;
+    reference at(size_type n);
+    const_reference at(size_type n) const;
+    reference front();
+    const_reference front() const;
+    reference back();
+    const_reference back() const;
+
+    // MODIFIERS
+    void push_back(const value_type& value);
+    void pop_back();
+    void append(const_pointer first, size_type n);
+    template <typename InputIter>
+    void append(InputIter first, InputIter last);
+    void clear();
+
+    // SCAN
+    template <typename Function>
+    void scan(Function f);
+
+    template <typename Function>
+    void scan(Function f) const;
+
+    template <typename Function>
+    void scan(size_type first, size_type last, Function f);
+
+    template <typename Function>
+    void scan(size_type first, size_type last, Function f) const;
+
+private:
+    template <typename Pointer, typename Function>
+    void scan_impl(size_type first, size_type last, Function& f) const;
+
+    pointer element(size_type n) const;
+
+    mutable memmap_file file_;
+    size_type per_window_ = 0;
+};
+
+// IMPLEMENTATION
+// --------------
+
+// ITERATOR
+
+
+template <typename A, typename T>
+memmap_array_iterator<A, T>::memmap_array_iterator(A* array, size_t index) noexcept:
+    array_(array),
+    index_(index)
+{}
+
+
+template <typename A, typename T>
+template <typename A2, typename U, typename>
+memmap_array_iterator<A, T>::memmap_array_iterator(const memmap_array_iterator<A2, U>& rhs) noexcept:
+    array_(rhs.array_),
+    index_(rhs.index_)
+{}
+
+
+template <typename A, typename T>
+bool memmap_array_iterator<A, T>::operator==(const self_t& rhs) const noexcept
+{
+    return index_ == rhs.index_;
+}
+
+
+template <typename A, typename T>
+bool memmap_array_iterator<A, T>::operator!=(const self_t& rhs) const noexcept
+{
+    return index_ != rhs.index_;
+}
+
+
+template <typename A, typename T>
+bool memmap_array_iterator<A, T>::operator<(const self_t& rhs) const noexcept
+{
+    return index_ < rhs.index_;
+}
+
+
+template <typename A, typename T>
+bool memmap_array_iterator<A, T>::operator<=(const self_t& rhs) const noexcept
+{
+    return index_ <= rhs.index_;
+}
+
+
+template <typename A, typename T>
+bool memmap_array_iterator<A, T>::operator>(const self_t& rhs) const noexcept
+{
+    return index_ > rhs.index_;
+}
+
+
+template <typename A, typename T>
+bool memmap_array_iterator<A, T>::operator>=(const self_t& rhs) const noexcept
+{
+    return index_ >= rhs.index_;
+}
+
+
+template <typename A, typename T>
+auto memmap_array_iterator<A, T>::operator++() noexcept -> self_t&
+{
+    ++index_;
+    return *this;
+}
+
+
+template <typename A, typename T>
+auto memmap_array_iterator<A, T>::operator++(int) noexcept -> self_t
+{
+    self_t copy(*this);
+    ++index_;
+    return copy;
+}
+
+
+template <typename A, typename T>
+auto memmap_array_iterator<A, T>::operator--() noexcept -> self_t&
+{
+    --index_;
+    return *this;
+}
+
+
+template <typename A, typename T>
+auto memmap_array_iterator<A, T>::operator--(int) noexcept -> self_t
+{
+    self_t copy(*this);
+    --index_;
+    return copy;
+}
+
+
+template <typename A, typename T>
+auto memmap_array_iterator<A, T>::operator+=(difference_type n) noexcept -> self_t&
+{
+    index_ += n;
+    return *this;
+}
+
+
+template <typename A, typename T>
+auto memmap_array_iterator<A, T>::operator-=(difference_type n) noexcept -> self_t&
+{
+    index_ -= n;
+    return *this;
+}
+
+
+template <typename A, typename T>
+auto memmap_array_iterator<A, T>::operator+(difference_type n) const noexcept -> self_t
+{
+    return self_t(array_, index_ + n);
+}
+
+
+template <typename A, typename T>
+auto memmap_array_iterator<A, T>::operator-(difference_type n) const noexcept -> self_t
+{
+    return self_t(array_, index_ - n);
+}
+
+
+template <typename A, typename T>
+auto memmap_array_iterator<A, T>::operator-(const self_t& rhs) const noexcept -> difference_type
+{
+    return static_cast<difference_type>(index_ - rhs.index_);
+}
+
+
+template <typename A, typename T>
+auto memmap_array_iterator<A, T>::operator[](difference_type n) const -> reference
+{
+    return (*array_)[index_ + n];
+}
+
+
+template <typename A, typename T>
+auto memmap_array_iterator<A, T>::operator*() const -> reference
+{
+    return (*array_)[index_];
+}
+
+
+template <typename A, typename T>
+auto memmap_array_iterator<A, T>::operator->() const -> pointer
+{
+    return &(*array_)[index_];
+}
+
+
+template <typename A, typename T>
+void memmap_array_iterator<A, T>::swap(self_t& rhs) noexcept
+{
+    using PYCPP_NAMESPACE::swap;
+    swap(array_, rhs.array_);
+    swap(index_, rhs.index_);
+}
+
+// ARRAY
+
+
+template <typename T>
+memmap_array<T>::memmap_array(const path_view_t& path, ios_base::openmode mode, size_t window, size_t cache_size)
+{
+    open(path, mode, window, cache_size);
+}
+
+
+template <typename T>
+void memmap_array<T>::open(const path_view_t& path, ios_base::openmode mode, size_t window, size_t cache_size)
+{
+    // windows must be aligned to the mapping granularity, and
+    // hold a whole number of elements
+    size_t a = memmap_file::granularity();
+    size_t b = sizeof(value_type);
+    while (b) {
+        a %= b;
+        PYCPP_NAMESPACE::swap(a, b);
+    }
+    size_t unit = memmap_file::granularity() / a * sizeof(value_type);
+    window = max(window, unit);
+    window += (unit - window % unit) % unit;
 
-// FUNCTIONS
-// ---------
+    file_.open(path, mode, window, cache_size);
+    per_window_ = file_.window() / sizeof(value_type);
+    if (file_.size() % sizeof(value_type)) {
+        file_.close();
+        throw filesystem_error(filesystem_invalid_parameter);
+    }
+}
 
-// TODO: this should be a NumPy-style array, so it can
-// be a matrix....
-// TODO: how do I estimate the blocksize then???
+
+template <typename T>
+void memmap_array<T>::close()
+{
+    file_.close();
+}
+
+
+template <typename T>
+bool memmap_array<T>::is_open() const
+{
+    return file_.is_open();
+}
+
+
+template <typename T>
+void memmap_array<T>::flush(bool async)
+{
+    file_.flush(async);
+}
+
+
+template <typename T>
+void memmap_array<T>::swap(self_t& rhs)
+{
+    using PYCPP_NAMESPACE::swap;
+    file_.swap(rhs.file_);
+    swap(per_window_, rhs.per_window_);
+}
+
+
+template <typename T>
+auto memmap_array<T>::begin() -> iterator
+{
+    return iterator(this, 0);
+}
+
+
+template <typename T>
+auto memmap_array<T>::begin() const -> const_iterator
+{
+    return const_iterator(this, 0);
+}
+
+
+template <typename T>
+auto memmap_array<T>::cbegin() const -> const_iterator
+{
+    return begin();
+}
+
+
+template <typename T>
+auto memmap_array<T>::end() -> iterator
+{
+    return iterator(this, size());
+}
+
+
+template <typename T>
+auto memmap_array<T>::end() const -> const_iterator
+{
+    return const_iterator(this, size());
+}
+
+
+template <typename T>
+auto memmap_array<T>::cend() const -> const_iterator
+{
+    return end();
+}
+
+
+template <typename T>
+auto memmap_array<T>::rbegin() -> reverse_iterator
+{
+    return reverse_iterator(end());
+}
+
+
+template <typename T>
+auto memmap_array<T>::rbegin() const -> const_reverse_iterator
+{
+    return const_reverse_iterator(end());
+}
+
+
+template <typename T>
+auto memmap_array<T>::crbegin() const -> const_reverse_iterator
+{
+    return rbegin();
+}
+
+
+template <typename T>
+auto memmap_array<T>::rend() -> reverse_iterator
+{
+    return reverse_iterator(begin());
+}
+
+
+template <typename T>
+auto memmap_array<T>::rend() const -> const_reverse_iterator
+{
+    return const_reverse_iterator(begin());
+}
+
+
+template <typename T>
+auto memmap_array<T>::crend() const -> const_reverse_iterator
+{
+    return rend();
+}
+
+
+template <typename T>
+auto memmap_array<T>::size() const -> size_type
+{
+    return file_.size() / sizeof(value_type);
+}
+
+
+template <typename T>
+auto memmap_array<T>::capacity() const -> size_type
+{
+    return file_.capacity() / sizeof(value_type);
+}
+
+
+template <typename T>
+auto memmap_array<T>::window() const -> size_type
+{
+    return per_window_;
+}
+
+
+template <typename T>
+auto memmap_array<T>::cache_size() const -> size_type
+{
+    return file_.cache_size();
+}
+
+
+template <typename T>
+bool memmap_array<T>::empty() const
+{
+    return file_.size() == 0;
+}
+
+
+template <typename T>
+void memmap_array<T>::reserve(size_type n)
+{
+    file_.reserve(n * sizeof(value_type));
+}
+
+
+template <typename T>
+void memmap_array<T>::resize(size_type n)
+{
+    file_.resize(n * sizeof(value_type));
+}
+
+
+template <typename T>
+auto memmap_array<T>::operator[](size_type n) -> reference
+{
+    assert(n < size() && "Index out of range.");
+    return *element(n);
+}
+
+
+template <typename T>
+auto memmap_array<T>::operator[](size_type n) const -> const_reference
+{
+    assert(n < size() && "Index out of range.");
+    return *element(n);
+}
+
+
+template <typename T>
+auto memmap_array<T>::at(size_type n) -> reference
+{
+    if (n >= size()) {
+        throw out_of_range("memmap_array::at(): Index out of range.");
+    }
+    return *element(n);
+}
+
+
+template <typename T>
+auto memmap_array<T>::at(size_type n) const -> const_reference
+{
+    if (n >= size()) {
+        throw out_of_range("memmap_array::at(): Index out of range.");
+    }
+    return *element(n);
+}
+
+
+template <typename T>
+auto memmap_array<T>::front() -> reference
+{
+    return (*this)[0];
+}
+
+
+template <typename T>
+auto memmap_array<T>::front() const -> const_reference
+{
+    return (*this)[0];
+}
+
+
+template <typename T>
+auto memmap_array<T>::back() -> reference
+{
+    return (*this)[size() - 1];
+}
+
+
+template <typename T>
+auto memmap_array<T>::back() const -> const_reference
+{
+    return (*this)[size() - 1];
+}
+
+
+template <typename T>
+void memmap_array<T>::push_back(const value_type& value)
+{
+    size_type n = size();
+    file_.resize((n + 1) * sizeof(value_type));
+    *element(n) = value;
+}
+
+
+template <typename T>
+void memmap_array<T>::pop_back()
+{
+    assert(!empty() && "Cannot pop from an empty array.");
+    file_.resize(file_.size() - sizeof(value_type));
+}
+
+
+template <typename T>
+void memmap_array<T>::append(const_pointer first, size_type n)
+{
+    size_type index = size();
+    file_.resize((index + n) * sizeof(value_type));
+
+    // copy a window at a time, reading ahead the next one
+    while (n) {
+        size_type offset = index % per_window_;
+        size_type count = min(n, per_window_ - offset);
+        if (count < n) {
+            file_.prefetch(index / per_window_ + 1);
+        }
+        memcpy(element(index), first, count * sizeof(value_type));
+        first += count;
+        index += count;
+        n -= count;
+    }
+}
+
+
+template <typename T>
+template <typename InputIter>
+void memmap_array<T>::append(InputIter first, InputIter last)
+{
+    for (; first != last; ++first) {
+        push_back(*first);
+    }
+}
+
+
+template <typename T>
+void memmap_array<T>::clear()
+{
+    resize(0);
+}
+
+
+template <typename T>
+template <typename Function>
+void memmap_array<T>::scan(Function f)
+{
+    scan_impl<pointer>(0, size(), f);
+}
+
+
+template <typename T>
+template <typename Function>
+void memmap_array<T>::scan(Function f) const
+{
+    scan_impl<const_pointer>(0, size(), f);
+}
+
+
+template <typename T>
+template <typename Function>
+void memmap_array<T>::scan(size_type first, size_type last, Function f)
+{
+    scan_impl<pointer>(first, last, f);
+}
+
+
+template <typename T>
+template <typename Function>
+void memmap_array<T>::scan(size_type first, size_type last, Function f) const
+{
+    scan_impl<const_pointer>(first, last, f);
+}
+
+
+/**
+ *  \brief Call `f(data, count)` for each contiguous run in `[first, last)`.
+ */
+template <typename T>
+template <typename Pointer, typename Function>
+void memmap_array<T>::scan_impl(size_type first, size_type last, Function& f) const
+{
+    assert(first <= last && last <= size() && "Range out of bounds.");
+    while (first < last) {
+        size_type offset = first % per_window_;
+        size_type count = min(last - first, per_window_ - offset);
+        if (first + count < last) {
+            file_.prefetch(first / per_window_ + 1);
+        }
+        f(static_cast<Pointer>(element(first)), count);
+        first += count;
+    }
+}
+
+
+template <typename T>
+auto memmap_array<T>::element(size_type n) const -> pointer
+{
+    char* data = file_.data(n / per_window_);
+    return reinterpret_cast<pointer>(data) + n % per_window_;
+}
 
 PYCPP_END_NAMESPACE
+
+#endif                                                  // MMAP
@@ -0,0 +1,301 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/filesystem/exception.h>
+#include <pycpp/memmap/file.h>
+#include <pycpp/stl/algorithm.h>
+
+#if defined(HAVE_MMAP) || defined(OS_WINDOWS)           // MMAP
+
+#if defined(HAVE_POSIX_FADVISE)
+#   include <fcntl.h>
+#endif
+
+PYCPP_BEGIN_NAMESPACE
+
+// VARIABLES
+// ---------
+
+size_t MEMMAP_WINDOW_SIZE = 16 << 20;
+size_t MEMMAP_CACHE_SIZE = 16;
+
+// DECLARATIONS
+// ------------
+
+size_t file_length(fd_t fd);
+size_t allocation_granularity();
+void* open_memory_view(fd_t fd, ios_base::openmode mode, size_t offset, size_t length, const mmap_options& options);
+int memory_sync(void *addr, size_t length, bool async);
+int close_memory_view(void *addr, size_t length);
+
+// OBJECTS
+// -------
+
+// WINDOW
+
+
+memmap_window::memmap_window(char* data, size_t length):
+    data(data),
+    length(length)
+{}
+
+
+memmap_window::memmap_window(memmap_window&& rhs)
+{
+    *this = move(rhs);
+}
+
+
+memmap_window& memmap_window::operator=(memmap_window&& rhs)
+{
+    swap(data, rhs.data);
+    swap(length, rhs.length);
+    return *this;
+}
+
+
+memmap_window::~memmap_window()
+{
+    if (data) {
+        close_memory_view(data, length);
+    }
+}
+
+// FILE
+
+
+memmap_file::memmap_file():
+    cache_(static_cast<int>(MEMMAP_CACHE_SIZE))
+{}
+
+
+memmap_file::memmap_file(const path_view_t& path, ios_base::openmode mode, size_t window, size_t cache_size):
+    memmap_file()
+{
+    open(path, mode, window, cache_size);
+}
+
+
+memmap_file::memmap_file(memmap_file&& rhs):
+    memmap_file()
+{
+    swap(rhs);
+}
+
+
+memmap_file& memmap_file::operator=(memmap_file&& rhs)
+{
+    swap(rhs);
+    return *this;
+}
+
+
+memmap_file::~memmap_file()
+{
+    close();
+}
+
+
+void memmap_file::open(const path_view_t& path, ios_base::openmode mode, size_t window, size_t cache_size)
+{
+    close();
+
+    // a shared, writable mapping requires a readable descriptor
+    if (mode & ios_base::out) {
+        mode |= ios_base::in;
+    }
+    fd_t fd = fd_open(path, mode);
+    if (fd == INVALID_FD_VALUE) {
+        throw filesystem_error(filesystem_file_not_found);
+    }
+
+    size_t unit = granularity();
+    fd_ = fd;
+    mode_ = mode;
+    size_ = capacity_ = file_length(fd);
+    window_ = max(window, unit);
+    window_ += (unit - window_ % unit) % unit;
+    cache_ = lru_cache<size_t, memmap_window>(static_cast<int>(max<size_t>(cache_size, 2)));
+}
+
+
+void memmap_file::close()
+{
+    if (!is_open()) {
+        return;
+    }
+
+    // unmapping a shared mapping does not discard changes
+    evict(0);
+    if ((mode_ & ios_base::out) && capacity_ != size_) {
+        fd_truncate(fd_, size_);
+    }
+    fd_close(fd_);
+    fd_ = INVALID_FD_VALUE;
+    size_ = 0;
+    capacity_ = 0;
+}
+
+
+bool memmap_file::is_open() const
+{
+    return fd_ != INVALID_FD_VALUE;
+}
+
+
+void memmap_file::flush(bool async)
+{
+    for (const memmap_window& window: cache_) {
+        memory_sync(window.data, window.length, async);
+    }
+}
+
+
+void memmap_file::swap(memmap_file& rhs)
+{
+    using PYCPP_NAMESPACE::swap;
+
+    swap(fd_, rhs.fd_);
+    swap(mode_, rhs.mode_);
+    swap(size_, rhs.size_);
+    swap(capacity_, rhs.capacity_);
+    swap(window_, rhs.window_);
+    swap(cache_, rhs.cache_);
+    swap(last_index_, rhs.last_index_);
+    swap(last_data_, rhs.last_data_);
+}
+
+
+ios_base::openmode memmap_file::mode() const
+{
+    return mode_;
+}
+
+
+size_t memmap_file::size() const
+{
+    return size_;
+}
+
+
+size_t memmap_file::capacity() const
+{
+    return capacity_;
+}
+
+
+size_t memmap_file::window() const
+{
+    return window_;
+}
+
+
+size_t memmap_file::cache_size() const
+{
+    return cache_.cache_size();
+}
+
+
+size_t memmap_file::granularity()
+{
+    return allocation_granularity();
+}
+
+
+void memmap_file::resize(size_t size)
+{
+    if (!(mode_ & ios_base::out)) {
+        throw filesystem_error(filesystem_permissions_error);
+    }
+
+    if (size > capacity_) {
+        reserve(size);
+    } else if (size < size_) {
+        // truncate, so the tail reads as zeros if the file regrows
+        evict(size / window_ + (size % window_ != 0));
+        if (fd_truncate(fd_, size) != 0) {
+            throw filesystem_error(filesystem_unexpected_error);
+        }
+        capacity_ = size;
+    }
+    size_ = size;
+}
+
+
+void memmap_file::reserve(size_t size)
+{
+    if (size <= capacity_) {
+        return;
+    } else if (!(mode_ & ios_base::out)) {
+        throw filesystem_error(filesystem_permissions_error);
+    }
+
+    // the last window may have been mapped short of a whole window
+    if (capacity_ % window_) {
+        evict(capacity_ / window_);
+    }
+
+    size_t capacity = size + (window_ - size % window_) % window_;
+    if (fd_allocate(fd_, capacity) != 0 && fd_truncate(fd_, capacity) != 0) {
+        throw filesystem_error(filesystem_out_of_memory);
+    }
+    capacity_ = capacity;
+}
+
+
+void memmap_file::prefetch(size_t index)
+{
+    size_t offset = index * window_;
+    if (offset >= capacity_) {
+        return;
+    }
+#if defined(HAVE_POSIX_FADVISE)
+    size_t length = min(window_, capacity_ - offset);
+    posix_fadvise(fd_, offset, length, POSIX_FADV_WILLNEED);
+#endif
+}
+
+
+char* memmap_file::load(size_t index)
+{
+    auto it = cache_.find(index);
+    if (it == cache_.end()) {
+        size_t offset = index * window_;
+        if (offset >= capacity_) {
+            throw filesystem_error(filesystem_seek_offset_beyond_file);
+        }
+        size_t length = min(window_, capacity_ - offset);
+        void* addr = open_memory_view(fd_, mode_, offset, length, mmap_options());
+        if (!addr) {
+            throw filesystem_error(filesystem_unexpected_error);
+        }
+        it = cache_.insert(size_t(index), memmap_window(reinterpret_cast<char*>(addr), length)).first;
+    }
+
+    last_index_ = index;
+    last_data_ = (*it).data;
+    return last_data_;
+}
+
+
+void memmap_file::evict(size_t first)
+{
+    size_t count = cache_.size();
+    for (size_t i = 0; i < count; ++i) {
+        // the least-recently used window is at the back
+        size_t index = (--cache_.end()).base()->first;
+        if (index >= first) {
+            cache_.erase(index);
+        } else {
+            cache_[index];
+        }
+    }
+    if (last_index_ >= first) {
+        last_index_ = SIZE_MAX;
+        last_data_ = nullptr;
+    }
+}
+
+PYCPP_END_NAMESPACE
+
+#endif                                                  // MMAP
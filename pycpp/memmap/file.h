@@ -0,0 +1,161 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief File mapped through an LRU cache of fixed-size windows.
+ *
+ *  Only the windows being accessed are mapped, so the file may be
+ *  far larger than the address space or physical memory. A bounded
+ *  number of windows stay mapped, and accessing an unmapped window
+ *  unmaps the least-recently used one, invalidating any pointers
+ *  into it. The last window accessed is remembered, so repeated
+ *  accesses to one window do not touch the cache.
+ *
+ *  Files open for writing grow in whole windows, allocated as if by
+ *  `posix_fallocate`, and are truncated back to their logical size
+ *  on `close`. Bytes past the logical size are always zero.
+ *
+ *  \synopsis
+ *      extern size_t MEMMAP_WINDOW_SIZE;
+ *      extern size_t MEMMAP_CACHE_SIZE;
+ *
+ *      class memmap_file
+ *      {
+ *      public:
+ *          memmap_file();
+ *          memmap_file(const path_view_t& path, ios_base::openmode mode = ios_base::in | ios_base::out, size_t window = MEMMAP_WINDOW_SIZE, size_t cache_size = MEMMAP_CACHE_SIZE);
+ *          memmap_file(const memmap_file&) = delete;
+ *          memmap_file& operator=(const memmap_file&) = delete;
+ *          memmap_file(memmap_file&&);
+ *          memmap_file& operator=(memmap_file&&);
+ *          ~memmap_file();
+ *
+ *          void open(const path_view_t& path, ios_base::openmode mode = ios_base::in | ios_base::out, size_t window = MEMMAP_WINDOW_SIZE, size_t cache_size = MEMMAP_CACHE_SIZE);
+ *          void close();
+ *          bool is_open() const;
+ *          void flush(bool async = false);
+ *          void swap(memmap_file&);
+ *
+ *          ios_base::openmode mode() const;
+ *          size_t size() const;
+ *          size_t capacity() const;
+ *          size_t window() const;
+ *          size_t cache_size() const;
+ *          static size_t granularity();
+ *
+ *          void resize(size_t size);
+ *          void reserve(size_t size);
+ *
+ *          char* data(size_t index);
+ *          void prefetch(size_t index);
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/cache/lru.h>
+#include <pycpp/filesystem.h>
+#include <pycpp/stream/mmap.h>
+#include <stdint.h>
+
+#if defined(HAVE_MMAP) || defined(OS_WINDOWS)           // MMAP
+
+PYCPP_BEGIN_NAMESPACE
+
+// VARIABLES
+// ---------
+
+extern size_t MEMMAP_WINDOW_SIZE;
+extern size_t MEMMAP_CACHE_SIZE;
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Mapping of a single window, unmapped on destruction.
+ */
+struct memmap_window
+{
+    memmap_window() = default;
+    memmap_window(char* data, size_t length);
+    memmap_window(const memmap_window&) = delete;
+    memmap_window& operator=(const memmap_window&) = delete;
+    memmap_window(memmap_window&&);
+    memmap_window& operator=(memmap_window&&);
+    ~memmap_window();
+
+    char* data = nullptr;
+    size_t length = 0;
+};
+
+
+/**
+ *  \brief File accessed through an LRU cache of mapped windows.
+ *
+ *  Window `index` covers the bytes `[index * window(), (index + 1) *
+ *  window())`. Pointers returned by `data` stay valid until
+ *  `cache_size()` other windows have been accessed, or the file is
+ *  resized or closed.
+ */
+class memmap_file
+{
+public:
+    memmap_file();
+    memmap_file(const path_view_t& path, ios_base::openmode mode = ios_base::in | ios_base::out, size_t window = MEMMAP_WINDOW_SIZE, size_t cache_size = MEMMAP_CACHE_SIZE);
+    memmap_file(const memmap_file&) = delete;
+    memmap_file& operator=(const memmap_file&) = delete;
+    memmap_file(memmap_file&&);
+    memmap_file& operator=(memmap_file&&);
+    ~memmap_file();
+
+    // MODIFIERS/PROPERTIES
+    void open(const path_view_t& path, ios_base::openmode mode = ios_base::in | ios_base::out, size_t window = MEMMAP_WINDOW_SIZE, size_t cache_size = MEMMAP_CACHE_SIZE);
+    void close();
+    bool is_open() const;
+    void flush(bool async = false);
+    void swap(memmap_file&);
+
+    ios_base::openmode mode() const;
+    size_t size() const;
+    size_t capacity() const;
+    size_t window() const;
+    size_t cache_size() const;
+    static size_t granularity();
+
+    // CAPACITY
+    void resize(size_t size);
+    void reserve(size_t size);
+
+    // WINDOWS
+    char* data(size_t index);
+    void prefetch(size_t index);
+
+private:
+    char* load(size_t index);
+    void evict(size_t first);
+
+    fd_t fd_ = INVALID_FD_VALUE;
+    ios_base::openmode mode_ = ios_base::in;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    size_t window_ = 0;
+    lru_cache<size_t, memmap_window> cache_;
+    size_t last_index_ = SIZE_MAX;
+    char* last_data_ = nullptr;
+};
+
+// IMPLEMENTATION
+// --------------
+
+
+inline char* memmap_file::data(size_t index)
+{
+    if (index == last_index_) {
+        return last_data_;
+    }
+    return load(index);
+}
+
+PYCPP_END_NAMESPACE
+
+#endif                                                  // MMAP
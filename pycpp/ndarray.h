@@ -0,0 +1,14 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief N-dimensional arrays, views and kernels.
+ */
+
+#pragma once
+
+#include <pycpp/ndarray/array.h>
+#include <pycpp/ndarray/iterator.h>
+#include <pycpp/ndarray/kernel.h>
+#include <pycpp/ndarray/shape.h>
+#include <pycpp/ndarray/view.h>
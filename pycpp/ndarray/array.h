@@ -0,0 +1,943 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief N-dimensional array with broadcasting arithmetic.
+ *
+ *  An owning, contiguous, row-major array, similar to NumPy's
+ *  `ndarray`. Slicing, transposing and broadcasting return
+ *  `ndarray_view`s of the data without copying. Arithmetic between
+ *  arrays, views and scalars broadcasts the operands, and walks them
+ *  in runs that are as long as possible, so contiguous `float` and
+ *  `double` operands use the vectorized kernels.
+ *
+ *  Storage is allocator-aware, and results of arithmetic use the
+ *  allocator of the first array operand, so temporaries may be
+ *  placed in a stack or linear arena.
+ *
+ *  \synopsis
+ *      template <typename T, typename Alloc = allocator<T>>
+ *      class ndarray
+ *      {
+ *      public:
+ *          using value_type = T;
+ *          using allocator_type = Alloc;
+ *          using reference = T&;
+ *          using const_reference = const T&;
+ *          using pointer = T*;
+ *          using const_pointer = const T*;
+ *          using iterator = T*;
+ *          using const_iterator = const T*;
+ *          using view_type = ndarray_view<T>;
+ *          using const_view_type = ndarray_view<const T>;
+ *
+ *          ndarray(const allocator_type& alloc = allocator_type());
+ *          ndarray(const ndarray_shape& shape, const allocator_type& alloc = allocator_type());
+ *          ndarray(const ndarray_shape& shape, const value_type& value, const allocator_type& alloc = allocator_type());
+ *          ndarray(const ndarray_shape& shape, initializer_list<value_type> list, const allocator_type& alloc = allocator_type());
+ *          template <typename U> explicit ndarray(const ndarray_view<U>& view, const allocator_type& alloc = allocator_type());
+ *
+ *          pointer data() noexcept;
+ *          const_pointer data() const noexcept;
+ *          const ndarray_shape& shape() const noexcept;
+ *          ndarray_strides strides() const;
+ *          size_t ndim() const noexcept;
+ *          size_t size() const noexcept;
+ *          bool empty() const noexcept;
+ *
+ *          template <typename ... Ts> reference operator()(Ts ... index) noexcept;
+ *          template <typename ... Ts> const_reference operator()(Ts ... index) const noexcept;
+ *          reference at(const ndarray_shape& index);
+ *          const_reference at(const ndarray_shape& index) const;
+ *          view_type operator[](size_t index) noexcept;
+ *          const_view_type operator[](size_t index) const noexcept;
+ *
+ *          view_type view() noexcept;
+ *          const_view_type view() const noexcept;
+ *          view_type slice(initializer_list<ndarray_slice> slices);
+ *          const_view_type slice(initializer_list<ndarray_slice> slices) const;
+ *          view_type slice(size_t axis, const ndarray_slice& slice);
+ *          const_view_type slice(size_t axis, const ndarray_slice& slice) const;
+ *          view_type transpose() noexcept;
+ *          const_view_type transpose() const noexcept;
+ *          view_type transpose(const ndarray_shape& axes);
+ *          const_view_type transpose(const ndarray_shape& axes) const;
+ *          view_type reshape(const ndarray_shape& shape);
+ *          const_view_type reshape(const ndarray_shape& shape) const;
+ *          const_view_type broadcast_to(const ndarray_shape& shape) const;
+ *
+ *          iterator begin() noexcept;
+ *          const_iterator begin() const noexcept;
+ *          iterator end() noexcept;
+ *          const_iterator end() const noexcept;
+ *
+ *          void fill(const value_type& value);
+ *          void resize(const ndarray_shape& shape);
+ *          void swap(ndarray& other);
+ *          allocator_type get_allocator() const;
+ *
+ *          template <typename U> ndarray& operator+=(const U& other);
+ *          template <typename U> ndarray& operator-=(const U& other);
+ *          template <typename U> ndarray& operator*=(const U& other);
+ *          template <typename U> ndarray& operator/=(const U& other);
+ *      };
+ *
+ *      // X and Y are an ndarray, an ndarray_view, or an arithmetic scalar
+ *      template <typename X, typename Y> ndarray<...> operator+(const X& x, const Y& y);
+ *      template <typename X, typename Y> ndarray<...> operator-(const X& x, const Y& y);
+ *      template <typename X, typename Y> ndarray<...> operator*(const X& x, const Y& y);
+ *      template <typename X, typename Y> ndarray<...> operator/(const X& x, const Y& y);
+ *
+ *      template <typename X> value_type sum(const X& x);
+ *      template <typename X> ndarray<value_type> sum(const X& x, size_t axis);
+ *      template <typename X> double mean(const X& x);
+ *      template <typename X> value_type amin(const X& x);
+ *      template <typename X> value_type amax(const X& x);
+ */
+
+#pragma once
+
+#include <pycpp/ndarray/kernel.h>
+#include <pycpp/ndarray/view.h>
+#include <pycpp/stl/functional.h>
+#include <pycpp/stl/memory.h>
+#include <pycpp/stl/vector.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// FORWARD
+// -------
+
+template <typename T, typename Alloc = allocator<T>>
+class ndarray;
+
+// DETAIL
+// ------
+
+namespace ndarray_detail
+{
+// TRAITS
+
+template <typename T, typename = void>
+struct operand_traits
+{};
+
+
+template <typename T>
+struct operand_traits<T, enable_if_t<is_arithmetic<T>::value>>
+{
+    using value_type = T;
+
+    template <typename R>
+    using allocator_type = allocator<R>;
+};
+
+
+template <typename T>
+struct operand_traits<ndarray_view<T>>
+{
+    using value_type = remove_const_t<T>;
+
+    template <typename R>
+    using allocator_type = allocator<R>;
+};
+
+
+template <typename T, typename Alloc>
+struct operand_traits<ndarray<T, Alloc>>
+{
+    using value_type = T;
+
+    template <typename R>
+    using allocator_type = typename allocator_traits<Alloc>::template rebind_alloc<R>;
+};
+
+
+template <typename T, typename = void>
+struct is_operand: false_type
+{};
+
+
+template <typename T>
+struct is_operand<T, void_t<typename operand_traits<T>::value_type>>: true_type
+{};
+
+
+template <typename T>
+struct is_array_operand: false_type
+{};
+
+
+template <typename T>
+struct is_array_operand<ndarray_view<T>>: true_type
+{};
+
+
+template <typename T, typename Alloc>
+struct is_array_operand<ndarray<T, Alloc>>: true_type
+{};
+
+
+template <typename X, typename Y>
+struct is_binary_operand: integral_constant<
+        bool,
+        is_operand<X>::value && is_operand<Y>::value && (is_array_operand<X>::value || is_array_operand<Y>::value)
+    >
+{};
+
+
+template <typename X>
+using operand_value_t = typename operand_traits<X>::value_type;
+
+
+template <typename X, typename Y>
+using array_operand_t = conditional_t<is_array_operand<X>::value, X, Y>;
+
+
+template <typename X, typename Y>
+using scalar_operand_t = conditional_t<is_array_operand<X>::value, Y, X>;
+
+
+/**
+ *  \brief Value type of an elementwise result.
+ *
+ *  Scalars do not promote the array they are combined with, as in
+ *  NumPy, unless a floating-point scalar meets an integral array.
+ */
+template <typename X, typename Y>
+using result_value_t = conditional_t<
+    is_array_operand<X>::value == is_array_operand<Y>::value ||
+        (is_integral<operand_value_t<array_operand_t<X, Y>>>::value && is_floating_point<scalar_operand_t<X, Y>>::value),
+    common_type_t<operand_value_t<X>, operand_value_t<Y>>,
+    operand_value_t<array_operand_t<X, Y>>
+>;
+
+
+template <typename X, typename Y>
+using result_allocator_t = typename operand_traits<array_operand_t<X, Y>>::template allocator_type<result_value_t<X, Y>>;
+
+
+template <typename X, typename Y>
+using result_t = ndarray<result_value_t<X, Y>, result_allocator_t<X, Y>>;
+
+// ALLOCATORS
+
+template <typename R, typename T>
+allocator<R> result_allocator(const T&)
+{
+    return allocator<R>();
+}
+
+
+template <typename R, typename T, typename Alloc>
+typename allocator_traits<Alloc>::template rebind_alloc<R> result_allocator(const ndarray<T, Alloc>& x)
+{
+    return typename allocator_traits<Alloc>::template rebind_alloc<R>(x.get_allocator());
+}
+
+
+template <typename R, typename X, typename Y>
+result_allocator_t<X, Y> result_allocator(const X& x, const Y&, true_type)
+{
+    return result_allocator<R>(x);
+}
+
+
+template <typename R, typename X, typename Y>
+result_allocator_t<X, Y> result_allocator(const X&, const Y& y, false_type)
+{
+    return result_allocator<R>(y);
+}
+
+// VIEWS
+
+template <typename T>
+ndarray_view<const T> to_view(const ndarray_view<T>& x) noexcept
+{
+    return x;
+}
+
+
+template <typename T, typename Alloc>
+ndarray_view<const T> to_view(const ndarray<T, Alloc>& x) noexcept
+{
+    return x.view();
+}
+
+
+/**
+ *  \brief 0-dimensional view of a scalar, which broadcasts to any shape.
+ */
+template <typename T>
+enable_if_t<is_arithmetic<T>::value, ndarray_view<const T>> to_view(const T& x)
+{
+    return ndarray_view<const T>(&x, ndarray_shape());
+}
+
+/**
+ *  \brief Convert scalars to the value type of the result.
+ *
+ *  Keeps both operands of the same type, so `float` arrays combined
+ *  with `double` scalars still use the vectorized kernels.
+ */
+template <typename R, typename T>
+enable_if_t<is_arithmetic<T>::value, R> promote(const T& x)
+{
+    return static_cast<R>(x);
+}
+
+
+template <typename R, typename T>
+enable_if_t<!is_arithmetic<T>::value, const T&> promote(const T& x)
+{
+    return x;
+}
+
+// KERNELS
+
+/**
+ *  \brief Compute `out = x op y`, broadcasting `x` and `y` to `out`.
+ */
+template <typename T, typename U, typename V>
+void binary_apply(ndarray_op op, const ndarray_view<T>& out, const ndarray_view<const U>& x, const ndarray_view<const V>& y)
+{
+    ndarray_view<const U> xb = x.broadcast_to(out.shape());
+    ndarray_view<const V> yb = y.broadcast_to(out.shape());
+    array<char*, 3> data = {{
+        reinterpret_cast<char*>(out.data()),
+        reinterpret_cast<char*>(const_cast<U*>(xb.data())),
+        reinterpret_cast<char*>(const_cast<V*>(yb.data())),
+    }};
+    array<ndarray_strides, 3> strides = {{
+        byte_strides(out),
+        byte_strides(xb),
+        byte_strides(yb),
+    }};
+    strided_apply<3>(out.shape(), data, strides, [op](char** ptr, const ptrdiff_t* step, size_t n) {
+        ndarray_binary(op,
+            reinterpret_cast<T*>(ptr[0]), step[0] / static_cast<ptrdiff_t>(sizeof(T)),
+            reinterpret_cast<const U*>(ptr[1]), step[1] / static_cast<ptrdiff_t>(sizeof(U)),
+            reinterpret_cast<const V*>(ptr[2]), step[2] / static_cast<ptrdiff_t>(sizeof(V)),
+            n);
+    });
+}
+
+
+template <typename X, typename Y>
+result_t<X, Y> binary(ndarray_op op, const X& x, const Y& y)
+{
+    using value_type = result_value_t<X, Y>;
+    const auto& xp = promote<value_type>(x);
+    const auto& yp = promote<value_type>(y);
+    auto xv = to_view(xp);
+    auto yv = to_view(yp);
+    result_t<X, Y> out(ndarray_broadcast_shape(xv.shape(), yv.shape()), result_allocator<value_type>(x, y, is_array_operand<X>()));
+    binary_apply(op, out.view(), xv, yv);
+    return out;
+}
+
+
+/**
+ *  \brief Call `f(data, stride, n)` for each run of elements in `x`.
+ */
+template <typename T, typename Function>
+void unary_apply(const ndarray_view<const T>& x, Function&& f)
+{
+    array<char*, 1> data = {{reinterpret_cast<char*>(const_cast<T*>(x.data()))}};
+    array<ndarray_strides, 1> strides = {{byte_strides(x)}};
+    strided_apply<1>(x.shape(), data, strides, [&f](char** ptr, const ptrdiff_t* step, size_t n) {
+        f(reinterpret_cast<const T*>(ptr[0]), step[0] / static_cast<ptrdiff_t>(sizeof(T)), n);
+    });
+}
+
+
+template <typename T, typename Compare>
+T extremum(const ndarray_view<const T>& x, Compare comp, const char* message)
+{
+    if (x.empty()) {
+        throw invalid_argument(message);
+    }
+    T value = *x.begin();
+    unary_apply(x, [&](const T* data, ptrdiff_t stride, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const T& item = data[static_cast<ptrdiff_t>(i) * stride];
+            if (comp(item, value)) {
+                value = item;
+            }
+        }
+    });
+    return value;
+}
+
+}   /* ndarray_detail */
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Contiguous, row-major N-dimensional array.
+ */
+template <typename T, typename Alloc>
+class ndarray
+{
+public:
+    // MEMBER TYPES
+    // ------------
+    using self_t = ndarray<T, Alloc>;
+    using value_type = T;
+    using allocator_type = Alloc;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using view_type = ndarray_view<T>;
+    using const_view_type = ndarray_view<const T>;
+
+    // MEMBER FUNCTIONS
+    // ----------------
+    ndarray(const allocator_type& alloc = allocator_type());
+    ndarray(const self_t&) = default;
+    self_t& operator=(const self_t&) = default;
+    ndarray(self_t&&) = default;
+    self_t& operator=(self_t&&) = default;
+    ndarray(const ndarray_shape& shape, const allocator_type& alloc = allocator_type());
+    ndarray(const ndarray_shape& shape, const value_type& value, const allocator_type& alloc = allocator_type());
+    ndarray(const ndarray_shape& shape, initializer_list<value_type> list, const allocator_type& alloc = allocator_type());
+    template <typename U>
+    explicit ndarray(const ndarray_view<U>& view, const allocator_type& alloc = allocator_type());
+
+    // PROPERTIES
+    pointer data() noexcept;
+    const_pointer data() const noexcept;
+    const ndarray_shape& shape() const noexcept;
+    ndarray_strides strides() const;
+    size_t ndim() const noexcept;
+    size_t size() const noexcept;
+    bool empty() const noexcept;
+
+    // ELEMENT ACCESS
+    template <typename ... Ts>
+    reference operator()(Ts ... index) noexcept;
+    template <typename ... Ts>
+    const_reference operator()(Ts ... index) const noexcept;
+    reference at(const ndarray_shape& index);
+    const_reference at(const ndarray_shape& index) const;
+    view_type operator[](size_t index) noexcept;
+    const_view_type operator[](size_t index) const noexcept;
+
+    // VIEWS
+    view_type view() noexcept;
+    const_view_type view() const noexcept;
+    view_type slice(initializer_list<ndarray_slice> slices);
+    const_view_type slice(initializer_list<ndarray_slice> slices) const;
+    view_type slice(size_t axis, const ndarray_slice& slice);
+    const_view_type slice(size_t axis, const ndarray_slice& slice) const;
+    view_type transpose() noexcept;
+    const_view_type transpose() const noexcept;
+    view_type transpose(const ndarray_shape& axes);
+    const_view_type transpose(const ndarray_shape& axes) const;
+    view_type reshape(const ndarray_shape& shape);
+    const_view_type reshape(const ndarray_shape& shape) const;
+    const_view_type broadcast_to(const ndarray_shape& shape) const;
+
+    // ITERATORS
+    iterator begin() noexcept;
+    const_iterator begin() const noexcept;
+    iterator end() noexcept;
+    const_iterator end() const noexcept;
+
+    // MODIFIERS
+    void fill(const value_type& value);
+    void resize(const ndarray_shape& shape);
+    void swap(self_t& other);
+    allocator_type get_allocator() const;
+
+    // OPERATORS
+    template <typename U>
+    self_t& operator+=(const U& other);
+    template <typename U>
+    self_t& operator-=(const U& other);
+    template <typename U>
+    self_t& operator*=(const U& other);
+    template <typename U>
+    self_t& operator/=(const U& other);
+
+private:
+    vector<T, Alloc> data_;
+    ndarray_shape shape_;
+};
+
+// IMPLEMENTATION
+// --------------
+
+
+template <typename T, typename Alloc>
+ndarray<T, Alloc>::ndarray(const allocator_type& alloc):
+    data_(alloc),
+    shape_({0})
+{}
+
+
+template <typename T, typename Alloc>
+ndarray<T, Alloc>::ndarray(const ndarray_shape& shape, const allocator_type& alloc):
+    data_(ndarray_size(shape), T(), alloc),
+    shape_(shape)
+{}
+
+
+template <typename T, typename Alloc>
+ndarray<T, Alloc>::ndarray(const ndarray_shape& shape, const value_type& value, const allocator_type& alloc):
+    data_(ndarray_size(shape), value, alloc),
+    shape_(shape)
+{}
+
+
+template <typename T, typename Alloc>
+ndarray<T, Alloc>::ndarray(const ndarray_shape& shape, initializer_list<value_type> list, const allocator_type& alloc):
+    data_(list, alloc),
+    shape_(shape)
+{
+    if (data_.size() != ndarray_size(shape)) {
+        throw invalid_argument("ndarray: number of values does not match the shape.");
+    }
+}
+
+
+template <typename T, typename Alloc>
+template <typename U>
+ndarray<T, Alloc>::ndarray(const ndarray_view<U>& view, const allocator_type& alloc):
+    data_(alloc),
+    shape_(view.shape())
+{
+    if (view.is_contiguous()) {
+        data_.assign(view.data(), view.data() + view.size());
+    } else {
+        data_.resize(view.size());
+        this->view().assign(view);
+    }
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::data() noexcept -> pointer
+{
+    return data_.data();
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::data() const noexcept -> const_pointer
+{
+    return data_.data();
+}
+
+
+template <typename T, typename Alloc>
+const ndarray_shape& ndarray<T, Alloc>::shape() const noexcept
+{
+    return shape_;
+}
+
+
+template <typename T, typename Alloc>
+ndarray_strides ndarray<T, Alloc>::strides() const
+{
+    return ndarray_contiguous_strides(shape_);
+}
+
+
+template <typename T, typename Alloc>
+size_t ndarray<T, Alloc>::ndim() const noexcept
+{
+    return shape_.size();
+}
+
+
+template <typename T, typename Alloc>
+size_t ndarray<T, Alloc>::size() const noexcept
+{
+    return data_.size();
+}
+
+
+template <typename T, typename Alloc>
+bool ndarray<T, Alloc>::empty() const noexcept
+{
+    return data_.empty();
+}
+
+
+template <typename T, typename Alloc>
+template <typename ... Ts>
+auto ndarray<T, Alloc>::operator()(Ts ... index) noexcept -> reference
+{
+    return view()(index...);
+}
+
+
+template <typename T, typename Alloc>
+template <typename ... Ts>
+auto ndarray<T, Alloc>::operator()(Ts ... index) const noexcept -> const_reference
+{
+    return view()(index...);
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::at(const ndarray_shape& index) -> reference
+{
+    return view().at(index);
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::at(const ndarray_shape& index) const -> const_reference
+{
+    return view().at(index);
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::operator[](size_t index) noexcept -> view_type
+{
+    return view()[index];
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::operator[](size_t index) const noexcept -> const_view_type
+{
+    return view()[index];
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::view() noexcept -> view_type
+{
+    return view_type(data_.data(), shape_, strides());
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::view() const noexcept -> const_view_type
+{
+    return const_view_type(data_.data(), shape_, strides());
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::slice(initializer_list<ndarray_slice> slices) -> view_type
+{
+    return view().slice(slices);
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::slice(initializer_list<ndarray_slice> slices) const -> const_view_type
+{
+    return view().slice(slices);
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::slice(size_t axis, const ndarray_slice& slice) -> view_type
+{
+    return view().slice(axis, slice);
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::slice(size_t axis, const ndarray_slice& slice) const -> const_view_type
+{
+    return view().slice(axis, slice);
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::transpose() noexcept -> view_type
+{
+    return view().transpose();
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::transpose() const noexcept -> const_view_type
+{
+    return view().transpose();
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::transpose(const ndarray_shape& axes) -> view_type
+{
+    return view().transpose(axes);
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::transpose(const ndarray_shape& axes) const -> const_view_type
+{
+    return view().transpose(axes);
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::reshape(const ndarray_shape& shape) -> view_type
+{
+    return view().reshape(shape);
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::reshape(const ndarray_shape& shape) const -> const_view_type
+{
+    return view().reshape(shape);
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::broadcast_to(const ndarray_shape& shape) const -> const_view_type
+{
+    return view().broadcast_to(shape);
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::begin() noexcept -> iterator
+{
+    return data_.data();
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::begin() const noexcept -> const_iterator
+{
+    return data_.data();
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::end() noexcept -> iterator
+{
+    return data_.data() + data_.size();
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::end() const noexcept -> const_iterator
+{
+    return data_.data() + data_.size();
+}
+
+
+template <typename T, typename Alloc>
+void ndarray<T, Alloc>::fill(const value_type& value)
+{
+    fill_n(data_.data(), data_.size(), value);
+}
+
+
+/**
+ *  \brief Change the shape, keeping the values in row-major order.
+ *
+ *  New elements are value-initialized.
+ */
+template <typename T, typename Alloc>
+void ndarray<T, Alloc>::resize(const ndarray_shape& shape)
+{
+    data_.resize(ndarray_size(shape));
+    shape_ = shape;
+}
+
+
+template <typename T, typename Alloc>
+void ndarray<T, Alloc>::swap(self_t& other)
+{
+    using PYCPP_NAMESPACE::swap;
+    swap(data_, other.data_);
+    swap(shape_, other.shape_);
+}
+
+
+template <typename T, typename Alloc>
+auto ndarray<T, Alloc>::get_allocator() const -> allocator_type
+{
+    return data_.get_allocator();
+}
+
+
+template <typename T, typename Alloc>
+template <typename U>
+auto ndarray<T, Alloc>::operator+=(const U& other) -> self_t&
+{
+    const auto& operand = ndarray_detail::promote<T>(other);
+    ndarray_detail::binary_apply(ndarray_add, view(), const_view_type(view()), ndarray_detail::to_view(operand));
+    return *this;
+}
+
+
+template <typename T, typename Alloc>
+template <typename U>
+auto ndarray<T, Alloc>::operator-=(const U& other) -> self_t&
+{
+    const auto& operand = ndarray_detail::promote<T>(other);
+    ndarray_detail::binary_apply(ndarray_subtract, view(), const_view_type(view()), ndarray_detail::to_view(operand));
+    return *this;
+}
+
+
+template <typename T, typename Alloc>
+template <typename U>
+auto ndarray<T, Alloc>::operator*=(const U& other) -> self_t&
+{
+    const auto& operand = ndarray_detail::promote<T>(other);
+    ndarray_detail::binary_apply(ndarray_multiply, view(), const_view_type(view()), ndarray_detail::to_view(operand));
+    return *this;
+}
+
+
+template <typename T, typename Alloc>
+template <typename U>
+auto ndarray<T, Alloc>::operator/=(const U& other) -> self_t&
+{
+    const auto& operand = ndarray_detail::promote<T>(other);
+    ndarray_detail::binary_apply(ndarray_divide, view(), const_view_type(view()), ndarray_detail::to_view(operand));
+    return *this;
+}
+
+// OPERATORS
+// ---------
+
+
+template <typename X, typename Y, enable_if_t<ndarray_detail::is_binary_operand<X, Y>::value, int> = 0>
+ndarray_detail::result_t<X, Y> operator+(const X& x, const Y& y)
+{
+    return ndarray_detail::binary(ndarray_add, x, y);
+}
+
+
+template <typename X, typename Y, enable_if_t<ndarray_detail::is_binary_operand<X, Y>::value, int> = 0>
+ndarray_detail::result_t<X, Y> operator-(const X& x, const Y& y)
+{
+    return ndarray_detail::binary(ndarray_subtract, x, y);
+}
+
+
+template <typename X, typename Y, enable_if_t<ndarray_detail::is_binary_operand<X, Y>::value, int> = 0>
+ndarray_detail::result_t<X, Y> operator*(const X& x, const Y& y)
+{
+    return ndarray_detail::binary(ndarray_multiply, x, y);
+}
+
+
+template <typename X, typename Y, enable_if_t<ndarray_detail::is_binary_operand<X, Y>::value, int> = 0>
+ndarray_detail::result_t<X, Y> operator/(const X& x, const Y& y)
+{
+    return ndarray_detail::binary(ndarray_divide, x, y);
+}
+
+
+template <typename T, typename Alloc>
+void swap(ndarray<T, Alloc>& x, ndarray<T, Alloc>& y)
+{
+    x.swap(y);
+}
+
+// REDUCTIONS
+// ----------
+
+
+/**
+ *  \brief Sum of all elements.
+ */
+template <typename X, enable_if_t<ndarray_detail::is_array_operand<X>::value, int> = 0>
+ndarray_detail::operand_value_t<X> sum(const X& x)
+{
+    using value_type = ndarray_detail::operand_value_t<X>;
+    value_type total = value_type();
+    ndarray_detail::unary_apply(ndarray_detail::to_view(x), [&](const value_type* data, ptrdiff_t stride, size_t n) {
+        total += ndarray_sum(data, stride, n);
+    });
+    return total;
+}
+
+
+/**
+ *  \brief Sum of the elements along `axis`, which is removed from the shape.
+ */
+template <typename X, enable_if_t<ndarray_detail::is_array_operand<X>::value, int> = 0>
+ndarray<ndarray_detail::operand_value_t<X>> sum(const X& x, size_t axis)
+{
+    using value_type = ndarray_detail::operand_value_t<X>;
+    ndarray_view<const value_type> xv = ndarray_detail::to_view(x);
+    if (axis >= xv.ndim()) {
+        throw out_of_range("ndarray::sum(): axis out of range.");
+    }
+
+    ndarray_shape shape = xv.shape();
+    shape.erase(axis);
+    ndarray<value_type> out(shape);
+
+    // accumulate into the output, broadcast along the reduced axis
+    ndarray_strides out_strides = out.strides();
+    out_strides.insert(axis, 0);
+    ndarray_view<value_type> accumulator(out.data(), xv.shape(), out_strides);
+    array<char*, 2> data = {{
+        reinterpret_cast<char*>(out.data()),
+        reinterpret_cast<char*>(const_cast<value_type*>(xv.data())),
+    }};
+    array<ndarray_strides, 2> strides = {{
+        ndarray_detail::byte_strides(accumulator),
+        ndarray_detail::byte_strides(xv),
+    }};
+    ndarray_detail::strided_apply<2>(xv.shape(), data, strides, [](char** ptr, const ptrdiff_t* step, size_t n) {
+        value_type* o = reinterpret_cast<value_type*>(ptr[0]);
+        const value_type* i = reinterpret_cast<const value_type*>(ptr[1]);
+        ptrdiff_t os = step[0] / static_cast<ptrdiff_t>(sizeof(value_type));
+        ptrdiff_t is = step[1] / static_cast<ptrdiff_t>(sizeof(value_type));
+        if (os == 0) {
+            *o += ndarray_sum(i, is, n);
+        } else {
+            ndarray_binary(ndarray_add, o, os, static_cast<const value_type*>(o), os, i, is, n);
+        }
+    });
+
+    return out;
+}
+
+
+/**
+ *  \brief Arithmetic mean of all elements.
+ */
+template <typename X, enable_if_t<ndarray_detail::is_array_operand<X>::value, int> = 0>
+double mean(const X& x)
+{
+    ndarray_view<const ndarray_detail::operand_value_t<X>> xv = ndarray_detail::to_view(x);
+    return static_cast<double>(sum(xv)) / static_cast<double>(xv.size());
+}
+
+
+/**
+ *  \brief Smallest element, throwing `invalid_argument` if empty.
+ */
+template <typename X, enable_if_t<ndarray_detail::is_array_operand<X>::value, int> = 0>
+ndarray_detail::operand_value_t<X> amin(const X& x)
+{
+    using value_type = ndarray_detail::operand_value_t<X>;
+    return ndarray_detail::extremum(ndarray_detail::to_view(x), less<value_type>(), "ndarray::amin(): empty array.");
+}
+
+
+/**
+ *  \brief Largest element, throwing `invalid_argument` if empty.
+ */
+template <typename X, enable_if_t<ndarray_detail::is_array_operand<X>::value, int> = 0>
+ndarray_detail::operand_value_t<X> amax(const X& x)
+{
+    using value_type = ndarray_detail::operand_value_t<X>;
+    return ndarray_detail::extremum(ndarray_detail::to_view(x), greater<value_type>(), "ndarray::amax(): empty array.");
+}
+
+PYCPP_END_NAMESPACE
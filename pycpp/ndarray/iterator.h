@@ -0,0 +1,164 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Iterator over the elements of a strided N-dimensional view.
+ *
+ *  Visits elements in row-major (C) order of the logical indexes,
+ *  regardless of the strides of the view, so iterating over a
+ *  transposed view yields the transpose. Elementwise operations use
+ *  `ndarray_detail::strided_apply` instead, which walks whole runs.
+ *
+ *  \synopsis
+ *      template <typename T>
+ *      struct ndarray_iterator
+ *      {
+ *          using value_type = remove_const_t<T>;
+ *          using reference = T&;
+ *          using pointer = T*;
+ *          using difference_type = ptrdiff_t;
+ *          using iterator_category = forward_iterator_tag;
+ *
+ *          ndarray_iterator() noexcept;
+ *          ndarray_iterator(T* data, const ndarray_shape& shape, const ndarray_strides& strides, size_t position = 0) noexcept;
+ *
+ *          bool operator==(const ndarray_iterator&) const noexcept;
+ *          bool operator!=(const ndarray_iterator&) const noexcept;
+ *          ndarray_iterator& operator++() noexcept;
+ *          ndarray_iterator operator++(int) noexcept;
+ *          reference operator*() const noexcept;
+ *          pointer operator->() const noexcept;
+ *          const ndarray_shape& index() const noexcept;
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/ndarray/shape.h>
+#include <pycpp/stl/iterator.h>
+#include <pycpp/stl/type_traits.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Forward iterator over a strided view.
+ */
+template <typename T>
+struct ndarray_iterator: iterator<forward_iterator_tag, remove_const_t<T>, ptrdiff_t, T*, T&>
+{
+    // MEMBER TYPES
+    // ------------
+    using self_t = ndarray_iterator<T>;
+    using value_type = remove_const_t<T>;
+    using reference = T&;
+    using pointer = T*;
+    using difference_type = ptrdiff_t;
+
+    // MEMBER FUNCTIONS
+    // ----------------
+    ndarray_iterator() noexcept = default;
+    ndarray_iterator(T* data, const ndarray_shape& shape, const ndarray_strides& strides, size_t position = 0) noexcept;
+
+    // RELATIONAL OPERATORS
+    bool operator==(const self_t&) const noexcept;
+    bool operator!=(const self_t&) const noexcept;
+
+    // INCREMENTORS
+    self_t& operator++() noexcept;
+    self_t operator++(int) noexcept;
+
+    // DEREFERENCE
+    reference operator*() const noexcept;
+    pointer operator->() const noexcept;
+
+    // PROPERTIES
+    const ndarray_shape& index() const noexcept;
+
+private:
+    T* data_ = nullptr;
+    ndarray_shape shape_;
+    ndarray_strides strides_;
+    ndarray_shape index_;
+    size_t position_ = 0;
+};
+
+// IMPLEMENTATION
+// --------------
+
+
+template <typename T>
+ndarray_iterator<T>::ndarray_iterator(T* data, const ndarray_shape& shape, const ndarray_strides& strides, size_t position) noexcept:
+    data_(data),
+    shape_(shape),
+    strides_(strides),
+    position_(position)
+{
+    for (size_t i = 0; i < shape.size(); ++i) {
+        index_.push_back(0);
+    }
+}
+
+
+template <typename T>
+bool ndarray_iterator<T>::operator==(const self_t& rhs) const noexcept
+{
+    return position_ == rhs.position_;
+}
+
+
+template <typename T>
+bool ndarray_iterator<T>::operator!=(const self_t& rhs) const noexcept
+{
+    return position_ != rhs.position_;
+}
+
+
+template <typename T>
+auto ndarray_iterator<T>::operator++() noexcept -> self_t&
+{
+    ++position_;
+    for (size_t axis = shape_.size(); axis-- > 0; ) {
+        if (++index_[axis] < shape_[axis]) {
+            data_ += strides_[axis];
+            return *this;
+        }
+        data_ -= strides_[axis] * static_cast<ptrdiff_t>(index_[axis] - 1);
+        index_[axis] = 0;
+    }
+    return *this;
+}
+
+
+template <typename T>
+auto ndarray_iterator<T>::operator++(int) noexcept -> self_t
+{
+    self_t copy(*this);
+    operator++();
+    return copy;
+}
+
+
+template <typename T>
+auto ndarray_iterator<T>::operator*() const noexcept -> reference
+{
+    return *data_;
+}
+
+
+template <typename T>
+auto ndarray_iterator<T>::operator->() const noexcept -> pointer
+{
+    return data_;
+}
+
+
+template <typename T>
+const ndarray_shape& ndarray_iterator<T>::index() const noexcept
+{
+    return index_;
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,377 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/ndarray/kernel.h>
+#include <pycpp/runtime/cpu.h>
+#if defined(HAVE_X86_SIMD)
+#   include <immintrin.h>
+#endif
+
+PYCPP_BEGIN_NAMESPACE
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Contiguous run, with inputs that are contiguous or a broadcast scalar.
+ */
+template <typename T>
+using binary_kernel = void (*)(T* out, const T* x, ptrdiff_t xs, const T* y, ptrdiff_t ys, size_t n);
+
+template <typename T>
+using sum_kernel = T (*)(const T* x, size_t n);
+
+
+struct ndarray_kernels
+{
+    binary_kernel<float> binary_float[4];
+    binary_kernel<double> binary_double[4];
+    sum_kernel<float> sum_float;
+    sum_kernel<double> sum_double;
+};
+
+// HELPERS
+// -------
+
+// SCALAR
+
+
+template <typename Op, typename T>
+static void binary_scalar(T* out, const T* x, ptrdiff_t xs, const T* y, ptrdiff_t ys, size_t n)
+{
+    ndarray_detail::binary_loop<Op>(out, 1, x, xs, y, ys, n);
+}
+
+
+template <typename T>
+static T sum_scalar(const T* x, size_t n)
+{
+    return ndarray_sum<T>(x, 1, n);
+}
+
+
+#if defined(HAVE_X86_SIMD)              // HAVE_X86_SIMD
+
+// SSE2
+
+struct sse2_float
+{
+    using value_type = float;
+    using vector_type = __m128;
+    static constexpr size_t width = 4;
+
+    SIMD_TARGET("sse2") static vector_type load(const float* p) { return _mm_loadu_ps(p); }
+    SIMD_TARGET("sse2") static void store(float* p, vector_type v) { _mm_storeu_ps(p, v); }
+    SIMD_TARGET("sse2") static vector_type set1(float v) { return _mm_set1_ps(v); }
+    SIMD_TARGET("sse2") static vector_type zero() { return _mm_setzero_ps(); }
+    SIMD_TARGET("sse2") static vector_type apply(ndarray_detail::add_op, vector_type a, vector_type b) { return _mm_add_ps(a, b); }
+    SIMD_TARGET("sse2") static vector_type apply(ndarray_detail::subtract_op, vector_type a, vector_type b) { return _mm_sub_ps(a, b); }
+    SIMD_TARGET("sse2") static vector_type apply(ndarray_detail::multiply_op, vector_type a, vector_type b) { return _mm_mul_ps(a, b); }
+    SIMD_TARGET("sse2") static vector_type apply(ndarray_detail::divide_op, vector_type a, vector_type b) { return _mm_div_ps(a, b); }
+
+    SIMD_TARGET("sse2") static float hsum(vector_type v)
+    {
+        v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+        v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+        return _mm_cvtss_f32(v);
+    }
+};
+
+
+struct sse2_double
+{
+    using value_type = double;
+    using vector_type = __m128d;
+    static constexpr size_t width = 2;
+
+    SIMD_TARGET("sse2") static vector_type load(const double* p) { return _mm_loadu_pd(p); }
+    SIMD_TARGET("sse2") static void store(double* p, vector_type v) { _mm_storeu_pd(p, v); }
+    SIMD_TARGET("sse2") static vector_type set1(double v) { return _mm_set1_pd(v); }
+    SIMD_TARGET("sse2") static vector_type zero() { return _mm_setzero_pd(); }
+    SIMD_TARGET("sse2") static vector_type apply(ndarray_detail::add_op, vector_type a, vector_type b) { return _mm_add_pd(a, b); }
+    SIMD_TARGET("sse2") static vector_type apply(ndarray_detail::subtract_op, vector_type a, vector_type b) { return _mm_sub_pd(a, b); }
+    SIMD_TARGET("sse2") static vector_type apply(ndarray_detail::multiply_op, vector_type a, vector_type b) { return _mm_mul_pd(a, b); }
+    SIMD_TARGET("sse2") static vector_type apply(ndarray_detail::divide_op, vector_type a, vector_type b) { return _mm_div_pd(a, b); }
+
+    SIMD_TARGET("sse2") static double hsum(vector_type v)
+    {
+        return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+    }
+};
+
+
+template <typename Simd, typename Op>
+SIMD_TARGET("sse2")
+static void binary_sse2(typename Simd::value_type* out, const typename Simd::value_type* x, ptrdiff_t xs, const typename Simd::value_type* y, ptrdiff_t ys, size_t n)
+{
+    using vector_type = typename Simd::vector_type;
+    constexpr size_t width = Simd::width;
+
+    Op op;
+    size_t i = 0;
+    if (xs && ys) {
+        for (; i + width <= n; i += width) {
+            Simd::store(out + i, Simd::apply(op, Simd::load(x + i), Simd::load(y + i)));
+        }
+    } else if (xs) {
+        vector_type b = Simd::set1(*y);
+        for (; i + width <= n; i += width) {
+            Simd::store(out + i, Simd::apply(op, Simd::load(x + i), b));
+        }
+    } else if (ys) {
+        vector_type a = Simd::set1(*x);
+        for (; i + width <= n; i += width) {
+            Simd::store(out + i, Simd::apply(op, a, Simd::load(y + i)));
+        }
+    }
+    ndarray_detail::binary_loop<Op>(out + i, 1, x + i * xs, xs, y + i * ys, ys, n - i);
+}
+
+
+template <typename Simd>
+SIMD_TARGET("sse2")
+static typename Simd::value_type sum_sse2(const typename Simd::value_type* x, size_t n)
+{
+    using vector_type = typename Simd::vector_type;
+    constexpr size_t width = Simd::width;
+
+    // independent accumulators hide the latency of the additions
+    ndarray_detail::add_op add;
+    vector_type s0 = Simd::zero();
+    vector_type s1 = Simd::zero();
+    vector_type s2 = Simd::zero();
+    vector_type s3 = Simd::zero();
+    size_t i = 0;
+    for (; i + 4 * width <= n; i += 4 * width) {
+        s0 = Simd::apply(add, s0, Simd::load(x + i));
+        s1 = Simd::apply(add, s1, Simd::load(x + i + width));
+        s2 = Simd::apply(add, s2, Simd::load(x + i + 2 * width));
+        s3 = Simd::apply(add, s3, Simd::load(x + i + 3 * width));
+    }
+    vector_type s = Simd::apply(add, Simd::apply(add, s0, s1), Simd::apply(add, s2, s3));
+    return Simd::hsum(s) + sum_scalar(x + i, n - i);
+}
+
+// AVX
+
+struct avx_float
+{
+    using value_type = float;
+    using vector_type = __m256;
+    static constexpr size_t width = 8;
+
+    SIMD_TARGET("avx") static vector_type load(const float* p) { return _mm256_loadu_ps(p); }
+    SIMD_TARGET("avx") static void store(float* p, vector_type v) { _mm256_storeu_ps(p, v); }
+    SIMD_TARGET("avx") static vector_type set1(float v) { return _mm256_set1_ps(v); }
+    SIMD_TARGET("avx") static vector_type zero() { return _mm256_setzero_ps(); }
+    SIMD_TARGET("avx") static vector_type apply(ndarray_detail::add_op, vector_type a, vector_type b) { return _mm256_add_ps(a, b); }
+    SIMD_TARGET("avx") static vector_type apply(ndarray_detail::subtract_op, vector_type a, vector_type b) { return _mm256_sub_ps(a, b); }
+    SIMD_TARGET("avx") static vector_type apply(ndarray_detail::multiply_op, vector_type a, vector_type b) { return _mm256_mul_ps(a, b); }
+    SIMD_TARGET("avx") static vector_type apply(ndarray_detail::divide_op, vector_type a, vector_type b) { return _mm256_div_ps(a, b); }
+
+    SIMD_TARGET("avx") static float hsum(vector_type v)
+    {
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+        return _mm_cvtss_f32(s);
+    }
+};
+
+
+struct avx_double
+{
+    using value_type = double;
+    using vector_type = __m256d;
+    static constexpr size_t width = 4;
+
+    SIMD_TARGET("avx") static vector_type load(const double* p) { return _mm256_loadu_pd(p); }
+    SIMD_TARGET("avx") static void store(double* p, vector_type v) { _mm256_storeu_pd(p, v); }
+    SIMD_TARGET("avx") static vector_type set1(double v) { return _mm256_set1_pd(v); }
+    SIMD_TARGET("avx") static vector_type zero() { return _mm256_setzero_pd(); }
+    SIMD_TARGET("avx") static vector_type apply(ndarray_detail::add_op, vector_type a, vector_type b) { return _mm256_add_pd(a, b); }
+    SIMD_TARGET("avx") static vector_type apply(ndarray_detail::subtract_op, vector_type a, vector_type b) { return _mm256_sub_pd(a, b); }
+    SIMD_TARGET("avx") static vector_type apply(ndarray_detail::multiply_op, vector_type a, vector_type b) { return _mm256_mul_pd(a, b); }
+    SIMD_TARGET("avx") static vector_type apply(ndarray_detail::divide_op, vector_type a, vector_type b) { return _mm256_div_pd(a, b); }
+
+    SIMD_TARGET("avx") static double hsum(vector_type v)
+    {
+        __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+};
+
+
+template <typename Simd, typename Op>
+SIMD_TARGET("avx")
+static void binary_avx(typename Simd::value_type* out, const typename Simd::value_type* x, ptrdiff_t xs, const typename Simd::value_type* y, ptrdiff_t ys, size_t n)
+{
+    using vector_type = typename Simd::vector_type;
+    constexpr size_t width = Simd::width;
+
+    Op op;
+    size_t i = 0;
+    if (xs && ys) {
+        for (; i + width <= n; i += width) {
+            Simd::store(out + i, Simd::apply(op, Simd::load(x + i), Simd::load(y + i)));
+        }
+    } else if (xs) {
+        vector_type b = Simd::set1(*y);
+        for (; i + width <= n; i += width) {
+            Simd::store(out + i, Simd::apply(op, Simd::load(x + i), b));
+        }
+    } else if (ys) {
+        vector_type a = Simd::set1(*x);
+        for (; i + width <= n; i += width) {
+            Simd::store(out + i, Simd::apply(op, a, Simd::load(y + i)));
+        }
+    }
+    ndarray_detail::binary_loop<Op>(out + i, 1, x + i * xs, xs, y + i * ys, ys, n - i);
+}
+
+
+template <typename Simd>
+SIMD_TARGET("avx")
+static typename Simd::value_type sum_avx(const typename Simd::value_type* x, size_t n)
+{
+    using vector_type = typename Simd::vector_type;
+    constexpr size_t width = Simd::width;
+
+    // independent accumulators hide the latency of the additions
+    ndarray_detail::add_op add;
+    vector_type s0 = Simd::zero();
+    vector_type s1 = Simd::zero();
+    vector_type s2 = Simd::zero();
+    vector_type s3 = Simd::zero();
+    size_t i = 0;
+    for (; i + 4 * width <= n; i += 4 * width) {
+        s0 = Simd::apply(add, s0, Simd::load(x + i));
+        s1 = Simd::apply(add, s1, Simd::load(x + i + width));
+        s2 = Simd::apply(add, s2, Simd::load(x + i + 2 * width));
+        s3 = Simd::apply(add, s3, Simd::load(x + i + 3 * width));
+    }
+    vector_type s = Simd::apply(add, Simd::apply(add, s0, s1), Simd::apply(add, s2, s3));
+    return Simd::hsum(s) + sum_scalar(x + i, n - i);
+}
+
+#endif                                  // HAVE_X86_SIMD
+
+
+static ndarray_kernels select_ndarray_kernels()
+{
+    using namespace ndarray_detail;
+
+#if defined(HAVE_X86_SIMD)
+    if (cpu_supports(cpu_avx)) {
+        return {
+            {
+                binary_avx<avx_float, add_op>,
+                binary_avx<avx_float, subtract_op>,
+                binary_avx<avx_float, multiply_op>,
+                binary_avx<avx_float, divide_op>,
+            },
+            {
+                binary_avx<avx_double, add_op>,
+                binary_avx<avx_double, subtract_op>,
+                binary_avx<avx_double, multiply_op>,
+                binary_avx<avx_double, divide_op>,
+            },
+            sum_avx<avx_float>,
+            sum_avx<avx_double>,
+        };
+    } else if (cpu_supports(cpu_sse2)) {
+        return {
+            {
+                binary_sse2<sse2_float, add_op>,
+                binary_sse2<sse2_float, subtract_op>,
+                binary_sse2<sse2_float, multiply_op>,
+                binary_sse2<sse2_float, divide_op>,
+            },
+            {
+                binary_sse2<sse2_double, add_op>,
+                binary_sse2<sse2_double, subtract_op>,
+                binary_sse2<sse2_double, multiply_op>,
+                binary_sse2<sse2_double, divide_op>,
+            },
+            sum_sse2<sse2_float>,
+            sum_sse2<sse2_double>,
+        };
+    }
+#endif
+
+    return {
+        {
+            binary_scalar<add_op, float>,
+            binary_scalar<subtract_op, float>,
+            binary_scalar<multiply_op, float>,
+            binary_scalar<divide_op, float>,
+        },
+        {
+            binary_scalar<add_op, double>,
+            binary_scalar<subtract_op, double>,
+            binary_scalar<multiply_op, double>,
+            binary_scalar<divide_op, double>,
+        },
+        sum_scalar<float>,
+        sum_scalar<double>,
+    };
+}
+
+
+static const ndarray_kernels& get_ndarray_kernels()
+{
+    static const ndarray_kernels kernels = select_ndarray_kernels();
+    return kernels;
+}
+
+
+/**
+ *  \brief Whether a run can use the contiguous kernels.
+ */
+static bool is_vectorizable(ptrdiff_t os, ptrdiff_t xs, ptrdiff_t ys)
+{
+    return os == 1 && (xs == 0 || xs == 1) && (ys == 0 || ys == 1);
+}
+
+// FUNCTIONS
+// ---------
+
+
+void ndarray_binary(ndarray_op op, float* out, ptrdiff_t os, const float* x, ptrdiff_t xs, const float* y, ptrdiff_t ys, size_t n) noexcept
+{
+    if (is_vectorizable(os, xs, ys)) {
+        get_ndarray_kernels().binary_float[op](out, x, xs, y, ys, n);
+    } else {
+        ndarray_binary<float, float, float>(op, out, os, x, xs, y, ys, n);
+    }
+}
+
+
+void ndarray_binary(ndarray_op op, double* out, ptrdiff_t os, const double* x, ptrdiff_t xs, const double* y, ptrdiff_t ys, size_t n) noexcept
+{
+    if (is_vectorizable(os, xs, ys)) {
+        get_ndarray_kernels().binary_double[op](out, x, xs, y, ys, n);
+    } else {
+        ndarray_binary<double, double, double>(op, out, os, x, xs, y, ys, n);
+    }
+}
+
+
+float ndarray_sum(const float* x, ptrdiff_t xs, size_t n) noexcept
+{
+    if (xs == 1) {
+        return get_ndarray_kernels().sum_float(x, n);
+    }
+    return ndarray_sum<float>(x, xs, n);
+}
+
+
+double ndarray_sum(const double* x, ptrdiff_t xs, size_t n) noexcept
+{
+    if (xs == 1) {
+        return get_ndarray_kernels().sum_double(x, n);
+    }
+    return ndarray_sum<double>(x, xs, n);
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,167 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Elementwise and reduction kernels for N-dimensional arrays.
+ *
+ *  Each kernel processes a single run of `n` elements, with a stride
+ *  (in elements) per operand. Runs of `float` and `double` whose
+ *  output is contiguous, and whose inputs are contiguous or
+ *  broadcast scalars (stride 0), use SSE2 or AVX, selected at
+ *  runtime. Other types and strides use scalar loops, which the
+ *  compiler may vectorize on its own.
+ *
+ *  \synopsis
+ *      enum ndarray_op
+ *      {
+ *          ndarray_add = 0,
+ *          ndarray_subtract,
+ *          ndarray_multiply,
+ *          ndarray_divide,
+ *      };
+ *
+ *      template <typename T, typename U, typename V>
+ *      void ndarray_binary(ndarray_op op, T* out, ptrdiff_t os, const U* x, ptrdiff_t xs, const V* y, ptrdiff_t ys, size_t n);
+ *      void ndarray_binary(ndarray_op op, float* out, ptrdiff_t os, const float* x, ptrdiff_t xs, const float* y, ptrdiff_t ys, size_t n) noexcept;
+ *      void ndarray_binary(ndarray_op op, double* out, ptrdiff_t os, const double* x, ptrdiff_t xs, const double* y, ptrdiff_t ys, size_t n) noexcept;
+ *
+ *      template <typename T>
+ *      T ndarray_sum(const T* x, ptrdiff_t xs, size_t n);
+ *      float ndarray_sum(const float* x, ptrdiff_t xs, size_t n) noexcept;
+ *      double ndarray_sum(const double* x, ptrdiff_t xs, size_t n) noexcept;
+ */
+
+#pragma once
+
+#include <pycpp/config.h>
+#include <stddef.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// ENUMS
+// -----
+
+/**
+ *  \brief Arithmetic operation for an elementwise kernel.
+ */
+enum ndarray_op
+{
+    ndarray_add = 0,
+    ndarray_subtract,
+    ndarray_multiply,
+    ndarray_divide,
+};
+
+// DETAIL
+// ------
+
+namespace ndarray_detail
+{
+
+struct add_op
+{
+    template <typename T, typename U>
+    auto operator()(const T& x, const U& y) const -> decltype(x + y)
+    {
+        return x + y;
+    }
+};
+
+
+struct subtract_op
+{
+    template <typename T, typename U>
+    auto operator()(const T& x, const U& y) const -> decltype(x - y)
+    {
+        return x - y;
+    }
+};
+
+
+struct multiply_op
+{
+    template <typename T, typename U>
+    auto operator()(const T& x, const U& y) const -> decltype(x * y)
+    {
+        return x * y;
+    }
+};
+
+
+struct divide_op
+{
+    template <typename T, typename U>
+    auto operator()(const T& x, const U& y) const -> decltype(x / y)
+    {
+        return x / y;
+    }
+};
+
+
+template <typename Op, typename T, typename U, typename V>
+void binary_loop(T* out, ptrdiff_t os, const U* x, ptrdiff_t xs, const V* y, ptrdiff_t ys, size_t n)
+{
+    Op op;
+    if (os == 1 && xs == 1 && ys == 1) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = static_cast<T>(op(x[i], y[i]));
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            ptrdiff_t j = static_cast<ptrdiff_t>(i);
+            out[j * os] = static_cast<T>(op(x[j * xs], y[j * ys]));
+        }
+    }
+}
+
+}   /* ndarray_detail */
+
+// FUNCTIONS
+// ---------
+
+/**
+ *  \brief Compute `out[i] = x[i] op y[i]` over a strided run.
+ */
+template <typename T, typename U, typename V>
+void ndarray_binary(ndarray_op op, T* out, ptrdiff_t os, const U* x, ptrdiff_t xs, const V* y, ptrdiff_t ys, size_t n)
+{
+    using namespace ndarray_detail;
+    switch (op) {
+        case ndarray_add:
+            binary_loop<add_op>(out, os, x, xs, y, ys, n);
+            break;
+        case ndarray_subtract:
+            binary_loop<subtract_op>(out, os, x, xs, y, ys, n);
+            break;
+        case ndarray_multiply:
+            binary_loop<multiply_op>(out, os, x, xs, y, ys, n);
+            break;
+        case ndarray_divide:
+            binary_loop<divide_op>(out, os, x, xs, y, ys, n);
+            break;
+    }
+}
+
+
+void ndarray_binary(ndarray_op op, float* out, ptrdiff_t os, const float* x, ptrdiff_t xs, const float* y, ptrdiff_t ys, size_t n) noexcept;
+void ndarray_binary(ndarray_op op, double* out, ptrdiff_t os, const double* x, ptrdiff_t xs, const double* y, ptrdiff_t ys, size_t n) noexcept;
+
+
+/**
+ *  \brief Sum a strided run of values.
+ */
+template <typename T>
+T ndarray_sum(const T* x, ptrdiff_t xs, size_t n)
+{
+    T sum = T();
+    for (size_t i = 0; i < n; ++i) {
+        sum += x[static_cast<ptrdiff_t>(i) * xs];
+    }
+    return sum;
+}
+
+
+float ndarray_sum(const float* x, ptrdiff_t xs, size_t n) noexcept;
+double ndarray_sum(const double* x, ptrdiff_t xs, size_t n) noexcept;
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,414 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Shapes, strides and slices for N-dimensional arrays.
+ *
+ *  Shapes and strides are stored inline, up to `NDARRAY_MAX_DIMS`
+ *  dimensions, so creating views never allocates. Strides are in
+ *  elements, not bytes, and may be negative (reversed slices) or
+ *  zero (broadcast dimensions).
+ *
+ *  \synopsis
+ *      static constexpr size_t NDARRAY_MAX_DIMS = 8;
+ *      static constexpr ptrdiff_t NDARRAY_NONE = PTRDIFF_MAX;
+ *
+ *      template <typename T>
+ *      class ndarray_extents
+ *      {
+ *      public:
+ *          ndarray_extents() noexcept;
+ *          ndarray_extents(initializer_list<T> list);
+ *          template <typename Iter> ndarray_extents(Iter first, Iter last);
+ *
+ *          size_t size() const noexcept;
+ *          bool empty() const noexcept;
+ *          T& operator[](size_t axis) noexcept;
+ *          const T& operator[](size_t axis) const noexcept;
+ *          T* begin() noexcept;
+ *          const T* begin() const noexcept;
+ *          T* end() noexcept;
+ *          const T* end() const noexcept;
+ *
+ *          void push_back(T value);
+ *          void insert(size_t axis, T value);
+ *          void erase(size_t axis) noexcept;
+ *      };
+ *
+ *      using ndarray_shape = ndarray_extents<size_t>;
+ *      using ndarray_strides = ndarray_extents<ptrdiff_t>;
+ *
+ *      struct ndarray_slice
+ *      {
+ *          ndarray_slice(ptrdiff_t start = NDARRAY_NONE, ptrdiff_t stop = NDARRAY_NONE, ptrdiff_t step = 1);
+ *          ptrdiff_t start;
+ *          ptrdiff_t stop;
+ *          ptrdiff_t step;
+ *      };
+ *
+ *      size_t ndarray_size(const ndarray_shape& shape) noexcept;
+ *      ndarray_strides ndarray_contiguous_strides(const ndarray_shape& shape);
+ *      ndarray_shape ndarray_broadcast_shape(const ndarray_shape& x, const ndarray_shape& y);
+ */
+
+#pragma once
+
+#include <pycpp/stl/algorithm.h>
+#include <pycpp/stl/array.h>
+#include <pycpp/stl/initializer_list.h>
+#include <pycpp/stl/stdexcept.h>
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// CONSTANTS
+// ---------
+
+static constexpr size_t NDARRAY_MAX_DIMS = 8;
+static constexpr ptrdiff_t NDARRAY_NONE = PTRDIFF_MAX;
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Fixed-capacity list of per-dimension values.
+ */
+template <typename T>
+class ndarray_extents
+{
+public:
+    // MEMBER TYPES
+    // ------------
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // MEMBER FUNCTIONS
+    // ----------------
+    ndarray_extents() noexcept = default;
+    ndarray_extents(initializer_list<T> list);
+    template <typename Iter>
+    ndarray_extents(Iter first, Iter last);
+
+    // PROPERTIES
+    size_t size() const noexcept;
+    bool empty() const noexcept;
+
+    // ELEMENT ACCESS
+    T& operator[](size_t axis) noexcept;
+    const T& operator[](size_t axis) const noexcept;
+    T* begin() noexcept;
+    const T* begin() const noexcept;
+    T* end() noexcept;
+    const T* end() const noexcept;
+
+    // MODIFIERS
+    void push_back(T value);
+    void insert(size_t axis, T value);
+    void erase(size_t axis) noexcept;
+
+    // RELATIONAL OPERATORS
+    bool operator==(const ndarray_extents&) const noexcept;
+    bool operator!=(const ndarray_extents&) const noexcept;
+
+private:
+    size_t size_ = 0;
+    T data_[NDARRAY_MAX_DIMS] = {};
+};
+
+using ndarray_shape = ndarray_extents<size_t>;
+using ndarray_strides = ndarray_extents<ptrdiff_t>;
+
+
+/**
+ *  \brief Python-style slice of a single dimension.
+ *
+ *  Negative `start` and `stop` count from the end of the dimension,
+ *  and a negative `step` walks it backwards, as in `a[start:stop:step]`.
+ *  `NDARRAY_NONE` leaves a bound open, like `None` in Python.
+ */
+struct ndarray_slice
+{
+    ndarray_slice(ptrdiff_t start = NDARRAY_NONE, ptrdiff_t stop = NDARRAY_NONE, ptrdiff_t step = 1) noexcept;
+
+    ptrdiff_t start;
+    ptrdiff_t stop;
+    ptrdiff_t step;
+};
+
+// FUNCTIONS
+// ---------
+
+/**
+ *  \brief Number of elements in an array of `shape`.
+ */
+inline size_t ndarray_size(const ndarray_shape& shape) noexcept
+{
+    size_t size = 1;
+    for (size_t dim: shape) {
+        size *= dim;
+    }
+    return size;
+}
+
+
+/**
+ *  \brief Row-major (C-order) strides for `shape`.
+ */
+inline ndarray_strides ndarray_contiguous_strides(const ndarray_shape& shape)
+{
+    ndarray_strides strides;
+    ptrdiff_t stride = 1;
+    for (size_t i = 0; i < shape.size(); ++i) {
+        strides.push_back(0);
+    }
+    for (size_t i = shape.size(); i-- > 0; ) {
+        strides[i] = stride;
+        stride *= static_cast<ptrdiff_t>(shape[i]);
+    }
+    return strides;
+}
+
+
+/**
+ *  \brief Shape of the result of an operation between `x` and `y`.
+ *
+ *  Shapes are aligned on their last dimension, and each pair of
+ *  dimensions must be equal or one of them must be 1, as in NumPy.
+ */
+inline ndarray_shape ndarray_broadcast_shape(const ndarray_shape& x, const ndarray_shape& y)
+{
+    const ndarray_shape& longer = x.size() >= y.size() ? x : y;
+    const ndarray_shape& shorter = x.size() >= y.size() ? y : x;
+    size_t offset = longer.size() - shorter.size();
+
+    ndarray_shape shape = longer;
+    for (size_t i = 0; i < shorter.size(); ++i) {
+        size_t a = longer[offset + i];
+        size_t b = shorter[i];
+        if (a != b && a != 1 && b != 1) {
+            throw invalid_argument("ndarray: shapes cannot be broadcast together.");
+        }
+        shape[offset + i] = a == 1 ? b : a;
+    }
+    return shape;
+}
+
+// IMPLEMENTATION
+// --------------
+
+namespace ndarray_detail
+{
+// DETAIL
+// ------
+
+/**
+ *  \brief Call `f(data, strides, n)` for each innermost run of elements.
+ *
+ *  `data` holds a pointer to the first element of each of the `N`
+ *  operands, and `strides` their strides, in bytes, which all share
+ *  `shape`. Dimensions of length 1 are dropped, and dimensions that
+ *  are contiguous for every operand are merged, so that the innermost
+ *  run is as long as possible: for contiguous operands, `f` is called
+ *  once for the whole array.
+ */
+template <size_t N, typename Function>
+void strided_apply(const ndarray_shape& shape, array<char*, N> data, const array<ndarray_strides, N>& strides, Function&& f)
+{
+    if (ndarray_size(shape) == 0) {
+        return;
+    }
+
+    // drop unit dimensions, and merge dimensions from the inside out
+    size_t ndim = 0;
+    size_t dims[NDARRAY_MAX_DIMS];
+    ptrdiff_t steps[N][NDARRAY_MAX_DIMS];
+    for (size_t axis = 0; axis < shape.size(); ++axis) {
+        if (shape[axis] == 1) {
+            continue;
+        }
+        bool merge = ndim > 0;
+        for (size_t k = 0; k < N && merge; ++k) {
+            merge = steps[k][ndim - 1] == strides[k][axis] * static_cast<ptrdiff_t>(shape[axis]);
+        }
+        if (merge) {
+            dims[ndim - 1] *= shape[axis];
+            for (size_t k = 0; k < N; ++k) {
+                steps[k][ndim - 1] = strides[k][axis];
+            }
+        } else {
+            dims[ndim] = shape[axis];
+            for (size_t k = 0; k < N; ++k) {
+                steps[k][ndim] = strides[k][axis];
+            }
+            ++ndim;
+        }
+    }
+
+    ptrdiff_t inner[N];
+    size_t length = 1;
+    if (ndim == 0) {
+        fill_n(inner, N, 0);
+    } else {
+        length = dims[ndim - 1];
+        for (size_t k = 0; k < N; ++k) {
+            inner[k] = steps[k][ndim - 1];
+        }
+    }
+
+    // odometer over the outer dimensions
+    size_t index[NDARRAY_MAX_DIMS] = {};
+    size_t outer = 1;
+    for (size_t axis = 0; axis + 1 < ndim; ++axis) {
+        outer *= dims[axis];
+    }
+    for (size_t i = 0; i < outer; ++i) {
+        f(data.data(), inner, length);
+        for (size_t axis = outer > 1 ? ndim - 1 : 0; axis-- > 0; ) {
+            if (++index[axis] < dims[axis]) {
+                for (size_t k = 0; k < N; ++k) {
+                    data[k] += steps[k][axis];
+                }
+                break;
+            }
+            index[axis] = 0;
+            for (size_t k = 0; k < N; ++k) {
+                data[k] -= steps[k][axis] * static_cast<ptrdiff_t>(dims[axis] - 1);
+            }
+        }
+    }
+}
+
+}   /* ndarray_detail */
+
+// EXTENTS
+
+
+template <typename T>
+ndarray_extents<T>::ndarray_extents(initializer_list<T> list):
+    ndarray_extents(list.begin(), list.end())
+{}
+
+
+template <typename T>
+template <typename Iter>
+ndarray_extents<T>::ndarray_extents(Iter first, Iter last)
+{
+    for (; first != last; ++first) {
+        push_back(*first);
+    }
+}
+
+
+template <typename T>
+size_t ndarray_extents<T>::size() const noexcept
+{
+    return size_;
+}
+
+
+template <typename T>
+bool ndarray_extents<T>::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+
+template <typename T>
+T& ndarray_extents<T>::operator[](size_t axis) noexcept
+{
+    assert(axis < size_ && "Axis out of range.");
+    return data_[axis];
+}
+
+
+template <typename T>
+const T& ndarray_extents<T>::operator[](size_t axis) const noexcept
+{
+    assert(axis < size_ && "Axis out of range.");
+    return data_[axis];
+}
+
+
+template <typename T>
+T* ndarray_extents<T>::begin() noexcept
+{
+    return data_;
+}
+
+
+template <typename T>
+const T* ndarray_extents<T>::begin() const noexcept
+{
+    return data_;
+}
+
+
+template <typename T>
+T* ndarray_extents<T>::end() noexcept
+{
+    return data_ + size_;
+}
+
+
+template <typename T>
+const T* ndarray_extents<T>::end() const noexcept
+{
+    return data_ + size_;
+}
+
+
+template <typename T>
+void ndarray_extents<T>::push_back(T value)
+{
+    insert(size_, value);
+}
+
+
+template <typename T>
+void ndarray_extents<T>::insert(size_t axis, T value)
+{
+    if (size_ == NDARRAY_MAX_DIMS) {
+        throw length_error("ndarray: too many dimensions.");
+    }
+    assert(axis <= size_ && "Axis out of range.");
+    copy_backward(data_ + axis, data_ + size_, data_ + size_ + 1);
+    data_[axis] = value;
+    ++size_;
+}
+
+
+template <typename T>
+void ndarray_extents<T>::erase(size_t axis) noexcept
+{
+    assert(axis < size_ && "Axis out of range.");
+    copy(data_ + axis + 1, data_ + size_, data_ + axis);
+    --size_;
+}
+
+
+template <typename T>
+bool ndarray_extents<T>::operator==(const ndarray_extents& rhs) const noexcept
+{
+    return size_ == rhs.size_ && equal(begin(), end(), rhs.begin());
+}
+
+
+template <typename T>
+bool ndarray_extents<T>::operator!=(const ndarray_extents& rhs) const noexcept
+{
+    return !(*this == rhs);
+}
+
+// SLICE
+
+
+inline ndarray_slice::ndarray_slice(ptrdiff_t start, ptrdiff_t stop, ptrdiff_t step) noexcept:
+    start(start),
+    stop(stop),
+    step(step)
+{}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,471 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Non-owning, strided view of an N-dimensional array.
+ *
+ *  A view is a pointer to its first element, a shape, and the strides
+ *  (in elements) of each dimension. Slicing, transposing, reshaping
+ *  and broadcasting return new views of the same data without
+ *  copying, as NumPy does.
+ *
+ *  \synopsis
+ *      template <typename T>
+ *      class ndarray_view
+ *      {
+ *      public:
+ *          using value_type = remove_const_t<T>;
+ *          using reference = T&;
+ *          using pointer = T*;
+ *          using iterator = ndarray_iterator<T>;
+ *
+ *          ndarray_view() noexcept;
+ *          ndarray_view(T* data, const ndarray_shape& shape);
+ *          ndarray_view(T* data, const ndarray_shape& shape, const ndarray_strides& strides) noexcept;
+ *          template <typename U> ndarray_view(const ndarray_view<U>& other) noexcept;
+ *
+ *          pointer data() const noexcept;
+ *          const ndarray_shape& shape() const noexcept;
+ *          const ndarray_strides& strides() const noexcept;
+ *          size_t ndim() const noexcept;
+ *          size_t size() const noexcept;
+ *          bool empty() const noexcept;
+ *          bool is_contiguous() const noexcept;
+ *
+ *          template <typename ... Ts> reference operator()(Ts ... index) const noexcept;
+ *          reference at(const ndarray_shape& index) const;
+ *          ndarray_view operator[](size_t index) const noexcept;
+ *
+ *          ndarray_view slice(initializer_list<ndarray_slice> slices) const;
+ *          ndarray_view slice(size_t axis, const ndarray_slice& slice) const;
+ *          ndarray_view transpose() const noexcept;
+ *          ndarray_view transpose(const ndarray_shape& axes) const;
+ *          ndarray_view reshape(const ndarray_shape& shape) const;
+ *          ndarray_view broadcast_to(const ndarray_shape& shape) const;
+ *
+ *          iterator begin() const noexcept;
+ *          iterator end() const noexcept;
+ *
+ *          void fill(const value_type& value) const;
+ *          template <typename U> void assign(const ndarray_view<U>& other) const;
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/ndarray/iterator.h>
+#include <pycpp/ndarray/shape.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Strided view of an N-dimensional array.
+ */
+template <typename T>
+class ndarray_view
+{
+public:
+    // MEMBER TYPES
+    // ------------
+    using self_t = ndarray_view<T>;
+    using value_type = remove_const_t<T>;
+    using reference = T&;
+    using pointer = T*;
+    using iterator = ndarray_iterator<T>;
+
+    // MEMBER FUNCTIONS
+    // ----------------
+    ndarray_view() noexcept = default;
+    ndarray_view(const self_t&) noexcept = default;
+    self_t& operator=(const self_t&) noexcept = default;
+    ndarray_view(T* data, const ndarray_shape& shape);
+    ndarray_view(T* data, const ndarray_shape& shape, const ndarray_strides& strides) noexcept;
+    template <typename U, enable_if_t<is_convertible<U*, T*>::value, int> = 0>
+    ndarray_view(const ndarray_view<U>& other) noexcept;
+
+    // PROPERTIES
+    pointer data() const noexcept;
+    const ndarray_shape& shape() const noexcept;
+    const ndarray_strides& strides() const noexcept;
+    size_t ndim() const noexcept;
+    size_t size() const noexcept;
+    bool empty() const noexcept;
+    bool is_contiguous() const noexcept;
+
+    // ELEMENT ACCESS
+    template <typename ... Ts>
+    reference operator()(Ts ... index) const noexcept;
+    reference at(const ndarray_shape& index) const;
+    self_t operator[](size_t index) const noexcept;
+
+    // VIEWS
+    self_t slice(initializer_list<ndarray_slice> slices) const;
+    self_t slice(size_t axis, const ndarray_slice& slice) const;
+    self_t transpose() const noexcept;
+    self_t transpose(const ndarray_shape& axes) const;
+    self_t reshape(const ndarray_shape& shape) const;
+    self_t broadcast_to(const ndarray_shape& shape) const;
+
+    // ITERATORS
+    iterator begin() const noexcept;
+    iterator end() const noexcept;
+
+    // MODIFIERS
+    void fill(const value_type& value) const;
+    template <typename U>
+    void assign(const ndarray_view<U>& other) const;
+
+private:
+    template <typename U>
+    friend class ndarray_view;
+
+    T* data_ = nullptr;
+    ndarray_shape shape_;
+    ndarray_strides strides_;
+};
+
+// IMPLEMENTATION
+// --------------
+
+namespace ndarray_detail
+{
+// DETAIL
+// ------
+
+/**
+ *  \brief Strides in bytes, for `strided_apply`.
+ */
+template <typename T>
+ndarray_strides byte_strides(const ndarray_view<T>& view)
+{
+    ndarray_strides strides;
+    for (ptrdiff_t stride: view.strides()) {
+        strides.push_back(stride * static_cast<ptrdiff_t>(sizeof(T)));
+    }
+    return strides;
+}
+
+
+/**
+ *  \brief Offset of the element at `index`, in elements.
+ */
+inline ptrdiff_t view_offset(const ndarray_strides&, size_t) noexcept
+{
+    return 0;
+}
+
+
+template <typename ... Ts>
+ptrdiff_t view_offset(const ndarray_strides& strides, size_t axis, size_t index, Ts ... rest) noexcept
+{
+    return strides[axis] * static_cast<ptrdiff_t>(index) + view_offset(strides, axis + 1, rest...);
+}
+
+}   /* ndarray_detail */
+
+
+template <typename T>
+ndarray_view<T>::ndarray_view(T* data, const ndarray_shape& shape):
+    data_(data),
+    shape_(shape),
+    strides_(ndarray_contiguous_strides(shape))
+{}
+
+
+template <typename T>
+ndarray_view<T>::ndarray_view(T* data, const ndarray_shape& shape, const ndarray_strides& strides) noexcept:
+    data_(data),
+    shape_(shape),
+    strides_(strides)
+{
+    assert(shape.size() == strides.size() && "Shape and strides must have the same length.");
+}
+
+
+template <typename T>
+template <typename U, enable_if_t<is_convertible<U*, T*>::value, int>>
+ndarray_view<T>::ndarray_view(const ndarray_view<U>& other) noexcept:
+    data_(other.data_),
+    shape_(other.shape_),
+    strides_(other.strides_)
+{}
+
+
+template <typename T>
+auto ndarray_view<T>::data() const noexcept -> pointer
+{
+    return data_;
+}
+
+
+template <typename T>
+const ndarray_shape& ndarray_view<T>::shape() const noexcept
+{
+    return shape_;
+}
+
+
+template <typename T>
+const ndarray_strides& ndarray_view<T>::strides() const noexcept
+{
+    return strides_;
+}
+
+
+template <typename T>
+size_t ndarray_view<T>::ndim() const noexcept
+{
+    return shape_.size();
+}
+
+
+template <typename T>
+size_t ndarray_view<T>::size() const noexcept
+{
+    return ndarray_size(shape_);
+}
+
+
+template <typename T>
+bool ndarray_view<T>::empty() const noexcept
+{
+    return size() == 0;
+}
+
+
+template <typename T>
+bool ndarray_view<T>::is_contiguous() const noexcept
+{
+    // strides of unit dimensions are irrelevant
+    ptrdiff_t stride = 1;
+    for (size_t axis = shape_.size(); axis-- > 0; ) {
+        if (shape_[axis] != 1) {
+            if (strides_[axis] != stride) {
+                return false;
+            }
+            stride *= static_cast<ptrdiff_t>(shape_[axis]);
+        }
+    }
+    return true;
+}
+
+
+template <typename T>
+template <typename ... Ts>
+auto ndarray_view<T>::operator()(Ts ... index) const noexcept -> reference
+{
+    assert(sizeof...(Ts) == shape_.size() && "Index must have one value per dimension.");
+    return data_[ndarray_detail::view_offset(strides_, 0, static_cast<size_t>(index)...)];
+}
+
+
+template <typename T>
+auto ndarray_view<T>::at(const ndarray_shape& index) const -> reference
+{
+    if (index.size() != shape_.size()) {
+        throw out_of_range("ndarray::at(): wrong number of indexes.");
+    }
+    ptrdiff_t offset = 0;
+    for (size_t axis = 0; axis < index.size(); ++axis) {
+        if (index[axis] >= shape_[axis]) {
+            throw out_of_range("ndarray::at(): index out of range.");
+        }
+        offset += strides_[axis] * static_cast<ptrdiff_t>(index[axis]);
+    }
+    return data_[offset];
+}
+
+
+template <typename T>
+auto ndarray_view<T>::operator[](size_t index) const noexcept -> self_t
+{
+    assert(!shape_.empty() && index < shape_[0] && "Index out of range.");
+    self_t view(*this);
+    view.data_ += strides_[0] * static_cast<ptrdiff_t>(index);
+    view.shape_.erase(0);
+    view.strides_.erase(0);
+    return view;
+}
+
+
+template <typename T>
+auto ndarray_view<T>::slice(initializer_list<ndarray_slice> slices) const -> self_t
+{
+    if (slices.size() > shape_.size()) {
+        throw out_of_range("ndarray::slice(): too many slices.");
+    }
+    self_t view(*this);
+    size_t axis = 0;
+    for (const ndarray_slice& s: slices) {
+        view = view.slice(axis++, s);
+    }
+    return view;
+}
+
+
+template <typename T>
+auto ndarray_view<T>::slice(size_t axis, const ndarray_slice& s) const -> self_t
+{
+    if (axis >= shape_.size()) {
+        throw out_of_range("ndarray::slice(): axis out of range.");
+    } else if (s.step == 0) {
+        throw invalid_argument("ndarray::slice(): step cannot be zero.");
+    }
+
+    // normalize the bounds as Python's slice.indices() does
+    ptrdiff_t length = static_cast<ptrdiff_t>(shape_[axis]);
+    ptrdiff_t lower = s.step < 0 ? -1 : 0;
+    ptrdiff_t upper = s.step < 0 ? length - 1 : length;
+    auto clamp_bound = [&](ptrdiff_t value, ptrdiff_t fallback) {
+        if (value == NDARRAY_NONE) {
+            return fallback;
+        } else if (value < 0) {
+            return max(value + length, lower);
+        }
+        return min(value, upper);
+    };
+    ptrdiff_t start = clamp_bound(s.start, s.step < 0 ? upper : 0);
+    ptrdiff_t stop = clamp_bound(s.stop, s.step < 0 ? lower : upper);
+
+    ptrdiff_t count = 0;
+    if (s.step > 0 && stop > start) {
+        count = (stop - start + s.step - 1) / s.step;
+    } else if (s.step < 0 && start > stop) {
+        count = (start - stop - s.step - 1) / -s.step;
+    }
+
+    self_t view(*this);
+    if (count > 0) {
+        view.data_ += strides_[axis] * start;
+    }
+    view.shape_[axis] = static_cast<size_t>(count);
+    view.strides_[axis] = strides_[axis] * s.step;
+    return view;
+}
+
+
+template <typename T>
+auto ndarray_view<T>::transpose() const noexcept -> self_t
+{
+    self_t view(*this);
+    reverse(view.shape_.begin(), view.shape_.end());
+    reverse(view.strides_.begin(), view.strides_.end());
+    return view;
+}
+
+
+template <typename T>
+auto ndarray_view<T>::transpose(const ndarray_shape& axes) const -> self_t
+{
+    if (axes.size() != shape_.size()) {
+        throw invalid_argument("ndarray::transpose(): axes do not match the dimensions.");
+    }
+    bool seen[NDARRAY_MAX_DIMS] = {};
+    self_t view(*this);
+    for (size_t i = 0; i < axes.size(); ++i) {
+        size_t axis = axes[i];
+        if (axis >= shape_.size() || seen[axis]) {
+            throw invalid_argument("ndarray::transpose(): axes must be a permutation.");
+        }
+        seen[axis] = true;
+        view.shape_[i] = shape_[axis];
+        view.strides_[i] = strides_[axis];
+    }
+    return view;
+}
+
+
+template <typename T>
+auto ndarray_view<T>::reshape(const ndarray_shape& shape) const -> self_t
+{
+    if (ndarray_size(shape) != size()) {
+        throw invalid_argument("ndarray::reshape(): cannot change the number of elements.");
+    } else if (!is_contiguous()) {
+        throw invalid_argument("ndarray::reshape(): view is not contiguous.");
+    }
+    return self_t(data_, shape);
+}
+
+
+template <typename T>
+auto ndarray_view<T>::broadcast_to(const ndarray_shape& shape) const -> self_t
+{
+    if (shape.size() < shape_.size()) {
+        throw invalid_argument("ndarray::broadcast_to(): too few dimensions.");
+    }
+
+    size_t offset = shape.size() - shape_.size();
+    ndarray_strides strides;
+    for (size_t axis = 0; axis < shape.size(); ++axis) {
+        if (axis < offset) {
+            strides.push_back(0);
+        } else if (shape_[axis - offset] == shape[axis]) {
+            strides.push_back(strides_[axis - offset]);
+        } else if (shape_[axis - offset] == 1) {
+            strides.push_back(0);
+        } else {
+            throw invalid_argument("ndarray::broadcast_to(): shapes cannot be broadcast together.");
+        }
+    }
+    return self_t(data_, shape, strides);
+}
+
+
+template <typename T>
+auto ndarray_view<T>::begin() const noexcept -> iterator
+{
+    return iterator(data_, shape_, strides_, 0);
+}
+
+
+template <typename T>
+auto ndarray_view<T>::end() const noexcept -> iterator
+{
+    return iterator(data_, shape_, strides_, size());
+}
+
+
+template <typename T>
+void ndarray_view<T>::fill(const value_type& value) const
+{
+    array<char*, 1> data = {{reinterpret_cast<char*>(data_)}};
+    array<ndarray_strides, 1> strides = {{ndarray_detail::byte_strides(*this)}};
+    ndarray_detail::strided_apply<1>(shape_, data, strides, [&](char** ptr, const ptrdiff_t* step, size_t n) {
+        T* out = reinterpret_cast<T*>(ptr[0]);
+        ptrdiff_t os = step[0] / static_cast<ptrdiff_t>(sizeof(T));
+        for (size_t i = 0; i < n; ++i) {
+            out[static_cast<ptrdiff_t>(i) * os] = value;
+        }
+    });
+}
+
+
+template <typename T>
+template <typename U>
+void ndarray_view<T>::assign(const ndarray_view<U>& other) const
+{
+    ndarray_view<U> source = other.broadcast_to(shape_);
+    array<char*, 2> data = {{
+        reinterpret_cast<char*>(data_),
+        reinterpret_cast<char*>(const_cast<remove_const_t<U>*>(source.data())),
+    }};
+    array<ndarray_strides, 2> strides = {{
+        ndarray_detail::byte_strides(*this),
+        ndarray_detail::byte_strides(source),
+    }};
+    ndarray_detail::strided_apply<2>(shape_, data, strides, [](char** ptr, const ptrdiff_t* step, size_t n) {
+        T* out = reinterpret_cast<T*>(ptr[0]);
+        const U* in = reinterpret_cast<const U*>(ptr[1]);
+        ptrdiff_t os = step[0] / static_cast<ptrdiff_t>(sizeof(T));
+        ptrdiff_t is = step[1] / static_cast<ptrdiff_t>(sizeof(U));
+        for (size_t i = 0; i < n; ++i) {
+            ptrdiff_t j = static_cast<ptrdiff_t>(i);
+            out[j * os] = static_cast<T>(in[j * is]);
+        }
+    });
+}
+
+PYCPP_END_NAMESPACE
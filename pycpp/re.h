@@ -9,3 +9,4 @@
 
 #include <pycpp/re/match.h>
 #include <pycpp/re/regex.h>
+#include <pycpp/re/set.h>
@@ -2,8 +2,14 @@
 //  :license: MIT, see licenses/mit.md for more details.
 
 #include <pycpp/cache/lru.h>
+#include <pycpp/preprocessor/tls.h>
 #include <pycpp/re/re.h>
 #include <pycpp/re/regex.h>
+#include <pycpp/stl/algorithm.h>
+#include <pycpp/stl/atomic.h>
+#include <pycpp/stl/limits.h>
+#include <pycpp/stl/string_view.h>
+#include <pycpp/stl/type_traits.h>
 
 PYCPP_BEGIN_NAMESPACE
 
@@ -12,28 +18,75 @@ PYCPP_BEGIN_NAMESPACE
 
 #define REGEX_CACHE_SIZE 100
 
+// ALIAS
+// -----
+
+// Compiled regular expressions are keyed by the hash of the pattern,
+// avoiding a copy of the pattern for each lookup. The pattern
+// is stored by the compiled regular expression, so collisions
+// can be detected during lookup.
+using regex_cache = lru_cache<size_t, regexp_t>;
+
+template <typename T>
+using memory_type = aligned_storage_t<sizeof(T), alignof(T)>;
+
 // GLOBALS
 // -------
 
-using regex_cache = lru_cache<string, regexp_t>;
-regex_cache REGEX_CACHE(REGEX_CACHE_SIZE);
+// `regexp_t` holds mutable state for submatch extraction, so
+// compiled objects cannot be shared between threads: use a
+// lazily-initialized cache per thread, which checks the global
+// settings on each access.
+static atomic<size_t> CACHE_SIZE = ATOMIC_VAR_INIT(REGEX_CACHE_SIZE);
+static atomic<size_t> CACHE_GENERATION = ATOMIC_VAR_INIT(0);
+static thread_local_storage bool THREAD_CACHE_INIT = false;
+static thread_local_storage size_t THREAD_CACHE_GENERATION = 0;
+static thread_local_storage memory_type<regex_cache> THREAD_CACHE;
 
 // HELPERS
 // -------
 
 
+/**
+ *  Get the regex cache for the current thread.
+ *
+ *  Resets the cache if it has been purged or resized since
+ *  the last access from the current thread.
+ */
+static regex_cache& get_regex_cache()
+{
+    auto& cache = reinterpret_cast<regex_cache&>(THREAD_CACHE);
+    size_t cache_size = CACHE_SIZE.load();
+    size_t generation = CACHE_GENERATION.load();
+    if (!THREAD_CACHE_INIT) {
+        new (&cache) regex_cache(static_cast<int>(cache_size));
+        THREAD_CACHE_INIT = true;
+        THREAD_CACHE_GENERATION = generation;
+    } else if (THREAD_CACHE_GENERATION != generation || cache.cache_size() != cache_size) {
+        cache = regex_cache(static_cast<int>(cache_size));
+        THREAD_CACHE_GENERATION = generation;
+    }
+
+    return cache;
+}
+
+
 /**
  *  Compile regex if not previously present in the cache.
  */
-static regexp_t& compile(const string_wrapper& view)
+static regexp_t& compile(const string_wrapper& pattern)
 {
-    string pattern(view);
-    auto it = REGEX_CACHE.find(pattern);
-    if (it == REGEX_CACHE.end()) {
-        it = REGEX_CACHE.insert(pattern, regexp_t(pattern)).first;
+    auto& cache = get_regex_cache();
+    size_t key = hash<string_view>()(pattern);
+    auto it = cache.find(key);
+    if (it != cache.end() && (*it).pattern() == pattern) {
+        return *it;
+    } else if (it != cache.end()) {
+        // hash collision, replace the existing pattern
+        cache.erase(key);
     }
 
-    return *it;
+    return *cache.insert(key, regexp_t(pattern)).first;
 }
 
 // FUNCTIONS
@@ -98,7 +151,23 @@ string re_escape(const string_wrapper& str)
 
 void re_purge()
 {
-    REGEX_CACHE.clear();
+    ++CACHE_GENERATION;
+    get_regex_cache();
+}
+
+
+size_t re_cache_size() noexcept
+{
+    return CACHE_SIZE.load();
+}
+
+
+void re_set_cache_size(size_t size) noexcept
+{
+    // an empty cache would evict each pattern as soon as it is
+    // compiled, and the cache stores its size as an `int`
+    size_t max_size = static_cast<size_t>(numeric_limits<int>::max());
+    CACHE_SIZE.store(max<size_t>(1, min(size, max_size)));
 }
 
 
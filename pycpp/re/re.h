@@ -4,11 +4,16 @@
  *  \addtogroup PyCPP
  *  \brief High-level regular expression methods.
  *
- *  \warning These global functions are not rentrant, since they
- *  rely on a global cache to store compiled regex objects,
- *  storing the last N (typically 100) compiled regular expression
- *  objects. If you need thread safety, you should instantiate a
- *  separate `regexp_t` object per thread.
+ *  These global functions rely on a cache to store compiled regex
+ *  objects, storing the last N (by default, 100) compiled regular
+ *  expression objects, keyed by the hash of the pattern. Each thread
+ *  lazily creates its own cache, so these functions may be called
+ *  concurrently from multiple threads. The cache size is shared
+ *  between all threads, and may be changed via `re_set_cache_size`.
+ *
+ *  \warning The thread-local caches are not released when a thread
+ *  exits. Long-running programs that create and destroy many threads
+ *  should call `re_purge` before exiting each thread.
  */
 
 #pragma once
@@ -60,7 +65,23 @@ string re_escape(const string_wrapper& str);
 
 /**
  *  \brief Purge the regex cache.
+ *
+ *  Releases the cache for the current thread immediately, and for
+ *  all other threads on their next use of the cache.
  */
 void re_purge();
 
+/**
+ *  \brief Get the maximum number of compiled patterns cached per thread.
+ */
+size_t re_cache_size() noexcept;
+
+/**
+ *  \brief Set the maximum number of compiled patterns cached per thread.
+ *
+ *  Existing caches are reset on their next use. The size is
+ *  clamped to the range `[1, INT_MAX]`.
+ */
+void re_set_cache_size(size_t size) noexcept;
+
 PYCPP_END_NAMESPACE
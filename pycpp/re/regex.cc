@@ -252,6 +252,13 @@ size_t regexp_t::groups() const
 }
 
 
+string_wrapper regexp_t::pattern() const
+{
+    const std::string& str = ptr_->sub.pattern();
+    return string_wrapper(str.data(), str.size());
+}
+
+
 const match_group_indexes& regexp_t::group_indexes() const
 {
     return ptr_->re2.NamedCapturingGroups();
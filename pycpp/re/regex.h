@@ -49,6 +49,7 @@ public:
     match_range finditer(const string_wrapper& str, size_t start = 0, size_t endpos = string_wrapper::npos);
     string sub(const string_wrapper& repl, const string_wrapper& str);
     size_t groups() const;
+    string_wrapper pattern() const;
     const match_group_indexes& group_indexes() const;
     const match_group_names& group_names() const;
 
@@ -0,0 +1,139 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/re/new.h>
+#include <pycpp/re/set.h>
+#include <pycpp/stl/stdexcept.h>
+#include <re2/set.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// HELPERS
+// -------
+
+static re2::RE2::Anchor to_re2(regex_anchor anchor)
+{
+    switch (anchor) {
+        case regex_anchor_start:
+            return re2::RE2::ANCHOR_START;
+        case regex_anchor_both:
+            return re2::RE2::ANCHOR_BOTH;
+        case regex_unanchored:
+        default:
+            return re2::RE2::UNANCHORED;
+    }
+}
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Implied base class for the regular expression set.
+ */
+struct regex_set_impl_t
+{
+    re2::RE2::Set set;
+    size_t size = 0;
+    bool compiled = false;
+
+    regex_set_impl_t(regex_anchor anchor);
+};
+
+
+regex_set_impl_t::regex_set_impl_t(regex_anchor anchor):
+    set(re2::RE2::Options(), to_re2(anchor))
+{}
+
+
+regex_set_t::regex_set_t(regex_anchor anchor):
+    ptr_(deleter_type::create_static(re_allocator(), anchor), deleter_type(re_allocator()))
+{}
+
+
+regex_set_t::regex_set_t(regex_set_t&& rhs) noexcept:
+    ptr_(move(rhs.ptr_))
+{}
+
+
+regex_set_t & regex_set_t::operator=(regex_set_t&& rhs) noexcept
+{
+    swap(ptr_, rhs.ptr_);
+    return *this;
+}
+
+
+regex_set_t::~regex_set_t() noexcept
+{}
+
+
+size_t regex_set_t::add(const string_wrapper& pattern)
+{
+    if (ptr_->compiled) {
+        throw runtime_error("Cannot add patterns to a compiled regex set.");
+    }
+
+    re2::StringPiece piece(pattern.data(), pattern.size());
+    int index = ptr_->set.Add(piece, nullptr);
+    if (index < 0) {
+        throw runtime_error("Invalid regular expression pattern.");
+    }
+    ++ptr_->size;
+
+    return static_cast<size_t>(index);
+}
+
+
+void regex_set_t::compile()
+{
+    if (ptr_->compiled) {
+        return;
+    } else if (!ptr_->set.Compile()) {
+        throw runtime_error("Unable to compile regex set, out of memory.");
+    }
+    ptr_->compiled = true;
+}
+
+
+match_indexes regex_set_t::match(const string_wrapper& str) const
+{
+    match_indexes indexes;
+    match(str, indexes);
+    return indexes;
+}
+
+
+bool regex_set_t::match(const string_wrapper& str, match_indexes& indexes) const
+{
+    if (!ptr_->compiled) {
+        throw runtime_error("Regex set must be compiled before matching.");
+    }
+
+    re2::StringPiece input(str.data(), str.size());
+    return ptr_->set.Match(input, &indexes);
+}
+
+
+bool regex_set_t::any(const string_wrapper& str) const
+{
+    if (!ptr_->compiled) {
+        throw runtime_error("Regex set must be compiled before matching.");
+    }
+
+    // without an output vector, RE2 may stop at the first match
+    re2::StringPiece input(str.data(), str.size());
+    return ptr_->set.Match(input, nullptr);
+}
+
+
+size_t regex_set_t::size() const noexcept
+{
+    return ptr_->size;
+}
+
+
+bool regex_set_t::compiled() const noexcept
+{
+    return ptr_->compiled;
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,122 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Set of regular expressions matched in a single pass.
+ *
+ *  Compiles many patterns into a single automaton, so each input
+ *  is scanned once regardless of the number of patterns, returning
+ *  the indexes of all patterns matching the input. Unlike `regexp_t`,
+ *  the set does not extract submatches, and a compiled set may be
+ *  matched concurrently from multiple threads. The indexes of
+ *  matching patterns are returned in no particular order.
+ *
+ *  \code
+ *      regex_set_t set;
+ *      set.add("error");       // 0
+ *      set.add("warn(ing)?");  // 1
+ *      set.compile();
+ *      auto indexes = set.match("warning: disk full");    // {1}
+ *
+ *  \synopsis
+ *      enum regex_anchor
+ *      {
+ *          regex_unanchored = 0,
+ *          regex_anchor_start,
+ *          regex_anchor_both,
+ *      };
+ *
+ *      using match_indexes = implementation-defined;
+ *
+ *      struct regex_set_t
+ *      {
+ *          regex_set_t(regex_anchor anchor = regex_unanchored);
+ *          regex_set_t(const regex_set_t&) = delete;
+ *          regex_set_t& operator=(const regex_set_t&) = delete;
+ *          regex_set_t(regex_set_t&&) noexcept;
+ *          regex_set_t& operator=(regex_set_t&&) noexcept;
+ *          ~regex_set_t() noexcept;
+ *
+ *          size_t add(const string_wrapper& pattern);
+ *          void compile();
+ *          match_indexes match(const string_wrapper& str) const;
+ *          bool match(const string_wrapper& str, match_indexes& indexes) const;
+ *          bool any(const string_wrapper& str) const;
+ *          size_t size() const noexcept;
+ *          bool compiled() const noexcept;
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/misc/heap_pimpl.h>
+#include <pycpp/stl/vector.h>
+#include <pycpp/string/string.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// FORWARD
+// -------
+
+struct regex_set_impl_t;
+
+// ENUMS
+// -----
+
+/**
+ *  \brief Anchoring for all patterns within a regex set.
+ */
+enum regex_anchor
+{
+    regex_unanchored = 0,
+    regex_anchor_start,
+    regex_anchor_both,
+};
+
+// ALIAS
+// -----
+
+// Aliases for RE2 types.
+using match_indexes = std::vector<int>;
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Set of regular expressions matched in a single pass.
+ */
+struct regex_set_t
+{
+public:
+    // MEMBER TYPES
+    // ------------
+    using allocator_type = allocator<regex_set_impl_t>;
+    using deleter_type = unique_heap_pimpl_manager<regex_set_impl_t, allocator_type, true>;
+
+    // MEMBER FUNCTIONS
+    // ----------------
+    regex_set_t(regex_anchor anchor = regex_unanchored);
+    regex_set_t(const regex_set_t&) = delete;
+    regex_set_t & operator=(const regex_set_t&) = delete;
+    regex_set_t(regex_set_t&&) noexcept;
+    regex_set_t & operator=(regex_set_t&&) noexcept;
+    ~regex_set_t() noexcept;
+
+    // MODIFIERS
+    size_t add(const string_wrapper& pattern);
+    void compile();
+
+    // MATCHING
+    match_indexes match(const string_wrapper& str) const;
+    bool match(const string_wrapper& str, match_indexes& indexes) const;
+    bool any(const string_wrapper& str) const;
+
+    // PROPERTIES
+    size_t size() const noexcept;
+    bool compiled() const noexcept;
+
+private:
+    unique_ptr<regex_set_impl_t, deleter_type> ptr_;
+};
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,147 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/runtime/cpu.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(HAVE_X86_SIMD) && defined(HAVE_MSVC)
+#   include <intrin.h>
+#elif defined(HAVE_X86_SIMD)
+#   include <cpuid.h>
+#endif
+
+PYCPP_BEGIN_NAMESPACE
+
+// HELPERS
+// -------
+
+#if defined(HAVE_X86_SIMD)              // HAVE_X86_SIMD
+
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t* regs) noexcept
+{
+#if defined(HAVE_MSVC)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) {
+        regs[i] = static_cast<uint32_t>(info[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+
+/**
+ *  \brief Read the extended control register, to check OS support for AVX.
+ */
+static uint64_t xgetbv() noexcept
+{
+#if defined(HAVE_MSVC)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+
+static bool is_set(uint32_t reg, int bit) noexcept
+{
+    return (reg >> bit) & 1;
+}
+
+
+static uint32_t detect_features() noexcept
+{
+    uint32_t features = 0;
+    uint32_t regs[4];
+    cpuid(0, 0, regs);
+    uint32_t max_leaf = regs[0];
+    if (max_leaf < 1) {
+        return features;
+    }
+
+    // leaf 1: ecx and edx
+    cpuid(1, 0, regs);
+    uint32_t ecx = regs[2];
+    uint32_t edx = regs[3];
+    features |= is_set(edx, 26) << cpu_sse2;
+    features |= is_set(ecx, 0) << cpu_sse3;
+    features |= is_set(ecx, 9) << cpu_ssse3;
+    features |= is_set(ecx, 19) << cpu_sse41;
+    features |= is_set(ecx, 20) << cpu_sse42;
+    features |= is_set(ecx, 23) << cpu_popcnt;
+    features |= is_set(ecx, 25) << cpu_aes;
+    features |= is_set(ecx, 1) << cpu_pclmul;
+
+    // AVX requires the OS to save the YMM registers
+    bool avx_state = is_set(ecx, 27) && (xgetbv() & 6) == 6;
+    features |= (avx_state && is_set(ecx, 28)) << cpu_avx;
+
+    // leaf 7: ebx
+    if (max_leaf >= 7) {
+        cpuid(7, 0, regs);
+        uint32_t ebx = regs[1];
+        features |= (avx_state && is_set(ebx, 5)) << cpu_avx2;
+        features |= is_set(ebx, 3) << cpu_bmi1;
+        features |= is_set(ebx, 8) << cpu_bmi2;
+        features |= is_set(ebx, 29) << cpu_sha;
+    }
+
+    return features;
+}
+
+#else                                   // !HAVE_X86_SIMD
+
+static uint32_t detect_features() noexcept
+{
+    return 0;
+}
+
+#endif                                  // HAVE_X86_SIMD
+
+
+/**
+ *  \brief Features listed in the `PYCPP_CPU_DISABLE` environment variable.
+ */
+static uint32_t disabled_features() noexcept
+{
+    static const char* const NAMES[] = {
+        "sse2", "sse3", "ssse3", "sse41", "sse42", "popcnt", "aes",
+        "pclmul", "avx", "avx2", "bmi1", "bmi2", "sha",
+    };
+
+    uint32_t features = 0;
+    const char* list = getenv("PYCPP_CPU_DISABLE");
+    if (list == nullptr) {
+        return features;
+    }
+
+    // comma-separated list of names, unknown names are ignored
+    while (*list) {
+        size_t length = strcspn(list, ",");
+        for (size_t i = 0; i < sizeof(NAMES) / sizeof(NAMES[0]); ++i) {
+            if (strlen(NAMES[i]) == length && strncmp(NAMES[i], list, length) == 0) {
+                features |= uint32_t(1) << i;
+            }
+        }
+        list += length;
+        list += (*list == ',');
+    }
+
+    return features;
+}
+
+// FUNCTIONS
+// ---------
+
+
+bool cpu_supports(cpu_feature feature) noexcept
+{
+    static const uint32_t features = detect_features() & ~disabled_features();
+    return (features >> feature) & 1;
+}
+
+PYCPP_END_NAMESPACE
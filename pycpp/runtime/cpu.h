@@ -0,0 +1,95 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Detect processor features at runtime.
+ *
+ *  Query the processor for instruction set extensions, allowing
+ *  vectorized routines to be compiled for a specific target and
+ *  selected at runtime, falling back to portable implementations
+ *  on older hardware. Features are detected once, on first use.
+ *
+ *  `SIMD_TARGET` compiles a single function for an instruction set
+ *  without changing the flags for the whole translation unit, and
+ *  `HAVE_X86_SIMD` is defined when x86 intrinsics may be used.
+ *
+ *  Features may be masked by listing them in the `PYCPP_CPU_DISABLE`
+ *  environment variable, separated by commas (for example,
+ *  `PYCPP_CPU_DISABLE=avx2,sha`), to benchmark the fallback
+ *  implementations on newer hardware. Each name is the enumerator
+ *  without the `cpu_` prefix.
+ *
+ *  \synopsis
+ *      #define HAVE_X86_SIMD                   implementation-defined
+ *      #define SIMD_TARGET(isa)                implementation-defined
+ *
+ *      enum cpu_feature
+ *      {
+ *          cpu_sse2 = 0,
+ *          cpu_sse3,
+ *          cpu_ssse3,
+ *          cpu_sse41,
+ *          cpu_sse42,
+ *          cpu_popcnt,
+ *          cpu_aes,
+ *          cpu_pclmul,
+ *          cpu_avx,
+ *          cpu_avx2,
+ *          cpu_bmi1,
+ *          cpu_bmi2,
+ *          cpu_sha,
+ *      };
+ *
+ *      bool cpu_supports(cpu_feature feature) noexcept;
+ */
+
+#pragma once
+
+#include <pycpp/config.h>
+#include <pycpp/preprocessor/compiler.h>
+#include <pycpp/preprocessor/processor.h>
+
+// MACROS
+// ------
+
+#if defined(PROCESSOR_X86) && (defined(HAVE_GCC) || defined(HAVE_CLANG))
+#   define HAVE_X86_SIMD
+#   define SIMD_TARGET(isa) __attribute__((target(isa)))
+#elif defined(PROCESSOR_X86) && defined(HAVE_MSVC)
+#   define HAVE_X86_SIMD
+#   define SIMD_TARGET(isa)
+#else
+#   define SIMD_TARGET(isa)
+#endif
+
+PYCPP_BEGIN_NAMESPACE
+
+// ENUMS
+// -----
+
+enum cpu_feature
+{
+    cpu_sse2 = 0,
+    cpu_sse3,
+    cpu_ssse3,
+    cpu_sse41,
+    cpu_sse42,
+    cpu_popcnt,
+    cpu_aes,
+    cpu_pclmul,
+    cpu_avx,
+    cpu_avx2,
+    cpu_bmi1,
+    cpu_bmi2,
+    cpu_sha,
+};
+
+// FUNCTIONS
+// ---------
+
+/**
+ *  \brief Check if the processor and OS support an instruction set.
+ */
+bool cpu_supports(cpu_feature feature) noexcept;
+
+PYCPP_END_NAMESPACE
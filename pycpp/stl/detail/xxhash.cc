@@ -0,0 +1,28 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/random.h>
+#include <pycpp/stl/detail/xxhash.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// HELPERS
+// -------
+
+static hash_result_t generate_seed()
+{
+    hash_result_t seed;
+    sysrandom(&seed, sizeof(seed));
+    return seed;
+}
+
+// FUNCTIONS
+// ---------
+
+hash_result_t xxhash_random_seed()
+{
+    static const hash_result_t seed = generate_seed();
+    return seed;
+}
+
+PYCPP_END_NAMESPACE
@@ -28,6 +28,7 @@ using std::is_same;
 using std::is_base_of;
 using std::is_reference;
 using std::is_array;
+using std::is_pointer;
 using std::is_void;
 using std::is_lvalue_reference;
 using std::is_rvalue_reference;
@@ -7,8 +7,10 @@
 
 #pragma once
 
+#include <stream/encoding.h>
 #include <stream/filter.h>
 #if BUILD_FILESYSTEM
+#   include <stream/aio.h>
 #   include <stream/fd.h>
 #   include <stream/mmap.h>
 #   include <stream/random_access.h>
@@ -0,0 +1,1074 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/filesystem.h>
+#include <pycpp/preprocessor/errno.h>
+#include <pycpp/stl/algorithm.h>
+#include <pycpp/stl/deque.h>
+#include <pycpp/stl/mutex.h>
+#include <pycpp/stl/stdexcept.h>
+#include <pycpp/stl/thread.h>
+#include <pycpp/stream/aio.h>
+#include <condition_variable>
+#include <string.h>
+#if defined(OS_WINDOWS)
+#   include <windows.h>
+#else
+#   include <unistd.h>
+#endif
+#if defined(HAVE_IO_URING)
+#   include <linux/io_uring.h>
+#   include <sys/mman.h>
+#   include <sys/syscall.h>
+#endif
+
+#if defined(HAVE_IO_URING) && defined(__NR_io_uring_setup) && defined(IORING_FEAT_FAST_POLL)
+#   define PYCPP_IO_URING 1
+#endif
+
+PYCPP_BEGIN_NAMESPACE
+
+// VARIABLES
+// ---------
+
+size_t AIO_DEFAULT_DEPTH = 64;
+size_t AIO_BUFFER_SIZE = 262144;
+size_t AIO_STREAM_DEPTH = 4;
+static constexpr size_t AIO_MAX_THREADS = 4;
+static constexpr size_t AIO_MAX_SIZE = 0x7FFFF000;
+
+// HELPERS
+// -------
+
+
+static void aio_complete(aio_request& request, streamsize result, int error)
+{
+    request.result = result;
+    request.error = error;
+}
+
+
+#if defined(OS_WINDOWS)             // WINDOWS
+
+
+static void aio_execute(aio_request& request)
+{
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(request.offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(request.offset) >> 32);
+    DWORD size = static_cast<DWORD>(min<size_t>(request.size, AIO_MAX_SIZE));
+    DWORD bytes = 0;
+
+    BOOL ok;
+    if (request.opcode == aio_read) {
+        ok = ReadFile(request.fd, request.data, size, &bytes, &overlapped);
+    } else {
+        ok = WriteFile(request.fd, request.data, size, &bytes, &overlapped);
+    }
+
+    if (ok) {
+        aio_complete(request, bytes, 0);
+    } else if (GetLastError() == ERROR_HANDLE_EOF) {
+        aio_complete(request, 0, 0);
+    } else {
+        aio_complete(request, -1, EIO);
+    }
+}
+
+
+#else                               // POSIX
+
+
+static void aio_execute(aio_request& request)
+{
+    size_t size = min<size_t>(request.size, AIO_MAX_SIZE);
+    ssize_t bytes;
+    do {
+        if (request.opcode == aio_read) {
+            bytes = ::pread(request.fd, request.data, size, request.offset);
+        } else {
+            bytes = ::pwrite(request.fd, request.data, size, request.offset);
+        }
+    } while (bytes == -1 && errno == EINTR);
+
+    aio_complete(request, bytes, bytes == -1 ? errno : 0);
+}
+
+#endif                              // WINDOWS
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Base for the asynchronous backends.
+ */
+struct aio_context_impl
+{
+    size_t depth = 0;
+    size_t pending = 0;
+
+    virtual ~aio_context_impl() noexcept = default;
+    virtual aio_backend backend() const noexcept = 0;
+    virtual size_t submit(aio_request* const* requests, size_t count) = 0;
+    virtual size_t wait(aio_request** completed, size_t min_count, size_t max_count) = 0;
+};
+
+
+/**
+ *  \brief Blocking positional I/O from a pool of threads.
+ */
+struct aio_threads_impl: aio_context_impl
+{
+    mutex lock;
+    std::condition_variable work;
+    std::condition_variable done;
+    deque<aio_request*> queue;
+    deque<aio_request*> completed;
+    vector<thread> workers;
+    bool stop = false;
+
+    aio_threads_impl(size_t depth);
+    ~aio_threads_impl() noexcept;
+
+    virtual aio_backend backend() const noexcept;
+    virtual size_t submit(aio_request* const* requests, size_t count);
+    virtual size_t wait(aio_request** completed, size_t min_count, size_t max_count);
+    void run();
+};
+
+
+aio_threads_impl::aio_threads_impl(size_t depth)
+{
+    this->depth = depth;
+    size_t threads = min(depth, AIO_MAX_THREADS);
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([this]() {
+            run();
+        });
+    }
+}
+
+
+aio_threads_impl::~aio_threads_impl() noexcept
+{
+    // workers finish any queued requests before exiting
+    {
+        lock_guard<mutex> guard(lock);
+        stop = true;
+    }
+    work.notify_all();
+    for (thread& worker: workers) {
+        worker.join();
+    }
+}
+
+
+aio_backend aio_threads_impl::backend() const noexcept
+{
+    return aio_backend_threads;
+}
+
+
+size_t aio_threads_impl::submit(aio_request* const* requests, size_t count)
+{
+    count = min(count, depth - pending);
+    {
+        lock_guard<mutex> guard(lock);
+        queue.insert(queue.end(), requests, requests + count);
+    }
+    pending += count;
+    work.notify_all();
+
+    return count;
+}
+
+
+size_t aio_threads_impl::wait(aio_request** dst, size_t min_count, size_t max_count)
+{
+    min_count = min(min_count, pending);
+    unique_lock<mutex> guard(lock);
+    done.wait(guard, [this, min_count]() {
+        return completed.size() >= min_count;
+    });
+
+    size_t count = min(max_count, completed.size());
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = completed.front();
+        completed.pop_front();
+    }
+    pending -= count;
+
+    return count;
+}
+
+
+void aio_threads_impl::run()
+{
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        work.wait(guard, [this]() {
+            return stop || !queue.empty();
+        });
+        if (queue.empty()) {
+            return;
+        }
+
+        aio_request* request = queue.front();
+        queue.pop_front();
+        guard.unlock();
+        aio_execute(*request);
+        guard.lock();
+        completed.push_back(request);
+        done.notify_one();
+    }
+}
+
+
+#if defined(PYCPP_IO_URING)         // IO_URING
+
+/**
+ *  \brief Submission and completion rings shared with the kernel.
+ *
+ *  Requests are written to the submission ring, and the kernel
+ *  posts their results to the completion ring, so a single
+ *  `io_uring_enter` call submits a batch of requests and waits
+ *  for completions.
+ */
+struct aio_uring_impl: aio_context_impl
+{
+    int fd = -1;
+    void* sq_ptr = MAP_FAILED;
+    size_t sq_size = 0;
+    void* cq_ptr = MAP_FAILED;
+    size_t cq_size = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqes_size = 0;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    io_uring_cqe* cqes;
+    unsigned tail = 0;
+
+    ~aio_uring_impl() noexcept;
+
+    bool open(size_t depth);
+    virtual aio_backend backend() const noexcept;
+    virtual size_t submit(aio_request* const* requests, size_t count);
+    virtual size_t wait(aio_request** completed, size_t min_count, size_t max_count);
+    void enter(unsigned min_complete);
+    size_t reap(aio_request** completed, size_t max_count);
+};
+
+
+aio_uring_impl::~aio_uring_impl() noexcept
+{
+    // the kernel may still write to in-flight buffers
+    aio_request* completed[64];
+    try {
+        while (pending) {
+            wait(completed, 1, 64);
+        }
+    } catch (...) {
+    }
+
+    if (sqes) {
+        ::munmap(sqes, sqes_size);
+    }
+    if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr) {
+        ::munmap(cq_ptr, cq_size);
+    }
+    if (sq_ptr != MAP_FAILED) {
+        ::munmap(sq_ptr, sq_size);
+    }
+    if (fd != -1) {
+        ::close(fd);
+    }
+}
+
+
+bool aio_uring_impl::open(size_t entries)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    fd = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(entries), &params));
+    if (fd == -1) {
+        return false;
+    } else if (!(params.features & IORING_FEAT_FAST_POLL)) {
+        // IORING_FEAT_FAST_POLL requires Linux 5.7, which implies
+        // IORING_OP_READ and IORING_OP_WRITE (added in 5.6)
+        return false;
+    }
+
+    sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single) {
+        sq_size = cq_size = max(sq_size, cq_size);
+    }
+
+    int prot = PROT_READ | PROT_WRITE;
+    int flags = MAP_SHARED | MAP_POPULATE;
+    sq_ptr = ::mmap(nullptr, sq_size, prot, flags, fd, IORING_OFF_SQ_RING);
+    if (sq_ptr == MAP_FAILED) {
+        return false;
+    }
+    if (single) {
+        cq_ptr = sq_ptr;
+    } else {
+        cq_ptr = ::mmap(nullptr, cq_size, prot, flags, fd, IORING_OFF_CQ_RING);
+        if (cq_ptr == MAP_FAILED) {
+            return false;
+        }
+    }
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* ptr = ::mmap(nullptr, sqes_size, prot, flags, fd, IORING_OFF_SQES);
+    if (ptr == MAP_FAILED) {
+        return false;
+    }
+    sqes = reinterpret_cast<io_uring_sqe*>(ptr);
+
+    char* sq = reinterpret_cast<char*>(sq_ptr);
+    char* cq = reinterpret_cast<char*>(cq_ptr);
+    sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    tail = *sq_tail;
+
+    // the completion ring holds twice the submission entries, so
+    // limiting requests in flight to the latter never overflows it
+    depth = min<size_t>(entries, params.sq_entries);
+
+    return true;
+}
+
+
+aio_backend aio_uring_impl::backend() const noexcept
+{
+    return aio_backend_io_uring;
+}
+
+
+size_t aio_uring_impl::submit(aio_request* const* requests, size_t count)
+{
+    count = min(count, depth - pending);
+    for (size_t i = 0; i < count; ++i) {
+        aio_request* request = requests[i];
+        unsigned index = tail & *sq_mask;
+        io_uring_sqe* sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = request->opcode == aio_read ? IORING_OP_READ : IORING_OP_WRITE;
+        sqe->fd = request->fd;
+        sqe->addr = reinterpret_cast<uintptr_t>(request->data);
+        sqe->len = static_cast<unsigned>(min<size_t>(request->size, AIO_MAX_SIZE));
+        sqe->off = static_cast<uint64_t>(request->offset);
+        sqe->user_data = reinterpret_cast<uintptr_t>(request);
+        sq_array[index] = index;
+        ++tail;
+    }
+    __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+    pending += count;
+    enter(0);
+
+    return count;
+}
+
+
+size_t aio_uring_impl::wait(aio_request** completed, size_t min_count, size_t max_count)
+{
+    min_count = min(min_count, pending);
+    size_t count = reap(completed, max_count);
+    while (count < min_count) {
+        enter(static_cast<unsigned>(min_count - count));
+        count += reap(completed + count, max_count - count);
+    }
+    pending -= count;
+
+    return count;
+}
+
+
+void aio_uring_impl::enter(unsigned min_complete)
+{
+    // entries the kernel has not consumed yet are submitted again
+    unsigned submit = tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+    if (submit == 0 && min_complete == 0) {
+        return;
+    }
+
+    unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+    long result = syscall(__NR_io_uring_enter, fd, submit, min_complete, flags, nullptr, 0);
+    if (result == -1 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        throw runtime_error("Unable to submit asynchronous I/O requests.");
+    }
+}
+
+
+size_t aio_uring_impl::reap(aio_request** completed, size_t max_count)
+{
+    unsigned head = *cq_head;
+    unsigned last = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+    size_t count = 0;
+    for (; head != last && count < max_count; ++head) {
+        io_uring_cqe* cqe = &cqes[head & *cq_mask];
+        aio_request* request = reinterpret_cast<aio_request*>(static_cast<uintptr_t>(cqe->user_data));
+        if (cqe->res < 0) {
+            aio_complete(*request, -1, -cqe->res);
+        } else {
+            aio_complete(*request, cqe->res, 0);
+        }
+        completed[count++] = request;
+    }
+    __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+
+    return count;
+}
+
+
+static unique_ptr<aio_context_impl> aio_make_uring(size_t depth)
+{
+    unique_ptr<aio_uring_impl> ptr = make_unique<aio_uring_impl>();
+    if (!ptr->open(depth)) {
+        return nullptr;
+    }
+    return unique_ptr<aio_context_impl>(ptr.release());
+}
+
+#else                               // !IO_URING
+
+
+static unique_ptr<aio_context_impl> aio_make_uring(size_t)
+{
+    return nullptr;
+}
+
+#endif                              // IO_URING
+
+// CONTEXT
+
+
+aio_context::aio_context(size_t depth, aio_backend backend)
+{
+    depth = max<size_t>(depth, 1);
+    if (backend != aio_backend_threads) {
+        ptr_ = aio_make_uring(depth);
+        if (!ptr_ && backend == aio_backend_io_uring) {
+            throw runtime_error("io_uring is not available.");
+        }
+    }
+    if (!ptr_) {
+        ptr_.reset(new aio_threads_impl(depth));
+    }
+}
+
+
+aio_context::aio_context(aio_context&& rhs) noexcept:
+    ptr_(move(rhs.ptr_))
+{}
+
+
+aio_context& aio_context::operator=(aio_context&& rhs) noexcept
+{
+    swap(rhs);
+    return *this;
+}
+
+
+aio_context::~aio_context() noexcept
+{}
+
+
+aio_backend aio_context::backend() const noexcept
+{
+    return ptr_->backend();
+}
+
+
+size_t aio_context::depth() const noexcept
+{
+    return ptr_->depth;
+}
+
+
+size_t aio_context::pending() const noexcept
+{
+    return ptr_->pending;
+}
+
+
+size_t aio_context::submit(aio_request* const* requests, size_t count)
+{
+    return ptr_->submit(requests, count);
+}
+
+
+size_t aio_context::wait(aio_request** completed, size_t min_count, size_t max_count)
+{
+    return ptr_->wait(completed, min_count, max_count);
+}
+
+
+void aio_context::swap(aio_context& rhs) noexcept
+{
+    using PYCPP_NAMESPACE::swap;
+    swap(ptr_, rhs.ptr_);
+}
+
+// STREAMBUF
+
+
+aio_streambuf::aio_streambuf(ios_base::openmode mode, fd_t fd):
+    aio_streambuf(mode, fd, AIO_BUFFER_SIZE, AIO_STREAM_DEPTH)
+{}
+
+
+aio_streambuf::aio_streambuf(ios_base::openmode mode, fd_t fd, size_t buffer_size, size_t depth):
+    mode(mode),
+    buffer_size(max<size_t>(buffer_size, 1)),
+    depth(max<size_t>(depth, 1))
+{
+    this->fd(fd);
+}
+
+
+aio_streambuf::~aio_streambuf()
+{
+    close();
+}
+
+
+aio_streambuf::aio_streambuf(aio_streambuf&& rhs):
+    mode(rhs.mode),
+    buffer_size(rhs.buffer_size),
+    depth(rhs.depth)
+{
+    swap(rhs);
+}
+
+
+aio_streambuf& aio_streambuf::operator=(aio_streambuf&& rhs)
+{
+    swap(rhs);
+    return *this;
+}
+
+
+void aio_streambuf::close()
+{
+    if (fd_ == INVALID_FD_VALUE) {
+        return;
+    }
+
+    // wait for in-flight requests, and leave the descriptor at the
+    // logical position, as a sequential stream would
+    streamoff position = tell();
+    if (mode & ios_base::out) {
+        sync();
+    } else {
+        drain();
+        setg(0, 0, 0);
+        head_ = count_ = 0;
+        base_ = next_ = position;
+    }
+    fd_seek(fd_, position);
+}
+
+
+bool aio_streambuf::is_open() const
+{
+    return fd_ != INVALID_FD_VALUE;
+}
+
+
+void aio_streambuf::swap(aio_streambuf& rhs)
+{
+    using PYCPP_NAMESPACE::swap;
+
+    swap(mode, rhs.mode);
+    swap(buffer_size, rhs.buffer_size);
+    swap(depth, rhs.depth);
+    swap(fd_, rhs.fd_);
+    swap(context_, rhs.context_);
+    swap(slots_, rhs.slots_);
+    swap(head_, rhs.head_);
+    swap(count_, rhs.count_);
+    swap(base_, rhs.base_);
+    swap(next_, rhs.next_);
+    swap(error_, rhs.error_);
+    streambuf::swap(rhs);
+}
+
+
+fd_t aio_streambuf::fd() const
+{
+    return fd_;
+}
+
+
+void aio_streambuf::fd(fd_t fd)
+{
+    close();
+    fd_ = fd;
+    setg(0, 0, 0);
+    setp(0, 0);
+    head_ = count_ = 0;
+    error_ = false;
+    base_ = 0;
+    if (fd_ != INVALID_FD_VALUE) {
+        base_ = max<streamoff>(fd_tell(fd_), 0);
+    }
+    next_ = base_;
+}
+
+
+auto aio_streambuf::underflow() -> int_type
+{
+    if (!(mode & ios_base::in) || fd_ == INVALID_FD_VALUE) {
+        return traits_type::eof();
+    } else if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    // release the consumed buffer
+    if (eback()) {
+        base_ += egptr() - eback();
+        head_ = (head_ + 1) % depth;
+        --count_;
+        setg(0, 0, 0);
+    }
+    if (error_) {
+        return traits_type::eof();
+    }
+
+    // after a short read, the queued reads start past the data read
+    if (count_ && slots_[head_].request.offset != base_) {
+        drain();
+        head_ = count_ = 0;
+        next_ = base_;
+    }
+
+    submit_reads();
+    slot& s = slots_[head_];
+    wait_for(s);
+    if (s.request.result <= 0) {
+        // 0 indicates EOF, -1 indicates error.
+        error_ = s.request.result < 0;
+        drain();
+        head_ = count_ = 0;
+        next_ = base_;
+        return traits_type::eof();
+    }
+
+    char_type* first = s.data.get();
+    setg(first, first, first + s.request.result);
+    return traits_type::to_int_type(*gptr());
+}
+
+
+auto aio_streambuf::overflow(int_type c) -> int_type
+{
+    if (!(mode & ios_base::out) || fd_ == INVALID_FD_VALUE) {
+        return traits_type::eof();
+    }
+
+    if (pbase() && pptr() == epptr()) {
+        if (!submit_write()) {
+            return traits_type::eof();
+        }
+    }
+    if (!pbase()) {
+        initialize_buffers();
+        slot& s = slots_[head_];
+        wait_for(s);
+        if (error_) {
+            return traits_type::eof();
+        }
+        setp(s.data.get(), s.data.get() + buffer_size);
+    }
+
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+
+int aio_streambuf::sync()
+{
+    if (fd_ != INVALID_FD_VALUE && mode & ios_base::out) {
+        submit_write();
+        drain();
+    }
+
+    return error_ ? -1 : 0;
+}
+
+
+auto aio_streambuf::seekoff(off_type off, ios_base::seekdir way, ios_base::openmode openmode) -> pos_type
+{
+    if (fd_ == INVALID_FD_VALUE) {
+        return pos_type(off_type(-1));
+    }
+
+    streamoff position;
+    switch (way) {
+        case ios_base::beg:
+            position = off;
+            break;
+        case ios_base::cur:
+            position = tell() + off;
+            break;
+        case ios_base::end:
+            if (sync() == -1) {
+                return pos_type(off_type(-1));
+            }
+            position = fd_seek(fd_, off, ios_base::end);
+            break;
+        default:
+            return pos_type(off_type(-1));
+    }
+
+    return seekpos(position, openmode);
+}
+
+
+auto aio_streambuf::seekpos(pos_type pos, ios_base::openmode) -> pos_type
+{
+    streamoff position = pos;
+    if (fd_ == INVALID_FD_VALUE || position < 0) {
+        return pos_type(off_type(-1));
+    }
+
+    if (mode & ios_base::out) {
+        if (sync() == -1) {
+            return pos_type(off_type(-1));
+        }
+        base_ = position;
+        return pos;
+    }
+
+    // seeking within the get area keeps the reads in flight
+    streamoff size = egptr() - eback();
+    if (eback() && position >= base_ && position <= base_ + size) {
+        setg(eback(), eback() + (position - base_), egptr());
+        return pos;
+    }
+
+    drain();
+    setg(0, 0, 0);
+    head_ = count_ = 0;
+    base_ = next_ = position;
+    return pos;
+}
+
+
+void aio_streambuf::initialize_buffers()
+{
+    // buffers are only allocated once the stream is used
+    if (context_) {
+        return;
+    }
+    context_.reset(new aio_context(depth));
+    slots_.resize(depth);
+    for (slot& s: slots_) {
+        s.data.reset(new char_type[buffer_size]);
+    }
+}
+
+
+streamoff aio_streambuf::tell() const
+{
+    if (mode & ios_base::out) {
+        return base_ + (pptr() - pbase());
+    }
+    return base_ + (gptr() - eback());
+}
+
+
+void aio_streambuf::submit_reads()
+{
+    initialize_buffers();
+
+    aio_request* requests[64];
+    while (count_ < depth) {
+        size_t count = 0;
+        for (; count_ < depth && count < 64; ++count_, ++count) {
+            size_t index = (head_ + count_) % depth;
+            slot& s = slots_[index];
+            s.request.opcode = aio_read;
+            s.request.fd = fd_;
+            s.request.data = s.data.get();
+            s.request.size = buffer_size;
+            s.request.offset = next_;
+            s.request.user_data = index;
+            s.busy = true;
+            next_ += buffer_size;
+            requests[count] = &s.request;
+        }
+
+        size_t submitted = 0;
+        while (submitted < count) {
+            submitted += context_->submit(requests + submitted, count - submitted);
+        }
+    }
+}
+
+
+bool aio_streambuf::submit_write()
+{
+    size_t size = pptr() - pbase();
+    if (size == 0) {
+        return !error_;
+    }
+
+    slot& s = slots_[head_];
+    s.request.opcode = aio_write;
+    s.request.fd = fd_;
+    s.request.data = s.data.get();
+    s.request.size = size;
+    s.request.offset = base_;
+    s.request.user_data = head_;
+    s.busy = true;
+    aio_request* request = &s.request;
+    context_->submit(&request, 1);
+
+    base_ += size;
+    head_ = (head_ + 1) % depth;
+    setp(0, 0);
+
+    return !error_;
+}
+
+
+void aio_streambuf::complete(aio_request* request)
+{
+    slot& s = slots_[request->user_data];
+    s.busy = false;
+    if (request->result < 0) {
+        error_ = true;
+    } else if (request->opcode == aio_write) {
+        // finish short writes synchronously
+        char_type* data = reinterpret_cast<char_type*>(request->data);
+        streamsize written = request->result;
+        streamsize size = request->size;
+        if (written < size && fd_seek(fd_, request->offset + written) == -1) {
+            error_ = true;
+            return;
+        }
+        while (written < size) {
+            streamsize bytes = fd_write(fd_, data + written, size - written);
+            if (bytes == -1 && errno == EINTR) {
+                continue;
+            } else if (bytes <= 0) {
+                error_ = true;
+                return;
+            }
+            written += bytes;
+        }
+    }
+}
+
+
+void aio_streambuf::wait_for(slot& s)
+{
+    aio_request* completed[64];
+    while (s.busy) {
+        size_t count = context_->wait(completed, 1, 64);
+        for (size_t i = 0; i < count; ++i) {
+            complete(completed[i]);
+        }
+    }
+}
+
+
+void aio_streambuf::drain()
+{
+    for (slot& s: slots_) {
+        wait_for(s);
+    }
+}
+
+// ISTREAM
+
+
+aio_istream::aio_istream():
+    buffer(ios_base::in, INVALID_FD_VALUE),
+    istream(&buffer),
+    close_(false)
+{}
+
+
+aio_istream::~aio_istream()
+{
+    close();
+}
+
+
+aio_istream::aio_istream(aio_istream&& rhs):
+    buffer(PYCPP_NAMESPACE::move(rhs.buffer)),
+    istream(&buffer),
+    close_(PYCPP_NAMESPACE::move(rhs.close_))
+{
+    ios::rdbuf(&buffer);
+    rhs.close_ = false;
+}
+
+
+aio_istream& aio_istream::operator=(aio_istream&& rhs)
+{
+    swap(rhs);
+    return *this;
+}
+
+
+aio_istream::aio_istream(fd_t fd, bool close):
+    buffer(ios_base::in, fd),
+    istream(&buffer),
+    close_(close)
+{}
+
+
+void aio_istream::open(fd_t fd, bool c)
+{
+    close();
+    buffer.fd(fd);
+    close_ = c;
+}
+
+
+streambuf* aio_istream::rdbuf() const
+{
+    return ios::rdbuf();
+}
+
+
+void aio_istream::rdbuf(streambuf* buffer)
+{
+    ios::rdbuf(buffer);
+}
+
+
+bool aio_istream::is_open() const
+{
+    return buffer.is_open();
+}
+
+
+void aio_istream::close()
+{
+    if (close_) {
+        // wait for in-flight reads before closing the descriptor
+        fd_t fd = buffer.fd();
+        buffer.fd(INVALID_FD_VALUE);
+        fd_close(fd);
+        close_ = false;
+    }
+}
+
+
+void aio_istream::swap(aio_istream& rhs)
+{
+    using PYCPP_NAMESPACE::swap;
+
+    istream::swap(rhs);
+    swap(buffer, rhs.buffer);
+    swap(close_, rhs.close_);
+}
+
+// OSTREAM
+
+
+aio_ostream::aio_ostream():
+    buffer(ios_base::out, INVALID_FD_VALUE),
+    ostream(&buffer),
+    close_(false)
+{}
+
+
+aio_ostream::~aio_ostream()
+{
+    close();
+}
+
+
+aio_ostream::aio_ostream(aio_ostream&& rhs):
+    buffer(PYCPP_NAMESPACE::move(rhs.buffer)),
+    ostream(&buffer),
+    close_(PYCPP_NAMESPACE::move(rhs.close_))
+{
+    ios::rdbuf(&buffer);
+    rhs.close_ = false;
+}
+
+
+aio_ostream& aio_ostream::operator=(aio_ostream&& rhs)
+{
+    swap(rhs);
+    return *this;
+}
+
+
+aio_ostream::aio_ostream(fd_t fd, bool close):
+    buffer(ios_base::out, fd),
+    ostream(&buffer),
+    close_(close)
+{}
+
+
+void aio_ostream::open(fd_t fd, bool c)
+{
+    close();
+    buffer.fd(fd);
+    close_ = c;
+}
+
+
+streambuf* aio_ostream::rdbuf() const
+{
+    return ios::rdbuf();
+}
+
+
+void aio_ostream::rdbuf(streambuf* buffer)
+{
+    ios::rdbuf(buffer);
+}
+
+
+bool aio_ostream::is_open() const
+{
+    return buffer.is_open();
+}
+
+
+void aio_ostream::close()
+{
+    if (close_) {
+        // flush pending writes before closing the descriptor
+        fd_t fd = buffer.fd();
+        buffer.fd(INVALID_FD_VALUE);
+        fd_close(fd);
+        close_ = false;
+    }
+}
+
+
+void aio_ostream::swap(aio_ostream& rhs)
+{
+    using PYCPP_NAMESPACE::swap;
+
+    ostream::swap(rhs);
+    swap(buffer, rhs.buffer);
+    swap(close_, rhs.close_);
+}
+
+PYCPP_END_NAMESPACE
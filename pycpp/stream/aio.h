@@ -0,0 +1,307 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Batched asynchronous file I/O.
+ *
+ *  `aio_context` submits batches of positional reads and writes and
+ *  returns them as they complete. On Linux, requests are submitted
+ *  to an io_uring; elsewhere, or when the kernel does not allow
+ *  io_uring, a pool of threads issues blocking `pread`/`pwrite`
+ *  calls. Requests are owned by the caller, and must stay alive
+ *  (and their buffers untouched) until `wait` returns them.
+ *
+ *  `aio_streambuf` builds read-ahead and write-behind on top of it:
+ *  several buffers are in flight at once, so a sequential scan
+ *  parses one buffer while the next ones are read. It only supports
+ *  files that allow positional I/O, not pipes or sockets.
+ *
+ *  \synopsis
+ *      enum aio_opcode
+ *      {
+ *          aio_read = 0,
+ *          aio_write,
+ *      };
+ *
+ *      enum aio_backend
+ *      {
+ *          aio_backend_default = 0,
+ *          aio_backend_io_uring,
+ *          aio_backend_threads,
+ *      };
+ *
+ *      struct aio_request
+ *      {
+ *          aio_opcode opcode = aio_read;
+ *          fd_t fd = INVALID_FD_VALUE;
+ *          void* data = nullptr;
+ *          size_t size = 0;
+ *          streamoff offset = 0;
+ *          streamsize result = 0;
+ *          int error = 0;
+ *          uintptr_t user_data = 0;
+ *      };
+ *
+ *      struct aio_context
+ *      {
+ *          aio_context(size_t depth = AIO_DEFAULT_DEPTH, aio_backend backend = aio_backend_default);
+ *          aio_context(aio_context&&) noexcept;
+ *          aio_context& operator=(aio_context&&) noexcept;
+ *          ~aio_context() noexcept;
+ *
+ *          aio_backend backend() const noexcept;
+ *          size_t depth() const noexcept;
+ *          size_t pending() const noexcept;
+ *          size_t submit(aio_request* const* requests, size_t count);
+ *          size_t wait(aio_request** completed, size_t min_count, size_t max_count);
+ *          void swap(aio_context&) noexcept;
+ *      };
+ *
+ *      class aio_streambuf: public streambuf
+ *      {
+ *          aio_streambuf(ios_base::openmode, fd_t fd);
+ *          aio_streambuf(ios_base::openmode, fd_t fd, size_t buffer_size, size_t depth);
+ *      };
+ *
+ *      class aio_istream: public istream
+ *      {
+ *          aio_istream(fd_t fd, bool close = false);
+ *          void open(fd_t fd, bool close = false);
+ *      };
+ *
+ *      class aio_ostream: public ostream
+ *      {
+ *          aio_ostream(fd_t fd, bool close = false);
+ *          void open(fd_t fd, bool close = false);
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/filesystem/fd.h>
+#include <pycpp/stl/iostream.h>
+#include <pycpp/stl/memory.h>
+#include <pycpp/stl/vector.h>
+#include <stdint.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// FORWARD
+// -------
+
+struct aio_context_impl;
+
+// VARIABLES
+// ---------
+
+extern size_t AIO_DEFAULT_DEPTH;
+extern size_t AIO_BUFFER_SIZE;
+extern size_t AIO_STREAM_DEPTH;
+
+// ENUMS
+// -----
+
+/**
+ *  \brief Operation for an asynchronous request.
+ */
+enum aio_opcode
+{
+    aio_read = 0,
+    aio_write,
+};
+
+
+/**
+ *  \brief Implementation of an asynchronous context.
+ */
+enum aio_backend
+{
+    aio_backend_default = 0,
+    aio_backend_io_uring,
+    aio_backend_threads,
+};
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Positional read or write.
+ *
+ *  On completion, `result` is the number of bytes transferred, which
+ *  may be short, or -1 with the error code in `error`.
+ */
+struct aio_request
+{
+    aio_opcode opcode = aio_read;
+    fd_t fd = INVALID_FD_VALUE;
+    void* data = nullptr;
+    size_t size = 0;
+    streamoff offset = 0;
+    streamsize result = 0;
+    int error = 0;
+    uintptr_t user_data = 0;
+};
+
+
+/**
+ *  \brief Queue of asynchronous requests.
+ *
+ *  At most `depth()` requests are in flight at once. The context is
+ *  not thread-safe: submit and wait from a single thread.
+ */
+struct aio_context
+{
+public:
+    aio_context(size_t depth = AIO_DEFAULT_DEPTH, aio_backend backend = aio_backend_default);
+    aio_context(aio_context&&) noexcept;
+    aio_context& operator=(aio_context&&) noexcept;
+    ~aio_context() noexcept;
+
+    aio_backend backend() const noexcept;
+    size_t depth() const noexcept;
+    size_t pending() const noexcept;
+    size_t submit(aio_request* const* requests, size_t count);
+    size_t wait(aio_request** completed, size_t min_count, size_t max_count);
+    void swap(aio_context&) noexcept;
+
+private:
+    unique_ptr<aio_context_impl> ptr_;
+};
+
+
+/**
+ *  \brief Streambuffer with asynchronous read-ahead or write-behind.
+ *
+ *  Opened for either input or output. Reads keep `depth` buffers of
+ *  `buffer_size` bytes in flight ahead of the get area; writes
+ *  submit each full buffer and only block when all are in flight.
+ *  The file offset of the descriptor is updated on `close`.
+ */
+class aio_streambuf: public streambuf
+{
+public:
+    // MEMBER TYPES
+    // ------------
+    using typename streambuf::char_type;
+    using typename streambuf::int_type;
+    using typename streambuf::traits_type;
+    using typename streambuf::off_type;
+    using typename streambuf::pos_type;
+
+    // MEMBER FUNCTIONS
+    // ----------------
+    aio_streambuf(ios_base::openmode, fd_t fd);
+    aio_streambuf(ios_base::openmode, fd_t fd, size_t buffer_size, size_t depth);
+    aio_streambuf(const aio_streambuf&) = delete;
+    aio_streambuf& operator=(const aio_streambuf&) = delete;
+    aio_streambuf(aio_streambuf&&);
+    aio_streambuf& operator=(aio_streambuf&&);
+    virtual ~aio_streambuf();
+
+    // MODIFIERS/PROPERTIES
+    void close();
+    bool is_open() const;
+    void swap(aio_streambuf&);
+    fd_t fd() const;
+    void fd(fd_t fd);
+
+protected:
+    // MEMBER FUNCTIONS
+    // ----------------
+    virtual int_type underflow();
+    virtual int_type overflow(int_type = traits_type::eof());
+    virtual int sync();
+    virtual pos_type seekoff(off_type off, ios_base::seekdir way, ios_base::openmode openmode = ios_base::in | ios_base::out);
+    virtual pos_type seekpos(pos_type pos, ios_base::openmode openmode = ios_base::in | ios_base::out);
+
+private:
+    struct slot
+    {
+        aio_request request;
+        unique_ptr<char_type[]> data;
+        bool busy = false;
+    };
+
+    void initialize_buffers();
+    streamoff tell() const;
+    void submit_reads();
+    bool submit_write();
+    void complete(aio_request* request);
+    void wait_for(slot& s);
+    void drain();
+
+    ios_base::openmode mode;
+    size_t buffer_size;
+    size_t depth;
+    fd_t fd_ = INVALID_FD_VALUE;
+    unique_ptr<aio_context> context_;
+    vector<slot> slots_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    streamoff base_ = 0;
+    streamoff next_ = 0;
+    bool eof_ = false;
+    bool error_ = false;
+};
+
+
+/**
+ *  \brief Input stream with asynchronous read-ahead.
+ */
+class aio_istream: public istream
+{
+public:
+    aio_istream();
+    ~aio_istream();
+    aio_istream(const aio_istream&) = delete;
+    aio_istream& operator=(const aio_istream&) = delete;
+    aio_istream(aio_istream&&);
+    aio_istream& operator=(aio_istream&&);
+
+    // STREAM
+    aio_istream(fd_t fd, bool close = false);
+    void open(fd_t fd, bool close = false);
+
+    // MODIFIERS/PROPERTIES
+    void close();
+    bool is_open() const;
+    void swap(aio_istream&);
+    streambuf* rdbuf() const;
+    void rdbuf(streambuf* buffer);
+
+private:
+    aio_streambuf buffer;
+    bool close_ = false;
+};
+
+
+/**
+ *  \brief Output stream with asynchronous write-behind.
+ */
+class aio_ostream: public ostream
+{
+public:
+    aio_ostream();
+    ~aio_ostream();
+    aio_ostream(const aio_ostream&) = delete;
+    aio_ostream& operator=(const aio_ostream&) = delete;
+    aio_ostream(aio_ostream&&);
+    aio_ostream& operator=(aio_ostream&&);
+
+    // STREAM
+    aio_ostream(fd_t fd, bool close = false);
+    void open(fd_t fd, bool close = false);
+
+    // MODIFIERS/PROPERTIES
+    void close();
+    bool is_open() const;
+    void swap(aio_ostream&);
+    streambuf* rdbuf() const;
+    void rdbuf(streambuf* buffer);
+
+private:
+    aio_streambuf buffer;
+    bool close_ = false;
+};
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,271 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/stream/encoding.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// MACROS
+// ------
+
+/**
+ *  \brief Callback function for encoding.
+ */
+#define ENCODE_CALLBACK                                                                                         \
+    [this](const void*& src, size_t srclen, void*& dst, size_t dstlen, size_t)                                  \
+    {                                                                                                           \
+        if (srclen) {                                                                                           \
+            ctx.encode(src, srclen, dst, dstlen);                                                               \
+        } else {                                                                                                \
+            ctx.flush(dst, dstlen);                                                                             \
+        }                                                                                                       \
+    }
+
+
+/**
+ *  \brief Callback function for decoding.
+ */
+#define DECODE_CALLBACK                                                                                         \
+    [this](const void*& src, size_t srclen, void*& dst, size_t dstlen, size_t)                                  \
+    {                                                                                                           \
+        if (srclen) {                                                                                           \
+            ctx.decode(src, srclen, dst, dstlen);                                                               \
+        } else {                                                                                                \
+            ctx.flush(dst, dstlen);                                                                             \
+        }                                                                                                       \
+    }
+
+
+/**
+ *  \brief Provides wide-path overloads for Windows.
+ */
+#if defined(HAVE_WFOPEN)                    // WINDOWS
+
+#   define WIDE_PATH_IFSTREAM(name)                                                                             \
+                                                                                                                \
+        name##_ifstream::name##_ifstream(const wstring_view& name, ios_base::openmode mode)                     \
+        {                                                                                                       \
+            open(name, mode);                                                                                   \
+        }                                                                                                       \
+                                                                                                                \
+        void name##_ifstream::open(const wstring_view& name, ios_base::openmode mode)                           \
+        {                                                                                                       \
+            filter_ifstream::open(name, mode, DECODE_CALLBACK);                                                 \
+        }                                                                                                       \
+                                                                                                                \
+        name##_ifstream::name##_ifstream(const u16string_view& name, ios_base::openmode mode)                   \
+        {                                                                                                       \
+            open(name, mode);                                                                                   \
+        }                                                                                                       \
+                                                                                                                \
+        void name##_ifstream::open(const u16string_view& name, ios_base::openmode mode)                         \
+        {                                                                                                       \
+            filter_ifstream::open(name, mode, DECODE_CALLBACK);                                                 \
+        }
+
+#   define WIDE_PATH_OFSTREAM(name)                                                                             \
+                                                                                                                \
+        name##_ofstream::name##_ofstream(const wstring_view& name, ios_base::openmode mode)                     \
+        {                                                                                                       \
+            open(name, mode);                                                                                   \
+        }                                                                                                       \
+                                                                                                                \
+        void name##_ofstream::open(const wstring_view& name, ios_base::openmode mode)                           \
+        {                                                                                                       \
+            filter_ofstream::open(name, mode, ENCODE_CALLBACK);                                                 \
+        }                                                                                                       \
+                                                                                                                \
+        name##_ofstream::name##_ofstream(const u16string_view& name, ios_base::openmode mode)                   \
+        {                                                                                                       \
+            open(name, mode);                                                                                   \
+        }                                                                                                       \
+                                                                                                                \
+        void name##_ofstream::open(const u16string_view& name, ios_base::openmode mode)                         \
+        {                                                                                                       \
+            filter_ofstream::open(name, mode, ENCODE_CALLBACK);                                                 \
+        }
+
+#else                                       // POSIX
+
+#   define WIDE_PATH_IFSTREAM(name)
+#   define WIDE_PATH_OFSTREAM(name)
+
+#endif                                      // WINDOWS
+
+
+/**
+ *  \brief Macro to define methods for a filtering istream base.
+ */
+#define ENCODED_ISTREAM(name)                                           \
+    name##_istream::name##_istream(istream& stream)                     \
+    {                                                                   \
+        open(stream);                                                   \
+    }                                                                   \
+                                                                        \
+    name##_istream::~name##_istream()                                   \
+    {                                                                   \
+        filter_istream::close();                                        \
+        rdbuf()->set_callback(nullptr);                                 \
+        ctx.close();                                                    \
+    }                                                                   \
+                                                                        \
+    void name##_istream::open(istream& stream)                          \
+    {                                                                   \
+        filter_istream::open(stream, DECODE_CALLBACK);                  \
+    }                                                                   \
+                                                                        \
+    name##_istream::name##_istream(name##_istream&& rhs)                \
+    {                                                                   \
+        swap(rhs);                                                      \
+    }                                                                   \
+                                                                        \
+    name##_istream & name##_istream::operator=(name##_istream&& rhs)    \
+    {                                                                   \
+        swap(rhs);                                                      \
+        return *this;                                                   \
+    }                                                                   \
+                                                                        \
+    void name##_istream::swap(name##_istream& rhs)                      \
+    {                                                                   \
+        filter_istream::swap(rhs);                                      \
+        ctx.swap(rhs.ctx);                                              \
+    }
+
+
+/**
+ *  \brief Macro to define methods for a filtering ostream base.
+ */
+#define ENCODED_OSTREAM(name)                                           \
+    name##_ostream::name##_ostream(ostream& stream)                     \
+    {                                                                   \
+        open(stream);                                                   \
+    }                                                                   \
+                                                                        \
+    name##_ostream::~name##_ostream()                                   \
+    {                                                                   \
+        filter_ostream::close();                                        \
+        rdbuf()->set_callback(nullptr);                                 \
+        ctx.close();                                                    \
+    }                                                                   \
+                                                                        \
+    void name##_ostream::open(ostream& stream)                          \
+    {                                                                   \
+        filter_ostream::open(stream, ENCODE_CALLBACK);                  \
+    }                                                                   \
+                                                                        \
+    name##_ostream::name##_ostream(name##_ostream&& rhs)                \
+    {                                                                   \
+        swap(rhs);                                                      \
+    }                                                                   \
+                                                                        \
+    name##_ostream & name##_ostream::operator=(name##_ostream&& rhs)    \
+    {                                                                   \
+        swap(rhs);                                                      \
+        return *this;                                                   \
+    }                                                                   \
+                                                                        \
+    void name##_ostream::swap(name##_ostream& rhs)                      \
+    {                                                                   \
+        filter_ostream::swap(rhs);                                      \
+        ctx.swap(rhs.ctx);                                              \
+    }
+
+/**
+ *  \brief Macro to define methods for a filtering ifstream base.
+ */
+#define ENCODED_IFSTREAM(name)                                                              \
+    name##_ifstream::name##_ifstream(name##_ifstream&& rhs)                                 \
+    {                                                                                       \
+        swap(rhs);                                                                          \
+    }                                                                                       \
+                                                                                            \
+    name##_ifstream & name##_ifstream::operator=(name##_ifstream&& rhs)                     \
+    {                                                                                       \
+        swap(rhs);                                                                          \
+        return *this;                                                                       \
+    }                                                                                       \
+                                                                                            \
+    name##_ifstream::~name##_ifstream()                                                     \
+    {                                                                                       \
+        filter_ifstream::close();                                                           \
+        rdbuf()->set_callback(nullptr);                                                     \
+        ctx.close();                                                                        \
+    }                                                                                       \
+                                                                                            \
+    name##_ifstream::name##_ifstream(const string_view& name, ios_base::openmode mode)      \
+    {                                                                                       \
+        open(name, mode);                                                                   \
+    }                                                                                       \
+                                                                                            \
+    void name##_ifstream::open(const string_view& name, ios_base::openmode mode)            \
+    {                                                                                       \
+        filter_ifstream::open(name, mode, DECODE_CALLBACK);                                 \
+    }                                                                                       \
+                                                                                            \
+    WIDE_PATH_IFSTREAM(name)                                                                \
+                                                                                            \
+    void name##_ifstream::swap(name##_ifstream& rhs)                                        \
+    {                                                                                       \
+        filter_ifstream::swap(rhs);                                                         \
+        ctx.swap(rhs.ctx);                                                                  \
+    }
+
+
+/**
+ *  \brief Macro to define methods for a filtering ofstream base.
+ */
+#define ENCODED_OFSTREAM(name)                                                                      \
+    name##_ofstream::name##_ofstream(name##_ofstream&& rhs)                                         \
+    {                                                                                               \
+        swap(rhs);                                                                                  \
+    }                                                                                               \
+                                                                                                    \
+    name##_ofstream & name##_ofstream::operator=(name##_ofstream&& rhs)                             \
+    {                                                                                               \
+        swap(rhs);                                                                                  \
+        return *this;                                                                               \
+    }                                                                                               \
+                                                                                                    \
+    name##_ofstream::~name##_ofstream()                                                             \
+    {                                                                                               \
+        filter_ofstream::close();                                                                   \
+        rdbuf()->set_callback(nullptr);                                                             \
+        ctx.close();                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    name##_ofstream::name##_ofstream(const string_view& name, ios_base::openmode mode)              \
+    {                                                                                               \
+        open(name, mode);                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    void name##_ofstream::open(const string_view& name, ios_base::openmode mode)                    \
+    {                                                                                               \
+        filter_ofstream::open(name, mode, ENCODE_CALLBACK);                                         \
+    }                                                                                               \
+                                                                                                    \
+    WIDE_PATH_OFSTREAM(name)                                                                        \
+                                                                                                    \
+    void name##_ofstream::swap(name##_ofstream& rhs)                                                \
+    {                                                                                               \
+        filter_ofstream::swap(rhs);                                                                 \
+        ctx.swap(rhs.ctx);                                                                          \
+    }
+
+
+/**
+ *  \brief Defines the encoded streams.
+ */
+#define ENCODED_STREAM_DEFINITION(name)                                                                      \
+    ENCODED_ISTREAM(name)                                                                                    \
+    ENCODED_OSTREAM(name)                                                                                    \
+    ENCODED_IFSTREAM(name)                                                                                   \
+    ENCODED_OFSTREAM(name)
+
+
+// OBJECTS
+// -------
+
+ENCODED_STREAM_DEFINITION(base16);
+ENCODED_STREAM_DEFINITION(base64);
+
+PYCPP_END_NAMESPACE
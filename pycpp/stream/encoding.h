@@ -0,0 +1,173 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Base16 and base64 encoding streams.
+ *
+ *  Input streams decode data read from the underlying stream, and
+ *  output streams encode data written to it, so large blobs can be
+ *  converted in fixed-size chunks. Output streams write the final,
+ *  padded quantum when closed or flushed.
+ */
+
+#pragma once
+
+#include <pycpp/stream/filter.h>
+#include <pycpp/string/base16.h>
+#include <pycpp/string/base64.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// MACROS
+// ------
+
+/**
+ *  \brief Provides wide-path overloads for Windows.
+ */
+#if defined(HAVE_WFOPEN)                    // WINDOWS
+
+#   define WIDE_PATH_IFSTREAM(name)                                                                         \
+        name##_ifstream(const wstring_view& name, ios_base::openmode = ios_base::in | ios_base::binary);    \
+        void open(const wstring_view& name, ios_base::openmode = ios_base::in | ios_base::binary);          \
+        name##_ifstream(const u16string_view& name, ios_base::openmode = ios_base::in | ios_base::binary);  \
+        void open(const u16string_view& name, ios_base::openmode = ios_base::in | ios_base::binary);
+
+#   define WIDE_PATH_OFSTREAM(name)                                                                         \
+        name##_ofstream(const wstring_view& name, ios_base::openmode = ios_base::out | ios_base::binary);   \
+        void open(const wstring_view& name, ios_base::openmode = ios_base::out | ios_base::binary);         \
+        name##_ofstream(const u16string_view& name, ios_base::openmode = ios_base::out | ios_base::binary); \
+        void open(const u16string_view& name, ios_base::openmode = ios_base::out | ios_base::binary);
+
+#else                                       // POSIX
+
+#   define WIDE_PATH_IFSTREAM(name)
+#   define WIDE_PATH_OFSTREAM(name)
+
+#endif                                      // WINDOWS
+
+
+/**
+ *  \brief Macro to define a decoding istream.
+ */
+#define ENCODED_ISTREAM(name)                                           \
+    struct name##_istream: filter_istream                               \
+    {                                                                   \
+    public:                                                             \
+        name##_istream() = default;                                     \
+        name##_istream(const name##_istream&) = delete;                 \
+        name##_istream & operator=(const name##_istream&) = delete;     \
+        ~name##_istream();                                              \
+                                                                        \
+        name##_istream(istream& stream);                                \
+        void open(istream& stream);                                     \
+                                                                        \
+    protected:                                                          \
+        name##_istream(name##_istream&&);                               \
+        name##_istream& operator=(name##_istream&&);                    \
+        void swap(name##_istream&);                                     \
+                                                                        \
+    private:                                                            \
+        name##_decoder ctx;                                             \
+    }
+
+
+/**
+ *  \brief Macro to define an encoding ostream.
+ */
+#define ENCODED_OSTREAM(name)                                           \
+    struct name##_ostream: filter_ostream                               \
+    {                                                                   \
+    public:                                                             \
+        name##_ostream() = default;                                     \
+        name##_ostream(const name##_ostream&) = delete;                 \
+        name##_ostream & operator=(const name##_ostream&) = delete;     \
+        ~name##_ostream();                                              \
+                                                                        \
+        name##_ostream(ostream& stream);                                \
+        void open(ostream& stream);                                     \
+                                                                        \
+    protected:                                                          \
+        name##_ostream(name##_ostream&&);                               \
+        name##_ostream & operator=(name##_ostream&&);                   \
+        void swap(name##_ostream&);                                     \
+                                                                        \
+    private:                                                            \
+        name##_encoder ctx;                                             \
+    }
+
+
+/**
+ *  \brief Macro to define a decoding ifstream.
+ */
+#define ENCODED_IFSTREAM(name)                                                                                  \
+    struct name##_ifstream: filter_ifstream                                                                     \
+    {                                                                                                           \
+    public:                                                                                                     \
+        name##_ifstream() = default;                                                                            \
+        name##_ifstream(const name##_ifstream&) = delete;                                                       \
+        name##_ifstream & operator=(const name##_ifstream&) = delete;                                           \
+        name##_ifstream(name##_ifstream&&);                                                                     \
+        name##_ifstream & operator=(name##_ifstream&&);                                                         \
+        ~name##_ifstream();                                                                                     \
+                                                                                                                \
+        name##_ifstream(const string_view& name, ios_base::openmode = ios_base::in | ios_base::binary);         \
+        void open(const string_view& name, ios_base::openmode = ios_base::in | ios_base::binary);               \
+        WIDE_PATH_IFSTREAM(name)                                                                                \
+        void swap(name##_ifstream&);                                                                            \
+                                                                                                                \
+    private:                                                                                                    \
+        name##_decoder ctx;                                                                                     \
+    }
+
+
+/**
+ *  \brief Macro to define an encoding ofstream.
+ */
+#define ENCODED_OFSTREAM(name)                                                                                  \
+    struct name##_ofstream: filter_ofstream                                                                     \
+    {                                                                                                           \
+    public:                                                                                                     \
+        name##_ofstream() = default;                                                                            \
+        name##_ofstream(const name##_ofstream&) = delete;                                                       \
+        name##_ofstream & operator=(const name##_ofstream&) = delete;                                           \
+        name##_ofstream(name##_ofstream&&);                                                                     \
+        name##_ofstream & operator=(name##_ofstream&&);                                                         \
+        ~name##_ofstream();                                                                                     \
+                                                                                                                \
+        name##_ofstream(const string_view& name, ios_base::openmode = ios_base::out | ios_base::binary);        \
+        void open(const string_view& name, ios_base::openmode = ios_base::out | ios_base::binary);              \
+        WIDE_PATH_OFSTREAM(name)                                                                                \
+        void swap(name##_ofstream&);                                                                            \
+                                                                                                                \
+    private:                                                                                                    \
+        name##_encoder ctx;                                                                                     \
+    }
+
+
+/**
+ *  \brief Defines the encoded streams.
+ */
+#define ENCODED_STREAM_DEFINITION(name)                                 \
+    ENCODED_ISTREAM(name);                                              \
+    ENCODED_OSTREAM(name);                                              \
+    ENCODED_IFSTREAM(name);                                             \
+    ENCODED_OFSTREAM(name)
+
+// OBJECTS
+// -------
+
+ENCODED_STREAM_DEFINITION(base16);
+ENCODED_STREAM_DEFINITION(base64);
+
+// CLEANUP
+// -------
+
+#undef WIDE_PATH_IFSTREAM
+#undef WIDE_PATH_OFSTREAM
+#undef ENCODED_ISTREAM
+#undef ENCODED_OSTREAM
+#undef ENCODED_IFSTREAM
+#undef ENCODED_OFSTREAM
+#undef ENCODED_STREAM_DEFINITION
+
+PYCPP_END_NAMESPACE
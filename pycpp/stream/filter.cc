@@ -72,9 +72,10 @@ filter_streambuf& filter_streambuf::operator=(filter_streambuf&& rhs)
 
 void filter_streambuf::close()
 {
+    // only output streams have pending data to flush
     sync();
-    streamsize converted = do_callback();
-    if (converted && filebuf && mode & ios_base::out) {
+    if (filebuf && mode & ios_base::out) {
+        streamsize converted = do_callback();
         filebuf->sputn(out_buffer, converted);
     }
 
@@ -108,17 +109,23 @@ auto filter_streambuf::underflow() -> int_type
         return traits_type::eof();
     }
 
-    streamsize read, converted;
+    streamsize read = 1;
+    streamsize converted;
 
     if (filebuf) {
-        if (first == nullptr) {
-            read = filebuf->sgetn(in_buffer, buffer_size);
-            first = in_buffer;
-            last = in_buffer + read;
-        }
+        // callbacks may buffer input without producing output,
+        // so keep reading until output is produced or input ends
+        do {
+            if (first == nullptr) {
+                read = filebuf->sgetn(in_buffer, buffer_size);
+                first = in_buffer;
+                last = in_buffer + read;
+            }
+
+            // perform the callback
+            converted = do_callback();
+        } while (!converted && first == nullptr && read);
 
-        // perform the callback
-        converted = do_callback();
         if (!converted) {
             return traits_type::eof();
         }
@@ -173,6 +180,22 @@ streamsize filter_streambuf::do_callback()
 }
 
 
+/**
+ *  \brief Convert all buffered input, writing the output to the file.
+ *
+ *  Expanding filters may need several passes to convert the input,
+ *  since the output buffer is the same size as the input buffer.
+ */
+void filter_streambuf::drain()
+{
+    streamsize converted;
+    do {
+        converted = do_callback();
+        filebuf->sputn(out_buffer, converted);
+    } while (first != nullptr && converted);
+}
+
+
 auto filter_streambuf::overflow(int_type c) -> int_type
 {
     if (!(mode & ios_base::out)) {
@@ -183,9 +206,10 @@ auto filter_streambuf::overflow(int_type c) -> int_type
         if (first == nullptr) {
             first = in_buffer;
             last = in_buffer;
-        } else if (last == first + buffer_size) {
-            streamsize converted = do_callback();
-            filebuf->sputn(out_buffer, converted);
+        } else if (last == in_buffer + buffer_size) {
+            drain();
+            first = in_buffer;
+            last = in_buffer;
         }
 
         if (!traits_type::eq_int_type(c, traits_type::eof())) {
@@ -196,14 +220,41 @@ auto filter_streambuf::overflow(int_type c) -> int_type
 }
 
 
+auto filter_streambuf::xsputn(const char_type* s, streamsize n) -> streamsize
+{
+    if (!(mode & ios_base::out) || !filebuf) {
+        return 0;
+    }
+
+    // copy in blocks, rather than a character at a time
+    streamsize written = 0;
+    while (written < n) {
+        if (first == nullptr) {
+            first = in_buffer;
+            last = in_buffer;
+        } else if (last == in_buffer + buffer_size) {
+            drain();
+            first = in_buffer;
+            last = in_buffer;
+        }
+
+        streamsize count = min<streamsize>(n - written, distance(last, in_buffer + buffer_size));
+        memcpy(last, s + written, static_cast<size_t>(count));
+        last += count;
+        written += count;
+    }
+
+    return written;
+}
+
+
 int filter_streambuf::sync()
 {
     auto result = overflow(traits_type::eof());
 
     // flush buffer on output
     if (filebuf && mode & ios_base::out) {
-        streamsize converted = do_callback();
-        filebuf->sputn(out_buffer, converted);
+        drain();
         filebuf->pubsync();
     }
 
@@ -76,11 +76,13 @@ protected:
     // ----------------
     virtual int_type underflow();
     virtual int_type overflow(int_type = traits_type::eof());
+    virtual streamsize xsputn(const char_type*, streamsize);
     virtual int sync();
 
 private:
     void set_pointers();
     streamsize do_callback();
+    void drain();
 
     friend class filter_istream;
     friend class filter_ostream;
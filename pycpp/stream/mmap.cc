@@ -4,6 +4,7 @@
 #include <pycpp/filesystem.h>
 #include <pycpp/filesystem/exception.h>
 #include <pycpp/preprocessor/architecture.h>
+#include <pycpp/stl/algorithm.h>
 #include <pycpp/stream/mmap.h>
 #include <assert.h>
 
@@ -11,6 +12,8 @@
 
 #if defined(HAVE_MMAP)
 #   include <sys/mman.h>
+#   include <fcntl.h>
+#   include <unistd.h>
 #   include <pycpp/preprocessor/sysstat.h>
 #elif defined(OS_WINDOWS)
 #   include <pycpp/windows/mman.h>
@@ -19,13 +22,18 @@
 
 PYCPP_BEGIN_NAMESPACE
 
+// VARIABLES
+// ---------
+
+size_t MMAP_WINDOW_SIZE = 16 << 20;
+
 // HELPERS
 // -------
 
 
 #if defined(OS_POSIX)                   // POSIX
 
-static size_t file_length(fd_t fd)
+size_t file_length(fd_t fd)
 {
     struct stat sb;
     if (::fstat(fd, &sb) == -1) {
@@ -36,7 +44,7 @@ static size_t file_length(fd_t fd)
 
 #elif defined(OS_WINDOWS)               // WINDOWS
 
-static size_t file_length(fd_t fd)
+size_t file_length(fd_t fd)
 {
     LARGE_INTEGER bytes;
     if (!::GetFileSizeEx(fd, &bytes)) {
@@ -64,22 +72,172 @@ static int convert_prot(ios_base::openmode mode)
 }
 
 
-static void* open_memory_view(fd_t fd, ios_base::openmode mode, size_t offset, size_t length)
+size_t allocation_granularity()
+{
+#if defined(OS_WINDOWS)
+    SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+#else
+    static long page_size = ::sysconf(_SC_PAGESIZE);
+    return page_size > 0 ? static_cast<size_t>(page_size) : 4096;
+#endif
+}
+
+
+static mmap_advice access_advice(io_access_pattern access)
+{
+    switch (access) {
+        case access_sequential:
+            return mmap_sequential;
+        case access_random:
+            return mmap_random;
+        default:
+            return mmap_normal;
+    }
+}
+
+
+bool advise_memory_view(void* addr, size_t length, mmap_advice advice)
+{
+#if defined(HAVE_MADVISE)
+    // madvise requires a page-aligned address
+    size_t page = allocation_granularity();
+    uintptr_t first = reinterpret_cast<uintptr_t>(addr);
+    uintptr_t aligned = first - first % page;
+    length += first - aligned;
+
+    int flag;
+    switch (advice) {
+        case mmap_sequential:
+            flag = MADV_SEQUENTIAL;
+            break;
+        case mmap_random:
+            flag = MADV_RANDOM;
+            break;
+        case mmap_willneed:
+            flag = MADV_WILLNEED;
+            break;
+        case mmap_dontneed:
+            flag = MADV_DONTNEED;
+            break;
+        default:
+            flag = MADV_NORMAL;
+            break;
+    }
+    return ::madvise(reinterpret_cast<void*>(aligned), length, flag) == 0;
+#else
+    return advice == mmap_normal;
+#endif
+}
+
+
+#if !defined(MAP_POPULATE)                              // !POPULATE
+
+/**
+ *  \brief Fault in every page of a mapping.
+ */
+static void prefault_memory_view(void* addr, size_t length)
+{
+    volatile const char* data = reinterpret_cast<const char*>(addr);
+    size_t page = allocation_granularity();
+    for (size_t i = 0; i < length; i += page) {
+        (void) data[i];
+    }
+}
+
+#endif                                                  // !POPULATE
+
+
+#if defined(HAVE_MADVISE) && defined(MADV_HUGEPAGE)     // HUGEPAGE
+
+static constexpr size_t HUGE_PAGE_SIZE = 2 << 20;
+
+/**
+ *  \brief Reserve address space for a file mapping backed by huge pages.
+ *
+ *  A huge page can only map a file if the address and the file
+ *  offset are congruent modulo the huge page size.
+ */
+static void* reserve_huge_pages(size_t offset, size_t length)
+{
+    // trim whole pages, since munmap requires a page-aligned address
+    size_t page = allocation_granularity();
+    length = (length + page - 1) / page * page;
+    size_t size = length + HUGE_PAGE_SIZE;
+    void* ptr = ::mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return nullptr;
+    }
+
+    uintptr_t first = reinterpret_cast<uintptr_t>(ptr);
+    size_t shift = (offset % HUGE_PAGE_SIZE + HUGE_PAGE_SIZE - first % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE;
+    char* aligned = reinterpret_cast<char*>(ptr) + shift;
+    size_t tail = size - shift - length;
+    if (shift && ::munmap(ptr, shift) != 0) {
+        ::munmap(ptr, size);
+        return nullptr;
+    }
+    if (tail && ::munmap(aligned + length, tail) != 0) {
+        ::munmap(aligned, size - shift);
+        return nullptr;
+    }
+    return aligned;
+}
+
+#endif                                                  // HUGEPAGE
+
+
+void* open_memory_view(fd_t fd, ios_base::openmode mode, size_t offset, size_t length, const mmap_options& options)
 {
+    int flags = MAP_SHARED;
+    void* hint = nullptr;
+#if defined(MAP_POPULATE)
+    if (options.populate) {
+        flags |= MAP_POPULATE;
+    }
+#endif
+#if defined(HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+    if (options.huge_pages) {
+        hint = reserve_huge_pages(offset, length);
+        if (hint) {
+            flags |= MAP_FIXED;
+        }
+    }
+#endif
+
 #if defined(OS_WINDOWS)
     int fd_ = _open_osfhandle((intptr_t) fd, 0);
-    void* addr = ::mmap(nullptr, length, convert_prot(mode), MAP_SHARED, fd_, offset);
+    void* addr = ::mmap(hint, length, convert_prot(mode), flags, fd_, offset);
 #else
-    void* addr = ::mmap(nullptr, length, convert_prot(mode), MAP_SHARED, fd, offset);
+    void* addr = ::mmap(hint, length, convert_prot(mode), flags, fd, offset);
 #endif
     if (addr == MAP_FAILED) {
+        if (hint) {
+            ::munmap(hint, length);
+        }
         return nullptr;
     }
+
+#if defined(HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+    if (options.huge_pages) {
+        ::madvise(addr, length, MADV_HUGEPAGE);
+    }
+#endif
+    if (options.advice != mmap_normal) {
+        advise_memory_view(addr, length, options.advice);
+    }
+#if !defined(MAP_POPULATE)
+    if (options.populate) {
+        prefault_memory_view(addr, length);
+    }
+#endif
+
     return addr;
 }
 
 
-static int memory_sync(void *addr, size_t length, bool async)
+int memory_sync(void *addr, size_t length, bool async)
 {
     // on modern Linux, MS_ASYNC is a no-op, however,
     // it still should be used for futureproofing
@@ -88,7 +246,7 @@ static int memory_sync(void *addr, size_t length, bool async)
 }
 
 
-static int close_memory_view(void *addr, size_t length)
+int close_memory_view(void *addr, size_t length)
 {
     return ::munmap(addr, length);
 }
@@ -96,6 +254,15 @@ static int close_memory_view(void *addr, size_t length)
 // OBJECTS
 // -------
 
+// OPTIONS
+
+
+mmap_options::mmap_options(mmap_advice advice, bool populate, bool huge_pages):
+    advice(advice),
+    populate(populate),
+    huge_pages(huge_pages)
+{}
+
 // MMAP FSTREAM
 
 mmap_fstream::mmap_fstream():
@@ -124,50 +291,52 @@ mmap_fstream & mmap_fstream::operator=(mmap_fstream&& rhs)
 }
 
 
-mmap_fstream::mmap_fstream(const string_view& name, ios_base::openmode mode):
+mmap_fstream::mmap_fstream(const string_view& name, ios_base::openmode mode, io_access_pattern access):
     buffer(ios_base::in | ios_base::out, INVALID_FD_VALUE),
     iostream(&buffer)
 {
-    open(name, mode);
+    open(name, mode, access);
 }
 
 
-void mmap_fstream::open(const string_view& name, ios_base::openmode mode)
+void mmap_fstream::open(const string_view& name, ios_base::openmode mode, io_access_pattern access)
 {
     close();
     mode |= ios_base::in | ios_base::out;
-    buffer.fd(fd_open(name, mode, S_IWR_USR_GRP, access_random));
+    buffer.fd(fd_open(name, mode, S_IWR_USR_GRP, access));
+    access_ = access;
 }
 
 #if defined(HAVE_WFOPEN)                        // WINDOWS
 
-mmap_fstream::mmap_fstream(const wstring_view& name, ios_base::openmode mode):
+mmap_fstream::mmap_fstream(const wstring_view& name, ios_base::openmode mode, io_access_pattern access):
     buffer(ios_base::in | ios_base::out, INVALID_FD_VALUE),
     iostream(&buffer)
 {
-    open(name, mode);
+    open(name, mode, access);
 }
 
 
-void mmap_fstream::open(const wstring_view& name, ios_base::openmode mode)
+void mmap_fstream::open(const wstring_view& name, ios_base::openmode mode, io_access_pattern access)
 {
-    open(reinterpret_cast<const char16_t*>(name.data()), mode);
+    open(reinterpret_cast<const char16_t*>(name.data()), mode, access);
 }
 
 
-mmap_fstream::mmap_fstream(const u16string_view& name, ios_base::openmode mode):
+mmap_fstream::mmap_fstream(const u16string_view& name, ios_base::openmode mode, io_access_pattern access):
     buffer(ios_base::in | ios_base::out, INVALID_FD_VALUE),
     iostream(&buffer)
 {
-    open(name, mode);
+    open(name, mode, access);
 }
 
 
-void mmap_fstream::open(const u16string_view& name, ios_base::openmode mode)
+void mmap_fstream::open(const u16string_view& name, ios_base::openmode mode, io_access_pattern access)
 {
     close();
     mode |= ios_base::in | ios_base::out;
-    buffer.fd(fd_open(name, mode, S_IWR_USR_GRP, access_random));
+    buffer.fd(fd_open(name, mode, S_IWR_USR_GRP, access));
+    access_ = access;
 }
 
 #endif                                          // WINDOWS
@@ -202,6 +371,7 @@ void mmap_fstream::swap(mmap_fstream& rhs)
     swap(buffer, rhs.buffer);
     swap(data_, rhs.data_);
     swap(length_, rhs.length_);
+    swap(access_, rhs.access_);
 }
 
 
@@ -246,6 +416,12 @@ void mmap_fstream::map(size_t o)
 
 
 void mmap_fstream::map(size_t o, size_t l)
+{
+    map(o, l, mmap_options(access_advice(access_)));
+}
+
+
+void mmap_fstream::map(size_t o, size_t l, const mmap_options& options)
 {
     // cleanup existing memory
     unmap();
@@ -260,13 +436,26 @@ void mmap_fstream::map(size_t o, size_t l)
 
     // map memory
     ios_base::openmode mode = ios_base::in | ios_base::out;
-    data_ = reinterpret_cast<char*>(open_memory_view(buffer.fd(), mode, o, l));
+    data_ = reinterpret_cast<char*>(open_memory_view(buffer.fd(), mode, o, l, options));
     if (data_) {
         length_ = l;
     }
 }
 
 
+bool mmap_fstream::advise(mmap_advice advice)
+{
+    return advise(advice, 0, length_);
+}
+
+
+bool mmap_fstream::advise(mmap_advice advice, size_t o, size_t l)
+{
+    assert(o + l <= length_ && "Range must be within the mapping.");
+    return data_ && advise_memory_view(data_ + o, l, advice);
+}
+
+
 void mmap_fstream::unmap()
 {
     // unmap
@@ -313,50 +502,52 @@ mmap_ifstream & mmap_ifstream::operator=(mmap_ifstream&& rhs)
 }
 
 
-mmap_ifstream::mmap_ifstream(const string_view& name, ios_base::openmode mode):
+mmap_ifstream::mmap_ifstream(const string_view& name, ios_base::openmode mode, io_access_pattern access):
     buffer(ios_base::in, INVALID_FD_VALUE),
     istream(&buffer)
 {
-    open(name, mode);
+    open(name, mode, access);
 }
 
 
-void mmap_ifstream::open(const string_view& name, ios_base::openmode mode)
+void mmap_ifstream::open(const string_view& name, ios_base::openmode mode, io_access_pattern access)
 {
     close();
     mode |= ios_base::in;
-    buffer.fd(fd_open(name, mode, S_IWR_USR_GRP, access_random));
+    buffer.fd(fd_open(name, mode, S_IWR_USR_GRP, access));
+    access_ = access;
 }
 
 #if defined(HAVE_WFOPEN)                        // WINDOWS
 
-mmap_ifstream::mmap_ifstream(const wstring_view& name, ios_base::openmode mode):
+mmap_ifstream::mmap_ifstream(const wstring_view& name, ios_base::openmode mode, io_access_pattern access):
     buffer(ios_base::in, INVALID_FD_VALUE),
     istream(&buffer)
 {
-    open(name, mode);
+    open(name, mode, access);
 }
 
 
-void mmap_ifstream::open(const wstring_view& name, ios_base::openmode mode)
+void mmap_ifstream::open(const wstring_view& name, ios_base::openmode mode, io_access_pattern access)
 {
-    open(reinterpret_cast<const char16_t*>(name.data()), mode);
+    open(reinterpret_cast<const char16_t*>(name.data()), mode, access);
 }
 
 
-mmap_ifstream::mmap_ifstream(const u16string_view& name, ios_base::openmode mode):
+mmap_ifstream::mmap_ifstream(const u16string_view& name, ios_base::openmode mode, io_access_pattern access):
     buffer(ios_base::in, INVALID_FD_VALUE),
     istream(&buffer)
 {
-    open(name, mode);
+    open(name, mode, access);
 }
 
 
-void mmap_ifstream::open(const u16string_view& name, ios_base::openmode mode)
+void mmap_ifstream::open(const u16string_view& name, ios_base::openmode mode, io_access_pattern access)
 {
     close();
     mode |= ios_base::in;
-    buffer.fd(fd_open(name, mode, S_IWR_USR_GRP, access_random));
+    buffer.fd(fd_open(name, mode, S_IWR_USR_GRP, access));
+    access_ = access;
 }
 
 #endif                                          // WINDOWS
@@ -391,6 +582,7 @@ void mmap_ifstream::swap(mmap_ifstream& rhs)
     swap(buffer, rhs.buffer);
     swap(data_, rhs.data_);
     swap(length_, rhs.length_);
+    swap(access_, rhs.access_);
 }
 
 
@@ -427,6 +619,12 @@ void mmap_ifstream::map(size_t o)
 
 
 void mmap_ifstream::map(size_t o, size_t l)
+{
+    map(o, l, mmap_options(access_advice(access_)));
+}
+
+
+void mmap_ifstream::map(size_t o, size_t l, const mmap_options& options)
 {
     // cleanup
     unmap();
@@ -434,13 +632,26 @@ void mmap_ifstream::map(size_t o, size_t l)
     // Note: read-only, cannot map beyond file.
     // map memory
     ios_base::openmode mode = ios_base::in;
-    data_ = reinterpret_cast<char*>(open_memory_view(buffer.fd(), mode, o, l));
+    data_ = reinterpret_cast<char*>(open_memory_view(buffer.fd(), mode, o, l, options));
     if (data_) {
         length_ = l;
     }
 }
 
 
+bool mmap_ifstream::advise(mmap_advice advice)
+{
+    return advise(advice, 0, length_);
+}
+
+
+bool mmap_ifstream::advise(mmap_advice advice, size_t o, size_t l)
+{
+    assert(o + l <= length_ && "Range must be within the mapping.");
+    return data_ && advise_memory_view(data_ + o, l, advice);
+}
+
+
 void mmap_ifstream::unmap()
 {
     // unmap
@@ -488,56 +699,58 @@ mmap_ofstream & mmap_ofstream::operator=(mmap_ofstream&& rhs)
 }
 
 
-mmap_ofstream::mmap_ofstream(const string_view& name, ios_base::openmode mode):
+mmap_ofstream::mmap_ofstream(const string_view& name, ios_base::openmode mode, io_access_pattern access):
     // Linux and Windows require read/write access for mmap
     // Lie about the underlying fd and just provide write methods
     buffer(ios_base::in | ios_base::out, INVALID_FD_VALUE),
     ostream(&buffer)
 {
-    open(name, mode);
+    open(name, mode, access);
 }
 
 
-void mmap_ofstream::open(const string_view& name, ios_base::openmode mode)
+void mmap_ofstream::open(const string_view& name, ios_base::openmode mode, io_access_pattern access)
 {
     close();
     mode |= ios_base::in | ios_base::out;
-    buffer.fd(fd_open(name, mode, S_IWR_USR_GRP, access_random));
+    buffer.fd(fd_open(name, mode, S_IWR_USR_GRP, access));
+    access_ = access;
 }
 
 #if defined(HAVE_WFOPEN)                        // WINDOWS
 
-mmap_ofstream::mmap_ofstream(const wstring_view& name, ios_base::openmode mode):
+mmap_ofstream::mmap_ofstream(const wstring_view& name, ios_base::openmode mode, io_access_pattern access):
     // Linux and Windows require read/write access for mmap
     // Lie about the underlying fd and just provide write methods
     buffer(ios_base::in | ios_base::out, INVALID_FD_VALUE),
     ostream(&buffer)
 {
-    open(name, mode);
+    open(name, mode, access);
 }
 
 
-void mmap_ofstream::open(const wstring_view& name, ios_base::openmode mode)
+void mmap_ofstream::open(const wstring_view& name, ios_base::openmode mode, io_access_pattern access)
 {
-    open(reinterpret_cast<const char16_t*>(name.data()), mode);
+    open(reinterpret_cast<const char16_t*>(name.data()), mode, access);
 }
 
 
-mmap_ofstream::mmap_ofstream(const u16string_view& name, ios_base::openmode mode):
+mmap_ofstream::mmap_ofstream(const u16string_view& name, ios_base::openmode mode, io_access_pattern access):
     // Linux and Windows require read/write access for mmap
     // Lie about the underlying fd and just provide write methods
     buffer(ios_base::in | ios_base::out, INVALID_FD_VALUE),
     ostream(&buffer)
 {
-    open(name, mode);
+    open(name, mode, access);
 }
 
 
-void mmap_ofstream::open(const u16string_view& name, ios_base::openmode mode)
+void mmap_ofstream::open(const u16string_view& name, ios_base::openmode mode, io_access_pattern access)
 {
     close();
     mode |= ios_base::in | ios_base::out;
-    buffer.fd(fd_open(name, mode, S_IWR_USR_GRP, access_random));
+    buffer.fd(fd_open(name, mode, S_IWR_USR_GRP, access));
+    access_ = access;
 }
 
 #endif                                          // WINDOWS
@@ -572,6 +785,7 @@ void mmap_ofstream::swap(mmap_ofstream& rhs)
     swap(buffer, rhs.buffer);
     swap(data_, rhs.data_);
     swap(length_, rhs.length_);
+    swap(access_, rhs.access_);
 }
 
 
@@ -608,6 +822,12 @@ void mmap_ofstream::map(size_t o)
 
 
 void mmap_ofstream::map(size_t o, size_t l)
+{
+    map(o, l, mmap_options(access_advice(access_)));
+}
+
+
+void mmap_ofstream::map(size_t o, size_t l, const mmap_options& options)
 {
     // cleanup
     unmap();
@@ -624,13 +844,26 @@ void mmap_ofstream::map(size_t o, size_t l)
     // Linux and Windows require read/write access for mmap
     // Lie about the underlying fd and just provide write methods
     ios_base::openmode mode = ios_base::in | ios_base::out;
-    data_ = reinterpret_cast<char*>(open_memory_view(buffer.fd(), mode, o, l));
+    data_ = reinterpret_cast<char*>(open_memory_view(buffer.fd(), mode, o, l, options));
     if (data_) {
         length_ = l;
     }
 }
 
 
+bool mmap_ofstream::advise(mmap_advice advice)
+{
+    return advise(advice, 0, length_);
+}
+
+
+bool mmap_ofstream::advise(mmap_advice advice, size_t o, size_t l)
+{
+    assert(o + l <= length_ && "Range must be within the mapping.");
+    return data_ && advise_memory_view(data_ + o, l, advice);
+}
+
+
 void mmap_ofstream::unmap()
 {
     // unmap
@@ -648,6 +881,288 @@ void mmap_ofstream::flush(bool async)
     memory_sync(data_, length_, async);
 }
 
+// MMAP WINDOW STREAMBUF
+
+
+mmap_window_streambuf::mmap_window_streambuf(fd_t fd, size_t window, const mmap_options& options):
+    options_(options)
+{
+    size_t granularity = allocation_granularity();
+    window_ = max(window, granularity);
+    window_ += (granularity - window_ % granularity) % granularity;
+    this->fd(fd);
+}
+
+
+mmap_window_streambuf::mmap_window_streambuf(mmap_window_streambuf&& rhs):
+    mmap_window_streambuf(INVALID_FD_VALUE, rhs.window_, rhs.options_)
+{
+    swap(rhs);
+}
+
+
+mmap_window_streambuf& mmap_window_streambuf::operator=(mmap_window_streambuf&& rhs)
+{
+    swap(rhs);
+    return *this;
+}
+
+
+mmap_window_streambuf::~mmap_window_streambuf()
+{
+    unmap();
+}
+
+
+void mmap_window_streambuf::close()
+{
+    unmap();
+}
+
+
+bool mmap_window_streambuf::is_open() const
+{
+    return fd_ != INVALID_FD_VALUE;
+}
+
+
+void mmap_window_streambuf::swap(mmap_window_streambuf& rhs)
+{
+    using PYCPP_NAMESPACE::swap;
+
+    swap(fd_, rhs.fd_);
+    swap(window_, rhs.window_);
+    swap(options_, rhs.options_);
+    swap(offset_, rhs.offset_);
+    swap(data_, rhs.data_);
+    swap(length_, rhs.length_);
+    streambuf::swap(rhs);
+}
+
+
+fd_t mmap_window_streambuf::fd() const
+{
+    return fd_;
+}
+
+
+void mmap_window_streambuf::fd(fd_t fd)
+{
+    unmap();
+    fd_ = fd;
+    offset_ = 0;
+}
+
+
+size_t mmap_window_streambuf::window() const
+{
+    return window_;
+}
+
+
+auto mmap_window_streambuf::underflow() -> int_type
+{
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    } else if (fd_ == INVALID_FD_VALUE) {
+        return traits_type::eof();
+    }
+
+    // the file may have grown since the window was mapped
+    size_t position = offset_ + (gptr() - eback());
+    if (position >= file_length(fd_) || !load(position)) {
+        return traits_type::eof();
+    }
+    return traits_type::to_int_type(*gptr());
+}
+
+
+auto mmap_window_streambuf::seekoff(off_type off, ios_base::seekdir way, ios_base::openmode openmode) -> pos_type
+{
+    if (fd_ == INVALID_FD_VALUE) {
+        return pos_type(off_type(-1));
+    }
+
+    off_type position;
+    switch (way) {
+        case ios_base::beg:
+            position = off;
+            break;
+        case ios_base::cur:
+            position = offset_ + (gptr() - eback()) + off;
+            break;
+        case ios_base::end:
+            position = file_length(fd_) + off;
+            break;
+        default:
+            return pos_type(off_type(-1));
+    }
+
+    return seekpos(position, openmode);
+}
+
+
+auto mmap_window_streambuf::seekpos(pos_type pos, ios_base::openmode) -> pos_type
+{
+    off_type position = pos;
+    if (fd_ == INVALID_FD_VALUE || position < 0) {
+        return pos_type(off_type(-1));
+    }
+
+    // seeking within the window keeps the mapping
+    size_t offset = static_cast<size_t>(position);
+    if (data_ && offset >= offset_ && offset <= offset_ + length_) {
+        setg(data_, data_ + (offset - offset_), data_ + length_);
+        return pos;
+    }
+
+    // map lazily, on the next read
+    unmap();
+    offset_ = offset;
+    return pos;
+}
+
+
+bool mmap_window_streambuf::load(size_t position)
+{
+    unmap();
+    size_t size = file_length(fd_);
+    size_t first = position - position % window_;
+    size_t length = min(window_, size - first);
+    void* addr = open_memory_view(fd_, ios_base::in, first, length, options_);
+    if (!addr) {
+        offset_ = position;
+        return false;
+    }
+
+    data_ = reinterpret_cast<char*>(addr);
+    length_ = length;
+    offset_ = first;
+    setg(data_, data_ + (position - first), data_ + length);
+
+#if defined(HAVE_POSIX_FADVISE)
+    // start reading the next window while this one is consumed
+    size_t next = first + length;
+    if (next < size && options_.advice == mmap_sequential) {
+        ::posix_fadvise(fd_, next, min(window_, size - next), POSIX_FADV_WILLNEED);
+    }
+#endif
+
+    return true;
+}
+
+
+void mmap_window_streambuf::unmap()
+{
+    if (data_) {
+        offset_ += gptr() - eback();
+        close_memory_view(data_, length_);
+        data_ = nullptr;
+        length_ = 0;
+        setg(0, 0, 0);
+    }
+}
+
+// MMAP WINDOW IFSTREAM
+
+
+mmap_window_ifstream::mmap_window_ifstream():
+    buffer(INVALID_FD_VALUE),
+    istream(&buffer)
+{}
+
+
+mmap_window_ifstream::~mmap_window_ifstream()
+{
+    close();
+}
+
+
+mmap_window_ifstream::mmap_window_ifstream(mmap_window_ifstream&& rhs):
+    mmap_window_ifstream()
+{
+    swap(rhs);
+}
+
+
+mmap_window_ifstream & mmap_window_ifstream::operator=(mmap_window_ifstream&& rhs)
+{
+    swap(rhs);
+    return *this;
+}
+
+
+mmap_window_ifstream::mmap_window_ifstream(const string_view& name, size_t window, const mmap_options& options):
+    buffer(INVALID_FD_VALUE, window, options),
+    istream(&buffer)
+{
+    open(name, window, options);
+}
+
+
+void mmap_window_ifstream::open(const string_view& name, size_t window, const mmap_options& options)
+{
+    close();
+    mmap_window_streambuf other(fd_open(name, ios_base::in, S_IWR_USR_GRP, access_sequential), window, options);
+    buffer.swap(other);
+}
+
+#if defined(HAVE_WFOPEN)                        // WINDOWS
+
+mmap_window_ifstream::mmap_window_ifstream(const wstring_view& name, size_t window, const mmap_options& options):
+    buffer(INVALID_FD_VALUE, window, options),
+    istream(&buffer)
+{
+    open(name, window, options);
+}
+
+
+void mmap_window_ifstream::open(const wstring_view& name, size_t window, const mmap_options& options)
+{
+    open(reinterpret_cast<const char16_t*>(name.data()), window, options);
+}
+
+
+mmap_window_ifstream::mmap_window_ifstream(const u16string_view& name, size_t window, const mmap_options& options):
+    buffer(INVALID_FD_VALUE, window, options),
+    istream(&buffer)
+{
+    open(name, window, options);
+}
+
+
+void mmap_window_ifstream::open(const u16string_view& name, size_t window, const mmap_options& options)
+{
+    close();
+    mmap_window_streambuf other(fd_open(name, ios_base::in, S_IWR_USR_GRP, access_sequential), window, options);
+    buffer.swap(other);
+}
+
+#endif                                          // WINDOWS
+
+bool mmap_window_ifstream::is_open() const
+{
+    return buffer.is_open();
+}
+
+
+void mmap_window_ifstream::close()
+{
+    if (buffer.fd() != INVALID_FD_VALUE) {
+        fd_t fd = buffer.fd();
+        buffer.fd(INVALID_FD_VALUE);
+        fd_close(fd);
+    }
+}
+
+
+void mmap_window_ifstream::swap(mmap_window_ifstream& rhs)
+{
+    using PYCPP_NAMESPACE::swap;
+    istream::swap(rhs);
+    swap(buffer, rhs.buffer);
+}
+
 PYCPP_END_NAMESPACE
 
 #endif                                                  // MMAP
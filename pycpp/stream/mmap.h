@@ -34,6 +34,20 @@
  *  specific error handlers (setjmp/longjmp on POSIX,
  *  __try/__except on MSVC).
  *
+ *  Mappings take `mmap_options`: access-pattern advice (`madvise`),
+ *  prefaulting the whole mapping up front (`MAP_POPULATE`), and
+ *  transparent huge pages. By default, the advice follows the
+ *  access pattern the file was opened with. Huge pages only back
+ *  file mappings on kernels and filesystems that support them
+ *  (e.g. tmpfs, or read-only mappings with
+ *  `CONFIG_READ_ONLY_THP_FOR_FS`), otherwise the hint is ignored.
+ *
+ *  `mmap_window_ifstream` reads a file sequentially through a
+ *  mapping of a fixed-size window, which is remapped as the reader
+ *  advances, while read-ahead is requested for the next window.
+ *  This bounds the address space used by arbitrarily large files,
+ *  and the reads come straight from the page cache, without copies.
+ *
  *  Due to the underlying OS implementation, all write-only
  *  files (`mmap_ofstream`) are implemented using a read/write
  *  file-descriptor, but contain write-only methods at the
@@ -42,6 +56,7 @@
 
 #pragma once
 
+#include <pycpp/filesystem/access.h>
 #include <pycpp/preprocessor/os.h>
 #include <pycpp/stl/string_view.h>
 #include <pycpp/stream/fd.h>
@@ -50,9 +65,46 @@
 
 PYCPP_BEGIN_NAMESPACE
 
+// VARIABLES
+// ---------
+
+extern size_t MMAP_WINDOW_SIZE;
+
+// ENUMS
+// -----
+
+/**
+ *  \brief Advice on how a mapping will be accessed.
+ */
+enum mmap_advice
+{
+    mmap_normal = 0,
+    mmap_sequential,
+    mmap_random,
+    mmap_willneed,
+    mmap_dontneed,
+};
+
 // OBJECTS
 // -------
 
+/**
+ *  \brief Options for a memory mapping.
+ *
+ *  \param advice           Expected access pattern.
+ *  \param populate         Prefault the whole mapping when mapped.
+ *  \param huge_pages       Request transparent huge pages.
+ */
+struct mmap_options
+{
+    mmap_advice advice;
+    bool populate;
+    bool huge_pages;
+
+    mmap_options(mmap_advice advice = mmap_normal, bool populate = false, bool huge_pages = false);
+};
+
+
 
 /**
  *  \brief Stream wrapping a memory-mapped I/O file.
@@ -67,19 +119,22 @@ public:
     mmap_fstream(mmap_fstream &&other);
     mmap_fstream & operator=(mmap_fstream &&other);
 
-    mmap_fstream(const string_view& name, ios_base::openmode mode = ios_base::in | ios_base::out);
-    void open(const string_view& name, ios_base::openmode mode = ios_base::in | ios_base::out);
+    mmap_fstream(const string_view& name, ios_base::openmode mode = ios_base::in | ios_base::out, io_access_pattern access = access_normal);
+    void open(const string_view& name, ios_base::openmode mode = ios_base::in | ios_base::out, io_access_pattern access = access_normal);
 
 #if defined(HAVE_WFOPEN)                        // WINDOWS
-    mmap_fstream(const wstring_view& name, ios_base::openmode mode = ios_base::in | ios_base::out);
-    void open(const wstring_view& name, ios_base::openmode mode = ios_base::in | ios_base::out);
-    mmap_fstream(const u16string_view& name, ios_base::openmode mode = ios_base::in | ios_base::out);
-    void open(const u16string_view& name, ios_base::openmode mode = ios_base::in | ios_base::out);
+    mmap_fstream(const wstring_view& name, ios_base::openmode mode = ios_base::in | ios_base::out, io_access_pattern access = access_normal);
+    void open(const wstring_view& name, ios_base::openmode mode = ios_base::in | ios_base::out, io_access_pattern access = access_normal);
+    mmap_fstream(const u16string_view& name, ios_base::openmode mode = ios_base::in | ios_base::out, io_access_pattern access = access_normal);
+    void open(const u16string_view& name, ios_base::openmode mode = ios_base::in | ios_base::out, io_access_pattern access = access_normal);
 #endif                                          // WINDOWS
 
     // MAPPING
     void map(size_t offset = 0);
     void map(size_t offset, size_t length);
+    void map(size_t offset, size_t length, const mmap_options& options);
+    bool advise(mmap_advice advice);
+    bool advise(mmap_advice advice, size_t offset, size_t length);
     void unmap();
     void flush(bool async = true);
 
@@ -102,6 +157,7 @@ private:
     fd_streambuf buffer;
     char* data_ = nullptr;
     size_t length_ = 0;
+    io_access_pattern access_ = access_normal;
 };
 
 
@@ -118,19 +174,22 @@ public:
     mmap_ifstream(mmap_ifstream &&other);
     mmap_ifstream & operator=(mmap_ifstream &&other);
 
-    mmap_ifstream(const string_view& name, ios_base::openmode mode = ios_base::in);
-    void open(const string_view& name, ios_base::openmode mode = ios_base::in);
+    mmap_ifstream(const string_view& name, ios_base::openmode mode = ios_base::in, io_access_pattern access = access_normal);
+    void open(const string_view& name, ios_base::openmode mode = ios_base::in, io_access_pattern access = access_normal);
 
 #if defined(HAVE_WFOPEN)                        // WINDOWS
-    mmap_ifstream(const wstring_view& name, ios_base::openmode mode = ios_base::in);
-    void open(const wstring_view& name, ios_base::openmode mode = ios_base::in);
-    mmap_ifstream(const u16string_view& name, ios_base::openmode mode = ios_base::in);
-    void open(const u16string_view& name, ios_base::openmode mode = ios_base::in);
+    mmap_ifstream(const wstring_view& name, ios_base::openmode mode = ios_base::in, io_access_pattern access = access_normal);
+    void open(const wstring_view& name, ios_base::openmode mode = ios_base::in, io_access_pattern access = access_normal);
+    mmap_ifstream(const u16string_view& name, ios_base::openmode mode = ios_base::in, io_access_pattern access = access_normal);
+    void open(const u16string_view& name, ios_base::openmode mode = ios_base::in, io_access_pattern access = access_normal);
 #endif                                          // WINDOWS
 
     // MAPPING
     void map(size_t offset = 0);
     void map(size_t offset, size_t length);
+    void map(size_t offset, size_t length, const mmap_options& options);
+    bool advise(mmap_advice advice);
+    bool advise(mmap_advice advice, size_t offset, size_t length);
     void unmap();
     void flush(bool async = true);
 
@@ -152,6 +211,7 @@ private:
     fd_streambuf buffer;
     char* data_ = nullptr;
     size_t length_ = 0;
+    io_access_pattern access_ = access_normal;
 };
 
 
@@ -168,19 +228,22 @@ public:
     mmap_ofstream(mmap_ofstream &&other);
     mmap_ofstream & operator=(mmap_ofstream &&other);
 
-    mmap_ofstream(const string_view& name, ios_base::openmode mode = ios_base::out);
-    void open(const string_view& name, ios_base::openmode mode = ios_base::out);
+    mmap_ofstream(const string_view& name, ios_base::openmode mode = ios_base::out, io_access_pattern access = access_normal);
+    void open(const string_view& name, ios_base::openmode mode = ios_base::out, io_access_pattern access = access_normal);
 
 #if defined(HAVE_WFOPEN)                        // WINDOWS
-    mmap_ofstream(const wstring_view& name, ios_base::openmode mode = ios_base::out);
-    void open(const wstring_view& name, ios_base::openmode mode = ios_base::out);
-    mmap_ofstream(const u16string_view& name, ios_base::openmode mode = ios_base::out);
-    void open(const u16string_view& name, ios_base::openmode mode = ios_base::out);
+    mmap_ofstream(const wstring_view& name, ios_base::openmode mode = ios_base::out, io_access_pattern access = access_normal);
+    void open(const wstring_view& name, ios_base::openmode mode = ios_base::out, io_access_pattern access = access_normal);
+    mmap_ofstream(const u16string_view& name, ios_base::openmode mode = ios_base::out, io_access_pattern access = access_normal);
+    void open(const u16string_view& name, ios_base::openmode mode = ios_base::out, io_access_pattern access = access_normal);
 #endif                                          // WINDOWS
 
     // MAPPING
     void map(size_t offset = 0);
     void map(size_t offset, size_t length);
+    void map(size_t offset, size_t length, const mmap_options& options);
+    bool advise(mmap_advice advice);
+    bool advise(mmap_advice advice, size_t offset, size_t length);
     void unmap();
     void flush(bool async = true);
 
@@ -202,6 +265,98 @@ private:
     fd_streambuf buffer;
     char* data_ = nullptr;
     size_t length_ = 0;
+    io_access_pattern access_ = access_normal;
+};
+
+
+
+/**
+ *  \brief Streambuffer reading through a sliding memory-mapped window.
+ *
+ *  The get area is the mapped window itself. Windows start at a
+ *  multiple of the allocation granularity, and `window` is rounded
+ *  up to it. The descriptor is not owned.
+ */
+class mmap_window_streambuf: public streambuf
+{
+public:
+    // MEMBER TYPES
+    // ------------
+    using typename streambuf::char_type;
+    using typename streambuf::int_type;
+    using typename streambuf::traits_type;
+    using typename streambuf::off_type;
+    using typename streambuf::pos_type;
+
+    // MEMBER FUNCTIONS
+    // ----------------
+    mmap_window_streambuf(fd_t fd = INVALID_FD_VALUE, size_t window = MMAP_WINDOW_SIZE, const mmap_options& options = mmap_options(mmap_sequential));
+    mmap_window_streambuf(const mmap_window_streambuf&) = delete;
+    mmap_window_streambuf& operator=(const mmap_window_streambuf&) = delete;
+    mmap_window_streambuf(mmap_window_streambuf&&);
+    mmap_window_streambuf& operator=(mmap_window_streambuf&&);
+    virtual ~mmap_window_streambuf();
+
+    // MODIFIERS/PROPERTIES
+    void close();
+    bool is_open() const;
+    void swap(mmap_window_streambuf&);
+    fd_t fd() const;
+    void fd(fd_t fd);
+    size_t window() const;
+
+protected:
+    // MEMBER FUNCTIONS
+    // ----------------
+    virtual int_type underflow();
+    virtual pos_type seekoff(off_type off, ios_base::seekdir way, ios_base::openmode openmode = ios_base::in | ios_base::out);
+    virtual pos_type seekpos(pos_type pos, ios_base::openmode openmode = ios_base::in | ios_base::out);
+
+private:
+    bool load(size_t position);
+    void unmap();
+
+    fd_t fd_ = INVALID_FD_VALUE;
+    size_t window_ = 0;
+    mmap_options options_;
+    size_t offset_ = 0;
+    char* data_ = nullptr;
+    size_t length_ = 0;
+};
+
+
+/**
+ *  \brief Input stream reading through a sliding memory-mapped window.
+ */
+class mmap_window_ifstream: public istream
+{
+public:
+    mmap_window_ifstream();
+    ~mmap_window_ifstream();
+    mmap_window_ifstream(const mmap_window_ifstream&) = delete;
+    mmap_window_ifstream & operator=(const mmap_window_ifstream&) = delete;
+    mmap_window_ifstream(mmap_window_ifstream &&other);
+    mmap_window_ifstream & operator=(mmap_window_ifstream &&other);
+
+    mmap_window_ifstream(const string_view& name, size_t window = MMAP_WINDOW_SIZE, const mmap_options& options = mmap_options(mmap_sequential));
+    void open(const string_view& name, size_t window = MMAP_WINDOW_SIZE, const mmap_options& options = mmap_options(mmap_sequential));
+
+#if defined(HAVE_WFOPEN)                        // WINDOWS
+    mmap_window_ifstream(const wstring_view& name, size_t window = MMAP_WINDOW_SIZE, const mmap_options& options = mmap_options(mmap_sequential));
+    void open(const wstring_view& name, size_t window = MMAP_WINDOW_SIZE, const mmap_options& options = mmap_options(mmap_sequential));
+    mmap_window_ifstream(const u16string_view& name, size_t window = MMAP_WINDOW_SIZE, const mmap_options& options = mmap_options(mmap_sequential));
+    void open(const u16string_view& name, size_t window = MMAP_WINDOW_SIZE, const mmap_options& options = mmap_options(mmap_sequential));
+#endif                                          // WINDOWS
+
+    // PROPERTIES
+    bool is_open() const;
+
+    // MODIFIERS
+    void close();
+    void swap(mmap_window_ifstream &other);
+
+private:
+    mmap_window_streambuf buffer;
 };
 
 PYCPP_END_NAMESPACE
@@ -15,6 +15,7 @@
 #include <pycpp/string/getline.h>
 #include <pycpp/string/hex.h>
 #include <pycpp/string/punycode.h>
+#include <pycpp/string/split.h>
 #include <pycpp/string/string.h>
 #include <pycpp/string/unicode.h>
 #include <pycpp/string/url.h>
@@ -1,7 +1,13 @@
 //  :copyright: (c) 2017 Alex Huszagh.
 //  :license: MIT, see licenses/mit.md for more details.
 
+#include <pycpp/runtime/cpu.h>
+#include <pycpp/stl/stdexcept.h>
 #include <pycpp/string/base16.h>
+#include <stdint.h>
+#if defined(HAVE_X86_SIMD)
+#   include <immintrin.h>
+#endif
 
 PYCPP_BEGIN_NAMESPACE
 
@@ -11,7 +17,7 @@ PYCPP_BEGIN_NAMESPACE
 static constexpr size_t INPUT_INTERVAL = 1;
 static constexpr size_t OUTPUT_INTERVAL = 2;
 static constexpr char ENCODING[] = "0123456789ABCDEF";
-static constexpr char DECODING[] = {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,0,1,2,3,4,5,6,7,8,9,-1,-1,-1,-1,-1,-1,-1,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1};
+static constexpr int8_t DECODING[] = {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,0,1,2,3,4,5,6,7,8,9,-1,-1,-1,-1,-1,-1,-1,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1};
 
 // HELPERS
 // -------
@@ -34,41 +40,321 @@ static size_t decoded_size(size_t length) noexcept
     return length / OUTPUT_INTERVAL;
 }
 
-// CHARACTER
+// HELPERS -- VECTORIZED
+// ---------------------
+
+// Each kernel converts the longest prefix that fits in the destination
+// buffer, returning the number of source bytes consumed. Decoding
+// kernels stop before the first pair with an invalid character.
 
 /**
- *  \brief Encode 1 byte to base16.
+ *  \brief Vectorized kernels for a single instruction set.
  */
-template <typename Iter1, typename Iter2>
-static void encode_base16_message(Iter1 &src, Iter2 &dst) noexcept
+struct base16_kernels
+{
+    size_t (*encode)(const uint8_t* src, size_t srclen, char* dst, size_t dstlen);
+    size_t (*decode)(const char* src, size_t srclen, uint8_t* dst, size_t dstlen);
+};
+
+
+static size_t encode_base16_scalar(const uint8_t* src, size_t srclen, char* dst, size_t dstlen)
+{
+    size_t i = 0;
+    for (; i < srclen && OUTPUT_INTERVAL * i + OUTPUT_INTERVAL <= dstlen; i += INPUT_INTERVAL) {
+        dst[2 * i] = ENCODING[src[i] >> 4];             // First: 11110000
+        dst[2 * i + 1] = ENCODING[src[i] & 0x0f];       // First: 00001111
+    }
+    return i;
+}
+
+
+static size_t decode_base16_scalar(const char* src, size_t srclen, uint8_t* dst, size_t dstlen)
+{
+    size_t i = 0;
+    for (; i + OUTPUT_INTERVAL <= srclen && i / OUTPUT_INTERVAL < dstlen; i += OUTPUT_INTERVAL) {
+        int hi = DECODING[static_cast<uint8_t>(src[i])];
+        int lo = DECODING[static_cast<uint8_t>(src[i + 1])];
+        if ((hi | lo) < 0) {
+            break;
+        }
+        dst[i / OUTPUT_INTERVAL] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return i;
+}
+
+#if defined(HAVE_X86_SIMD)              // HAVE_X86_SIMD
+
+// Encoding splits each byte into nibbles, maps them to digits with a
+// 16-entry shuffle table, and interleaves the results. Decoding
+// range-checks each character as a digit or a case-folded letter,
+// then merges pairs of nibbles with a multiply-add.
+
+// SSE4.1
+
+SIMD_TARGET("sse4.1")
+static size_t encode_base16_sse41(const uint8_t* src, size_t srclen, char* dst, size_t dstlen)
 {
-    *dst++ = ENCODING[(*src & 0xf0) >> 4];          // First: 11110000
-    *dst++ = ENCODING[(*src & 0x0f)];               // First: 00001111
-    ++src;
+    const __m128i lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+    const __m128i mask = _mm_set1_epi8(0x0f);
+
+    size_t i = 0;
+    for (; i + 16 <= srclen && 2 * i + 32 <= dstlen; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return i + encode_base16_scalar(src + i, srclen - i, dst + 2 * i, dstlen - 2 * i);
 }
 
+
 /**
- *  \brief Decode 2 bytes from base16.
+ *  \brief Convert 16 hex digits to nibbles, returning false on any invalid digit.
  */
-template <typename Iter1, typename Iter2>
-static void decode_base16_message(Iter1 &src_first,
-    Iter1 src_last,
-    Iter2 &dst) noexcept
+SIMD_TARGET("sse4.1")
+static inline bool decode_base16_nibbles_sse41(__m128i v, __m128i& nibbles)
+{
+    __m128i digits = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+    __m128i letters = _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+    __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letters, _mm_set1_epi8(5)), letters);
+    if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xFFFF) {
+        return false;
+    }
+    nibbles = _mm_blendv_epi8(_mm_add_epi8(letters, _mm_set1_epi8(10)), digits, is_digit);
+    return true;
+}
+
+
+SIMD_TARGET("sse4.1")
+static size_t decode_base16_sse41(const char* src, size_t srclen, uint8_t* dst, size_t dstlen)
+{
+    const __m128i merge = _mm_set1_epi16(0x0110);
+
+    size_t i = 0;
+    for (; i + 32 <= srclen && i / 2 + 16 <= dstlen; i += 32) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+        if (!decode_base16_nibbles_sse41(a, a) || !decode_base16_nibbles_sse41(b, b)) {
+            break;
+        }
+        a = _mm_maddubs_epi16(a, merge);
+        b = _mm_maddubs_epi16(b, merge);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i / 2), _mm_packus_epi16(a, b));
+    }
+    return i + decode_base16_scalar(src + i, srclen - i, dst + i / 2, dstlen - i / 2);
+}
+
+// AVX2
+
+SIMD_TARGET("avx2")
+static size_t encode_base16_avx2(const uint8_t* src, size_t srclen, char* dst, size_t dstlen)
+{
+    const __m256i lut = _mm256_setr_epi8(
+        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F',
+        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+    );
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+
+    size_t i = 0;
+    for (; i + 32 <= srclen && 2 * i + 64 <= dstlen; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+        __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, mask));
+        // unpack within each lane, then restore the lane order
+        __m256i first = _mm256_unpacklo_epi8(hi, lo);
+        __m256i second = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    return i + encode_base16_sse41(src + i, srclen - i, dst + 2 * i, dstlen - 2 * i);
+}
+
+
+SIMD_TARGET("avx2")
+static inline bool decode_base16_nibbles_avx2(__m256i v, __m256i& nibbles)
+{
+    __m256i digits = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+    __m256i letters = _mm256_sub_epi8(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digits, _mm256_set1_epi8(9)), digits);
+    __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letters, _mm256_set1_epi8(5)), letters);
+    if (_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter)) != -1) {
+        return false;
+    }
+    nibbles = _mm256_blendv_epi8(_mm256_add_epi8(letters, _mm256_set1_epi8(10)), digits, is_digit);
+    return true;
+}
+
+
+SIMD_TARGET("avx2")
+static size_t decode_base16_avx2(const char* src, size_t srclen, uint8_t* dst, size_t dstlen)
 {
-    char buffer[OUTPUT_INTERVAL];
+    const __m256i merge = _mm256_set1_epi16(0x0110);
+
     size_t i = 0;
-    for (; i < OUTPUT_INTERVAL && src_first != src_last; i++, src_first++) {
-        buffer[i] = DECODING[static_cast<int>(*src_first)];
+    for (; i + 64 <= srclen && i / 2 + 32 <= dstlen; i += 64) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+        if (!decode_base16_nibbles_avx2(a, a) || !decode_base16_nibbles_avx2(b, b)) {
+            break;
+        }
+        a = _mm256_maddubs_epi16(a, merge);
+        b = _mm256_maddubs_epi16(b, merge);
+        // packing interleaves the lanes, so restore their order
+        __m256i v = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i / 2), v);
     }
-    for (; i < OUTPUT_INTERVAL; i++) {
-        buffer[i] = DECODING[0];
+    return i + decode_base16_sse41(src + i, srclen - i, dst + i / 2, dstlen - i / 2);
+}
+
+#endif                                  // HAVE_X86_SIMD
+
+
+static base16_kernels select_base16_kernels()
+{
+#if defined(HAVE_X86_SIMD)
+    if (cpu_supports(cpu_avx2)) {
+        return {encode_base16_avx2, decode_base16_avx2};
+    } else if (cpu_supports(cpu_sse41) && cpu_supports(cpu_ssse3)) {
+        return {encode_base16_sse41, decode_base16_sse41};
     }
+#endif
 
-    // First, 11111111, Seconds, 11111111
-    *dst++ = static_cast<char>((buffer[0] << 4) + (buffer[1]));
+    return {encode_base16_scalar, decode_base16_scalar};
 }
 
 
+static const base16_kernels& get_base16_kernels()
+{
+    static const base16_kernels kernels = select_base16_kernels();
+    return kernels;
+}
+
+// HELPERS -- BUFFERS
+// ------------------
+
+
+static void encode_base16_impl(const uint8_t*& src_first,
+    const uint8_t* src_last,
+    char*& dst_first,
+    char* dst_last) noexcept
+{
+    size_t srclen = static_cast<size_t>(src_last - src_first);
+    size_t dstlen = static_cast<size_t>(dst_last - dst_first);
+    size_t read = get_base16_kernels().encode(src_first, srclen, dst_first, dstlen);
+    src_first += read;
+    dst_first += read * OUTPUT_INTERVAL;
+}
+
+
+/**
+ *  \brief Decode base16 to bytes, validating the input.
+ *
+ *  Decoding stops at the first invalid pair, or once the destination
+ *  is full, leaving `src_first` at the start of that pair.
+ *
+ *  \return                 False if the input is malformed.
+ */
+static bool decode_base16_impl(const char*& src_first,
+    const char* src_last,
+    uint8_t*& dst_first,
+    uint8_t* dst_last) noexcept
+{
+    size_t srclen = static_cast<size_t>(src_last - src_first);
+    size_t dstlen = static_cast<size_t>(dst_last - dst_first);
+    size_t read = get_base16_kernels().decode(src_first, srclen, dst_first, dstlen);
+    src_first += read;
+    dst_first += read / OUTPUT_INTERVAL;
+
+    size_t left = static_cast<size_t>(src_last - src_first);
+    return left == 0 || (left >= OUTPUT_INTERVAL && dst_first == dst_last);
+}
+
+// OBJECTS
+// -------
+
+
+void base16_encoder::encode(const void*& src, size_t srclen, void*& dst, size_t dstlen) noexcept
+{
+    auto src_first = static_cast<const uint8_t*>(src);
+    auto dst_first = static_cast<char*>(dst);
+
+    encode_base16_impl(src_first, src_first + srclen, dst_first, dst_first + dstlen);
+
+    src = static_cast<const void*>(src_first);
+    dst = static_cast<void*>(dst_first);
+}
+
+
+bool base16_encoder::flush(void*&, size_t) noexcept
+{
+    return true;
+}
+
+
+void base16_encoder::close() noexcept
+{}
+
+
+void base16_encoder::swap(base16_encoder&) noexcept
+{}
+
+
+void base16_decoder::decode(const void*& src, size_t srclen, void*& dst, size_t dstlen)
+{
+    auto src_first = static_cast<const char*>(src);
+    auto src_last = src_first + srclen;
+    auto dst_first = static_cast<uint8_t*>(dst);
+    auto dst_last = dst_first + dstlen;
+
+    // complete a pair split across calls
+    if (size_ != 0 && src_first < src_last && dst_first < dst_last) {
+        buffer_[size_++] = *src_first++;
+        const char* first = buffer_;
+        if (!decode_base16_impl(first, buffer_ + size_, dst_first, dst_last)) {
+            throw runtime_error("Invalid base16 data.");
+        }
+        size_ = 0;
+    }
+
+    // decode whole pairs, and buffer the remainder
+    if (size_ == 0) {
+        const char* last = src_first + (src_last - src_first) / OUTPUT_INTERVAL * OUTPUT_INTERVAL;
+        if (!decode_base16_impl(src_first, last, dst_first, dst_last)) {
+            throw runtime_error("Invalid base16 data.");
+        } else if (src_first == last && last != src_last) {
+            buffer_[size_++] = *src_first++;
+        }
+    }
+
+    src = static_cast<const void*>(src_first);
+    dst = static_cast<void*>(dst_first);
+}
+
+
+bool base16_decoder::flush(void*&, size_t)
+{
+    if (size_ != 0) {
+        throw runtime_error("Truncated base16 data.");
+    }
+    return true;
+}
+
+
+void base16_decoder::close() noexcept
+{
+    size_ = 0;
+}
+
+
+void base16_decoder::swap(base16_decoder& rhs) noexcept
+{
+    using PYCPP_NAMESPACE::swap;
+    swap(buffer_, rhs.buffer_);
+    swap(size_, rhs.size_);
+}
+
 // FUNCTIONS
 // ---------
 
@@ -79,14 +365,10 @@ void base16_encode(const void*& src,
     size_t dstlen,
     const byte_allocator&) noexcept
 {
-    auto src_first = reinterpret_cast<const char*>(src);
-    auto src_last = src_first + srclen;
-    auto dst_first = reinterpret_cast<char*>(dst);
-    auto dst_last = dst_first + dstlen;
+    auto src_first = static_cast<const uint8_t*>(src);
+    auto dst_first = static_cast<char*>(dst);
 
-    for (; src_first < src_last && dst_first + OUTPUT_INTERVAL <= dst_last; ) {
-        encode_base16_message(src_first, dst_first);
-    }
+    encode_base16_impl(src_first, src_first + srclen, dst_first, dst_first + dstlen);
 
     src = static_cast<const void*>(src_first);
     dst = static_cast<void*>(dst_first);
@@ -100,13 +382,10 @@ string base16_encode(const string_wrapper& str,
     char_allocator alloc(allocator);
 
     string base16(alloc);
-    base16.reserve(encoded_size(str.size()));
-    auto first = str.begin();
-    auto last = str.end();
-    auto dst = back_inserter(base16);
-    for (; first != last; ) {
-        encode_base16_message(first, dst);
-    }
+    base16.resize(encoded_size(str.size()));
+    auto src_first = reinterpret_cast<const uint8_t*>(str.data());
+    auto dst_first = &base16[0];
+    encode_base16_impl(src_first, src_first + str.size(), dst_first, dst_first + base16.size());
 
     return base16;
 }
@@ -118,14 +397,10 @@ void base16_decode(const void*& src,
     size_t dstlen,
     const byte_allocator&) noexcept
 {
-    auto src_first = reinterpret_cast<const char*>(src);
-    auto src_last = src_first + srclen;
-    auto dst_first = reinterpret_cast<char*>(dst);
-    auto dst_last = dst_first + dstlen;
+    auto src_first = static_cast<const char*>(src);
+    auto dst_first = static_cast<uint8_t*>(dst);
 
-    for (; src_first + OUTPUT_INTERVAL <= src_last && dst_first < dst_last; ) {
-        decode_base16_message(src_first, src_last, dst_first);
-    }
+    decode_base16_impl(src_first, src_first + srclen, dst_first, dst_first + dstlen);
 
     src = static_cast<const void*>(src_first);
     dst = static_cast<void*>(dst_first);
@@ -138,13 +413,16 @@ string base16_decode(const string_wrapper& str,
     using char_allocator = allocator_traits<byte_allocator>::template rebind_alloc<char>;
     char_allocator alloc(allocator);
 
+    if (str.size() % OUTPUT_INTERVAL != 0) {
+        throw runtime_error("Truncated base16 data.");
+    }
+
     string base16(alloc);
-    base16.reserve(decoded_size(str.size()));
-    auto first = str.begin();
-    auto last = str.end();
-    auto dst = back_inserter(base16);
-    for (; first != last; ) {
-        decode_base16_message(first, last, dst);
+    base16.resize(decoded_size(str.size()));
+    auto src_first = str.data();
+    auto dst_first = reinterpret_cast<uint8_t*>(&base16[0]);
+    if (!decode_base16_impl(src_first, src_first + str.size(), dst_first, dst_first + base16.size())) {
+        throw runtime_error("Invalid base16 data.");
     }
 
     return base16;
@@ -4,7 +4,31 @@
  *  \addtogroup PyCPP
  *  \brief Base16 encoding and decoding routines.
  *
+ *  Encoding and decoding are vectorized on processors supporting
+ *  SSE4.1 or AVX2, selected at runtime. Encoding uses uppercase
+ *  digits, while decoding accepts either case, and is strict: any
+ *  other character, or a truncated pair, is an error.
+ *
+ *  `base16_encoder` and `base16_decoder` convert data incrementally,
+ *  for use with filtering streams.
+ *
  *  \synopsis
+ *      struct base16_encoder
+ *      {
+ *          void encode(const void*& src, size_t srclen, void*& dst, size_t dstlen) noexcept;
+ *          bool flush(void*& dst, size_t dstlen) noexcept;
+ *          void close() noexcept;
+ *          void swap(base16_encoder&) noexcept;
+ *      };
+ *
+ *      struct base16_decoder
+ *      {
+ *          void decode(const void*& src, size_t srclen, void*& dst, size_t dstlen);
+ *          bool flush(void*& dst, size_t dstlen);
+ *          void close() noexcept;
+ *          void swap(base16_decoder&) noexcept;
+ *      };
+ *
  *      void base16_encode(const void*& src,
  *          size_t srclen,
  *          void*& dst,
@@ -30,6 +54,41 @@
 
 PYCPP_BEGIN_NAMESPACE
 
+// OBJECTS
+// -------
+
+/**
+ *  \brief Incremental base16 encoder.
+ */
+struct base16_encoder
+{
+public:
+    void encode(const void*& src, size_t srclen, void*& dst, size_t dstlen) noexcept;
+    bool flush(void*& dst, size_t dstlen) noexcept;
+    void close() noexcept;
+    void swap(base16_encoder&) noexcept;
+};
+
+
+/**
+ *  \brief Incremental base16 decoder.
+ *
+ *  A character that does not complete a pair is buffered between
+ *  calls. Throws `runtime_error` on malformed input.
+ */
+struct base16_decoder
+{
+public:
+    void decode(const void*& src, size_t srclen, void*& dst, size_t dstlen);
+    bool flush(void*& dst, size_t dstlen);
+    void close() noexcept;
+    void swap(base16_decoder&) noexcept;
+
+private:
+    char buffer_[2];
+    size_t size_ = 0;
+};
+
 // FUNCTIONS
 // ---------
 
@@ -60,6 +119,9 @@ string base16_encode(const string_wrapper& str,
 /**
   *\brief Decode buffer from base16.
  *
+ *  Decoding stops at the first invalid pair, leaving `src` at the
+ *  start of that pair.
+ *
  *  \param src              Pointer to source buffer.
  *  \param srclen           Length of source buffer.
  *  \param src              Pointer to destination buffer.
@@ -75,6 +137,8 @@ void base16_decode(const void*& src,
 /**
   *\brief Decode string from base16.
  *
+ *  Throws `runtime_error` on malformed input.
+ *
  *  \param str              Source string to encode.
  *  \param allocator        Allocator for output string.
  */
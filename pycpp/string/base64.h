@@ -4,7 +4,31 @@
  *  \addtogroup PyCPP
  *  \brief Base64 encoding and decoding routines.
  *
+ *  Encoding and decoding are vectorized on processors supporting
+ *  SSE4.1 or AVX2, selected at runtime. Decoding is strict: any
+ *  character outside the alphabet, or padding before the final
+ *  quantum, is an error. The final quantum may be unpadded.
+ *
+ *  `base64_encoder` and `base64_decoder` convert data incrementally,
+ *  for use with filtering streams.
+ *
  *  \synopsis
+ *      struct base64_encoder
+ *      {
+ *          void encode(const void*& src, size_t srclen, void*& dst, size_t dstlen) noexcept;
+ *          bool flush(void*& dst, size_t dstlen) noexcept;
+ *          void close() noexcept;
+ *          void swap(base64_encoder&) noexcept;
+ *      };
+ *
+ *      struct base64_decoder
+ *      {
+ *          void decode(const void*& src, size_t srclen, void*& dst, size_t dstlen);
+ *          bool flush(void*& dst, size_t dstlen);
+ *          void close() noexcept;
+ *          void swap(base64_decoder&) noexcept;
+ *      };
+ *
  *      void base64_encode(const void*& src,
  *          size_t srclen,
  *          void*& dst,
@@ -30,6 +54,50 @@
 
 PYCPP_BEGIN_NAMESPACE
 
+// OBJECTS
+// -------
+
+/**
+ *  \brief Incremental base64 encoder.
+ *
+ *  Bytes that do not complete a quantum are buffered between calls.
+ *  `flush` writes the final, padded quantum, and should only be
+ *  called once all input has been encoded.
+ */
+struct base64_encoder
+{
+public:
+    void encode(const void*& src, size_t srclen, void*& dst, size_t dstlen) noexcept;
+    bool flush(void*& dst, size_t dstlen) noexcept;
+    void close() noexcept;
+    void swap(base64_encoder&) noexcept;
+
+private:
+    uint8_t buffer_[3];
+    size_t size_ = 0;
+};
+
+
+/**
+ *  \brief Incremental base64 decoder.
+ *
+ *  Characters that do not complete a quantum are buffered between
+ *  calls. Throws `runtime_error` on malformed input.
+ */
+struct base64_decoder
+{
+public:
+    void decode(const void*& src, size_t srclen, void*& dst, size_t dstlen);
+    bool flush(void*& dst, size_t dstlen);
+    void close() noexcept;
+    void swap(base64_decoder&) noexcept;
+
+private:
+    char buffer_[4];
+    size_t size_ = 0;
+    bool finished_ = false;
+};
+
 // FUNCTIONS
 // ---------
 
@@ -62,6 +130,9 @@ string base64_encode(const string_wrapper& str,
 /**
  *  \brief Decode buffer from base64.
  *
+ *  Decoding stops at the first malformed quantum, leaving `src`
+ *  at the start of that quantum.
+ *
  *  \param src              Pointer to source buffer.
  *  \param srclen           Length of source buffer.
  *  \param src              Pointer to destination buffer.
@@ -77,6 +148,8 @@ void base64_decode(const void*& src,
 /**
  *  \brief Decode string from base64.
  *
+ *  Throws `runtime_error` on malformed input.
+ *
  *  \param str              Source string to encode.
  *  \param allocator        Allocator for output string.
  */
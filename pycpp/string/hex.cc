@@ -2,9 +2,10 @@
 //  :license: Unicode, see licenses/unicode.md for more details.
 
 #include <pycpp/preprocessor/byteorder.h>
+#include <pycpp/stl/algorithm.h>
+#include <pycpp/stl/utility.h>
 #include <pycpp/string/base16.h>
 #include <pycpp/string/hex.h>
-#include <string.h>
 
 PYCPP_BEGIN_NAMESPACE
 
@@ -12,43 +13,45 @@ PYCPP_BEGIN_NAMESPACE
 // -------
 
 
+/**
+ *  \brief Encode whole elements at once, then reverse the digit pairs of each element.
+ */
 template <typename Iter1, typename Iter2>
 static void hex_impl(Iter1 &src_first,
     Iter1 src_last,
     Iter2 &dst_first,
     Iter2 dst_last,
-    const byte_allocator& allocator,
+    const byte_allocator&,
     size_t width)
 {
-    // get allocator
-    using char_allocator = allocator_traits<byte_allocator>::template rebind_alloc<char>;
-    char_allocator alloc(allocator);
+    size_t shift = 2 * width;
+    size_t srclen = static_cast<size_t>(distance(src_first, src_last)) / width;
+    size_t dstlen = static_cast<size_t>(distance(dst_first, dst_last)) / shift;
+    size_t count = min(srclen, dstlen);
 
-    void* buffer = nullptr;
-    try {
-        buffer = static_cast<void*>(alloc.allocate(width));
-        const void* b16_src = buffer;
-        void* b16_dst = static_cast<void*>(dst_first);
-        size_t shift = 2 * width;
-        while (src_first < src_last && dst_first + shift <= dst_last) {
-            memcpy(buffer, src_first, width);
-            bswap(buffer, static_cast<int>(width));
-            base16_encode(b16_src, width, b16_dst, shift);
-
-            src_first += width;
-            dst_first += shift;
-            b16_src = buffer;
-        }
-        alloc.deallocate(static_cast<char*>(buffer), width);
-    } catch (...) {
-        if (buffer) {
-            alloc.deallocate(static_cast<char*>(buffer), width);
+    const void* b16_src = static_cast<const void*>(src_first);
+    void* b16_dst = static_cast<void*>(dst_first);
+    base16_encode(b16_src, count * width, b16_dst, count * shift);
+
+    if (width > 1) {
+        for (size_t i = 0; i < count; ++i) {
+            char* first = dst_first + i * shift;
+            char* last = first + shift - 2;
+            for (; first < last; first += 2, last -= 2) {
+                swap(first[0], last[0]);
+                swap(first[1], last[1]);
+            }
         }
-        throw;
     }
+
+    src_first += count * width;
+    dst_first += count * shift;
 }
 
 
+/**
+ *  \brief Decode whole elements at once, then swap the bytes of each element.
+ */
 template <typename Iter1, typename Iter2>
 static void unhex_impl(Iter1 &src_first,
     Iter1 src_last,
@@ -58,15 +61,24 @@ static void unhex_impl(Iter1 &src_first,
     size_t width)
 {
     size_t shift = 2 * width;
+    size_t srclen = static_cast<size_t>(distance(src_first, src_last)) / shift;
+    size_t dstlen = static_cast<size_t>(distance(dst_first, dst_last)) / width;
+    size_t count = min(srclen, dstlen);
+
     const void* b16_src = static_cast<const void*>(src_first);
     void* b16_dst = static_cast<void*>(dst_first);
-    while (src_first + shift <= src_last && dst_first < dst_last) {
-        base16_decode(b16_src, shift, b16_dst, width);
-        bswap(dst_first, static_cast<int>(width));
+    base16_decode(b16_src, count * shift, b16_dst, count * width);
 
-        src_first += shift;
-        dst_first += width;
+    // only keep fully-decoded elements
+    count = static_cast<size_t>(distance(dst_first, static_cast<Iter2>(b16_dst))) / width;
+    if (width > 1) {
+        for (size_t i = 0; i < count; ++i) {
+            bswap(dst_first + i * width, static_cast<int>(width));
+        }
     }
+
+    src_first += count * shift;
+    dst_first += count * width;
 }
 
 // FUNCTIONS
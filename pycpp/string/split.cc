@@ -0,0 +1,102 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/preprocessor/compiler.h>
+#include <pycpp/string/split.h>
+#if (defined(HAVE_GCC) || defined(HAVE_CLANG)) && defined(__SSE2__)
+#   include <emmintrin.h>
+#   define PYCPP_SPLIT_SSE2
+#endif
+
+PYCPP_BEGIN_NAMESPACE
+
+// HELPERS
+// -------
+
+
+static const char* charset_find_scalar(const charset_splitter& splitter, const char* first, const char* last) noexcept
+{
+    for (; first != last; ++first) {
+        if (splitter(*first)) {
+            return first;
+        }
+    }
+    return last;
+}
+
+#if defined(PYCPP_SPLIT_SSE2)
+
+/**
+ *  \brief Scan 16 bytes at a time, comparing against each character in the set.
+ */
+static const char* charset_find_sse2(const charset_splitter& splitter, const unsigned char* chars, size_t count, const char* first, const char* last) noexcept
+{
+    __m128i needles[8];
+    for (size_t i = 0; i < count; ++i) {
+        needles[i] = _mm_set1_epi8(static_cast<char>(chars[i]));
+    }
+
+    while (last - first >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        __m128i mask = _mm_cmpeq_epi8(block, needles[0]);
+        for (size_t i = 1; i < count; ++i) {
+            mask = _mm_or_si128(mask, _mm_cmpeq_epi8(block, needles[i]));
+        }
+        int bits = _mm_movemask_epi8(mask);
+        if (bits) {
+            return first + __builtin_ctz(static_cast<unsigned>(bits));
+        }
+        first += 16;
+    }
+
+    return charset_find_scalar(splitter, first, last);
+}
+
+#endif
+
+// OBJECTS
+// -------
+
+
+charset_splitter::charset_splitter(const string_view& sep) noexcept:
+    table_{0, 0, 0, 0},
+    chars_{},
+    count_(0)
+{
+    for (char c: sep) {
+        unsigned char u = static_cast<unsigned char>(c);
+        uint64_t bit = uint64_t(1) << (u & 63);
+        if (table_[u >> 6] & bit) {
+            continue;
+        }
+        table_[u >> 6] |= bit;
+        if (count_ < sizeof(chars_)) {
+            chars_[count_] = u;
+        }
+        ++count_;
+    }
+}
+
+
+const char* charset_splitter::find(const char* first, const char* last) const noexcept
+{
+#if defined(PYCPP_SPLIT_SSE2)
+    if (count_ != 0 && count_ <= sizeof(chars_)) {
+        return charset_find_sse2(*this, chars_, count_, first, last);
+    }
+#endif
+    return charset_find_scalar(*this, first, last);
+}
+
+
+const char* charset_splitter::rfind(const char* first, const char* last) const noexcept
+{
+    while (last != first) {
+        if (operator()(*--last)) {
+            return last;
+        }
+    }
+    return nullptr;
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,494 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Lazy, zero-copy string splitting.
+ *
+ *  Iterator-based alternatives to `split` and `rsplit`, which yield
+ *  views into the original string rather than storing copies in a
+ *  list. The iterators follow the semantics of `split` and `rsplit`:
+ *  N delimiters produce N+1 tokens (unless limited by `maxsplit`),
+ *  and an empty string produces no tokens. Reverse iterators yield
+ *  tokens from the end of the string.
+ *
+ *  The iterators are templated on the splitter, so arbitrary
+ *  predicates are inlined rather than called through `function`.
+ *  Single-character separators use `memchr`, while character
+ *  sets use a 256-bit lookup table (and a vectorized scan for
+ *  small sets on x86).
+ *
+ *  The views reference the original string, which must outlive
+ *  the range. Iterators reference the splitter stored by the range,
+ *  and therefore must not outlive the range.
+ *
+ *  \code
+ *      for (string_view token: splititer("a,b,c", ',')) {
+ *          cout << token << endl;                  // "a", "b", "c"
+ *      }
+ *
+ *  \synopsis
+ *      struct char_splitter
+ *      {
+ *          char_splitter(char c) noexcept;
+ *          const char* find(const char* first, const char* last) const noexcept;
+ *          const char* rfind(const char* first, const char* last) const noexcept;
+ *      };
+ *
+ *      struct charset_splitter
+ *      {
+ *          charset_splitter(const string_view& sep) noexcept;
+ *          bool operator()(char c) const noexcept;
+ *          const char* find(const char* first, const char* last) const noexcept;
+ *          const char* rfind(const char* first, const char* last) const noexcept;
+ *      };
+ *
+ *      template <typename IsSplit>
+ *      struct predicate_splitter
+ *      {
+ *          predicate_splitter(IsSplit is_split);
+ *          const char* find(const char* first, const char* last) const;
+ *          const char* rfind(const char* first, const char* last) const;
+ *      };
+ *
+ *      template <typename Splitter, bool Reverse = false>
+ *      struct split_iterator
+ *      {
+ *          using value_type = string_view;
+ *          using iterator_category = forward_iterator_tag;
+ *
+ *          split_iterator();
+ *          split_iterator(const string_view& str, const Splitter* splitter, size_t maxsplit = SIZE_MAX);
+ *      };
+ *
+ *      template <typename Splitter, bool Reverse = false>
+ *      struct split_range
+ *      {
+ *          using iterator = split_iterator<Splitter, Reverse>;
+ *
+ *          split_range(const string_view& str, const Splitter& splitter, size_t maxsplit = SIZE_MAX);
+ *          iterator begin() const;
+ *          iterator end() const;
+ *          bool empty() const;
+ *      };
+ *
+ *      split_range<char_splitter> splititer(const string_view& str, char sep, size_t maxsplit = SIZE_MAX);
+ *      split_range<charset_splitter> splititer(const string_view& str, const string_view& sep, size_t maxsplit = SIZE_MAX);
+ *      template <typename IsSplit>
+ *      split_range<predicate_splitter<IsSplit>> splititer(const string_view& str, IsSplit is_split, size_t maxsplit = SIZE_MAX);
+ *
+ *      split_range<char_splitter, true> rsplititer(const string_view& str, char sep, size_t maxsplit = SIZE_MAX);
+ *      split_range<charset_splitter, true> rsplititer(const string_view& str, const string_view& sep, size_t maxsplit = SIZE_MAX);
+ *      template <typename IsSplit>
+ *      split_range<predicate_splitter<IsSplit>, true> rsplititer(const string_view& str, IsSplit is_split, size_t maxsplit = SIZE_MAX);
+ */
+
+#pragma once
+
+#include <pycpp/stl/iterator.h>
+#include <pycpp/stl/string_view.h>
+#include <pycpp/stl/type_traits.h>
+#include <stdint.h>
+#include <string.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// SPLITTERS
+// ---------
+
+/**
+ *  \brief Split on a single character, using `memchr`.
+ */
+struct char_splitter
+{
+public:
+    char_splitter(char c) noexcept;
+
+    bool operator()(char c) const noexcept;
+    const char* find(const char* first, const char* last) const noexcept;
+    const char* rfind(const char* first, const char* last) const noexcept;
+
+private:
+    char c_;
+};
+
+
+/**
+ *  \brief Split on any character from a set, using a lookup table.
+ */
+struct charset_splitter
+{
+public:
+    charset_splitter(const string_view& sep) noexcept;
+
+    bool operator()(char c) const noexcept;
+    const char* find(const char* first, const char* last) const noexcept;
+    const char* rfind(const char* first, const char* last) const noexcept;
+
+private:
+    uint64_t table_[4];
+    unsigned char chars_[8];
+    size_t count_;
+};
+
+
+/**
+ *  \brief Split on characters matching a user-defined predicate.
+ */
+template <typename IsSplit>
+struct predicate_splitter
+{
+public:
+    predicate_splitter(IsSplit is_split);
+
+    bool operator()(char c) const;
+    const char* find(const char* first, const char* last) const;
+    const char* rfind(const char* first, const char* last) const;
+
+private:
+    IsSplit is_split_;
+};
+
+// ITERATORS
+// ---------
+
+/**
+ *  \brief Forward iterator yielding views of each token.
+ */
+template <typename Splitter, bool Reverse = false>
+struct split_iterator: iterator<forward_iterator_tag, string_view>
+{
+public:
+    // MEMBER TYPES
+    // ------------
+    using self_t = split_iterator<Splitter, Reverse>;
+    using base_t = iterator<forward_iterator_tag, string_view>;
+    using typename base_t::value_type;
+    using typename base_t::difference_type;
+    using reference = const value_type&;
+    using pointer = const value_type*;
+
+    // MEMBER FUNCTIONS
+    // ----------------
+    split_iterator() = default;
+    split_iterator(const string_view& str, const Splitter* splitter, size_t maxsplit = SIZE_MAX);
+    split_iterator(const self_t&) = default;
+    self_t& operator=(const self_t&) = default;
+    split_iterator(self_t&&) = default;
+    self_t& operator=(self_t&&) = default;
+
+    // OPERATORS
+    self_t& operator++();
+    self_t operator++(int);
+    pointer operator->() const;
+    reference operator*() const;
+
+    // RELATIONAL
+    bool operator==(const self_t&) const;
+    bool operator!=(const self_t&) const;
+
+private:
+    void advance();
+
+    const Splitter* splitter_ = nullptr;
+    const char* first_ = nullptr;
+    const char* last_ = nullptr;
+    size_t maxsplit_ = 0;
+    bool exhausted_ = true;
+    string_view token_;
+};
+
+
+/**
+ *  \brief Range storing the string and splitter for the split iterators.
+ */
+template <typename Splitter, bool Reverse = false>
+struct split_range
+{
+public:
+    // MEMBER TYPES
+    // ------------
+    using self_t = split_range<Splitter, Reverse>;
+    using iterator = split_iterator<Splitter, Reverse>;
+    using const_iterator = iterator;
+    using value_type = typename iterator::value_type;
+    using reference = typename iterator::reference;
+    using const_reference = reference;
+    using pointer = typename iterator::pointer;
+    using const_pointer = pointer;
+    using difference_type = typename iterator::difference_type;
+
+    // MEMBER FUNCTIONS
+    // ----------------
+    split_range(const string_view& str, const Splitter& splitter, size_t maxsplit = SIZE_MAX);
+    split_range(const self_t&) = default;
+    split_range(self_t&&) = default;
+
+    // ITERATORS
+    iterator begin() const;
+    iterator end() const;
+
+    // CAPACITY
+    bool empty() const;
+
+private:
+    string_view str_;
+    Splitter splitter_;
+    size_t maxsplit_;
+};
+
+// IMPLEMENTATION
+// --------------
+
+inline char_splitter::char_splitter(char c) noexcept:
+    c_(c)
+{}
+
+
+inline bool char_splitter::operator()(char c) const noexcept
+{
+    return c == c_;
+}
+
+
+inline const char* char_splitter::find(const char* first, const char* last) const noexcept
+{
+    const void* p = memchr(first, c_, static_cast<size_t>(last - first));
+    return p ? static_cast<const char*>(p) : last;
+}
+
+
+inline const char* char_splitter::rfind(const char* first, const char* last) const noexcept
+{
+    while (last != first) {
+        if (*--last == c_) {
+            return last;
+        }
+    }
+    return nullptr;
+}
+
+
+inline bool charset_splitter::operator()(char c) const noexcept
+{
+    unsigned char u = static_cast<unsigned char>(c);
+    return (table_[u >> 6] >> (u & 63)) & 1;
+}
+
+
+template <typename IsSplit>
+predicate_splitter<IsSplit>::predicate_splitter(IsSplit is_split):
+    is_split_(is_split)
+{}
+
+
+template <typename IsSplit>
+bool predicate_splitter<IsSplit>::operator()(char c) const
+{
+    return is_split_(c);
+}
+
+
+template <typename IsSplit>
+const char* predicate_splitter<IsSplit>::find(const char* first, const char* last) const
+{
+    for (; first != last; ++first) {
+        if (is_split_(*first)) {
+            return first;
+        }
+    }
+    return last;
+}
+
+
+template <typename IsSplit>
+const char* predicate_splitter<IsSplit>::rfind(const char* first, const char* last) const
+{
+    while (last != first) {
+        if (is_split_(*--last)) {
+            return last;
+        }
+    }
+    return nullptr;
+}
+
+
+template <typename S, bool R>
+split_iterator<S, R>::split_iterator(const string_view& str, const S* splitter, size_t maxsplit):
+    splitter_(splitter),
+    first_(str.data()),
+    last_(str.data() + str.size()),
+    maxsplit_(maxsplit),
+    exhausted_(str.empty())
+{
+    advance();
+}
+
+
+template <typename S, bool R>
+auto split_iterator<S, R>::operator++() -> self_t&
+{
+    advance();
+    return *this;
+}
+
+
+template <typename S, bool R>
+auto split_iterator<S, R>::operator++(int) -> self_t
+{
+    self_t copy(*this);
+    operator++();
+    return copy;
+}
+
+
+template <typename S, bool R>
+auto split_iterator<S, R>::operator->() const -> pointer
+{
+    return &token_;
+}
+
+
+template <typename S, bool R>
+auto split_iterator<S, R>::operator*() const -> reference
+{
+    return token_;
+}
+
+
+template <typename S, bool R>
+bool split_iterator<S, R>::operator==(const self_t& rhs) const
+{
+    return token_.data() == rhs.token_.data() && token_.size() == rhs.token_.size();
+}
+
+
+template <typename S, bool R>
+bool split_iterator<S, R>::operator!=(const self_t& rhs) const
+{
+    return !operator==(rhs);
+}
+
+
+template <typename S, bool R>
+void split_iterator<S, R>::advance()
+{
+    if (exhausted_) {
+        // past-the-end, compares equal to a default-constructed iterator
+        token_ = string_view();
+        return;
+    }
+
+    const char* p = nullptr;
+    if (maxsplit_) {
+        p = R ? splitter_->rfind(first_, last_) : splitter_->find(first_, last_);
+        if (p == (R ? nullptr : last_)) {
+            p = nullptr;
+        }
+    }
+
+    if (p == nullptr) {
+        // last token, no more delimiters or splits
+        token_ = string_view(first_, static_cast<size_t>(last_ - first_));
+        exhausted_ = true;
+    } else if (R) {
+        token_ = string_view(p + 1, static_cast<size_t>(last_ - p - 1));
+        last_ = p;
+        --maxsplit_;
+    } else {
+        token_ = string_view(first_, static_cast<size_t>(p - first_));
+        first_ = p + 1;
+        --maxsplit_;
+    }
+}
+
+
+template <typename S, bool R>
+split_range<S, R>::split_range(const string_view& str, const S& splitter, size_t maxsplit):
+    str_(str),
+    splitter_(splitter),
+    maxsplit_(maxsplit)
+{}
+
+
+template <typename S, bool R>
+auto split_range<S, R>::begin() const -> iterator
+{
+    return iterator(str_, &splitter_, maxsplit_);
+}
+
+
+template <typename S, bool R>
+auto split_range<S, R>::end() const -> iterator
+{
+    return iterator();
+}
+
+
+template <typename S, bool R>
+bool split_range<S, R>::empty() const
+{
+    return str_.empty();
+}
+
+// FUNCTIONS
+// ---------
+
+/**
+ *  \brief Lazily split string by a single character.
+ */
+inline split_range<char_splitter> splititer(const string_view& str, char sep, size_t maxsplit = SIZE_MAX)
+{
+    return split_range<char_splitter>(str, char_splitter(sep), maxsplit);
+}
+
+/**
+ *  \brief Lazily split string by any character in `sep`.
+ */
+inline split_range<charset_splitter> splititer(const string_view& str, const string_view& sep, size_t maxsplit = SIZE_MAX)
+{
+    return split_range<charset_splitter>(str, charset_splitter(sep), maxsplit);
+}
+
+/**
+ *  \brief Lazily split string by any character matching the predicate.
+ */
+template <
+    typename IsSplit,
+    typename = enable_if_t<!is_convertible<IsSplit, string_view>::value && !is_convertible<IsSplit, char>::value>
+>
+split_range<predicate_splitter<IsSplit>> splititer(const string_view& str, IsSplit is_split, size_t maxsplit = SIZE_MAX)
+{
+    using splitter = predicate_splitter<IsSplit>;
+    return split_range<splitter>(str, splitter(is_split), maxsplit);
+}
+
+/**
+ *  \brief Same as splititer, except scanning in reverse order.
+ */
+inline split_range<char_splitter, true> rsplititer(const string_view& str, char sep, size_t maxsplit = SIZE_MAX)
+{
+    return split_range<char_splitter, true>(str, char_splitter(sep), maxsplit);
+}
+
+/**
+ *  \brief Same as splititer, except scanning in reverse order.
+ */
+inline split_range<charset_splitter, true> rsplititer(const string_view& str, const string_view& sep, size_t maxsplit = SIZE_MAX)
+{
+    return split_range<charset_splitter, true>(str, charset_splitter(sep), maxsplit);
+}
+
+/**
+ *  \brief Same as splititer, except scanning in reverse order.
+ */
+template <
+    typename IsSplit,
+    typename = enable_if_t<!is_convertible<IsSplit, string_view>::value && !is_convertible<IsSplit, char>::value>
+>
+split_range<predicate_splitter<IsSplit>, true> rsplititer(const string_view& str, IsSplit is_split, size_t maxsplit = SIZE_MAX)
+{
+    using splitter = predicate_splitter<IsSplit>;
+    return split_range<splitter, true>(str, splitter(is_split), maxsplit);
+}
+
+PYCPP_END_NAMESPACE
@@ -6,6 +6,7 @@
 #include <pycpp/stl/iterator.h>
 #include <pycpp/stl/stdexcept.h>
 #include <pycpp/string/casemap.h>
+#include <pycpp/string/split.h>
 #include <pycpp/string/string.h>
 #include <pycpp/string/unicode.h>
 #include <string.h>
@@ -149,6 +150,37 @@ static size_t rsplit_impl(Iter first, Iter last, size_t maxsplit, IsSplit is_spl
 }
 
 
+template <typename List, typename Splitter, bool Reverse>
+static List split_range_impl(const split_range<Splitter, Reverse>& range)
+{
+    using value_type = typename List::value_type;
+
+    List data;
+    for (const string_view& token: range) {
+        data.emplace_back(value_type(token.data(), token.size()));
+    }
+    if (Reverse) {
+        reverse(data.begin(), data.end());
+    }
+
+    return data;
+}
+
+
+template <typename List, bool Reverse>
+static List split_sep_impl(const string_view& str, const string_view& sep, size_t maxsplit)
+{
+    // single-character separators use memchr, otherwise use a lookup table
+    if (sep.size() == 1) {
+        using range_type = split_range<char_splitter, Reverse>;
+        return split_range_impl<List>(range_type(str, char_splitter(sep.front()), maxsplit));
+    }
+
+    using range_type = split_range<charset_splitter, Reverse>;
+    return split_range_impl<List>(range_type(str, charset_splitter(sep), maxsplit));
+}
+
+
 template <typename Iter>
 string_list_t quoted_split_impl(Iter first, Iter last, char delimiter, char quote, char escape)
 {
@@ -389,9 +421,7 @@ string_list_t split(const string_wrapper& str, split_function is_split, size_t m
 
 string_list_t split(const string_wrapper& str, const string_wrapper& sep, size_t maxsplit)
 {
-    return split(str, [&](char c) {
-        return sep.view().find(c) != sep.npos;
-    }, maxsplit);
+    return split_sep_impl<string_list_t, false>(str, sep, maxsplit);
 }
 
 
@@ -417,9 +447,7 @@ string_list_t rsplit(const string_wrapper& str, split_function is_split, size_t
 
 string_list_t rsplit(const string_wrapper& str, const string_wrapper& sep, size_t maxsplit)
 {
-    return rsplit(str, [&](char c) {
-        return sep.view().find(c) != sep.npos;
-    }, maxsplit);
+    return split_sep_impl<string_list_t, true>(str, sep, maxsplit);
 }
 
 
@@ -590,9 +618,7 @@ string_wrapper_list_t string_wrapper::split(split_function is_split, size_t maxs
 
 string_wrapper_list_t string_wrapper::split(const string_wrapper& sep, size_t maxsplit) const
 {
-    return split([&](char c) {
-        return sep.view().find(c) != sep.npos;
-    }, maxsplit);
+    return split_sep_impl<string_wrapper_list_t, false>(*this, sep, maxsplit);
 }
 
 
@@ -612,9 +638,7 @@ string_wrapper_list_t string_wrapper::rsplit(split_function is_split, size_t max
 
 string_wrapper_list_t string_wrapper::rsplit(const string_wrapper& sep, size_t maxsplit) const
 {
-    return rsplit([&](char c) {
-        return sep.view().find(c) != sep.npos;
-    }, maxsplit);
+    return split_sep_impl<string_wrapper_list_t, true>(*this, sep, maxsplit);
 }
 
 
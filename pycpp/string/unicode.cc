@@ -6,10 +6,15 @@
 //  :license: Boost, see licenses/boost.md for more details.
 
 #include <pycpp/misc/safe_stdlib.h>
+#include <pycpp/runtime/cpu.h>
 #include <pycpp/stl/algorithm.h>
 #include <pycpp/stl/functional.h>
 #include <pycpp/stl/stdexcept.h>
 #include <pycpp/string/unicode.h>
+#include <string.h>
+#if defined(HAVE_X86_SIMD)
+#   include <immintrin.h>
+#endif
 
 PYCPP_BEGIN_NAMESPACE
 
@@ -304,7 +309,7 @@ size_t utf16_to_utf32(uint32_t& c, Iter16 &first, Iter16 last, bool strict)
     const uint32_t c1 = *first++;
     if (c1 >= high_begin && c1 <= high_end) {
         // check source buffer, check whether or not we have space to replace
-        if (first + 1 >= last) {
+        if (first >= last) {
             throw runtime_error("Not enough input characters for a full code point.");
         }
 
@@ -572,6 +577,703 @@ size_t utf32_to_utf16_array(Iter32 &src_first,
 }
 
 
+// HELPERS -- VECTORIZED
+// ---------------------
+
+// Each kernel processes the longest prefix it can handle, leaving
+// the remainder (non-ASCII characters, or invalid data) to the
+// scalar routines above. Kernels are selected once, at runtime,
+// from the instruction sets supported by the processor.
+
+/**
+ *  \brief Vectorized kernels for a single instruction set.
+ */
+struct unicode_kernels
+{
+    bool (*has_nonascii_or_null)(const uint8_t* src, size_t n);
+    bool (*is_valid_utf8)(const uint8_t* src, size_t n);
+    size_t (*ascii_to_utf16)(const uint8_t* src, size_t n, uint16_t* dst);
+    size_t (*ascii_to_utf32)(const uint8_t* src, size_t n, uint32_t* dst);
+    size_t (*utf16_to_ascii)(const uint16_t* src, size_t n, uint8_t* dst);
+    size_t (*utf32_to_ascii)(const uint32_t* src, size_t n, uint8_t* dst);
+};
+
+
+static bool has_nonascii_or_null_scalar(const uint8_t* src, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        if (src[i] == 0 || src[i] >= 0x80) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+static bool is_continuation(const uint8_t* src)
+{
+    return (*src & 0xC0) == 0x80;
+}
+
+
+/**
+ *  \brief Validate UTF-8, rejecting overlong encodings, surrogates and values above U+10FFFF.
+ */
+static bool is_valid_utf8_scalar(const uint8_t* src, size_t n)
+{
+    const uint8_t* last = src + n;
+    while (src < last) {
+        uint8_t c = *src;
+        ptrdiff_t left = last - src;
+        if (c < 0x80) {
+            ++src;
+        } else if (c < 0xC2) {
+            return false;
+        } else if (c < 0xE0) {
+            if (left < 2 || !is_continuation(src + 1)) {
+                return false;
+            }
+            src += 2;
+        } else if (c < 0xF0) {
+            if (left < 3 || !is_continuation(src + 1) || !is_continuation(src + 2)) {
+                return false;
+            } else if (c == 0xE0 && src[1] < 0xA0) {
+                return false;
+            } else if (c == 0xED && src[1] > 0x9F) {
+                return false;
+            }
+            src += 3;
+        } else if (c < 0xF5) {
+            if (left < 4 || !is_continuation(src + 1) || !is_continuation(src + 2) || !is_continuation(src + 3)) {
+                return false;
+            } else if (c == 0xF0 && src[1] < 0x90) {
+                return false;
+            } else if (c == 0xF4 && src[1] > 0x8F) {
+                return false;
+            }
+            src += 4;
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+template <typename Char>
+static size_t ascii_to_wide_scalar(const uint8_t* src, size_t n, Char* dst)
+{
+    size_t i = 0;
+    for (; i < n && src[i] < 0x80; ++i) {
+        dst[i] = src[i];
+    }
+    return i;
+}
+
+
+template <typename Char>
+static size_t wide_to_ascii_scalar(const Char* src, size_t n, uint8_t* dst)
+{
+    size_t i = 0;
+    for (; i < n && src[i] < 0x80; ++i) {
+        dst[i] = utf8_t(src[i]);
+    }
+    return i;
+}
+
+#if defined(HAVE_X86_SIMD)              // HAVE_X86_SIMD
+
+// Lookup tables for the UTF-8 validation algorithm described in
+// "Validating UTF-8 In Less Than One Instruction Per Byte"
+// (Keiser and Lemire, 2021). Each error class is assigned a bit,
+// and an error is present if all three nibble lookups share a bit.
+
+static constexpr uint8_t UTF8_TOO_SHORT = 1 << 0;
+static constexpr uint8_t UTF8_TOO_LONG = 1 << 1;
+static constexpr uint8_t UTF8_OVERLONG_3 = 1 << 2;
+static constexpr uint8_t UTF8_TOO_LARGE = 1 << 3;
+static constexpr uint8_t UTF8_SURROGATE = 1 << 4;
+static constexpr uint8_t UTF8_OVERLONG_2 = 1 << 5;
+static constexpr uint8_t UTF8_TOO_LARGE_1000 = 1 << 6;
+static constexpr uint8_t UTF8_OVERLONG_4 = 1 << 6;
+static constexpr uint8_t UTF8_TWO_CONTS = 1 << 7;
+static constexpr uint8_t UTF8_CARRY = UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS;
+
+// high nibble of the previous byte
+static constexpr uint8_t UTF8_BYTE_1_HIGH[16] = {
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+};
+
+// low nibble of the previous byte
+static constexpr uint8_t UTF8_BYTE_1_LOW[16] = {
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    UTF8_CARRY,
+    UTF8_CARRY,
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+};
+
+// high nibble of the current byte
+static constexpr uint8_t UTF8_BYTE_2_HIGH[16] = {
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+};
+
+// the last 3 bytes of a block cannot start a sequence longer than the remaining bytes
+static constexpr uint8_t UTF8_MAX_VALUE[32] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 0xEF, 0xDF, 0xBF,
+};
+
+// SSE4.1
+
+SIMD_TARGET("sse4.1")
+static bool has_nonascii_or_null_sse41(const uint8_t* src, size_t n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (_mm_movemask_epi8(_mm_or_si128(v, _mm_cmpeq_epi8(v, zero)))) {
+            return true;
+        }
+    }
+    return has_nonascii_or_null_scalar(src + i, n - i);
+}
+
+
+SIMD_TARGET("sse4.1")
+static inline __m128i utf8_high_nibbles_sse41(__m128i v)
+{
+    return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+}
+
+
+SIMD_TARGET("sse4.1")
+static inline void utf8_check_block_sse41(__m128i input, __m128i& prev_input, __m128i& prev_incomplete, __m128i& error)
+{
+    if (_mm_movemask_epi8(input) == 0) {
+        // ASCII block: only an incomplete sequence from the last block is an error
+        error = _mm_or_si128(error, prev_incomplete);
+        prev_incomplete = _mm_setzero_si128();
+        prev_input = input;
+        return;
+    }
+
+    const __m128i byte_1_high_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(UTF8_BYTE_1_HIGH));
+    const __m128i byte_1_low_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(UTF8_BYTE_1_LOW));
+    const __m128i byte_2_high_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(UTF8_BYTE_2_HIGH));
+    const __m128i max_value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(UTF8_MAX_VALUE + 16));
+
+    // special cases from the previous and current byte
+    __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+    __m128i byte_1_high = _mm_shuffle_epi8(byte_1_high_table, utf8_high_nibbles_sse41(prev1));
+    __m128i byte_1_low = _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(prev1, _mm_set1_epi8(0x0F)));
+    __m128i byte_2_high = _mm_shuffle_epi8(byte_2_high_table, utf8_high_nibbles_sse41(input));
+    __m128i special = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+    // third and fourth bytes must be continuations
+    __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+    __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+
+    error = _mm_or_si128(error, _mm_xor_si128(must23, special));
+    prev_incomplete = _mm_subs_epu8(input, max_value);
+    prev_input = input;
+}
+
+
+SIMD_TARGET("sse4.1")
+static bool is_valid_utf8_sse41(const uint8_t* src, size_t n)
+{
+    __m128i error = _mm_setzero_si128();
+    __m128i prev_input = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        utf8_check_block_sse41(input, prev_input, prev_incomplete, error);
+    }
+    if (i < n) {
+        // pad with ASCII, which detects truncated sequences
+        uint8_t buffer[16] = {0};
+        memcpy(buffer, src + i, n - i);
+        __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer));
+        utf8_check_block_sse41(input, prev_input, prev_incomplete, error);
+    }
+    error = _mm_or_si128(error, prev_incomplete);
+
+    return _mm_testz_si128(error, error);
+}
+
+
+SIMD_TARGET("sse4.1")
+static size_t ascii_to_utf16_sse41(const uint8_t* src, size_t n, uint16_t* dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (_mm_movemask_epi8(v)) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(v, zero));
+    }
+    return i + ascii_to_wide_scalar(src + i, n - i, dst + i);
+}
+
+
+SIMD_TARGET("sse4.1")
+static size_t ascii_to_utf32_sse41(const uint8_t* src, size_t n, uint32_t* dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (_mm_movemask_epi8(v)) {
+            break;
+        }
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+    }
+    return i + ascii_to_wide_scalar(src + i, n - i, dst + i);
+}
+
+
+SIMD_TARGET("sse4.1")
+static size_t utf16_to_ascii_sse41(const uint16_t* src, size_t n, uint8_t* dst)
+{
+    const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFF80));
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+        if (!_mm_testz_si128(_mm_or_si128(lo, hi), mask)) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    return i + wide_to_ascii_scalar(src + i, n - i, dst + i);
+}
+
+
+SIMD_TARGET("sse4.1")
+static size_t utf32_to_ascii_sse41(const uint32_t* src, size_t n, uint8_t* dst)
+{
+    const __m128i mask = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+        __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        if (!_mm_testz_si128(any, mask)) {
+            break;
+        }
+        __m128i lo = _mm_packus_epi32(a, b);
+        __m128i hi = _mm_packus_epi32(c, d);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    return i + wide_to_ascii_scalar(src + i, n - i, dst + i);
+}
+
+// AVX2
+
+SIMD_TARGET("avx2")
+static bool has_nonascii_or_null_avx2(const uint8_t* src, size_t n)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        if (_mm256_movemask_epi8(_mm256_or_si256(v, _mm256_cmpeq_epi8(v, zero)))) {
+            return true;
+        }
+    }
+    return has_nonascii_or_null_scalar(src + i, n - i);
+}
+
+
+SIMD_TARGET("avx2")
+static inline __m256i utf8_high_nibbles_avx2(__m256i v)
+{
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+}
+
+
+/**
+ *  \brief Shift the input right by N bytes, shifting in bytes from the previous block.
+ */
+template <int N>
+SIMD_TARGET("avx2")
+static inline __m256i utf8_prev_avx2(__m256i input, __m256i prev_input)
+{
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev_input, input, 0x21), 16 - N);
+}
+
+
+SIMD_TARGET("avx2")
+static inline void utf8_check_block_avx2(__m256i input, __m256i& prev_input, __m256i& prev_incomplete, __m256i& error)
+{
+    if (_mm256_movemask_epi8(input) == 0) {
+        error = _mm256_or_si256(error, prev_incomplete);
+        prev_incomplete = _mm256_setzero_si256();
+        prev_input = input;
+        return;
+    }
+
+    const __m256i byte_1_high_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(UTF8_BYTE_1_HIGH)));
+    const __m256i byte_1_low_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(UTF8_BYTE_1_LOW)));
+    const __m256i byte_2_high_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(UTF8_BYTE_2_HIGH)));
+    const __m256i max_value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(UTF8_MAX_VALUE));
+
+    __m256i prev1 = utf8_prev_avx2<1>(input, prev_input);
+    __m256i byte_1_high = _mm256_shuffle_epi8(byte_1_high_table, utf8_high_nibbles_avx2(prev1));
+    __m256i byte_1_low = _mm256_shuffle_epi8(byte_1_low_table, _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+    __m256i byte_2_high = _mm256_shuffle_epi8(byte_2_high_table, utf8_high_nibbles_avx2(input));
+    __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+    __m256i prev2 = utf8_prev_avx2<2>(input, prev_input);
+    __m256i prev3 = utf8_prev_avx2<3>(input, prev_input);
+    __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    __m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+
+    error = _mm256_or_si256(error, _mm256_xor_si256(must23, special));
+    prev_incomplete = _mm256_subs_epu8(input, max_value);
+    prev_input = input;
+}
+
+
+SIMD_TARGET("avx2")
+static bool is_valid_utf8_avx2(const uint8_t* src, size_t n)
+{
+    __m256i error = _mm256_setzero_si256();
+    __m256i prev_input = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        utf8_check_block_avx2(input, prev_input, prev_incomplete, error);
+    }
+    if (i < n) {
+        uint8_t buffer[32] = {0};
+        memcpy(buffer, src + i, n - i);
+        __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer));
+        utf8_check_block_avx2(input, prev_input, prev_incomplete, error);
+    }
+    error = _mm256_or_si256(error, prev_incomplete);
+
+    return _mm256_testz_si256(error, error);
+}
+
+
+SIMD_TARGET("avx2")
+static size_t ascii_to_utf16_avx2(const uint8_t* src, size_t n, uint16_t* dst)
+{
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        if (_mm256_movemask_epi8(v)) {
+            break;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+    }
+    return i + ascii_to_utf16_sse41(src + i, n - i, dst + i);
+}
+
+
+SIMD_TARGET("avx2")
+static size_t ascii_to_utf32_avx2(const uint8_t* src, size_t n, uint32_t* dst)
+{
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        if (_mm256_movemask_epi8(v)) {
+            break;
+        }
+        __m128i lo = _mm256_castsi256_si128(v);
+        __m128i hi = _mm256_extracti128_si256(v, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvtepu8_epi32(lo));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 8), _mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 16), _mm256_cvtepu8_epi32(hi));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 24), _mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)));
+    }
+    return i + ascii_to_utf32_sse41(src + i, n - i, dst + i);
+}
+
+
+SIMD_TARGET("avx2")
+static size_t utf16_to_ascii_avx2(const uint16_t* src, size_t n, uint8_t* dst)
+{
+    const __m256i mask = _mm256_set1_epi16(static_cast<short>(0xFF80));
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16));
+        if (!_mm256_testz_si256(_mm256_or_si256(lo, hi), mask)) {
+            break;
+        }
+        // packus interleaves 128-bit lanes, restore the order
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+    }
+    return i + utf16_to_ascii_sse41(src + i, n - i, dst + i);
+}
+
+#endif                                  // HAVE_X86_SIMD
+
+
+static unicode_kernels select_unicode_kernels()
+{
+#if defined(HAVE_X86_SIMD)
+    if (cpu_supports(cpu_avx2)) {
+        return {
+            has_nonascii_or_null_avx2,
+            is_valid_utf8_avx2,
+            ascii_to_utf16_avx2,
+            ascii_to_utf32_avx2,
+            utf16_to_ascii_avx2,
+            utf32_to_ascii_sse41,
+        };
+    } else if (cpu_supports(cpu_sse41) && cpu_supports(cpu_ssse3)) {
+        return {
+            has_nonascii_or_null_sse41,
+            is_valid_utf8_sse41,
+            ascii_to_utf16_sse41,
+            ascii_to_utf32_sse41,
+            utf16_to_ascii_sse41,
+            utf32_to_ascii_sse41,
+        };
+    }
+#endif
+
+    return {
+        has_nonascii_or_null_scalar,
+        is_valid_utf8_scalar,
+        ascii_to_wide_scalar<uint16_t>,
+        ascii_to_wide_scalar<uint32_t>,
+        wide_to_ascii_scalar<uint16_t>,
+        wide_to_ascii_scalar<uint32_t>,
+    };
+}
+
+
+static const unicode_kernels& get_unicode_kernels()
+{
+    static const unicode_kernels kernels = select_unicode_kernels();
+    return kernels;
+}
+
+
+/**
+ *  \brief Find the longest prefix of at most `n` bytes ending on a code point boundary.
+ */
+static size_t utf8_boundary(const uint8_t* src, size_t n, size_t limit)
+{
+    if (n <= limit) {
+        return n;
+    }
+    size_t i = limit;
+    while (i > 0 && limit - i < 3 && is_continuation(src + i)) {
+        --i;
+    }
+    return i;
+}
+
+
+/**
+ *  \brief Decode a validated, multi-byte UTF-8 character.
+ */
+static uint32_t utf8_decode_valid(const uint8_t*& src)
+{
+    uint32_t c = src[0];
+    if (c < 0xE0) {
+        c = ((c & 0x1F) << 6) | (src[1] & 0x3F);
+        src += 2;
+    } else if (c < 0xF0) {
+        c = ((c & 0x0F) << 12) | ((src[1] & 0x3F) << 6) | (src[2] & 0x3F);
+        src += 3;
+    } else {
+        c = ((c & 0x07) << 18) | ((src[1] & 0x3F) << 12) | ((src[2] & 0x3F) << 6) | (src[3] & 0x3F);
+        src += 4;
+    }
+    return c;
+}
+
+
+/**
+ *  \brief Convert validated UTF-8 to UTF-16, until the destination may overflow.
+ */
+static void utf8_to_utf16_valid(const uint8_t*& src_first,
+    const uint8_t* src_last,
+    uint16_t*& dst_first,
+    uint16_t* dst_last,
+    const unicode_kernels& kernels)
+{
+    const uint8_t* src = src_first;
+    uint16_t* dst = dst_first;
+    while (src < src_last && dst_last - dst >= 2) {
+        if (*src < 0x80) {
+            size_t n = min<size_t>(src_last - src, dst_last - dst);
+            size_t length = kernels.ascii_to_utf16(src, n, dst);
+            src += length;
+            dst += length;
+            continue;
+        }
+
+        uint32_t c = utf8_decode_valid(src);
+        if (c < 0x10000) {
+            *dst++ = utf16_t(c);
+        } else {
+            c -= 0x10000;
+            *dst++ = utf16_t((c >> 10) + 0xD800);
+            *dst++ = utf16_t((c & 0x3FF) + 0xDC00);
+        }
+    }
+
+    src_first = src;
+    dst_first = dst;
+}
+
+
+/**
+ *  \brief Convert validated UTF-8 to UTF-32, until the destination is full.
+ */
+static void utf8_to_utf32_valid(const uint8_t*& src_first,
+    const uint8_t* src_last,
+    uint32_t*& dst_first,
+    uint32_t* dst_last,
+    const unicode_kernels& kernels)
+{
+    const uint8_t* src = src_first;
+    uint32_t* dst = dst_first;
+    while (src < src_last && dst < dst_last) {
+        if (*src < 0x80) {
+            size_t n = min<size_t>(src_last - src, dst_last - dst);
+            size_t length = kernels.ascii_to_utf32(src, n, dst);
+            src += length;
+            dst += length;
+            continue;
+        }
+        *dst++ = utf8_decode_valid(src);
+    }
+
+    src_first = src;
+    dst_first = dst;
+}
+
+
+/**
+ *  \brief Convert the longest valid prefix of UTF-8 that fits in the destination.
+ *
+ *  The input is validated in chunks before conversion, so characters
+ *  may be decoded without per-byte checks. Any remaining (or invalid)
+ *  data is left for the checked conversion routines.
+ */
+template <typename Char, typename Convert>
+static void utf8_to_wide_fast(const uint8_t*& src_first,
+    const uint8_t* src_last,
+    Char*& dst_first,
+    Char* dst_last,
+    Convert convert)
+{
+    static constexpr size_t chunk = 4096;
+    const unicode_kernels& kernels = get_unicode_kernels();
+
+    while (src_first < src_last && dst_first < dst_last) {
+        // every output character consumes at least 1 byte
+        size_t srclen = static_cast<size_t>(src_last - src_first);
+        size_t dstlen = static_cast<size_t>(dst_last - dst_first);
+        size_t length = utf8_boundary(src_first, srclen, min(dstlen, chunk));
+        if (length == 0 || !kernels.is_valid_utf8(src_first, length)) {
+            break;
+        }
+
+        const uint8_t* chunk_last = src_first + length;
+        convert(src_first, chunk_last, dst_first, dst_last, kernels);
+        if (src_first != chunk_last) {
+            break;
+        }
+    }
+}
+
+
+/**
+ *  \brief Convert UTF-16 or UTF-32 to UTF-8, with a fast path for ASCII runs.
+ */
+template <typename Char, typename Narrow, typename ToUtf32>
+static size_t wide_to_utf8_fast(const Char*& src_first,
+    const Char* src_last,
+    uint8_t*& dst_first,
+    uint8_t* dst_last,
+    bool strict,
+    Narrow narrow,
+    ToUtf32 to_utf32)
+{
+    auto src = src_first;
+    auto dst = dst_first;
+    while (src < src_last && dst < dst_last) {
+        if (*src < 0x80) {
+            size_t n = min<size_t>(src_last - src, dst_last - dst);
+            size_t length = narrow(src, n, dst);
+            src += length;
+            dst += length;
+            continue;
+        }
+
+        uint32_t c;
+        if (!to_utf32(c, src, src_last, strict)) {
+            break;
+        }
+        if (!utf32_to_utf8(c, dst, dst_last, strict)) {
+            break;
+        }
+    }
+
+    // store_pointers
+    size_t dist = distance(dst_first, dst);
+    src_first = src;
+    dst_first = dst;
+
+    return dist;
+}
+
+
 // HELPERS -- POINTERS
 // -------------------
 
@@ -582,7 +1284,11 @@ size_t utf8_to_utf16_ptr(const uint8_t*& src_first,
     uint16_t* dst_last,
     bool strict = true)
 {
-    return utf8_to_utf16_array(src_first, src_last, dst_first, dst_last, strict);
+    uint16_t* dst = dst_first;
+    utf8_to_wide_fast(src_first, src_last, dst_first, dst_last, utf8_to_utf16_valid);
+    utf8_to_utf16_array(src_first, src_last, dst_first, dst_last, strict);
+
+    return distance(dst, dst_first);
 }
 
 
@@ -592,7 +1298,11 @@ size_t utf8_to_utf32_ptr(const uint8_t*& src_first,
     uint32_t* dst_last,
     bool strict = true)
 {
-    return utf8_to_utf32_array(src_first, src_last, dst_first, dst_last, strict);
+    uint32_t* dst = dst_first;
+    utf8_to_wide_fast(src_first, src_last, dst_first, dst_last, utf8_to_utf32_valid);
+    utf8_to_utf32_array(src_first, src_last, dst_first, dst_last, strict);
+
+    return distance(dst, dst_first);
 }
 
 
@@ -602,7 +1312,11 @@ size_t utf16_to_utf8_ptr(const uint16_t*& src_first,
     uint8_t* dst_last,
     bool strict = true)
 {
-    return utf16_to_utf8_array(src_first, src_last, dst_first, dst_last, strict);
+    auto narrow = get_unicode_kernels().utf16_to_ascii;
+    auto to_utf32 = [](uint32_t& c, const uint16_t*& first, const uint16_t* last, bool strict) {
+        return utf16_to_utf32(c, first, last, strict);
+    };
+    return wide_to_utf8_fast(src_first, src_last, dst_first, dst_last, strict, narrow, to_utf32);
 }
 
 
@@ -622,7 +1336,12 @@ size_t utf32_to_utf8_ptr(const uint32_t*& src_first,
     uint8_t* dst_last,
     bool strict = true)
 {
-    return utf32_to_utf8_array(src_first, src_last, dst_first, dst_last, strict);
+    auto narrow = get_unicode_kernels().utf32_to_ascii;
+    auto to_utf32 = [](uint32_t& c, const uint32_t*& first, const uint32_t*, bool) -> size_t {
+        c = *first++;
+        return 1;
+    };
+    return wide_to_utf8_fast(src_first, src_last, dst_first, dst_last, strict, narrow, to_utf32);
 }
 
 
@@ -817,9 +1536,15 @@ bool is_ascii(const string_wrapper& str)
 
 bool is_unicode(const string_wrapper& str)
 {
-    return any_of(str.cbegin(), str.cend(), [](char c) {
-        return c <= 0;
-    });
+    auto src = reinterpret_cast<const uint8_t*>(str.data());
+    return get_unicode_kernels().has_nonascii_or_null(src, str.size());
+}
+
+
+bool is_valid_utf8(const string_wrapper& str)
+{
+    auto src = reinterpret_cast<const uint8_t*>(str.data());
+    return get_unicode_kernels().is_valid_utf8(src, str.size());
 }
 
 // CONVERSIONS
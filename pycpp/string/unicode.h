@@ -15,6 +15,10 @@
  *  for the high-level interfaces, and dictate the memory allocation
  *  properties of the output string.
  *
+ *  Validation and the ASCII portions of UTF-8, UTF-16 and UTF-32
+ *  conversions are vectorized, using the best instruction set
+ *  (SSE4.1 or AVX2) supported by the processor at runtime.
+ *
  *  \synopsis
  *      using unicode_lowlevel_callback = void(*)(
  *          const void*& src, size_t srclen,
@@ -41,6 +45,7 @@
  *      bool is_continuation_byte(uint8_t c);
  *      bool is_ascii(const string_wrapper& str);
  *      bool is_unicode(const string_wrapper& str);
+ *      bool is_valid_utf8(const string_wrapper& str);
  *
  *      void utf8_to_utf16(const void*& src,
  *          size_t srclen,
@@ -202,6 +207,14 @@ bool is_ascii(const string_wrapper& str);
  */
 bool is_unicode(const string_wrapper& str);
 
+/**
+ *  \brief Check if string is well-formed UTF-8.
+ *
+ *  Rejects truncated sequences, overlong encodings, surrogates,
+ *  and code points above U+10FFFF.
+ */
+bool is_valid_utf8(const string_wrapper& str);
+
 // CONVERSIONS
 
 /**
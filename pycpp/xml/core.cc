@@ -44,6 +44,8 @@ using xml_node_list_impl_t = multi_index_container<
 >;
 
 using xml_node_iterator_impl_t = typename xml_node_list_impl_t::iterator;
+using xml_node_list_allocator_t = typename allocator_traits<byte_allocator>::template rebind_alloc<xml_node_list_impl_t>;
+using xml_node_list_traits_t = allocator_traits<xml_node_list_allocator_t>;
 
 
 // PRIVATE
@@ -64,8 +66,50 @@ struct xml_node_impl_t
     xml_attr_t attrs;
     xml_node_list_t children;
     xml_node_list_t* parent = nullptr;
+
+    xml_node_impl_t() = default;
+    xml_node_impl_t(const xml_node_impl_t&) = default;
+    xml_node_impl_t(const byte_allocator&);
 };
 
+
+xml_node_impl_t::xml_node_impl_t(const byte_allocator& allocator):
+    tag(allocator),
+    text(allocator),
+    attrs(allocator),
+    children(allocator)
+{}
+
+
+/**
+ *  \brief Create a node list, and its control block, with an allocator.
+ */
+static xml_node_list_impl_t* new_node_list(const byte_allocator& allocator)
+{
+    xml_node_list_allocator_t alloc(allocator);
+    xml_node_list_impl_t* ptr = xml_node_list_traits_t::allocate(alloc, 1);
+    try {
+        xml_node_list_traits_t::construct(alloc, ptr, xml_node_list_impl_t::ctor_args_list(), allocator);
+    } catch (...) {
+        xml_node_list_traits_t::deallocate(alloc, ptr, 1);
+        throw;
+    }
+    return ptr;
+}
+
+
+/**
+ *  \brief Destroy a node list created by `new_node_list`.
+ */
+static void delete_node_list(xml_node_list_impl_t* ptr)
+{
+    if (ptr) {
+        xml_node_list_allocator_t alloc(ptr->get_allocator());
+        xml_node_list_traits_t::destroy(alloc, ptr);
+        xml_node_list_traits_t::deallocate(alloc, ptr, 1);
+    }
+}
+
 // OBJECTS
 // -------
 
@@ -189,12 +233,17 @@ xml_node_iterator_t::~xml_node_iterator_t()
 
 
 xml_node_list_t::xml_node_list_t():
-    ptr_(new xml_node_list_impl_t)
+    ptr_(new_node_list(allocator_type()))
+{}
+
+
+xml_node_list_t::xml_node_list_t(const allocator_type& allocator):
+    ptr_(new_node_list(allocator))
 {}
 
 
 xml_node_list_t::xml_node_list_t(const self_t& rhs):
-    ptr_(new xml_node_list_impl_t)
+    ptr_(new_node_list(allocator_type()))
 {
     auto& src = *(const xml_node_list_impl_t*) rhs.ptr_;
     auto& dst = *(xml_node_list_impl_t*) ptr_;
@@ -238,7 +287,7 @@ auto xml_node_list_t::operator=(self_t&& rhs) -> self_t&
 
 xml_node_list_t::~xml_node_list_t()
 {
-    delete (xml_node_list_impl_t*) ptr_;
+    delete_node_list((xml_node_list_impl_t*) ptr_);
 }
 
 
@@ -575,6 +624,11 @@ xml_node_t::xml_node_t():
 {}
 
 
+xml_node_t::xml_node_t(const allocator_type& allocator):
+    ptr_(allocate_shared<xml_node_impl_t>(allocator, allocator))
+{}
+
+
 xml_node_t::xml_node_t(xml_node_impl_t*ptr):
     ptr_(ptr)
 {}
@@ -676,6 +730,12 @@ const xml_string_t& xml_node_t::get_tag() const
 }
 
 
+xml_string_t& xml_node_t::get_text()
+{
+    return ptr_->text;
+}
+
+
 const xml_string_t& xml_node_t::get_text() const
 {
     return ptr_->text;
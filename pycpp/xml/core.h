@@ -94,6 +94,7 @@ public:
     // MEMBER TYPES
     // ------------
     using self_t = xml_node_list_t;
+    using allocator_type = byte_allocator;
     using value_type = xml_node_t;
     using reference = value_type&;
     using const_reference = const value_type&;
@@ -107,6 +108,7 @@ public:
     // MEMBER FUNCTIONS
     // ----------------
     xml_node_list_t();
+    explicit xml_node_list_t(const allocator_type&);
     xml_node_list_t(const self_t&);
     self_t& operator=(const self_t&);
     xml_node_list_t(self_t&&);
@@ -169,6 +171,10 @@ private:
 
 /**
  *  \brief XML node type.
+ *
+ *  Nodes constructed with an allocator store their tag, text,
+ *  attributes and children with that allocator. Copies of a
+ *  node's children use the default allocator.
  */
 struct xml_node_t
 {
@@ -176,6 +182,7 @@ public:
     // MEMBER TYPES
     // ------------
     using self_t = xml_node_t;
+    using allocator_type = byte_allocator;
     using iterator = xml_node_iterator_t;
     using const_iterator = iterator;
     using reverse_iterator = PYCPP_NAMESPACE::reverse_iterator<iterator>;
@@ -186,6 +193,7 @@ public:
 
     // CONSTRUCTORS
     xml_node_t();
+    explicit xml_node_t(const allocator_type&);
     xml_node_t(const xml_node_t&) = default;
     xml_node_t & operator=(const xml_node_t&) = default;
     xml_node_t(xml_node_t&&) = default;
@@ -211,6 +219,7 @@ public:
 
     // GETTERS
     const xml_string_t& get_tag() const;
+    xml_string_t& get_text();
     const xml_string_t& get_text() const;
     xml_attr_t& get_attrs();
     const xml_attr_t& get_attrs() const;
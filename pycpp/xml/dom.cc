@@ -49,7 +49,8 @@ xml_string_t xml_node_t::tostring() const
 
 // HANDLER
 
-xml_dom_handler::xml_dom_handler(xml_dom_handler&& rhs)
+xml_dom_handler::xml_dom_handler(xml_dom_handler&& rhs):
+    allocator_(rhs.allocator_)
 {
     swap(rhs);
 }
@@ -62,7 +63,8 @@ xml_dom_handler& xml_dom_handler::operator=(xml_dom_handler&& rhs)
 }
 
 
-xml_dom_handler::xml_dom_handler(xml_node_t& root):
+xml_dom_handler::xml_dom_handler(xml_node_t& root, const allocator_type& allocator):
+    allocator_(allocator),
     root_(&root)
 {}
 
@@ -85,9 +87,16 @@ void xml_dom_handler::start_element(const string_wrapper& name, xml_attr_t&& att
     xml_node_list_t& list = parent->get_children();
 
     // create and append child
-    xml_node_t child;
-    child.set_tag(xml_string_t(name));
-    child.set_attrs(forward<xml_attr_t>(attrs));
+    xml_node_t child(allocator_);
+    child.set_tag(xml_string_t(name.data(), name.size(), allocator_));
+    if (attrs.get_allocator() == allocator_) {
+        child.set_attrs(forward<xml_attr_t>(attrs));
+    } else {
+        xml_attr_t& dst = child.get_attrs();
+        for (const auto& pair: attrs) {
+            dst.emplace(xml_string_t(pair.first, allocator_), xml_string_t(pair.second, allocator_));
+        }
+    }
     list.push_back(move(child));
 
     levels_.emplace_back(&*list.rbegin());
@@ -103,12 +112,13 @@ void xml_dom_handler::end_element(const string_wrapper& name)
 void xml_dom_handler::characters(const string_wrapper& content)
 {
     xml_node_t* current = levels_.back();
-    current->set_text(current->get_text() + xml_string_t(content));
+    current->get_text().append(content.data(), content.size());
 }
 
 
 void xml_dom_handler::swap(xml_dom_handler& rhs)
 {
+    // allocators are not propagated
     using PYCPP_NAMESPACE::swap;
 
     swap(root_, rhs.root_);
@@ -117,13 +127,21 @@ void xml_dom_handler::swap(xml_dom_handler& rhs)
 
 // DOCUMENT
 
+xml_document_t::xml_document_t(const allocator_type& allocator):
+    xml_node_t(allocator),
+    allocator_(allocator)
+{}
+
+
 xml_document_t::xml_document_t(xml_document_t&& rhs):
-    xml_node_t(move(rhs))
+    xml_node_t(move(rhs)),
+    allocator_(rhs.allocator_)
 {}
 
 
 xml_document_t& xml_document_t::operator=(xml_document_t&& rhs)
 {
+    // allocators are not propagated
     xml_node_t::operator=(move(rhs));
     return *this;
 }
@@ -139,7 +157,7 @@ void xml_document_t::loads(const string_wrapper& data)
 void xml_document_t::load(istream& stream)
 {
     xml_stream_reader reader;
-    xml_dom_handler handler(*this);
+    xml_dom_handler handler(*this, allocator_);
     reader.set_handler(handler);
     reader.open(stream);
 }
@@ -209,4 +227,10 @@ void xml_document_t::dump(const u16string_view& path, char c, int width)
 
 #endif                                          // WINDOWS
 
+
+auto xml_document_t::get_allocator() const -> allocator_type
+{
+    return allocator_;
+}
+
 PYCPP_END_NAMESPACE
@@ -24,12 +24,18 @@ PYCPP_BEGIN_NAMESPACE
 struct xml_dom_handler: xml_sax_handler
 {
 public:
+    // MEMBER TYPES
+    // ------------
+    using allocator_type = xml_node_t::allocator_type;
+
+    // MEMBER FUNCTIONS
+    // ----------------
     xml_dom_handler() = delete;
     xml_dom_handler(const xml_dom_handler&) = delete;
     xml_dom_handler& operator=(const xml_dom_handler&) = delete;
     xml_dom_handler(xml_dom_handler&&);
     xml_dom_handler& operator=(xml_dom_handler&&);
-    xml_dom_handler(xml_node_t&);
+    xml_dom_handler(xml_node_t&, const allocator_type& = allocator_type());
 
     // SAX EVENTS
     virtual void start_document() override;
@@ -42,6 +48,7 @@ public:
     void swap(xml_dom_handler&);
 
 private:
+    allocator_type allocator_;
     xml_node_t* root_ = nullptr;
     deque<xml_node_t*> levels_;
 };
@@ -49,10 +56,14 @@ private:
 
 /**
  *  \brief XML document type.
+ *
+ *  Parsed nodes are allocated from the document's allocator, so
+ *  a document may be parsed into an arena and released at once.
  */
 struct xml_document_t: xml_node_t
 {
     xml_document_t() = default;
+    explicit xml_document_t(const allocator_type&);
     xml_document_t(const xml_document_t&) = delete;
     xml_document_t& operator=(const xml_document_t&) = delete;
     xml_document_t(xml_document_t&&);
@@ -75,6 +86,12 @@ struct xml_document_t: xml_node_t
     void dump(const wstring_view&, char = ' ', int = 4);
     void dump(const u16string_view&, char = ' ', int = 4);
 #endif                                          // WINDOWS
+
+    // PROPERTIES
+    allocator_type get_allocator() const;
+
+private:
+    allocator_type allocator_;
 };
 
 PYCPP_END_NAMESPACE
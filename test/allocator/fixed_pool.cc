@@ -0,0 +1,91 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/allocator/fixed_pool.h>
+#include <pycpp/stl/utility.h>
+#include <pycpp/stl/vector.h>
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+
+PYCPP_USING_NAMESPACE
+
+// TESTS
+// -----
+
+
+TEST(fixed_pool, properties)
+{
+    fixed_pool pool(20, 4, 16);
+    EXPECT_EQ(pool.block_size(), 32);
+    EXPECT_EQ(pool.blocks_per_chunk(), 4);
+    EXPECT_EQ(pool.alignment(), 16);
+    EXPECT_EQ(pool.max_blocks(), 0);
+    EXPECT_EQ(pool.capacity(), 0);
+    EXPECT_EQ(pool.upstream(), new_delete_resource());
+
+    // blocks must hold the free list link
+    fixed_pool small(1, 0, 1);
+    EXPECT_GE(small.block_size(), sizeof(void*));
+    EXPECT_GT(small.blocks_per_chunk(), 0);
+}
+
+
+TEST(fixed_pool, allocate)
+{
+    fixed_pool pool(24, 4, 8);
+    vector<void*> blocks;
+    for (size_t i = 0; i < 10; ++i) {
+        void* p = pool.allocate();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 8, 0);
+        memset(p, static_cast<int>(i), 24);
+        blocks.push_back(p);
+    }
+    EXPECT_EQ(pool.capacity(), 12);
+
+    // freed blocks are reused, last in, first out
+    pool.deallocate(blocks[3]);
+    pool.deallocate(blocks[7]);
+    EXPECT_EQ(pool.allocate(), blocks[7]);
+    EXPECT_EQ(pool.allocate(), blocks[3]);
+    EXPECT_EQ(pool.capacity(), 12);
+
+    for (void* p: blocks) {
+        pool.deallocate(p);
+    }
+    pool.release();
+    EXPECT_EQ(pool.capacity(), 0);
+    EXPECT_NE(pool.allocate(), nullptr);
+}
+
+
+TEST(fixed_pool, max_blocks)
+{
+    fixed_pool pool(16, 4, 16, 6);
+    vector<void*> blocks;
+    for (size_t i = 0; i < 6; ++i) {
+        blocks.push_back(pool.allocate());
+    }
+    EXPECT_EQ(pool.capacity(), 6);
+    EXPECT_THROW(pool.allocate(), bad_alloc);
+
+    pool.deallocate(blocks.back());
+    EXPECT_EQ(pool.allocate(), blocks.back());
+    EXPECT_THROW(pool.allocate(), bad_alloc);
+}
+
+
+TEST(fixed_pool, move)
+{
+    fixed_pool x(16, 4);
+    void* p = x.allocate();
+    fixed_pool y(move(x));
+    EXPECT_EQ(x.capacity(), 0);
+    EXPECT_EQ(y.capacity(), 4);
+    y.deallocate(p);
+    EXPECT_EQ(y.allocate(), p);
+
+    x = move(y);
+    EXPECT_EQ(x.capacity(), 4);
+    EXPECT_EQ(y.capacity(), 0);
+}
@@ -0,0 +1,141 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/allocator/page.h>
+#include <pycpp/stl/vector.h>
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+
+PYCPP_USING_NAMESPACE
+
+// TESTS
+// -----
+
+
+TEST(page, is_relocatable)
+{
+    using allocator_type = page_arena_allocator<char>;
+    using arena_type = typename allocator_type::arena_type;
+    using resource_type = page_arena_resource<>;
+    static_assert(is_relocatable<page_allocator<char>>::value, "");
+    static_assert(is_relocatable<allocator_type>::value, "");
+    static_assert(!is_relocatable<arena_type>::value, "");
+    static_assert(is_relocatable<resource_type>::value, "");
+}
+
+
+TEST(page_allocator, page_allocator)
+{
+    using allocator_type = page_allocator<char>;
+    allocator_type allocator;
+
+    size_t page = page_region::page_size();
+    char* ptr = allocator.allocate(3 * page + 1);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % page, 0);
+    memset(ptr, 'a', 3 * page + 1);
+    allocator.deallocate(ptr, 3 * page + 1);
+
+    vector<int, page_allocator<int>> v(1000, 5);
+    EXPECT_EQ(v[999], 5);
+}
+
+
+TEST(page_region, page_region)
+{
+    size_t page = page_region::page_size();
+    page_region region(100 * page + 1);
+    EXPECT_EQ(region.reserved(), 101 * page);
+    EXPECT_EQ(region.committed(), 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(region.data()) % page, 0);
+
+    // commits grow in steps, and never past the reservation
+    region.commit(1);
+    EXPECT_GE(region.committed(), page);
+    region.data()[region.committed() - 1] = byte(1);
+    region.commit(region.reserved());
+    EXPECT_EQ(region.committed(), region.reserved());
+    EXPECT_THROW(region.commit(region.reserved() + 1), bad_alloc);
+
+    // decommitted pages read as zero
+    region.data()[0] = byte(1);
+    region.decommit();
+    region.commit(page);
+    EXPECT_EQ(region.data()[0], byte(0));
+
+    page_region other(move(region));
+    EXPECT_EQ(region.data(), nullptr);
+    EXPECT_EQ(other.reserved(), 101 * page);
+}
+
+
+TEST(page_arena, page_arena)
+{
+    using allocator_type = page_arena_allocator<char>;
+    using arena_type = typename allocator_type::arena_type;
+    arena_type arena(1 << 24);
+    allocator_type allocator(arena);
+    EXPECT_EQ(arena.reserved(), 1 << 24);
+    EXPECT_EQ(arena.used(), 0);
+
+    char* ptr = allocator.allocate(50);
+    allocator.deallocate(ptr, 50);
+    EXPECT_EQ(arena.used(), 64);
+    EXPECT_GE(arena.committed(), 64);
+
+    // grows in place, without a fixed size
+    char* large = allocator.allocate(4 << 20);
+    EXPECT_EQ(large, ptr + 64);
+    memset(large, 'a', 4 << 20);
+    EXPECT_GE(arena.committed(), (4 << 20) + 64);
+
+    // allocate larger than the reservation
+    EXPECT_THROW(allocator.allocate(1 << 24), bad_alloc);
+
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0);
+    EXPECT_EQ(allocator.allocate(50), ptr);
+    EXPECT_EQ(ptr[0], 0);
+}
+
+
+TEST(page_arena, huge_pages)
+{
+    using arena_type = page_arena<>;
+    arena_type arena(1 << 24, true);
+    byte* ptr = arena.allocate<1>(3 << 20);
+    memset(ptr, 0, 3 << 20);
+    EXPECT_GE(arena.committed(), 3 << 20);
+    arena.reset();
+}
+
+
+TEST(page_arena_allocator, vector)
+{
+    using allocator_type = page_arena_allocator<int>;
+    using arena_type = typename allocator_type::arena_type;
+    using vector = vector<int, allocator_type>;
+
+    arena_type arena;
+    vector v1(arena);
+    for (int i = 0; i < 100000; ++i) {
+        v1.emplace_back(i);
+    }
+    EXPECT_EQ(v1[99999], 99999);
+}
+
+
+TEST(page_arena_allocator, polymorphic)
+{
+    using allocator_type = polymorphic_allocator<int>;
+    using resource_type = page_arena_resource<>;
+    using arena_type = typename resource_type::allocator_type::arena_type;
+    using vector = vector<int, allocator_type>;
+
+    arena_type arena;
+    resource_type resource(arena);
+    vector v1 = vector(allocator_type(&resource));
+    v1.emplace_back(1);
+
+    EXPECT_GE(arena.used(), sizeof(int));
+}
@@ -2,7 +2,11 @@
 //  :license: MIT, see licenses/mit.md for more details.
 
 #include <pycpp/allocator/pool.h>
+#include <pycpp/stl/list.h>
+#include <pycpp/stl/map.h>
+#include <pycpp/stl/vector.h>
 #include <gtest/gtest.h>
+#include <stdint.h>
 
 PYCPP_USING_NAMESPACE
 
@@ -10,17 +14,151 @@ PYCPP_USING_NAMESPACE
 // -----
 
 
+TEST(pool, is_relocatable)
+{
+    using allocator_type = pool_allocator<char>;
+    using arena_type = typename allocator_type::arena_type;
+    using resource_type = pool_resource<>;
+    static_assert(is_relocatable<allocator_type>::value, "");
+    static_assert(!is_relocatable<arena_type>::value, "");
+    static_assert(is_relocatable<resource_type>::value, "");
+}
+
+
+TEST(size_class_pool, size_class_pool)
+{
+    size_class_pool pool(0, 1000, 16);
+    EXPECT_EQ(pool.max_block_size(), 1024);
+    EXPECT_EQ(pool.alignment(), 16);
+    EXPECT_EQ(pool.block_size(0), 16);
+    EXPECT_EQ(pool.block_size(1), 16);
+    EXPECT_EQ(pool.block_size(16), 16);
+    EXPECT_EQ(pool.block_size(17), 32);
+    EXPECT_EQ(pool.block_size(256), 256);
+    EXPECT_EQ(pool.block_size(257), 512);
+    EXPECT_EQ(pool.block_size(1024), 1024);
+    EXPECT_EQ(pool.block_size(1025), 1025);
+
+    // blocks of a size class are reused
+    void* p = pool.allocate(40);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 16, 0);
+    pool.deallocate(p, 40);
+    EXPECT_EQ(pool.allocate(48), p);
+    pool.deallocate(p, 48);
+
+    // large or overaligned blocks use upstream
+    void* large = pool.allocate(4096);
+    pool.deallocate(large, 4096);
+    void* aligned = pool.allocate(32, 64);
+    pool.deallocate(aligned, 32, 64);
+    pool.release();
+}
+
+
 TEST(pool_allocator, pool_allocator)
 {
-// TODO: restore
-//    using allocator_type = pool_allocator<char>;
-//    allocator_type allocator;
-//
-//    char* ptr = allocator.allocate(50);
-//    allocator.deallocate(ptr, 50);
-//
-//    ptr = allocator.allocate(50);
-//    allocator.construct(ptr, 0);
-//    allocator.destroy(ptr);
-//    allocator.deallocate(ptr, 50);
+    using allocator_type = pool_allocator<char>;
+    using arena_type = typename allocator_type::arena_type;
+    arena_type arena;
+    allocator_type allocator(arena);
+
+    char* ptr = allocator.allocate(50);
+    allocator.deallocate(ptr, 50);
+    EXPECT_EQ(allocator.allocate(64), ptr);
+    allocator.deallocate(ptr, 64);
+
+    // larger than the largest block
+    ptr = allocator.allocate(10000);
+    allocator.deallocate(ptr, 10000);
+}
+
+
+TEST(pool_allocator, equality)
+{
+    using allocator_type = pool_allocator<int>;
+    using arena_type = typename allocator_type::arena_type;
+    arena_type a1, a2;
+    allocator_type x(a1), y(a1), z(a2);
+    pool_allocator<double> w(x);
+
+    EXPECT_EQ(x, y);
+    EXPECT_EQ(x, w);
+    EXPECT_NE(x, z);
+}
+
+
+TEST(pool_allocator, list)
+{
+    using allocator_type = pool_allocator<int, 32>;
+    using arena_type = typename allocator_type::arena_type;
+    using list = std::list<int, allocator_type>;
+
+    arena_type arena;
+    list l((allocator_type(arena)));
+    for (int i = 0; i < 1000; ++i) {
+        l.push_back(i);
+    }
+    for (int i = 0; i < 500; ++i) {
+        l.pop_front();
+    }
+    for (int i = 0; i < 500; ++i) {
+        l.push_front(i);
+    }
+    EXPECT_EQ(l.size(), 1000);
+    EXPECT_EQ(l.front(), 499);
+    EXPECT_EQ(l.back(), 999);
+}
+
+
+TEST(pool_allocator, map)
+{
+    using value_type = std::pair<const int, int>;
+    using allocator_type = pool_locked_allocator<value_type>;
+    using arena_type = typename allocator_type::arena_type;
+    using map = std::map<int, int, std::less<int>, allocator_type>;
+
+    arena_type arena;
+    map m((std::less<int>()), (allocator_type(arena)));
+    for (int i = 0; i < 1000; ++i) {
+        m.emplace(i, -i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        m.erase(i);
+    }
+    EXPECT_EQ(m.size(), 500);
+    EXPECT_EQ(m.at(1), -1);
+    EXPECT_EQ(m.count(2), 0);
+}
+
+
+TEST(pool_allocator, vector)
+{
+    using allocator_type = pool_allocator<int>;
+    using arena_type = typename allocator_type::arena_type;
+    using vector = vector<int, allocator_type>;
+
+    arena_type arena;
+    vector v1(arena);
+    for (int i = 0; i < 2000; ++i) {
+        v1.emplace_back(i);
+    }
+    EXPECT_EQ(v1[1999], 1999);
+}
+
+
+TEST(pool_allocator, polymorphic)
+{
+    using allocator_type = polymorphic_allocator<int>;
+    using resource_type = pool_resource<>;
+    using arena_type = typename resource_type::allocator_type::arena_type;
+    using list = list<int, allocator_type>;
+
+    arena_type arena;
+    resource_type resource(arena);
+    list l1 = list(allocator_type(&resource));
+    for (int i = 0; i < 100; ++i) {
+        l1.emplace_back(i);
+    }
+    l1.clear();
+    arena.reset();
 }
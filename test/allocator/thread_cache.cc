@@ -0,0 +1,143 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/allocator/thread_cache.h>
+#include <pycpp/stl/algorithm.h>
+#include <pycpp/stl/map.h>
+#include <pycpp/stl/string.h>
+#include <pycpp/stl/thread.h>
+#include <pycpp/stl/vector.h>
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+
+PYCPP_USING_NAMESPACE
+
+// TESTS
+// -----
+
+
+TEST(thread_cache_resource, properties)
+{
+    thread_cache_resource resource(1000);
+    EXPECT_EQ(resource.max_block_size(), 1024);
+    EXPECT_EQ(resource.upstream(), new_delete_resource());
+    EXPECT_TRUE(resource.is_equal(resource));
+    EXPECT_FALSE(resource.is_equal(*new_delete_resource()));
+}
+
+
+TEST(thread_cache_resource, allocate)
+{
+    thread_cache_resource resource;
+    vector<void*> blocks;
+    for (size_t i = 0; i < 1000; ++i) {
+        void* p = resource.allocate(24);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(max_align_t), 0);
+        memset(p, static_cast<int>(i), 24);
+        blocks.push_back(p);
+    }
+    for (void* p: blocks) {
+        resource.deallocate(p, 24);
+    }
+
+    // freed blocks are reused by the same thread
+    void* p = resource.allocate(32);
+    EXPECT_NE(find(blocks.begin(), blocks.end(), p), blocks.end());
+    resource.deallocate(p, 32);
+
+    // large and overaligned blocks use upstream
+    p = resource.allocate(10000);
+    resource.deallocate(p, 10000);
+    p = resource.allocate(64, 256);
+    resource.deallocate(p, 64, 256);
+    resource.flush();
+}
+
+
+TEST(thread_cache_resource, cross_thread)
+{
+    thread_cache_resource resource;
+    vector<char*> blocks(1000);
+
+    // allocate from one thread, free from another
+    thread producer([&]() {
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            blocks[i] = static_cast<char*>(resource.allocate(48));
+            memset(blocks[i], 'a', 48);
+        }
+    });
+    producer.join();
+
+    thread consumer([&]() {
+        for (char* p: blocks) {
+            EXPECT_EQ(p[47], 'a');
+            resource.deallocate(p, 48);
+        }
+    });
+    consumer.join();
+
+    // blocks flushed when the consumer exited are reused
+    char* p = static_cast<char*>(resource.allocate(48));
+    EXPECT_NE(find(blocks.begin(), blocks.end(), p), blocks.end());
+    resource.deallocate(p, 48);
+}
+
+
+TEST(thread_cache_resource, threads)
+{
+    thread_cache_resource resource;
+    vector<thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&resource, t]() {
+            using allocator_type = polymorphic_allocator<std::pair<const int, string>>;
+            using map_type = std::map<int, string, std::less<int>, allocator_type>;
+            map_type map((std::less<int>()), allocator_type(&resource));
+            for (int i = 0; i < 2000; ++i) {
+                map.emplace(i, string(static_cast<size_t>(i % 100), 'a' + static_cast<char>(t)));
+            }
+            for (int i = 0; i < 2000; i += 2) {
+                map.erase(i);
+            }
+            EXPECT_EQ(map.size(), 1000);
+            EXPECT_EQ(map.at(99).size(), 99);
+        });
+    }
+    for (thread& t: threads) {
+        t.join();
+    }
+}
+
+
+TEST(thread_cache_resource, default_resource)
+{
+    thread_cache_resource resource;
+    memory_resource* previous = set_default_resource(&resource);
+    {
+        vector<int> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.push_back(i);
+        }
+        EXPECT_EQ(v.get_allocator().resource(), &resource);
+        EXPECT_EQ(v[999], 999);
+    }
+    set_default_resource(previous);
+}
+
+
+TEST(thread_cache_resource, lifetime)
+{
+    // caches of destroyed resources are dropped
+    for (size_t i = 0; i < 4; ++i) {
+        thread_cache_resource resource(256);
+        void* p = resource.allocate(16);
+        resource.deallocate(p, 16);
+    }
+
+    thread_cache_resource resource;
+    thread worker([&]() {
+        void* p = resource.allocate(100);
+        resource.deallocate(p, 100);
+    });
+    worker.join();
+}
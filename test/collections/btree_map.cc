@@ -6,10 +6,29 @@
  */
 
 #include <pycpp/collections/btree_map.h>
+#include <pycpp/stl/string.h>
+#include <pycpp/stl/vector.h>
 #include <gtest/gtest.h>
 
 PYCPP_USING_NAMESPACE
 
+// HELPERS
+// -------
+
+
+static string make_key(int i, size_t width = 0)
+{
+    string key;
+    do {
+        key.insert(key.begin(), static_cast<char>('0' + i % 10));
+        i /= 10;
+    } while (i);
+    if (key.size() < width) {
+        key.insert(0, width - key.size(), '0');
+    }
+    return key;
+}
+
 // TESTS
 // -----
 
@@ -30,3 +49,35 @@ TEST(btree_map, constructor_null)
     EXPECT_TRUE(m1.find(1) != m1.end());
     EXPECT_TRUE(m2.find(1) == m2.end());
 }
+
+
+TEST(btree_map, bulk_load)
+{
+    using map = btree_map<string, int>;
+    vector<pair<string, int>> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.emplace_back(make_key(i, 4), i);
+    }
+
+    map m1, m2;
+    m1.bulk_load(values.begin(), values.end(), 0.75);
+    m1.verify();
+    EXPECT_EQ(m1.size(), 1000);
+    EXPECT_EQ(m1["0999"], 999);
+
+    for (int i = 0; i < 1000; i += 2) {
+        m2.insert(make_pair(make_key(i), -i));
+    }
+    m1.merge(m2);
+    m1.verify();
+    m2.verify();
+    EXPECT_EQ(m1.size(), 1500);
+    EXPECT_EQ(m2.size(), 0);
+    EXPECT_EQ(m1["0998"], 998);
+    EXPECT_EQ(m1["998"], -998);
+
+    m1.erase(m1.begin(), m1.lower_bound("1"));
+    m1.verify();
+    EXPECT_EQ(m1.size(), 499);
+    EXPECT_EQ(m1.begin()->first, "10");
+}
@@ -6,10 +6,37 @@
  */
 
 #include <pycpp/collections/btree_set.h>
+#include <pycpp/stl/vector.h>
 #include <gtest/gtest.h>
 
 PYCPP_USING_NAMESPACE
 
+// HELPERS
+// -------
+
+
+template <typename T>
+static void test_bounds(T first, T step)
+{
+    // every key appears twice, so both bounds fall inside nodes
+    btree_multiset<T> s;
+    for (int i = 0; i < 1000; ++i) {
+        s.insert(static_cast<T>(first + i * step));
+        s.insert(static_cast<T>(first + i * step));
+    }
+    s.verify();
+
+    for (int i = 0; i < 1000; ++i) {
+        T key = static_cast<T>(first + i * step);
+        EXPECT_EQ(distance(s.begin(), s.lower_bound(key)), 2 * i);
+        EXPECT_EQ(distance(s.begin(), s.upper_bound(key)), 2 * i + 2);
+        EXPECT_EQ(s.count(key), 2);
+    }
+    EXPECT_TRUE(s.lower_bound(static_cast<T>(first - step)) == s.begin());
+    EXPECT_TRUE(s.upper_bound(static_cast<T>(first + 1000 * step)) == s.end());
+    EXPECT_TRUE(s.find(static_cast<T>(first + step / 2)) == s.end());
+}
+
 // TESTS
 // -----
 
@@ -66,3 +93,148 @@ TEST(btree_multiset, constructor_null)
     EXPECT_TRUE(s1.find(1) == s1.end());
     EXPECT_TRUE(s2.find(1) != s2.end());
 }
+
+
+TEST(btree_set, bulk_load)
+{
+    using set = btree_set<int>;
+    vector<int> values;
+    for (int i = 0; i < 10000; ++i) {
+        values.push_back(i / 2);
+    }
+
+    set s1, s2;
+    s1.bulk_load(values.begin(), values.end());
+    s1.verify();
+    EXPECT_EQ(s1.size(), 5000);
+    EXPECT_GT(s1.fullness(), 0.95);
+    EXPECT_TRUE(s1.find(4999) != s1.end());
+    EXPECT_TRUE(s1.find(5000) == s1.end());
+
+    // partially filled nodes leave room for later insertions
+    s2.bulk_load(values.begin(), values.end(), 0.5);
+    s2.verify();
+    EXPECT_EQ(s2.size(), 5000);
+    EXPECT_LT(s2.fullness(), 0.6);
+    EXPECT_GT(s2.nodes(), s1.nodes());
+
+    for (int i = 5000; i < 6000; ++i) {
+        s1.insert(i);
+    }
+    for (int i = 0; i < 6000; i += 3) {
+        s1.erase(i);
+    }
+    s1.verify();
+    EXPECT_EQ(s1.size(), 4000);
+
+    // small and empty ranges
+    s1.bulk_load(values.begin(), values.begin() + 3);
+    s1.verify();
+    EXPECT_EQ(s1.size(), 2);
+    s1.bulk_load(values.begin(), values.begin());
+    EXPECT_TRUE(s1.empty());
+}
+
+
+TEST(btree_set, merge)
+{
+    using set = btree_set<int>;
+    set s1, s2;
+    for (int i = 0; i < 3000; i += 2) {
+        s1.insert(i);
+    }
+    for (int i = 0; i < 3000; i += 3) {
+        s2.insert(i);
+    }
+
+    // union with a sorted range
+    set s3;
+    s3.merge(s1.begin(), s1.end());
+    s3.merge(s2.begin(), s2.end());
+    s3.verify();
+    EXPECT_EQ(s3.size(), 2000);
+
+    // values already in the set stay in the source
+    s1.merge(s2);
+    s1.verify();
+    s2.verify();
+    EXPECT_TRUE(s1 == s3);
+    EXPECT_EQ(s2.size(), 500);
+    EXPECT_TRUE(s2.find(6) != s2.end());
+    EXPECT_TRUE(s2.find(3) == s2.end());
+
+    // small sets are inserted one value at a time
+    set s4;
+    s4.insert(3001);
+    s4.insert(4);
+    s1.merge(s4);
+    EXPECT_EQ(s1.size(), 2001);
+    EXPECT_EQ(s4.size(), 1);
+}
+
+
+TEST(btree_set, erase_range)
+{
+    using set = btree_set<int>;
+    set s;
+    for (int i = 0; i < 10000; ++i) {
+        s.insert(i);
+    }
+
+    // small range
+    s.erase(s.find(100), s.find(110));
+    s.verify();
+    EXPECT_EQ(s.size(), 9990);
+    EXPECT_TRUE(s.find(105) == s.end());
+
+    // large range
+    s.erase(s.find(1000), s.find(9000));
+    s.verify();
+    EXPECT_EQ(s.size(), 1990);
+    EXPECT_TRUE(s.find(999) != s.end());
+    EXPECT_TRUE(s.find(5000) == s.end());
+    EXPECT_TRUE(s.find(9000) != s.end());
+
+    s.erase(s.begin(), s.end());
+    EXPECT_TRUE(s.empty());
+}
+
+
+TEST(btree_multiset, bulk_load)
+{
+    using set = btree_multiset<int>;
+    vector<int> values;
+    for (int i = 0; i < 10000; ++i) {
+        values.push_back(i / 2);
+    }
+
+    set s1, s2;
+    s1.bulk_load(values.begin(), values.end());
+    s1.verify();
+    EXPECT_EQ(s1.size(), 10000);
+    EXPECT_EQ(s1.count(100), 2);
+
+    s2.insert(100);
+    s2.insert(20000);
+    s1.merge(s2);
+    s1.verify();
+    EXPECT_TRUE(s2.empty());
+    EXPECT_EQ(s1.size(), 10002);
+    EXPECT_EQ(s1.count(100), 3);
+
+    s1.erase(50);
+    s1.verify();
+    EXPECT_EQ(s1.size(), 10000);
+}
+
+
+TEST(btree_multiset, arithmetic_search)
+{
+    test_bounds<int32_t>(-1000, 3);
+    test_bounds<uint32_t>(0x7FFFF000U, 8);
+    test_bounds<int64_t>(-(int64_t(1) << 40), int64_t(1) << 30);
+    test_bounds<uint64_t>((uint64_t(1) << 63) - 500000, 1000);
+    test_bounds<int16_t>(-1000, 2);
+    test_bounds<float>(-100.0f, 0.25f);
+    test_bounds<double>(-1e10, 1e7);
+}
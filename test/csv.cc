@@ -5,6 +5,7 @@
  *  \brief CSV unittests.
  */
 
+#include <pycpp/allocator/page.h>
 #include <pycpp/csv.h>
 #include <pycpp/filesystem.h>
 #include <pycpp/stl/fstream.h>
@@ -209,6 +210,23 @@ TEST(csv_string_reader, move)
     EXPECT_FALSE(bool(r2));
 }
 
+
+TEST(csv_string_reader, allocator)
+{
+    page_arena_resource<>::allocator_type::arena_type arena;
+    page_arena_resource<> resource(arena);
+    {
+        csv_string_reader reader(CSV_SIMPLE_ALL, 0, nullptr, &resource);
+        EXPECT_EQ(reader.get_allocator().resource(), &resource);
+        csv_row row = reader();
+        EXPECT_EQ(row, CSV_HEADER);
+        EXPECT_EQ(row.get_allocator().resource(), &resource);
+        EXPECT_EQ(row.front().get_allocator().resource(), &resource);
+        EXPECT_GT(arena.used(), 0);
+    }
+    arena.reset();
+}
+
 // SIMPLE WRITER
 
 
@@ -449,6 +467,23 @@ TEST(csv_dict_string_reader, move)
 }
 
 
+TEST(csv_dict_string_reader, allocator)
+{
+    page_arena_resource<>::allocator_type::arena_type arena;
+    page_arena_resource<> resource(arena);
+    {
+        csv_dict_string_reader reader(CSV_SIMPLE_ALL, 0, nullptr, &resource);
+        EXPECT_EQ(reader.get_allocator().resource(), &resource);
+        csv_map map = reader();
+        EXPECT_EQ(map, CSV_MAP);
+        EXPECT_EQ(map.get_allocator().resource(), &resource);
+        EXPECT_EQ(map.begin()->first.get_allocator().resource(), &resource);
+        EXPECT_EQ(map.begin()->second.get_allocator().resource(), &resource);
+    }
+    arena.reset();
+}
+
+
 // DICT WRITER
 
 TEST(csv_dict_stream_writer, simple_all)
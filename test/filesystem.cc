@@ -6,7 +6,12 @@
  */
 
 #include <pycpp/filesystem.h>
+#include <pycpp/filesystem/exception.h>
+#include <pycpp/stl/algorithm.h>
 #include <pycpp/stl/fstream.h>
+#include <pycpp/stl/map.h>
+#include <pycpp/stl/mutex.h>
+#include <pycpp/stl/stdexcept.h>
 #include <pycpp/stl/vector.h>
 #include <gtest/gtest.h>
 
@@ -101,6 +106,52 @@ TEST(directory_iterator, recursive_directory_iterator)
 }
 
 
+TEST(walk, walk)
+{
+    // collect the relative paths and types from every batch
+    mutex lock;
+    map<path_t, walk_type> entries;
+    size_t depth = 0;
+    auto collect = [&](walk_batch& batch) {
+        lock_guard<mutex> guard(lock);
+        for (const walk_entry& entry: batch.entries) {
+            entries[batch.path(entry)] = entry.type;
+            depth = max(depth, batch.depth);
+        }
+    };
+
+    path_t root(path_prefix("test/directory"));
+    path_t file = join_path({root, path_prefix("file")});
+    path_t folder = join_path({root, path_prefix("folder")});
+    path_t nested = join_path({folder, path_prefix("file")});
+
+    walk_options options;
+    options.threads = 4;
+    options.batch_size = 1;
+    options.stat = true;
+    walk(root, collect, nullptr, options);
+    ASSERT_EQ(entries.size(), 3);
+    EXPECT_EQ(entries[file], walk_file);
+    EXPECT_EQ(entries[folder], walk_directory);
+    EXPECT_EQ(entries[nested], walk_file);
+    EXPECT_EQ(depth, 1);
+
+    // prune the subdirectory
+    entries.clear();
+    walk(root, collect, [](const walk_batch&, const walk_entry& entry) {
+        return entry.basename == path_prefix("folder");
+    });
+    EXPECT_EQ(entries.size(), 2);
+    EXPECT_EQ(entries.count(nested), 0);
+
+    // errors
+    EXPECT_THROW(walk(path_prefix("test/missing"), collect), filesystem_error);
+    EXPECT_THROW(walk(root, [](walk_batch&) {
+        throw runtime_error("");
+    }), runtime_error);
+}
+
+
 TEST(stat, stat)
 {
     auto s = stat("test/files");
@@ -525,3 +576,52 @@ TEST(remove, remove_dir)
     }
 }
 
+
+TEST(copy, copy_file)
+{
+    // larger than the user-space buffer, and not a multiple of it
+    string src("sample_copy_src");
+    string dst("sample_copy_dst");
+    string data;
+    for (size_t i = 0; data.size() < (3 << 20) + 17; ++i) {
+        data.push_back(static_cast<char>(i * 31));
+    }
+    {
+        ofstream stream(src, ios_base::out | ios_base::binary);
+        stream.write(data.data(), data.size());
+    }
+
+    EXPECT_TRUE(copy_file(src, dst));
+    EXPECT_EQ(getsize(dst), data.size());
+    {
+        ifstream stream(dst, ios_base::in | ios_base::binary);
+        string copy((istreambuf_iterator<char>(stream)), istreambuf_iterator<char>());
+        EXPECT_TRUE(copy == data);
+    }
+
+    EXPECT_THROW(copy_file(src, dst), filesystem_error);
+    EXPECT_TRUE(copy_file(src, dst, true));
+    EXPECT_EQ(getsize(dst), data.size());
+
+    EXPECT_TRUE(remove_file(src));
+    EXPECT_TRUE(remove_file(dst));
+}
+
+
+TEST(copy, copy_dir_parallel)
+{
+    string dst("sample_copy_folder");
+    ASSERT_FALSE(exists(dst));
+
+    EXPECT_TRUE(copy_dir_parallel("test/directory", dst, false, 4));
+    EXPECT_TRUE(isfile(join_path({dst, "file"})));
+    EXPECT_TRUE(isdir(join_path({dst, "folder"})));
+    EXPECT_TRUE(isfile(join_path({dst, "folder", "file"})));
+    EXPECT_EQ(getsize(join_path({dst, "folder", "file"})), getsize("test/directory/folder/file"));
+
+    EXPECT_TRUE(copy_dir_parallel("test/directory", dst, true));
+    EXPECT_TRUE(isfile(join_path({dst, "folder", "file"})));
+
+    EXPECT_TRUE(remove_dir(dst));
+    EXPECT_FALSE(exists(dst));
+}
@@ -6,6 +6,8 @@
  */
 
 #include <pycpp/hashlib.h>
+#include <pycpp/hashlib/kernel.h>
+#include <pycpp/stl/algorithm.h>
 #include <pycpp/stl/random.h>
 #include <pycpp/stl/utility.h>
 #include <pycpp/stl/vector.h>
@@ -13,6 +15,25 @@
 
 PYCPP_USING_NAMESPACE
 
+// ALIAS
+// -----
+
+using batch_array_t = void (*)(const void* const*, const size_t*, size_t, void*);
+using batch_string_t = void (*)(const string_wrapper*, size_t, void*);
+using digest_list_t = vector<secure_string>;
+
+// DATA
+// ----
+
+// FIPS 180 test vectors, including a message of 1 million 'a's
+static const vector<string> KERNEL_MESSAGES = {
+    "",
+    "abc",
+    "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+    "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+    string(1000000, 'a'),
+};
+
 // FUNCTIONS
 // ---------
 
@@ -20,7 +41,17 @@ template <typename List, typename Hasher>
 static void test_digest(const List& list, const Hasher&)
 {
     for (const auto &pair: list) {
-        EXPECT_EQ(Hasher(pair.first.view()).hexdigest(), pair.second);
+        Hasher hash(pair.first.view());
+        EXPECT_EQ(hash.hexdigest(), pair.second);
+
+        // allocation-free digests
+        typename Hasher::digest_type digest;
+        hash.digest_into(digest);
+        EXPECT_EQ(secure_string((const char*) digest.data(), digest.size()), hash.digest());
+
+        char hex[2 * Hasher::digest_size];
+        hash.hexdigest_into(hex);
+        EXPECT_EQ(secure_string(hex, sizeof(hex)), pair.second);
     }
 }
 
@@ -33,6 +64,9 @@ static void test_update(const List& list, const Hasher&)
 
     hash.update("x");
     EXPECT_EQ(hash.hexdigest(), list[1]);
+
+    Hasher moved(move(hash));
+    EXPECT_EQ(moved.hexdigest(), list[1]);
 }
 
 
@@ -53,6 +87,95 @@ static void test_fuzz(const Hasher&, size_t n)
     }
 }
 
+
+template <typename Hasher>
+static void test_batch(const Hasher&, batch_array_t batch_array, batch_string_t batch_string, size_t n)
+{
+    // lengths around the block and padding boundaries
+    vector<string> messages;
+    for (size_t length = 0; length < 300; length += 1 + length / 16) {
+        string message;
+        for (size_t i = 0; i < length; ++i) {
+            message.push_back(static_cast<char>(rand()));
+        }
+        messages.emplace_back(move(message));
+    }
+
+    vector<const void*> src;
+    vector<size_t> srclen;
+    vector<string_wrapper> str;
+    for (const string& message: messages) {
+        src.push_back(message.data());
+        srclen.push_back(message.size());
+        str.emplace_back(message);
+    }
+
+    string actual(n * messages.size(), '\0');
+    batch_array(src.data(), srclen.data(), messages.size(), &actual[0]);
+    for (size_t i = 0; i < messages.size(); ++i) {
+        EXPECT_EQ(secure_string(actual.data() + i * n, n), Hasher(messages[i]).digest());
+    }
+
+    string strings(n * messages.size(), '\0');
+    batch_string(str.data(), str.size(), &strings[0]);
+    EXPECT_EQ(strings, actual);
+
+    // empty batch
+    batch_array(src.data(), srclen.data(), 0, nullptr);
+}
+
+
+/**
+ *  \brief Check every supported block kernel against reference digests.
+ */
+template <typename Hasher, typename Kernel>
+static void test_kernels(const Hasher&, hash_kernel_table<Kernel> table, Kernel& kernel, const digest_list_t& digests)
+{
+    Kernel selected = kernel;
+    for (const hash_kernel<Kernel>& item: table) {
+        if (!item.supported()) {
+            continue;
+        }
+        SCOPED_TRACE(item.name);
+        kernel = item.kernel;
+
+        for (size_t i = 0; i < KERNEL_MESSAGES.size(); ++i) {
+            // offset the message so blocks are not aligned
+            string buffer = "x" + KERNEL_MESSAGES[i];
+            const char* data = buffer.data() + 1;
+            size_t size = KERNEL_MESSAGES[i].size();
+            EXPECT_EQ(Hasher(data, size).hexdigest(), digests[i]);
+
+            // updates that straddle block boundaries
+            Hasher hash;
+            for (size_t j = 0; j < size; j += 1000) {
+                hash.update(data + j, min<size_t>(1000, size - j));
+            }
+            EXPECT_EQ(hash.hexdigest(), digests[i]);
+        }
+    }
+    kernel = selected;
+}
+
+
+/**
+ *  \brief Check every supported batch kernel against single digests.
+ */
+template <typename Hasher>
+static void test_batch_kernels(const Hasher& hasher, hash_kernel_table<multibuffer_kernel_t> table, multibuffer_kernel_t& kernel, batch_array_t batch_array, batch_string_t batch_string, size_t n)
+{
+    multibuffer_kernel_t selected = kernel;
+    for (const hash_kernel<multibuffer_kernel_t>& item: table) {
+        if (!item.supported()) {
+            continue;
+        }
+        SCOPED_TRACE(item.name);
+        kernel = item.kernel;
+        test_batch(hasher, batch_array, batch_string, n);
+    }
+    kernel = selected;
+}
+
 // TESTS
 // -----
 
@@ -228,6 +351,18 @@ TEST(md5, fuzz)
 }
 
 
+TEST(md5, batch)
+{
+    test_batch(md5_hash(), md5_digest_batch, md5_digest_batch, 16);
+}
+
+
+TEST(md5, batch_kernels)
+{
+    test_batch_kernels(md5_hash(), md5_batch_kernels(), md5_batch_kernel(), md5_digest_batch, md5_digest_batch, 16);
+}
+
+
 TEST(sha1, digest)
 {
     vector<pair<secure_string, secure_string>> tests = {
@@ -285,6 +420,31 @@ TEST(sha1, fuzz)
 }
 
 
+TEST(sha1, batch)
+{
+    test_batch(sha1_hash(), sha1_digest_batch, sha1_digest_batch, 20);
+}
+
+
+TEST(sha1, kernels)
+{
+    digest_list_t digests = {
+        "DA39A3EE5E6B4B0D3255BFEF95601890AFD80709",
+        "A9993E364706816ABA3E25717850C26C9CD0D89D",
+        "84983E441C3BD26EBAAE4AA1F95129E5E54670F1",
+        "A49B2446A02C645BF419F995B67091253A04A259",
+        "34AA973CD4C4DAA4F61EEB2BDBAD27316534016F",
+    };
+    test_kernels(sha1_hash(), sha1_kernels(), sha1_kernel(), digests);
+}
+
+
+TEST(sha1, batch_kernels)
+{
+    test_batch_kernels(sha1_hash(), sha1_batch_kernels(), sha1_batch_kernel(), sha1_digest_batch, sha1_digest_batch, 20);
+}
+
+
 TEST(sha2_256, digest)
 {
     vector<pair<secure_string, secure_string>> tests = {
@@ -342,6 +502,40 @@ TEST(sha2_256, fuzz)
 }
 
 
+TEST(sha2_256, batch)
+{
+    test_batch(sha2_256_hash(), sha2_256_digest_batch, sha2_256_digest_batch, 32);
+}
+
+
+TEST(sha2_256, kernels)
+{
+    digest_list_t digests = {
+        "E3B0C44298FC1C149AFBF4C8996FB92427AE41E4649B934CA495991B7852B855",
+        "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD",
+        "248D6A61D20638B8E5C026930C3E6039A33CE45964FF2167F6ECEDD419DB06C1",
+        "CF5B16A778AF8380036CE59E7B0492370B249B11E8F07A51AFAC45037AFEE9D1",
+        "CDC76E5C9914FB9281A1C7E284D73E67F1809A48A497200E046D39CCC7112CD0",
+    };
+    test_kernels(sha2_256_hash(), sha256_kernels(), sha256_kernel(), digests);
+
+    digests = {
+        "D14A028C2A3A2BC9476102BB288234C415A2B01F828EA62AC5B3E42F",
+        "23097D223405D8228642A477BDA255B32AADBCE4BDA0B3F7E36C9DA7",
+        "75388B16512776CC5DBA5DA1FD890150B0C6455CB4F58B1952522525",
+        "C97CA9A559850CE97A04A96DEF6D99A9E0E0E2AB14E6B8DF265FC0B3",
+        "20794655980C91D8BBB4C1EA97618A4BF03F42581948B2EE4EE7AD67",
+    };
+    test_kernels(sha2_224_hash(), sha256_kernels(), sha256_kernel(), digests);
+}
+
+
+TEST(sha2_256, batch_kernels)
+{
+    test_batch_kernels(sha2_256_hash(), sha256_batch_kernels(), sha256_batch_kernel(), sha2_256_digest_batch, sha2_256_digest_batch, 32);
+}
+
+
 TEST(sha2_224, digest)
 {
     vector<pair<secure_string, secure_string>> tests = {
@@ -513,6 +707,28 @@ TEST(sha2_512, fuzz)
 }
 
 
+TEST(sha2_512, kernels)
+{
+    digest_list_t digests = {
+        "CF83E1357EEFB8BDF1542850D66D8007D620E4050B5715DC83F4A921D36CE9CE47D0D13C5D85F2B0FF8318D2877EEC2F63B931BD47417A81A538327AF927DA3E",
+        "DDAF35A193617ABACC417349AE20413112E6FA4E89A97EA20A9EEEE64B55D39A2192992A274FC1A836BA3C23A3FEEBBD454D4423643CE80E2A9AC94FA54CA49F",
+        "204A8FC6DDA82F0A0CED7BEB8E08A41657C16EF468B228A8279BE331A703C33596FD15C13B1B07F9AA1D3BEA57789CA031AD85C7A71DD70354EC631238CA3445",
+        "8E959B75DAE313DA8CF4F72814FC143F8F7779C6EB9F7FA17299AEADB6889018501D289E4900F7E4331B99DEC4B5433AC7D329EEB6DD26545E96E55B874BE909",
+        "E718483D0CE769644E2E42C7BC15B4638E1F98B13B2044285632A803AFA973EBDE0FF244877EA60A4CB0432CE577C31BEB009C5C2C49AA2E4EADB217AD8CC09B",
+    };
+    test_kernels(sha2_512_hash(), sha512_kernels(), sha512_kernel(), digests);
+
+    digests = {
+        "38B060A751AC96384CD9327EB1B1E36A21FDB71114BE07434C0CC7BF63F6E1DA274EDEBFE76F65FBD51AD2F14898B95B",
+        "CB00753F45A35E8BB5A03D699AC65007272C32AB0EDED1631A8B605A43FF5BED8086072BA1E7CC2358BAECA134C825A7",
+        "3391FDDDFC8DC7393707A65B1B4709397CF8B1D162AF05ABFE8F450DE5F36BC6B0455A8520BC4E6F5FE95B1FE3C8452B",
+        "09330C33F71147E83D192FC782CD1B4753111B173B3B05D22FA08086E3B0F712FCC7C71A557E2DB966C3E9FA91746039",
+        "9D0E1809716474CB086E834E310A4A1CED149E9C00F248527972CEC5704C2A5B07B8B3DC38ECC4EBAE97DDD87F3D8985",
+    };
+    test_kernels(sha2_384_hash(), sha512_kernels(), sha512_kernel(), digests);
+}
+
+
 TEST(sha3_224, digest)
 {
     vector<pair<secure_string, secure_string>> tests = {
@@ -5,11 +5,59 @@
  *  \brief JSON DOM unittests.
  */
 
+#include <pycpp/allocator/page.h>
 #include <pycpp/json.h>
 #include <gtest/gtest.h>
 
 PYCPP_USING_NAMESPACE
 
+// HELPERS
+// -------
+
+/**
+ *  \brief Resource that aligns storage to exactly the requested alignment.
+ *
+ *  Each block is aligned to the requested alignment but not twice
+ *  it, so any storage used with a stricter alignment than requested
+ *  is misaligned.
+ */
+struct exact_alignment_resource: public memory_resource
+{
+    alignas(max_align_t) char buffer[1 << 16];
+    size_t used = 0;
+    bool misaligned = false;
+
+protected:
+    virtual void* do_allocate(size_t n, size_t alignment)
+    {
+        used = (used + alignment - 1) & ~(alignment - 1);
+        if (used % (2 * alignment) == 0) {
+            used += alignment;
+        }
+        if (used + n > sizeof(buffer)) {
+            throw std::bad_alloc();
+        }
+        void* p = buffer + used;
+        used += n;
+        return p;
+    }
+
+    virtual void do_deallocate(void*, size_t, size_t)
+    {}
+
+    virtual bool do_is_equal(const memory_resource& rhs) const noexcept
+    {
+        return this == &rhs;
+    }
+};
+
+
+template <typename T>
+static bool is_aligned(const T& t)
+{
+    return reinterpret_cast<uintptr_t>(&t) % alignof(T) == 0;
+}
+
 // TESTS
 // -----
 
@@ -50,3 +98,49 @@ TEST(json, dom)
     auto& o3 = d1.get_object();
     EXPECT_EQ(o3.size(), 7);
 }
+
+
+TEST(json, allocator)
+{
+    page_arena_resource<>::allocator_type::arena_type arena;
+    page_arena_resource<> resource(arena);
+    {
+        json_document_t d1(&resource);
+        d1.loads(" { \"hello\" : \"world\", \"a\":[1, 2, 3, 4] } ");
+        EXPECT_EQ(d1.get_allocator().resource(), &resource);
+        EXPECT_GT(arena.used(), 0);
+
+        // values, keys and containers are all allocated from the arena
+        ASSERT_TRUE(d1.has_object());
+        auto& o1 = d1.get_object();
+        EXPECT_EQ(o1.get_allocator().resource(), &resource);
+        EXPECT_EQ(o1.begin()->first.get_allocator().resource(), &resource);
+        EXPECT_EQ(o1.at("hello").get_string(), "world");
+        EXPECT_EQ(o1.at("hello").get_string().get_allocator().resource(), &resource);
+        EXPECT_EQ(o1.at("a").get_array().get_allocator().resource(), &resource);
+        EXPECT_EQ(o1.at("a").get_array().back().get_number(), 4.);
+    }
+
+    // release the whole document at once
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0);
+}
+
+
+TEST(json, alignment)
+{
+    exact_alignment_resource resource;
+    {
+        json_document_t d1(&resource);
+        d1.loads(" { \"hello\" : \"world\", \"a\":[1, 2, 3, 4] } ");
+
+        // containers are aligned even if the resource only honours the
+        // alignment requested
+        ASSERT_TRUE(d1.has_object());
+        auto& o1 = d1.get_object();
+        EXPECT_TRUE(is_aligned(o1));
+        EXPECT_TRUE(is_aligned(o1.at("hello").get_string()));
+        EXPECT_TRUE(is_aligned(o1.at("a").get_array()));
+        EXPECT_EQ(o1.at("a").get_array().back().get_number(), 4.);
+    }
+}
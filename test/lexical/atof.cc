@@ -81,6 +81,23 @@ TEST(atof32, base10)
 }
 
 
+TEST(atof32, rounding)
+{
+    // exact values, halfway cases and subnormals must be correctly rounded
+    EXPECT_EQ(atof32("16777217", 10), 16777216.f);
+    EXPECT_EQ(atof32("16777219", 10), 16777220.f);
+    EXPECT_EQ(atof32("3.4028235e38", 10), 3.4028235e38f);
+    EXPECT_TRUE(isinf(atof32("3.4028236e38", 10)));
+    EXPECT_EQ(atof32("1.17549435e-38", 10), 1.17549435e-38f);
+    EXPECT_EQ(atof32("1.4e-45", 10), 1.4e-45f);
+    EXPECT_EQ(atof32("7e-46", 10), 0.f);
+    EXPECT_EQ(atof32("7.1e-46", 10), 1.4e-45f);
+    EXPECT_EQ(atof32("0.1", 10), 0.1f);
+    EXPECT_EQ(atof32("1.00000005960464477539062499", 10), 1.f);
+    EXPECT_EQ(atof32("1.00000005960464477539062501", 10), 1.00000012f);
+}
+
+
 TEST(atof32, basen)
 {
     EXPECT_FLOAT_NEAR(atof32("YA", 36), 1234.);
@@ -127,6 +144,51 @@ TEST(atof64, base10)
 }
 
 
+TEST(atof64, rounding)
+{
+    // exact values, halfway cases and subnormals must be correctly rounded
+    EXPECT_EQ(atof64("9007199254740993", 10), 9007199254740992.);
+    EXPECT_EQ(atof64("9007199254740995", 10), 9007199254740996.);
+    EXPECT_EQ(atof64("0.1", 10), 0.1);
+    EXPECT_EQ(atof64("1e23", 10), 1e23);
+    EXPECT_EQ(atof64("1.7976931348623157e308", 10), 1.7976931348623157e308);
+    EXPECT_TRUE(isinf(atof64("1.7976931348623159e308", 10)));
+    EXPECT_EQ(atof64("2.2250738585072011e-308", 10), 2.2250738585072011e-308);
+    EXPECT_EQ(atof64("4.9406564584124654e-324", 10), 4.9406564584124654e-324);
+    EXPECT_EQ(atof64("2.4703282292062327e-324", 10), 0.);
+    EXPECT_EQ(atof64("2.4703282292062328e-324", 10), 4.9406564584124654e-324);
+    EXPECT_EQ(atof64("1e-400", 10), 0.);
+    EXPECT_TRUE(isinf(atof64("1e400", 10)));
+
+    // halfway between 1 and the next float, requires all digits
+    EXPECT_EQ(atof64("1.00000000000000011102230246251565404236316680908203125", 10), 1.);
+    EXPECT_EQ(atof64("1.00000000000000011102230246251565404236316680908203124", 10), 1.);
+    EXPECT_EQ(atof64("1.00000000000000011102230246251565404236316680908203126", 10), 1.0000000000000002);
+    EXPECT_EQ(atof64("-1.00000000000000011102230246251565404236316680908203126", 10), -1.0000000000000002);
+}
+
+
+TEST(atof64, last)
+{
+    const char* first = "1.5e3x";
+    const char* last = first + 6;
+    EXPECT_EQ(atof64(first, last), 1500.);
+    EXPECT_EQ(last, first + 5);
+
+    // exponent without digits is not consumed
+    first = "2.5e+";
+    last = first + 5;
+    EXPECT_EQ(atof64(first, last), 2.5);
+    EXPECT_EQ(last, first + 3);
+
+    // no digits
+    first = "-x";
+    last = first + 2;
+    EXPECT_EQ(atof64(first, last), 0.);
+    EXPECT_EQ(last, first);
+}
+
+
 TEST(atof64, basen)
 {
     EXPECT_FLOAT_NEAR(atof64("YA", 36), 1234.);
@@ -114,6 +114,8 @@ TEST(atoi32, base10)
     EXPECT_EQ(atoi32("2147483648", 10), -2147483648LL);
     EXPECT_EQ(atoi32("4294967295", 10), -1);
     EXPECT_EQ(atoi32("-1", 10), -1);
+    EXPECT_EQ(atoi32("-2147483648", 10), INT32_MIN);
+    EXPECT_EQ(atoi32("-10000000000000000000000000000000", 2), INT32_MIN);
     EXPECT_EQ(atoi32("1a", 10), 1);
 }
 
@@ -139,6 +141,8 @@ TEST(atoi64, base10)
 //    EXPECT_EQ(atoi64("9223372036854775808", 10), -9223372036854775808LL);
     EXPECT_EQ(atoi64("18446744073709551615", 10), -1);
     EXPECT_EQ(atoi64("-1", 10), -1);
+    EXPECT_EQ(atoi64("-9223372036854775808", 10), INT64_MIN);
+    EXPECT_EQ(atoi64("-8000000000000000", 16), INT64_MIN);
     EXPECT_EQ(atoi64("1a", 10), 1);
 }
 
@@ -155,3 +159,138 @@ TEST(atoi16, basen)
 {
     EXPECT_EQ(atoi16("YA", 36), 1234);
 }
+
+
+TEST(atou64, digits)
+{
+    // lengths on either side of the 8-digit blocks
+    EXPECT_EQ(atou64("1234567", 10), 1234567);
+    EXPECT_EQ(atou64("12345678", 10), 12345678);
+    EXPECT_EQ(atou64("123456789", 10), 123456789);
+    EXPECT_EQ(atou64("1234567890123456", 10), 1234567890123456ULL);
+    EXPECT_EQ(atou64("12345678901234567", 10), 12345678901234567ULL);
+    EXPECT_EQ(atou64("00000000000000000001", 10), 1);
+    EXPECT_EQ(atou64("18446744073709551615", 10), 18446744073709551615ULL);
+
+    // a number followed by other characters within the same block
+    std::string string = "12345,67890";
+    const char* first = string.data();
+    const char* last = first + string.size();
+    EXPECT_EQ(atou64(first, last, 10), 12345);
+    EXPECT_EQ(last, first + 5);
+
+    string = "1234567890123:";
+    last = string.data() + string.size();
+    EXPECT_EQ(atou64(string.data(), last, 10), 1234567890123ULL);
+    EXPECT_EQ(*last, ':');
+}
+
+
+TEST(atou64, base16)
+{
+    EXPECT_EQ(atou64("0", 16), 0);
+    EXPECT_EQ(atou64("fF", 16), 255);
+    EXPECT_EQ(atou64("deadBEEF", 16), 0xDEADBEEF);
+    EXPECT_EQ(atou64("123456789abcdef", 16), 0x123456789ABCDEFULL);
+    EXPECT_EQ(atou64("FFFFFFFFFFFFFFFF", 16), 18446744073709551615ULL);
+    EXPECT_EQ(atou64("1234abcdefg", 16), 0x1234ABCDEFULL);
+    EXPECT_EQ(atou64("12345678 9", 16), 0x12345678);
+    EXPECT_EQ(atoi32("-7fffffff", 16), -2147483647);
+
+    // control characters are not digits, even within an 8-digit block
+    for (char c = 0x10; c <= 0x19; ++c) {
+        std::string string = "1234567";
+        string.push_back(c);
+        const char* last = string.data() + string.size();
+        EXPECT_EQ(atou64(string.data(), last, 16), 0x1234567);
+        EXPECT_EQ(last, string.data() + 7);
+
+        uint64_t values[2];
+        last = string.data() + string.size();
+        EXPECT_EQ(atou64_batch(string.data(), last, values, 2, ',', 16), 1);
+        EXPECT_EQ(values[0], 0x1234567);
+        EXPECT_EQ(last, string.data() + 7);
+    }
+}
+
+
+TEST(atou64, batch)
+{
+    uint64_t values[4];
+    EXPECT_EQ(atou64_batch("", values, 4), 0);
+    EXPECT_EQ(atou64_batch("1,18446744073709551615,37", values, 4), 3);
+    EXPECT_EQ(values[0], 1);
+    EXPECT_EQ(values[1], 18446744073709551615ULL);
+    EXPECT_EQ(values[2], 37);
+
+    // stop at the count, an empty field, or an unexpected character
+    std::string string = "1\t2\t3\t4\t5";
+    const char* last = string.data() + string.size();
+    EXPECT_EQ(atou64_batch(string.data(), last, values, 4, '\t'), 4);
+    EXPECT_EQ(*last, '\t');
+
+    string = "1,2,,3";
+    last = string.data() + string.size();
+    EXPECT_EQ(atou64_batch(string.data(), last, values, 4), 2);
+    EXPECT_EQ(last, string.data() + 3);
+
+    string = "a,b;c";
+    last = string.data() + string.size();
+    EXPECT_EQ(atou64_batch(string.data(), last, values, 4, ',', 16), 2);
+    EXPECT_EQ(values[1], 11);
+    EXPECT_EQ(*last, ';');
+}
+
+
+TEST(atoi64, batch)
+{
+    int64_t values[3];
+    EXPECT_EQ(atoi64_batch("-1,+2,-9223372036854775808", values, 3), 3);
+    EXPECT_EQ(values[0], -1);
+    EXPECT_EQ(values[1], 2);
+    EXPECT_EQ(values[2], INT64_MIN);
+
+    int32_t values32[2];
+    EXPECT_EQ(atoi32_batch("-37 11", values32, 2, ' ', 36), 2);
+    EXPECT_EQ(values32[0], -115);
+    EXPECT_EQ(values32[1], 37);
+}
+
+
+TEST(atou64, batch_overflow)
+{
+    // overflowing fields stop the batch before their delimiter
+    uint64_t values[3];
+    std::string string = "1,18446744073709551616,2";
+    const char* last = string.data() + string.size();
+    EXPECT_EQ(atou64_batch(string.data(), last, values, 3), 1);
+    EXPECT_EQ(last, string.data() + 1);
+
+    EXPECT_EQ(atou64_batch("99999999999999999999", values, 3), 0);
+    EXPECT_EQ(atou64_batch("1844674407370955161500000000", values, 3), 0);
+    EXPECT_EQ(atou64_batch("-1", values, 3), 0);
+    EXPECT_EQ(atou64_batch("-0", values, 3), 1);
+    EXPECT_EQ(atou64_batch("ffffffffffffffff,10000000000000000", values, 3, ',', 16), 1);
+    EXPECT_EQ(values[0], 18446744073709551615ULL);
+    EXPECT_EQ(atou64_batch("3w5e11264sgsf,3w5e11264sgsg", values, 3, ',', 36), 1);
+    EXPECT_EQ(values[0], 18446744073709551615ULL);
+}
+
+
+TEST(atoi64, batch_overflow)
+{
+    int64_t values[2];
+    EXPECT_EQ(atoi64_batch("9223372036854775807,9223372036854775808", values, 2), 1);
+    EXPECT_EQ(values[0], INT64_MAX);
+    EXPECT_EQ(atoi64_batch("-9223372036854775808,-9223372036854775809", values, 2), 1);
+    EXPECT_EQ(values[0], INT64_MIN);
+    EXPECT_EQ(atoi64_batch("18446744073709551615", values, 2), 0);
+
+    int32_t values32[2];
+    EXPECT_EQ(atoi32_batch("-2147483648,2147483648", values32, 2), 1);
+    EXPECT_EQ(values32[0], INT32_MIN);
+
+    uint32_t valuesu32[2];
+    EXPECT_EQ(atou32_batch("4294967295,4294967296", valuesu32, 2), 1);
+    EXPECT_EQ(valuesu32[0], UINT32_MAX);
+}
@@ -136,6 +136,17 @@ TEST(f32toa, base10)
 }
 
 
+TEST(f32toa, shortest)
+{
+    EXPECT_EQ(f32toa(0.1f), "0.1");
+    EXPECT_EQ(f32toa(1.0f), "1");
+    EXPECT_EQ(f32toa(3.4028235e38f), "3.4028235e+38");
+    EXPECT_EQ(f32toa(1.4e-45f), "1e-45");
+    EXPECT_EQ(f32toa(16777216.f), "16777216");
+    EXPECT_EQ(f32toa(0.3f), "0.3");
+}
+
+
 TEST(f32toa, basen)
 {
     for (double d: FLOATS) {
@@ -193,6 +204,56 @@ TEST(f64toa, base10)
 }
 
 
+TEST(f64toa, shortest)
+{
+    // shortest representations which round-trip
+    EXPECT_EQ(f64toa(0.1), "0.1");
+    EXPECT_EQ(f64toa(0.3), "0.3");
+    EXPECT_EQ(f64toa(1.0), "1");
+    EXPECT_EQ(f64toa(1e23), "1e+23");
+    EXPECT_EQ(f64toa(5e-324), "5e-324");
+    EXPECT_EQ(f64toa(1.7976931348623157e308), "1.7976931348623157e+308");
+    EXPECT_EQ(f64toa(2.2250738585072014e-308), "2.2250738585072014e-308");
+    EXPECT_EQ(f64toa(9007199254740993.), "9007199254740992");
+    EXPECT_EQ(f64toa(-1.5), "-1.5");
+
+    for (double d: DOUBLES) {
+        EXPECT_EQ(atof64(f64toa(d)), d);
+    }
+}
+
+
+TEST(f64toa, format)
+{
+    // general
+    EXPECT_EQ(f64toa(1.5, float_general), "1.5");
+    EXPECT_EQ(f64toa(1e20, float_general), "1e+20");
+    EXPECT_EQ(f64toa(1e-7, float_general), "1e-7");
+
+    // fixed
+    EXPECT_EQ(f64toa(0., float_fixed), "0");
+    EXPECT_EQ(f64toa(1.5, float_fixed), "1.5");
+    EXPECT_EQ(f64toa(1e20, float_fixed), "100000000000000000000");
+    EXPECT_EQ(f64toa(-1.25e-7, float_fixed), "-0.000000125");
+    EXPECT_EQ(f64toa(1.7976931348623157e308, float_fixed).size(), 309);
+    EXPECT_EQ(atof64(f64toa(5e-324, float_fixed)), 5e-324);
+
+    // scientific
+    EXPECT_EQ(f64toa(0., float_scientific), "0e+0");
+    EXPECT_EQ(f64toa(1.5, float_scientific), "1.5e+0");
+    EXPECT_EQ(f64toa(123456., float_scientific), "1.23456e+5");
+    EXPECT_EQ(f64toa(-0.00125, float_scientific), "-1.25e-3");
+    EXPECT_EQ(f32toa(0.00125f, float_scientific), "1.25e-3");
+
+    // truncated to the buffer, always null-terminated
+    char buffer[8];
+    char* last = buffer + sizeof(buffer);
+    f64toa(1e20, buffer, last, float_fixed);
+    EXPECT_EQ(string(buffer, last), "1000000");
+    EXPECT_EQ(*last, '\0');
+}
+
+
 TEST(f64toa, basen)
 {
     // known issues
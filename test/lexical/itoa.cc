@@ -146,3 +146,63 @@ TEST(i8toa, basen)
         EXPECT_EQ(i8toa(37, pair.first), pair.second);
     }
 }
+
+
+TEST(u64toa, digits)
+{
+    // every decimal digit count, and the values on either side of it
+    uint64_t power = 1;
+    for (size_t i = 1; i < 20; ++i) {
+        power *= 10;
+        EXPECT_EQ(u64toa(power - 1), string(i, '9'));
+        EXPECT_EQ(u64toa(power), "1" + string(i, '0'));
+        EXPECT_EQ(u64toa(power + 1), "1" + string(i-1, '0') + "1");
+    }
+}
+
+
+TEST(u64toa, pow2)
+{
+    EXPECT_EQ(u64toa(0, 2), "0");
+    EXPECT_EQ(u64toa(0, 16), "0");
+    EXPECT_EQ(u64toa(1, 2), "1");
+    EXPECT_EQ(u64toa(255, 2), "11111111");
+    EXPECT_EQ(u64toa(256, 4), "10000");
+    EXPECT_EQ(u64toa(511, 8), "777");
+    EXPECT_EQ(u64toa(4096, 8), "10000");
+    EXPECT_EQ(u64toa(0xABC, 16), "ABC");
+    EXPECT_EQ(u64toa(0xABCD, 16), "ABCD");
+    EXPECT_EQ(u64toa(0x123456789ABCDEFULL, 16), "123456789ABCDEF");
+    EXPECT_EQ(u64toa(18446744073709551615ULL, 2), string(64, '1'));
+    EXPECT_EQ(u64toa(18446744073709551615ULL, 8), "1777777777777777777777");
+    EXPECT_EQ(u64toa(18446744073709551615ULL, 16), "FFFFFFFFFFFFFFFF");
+    EXPECT_EQ(u64toa(18446744073709551615ULL, 32), "FVVVVVVVVVVVV");
+    EXPECT_EQ(u64toa(18446744073709551615ULL, 36), "3W5E11264SGSF");
+}
+
+
+TEST(u64toa, batch)
+{
+    uint64_t values[] = {0, 1, 18446744073709551615ULL, 37};
+    EXPECT_EQ(u64toa_batch(values, 0), "");
+    EXPECT_EQ(u64toa_batch(values, 4), "0,1,18446744073709551615,37");
+    EXPECT_EQ(u64toa_batch(values, 4, '\n', 16), "0\n1\nFFFFFFFFFFFFFFFF\n25");
+
+    // stop before the first value that does not fit
+    char buffer[8];
+    char* last = buffer + sizeof(buffer);
+    EXPECT_EQ(u64toa_batch(values, 4, buffer, last), 2);
+    EXPECT_EQ(string(buffer, last), "0,1");
+    EXPECT_EQ(*last, '\0');
+}
+
+
+TEST(i64toa, batch)
+{
+    int64_t values[] = {-1, 0, INT64_MIN, 37};
+    EXPECT_EQ(i64toa_batch(values, 4), "-1,0,-9223372036854775808,37");
+    EXPECT_EQ(i64toa_batch(values, 4, ' ', 2), "-1 0 -1" + string(63, '0') + " 100101");
+
+    int32_t values32[] = {-37, 37};
+    EXPECT_EQ(i32toa_batch(values32, 2, ';', 36), "-11;11");
+}
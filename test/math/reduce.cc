@@ -0,0 +1,184 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see LICENSE.md for more details.
+/*
+ *  \addtogroup Tests
+ *  \brief Vectorized and parallel reduction unittests.
+ */
+
+#include <pycpp/math/average.h>
+#include <pycpp/math/dot.h>
+#include <pycpp/math/reduce.h>
+#include <pycpp/math/std.h>
+#include <pycpp/math/trapz.h>
+#include <pycpp/stl/deque.h>
+#include <pycpp/stl/vector.h>
+#include <gtest/gtest.h>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+/**
+ *  \brief Force ranges of `threshold` values to use parallel chunks.
+ */
+struct parallel_guard
+{
+    parallel_guard(size_t threshold, size_t threads):
+        threshold_(REDUCE_PARALLEL_THRESHOLD),
+        threads_(REDUCE_MAX_THREADS)
+    {
+        REDUCE_PARALLEL_THRESHOLD = threshold;
+        REDUCE_MAX_THREADS = threads;
+    }
+
+    ~parallel_guard()
+    {
+        REDUCE_PARALLEL_THRESHOLD = threshold_;
+        REDUCE_MAX_THREADS = threads_;
+    }
+
+private:
+    size_t threshold_;
+    size_t threads_;
+};
+
+// TESTS
+// -----
+
+
+TEST(reduce, traits)
+{
+    static_assert(reduce_detail::is_contiguous<double*>::value, "");
+    static_assert(reduce_detail::is_contiguous<const float*>::value, "");
+    static_assert(reduce_detail::is_contiguous<vector<double>::iterator>::value, "");
+    static_assert(reduce_detail::is_contiguous<vector<float>::const_iterator>::value, "");
+    static_assert(!reduce_detail::is_contiguous<vector<int>::iterator>::value, "");
+    static_assert(!reduce_detail::is_contiguous<deque<double>::iterator>::value, "");
+    static_assert(reduce_detail::is_contiguous_pair<double*, vector<double>::iterator>::value, "");
+    static_assert(!reduce_detail::is_contiguous_pair<double*, float*>::value, "");
+}
+
+
+TEST(reduce, sum)
+{
+    for (size_t n: {0, 1, 3, 4, 15, 16, 17, 1000, 5000}) {
+        vector<double> x(n);
+        vector<float> y(n);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = static_cast<double>(i);
+            y[i] = static_cast<float>(i);
+        }
+        double expected = static_cast<double>(n) * (static_cast<double>(n) - 1) / 2;
+        for (summation_method method: {summation_default, summation_pairwise, summation_kahan}) {
+            EXPECT_EQ(reduce_sum(x.data(), n, method), expected);
+            EXPECT_EQ(reduce_sum(y.data(), n, method), expected);
+        }
+    }
+}
+
+
+TEST(reduce, compensated)
+{
+    // 1 + many tiny values: naive summation loses all of them
+    vector<double> x(1 << 16, 1e-16);
+    x[0] = 1;
+    double expected = 1 + (x.size() - 1) * 1e-16;
+    EXPECT_NEAR(reduce_sum(x.data(), x.size(), summation_kahan), expected, 1e-15);
+    EXPECT_NEAR(reduce_sum(x.data(), x.size(), summation_pairwise), expected, 1e-13);
+}
+
+
+TEST(reduce, dot)
+{
+    vector<float> x = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    vector<float> y(x.size(), 2);
+    EXPECT_EQ(reduce_dot(x.data(), y.data(), x.size()), 132);
+    EXPECT_EQ(dot(x.begin(), x.end(), y.begin(), y.end()), 132);
+    EXPECT_EQ(dot(x.begin(), x.end(), y.begin(), y.begin() + 2), 6);
+}
+
+
+TEST(reduce, moments)
+{
+    vector<double> x = {5, 6, 7, 8, 9, 10, 11, 12, 13, 14};
+    welford_accumulator moments = reduce_moments(x.data(), x.size());
+    EXPECT_EQ(moments.count(), 10);
+    EXPECT_DOUBLE_EQ(moments.mean(), 9.5);
+    EXPECT_DOUBLE_EQ(moments.variance(), 8.25);
+    EXPECT_DOUBLE_EQ(moments.variance(1), 8.25 * 10 / 9);
+
+    // a large offset does not cancel catastrophically
+    vector<double> offset;
+    for (double value: x) {
+        offset.push_back(value + 1e9);
+    }
+    EXPECT_NEAR(variance(offset.begin(), offset.end()), 8.25, 1e-6);
+
+    // any iterator, one value at a time
+    deque<double> queue(x.begin(), x.end());
+    EXPECT_DOUBLE_EQ(::PYCPP_NAMESPACE::moments(queue.begin(), queue.end()).variance(), 8.25);
+
+    welford_accumulator left = reduce_moments(x.data(), 3);
+    left.merge(reduce_moments(x.data() + 3, 7));
+    EXPECT_DOUBLE_EQ(left.mean(), 9.5);
+    EXPECT_DOUBLE_EQ(left.variance(), 8.25);
+}
+
+
+TEST(reduce, trapz)
+{
+    vector<double> x = {4.5, 6.5, 8.5, 9.3};
+    vector<double> y = {0.1, 200.45, 175.6, 12.3};
+    EXPECT_NEAR(reduce_trapz(y.data(), y.size(), 1.0), 382.25, 0.001);
+    EXPECT_NEAR(reduce_trapz(y.data(), x.data(), y.size()), 651.76, 0.001);
+    EXPECT_EQ(reduce_trapz(y.data(), 1, 1.0), 0);
+    EXPECT_EQ(reduce_trapz(y.data(), x.data(), 0), 0);
+
+    vector<float> z(1001);
+    vector<float> t(1001);
+    for (size_t i = 0; i < z.size(); ++i) {
+        t[i] = static_cast<float>(i) / 1000;
+        z[i] = t[i] * t[i];
+    }
+    EXPECT_NEAR(trapz(z.begin(), z.end(), t.begin(), t.end()), 1.0 / 3, 1e-6);
+    EXPECT_NEAR(trapz(z.begin(), z.end(), 0.001), 1.0 / 3, 1e-6);
+}
+
+
+TEST(reduce, parallel)
+{
+    parallel_guard guard(1000, 4);
+
+    vector<double> x(4099);
+    vector<double> y(x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = static_cast<double>(i % 7);
+        y[i] = static_cast<double>(i);
+    }
+
+    double sum = 0;
+    double product = 0;
+    welford_accumulator expected;
+    for (size_t i = 0; i < x.size(); ++i) {
+        sum += x[i];
+        product += x[i] * y[i];
+        expected.push(x[i]);
+    }
+
+    EXPECT_EQ(reduce_sum(x.data(), x.size()), sum);
+    EXPECT_EQ(reduce_sum(x.data(), x.size(), summation_kahan), sum);
+    EXPECT_EQ(reduce_sum(x.data(), x.size(), summation_pairwise), sum);
+    EXPECT_EQ(reduce_dot(x.data(), y.data(), x.size()), product);
+    EXPECT_DOUBLE_EQ(average(x.begin(), x.end()), sum / x.size());
+
+    welford_accumulator moments = reduce_moments(x.data(), x.size());
+    EXPECT_EQ(moments.count(), expected.count());
+    EXPECT_NEAR(moments.mean(), expected.mean(), 1e-12);
+    EXPECT_NEAR(moments.variance(), expected.variance(), 1e-12);
+
+    // y = i, so the integral over [0, n-1] is (n-1)^2 / 2
+    double last = static_cast<double>(y.size() - 1);
+    EXPECT_DOUBLE_EQ(reduce_trapz(y.data(), y.size(), 1.0), last * last / 2);
+    EXPECT_DOUBLE_EQ(reduce_trapz(y.data(), y.data(), y.size()), last * last / 2);
+}
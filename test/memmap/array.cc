@@ -0,0 +1,150 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see LICENSE.md for more details.
+/*
+ *  \addtogroup Tests
+ *  \brief Memory-mapped array unittests.
+ */
+
+#include <pycpp/filesystem.h>
+#include <pycpp/memmap/array.h>
+#include <pycpp/stl/algorithm.h>
+#include <pycpp/stl/numeric.h>
+#include <pycpp/stl/vector.h>
+#include <gtest/gtest.h>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+struct triple
+{
+    int32_t x;
+    int32_t y;
+    int32_t z;
+};
+
+// TESTS
+// -----
+
+
+TEST(memmap_array, windows)
+{
+    string path("sample_memmap");
+    {
+        // small windows, so the values span many of them
+        memmap_array<uint64_t> array(path, ios_base::out | ios_base::trunc, 4096, 2);
+        EXPECT_TRUE(array.is_open());
+        EXPECT_TRUE(array.empty());
+        EXPECT_EQ(array.window(), memmap_file::granularity() / sizeof(uint64_t));
+        EXPECT_EQ(array.cache_size(), 2);
+
+        const size_t count = 20 * array.window() + 7;
+        for (size_t i = 0; i < count; ++i) {
+            array.push_back(i);
+        }
+        EXPECT_EQ(array.size(), count);
+        EXPECT_EQ(array.capacity() % array.window(), 0);
+        EXPECT_EQ(array.front(), 0);
+        EXPECT_EQ(array.back(), count - 1);
+        EXPECT_EQ(array.at(count / 2), count / 2);
+        EXPECT_THROW(array.at(count), out_of_range);
+
+        // references to two windows at once
+        swap(array[0], array[count - 1]);
+        EXPECT_EQ(array[0], count - 1);
+        EXPECT_EQ(array[count - 1], 0);
+        swap(array[0], array[count - 1]);
+
+        // iterators
+        EXPECT_EQ(static_cast<size_t>(array.end() - array.begin()), count);
+        EXPECT_EQ(accumulate(array.begin(), array.end(), uint64_t(0)), count * (count - 1) / 2);
+        EXPECT_EQ(*array.rbegin(), count - 1);
+        reverse(array.begin(), array.end());
+        EXPECT_EQ(array[0], count - 1);
+        EXPECT_TRUE(is_sorted(array.rbegin(), array.rend()));
+        sort(array.begin(), array.end());
+        EXPECT_TRUE(is_sorted(array.cbegin(), array.cend()));
+        EXPECT_EQ(lower_bound(array.begin(), array.end(), 1000) - array.begin(), 1000);
+
+        // bulk append and scan
+        vector<uint64_t> values(3 * array.window() + 11);
+        iota(values.begin(), values.end(), count);
+        array.append(values.data(), values.size());
+        EXPECT_EQ(array.size(), count + values.size());
+
+        uint64_t sum = 0;
+        size_t runs = 0;
+        array.scan([&](const uint64_t* data, size_t n) {
+            EXPECT_LE(n, array.window());
+            sum = accumulate(data, data + n, sum);
+            ++runs;
+        });
+        size_t total = array.size();
+        EXPECT_EQ(sum, total * (total - 1) / 2);
+        EXPECT_EQ(runs, (total + array.window() - 1) / array.window());
+
+        array.scan(5, 10, [](uint64_t* data, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                data[i] *= 2;
+            }
+        });
+        EXPECT_EQ(array[4], 4);
+        EXPECT_EQ(array[5], 10);
+        EXPECT_EQ(array[9], 18);
+        EXPECT_EQ(array[10], 10);
+
+        // shrinking then growing reads back zeros
+        array.resize(100);
+        EXPECT_EQ(array.size(), 100);
+        array.resize(2 * array.window());
+        EXPECT_EQ(array[99], 99);
+        EXPECT_EQ(array[100], 0);
+        EXPECT_EQ(array.back(), 0);
+        array.pop_back();
+        EXPECT_EQ(array.size(), 2 * array.window() - 1);
+    }
+
+    // the file is truncated to the logical size on close
+    size_t size = 2 * memmap_file::granularity() / sizeof(uint64_t) - 1;
+    EXPECT_EQ(getsize(path), size * sizeof(uint64_t));
+
+    // read-only
+    memmap_array<uint64_t> array(path, ios_base::in);
+    EXPECT_EQ(array.size(), size);
+    EXPECT_EQ(array[99], 99);
+    EXPECT_THROW(array.push_back(1), filesystem_error);
+    array.close();
+    EXPECT_FALSE(array.is_open());
+
+    EXPECT_TRUE(remove_file(path));
+}
+
+
+TEST(memmap_array, unaligned)
+{
+    string path("sample_memmap");
+    memmap_array<triple> array(path, ios_base::out | ios_base::trunc, 1, 2);
+    EXPECT_EQ(array.window() * sizeof(triple) % memmap_file::granularity(), 0);
+
+    vector<triple> values;
+    for (int32_t i = 0; i < static_cast<int32_t>(3 * array.window()); ++i) {
+        values.push_back({i, -i, 2 * i});
+    }
+    array.append(values.begin(), values.end());
+    EXPECT_EQ(array.size(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(array[i].x, values[i].x);
+        EXPECT_EQ(array[i].z, values[i].z);
+    }
+    EXPECT_EQ(array.end()[-1].y, values.back().y);
+
+    memmap_array<triple> moved(move(array));
+    EXPECT_FALSE(array.is_open());
+    EXPECT_EQ(moved.size(), values.size());
+    moved.clear();
+    EXPECT_TRUE(moved.empty());
+    moved.close();
+
+    EXPECT_TRUE(remove_file(path));
+}
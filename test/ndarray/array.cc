@@ -5,7 +5,185 @@
  *  \brief N-dimensional array unittests.
  */
 
+#include <pycpp/allocator/stack.h>
 #include <pycpp/ndarray/array.h>
 #include <gtest/gtest.h>
 
 PYCPP_USING_NAMESPACE
+
+// TESTS
+// -----
+
+
+TEST(ndarray, constructor)
+{
+    ndarray<int> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.ndim(), 1);
+
+    ndarray<int> zeros({2, 3});
+    EXPECT_EQ(zeros.size(), 6);
+    EXPECT_EQ(zeros.ndim(), 2);
+    EXPECT_EQ(zeros.strides(), ndarray_strides({3, 1}));
+    EXPECT_EQ(zeros(1, 2), 0);
+
+    ndarray<int> filled({2, 2}, 7);
+    EXPECT_EQ(filled(1, 1), 7);
+
+    ndarray<int> values({2, 3}, {0, 1, 2, 3, 4, 5});
+    EXPECT_EQ(values(0, 2), 2);
+    EXPECT_EQ(values(1, 0), 3);
+    EXPECT_EQ(values.at({1, 2}), 5);
+    EXPECT_THROW(values.at({2, 0}), out_of_range);
+    EXPECT_THROW(values.at({0}), out_of_range);
+    EXPECT_THROW(ndarray<int>({2, 2}, {1, 2, 3}), invalid_argument);
+
+    // copy a strided view into contiguous storage
+    ndarray<int> transposed(values.transpose());
+    EXPECT_EQ(transposed.shape(), ndarray_shape({3, 2}));
+    EXPECT_EQ(transposed(2, 1), 5);
+    EXPECT_EQ(transposed(1, 0), 1);
+    EXPECT_EQ(vector<int>(transposed.begin(), transposed.end()), vector<int>({0, 3, 1, 4, 2, 5}));
+
+    values.resize({3, 2});
+    EXPECT_EQ(values(2, 1), 5);
+    values.fill(1);
+    EXPECT_EQ(sum(values), 6);
+
+    swap(values, transposed);
+    EXPECT_EQ(values(1, 0), 1);
+    EXPECT_EQ(transposed(1, 0), 1);
+}
+
+
+TEST(ndarray, arithmetic)
+{
+    ndarray<double> x({2, 3}, {1, 2, 3, 4, 5, 6});
+    ndarray<double> y({3}, {10, 20, 30});
+
+    // broadcast a row
+    ndarray<double> z = x + y;
+    EXPECT_EQ(z.shape(), ndarray_shape({2, 3}));
+    EXPECT_EQ(vector<double>(z.begin(), z.end()), vector<double>({11, 22, 33, 14, 25, 36}));
+
+    // broadcast a column
+    ndarray<double> column({2, 1}, {1, 2});
+    z = x * column;
+    EXPECT_EQ(vector<double>(z.begin(), z.end()), vector<double>({1, 2, 3, 8, 10, 12}));
+
+    // outer product
+    ndarray<double> row({1, 3}, {1, 2, 3});
+    z = column * row;
+    EXPECT_EQ(z.shape(), ndarray_shape({2, 3}));
+    EXPECT_EQ(z(1, 2), 6);
+
+    // scalars and views
+    z = 2.0 * x - 1.0;
+    EXPECT_EQ(z(1, 2), 11);
+    z = x.transpose() / 2.0;
+    EXPECT_EQ(z.shape(), ndarray_shape({3, 2}));
+    EXPECT_EQ(z(2, 0), 1.5);
+    z = x.slice(1, {0, NDARRAY_NONE, 2}) - x.slice(1, {1, NDARRAY_NONE, 2}).slice(1, {0, 1});
+    EXPECT_EQ(z.shape(), ndarray_shape({2, 2}));
+    EXPECT_EQ(z(1, 1), 1);
+
+    EXPECT_THROW(x + ndarray<double>({2}), invalid_argument);
+
+    // compound assignment
+    z = x;
+    z += y;
+    z -= 1;
+    z *= 2.0;
+    z /= ndarray<double>({2, 1}, {1, 2});
+    EXPECT_EQ(z(0, 0), 20);
+    EXPECT_EQ(z(1, 2), 35);
+}
+
+
+TEST(ndarray, promotion)
+{
+    ndarray<float> x({4}, {1, 2, 3, 4});
+    ndarray<int> i({4}, {1, 2, 3, 4});
+
+    // scalars do not promote arrays, unless mixing integers and floats
+    static_assert(is_same<decltype(x * 2.0), ndarray<float>>::value, "");
+    static_assert(is_same<decltype(i * 2), ndarray<int>>::value, "");
+    static_assert(is_same<decltype(i * 0.5), ndarray<double>>::value, "");
+    static_assert(is_same<decltype(x + i), ndarray<float>>::value, "");
+
+    EXPECT_EQ((i * 0.5)(1), 1.0);
+    EXPECT_EQ((x + i)(3), 8.0f);
+    EXPECT_EQ((i / 2)(2), 1);
+}
+
+
+TEST(ndarray, long)
+{
+    // long enough for the vectorized kernels and their tails
+    for (size_t n: {0, 1, 7, 8, 31, 32, 33, 1001}) {
+        ndarray<float> x({n});
+        ndarray<double> y({n});
+        for (size_t i = 0; i < n; ++i) {
+            x(i) = static_cast<float>(i);
+            y(i) = static_cast<double>(i);
+        }
+        ndarray<float> xx = x + x;
+        ndarray<double> yy = 1.0 - y;
+        double expected = static_cast<double>(n) * (static_cast<double>(n) - 1) / 2;
+        EXPECT_EQ(sum(x), static_cast<float>(expected));
+        EXPECT_EQ(sum(y), expected);
+        EXPECT_EQ(sum(xx), static_cast<float>(2 * expected));
+        EXPECT_EQ(sum(yy), static_cast<double>(n) - expected);
+        if (n > 0) {
+            EXPECT_EQ(xx(n - 1), 2.0f * (n - 1));
+            EXPECT_EQ(yy(n - 1), 2.0 - n);
+        }
+    }
+}
+
+
+TEST(ndarray, reductions)
+{
+    ndarray<int> x({2, 3}, {1, 2, 3, 4, 5, 6});
+    EXPECT_EQ(sum(x), 21);
+    EXPECT_EQ(sum(x.transpose()), 21);
+    EXPECT_EQ(mean(x), 3.5);
+    EXPECT_EQ(amin(x), 1);
+    EXPECT_EQ(amax(x.slice(0, {0, 1})), 3);
+    EXPECT_THROW(amin(ndarray<int>()), invalid_argument);
+
+    ndarray<int> rows = sum(x, 0);
+    EXPECT_EQ(rows.shape(), ndarray_shape({3}));
+    EXPECT_EQ(vector<int>(rows.begin(), rows.end()), vector<int>({5, 7, 9}));
+
+    ndarray<int> columns = sum(x, 1);
+    EXPECT_EQ(columns.shape(), ndarray_shape({2}));
+    EXPECT_EQ(vector<int>(columns.begin(), columns.end()), vector<int>({6, 15}));
+
+    ndarray<double> y({2, 2, 2}, {1, 2, 3, 4, 5, 6, 7, 8});
+    ndarray<double> middle = sum(y, 1);
+    EXPECT_EQ(middle.shape(), ndarray_shape({2, 2}));
+    EXPECT_EQ(middle(0, 0), 4);
+    EXPECT_EQ(middle(1, 1), 14);
+    EXPECT_THROW(sum(y, 3), out_of_range);
+}
+
+
+TEST(ndarray, allocator)
+{
+    using allocator_type = stack_allocator<double, 512>;
+    using arena_type = typename allocator_type::arena_type;
+    using array_type = ndarray<double, allocator_type>;
+
+    arena_type arena;
+    allocator_type alloc(arena);
+    array_type x({2, 4}, 1.0, alloc);
+    EXPECT_GT(arena.used(), 0);
+
+    // results stay in the arena of the first array operand
+    size_t used = arena.used();
+    array_type y = x * 3.0 + x;
+    EXPECT_GT(arena.used(), used);
+    EXPECT_EQ(y(1, 3), 4.0);
+    EXPECT_EQ(sum(y), 32.0);
+}
@@ -6,6 +6,52 @@
  */
 
 #include <pycpp/ndarray/iterator.h>
+#include <pycpp/stl/vector.h>
 #include <gtest/gtest.h>
 
 PYCPP_USING_NAMESPACE
+
+// TESTS
+// -----
+
+
+TEST(ndarray_iterator, contiguous)
+{
+    vector<int> data = {0, 1, 2, 3, 4, 5};
+    ndarray_shape shape = {2, 3};
+    ndarray_iterator<int> first(data.data(), shape, ndarray_contiguous_strides(shape));
+    ndarray_iterator<int> last(data.data(), shape, ndarray_contiguous_strides(shape), data.size());
+
+    EXPECT_EQ(vector<int>(first, last), data);
+    EXPECT_EQ(*first, 0);
+    EXPECT_EQ(first.index(), ndarray_shape({0, 0}));
+    ++first;
+    ++first;
+    ++first;
+    EXPECT_EQ(*first, 3);
+    EXPECT_EQ(first.index(), ndarray_shape({1, 0}));
+    EXPECT_EQ(*first++, 3);
+    EXPECT_EQ(*first, 4);
+    *first = -4;
+    EXPECT_EQ(data[4], -4);
+}
+
+
+TEST(ndarray_iterator, strided)
+{
+    // transposed and reversed columns
+    vector<int> data = {0, 1, 2, 3, 4, 5};
+    ndarray_iterator<const int> first(data.data() + 2, {3, 2}, {-1, 3});
+    ndarray_iterator<const int> last(data.data() + 2, {3, 2}, {-1, 3}, 6);
+    EXPECT_EQ(vector<int>(first, last), vector<int>({2, 5, 1, 4, 0, 3}));
+
+    // broadcast rows
+    ndarray_iterator<const int> repeat(data.data(), {2, 3}, {0, 1});
+    ndarray_iterator<const int> end(data.data(), {2, 3}, {0, 1}, 6);
+    EXPECT_EQ(vector<int>(repeat, end), vector<int>({0, 1, 2, 0, 1, 2}));
+
+    // 0-dimensional
+    ndarray_iterator<const int> scalar(data.data() + 5, {}, {});
+    EXPECT_EQ(*scalar, 5);
+    EXPECT_EQ(++scalar, ndarray_iterator<const int>(data.data(), {}, {}, 1));
+}
@@ -6,6 +6,152 @@
  */
 
 #include <pycpp/ndarray/view.h>
+#include <pycpp/stl/numeric.h>
+#include <pycpp/stl/vector.h>
 #include <gtest/gtest.h>
 
 PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+template <typename T>
+static vector<remove_const_t<T>> values(const ndarray_view<T>& view)
+{
+    return vector<remove_const_t<T>>(view.begin(), view.end());
+}
+
+// TESTS
+// -----
+
+
+TEST(ndarray_view, properties)
+{
+    vector<int> data(24);
+    iota(data.begin(), data.end(), 0);
+    ndarray_view<int> view(data.data(), {2, 3, 4});
+
+    EXPECT_EQ(view.ndim(), 3);
+    EXPECT_EQ(view.size(), 24);
+    EXPECT_FALSE(view.empty());
+    EXPECT_TRUE(view.is_contiguous());
+    EXPECT_EQ(view.strides(), ndarray_strides({12, 4, 1}));
+    EXPECT_EQ(view(1, 2, 3), 23);
+    EXPECT_EQ(view.at({1, 0, 2}), 14);
+    EXPECT_THROW(view.at({1, 3, 0}), out_of_range);
+
+    ndarray_view<int> row = view[1];
+    EXPECT_EQ(row.shape(), ndarray_shape({3, 4}));
+    EXPECT_EQ(row(0, 0), 12);
+    EXPECT_EQ(view[1][2](3), 23);
+
+    // writes through the view
+    view(0, 0, 1) = -1;
+    EXPECT_EQ(data[1], -1);
+
+    ndarray_view<const int> readonly = view;
+    EXPECT_EQ(readonly(0, 0, 1), -1);
+}
+
+
+TEST(ndarray_view, slice)
+{
+    vector<int> data(10);
+    iota(data.begin(), data.end(), 0);
+    ndarray_view<int> view(data.data(), {10});
+
+    EXPECT_EQ(values(view.slice(0, {2, 5})), vector<int>({2, 3, 4}));
+    EXPECT_EQ(values(view.slice(0, {-3})), vector<int>({7, 8, 9}));
+    EXPECT_EQ(values(view.slice(0, {1, -1, 3})), vector<int>({1, 4, 7}));
+    EXPECT_EQ(values(view.slice(0, {NDARRAY_NONE, NDARRAY_NONE, -1})), vector<int>({9, 8, 7, 6, 5, 4, 3, 2, 1, 0}));
+    EXPECT_EQ(values(view.slice(0, {7, 2, -2})), vector<int>({7, 5, 3}));
+    EXPECT_EQ(values(view.slice(0, {0, NDARRAY_NONE, -1})), vector<int>({0}));
+    EXPECT_EQ(values(view.slice(0, {-100, 100})), values(view));
+    EXPECT_TRUE(view.slice(0, {5, 2}).empty());
+    EXPECT_THROW(view.slice(0, {0, 1, 0}), invalid_argument);
+    EXPECT_THROW(view.slice(1, {0, 1}), out_of_range);
+
+    ndarray_view<int> matrix(data.data(), {2, 5});
+    ndarray_view<int> sliced = matrix.slice({{NDARRAY_NONE, NDARRAY_NONE, -1}, {1, 4, 2}});
+    EXPECT_EQ(sliced.shape(), ndarray_shape({2, 2}));
+    EXPECT_FALSE(sliced.is_contiguous());
+    EXPECT_EQ(values(sliced), vector<int>({6, 8, 1, 3}));
+}
+
+
+TEST(ndarray_view, transpose)
+{
+    vector<int> data(24);
+    iota(data.begin(), data.end(), 0);
+    ndarray_view<int> view(data.data(), {2, 3, 4});
+
+    ndarray_view<int> transposed = view.transpose();
+    EXPECT_EQ(transposed.shape(), ndarray_shape({4, 3, 2}));
+    EXPECT_EQ(transposed(3, 2, 1), view(1, 2, 3));
+    EXPECT_FALSE(transposed.is_contiguous());
+
+    ndarray_view<int> permuted = view.transpose({1, 0, 2});
+    EXPECT_EQ(permuted.shape(), ndarray_shape({3, 2, 4}));
+    EXPECT_EQ(permuted(2, 1, 0), view(1, 2, 0));
+    EXPECT_THROW(view.transpose({0, 0, 1}), invalid_argument);
+    EXPECT_THROW(view.transpose({0, 1}), invalid_argument);
+}
+
+
+TEST(ndarray_view, reshape)
+{
+    vector<int> data(12);
+    iota(data.begin(), data.end(), 0);
+    ndarray_view<int> view(data.data(), {3, 4});
+
+    ndarray_view<int> reshaped = view.reshape({2, 2, 3});
+    EXPECT_EQ(reshaped(1, 1, 2), 11);
+    EXPECT_EQ(view.reshape({12})(5), 5);
+    EXPECT_THROW(view.reshape({5}), invalid_argument);
+    EXPECT_THROW(view.transpose().reshape({12}), invalid_argument);
+
+    // unit dimensions do not affect contiguity
+    EXPECT_TRUE(view.slice(0, {1, 2}).is_contiguous());
+    EXPECT_EQ(view.slice(0, {1, 2}).reshape({4})(0), 4);
+}
+
+
+TEST(ndarray_view, broadcast)
+{
+    vector<int> data = {1, 2, 3};
+    ndarray_view<int> row(data.data(), {3});
+
+    ndarray_view<int> matrix = row.broadcast_to({2, 3});
+    EXPECT_EQ(matrix.strides(), ndarray_strides({0, 1}));
+    EXPECT_EQ(values(matrix), vector<int>({1, 2, 3, 1, 2, 3}));
+
+    ndarray_view<int> column(data.data(), {3, 1});
+    EXPECT_EQ(values(column.broadcast_to({3, 2})), vector<int>({1, 1, 2, 2, 3, 3}));
+    EXPECT_THROW(row.broadcast_to({4}), invalid_argument);
+    EXPECT_THROW(matrix.broadcast_to({3}), invalid_argument);
+
+    EXPECT_EQ(ndarray_broadcast_shape({2, 1, 3}, {4, 1}), ndarray_shape({2, 4, 3}));
+    EXPECT_EQ(ndarray_broadcast_shape({}, {2}), ndarray_shape({2}));
+    EXPECT_THROW(ndarray_broadcast_shape({2, 3}, {2}), invalid_argument);
+}
+
+
+TEST(ndarray_view, assign)
+{
+    vector<int> data(6);
+    ndarray_view<int> view(data.data(), {2, 3});
+
+    view.fill(4);
+    EXPECT_EQ(data, vector<int>(6, 4));
+
+    // broadcast a row into every row, and a value into a strided slice
+    vector<double> row = {1.5, 2.5, 3.5};
+    view.assign(ndarray_view<double>(row.data(), {3}));
+    EXPECT_EQ(data, vector<int>({1, 2, 3, 1, 2, 3}));
+    view.slice(1, {NDARRAY_NONE, NDARRAY_NONE, 2}).fill(0);
+    EXPECT_EQ(data, vector<int>({0, 2, 0, 0, 2, 0}));
+
+    vector<int> source = {1, 2, 3, 4, 5, 6};
+    view.transpose().assign(ndarray_view<int>(source.data(), {3, 2}));
+    EXPECT_EQ(data, vector<int>({1, 3, 5, 2, 4, 6}));
+}
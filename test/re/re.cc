@@ -7,7 +7,11 @@
 
 #include <pycpp/re/re.h>
 #include <pycpp/stl/deque.h>
+#include <pycpp/stl/thread.h>
+#include <pycpp/stl/vector.h>
 #include <gtest/gtest.h>
+#include <limits.h>
+#include <stdint.h>
 
 PYCPP_USING_NAMESPACE
 
@@ -125,3 +129,51 @@ TEST(re, re_purge)
 {
     re_purge();
 }
+
+
+TEST(re, re_cache_size)
+{
+    size_t size = re_cache_size();
+    re_set_cache_size(1);
+    EXPECT_EQ(re_cache_size(), 1);
+
+    // alternating patterns must recompile each time
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(bool(re_search("\\d+", "abc 123")));
+        EXPECT_TRUE(bool(re_search("\\w+", "abc 123")));
+    }
+
+    // an empty cache still holds the pattern in use
+    re_set_cache_size(0);
+    EXPECT_EQ(re_cache_size(), 1);
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(re_search("\\d+", "abc 123").group(), string_view("123"));
+        EXPECT_EQ(re_match("\\w+", "abc 123").group(), string_view("abc"));
+    }
+
+    // sizes are limited to the range of the cache
+    re_set_cache_size(SIZE_MAX);
+    EXPECT_EQ(re_cache_size(), static_cast<size_t>(INT_MAX));
+    EXPECT_TRUE(bool(re_search("\\d+", "abc 123")));
+
+    re_set_cache_size(size);
+    EXPECT_EQ(re_cache_size(), size);
+}
+
+
+TEST(re, thread_safety)
+{
+    vector<thread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([]() {
+            for (size_t j = 0; j < 100; ++j) {
+                auto m = re_search("\\w+", "...~/.'' Words");
+                EXPECT_EQ(m.group(), string_view("Words"));
+            }
+            re_purge();
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+}
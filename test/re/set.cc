@@ -0,0 +1,79 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see LICENSE.md for more details.
+/*
+ *  \addtogroup Tests
+ *  \brief Regular expression set unittests.
+ */
+
+#include <pycpp/re/set.h>
+#include <pycpp/stl/algorithm.h>
+#include <gtest/gtest.h>
+
+PYCPP_USING_NAMESPACE
+
+// TESTS
+// -----
+
+
+TEST(regex_set, add)
+{
+    regex_set_t set;
+    EXPECT_EQ(set.add("error"), 0);
+    EXPECT_EQ(set.add("warn(ing)?"), 1);
+    EXPECT_EQ(set.size(), 2);
+    EXPECT_THROW(set.add("(unbalanced"), runtime_error);
+
+    set.compile();
+    EXPECT_TRUE(set.compiled());
+    EXPECT_THROW(set.add("info"), runtime_error);
+}
+
+
+TEST(regex_set, match)
+{
+    regex_set_t set;
+    set.add("error");
+    set.add("warn(ing)?");
+    set.add("\\d+");
+    EXPECT_THROW(set.match("error"), runtime_error);
+    set.compile();
+
+    auto indexes = set.match("warning: disk 1 is full");
+    sort(indexes.begin(), indexes.end());
+    EXPECT_EQ(indexes, match_indexes({1, 2}));
+
+    EXPECT_TRUE(set.match("info: nothing to see").empty());
+
+    match_indexes buffer;
+    EXPECT_TRUE(set.match("error", buffer));
+    EXPECT_EQ(buffer, match_indexes({0}));
+    EXPECT_FALSE(set.match("info", buffer));
+}
+
+
+TEST(regex_set, any)
+{
+    regex_set_t set;
+    set.add("error");
+    set.add("warn(ing)?");
+    set.compile();
+
+    EXPECT_TRUE(set.any("error: out of memory"));
+    EXPECT_FALSE(set.any("info: nothing to see"));
+}
+
+
+TEST(regex_set, anchor)
+{
+    regex_set_t start(regex_anchor_start);
+    start.add("error");
+    start.compile();
+    EXPECT_TRUE(start.any("error: out of memory"));
+    EXPECT_FALSE(start.any("fatal error"));
+
+    regex_set_t both(regex_anchor_both);
+    both.add("error");
+    both.compile();
+    EXPECT_TRUE(both.any("error"));
+    EXPECT_FALSE(both.any("error: out of memory"));
+}
@@ -0,0 +1,34 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see LICENSE.md for more details.
+/*
+ *  \addtogroup Tests
+ *  \brief Runtime CPU feature detection unittests.
+ */
+
+#include <pycpp/runtime/cpu.h>
+#include <gtest/gtest.h>
+
+PYCPP_USING_NAMESPACE
+
+// TESTS
+// -----
+
+
+TEST(runtime, cpu)
+{
+    // later extensions imply earlier ones
+    if (cpu_supports(cpu_avx2)) {
+        EXPECT_TRUE(cpu_supports(cpu_avx));
+    }
+    if (cpu_supports(cpu_sse42)) {
+        EXPECT_TRUE(cpu_supports(cpu_sse41));
+    }
+    if (cpu_supports(cpu_sse41)) {
+        EXPECT_TRUE(cpu_supports(cpu_ssse3));
+        EXPECT_TRUE(cpu_supports(cpu_sse2));
+    }
+
+#if defined(PROCESSOR_X8664)
+    EXPECT_TRUE(cpu_supports(cpu_sse2));
+#endif
+}
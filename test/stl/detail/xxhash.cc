@@ -0,0 +1,95 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see LICENSE.md for more details.
+/*
+ *  \addtogroup Tests
+ *  \brief `xxhash` unittests.
+ */
+
+#include <pycpp/stl/detail/xxhash.h>
+#include <pycpp/stl/string.h>
+#include <pycpp/stl/string_view.h>
+#include <pycpp/stl/unordered_set.h>
+#include <gtest/gtest.h>
+
+PYCPP_USING_NAMESPACE
+
+// DATA
+// ----
+
+enum class color { red, green };
+
+// TESTS
+// -----
+
+
+TEST(xxhash, vectors)
+{
+    // reference vectors for the empty input with a seed of 0
+    EXPECT_EQ(XXH32("", 0, 0), 0x02CC5D05U);
+    EXPECT_EQ(XXH64("", 0, 0), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(XXH3_64bits("", 0), 0x2D06800538D394C2ULL);
+    EXPECT_EQ(XXH3_64bits_withSeed("", 0, 0), 0x2D06800538D394C2ULL);
+}
+
+
+TEST(xxhash, string)
+{
+    string str = "This is a message";
+    string_view view = str;
+    EXPECT_EQ(xxhash_string(str.data(), str.size()), xxhash_string(str.data(), str.size(), HASH_SEED));
+    EXPECT_EQ(hash<string>()(str), hash<string_view>()(view));
+    EXPECT_NE(xxhash_string(str.data(), str.size(), 1), xxhash_string(str.data(), str.size(), 2));
+
+    // every length through the short-input paths
+    unordered_set<hash_result_t> hashes;
+    string buffer;
+    for (size_t i = 0; i <= 256; ++i) {
+        hashes.insert(xxhash_string(buffer.data(), buffer.size()));
+        buffer.push_back('a');
+    }
+    EXPECT_EQ(hashes.size(), 257);
+}
+
+
+TEST(xxhash, integer)
+{
+    xxhash<int> hsh;
+    EXPECT_EQ(hsh(5), xxhash_integer(5));
+    EXPECT_EQ(xxhash<long>()(5), hsh(5));
+    EXPECT_EQ(xxhash<color>()(color::green), xxhash_integer(1));
+    EXPECT_NE(xxhash_integer(5, 1), xxhash_integer(5, 2));
+
+    // keys sharing their low bits must differ in the low bits of the hash
+    unordered_set<size_t> buckets;
+    for (size_t i = 0; i < 256; ++i) {
+        buckets.insert(hsh(static_cast<int>(i << 16)) & 0xFFFF);
+    }
+    EXPECT_GT(buckets.size(), 240);
+
+    // aligned pointers
+    int values[64];
+    buckets.clear();
+    for (int& value: values) {
+        buckets.insert(xxhash<int*>()(&value) & 0xFF);
+    }
+    EXPECT_GT(buckets.size(), 32);
+}
+
+
+TEST(seeded_xxhash, seeded_xxhash)
+{
+    seeded_xxhash<string> s1, s2;
+    seeded_xxhash<string> s3(HASH_SEED);
+    seeded_xxhash<int> i1(1);
+    seeded_xxhash<int> i2(2);
+
+    string str = "This is a message";
+    EXPECT_EQ(s1.seed(), xxhash_random_seed());
+    EXPECT_EQ(s1(str), s2(str));
+    EXPECT_EQ(s3(str), hash<string>()(str));
+    EXPECT_EQ(seeded_xxhash<string_view>(7)(str), seeded_xxhash<string>(7)(str));
+    EXPECT_EQ(i1(5), xxhash_integer(5, 1));
+    EXPECT_NE(i1(5), i2(5));
+    EXPECT_EQ(seeded_xxhash<color>(1)(color::green), xxhash_integer(1, 1));
+    EXPECT_EQ(seeded_xxhash<int*>(1)(nullptr), xxhash_integer(0, 1));
+}
@@ -0,0 +1,198 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see LICENSE.md for more details.
+/*
+ *  \addtogroup Tests
+ *  \brief Asynchronous I/O unittests.
+ */
+
+#include <pycpp/filesystem.h>
+#include <pycpp/stl/vector.h>
+#include <pycpp/stream/aio.h>
+#include <gtest/gtest.h>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+static std::string make_data(size_t size)
+{
+    std::string data(size, '\0');
+    uint32_t state = 2463534242u;
+    for (char& c: data) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        c = static_cast<char>(state);
+    }
+    return data;
+}
+
+
+static void test_context(aio_backend backend)
+{
+    string path("sample_aio");
+    const size_t chunk = 4096;
+    const size_t count = 16;
+    std::string data = make_data(chunk * count - 100);
+
+    aio_context context(8, backend);
+    EXPECT_EQ(context.backend() == aio_backend_threads, backend == aio_backend_threads);
+    EXPECT_EQ(context.depth(), 8);
+
+    // write, submitting more requests than the depth
+    fd_t fd = fd_open(path, ios_base::in | ios_base::out);
+    vector<aio_request> requests(count);
+    vector<aio_request*> pointers;
+    for (size_t i = 0; i < count; ++i) {
+        aio_request& request = requests[i];
+        request.opcode = aio_write;
+        request.fd = fd;
+        request.data = const_cast<char*>(data.data()) + i * chunk;
+        request.size = min(chunk, data.size() - i * chunk);
+        request.offset = i * chunk;
+        request.user_data = i;
+        pointers.push_back(&request);
+    }
+
+    size_t submitted = 0;
+    size_t completed = 0;
+    aio_request* done[count];
+    while (completed < count) {
+        submitted += context.submit(pointers.data() + submitted, count - submitted);
+        EXPECT_LE(context.pending(), context.depth());
+        size_t n = context.wait(done, 1, count);
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_EQ(done[i]->result, (streamsize) done[i]->size);
+        }
+        completed += n;
+    }
+    EXPECT_EQ(context.pending(), 0);
+
+    // read back, past the end of the file
+    std::string buffer(chunk * count, '\0');
+    for (size_t i = 0; i < count; ++i) {
+        aio_request& request = requests[i];
+        request.opcode = aio_read;
+        request.data = &buffer[i * chunk];
+        request.size = chunk;
+        request.result = 0;
+    }
+    submitted = context.submit(pointers.data(), 8);
+    EXPECT_EQ(submitted, 8);
+    EXPECT_EQ(context.wait(done, 8, count), 8);
+    EXPECT_EQ(context.submit(pointers.data() + 8, 8), 8);
+    EXPECT_EQ(context.wait(done, 8, count), 8);
+
+    for (size_t i = 0; i < count - 1; ++i) {
+        EXPECT_EQ(requests[i].result, (streamsize) chunk);
+    }
+    EXPECT_EQ(requests[count - 1].result, (streamsize) (chunk - 100));
+    EXPECT_EQ(buffer.substr(0, data.size()), data);
+
+    // errors
+    aio_request invalid;
+    invalid.fd = INVALID_FD_VALUE;
+    invalid.data = &buffer[0];
+    invalid.size = chunk;
+    aio_request* pointer = &invalid;
+    EXPECT_EQ(context.submit(&pointer, 1), 1);
+    EXPECT_EQ(context.wait(done, 1, 1), 1);
+    EXPECT_EQ(done[0], &invalid);
+    EXPECT_EQ(invalid.result, -1);
+    EXPECT_NE(invalid.error, 0);
+
+    fd_close(fd);
+    EXPECT_TRUE(remove_file(path));
+}
+
+// TESTS
+// -----
+
+
+TEST(aio_context, threads)
+{
+    test_context(aio_backend_threads);
+}
+
+
+TEST(aio_context, default_backend)
+{
+    test_context(aio_backend_default);
+}
+
+
+TEST(aio_stream, iostream)
+{
+    string path("sample_aio_stream");
+    std::string expected = make_data(3 * AIO_BUFFER_SIZE * AIO_STREAM_DEPTH + 17);
+
+    // write
+    fd_t fd = fd_open(path, ios_base::out);
+    aio_ostream ofs(fd, true);
+    ofs.write(expected.data(), expected.size());
+    ofs << "Single line" << endl;
+    EXPECT_TRUE(bool(ofs));
+    ofs.close();
+    expected += "Single line\n";
+    EXPECT_EQ(getsize(path), expected.size());
+
+    // read
+    fd = fd_open(path, ios_base::in);
+    aio_istream ifs(fd, true);
+    std::string result(expected.size(), '\0');
+    ifs.read(&result[0], result.size());
+    EXPECT_EQ((size_t) ifs.gcount(), expected.size());
+    EXPECT_EQ(result, expected);
+    EXPECT_EQ(ifs.get(), EOF);
+    EXPECT_TRUE(ifs.eof());
+    ifs.close();
+
+    EXPECT_TRUE(remove_file(path));
+}
+
+
+TEST(aio_stream, seek)
+{
+    string path("sample_aio_stream");
+    std::string expected = make_data(2 * AIO_BUFFER_SIZE * AIO_STREAM_DEPTH);
+    fd_t fd = fd_open(path, ios_base::out);
+    aio_ostream ofs(fd, true);
+    ofs.write(expected.data(), expected.size());
+    ofs.seekp(5);
+    ofs << "Single line";
+    expected.replace(5, 11, "Single line");
+    ofs.close();
+
+    fd = fd_open(path, ios_base::in);
+    aio_istream ifs(fd, true);
+    std::string result(100, '\0');
+
+    // within the buffer, then past the read-ahead, then backwards
+    for (size_t offset: {size_t(0), size_t(1000), expected.size() - 50, AIO_BUFFER_SIZE + 3}) {
+        ifs.clear();
+        ifs.seekg(offset);
+        EXPECT_EQ((size_t) ifs.tellg(), offset);
+        ifs.read(&result[0], result.size());
+        size_t size = min<size_t>(result.size(), expected.size() - offset);
+        EXPECT_EQ((size_t) ifs.gcount(), size);
+        EXPECT_EQ(result.substr(0, size), expected.substr(offset, size));
+        EXPECT_EQ((size_t) ifs.tellg(), size == result.size() ? offset + size : size_t(-1));
+    }
+
+    ifs.close();
+
+    // an unowned descriptor is left at the logical position
+    fd = fd_open(path, ios_base::in);
+    {
+        aio_istream unowned(fd);
+        unowned.seekg(7);
+        EXPECT_EQ(unowned.get(), (unsigned char) expected[7]);
+        aio_istream moved(std::move(unowned));
+        EXPECT_EQ(moved.get(), (unsigned char) expected[8]);
+    }
+    EXPECT_EQ(fd_tell(fd), 9);
+    fd_close(fd);
+
+    EXPECT_TRUE(remove_file(path));
+}
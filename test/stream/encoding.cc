@@ -0,0 +1,98 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see LICENSE.md for more details.
+/*
+ *  \addtogroup Tests
+ *  \brief Base16 and base64 stream unittests.
+ */
+
+#include <pycpp/stl/iterator.h>
+#include <pycpp/stl/sstream.h>
+#include <pycpp/stream/encoding.h>
+#include <gtest/gtest.h>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+/**
+ *  \brief Create binary data spanning several stream buffers.
+ */
+static string make_blob(size_t length)
+{
+    string blob;
+    blob.reserve(length);
+    for (size_t i = 0; i < length; ++i) {
+        blob.push_back(static_cast<char>(i * 31 + (i >> 8)));
+    }
+    return blob;
+}
+
+
+template <typename IStream>
+static string read_all(istream& stream)
+{
+    IStream decoded(stream);
+    return string(istreambuf_iterator<char>(decoded), istreambuf_iterator<char>());
+}
+
+// TESTS
+// -----
+
+
+TEST(base64_stream, ostream)
+{
+    for (size_t length: {0, 1, 2, 3, 4095, 4096, 10000}) {
+        string blob = make_blob(length);
+        ostringstream sstream;
+        {
+            base64_ostream encoded(sstream);
+            encoded.write(blob.data(), blob.size());
+        }
+        EXPECT_EQ(sstream.str(), base64_encode(blob));
+    }
+}
+
+
+TEST(base64_stream, istream)
+{
+    for (size_t length: {0, 1, 2, 3, 4095, 4096, 10000}) {
+        string blob = make_blob(length);
+        istringstream sstream(base64_encode(blob));
+        EXPECT_EQ(read_all<base64_istream>(sstream), blob);
+    }
+}
+
+
+TEST(base64_stream, invalid)
+{
+    istringstream sstream("TE9X*VI=");
+    base64_istream decoded(sstream);
+    char buffer[16];
+    decoded.read(buffer, sizeof(buffer));
+    EXPECT_TRUE(decoded.bad());
+}
+
+
+TEST(base16_stream, ostream)
+{
+    for (size_t length: {0, 1, 2047, 2048, 10000}) {
+        string blob = make_blob(length);
+        ostringstream sstream;
+        {
+            base16_ostream encoded(sstream);
+            encoded.write(blob.data(), blob.size());
+        }
+        EXPECT_EQ(sstream.str(), base16_encode(blob));
+    }
+}
+
+
+TEST(base16_stream, istream)
+{
+    for (size_t length: {0, 1, 2047, 2048, 10000}) {
+        string blob = make_blob(length);
+        istringstream sstream(base16_encode(blob));
+        EXPECT_EQ(read_all<base16_istream>(sstream), blob);
+    }
+}
@@ -196,6 +196,19 @@ TEST(filter_ostream, doublechars)
     }, doublechars);
 }
 
+
+TEST(filter_ostream, large)
+{
+    // larger than the buffer, and expanded by the callback
+    ostringstream sstream;
+    string message(10000, 'a');
+    {
+        filter_ostream_wrapper stream(sstream, doublechars);
+        stream.write(message.data(), message.size());
+    }
+    EXPECT_EQ(sstream.str(), string(20000, 'a'));
+}
+
 #if BUILD_FILESYSTEM
 
 // IFSTREAM
@@ -127,6 +127,90 @@ TEST(mmap_fstream, mmap_iofstream)
 #endif
 }
 
+
+
+TEST(mmap_fstream, options)
+{
+    std::string path("sample_mmap_options");
+    std::string expected(3 * MMAP_WINDOW_SIZE / 2 + 7, 'x');
+    for (size_t i = 0; i < expected.size(); i += 97) {
+        expected[i] = static_cast<char>('a' + i % 26);
+    }
+
+    mmap_ofstream ofs(path, ios_base::out, access_sequential);
+    ofs.map(0, expected.size(), mmap_options(mmap_sequential, true, true));
+    ASSERT_TRUE(ofs.has_mapping());
+    memcpy(ofs.data(), expected.data(), expected.size());
+    ofs.flush(false);
+    ofs.close();
+
+    mmap_ifstream ifs(path, ios_base::in, access_random);
+    ifs.map(0);
+    ASSERT_TRUE(ifs.has_mapping());
+    EXPECT_TRUE(ifs.advise(mmap_willneed));
+    EXPECT_TRUE(ifs.advise(mmap_sequential, 4097, 100));
+    EXPECT_EQ(std::string(ifs.data(), ifs.size()), expected);
+    EXPECT_TRUE(ifs.advise(mmap_dontneed));
+    EXPECT_EQ(std::string(ifs.data(), ifs.size()), expected);
+    ifs.map(0, expected.size(), mmap_options(mmap_random, true, true));
+    ASSERT_TRUE(ifs.has_mapping());
+    EXPECT_EQ(std::string(ifs.data(), ifs.size()), expected);
+    ifs.close();
+
+    EXPECT_TRUE(remove_file(path));
+}
+
+
+TEST(mmap_window_ifstream, mmap_window_ifstream)
+{
+    std::string path("sample_mmap_window");
+    std::string expected;
+    for (size_t i = 0; expected.size() < 100000; ++i) {
+        expected += "line " + std::to_string(i) + "\n";
+    }
+    {
+        mmap_ofstream ofs(path, ios_base::out);
+        ofs.map(0, expected.size());
+        memcpy(ofs.data(), expected.data(), expected.size());
+    }
+
+    // small windows, remapped many times
+    for (bool populate: {false, true}) {
+        mmap_window_ifstream ifs(path, 4096, mmap_options(mmap_sequential, populate));
+        EXPECT_TRUE(ifs.is_open());
+        std::string actual;
+        std::string line;
+        while (std::getline(ifs, line)) {
+            actual += line + "\n";
+        }
+        EXPECT_EQ(actual, expected);
+    }
+
+    // seek
+    mmap_window_ifstream ifs(path, 4096);
+    std::string actual(10, '\0');
+    for (size_t offset: {size_t(5), size_t(40000), size_t(4090), size_t(12)}) {
+        ifs.seekg(offset);
+        EXPECT_EQ((size_t) ifs.tellg(), offset);
+        ifs.read(&actual[0], actual.size());
+        EXPECT_EQ(actual, expected.substr(offset, actual.size()));
+        EXPECT_EQ((size_t) ifs.tellg(), offset + actual.size());
+    }
+    ifs.seekg(-3, ios_base::end);
+    EXPECT_EQ((size_t) ifs.tellg(), expected.size() - 3);
+    EXPECT_FALSE(ifs.read(&actual[0], actual.size()));
+    EXPECT_EQ(ifs.gcount(), 3);
+
+    mmap_window_ifstream moved(std::move(ifs));
+    moved.clear();
+    moved.seekg(6);
+    EXPECT_EQ(moved.get(), expected[6]);
+    moved.close();
+    EXPECT_FALSE(moved.is_open());
+
+    EXPECT_TRUE(remove_file(path));
+}
+
 #endif                                                  // MMAP
 
 #include <warnings/pop.h>
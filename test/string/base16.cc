@@ -6,6 +6,7 @@
  */
 
 #include <pycpp/stl/random.h>
+#include <pycpp/stl/stdexcept.h>
 #include <pycpp/stl/utility.h>
 #include <pycpp/stl/vector.h>
 #include <pycpp/string/base16.h>
@@ -73,3 +74,40 @@ TEST(base16, fuzz)
         EXPECT_EQ(base16_decode(encoded), input);
     }
 }
+
+
+TEST(base16, long)
+{
+    // cover every tail length after the vectorized blocks
+    string input;
+    for (size_t length = 0; length < 150; ++length) {
+        auto encoded = base16_encode(input);
+        EXPECT_EQ(encoded.size(), 2 * length);
+        EXPECT_EQ(base16_decode(encoded), input);
+        input.push_back(static_cast<char>(length * 7));
+    }
+}
+
+
+TEST(base16, lowercase)
+{
+    EXPECT_EQ(base16_decode("4c4f574552"), "LOWER");
+    EXPECT_EQ(base16_decode("546869732069732061206c6f6e67206d657373616765"), "This is a long message");
+}
+
+
+TEST(base16, invalid)
+{
+    EXPECT_THROW(base16_decode("4C4F5745G2"), runtime_error);
+    EXPECT_THROW(base16_decode("4C4"), runtime_error);
+
+    // invalid characters inside a vectorized block
+    string encoded = base16_encode(string(100, 'x'));
+    for (const char c: {'/', ':', '@', 'G', '`', 'g', '\xff'}) {
+        for (size_t i = 0; i < encoded.size(); i += 11) {
+            string copy = encoded;
+            copy[i] = c;
+            EXPECT_THROW(base16_decode(copy), runtime_error);
+        }
+    }
+}
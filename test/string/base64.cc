@@ -5,7 +5,9 @@
  *  \brief Base64 unittests.
  */
 
+#include <pycpp/stl/algorithm.h>
 #include <pycpp/stl/random.h>
+#include <pycpp/stl/stdexcept.h>
 #include <pycpp/stl/utility.h>
 #include <pycpp/stl/vector.h>
 #include <pycpp/string/base64.h>
@@ -73,3 +75,93 @@ TEST(base64, fuzz)
         EXPECT_EQ(base64_decode(encoded), input);
     }
 }
+
+
+TEST(base64, long)
+{
+    // cover every tail length after the vectorized blocks
+    string input;
+    for (size_t length = 0; length < 200; ++length) {
+        auto encoded = base64_encode(input);
+        EXPECT_EQ(encoded.size(), (length + 2) / 3 * 4);
+        EXPECT_EQ(base64_decode(encoded), input);
+        input.push_back(static_cast<char>(length * 7));
+    }
+}
+
+
+TEST(base64, unpadded)
+{
+    EXPECT_EQ(base64_decode("TE9XRVI"), "LOWER");
+    EXPECT_EQ(base64_decode("bG93ZXItLw"), "lower-/");
+    EXPECT_EQ(base64_decode(""), "");
+}
+
+
+TEST(base64, invalid)
+{
+    EXPECT_THROW(base64_decode("TE9XRVI*"), runtime_error);
+    EXPECT_THROW(base64_decode("TE9X\nRVI="), runtime_error);
+    EXPECT_THROW(base64_decode("TQ==TQ=="), runtime_error);
+    EXPECT_THROW(base64_decode("TQ="), runtime_error);
+    EXPECT_THROW(base64_decode("T"), runtime_error);
+    EXPECT_THROW(base64_decode("T==="), runtime_error);
+    EXPECT_THROW(base64_decode("TQ=A"), runtime_error);
+
+    // invalid characters inside a vectorized block
+    string encoded = base64_encode(string(300, 'x'));
+    for (size_t i = 0; i < encoded.size(); i += 13) {
+        string copy = encoded;
+        copy[i] = '\xff';
+        EXPECT_THROW(base64_decode(copy), runtime_error);
+    }
+}
+
+
+TEST(base64, lowlevel)
+{
+    // decoding stops at the start of the malformed quantum
+    string encoded = base64_encode(string(99, 'x')) + "AB*D";
+    string decoded(200, '\0');
+    const void* src = encoded.data();
+    void* dst = &decoded[0];
+    base64_decode(src, encoded.size(), dst, decoded.size());
+    EXPECT_EQ(static_cast<const char*>(src), encoded.data() + encoded.size() - 4);
+    EXPECT_EQ(static_cast<char*>(dst), decoded.data() + 99);
+}
+
+
+TEST(base64, encoder)
+{
+    string input;
+    for (size_t i = 0; i < 1000; ++i) {
+        input.push_back(static_cast<char>(i));
+    }
+
+    // feed the data in uneven chunks
+    base64_encoder encoder;
+    string encoded(2000, '\0');
+    void* dst = &encoded[0];
+    for (size_t i = 0; i < input.size(); ) {
+        size_t length = min<size_t>(input.size() - i, 1 + i % 7);
+        const void* src = input.data() + i;
+        encoder.encode(src, length, dst, 8);
+        i = static_cast<size_t>(static_cast<const char*>(src) - input.data());
+    }
+    EXPECT_TRUE(encoder.flush(dst, 8));
+    encoded.resize(static_cast<size_t>(static_cast<char*>(dst) - encoded.data()));
+    EXPECT_EQ(encoded, base64_encode(input));
+
+    base64_decoder decoder;
+    string decoded(1006, '\0');
+    dst = &decoded[0];
+    for (size_t i = 0; i < encoded.size(); ) {
+        size_t length = min<size_t>(encoded.size() - i, 1 + i % 7);
+        const void* src = encoded.data() + i;
+        decoder.decode(src, length, dst, 6);
+        i = static_cast<size_t>(static_cast<const char*>(src) - encoded.data());
+    }
+    EXPECT_TRUE(decoder.flush(dst, 6));
+    decoded.resize(static_cast<size_t>(static_cast<char*>(dst) - decoded.data()));
+    EXPECT_EQ(decoded, input);
+}
@@ -0,0 +1,145 @@
+//  :copyright: (c) 2017 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PyCPP
+ *  \brief Lazy string splitting unittests.
+ */
+
+#include <pycpp/stl/string.h>
+#include <pycpp/stl/vector.h>
+#include <pycpp/string/split.h>
+#include <gtest/gtest.h>
+
+PYCPP_USING_NAMESPACE
+
+// HELPERS
+// -------
+
+template <typename Range>
+static vector<string> collect(const Range& range)
+{
+    vector<string> list;
+    for (const string_view& token: range) {
+        list.emplace_back(string(token));
+    }
+    return list;
+}
+
+// TESTS
+// -----
+
+
+TEST(split_iterator, char_splitter)
+{
+    auto data = collect(splititer("This,Is,A,String", ','));
+    ASSERT_EQ(data.size(), 4);
+    EXPECT_EQ(data[0], "This");
+    EXPECT_EQ(data[1], "Is");
+    EXPECT_EQ(data[2], "A");
+    EXPECT_EQ(data[3], "String");
+
+    data = collect(splititer(";;0", ';'));
+    ASSERT_EQ(data.size(), 3);
+    EXPECT_EQ(data[0], "");
+    EXPECT_EQ(data[1], "");
+    EXPECT_EQ(data[2], "0");
+
+    data = collect(splititer("0;", ';'));
+    ASSERT_EQ(data.size(), 2);
+    EXPECT_EQ(data[0], "0");
+    EXPECT_EQ(data[1], "");
+
+    data = collect(splititer("", ';'));
+    EXPECT_EQ(data.size(), 0);
+
+    data = collect(splititer("a;b;c", ';', 1));
+    ASSERT_EQ(data.size(), 2);
+    EXPECT_EQ(data[0], "a");
+    EXPECT_EQ(data[1], "b;c");
+}
+
+
+TEST(split_iterator, charset_splitter)
+{
+    auto data = collect(splititer("a,b;c\td", ",;\t"));
+    ASSERT_EQ(data.size(), 4);
+    EXPECT_EQ(data[0], "a");
+    EXPECT_EQ(data[1], "b");
+    EXPECT_EQ(data[2], "c");
+    EXPECT_EQ(data[3], "d");
+
+    // long enough to use the vectorized scan, with high-bit characters
+    string str(40, 'x');
+    str[17] = '\xff';
+    str[33] = ',';
+    data = collect(splititer(str, string_view("\xff,")));
+    ASSERT_EQ(data.size(), 3);
+    EXPECT_EQ(data[0].size(), 17);
+    EXPECT_EQ(data[1].size(), 15);
+    EXPECT_EQ(data[2].size(), 6);
+
+    // more characters than the vectorized scan supports
+    data = collect(splititer("a0b1c2d3e4f5g6h7i8j9k", "0123456789"));
+    ASSERT_EQ(data.size(), 11);
+    EXPECT_EQ(data[0], "a");
+    EXPECT_EQ(data[10], "k");
+}
+
+
+TEST(split_iterator, predicate_splitter)
+{
+    auto data = collect(splititer("a1b22c", [](char c) {
+        return c >= '0' && c <= '9';
+    }));
+    ASSERT_EQ(data.size(), 4);
+    EXPECT_EQ(data[0], "a");
+    EXPECT_EQ(data[1], "b");
+    EXPECT_EQ(data[2], "");
+    EXPECT_EQ(data[3], "c");
+}
+
+
+TEST(split_iterator, reverse)
+{
+    auto data = collect(rsplititer(";;0", ';'));
+    ASSERT_EQ(data.size(), 3);
+    EXPECT_EQ(data[0], "0");
+    EXPECT_EQ(data[1], "");
+    EXPECT_EQ(data[2], "");
+
+    data = collect(rsplititer(";;0", ';', 1));
+    ASSERT_EQ(data.size(), 2);
+    EXPECT_EQ(data[0], "0");
+    EXPECT_EQ(data[1], ";");
+
+    data = collect(rsplititer("a,b;c", ",;", 1));
+    ASSERT_EQ(data.size(), 2);
+    EXPECT_EQ(data[0], "c");
+    EXPECT_EQ(data[1], "a,b");
+
+    data = collect(rsplititer(";;0", [](char c) {
+        return c == ';';
+    }, 1));
+    ASSERT_EQ(data.size(), 2);
+    EXPECT_EQ(data[0], "0");
+    EXPECT_EQ(data[1], ";");
+}
+
+
+TEST(split_iterator, iterator)
+{
+    string_view str = "a,b";
+    auto range = splititer(str, ',');
+    auto it = range.begin();
+    EXPECT_NE(it, range.end());
+    EXPECT_EQ(*it++, string_view("a"));
+    EXPECT_EQ(it->size(), 1);
+    EXPECT_EQ(*it, string_view("b"));
+
+    // zero-copy
+    EXPECT_EQ(it->data(), str.data() + 2);
+    ++it;
+    EXPECT_EQ(it, range.end());
+    EXPECT_FALSE(range.empty());
+    EXPECT_TRUE(splititer("", ',').empty());
+}
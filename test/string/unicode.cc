@@ -8,6 +8,7 @@
  */
 
 #include <pycpp/stl/exception.h>
+#include <pycpp/stl/stdexcept.h>
 #include <pycpp/stl/utility.h>
 #include <pycpp/stl/vector.h>
 #include <pycpp/string/unicode.h>
@@ -126,6 +127,56 @@ TEST(unicode, is_unicode)
     EXPECT_TRUE(is_unicode(UTF8_3));
     EXPECT_TRUE(is_unicode(UTF16_3));
     EXPECT_TRUE(is_unicode(UTF32_3));
+
+    // long strings, using the vectorized checks
+    string long_ascii(100, 'a');
+    EXPECT_FALSE(is_unicode(long_ascii));
+    long_ascii[70] = '\0';
+    EXPECT_TRUE(is_unicode(long_ascii));
+    long_ascii[70] = '\x80';
+    EXPECT_TRUE(is_unicode(long_ascii));
+}
+
+
+TEST(unicode, is_valid_utf8)
+{
+    EXPECT_TRUE(is_valid_utf8(""));
+    EXPECT_TRUE(is_valid_utf8(ASCII));
+    EXPECT_TRUE(is_valid_utf8(HAS_NULL));
+    EXPECT_TRUE(is_valid_utf8(UTF8));
+    EXPECT_TRUE(is_valid_utf8(UTF8_2));
+    EXPECT_TRUE(is_valid_utf8(UTF8_3));
+    EXPECT_TRUE(is_valid_utf8("\xf0\x90\x80\x80"));           // U+10000
+    EXPECT_TRUE(is_valid_utf8("\xf4\x8f\xbf\xbf"));           // U+10FFFF
+    EXPECT_TRUE(is_valid_utf8("\xed\x9f\xbf"));               // U+D7FF
+
+    EXPECT_FALSE(is_valid_utf8("\x80"));                       // lonely continuation
+    EXPECT_FALSE(is_valid_utf8("\xc3"));                       // truncated
+    EXPECT_FALSE(is_valid_utf8("\xe2\x82"));                   // truncated
+    EXPECT_FALSE(is_valid_utf8("\xc0\xaf"));                   // overlong
+    EXPECT_FALSE(is_valid_utf8("\xe0\x80\xaf"));               // overlong
+    EXPECT_FALSE(is_valid_utf8("\xf0\x80\x80\xaf"));           // overlong
+    EXPECT_FALSE(is_valid_utf8("\xed\xa0\x80"));               // surrogate
+    EXPECT_FALSE(is_valid_utf8("\xf4\x90\x80\x80"));           // > U+10FFFF
+    EXPECT_FALSE(is_valid_utf8("\xf8\x88\x80\x80\x80"));       // 5 bytes
+    EXPECT_FALSE(is_valid_utf8("\xfe"));
+
+    // check sequences crossing vector boundaries, at every offset
+    string multibyte = "\xe2\x82\xac\xf0\x9f\x98\x80\xc3\xa9";
+    for (size_t offset = 0; offset < 70; ++offset) {
+        string str = string(offset, 'a') + multibyte + string(70 - offset, 'b');
+        EXPECT_TRUE(is_valid_utf8(str));
+        for (size_t i = 0; i < multibyte.size(); ++i) {
+            // truncating a sequence must fail
+            string truncated = str.substr(0, offset + i);
+            if (i != 0 && i != 3 && i != 7) {
+                EXPECT_FALSE(is_valid_utf8(truncated)) << offset << " " << i;
+                EXPECT_FALSE(is_valid_utf8(truncated + "c"));
+            } else {
+                EXPECT_TRUE(is_valid_utf8(truncated));
+            }
+        }
+    }
 }
 
 
@@ -285,6 +336,38 @@ TEST(unicode, codepoint_conversions)
 }
 
 
+TEST(unicode, long_conversions)
+{
+    // mixed ASCII and CJK, long enough to use the vectorized routines
+    string utf8;
+    for (size_t i = 0; i < 40; ++i) {
+        utf8 += "Hangul: ";
+        utf8 += UTF8;
+        utf8 += " ";
+        utf8 += UTF8_2;
+        utf8 += "\xf0\x9f\x98\x80";
+    }
+
+    string utf16 = utf8_to_utf16(utf8);
+    string utf32 = utf8_to_utf32(utf8);
+    EXPECT_EQ(utf32.size(), 40 * (8 + 3 + 1 + 10 + 1) * 4);
+    EXPECT_EQ(utf16.size(), 40 * (8 + 3 + 1 + 10 + 2) * 2);
+    EXPECT_EQ(utf16_to_utf8(utf16), utf8);
+    EXPECT_EQ(utf32_to_utf8(utf32), utf8);
+    EXPECT_EQ(utf16_to_utf32(utf16), utf32);
+    EXPECT_EQ(utf32_to_utf16(utf32), utf16);
+
+    // pure ASCII
+    string ascii(1000, 'x');
+    EXPECT_EQ(utf16_to_utf8(utf8_to_utf16(ascii)), ascii);
+    EXPECT_EQ(utf32_to_utf8(utf8_to_utf32(ascii)), ascii);
+
+    // invalid data after a long valid prefix
+    EXPECT_THROW(utf8_to_utf32(utf8 + "\x80" "abc"), runtime_error);
+    EXPECT_THROW(utf8_to_utf16(ascii + "\x80" + ascii), runtime_error);
+}
+
+
 TEST(unicode, lowlevel)
 {
     test_lowlevel(UTF8, UTF16, unicode_lowlevel_callback(utf8_to_utf16));
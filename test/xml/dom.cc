@@ -5,6 +5,7 @@
  *  \brief JSON DOM unittests.
  */
 
+#include <pycpp/allocator/page.h>
 #include <pycpp/xml.h>
 #include <gtest/gtest.h>
 
@@ -83,3 +84,31 @@ TEST(xml, dom)
     EXPECT_EQ(str, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<note><to email=\"tove@tove.com\">Tove</to><from email=\"jani@jani.com\">Jani</from><heading>Reminder</heading><body>Don't forget me this weekend!</body></note>\n");
 
 }
+
+
+TEST(xml, allocator)
+{
+    page_arena_resource<>::allocator_type::arena_type arena;
+    page_arena_resource<> resource(arena);
+    {
+        xml_document_t d1(&resource);
+        d1.loads("<?xml version=\"1.0\" encoding=\"UTF-8\"?><note><to email=\"tove@tove.com\">Tove</to></note>");
+        EXPECT_EQ(d1.get_allocator().resource(), &resource);
+        EXPECT_GT(arena.used(), 0);
+
+        // tags, text and attributes are allocated from the arena
+        ASSERT_EQ(d1.get_children().size(), 1);
+        auto &to = d1.get_children().front().get_children().front();
+        EXPECT_EQ(to.get_tag(), "to");
+        EXPECT_EQ(to.get_tag().get_allocator().resource(), &resource);
+        EXPECT_EQ(to.get_text(), "Tove");
+        EXPECT_EQ(to.get_text().get_allocator().resource(), &resource);
+        EXPECT_EQ(to.get_attrs().at("email"), "tove@tove.com");
+        EXPECT_EQ(to.get_attrs().get_allocator().resource(), &resource);
+        EXPECT_EQ(to.get_attrs().begin()->first.get_allocator().resource(), &resource);
+    }
+
+    // release the whole document at once
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0);
+}